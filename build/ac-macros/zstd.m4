@@ -0,0 +1,101 @@
+dnl ===================================================================
+dnl   Licensed to the Apache Software Foundation (ASF) under one
+dnl   or more contributor license agreements.  See the NOTICE file
+dnl   distributed with this work for additional information
+dnl   regarding copyright ownership.  The ASF licenses this file
+dnl   to you under the Apache License, Version 2.0 (the
+dnl   "License"); you may not use this file except in compliance
+dnl   with the License.  You may obtain a copy of the License at
+dnl
+dnl     http://www.apache.org/licenses/LICENSE-2.0
+dnl
+dnl   Unless required by applicable law or agreed to in writing,
+dnl   software distributed under the License is distributed on an
+dnl   "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+dnl   KIND, either express or implied.  See the License for the
+dnl   specific language governing permissions and limitations
+dnl   under the License.
+dnl ===================================================================
+dnl
+dnl Unlike LZ4, zstd is an optional dependency: it enables the svndiff3
+dnl wire format but Subversion works fine without it.  The default
+dnl behaviour is to use pkg-config to look for a zstd library and if
+dnl that fails to simply try linking -lzstd; if neither works, zstd
+dnl support is quietly disabled.
+dnl
+dnl The user can specify --with-zstd=PREFIX to look in PREFIX, or
+dnl --with-zstd=no to disable zstd support outright.
+
+AC_DEFUN(SVN_ZSTD,
+[
+  AC_ARG_WITH([zstd],
+    [AS_HELP_STRING([--with-zstd=PREFIX],
+                    [look for zstd in PREFIX, or "no" to disable it])],
+    [
+      if test "$withval" = yes; then
+        zstd_prefix=std
+      else
+        zstd_prefix="$withval"
+      fi
+    ],
+    [zstd_prefix=std])
+
+  if test "$zstd_prefix" = "no"; then
+    AC_MSG_NOTICE([zstd support disabled])
+  else
+    if test "$zstd_prefix" = "std"; then
+      SVN_ZSTD_STD
+    else
+      SVN_ZSTD_PREFIX
+    fi
+    if test "$zstd_found" = "yes"; then
+      AC_DEFINE([SVN_HAVE_ZSTD], [1],
+                [Define if zstd is available (enables svndiff3)])
+    else
+      AC_MSG_NOTICE([zstd library not found; svndiff3 support disabled])
+    fi
+  fi
+  AC_SUBST(SVN_ZSTD_INCLUDES)
+  AC_SUBST(SVN_ZSTD_LIBS)
+])
+
+dnl ZSTD_compress2 and the advanced parameter API appeared in zstd 1.4.0,
+dnl but we only use the stable simple API which is complete as of 1.0.0.
+AC_DEFUN(SVN_ZSTD_STD,
+[
+  if test -n "$PKG_CONFIG"; then
+    AC_MSG_CHECKING([for zstd library via pkg-config])
+    if $PKG_CONFIG libzstd --exists; then
+      AC_MSG_RESULT([yes])
+      zstd_found=yes
+      SVN_ZSTD_INCLUDES=`$PKG_CONFIG libzstd --cflags`
+      SVN_ZSTD_LIBS=`$PKG_CONFIG libzstd --libs`
+      SVN_ZSTD_LIBS="`SVN_REMOVE_STANDARD_LIB_DIRS($SVN_ZSTD_LIBS)`"
+    else
+      AC_MSG_RESULT([no])
+    fi
+  fi
+  if test "$zstd_found" != "yes"; then
+    AC_MSG_NOTICE([zstd configuration without pkg-config])
+    AC_CHECK_LIB(zstd, ZSTD_compress, [
+      zstd_found=yes
+      SVN_ZSTD_LIBS="-lzstd"
+    ])
+  fi
+])
+
+AC_DEFUN(SVN_ZSTD_PREFIX,
+[
+  AC_MSG_NOTICE([zstd configuration via prefix])
+  save_cppflags="$CPPFLAGS"
+  CPPFLAGS="$CPPFLAGS -I$zstd_prefix/include"
+  save_ldflags="$LDFLAGS"
+  LDFLAGS="$LDFLAGS -L$zstd_prefix/lib"
+  AC_CHECK_LIB(zstd, ZSTD_compress, [
+    zstd_found=yes
+    SVN_ZSTD_INCLUDES="-I$zstd_prefix/include"
+    SVN_ZSTD_LIBS="`SVN_REMOVE_STANDARD_LIB_DIRS(-L$zstd_prefix/lib)` -lzstd"
+  ])
+  LDFLAGS="$save_ldflags"
+  CPPFLAGS="$save_cppflags"
+])
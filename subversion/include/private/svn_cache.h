@@ -174,6 +174,19 @@ typedef struct svn_cache__info_t
    */
   apr_uint64_t total_entries;
 
+  /** Number of cache entries per priority class.  Index 0 counts the
+   * low-priority entries, index 1 the default-priority ones and index 2
+   * the high-priority ones (see #SVN_CACHE__MEMBUFFER_LOW_PRIORITY etc.).
+   * All zero if that information is not available.
+   */
+  apr_uint64_t used_entries_per_class[3];
+
+  /** Size of the data currently stored per priority class, using the
+   * same index assignment as @a used_entries_per_class.
+   * All zero if that information is not available.
+   */
+  apr_uint64_t used_size_per_class[3];
+
   /** Number of index buckets with the given number of entries.
    * Bucket sizes larger than the array will saturate into the
    * highest array index.
@@ -391,6 +404,27 @@ svn_cache__create_null(svn_cache__t **cache_p,
                        const char *id,
                        apr_pool_t *result_pool);
 
+/**
+ * Creates a cache in @a *cache_p, allocated from @a result_pool, that
+ * combines the existing caches @a front and @a back into a two-level
+ * hierarchy.  Lookups consult @a front first and fall back to @a back
+ * on a miss; entries found in @a back only get copied into @a front.
+ * Modifications are applied to both levels.
+ *
+ * Use this to put a fast, process-local cache in front of a larger but
+ * slower one, e.g. a memcached instance shared between hosts.  Both
+ * caches must use compatible key and value types.  Neither of them
+ * should have an error handler set; attach the handler to @a *cache_p
+ * instead so it sees errors from both levels.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_cache__create_two_level(svn_cache__t **cache_p,
+                            svn_cache__t *front,
+                            svn_cache__t *back,
+                            apr_pool_t *result_pool);
+
 /**
  * Sets @a handler to be @a cache's error handling routine.  If any
  * error is returned from a call to svn_cache__get or svn_cache__set, @a
@@ -433,6 +467,47 @@ svn_cache__get(void **value,
                const void *key,
                apr_pool_t *result_pool);
 
+/**
+ * A single lookup within a svn_cache__get_multi() batch.
+ */
+typedef struct svn_cache__multi_item_t
+{
+  /** The key to look up.  May be NULL, in which case the entry will
+   * simply not be found. */
+  const void *key;
+
+  /** Output: the deserialized value, if the entry has been found. */
+  void *value;
+
+  /** Output: whether the entry has been found. */
+  svn_boolean_t found;
+} svn_cache__multi_item_t;
+
+/**
+ * Fetches @a count values from @a cache as described by the @a items
+ * array, setting each item's @c value and @c found members the same way
+ * svn_cache__get() would.  Values are copied into @a result_pool.
+ *
+ * Backends that talk to an external store may answer the whole batch
+ * in a single round trip; all others fall back to individual lookups.
+ * A batch-level error leaves all items not found.
+ */
+svn_error_t *
+svn_cache__get_multi(svn_cache__t *cache,
+                     svn_cache__multi_item_t *items,
+                     apr_size_t count,
+                     apr_pool_t *result_pool);
+
+/**
+ * Returns @c TRUE if @a cache answers svn_cache__get_multi() batches
+ * natively, i.e. cheaper than the equivalent series of svn_cache__get()
+ * calls.  Callers that would have to fetch speculatively to fill a
+ * batch should only do so if this returns @c TRUE.  Returns @c FALSE
+ * for a @c NULL @a cache.
+ */
+svn_boolean_t
+svn_cache__supports_multi_get(svn_cache__t *cache);
+
 /**
  * Looks for an entry indexed by @a key in @a cache,  setting @a *found
  * to TRUE if an entry has been found and FALSE otherwise.  @a key may be
@@ -544,6 +619,24 @@ svn_cache__format_info(const svn_cache__info_t *info,
                        svn_boolean_t access_only,
                        apr_pool_t *result_pool);
 
+/**
+ * Set the number of segments that the process-global membuffer cache
+ * shall be split into to @a segment_count.  0 (the default) selects a
+ * suitable value automatically based on the cache size.  The value will
+ * be capped and rounded down to a power of two during cache creation.
+ *
+ * More segments reduce lock contention on multi-core servers and, on
+ * multi-socket machines with a first-touch memory placement policy,
+ * increase the share of node-local cache accesses - at the expense of a
+ * lower maximum size per cachable item.
+ *
+ * This function is not thread-safe and must be called from the process
+ * initialization code, before the first call to
+ * svn_cache__get_global_membuffer_cache(), to have any effect.
+ */
+void
+svn_cache__set_global_membuffer_segments(apr_size_t segment_count);
+
 /**
  * Access the process-global (singleton) membuffer cache. The first call
  * will automatically allocate the cache using the current cache config.
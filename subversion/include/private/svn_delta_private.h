@@ -101,6 +101,34 @@ svn_delta__delta_from_editor(const svn_delta_editor_t **deditor,
                              struct svn_delta__extra_baton *exb,
                              apr_pool_t *pool);
 
+/** Opaque context for svn_txdelta__compose_windows().
+ *
+ * The delta combiner allocates short-lived index structures for every
+ * window pair it composes.  A context keeps those allocations alive
+ * between compositions so that long chains of compositions - such as
+ * undeltifying a deep delta chain - can recycle them instead of
+ * re-creating them for every window pair.
+ */
+typedef struct svn_txdelta__compose_ctx_t svn_txdelta__compose_ctx_t;
+
+/** Create a combiner context, allocated in @a pool.  Scratch structures
+ * recycled by the context will be allocated in @a pool as well; their
+ * total size is bounded by the largest composition seen.
+ */
+svn_txdelta__compose_ctx_t *
+svn_txdelta__compose_ctx_create(apr_pool_t *pool);
+
+/** Like svn_txdelta_compose_windows(), but reuse the scratch structures
+ * kept in @a ctx.  @a ctx may be @c NULL, in which case this behaves
+ * exactly like the public function.  A context must not be used by more
+ * than one thread at a time.
+ */
+svn_txdelta_window_t *
+svn_txdelta__compose_windows(const svn_txdelta_window_t *window_A,
+                             const svn_txdelta_window_t *window_B,
+                             svn_txdelta__compose_ctx_t *ctx,
+                             apr_pool_t *pool);
+
 /** Read the txdelta window header from @a stream and return the total
     length of the unparsed window data in @a *window_len. */
 svn_error_t *
@@ -108,6 +136,48 @@ svn_txdelta__read_raw_window_len(apr_size_t *window_len,
                                  svn_stream_t *stream,
                                  apr_pool_t *pool);
 
+/** Similar to svn_txdelta2(), but produce windows with source and target
+ * views of up to @a window_size bytes instead of the standard 100 KB.
+ * @a window_size 0 selects the standard size; larger values are clamped
+ * to the maximum that our decoders accept.
+ *
+ * Larger windows give the xdelta matcher a wider horizon and can shrink
+ * deltas of large binaries considerably, at a proportional cost in
+ * memory.  Use a non-standard size only where the consumer of the
+ * resulting windows is known to accept it: releases before 1.15 reject
+ * svndiff windows larger than the standard size, so such deltas must
+ * not be sent to, or stored for, older peers.
+ */
+void
+svn_txdelta__create_stream(svn_txdelta_stream_t **stream,
+                           svn_stream_t *source,
+                           svn_stream_t *target,
+                           svn_boolean_t calculate_checksum,
+                           apr_size_t window_size,
+                           apr_pool_t *pool);
+
+/** Similar to svn_txdelta_to_svndiff3(), but compress the windows on up
+ * to @a thread_count worker threads while the caller's thread keeps
+ * producing windows and writes the finished ones, in their original
+ * order, to @a output.  The number of windows in flight is bounded, so
+ * memory use stays within a small multiple of the window size.
+ *
+ * Falls back to the plain single-threaded encoder if @a thread_count
+ * is 1 or less, if APR does not support threads, or for svndiff
+ * version 0, which does not compress.
+ *
+ * @a output and the returned handler must only be used from the
+ * caller's thread.
+ */
+void
+svn_txdelta__to_svndiff_pipelined(svn_txdelta_window_handler_t *handler,
+                                  void **handler_baton,
+                                  svn_stream_t *output,
+                                  int svndiff_version,
+                                  int compression_level,
+                                  int thread_count,
+                                  apr_pool_t *pool);
+
 /* Return a debug editor that wraps @a wrapped_editor.
  *
  * The debug editor simply prints an indication of what callbacks are being
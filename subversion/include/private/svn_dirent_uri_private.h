@@ -26,6 +26,8 @@
 
 #include <apr_pools.h>
 
+#include "svn_string.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -46,6 +48,24 @@ svn_relpath__make_internal(const char **internal_style_relpath,
                            apr_pool_t *result_pool,
                            apr_pool_t *scratch_pool);
 
+/**
+ * Set @a result to @a base joined with @a component, like
+ * svn_relpath_join(), but write the result into the caller-provided
+ * buffer @a result instead of allocating a new string.
+ *
+ * With a buffer that is reused across iterations, joining stops
+ * allocating entirely once the buffer has reached its high-water mark,
+ * which matters for loops that build one transient child path per row.
+ * Note that svn_relpath_skip_ancestor() and friends already return
+ * borrowed views into their arguments and need no such variant.
+ *
+ * @since New in 1.15.
+ */
+void
+svn_relpath__join_buf(svn_stringbuf_t *result,
+                      const char *base,
+                      const char *component);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -311,6 +311,12 @@ typedef svn_error_t *
 
 typedef struct svn_fs_fs__ioctl_get_stats_input_t
 {
+  /* First revision to scan; 0 for a full scan.  A value within the
+   * packed part of the repository is rounded down to the pack file
+   * boundary.  See svn_fs_fs__get_stats_range() for the semantics of
+   * partial scans. */
+  svn_revnum_t start_rev;
+
   svn_fs_progress_notify_func_t progress_func;
   void *progress_baton;
 } svn_fs_fs__ioctl_get_stats_input_t;
@@ -364,6 +370,75 @@ typedef struct svn_fs_fs__ioctl_build_rep_cache_input_t
 /* See svn_fs_fs__build_rep_cache(). */
 SVN_FS_DECLARE_IOCTL_CODE(SVN_FS_FS__IOCTL_BUILD_REP_CACHE, SVN_FS_TYPE_FSFS, 1004);
 
+typedef struct svn_fs_fs__ioctl_build_paths_index_input_t
+{
+  svn_revnum_t end_rev;
+  svn_fs_progress_notify_func_t progress_func;
+  void *progress_baton;
+} svn_fs_fs__ioctl_build_paths_index_input_t;
+
+/* See svn_fs_fs__paths_index_build(). */
+SVN_FS_DECLARE_IOCTL_CODE(SVN_FS_FS__IOCTL_BUILD_PATHS_INDEX, SVN_FS_TYPE_FSFS,
+                          1005);
+
+/* Summary of the indexed changes in one revision that are relevant to
+ * the path given in svn_fs_fs__ioctl_query_paths_index_input_t. */
+typedef struct svn_fs_fs__paths_index_hit_t
+{
+  /* The revision containing the change(s). */
+  svn_revnum_t revision;
+
+  /* A change was recorded for the path itself or some path below it. */
+  svn_boolean_t self_or_below;
+
+  /* The path itself or one of its ancestors was added or replaced,
+   * i.e. this is where the node first appeared under this name. */
+  svn_boolean_t added_here;
+} svn_fs_fs__paths_index_hit_t;
+
+typedef struct svn_fs_fs__ioctl_query_paths_index_input_t
+{
+  /* Path to query, in canonical fspath ("/trunk/foo") form. */
+  const char *path;
+
+  /* Inclusive revision range to report changes for. */
+  svn_revnum_t start_rev;
+  svn_revnum_t end_rev;
+} svn_fs_fs__ioctl_query_paths_index_input_t;
+
+typedef struct svn_fs_fs__ioctl_query_paths_index_output_t
+{
+  /* Array of svn_fs_fs__paths_index_hit_t, sorted by revision in
+   * ascending order.  NULL if there is no index or it does not cover
+   * the requested range; the caller must then fall back to reading the
+   * changed-paths lists. */
+  apr_array_header_t *hits;
+} svn_fs_fs__ioctl_query_paths_index_output_t;
+
+/* See svn_fs_fs__paths_index_query(). */
+SVN_FS_DECLARE_IOCTL_CODE(SVN_FS_FS__IOCTL_QUERY_PATHS_INDEX, SVN_FS_TYPE_FSFS,
+                          1006);
+
+typedef struct svn_fs_fs__ioctl_rebuild_index_input_t
+{
+  /* Inclusive revision range to re-index; pass 0 / SVN_INVALID_REVNUM
+   * to cover the full repository.  A START_REV within the packed part
+   * of the repository is rounded down to the pack file boundary. */
+  svn_revnum_t start_rev;
+  svn_revnum_t end_rev;
+
+  svn_fs_progress_notify_func_t progress_func;
+  void *progress_baton;
+} svn_fs_fs__ioctl_rebuild_index_input_t;
+
+/* See svn_fs_fs__rebuild_index(). */
+SVN_FS_DECLARE_IOCTL_CODE(SVN_FS_FS__IOCTL_REBUILD_INDEX, SVN_FS_TYPE_FSFS,
+                          1007);
+
+/* See svn_fs_fs__lock_index_build().  Takes no input or output. */
+SVN_FS_DECLARE_IOCTL_CODE(SVN_FS_FS__IOCTL_BUILD_LOCK_INDEX, SVN_FS_TYPE_FSFS,
+                          1008);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -211,6 +211,21 @@ svn_fs__get_deleted_node(svn_fs_root_t **node_root,
                          apr_pool_t *result_pool,
                          apr_pool_t *scratch_pool);
 
+/** Set @a *entries_p to an array of <tt>svn_fs_dirent_t *</tt> for the
+ * directory @a path in @a root, sorted by entry name (strcmp() order).
+ *
+ * This is equivalent to sorting the result of svn_fs_dir_entries() but
+ * lets backends that already store directories in sorted order hand out
+ * the listing without building a hash and re-sorting it.
+ *
+ * Allocate the result in @a pool.
+ */
+svn_error_t *
+svn_fs__dir_entries_sorted(apr_array_header_t **entries_p,
+                           svn_fs_root_t *root,
+                           const char *path,
+                           apr_pool_t *pool);
+
 
 /** @} */
 
@@ -149,6 +149,27 @@ svn_error_t *
 svn_stream__install_delete(svn_stream_t *install_stream,
                            apr_pool_t *scratch_pool);
 
+/* Set *STREAM to a writable stream that forwards everything written to
+   it to TARGET from a separate writer thread.  Data is handed over
+   through a bounded ring of BUF_COUNT buffers of BUF_SIZE bytes each,
+   i.e. the producer may run ahead of a slow TARGET by roughly
+   BUF_COUNT * BUF_SIZE bytes before it gets throttled.  BUF_COUNT must
+   be at least 2.
+
+   Closing *STREAM flushes all pending data, waits for the writer thread
+   to terminate, closes TARGET and returns the first error encountered
+   by either side.  The caller must not write to TARGET directly while
+   *STREAM exists.
+
+   If this build does not support threads, TARGET itself is returned.
+   Allocate the stream and its buffers in RESULT_POOL. */
+svn_error_t *
+svn_stream__async_buffered(svn_stream_t **stream,
+                           svn_stream_t *target,
+                           apr_size_t buf_size,
+                           apr_size_t buf_count,
+                           apr_pool_t *result_pool);
+
 /* Internal version of svn_stream_from_aprfile2() supporting the
    additional TRUNCATE_ON_SEEK argument. */
 svn_stream_t *
@@ -38,6 +38,52 @@ extern "C" {
 #endif /* __cplusplus */
 
 
+/* An opaque context that amortizes allocations over many mergeinfo
+ * parses.  It interns merge source paths, so repeated paths - the norm
+ * when processing a whole mergeinfo catalog - share a single string
+ * allocation. */
+typedef struct svn_mergeinfo__parse_context_t svn_mergeinfo__parse_context_t;
+
+/* Return a new mergeinfo parse context, allocated in POOL. */
+svn_mergeinfo__parse_context_t *
+svn_mergeinfo__parse_context_create(apr_pool_t *pool);
+
+/* Like svn_mergeinfo_parse(), but intern the merge source path keys
+ * through CONTEXT and store each rangelist as a single contiguous block
+ * of ranges instead of one allocation per range.  Allocate *MERGEINFO in
+ * RESULT_POOL, except for the path keys which live in - and are only
+ * valid for the lifetime of - CONTEXT's pool.
+ *
+ * The resulting mergeinfo may be modified like any other, but caller
+ * code must not assume that individual ranges are independently
+ * allocated, e.g. it must not free or reuse them separately. */
+svn_error_t *
+svn_mergeinfo__parse(svn_mergeinfo_t *mergeinfo,
+                     const char *input,
+                     svn_mergeinfo__parse_context_t *context,
+                     apr_pool_t *result_pool);
+
+/* Return a copy of RANGELIST, allocated in RESULT_POOL, that stores all
+ * ranges in one contiguous block of memory instead of one allocation
+ * per range.  Use this for long-lived rangelists: iterating a packed
+ * copy touches a minimal number of cache lines and halves the per-range
+ * memory overhead.
+ *
+ * The copy may be modified like any other rangelist, but callers must
+ * not assume that its ranges are independently allocated, e.g. they
+ * must not reuse individual ranges in a different rangelist. */
+svn_rangelist_t *
+svn_rangelist__dup_packed(const svn_rangelist_t *rangelist,
+                          apr_pool_t *result_pool);
+
+/* Like svn_mergeinfo_dup(), but store every path's rangelist packed,
+ * c.f. svn_rangelist__dup_packed().  Allocate the result in RESULT_POOL
+ * and use SCRATCH_POOL for the hash iteration. */
+svn_mergeinfo_t
+svn_mergeinfo__dup_packed(svn_mergeinfo_t mergeinfo,
+                          apr_pool_t *result_pool,
+                          apr_pool_t *scratch_pool);
+
 /* Set inheritability of all ranges in RANGELIST to INHERITABLE.
    If RANGELIST is NULL do nothing. */
 void
@@ -130,6 +176,46 @@ svn_boolean_t
 svn_mergeinfo__remove_empty_rangelists(svn_mergeinfo_t mergeinfo,
                                        apr_pool_t *scratch_pool);
 
+/* Set *RESULT_CATALOG to the intersection of CATALOG1 and CATALOG2:
+   for every path with mergeinfo in both catalogs, the intersection of
+   the two mergeinfos as per svn_mergeinfo_intersect2(); paths present
+   in only one catalog, or whose intersection is empty, are omitted.
+
+   Unlike iterating a catalog and intersecting path by path, this walks
+   both catalogs - and the mergeinfos of each common path - in a single
+   sorted merged iteration and allocates each output rangelist as one
+   contiguous block, which makes it the preferred way to intersect
+   whole catalogs with many merge sources.
+
+   Allocate *RESULT_CATALOG in RESULT_POOL and use SCRATCH_POOL for all
+   temporary allocations. */
+svn_error_t *
+svn_mergeinfo__catalog_intersect(svn_mergeinfo_catalog_t *result_catalog,
+                                 svn_mergeinfo_catalog_t catalog1,
+                                 svn_mergeinfo_catalog_t catalog2,
+                                 svn_boolean_t consider_inheritance,
+                                 apr_pool_t *result_pool,
+                                 apr_pool_t *scratch_pool);
+
+/* Set *RESULT_CATALOG to WHITEBOARD_CATALOG with all revision ranges of
+   ERASER_CATALOG removed, applying svn_mergeinfo_remove2() semantics
+   per path:  paths only in WHITEBOARD_CATALOG are kept unchanged and
+   paths erased down to an empty mergeinfo are omitted.
+
+   Like svn_mergeinfo__catalog_intersect(), this processes both whole
+   catalogs in one sorted merged iteration with contiguously allocated
+   output rangelists.
+
+   Allocate *RESULT_CATALOG in RESULT_POOL and use SCRATCH_POOL for all
+   temporary allocations. */
+svn_error_t *
+svn_mergeinfo__catalog_remove(svn_mergeinfo_catalog_t *result_catalog,
+                              svn_mergeinfo_catalog_t eraser_catalog,
+                              svn_mergeinfo_catalog_t whiteboard_catalog,
+                              svn_boolean_t consider_inheritance,
+                              apr_pool_t *result_pool,
+                              apr_pool_t *scratch_pool);
+
 /* Make a shallow (ie, mergeinfos are not duped, or altered at all;
    keys share storage) copy of IN_CATALOG in *OUT_CATALOG, removing
    PREFIX_PATH from the beginning of each key in the catalog.
@@ -140,6 +140,16 @@ svn_error_t *
 svn_ra_svn__set_shim_callbacks(svn_ra_svn_conn_t *conn,
                                svn_delta_shim_callbacks_t *shim_callbacks);
 
+/**
+ * Limit the rate at which @a conn sends data to @a bytes_per_sec;
+ * 0 removes the limit.  The limit allows for up to one second's worth
+ * of burst.  Used by svnserve to keep bulk revision streams from
+ * monopolizing server I/O at the expense of interactive clients.
+ */
+void
+svn_ra_svn__set_bandwidth_limit(svn_ra_svn_conn_t *conn,
+                                apr_uint64_t bytes_per_sec);
+
 /**
  * Return the memory pool used to allocate @a conn.
  */
@@ -124,12 +124,87 @@ const char *
 svn_repos__post_commit_error_str(svn_error_t *err,
                                  apr_pool_t *pool);
 
+/** Callback invoked once for every revision successfully committed
+ * through a #svn_repos_t that the callback has been subscribed to with
+ * svn_repos__subscribe_to_commits().
+ *
+ * @a revision is the number of the new revision.  @a changed_paths maps
+ * <tt>const char *</tt> FS paths to #svn_fs_path_change3_t * values and
+ * describes all changes made by that revision; it is shared between all
+ * subscribers and must not be modified.  Both the hash and
+ * @a scratch_pool are cleared after the last subscriber returned.
+ *
+ * The callback runs in the process and thread performing the commit,
+ * after the transaction has been committed but before the post-commit
+ * hook script is started.  An error returned here is reported to the
+ * client like a post-commit hook failure; it cannot undo the commit.
+ */
+typedef svn_error_t *(*svn_repos__commit_notify_func_t)(
+  void *baton,
+  svn_revnum_t revision,
+  apr_hash_t *changed_paths,
+  apr_pool_t *scratch_pool);
+
+/** Subscribe @a notify_func / @a notify_baton to all future commits made
+ * through @a repos.  Subscribers are notified in the order they were
+ * added.  There is no way to unsubscribe; @a notify_baton must remain
+ * valid for the lifetime of @a repos.
+ *
+ * The subscription only covers this particular #svn_repos_t object, not
+ * other handles to the same on-disk repository (let alone other
+ * processes).  It gives in-process consumers the changed-paths list of
+ * each commit without re-reading the revision the way an external hook
+ * script would have to.
+ *
+ * This function is not thread-safe; subscribe before commits can happen.
+ */
+void
+svn_repos__subscribe_to_commits(svn_repos_t *repos,
+                                svn_repos__commit_notify_func_t notify_func,
+                                void *notify_baton);
+
 /* A repos version of svn_fs_type */
 svn_error_t *
 svn_repos__fs_type(const char **fs_type,
                    const char *repos_path,
                    apr_pool_t *pool);
 
+/* Like svn_repos_fs_get_locks2(), but instead of collecting the locks
+ * into a hash, invoke GET_LOCKS_FUNC with GET_LOCKS_BATON for each lock
+ * that passes the AUTHZ_READ_FUNC check, as the filesystem walk
+ * discovers it.  This keeps the server's memory use bounded no matter
+ * how many locks live below PATH.
+ */
+svn_error_t *
+svn_repos__fs_get_locks_stream(svn_repos_t *repos,
+                               const char *path,
+                               svn_depth_t depth,
+                               svn_repos_authz_func_t authz_read_func,
+                               void *authz_read_baton,
+                               svn_fs_get_locks_callback_t get_locks_func,
+                               void *get_locks_baton,
+                               apr_pool_t *pool);
+
+
+/* Set *ACCESS_GRANTED to TRUE iff the user's "global access floor" in
+ * AUTHZ covers REQUIRED_ACCESS, i.e. iff USER is granted at least
+ * REQUIRED_ACCESS on *every* path in the repository REPOS_NAME.
+ *
+ * The floor is a by-product of the rule filtering that the authz code
+ * performs anyway, so this is a cheap lookup.  Callers that iterate over
+ * many paths - dumps, log retrieval with changed paths etc. - can use it
+ * to skip their per-path authz checks wholesale whenever the floor
+ * already grants the required access.
+ *
+ * USER may be NULL, referring to the anonymous user.  REPOS_NAME may be
+ * NULL, meaning "in any repository".
+ */
+svn_error_t *
+svn_repos_authz__get_global_access(svn_boolean_t *access_granted,
+                                   svn_authz_t *authz,
+                                   const char *repos_name,
+                                   const char *user,
+                                   svn_repos_authz_access_t required_access);
 
 /* Create a commit editor for REPOS, based on REVISION.  */
 svn_error_t *
@@ -188,8 +263,11 @@ svn_repos__get_logs_compat(svn_repos_t *repos,
  * Instances handed out are read-only and may be given to multiple callers
  * from multiple threads.  Configuration objects no longer referenced by
  * any user may linger for a while before being cleaned up.
+ *
+ * On-disk configuration files are tracked with their stat() data, so
+ * repeated access to an unchanged file does not even re-read it.
  */
-typedef svn_object_pool__t svn_repos__config_pool_t;
+typedef struct svn_repos__config_pool_t svn_repos__config_pool_t;
 
 /* Create a new configuration pool object with a lifetime determined by
  * POOL and return it in *CONFIG_POOL.
@@ -119,6 +119,19 @@ svn_skel_t *svn_skel__parse(const char *data, apr_size_t len,
                             apr_pool_t *pool);
 
 
+/* Like svn_skel__parse(), but allocate all skel objects as a single
+   contiguous block from POOL, filled in pre-order, and parse without
+   recursing.  Like svn_skel__parse(), the returned skel objects point
+   into the block indicated by DATA and LEN; we don't copy the contents.
+
+   Prefer this over svn_skel__parse() on hot paths that deserialize
+   many skels, e.g. working copy workqueue processing: it performs one
+   pool allocation per skel instead of one per atom or list cell, and
+   its stack usage does not grow with the nesting depth.  */
+svn_skel_t *svn_skel__parse_in_place(const char *data, apr_size_t len,
+                                     apr_pool_t *pool);
+
+
 /* Create an atom skel whose contents are the C string STR, allocated
    from POOL.  */
 svn_skel_t *svn_skel__str_atom(const char *str, apr_pool_t *pool);
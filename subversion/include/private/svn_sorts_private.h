@@ -80,6 +80,17 @@ svn_sort__array(apr_array_header_t *array,
                 int (*comparison_func)(const void *,
                                        const void *));
 
+/* Sort @a array, an array of <tt>const char *</tt> canonical paths, into
+ * svn_path_compare_paths() order.
+ *
+ * This is equivalent to svn_sort__array() with svn_sort_compare_paths()
+ * but uses a multikey quicksort that never re-compares the prefix shared
+ * by a partition.  Prefer it when sorting large numbers of paths with
+ * long common prefixes, e.g. when driving an editor across a big commit.
+ */
+void
+svn_sort__array_paths(apr_array_header_t *array);
+
 /** Return the lowest index at which the element @a *key should be inserted into
  * the array @a array, according to the ordering defined by @a compare_func.
  * The array must already be sorted in the ordering defined by @a compare_func.
@@ -223,6 +234,74 @@ svn_priority_queue__push(svn_priority_queue__t *queue, const void *element);
 /** @} */
 
 
+/** Sorted arrays with deferred consolidation.
+ *
+ * @defgroup svn_sorted_array__t Sorted arrays
+ * @{
+ */
+
+/**
+ * Like #svn_priority_queue__t, we implement these on top of existing
+ * ELEMENTS arrays.  The wrapped array is kept in the ordering defined
+ * by a qsort-style comparison function, but new elements are collected
+ * in a separate buffer first and only merged into the main array in
+ * batches.  This replaces the O(N) per-element memmove of
+ * svn_sort__array_insert2() with an amortized sub-linear cost for
+ * build-then-iterate workloads, while lookups remain possible
+ * throughout the build.
+ */
+
+/**
+ * Opaque data type for sorted arrays.
+ */
+typedef struct svn_sorted_array__t svn_sorted_array__t;
+
+/**
+ * Return a sorted array wrapping the existing @a elements array and
+ * maintaining the ordering defined by @a compare_func.  @a elements
+ * must already be sorted accordingly.  Allocate the result and all
+ * internal buffers in @a pool.
+ *
+ * @note The wrapped @a elements array must not be accessed directly
+ * while insertions are pending; call #svn_sorted_array__flush first.
+ */
+svn_sorted_array__t *
+svn_sorted_array__create(apr_array_header_t *elements,
+                         int (*compare_func)(const void *, const void *),
+                         apr_pool_t *pool);
+
+/**
+ * Insert a shallow copy of @a *element into the sorted @a array.  The
+ * element only shows up in the wrapped array after the next
+ * consolidation, but #svn_sorted_array__lookup sees it immediately.
+ */
+void
+svn_sorted_array__insert(svn_sorted_array__t *array,
+                         const void *element);
+
+/**
+ * Return a reference to the element in @a array matching @a key, or
+ * NULL if there is none.  @a compare_func is defined as for
+ * svn_sort__array_lookup(), i.e. it receives an array element as the
+ * first and @a key as the second parameter, and must be compatible
+ * with the element ordering that @a array was created with.
+ */
+void *
+svn_sorted_array__lookup(svn_sorted_array__t *array,
+                         const void *key,
+                         int (*compare_func)(const void *, const void *));
+
+/**
+ * Merge all pending insertions into the array wrapped by @a array.
+ * Afterwards, the wrapped array is fully sorted and may be accessed
+ * directly again.
+ */
+void
+svn_sorted_array__flush(svn_sorted_array__t *array);
+
+/** @} */
+
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
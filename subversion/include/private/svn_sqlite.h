@@ -151,6 +151,16 @@ svn_sqlite__create_scalar_function(svn_sqlite__db_t *db,
 svn_error_t *
 svn_sqlite__exec_statements(svn_sqlite__db_t *db, int stmt_idx);
 
+/* Override SQLite's default I/O tuning for DB.  CACHE_SIZE is passed to
+   "PRAGMA cache_size" (positive: pages, negative: KiB, 0: keep the
+   default), MMAP_SIZE is the "PRAGMA mmap_size" limit in bytes (<= 0:
+   keep the default).  Use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_sqlite__set_cache_tuning(svn_sqlite__db_t *db,
+                             apr_int64_t cache_size,
+                             apr_int64_t mmap_size,
+                             apr_pool_t *scratch_pool);
+
 /* Return the statement in *STMT which has been prepared from the
    STATEMENTS[STMT_IDX] string, where STATEMENTS is the array that was
    passed to svn_sqlite__open().  This statement is allocated in the same
@@ -130,6 +130,28 @@ svn_spillbuf__write(svn_spillbuf_t *buf,
                     apr_pool_t *scratch_pool);
 
 
+/* Reserve a writable region at the end of the spill buffer, to append
+   content without staging it in a caller-owned buffer first. @a *data
+   will point to @a *len bytes (at least one, at most the blocksize) that
+   the caller may fill directly. The reservation must be completed with
+   svn_spillbuf__commit() before any other operation is performed on the
+   spill buffer; the region is only valid until then.  */
+svn_error_t *
+svn_spillbuf__reserve(char **data,
+                      apr_size_t *len,
+                      svn_spillbuf_t *buf,
+                      apr_pool_t *scratch_pool);
+
+
+/* Append the first @a len bytes of the region handed out by the preceding
+   svn_spillbuf__reserve() call to the spill buffer. @a len may be anything
+   from zero (discarding the reservation) up to the reserved size.  */
+svn_error_t *
+svn_spillbuf__commit(svn_spillbuf_t *buf,
+                     apr_size_t len,
+                     apr_pool_t *scratch_pool);
+
+
 /* Read a block of memory from the spill buffer. @a *data will be set to
    NULL if no content remains. Otherwise, @a data and @a len will point to
    data that must be fully-consumed by the caller. This data will remain
@@ -303,6 +325,14 @@ svn_checksum__wrap_write_stream_fnv1a_32x4(apr_uint32_t *digest,
 apr_uint32_t
 svn__fnv1a_32(const void *input, apr_size_t len);
 
+/**
+ * Return a 64 bit FNV-1a checksum for the first @a len bytes in @a input.
+ *
+ * @since New in 1.10
+ */
+apr_uint64_t
+svn__fnv1a_64(const void *input, apr_size_t len);
+
 /**
  * Return a 32 bit modified FNV-1a checksum for the first @a len bytes in
  * @a input.
@@ -591,6 +621,30 @@ svn__decompress_lz4(const void *data, apr_size_t len,
                     svn_stringbuf_t *out,
                     apr_size_t limit);
 
+/* Return TRUE if this build can compress and decompress zstd data,
+ * i.e. if it was compiled against the zstd library.  Callers must not
+ * negotiate the svndiff3 format unless this returns TRUE.
+ */
+svn_boolean_t
+svn__zstd_available(void);
+
+/* Same as svn__compress_zlib(), but use zstd compression.
+ * COMPRESSION_LEVEL is our generic 0..9 scale, not a zstd level.
+ * Return SVN_ERR_UNSUPPORTED_FEATURE if this build lacks zstd.
+ */
+svn_error_t *
+svn__compress_zstd(const void *data, apr_size_t len,
+                   svn_stringbuf_t *out,
+                   int compression_level);
+
+/* Same as svn__decompress_zlib(), but use zstd compression.
+ * Return SVN_ERR_UNSUPPORTED_FEATURE if this build lacks zstd.
+ */
+svn_error_t *
+svn__decompress_zstd(const void *data, apr_size_t len,
+                     svn_stringbuf_t *out,
+                     apr_size_t limit);
+
 /** @} */
 
 /**
@@ -746,6 +800,54 @@ const char *svn_lz4__compiled_version(void);
  */
 int svn_lz4__runtime_version(void);
 
+/* Return the zstd version we compiled against, or NULL if this build
+ * does not include zstd support. */
+const char *svn_zstd__compiled_version(void);
+
+
+/** Cancellation
+ *
+ * @defgroup svn_cancel Deadline-aware cancellation
+ * @{
+ */
+
+/* An opaque cancellation context combining an optional wall-clock
+   deadline, a flag that may be raised from another thread, and an
+   optional wrapped cancellation callback.  It plugs into the existing
+   cancellation plumbing as an ordinary #svn_cancel_func_t pair:
+
+     ctx->cancel_baton = svn_cancel__context_create(deadline,
+                                                    ctx->cancel_func,
+                                                    ctx->cancel_baton,
+                                                    pool);
+     ctx->cancel_func = svn_cancel__context_check;
+ */
+typedef struct svn_cancel__context_t svn_cancel__context_t;
+
+/* Create a cancellation context in RESULT_POOL.  DEADLINE is an
+   absolute time after which checks fail with #SVN_ERR_CANCELLED, or 0
+   for no deadline.  WRAPPED_FUNC / WRAPPED_BATON, if not NULL, are
+   consulted after the context's own checks pass. */
+svn_cancel__context_t *
+svn_cancel__context_create(apr_time_t deadline,
+                           svn_cancel_func_t wrapped_func,
+                           void *wrapped_baton,
+                           apr_pool_t *result_pool);
+
+/* Cancel CC:  all later svn_cancel__context_check() calls will fail
+   with #SVN_ERR_CANCELLED.  This function is atomic and may be called
+   from a different thread than the one running the operation. */
+void
+svn_cancel__context_cancel(svn_cancel__context_t *cc);
+
+/* Implements #svn_cancel_func_t, with an #svn_cancel__context_t for
+   BATON.  The uncancelled path costs one atomic load and, if a
+   deadline is set, one clock read. */
+svn_error_t *
+svn_cancel__context_check(void *baton);
+
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,71 @@
+/* svn_trace.h : lightweight in-process tracing for performance analysis
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#ifndef SVN_TRACE_H
+#define SVN_TRACE_H
+
+#include <apr_time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Unlike the SVN_DBG machinery, this facility is always compiled in but
+ * disabled by default.  It records timing spans for selected operations
+ * into a fixed-size in-memory ring buffer and, at process exit, writes
+ * them to the file named by the SVN_TRACE_FILE environment variable in
+ * the Chrome trace event JSON format (chrome://tracing, Perfetto).
+ * If that variable is not set, the only cost per instrumented operation
+ * is a NULL check.
+ *
+ * This is a diagnostic aid, not a transaction log: under concurrent use
+ * a wrapped-around ring slot may contain a torn span and spans of failed
+ * operations are simply dropped.
+ *
+ * Typical usage:
+ *
+ *   apr_time_t trace_start = svn_trace__start();
+ *   ...
+ *   svn_trace__record("fs_fs", "block-read", trace_start);
+ */
+
+/* If tracing is enabled, return the current time to be passed to
+ * svn_trace__record() when the operation has completed.  Return 0
+ * otherwise.
+ */
+apr_time_t
+svn_trace__start(void);
+
+/* Record a completed span that started at START and ends now, unless
+ * START is 0.  CATEGORY and NAME classify the operation in the trace
+ * viewer; both must be string literals (they are not copied).
+ */
+void
+svn_trace__record(const char *category,
+                  const char *name,
+                  apr_time_t start);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SVN_TRACE_H */
@@ -56,6 +56,23 @@ svn_wc__changelist_match(svn_wc_context_t *wc_ctx,
                          const apr_hash_t *clhash,
                          apr_pool_t *scratch_pool);
 
+/* Like svn_wc_set_changelist2(), but apply the change to all targets
+   in LOCAL_ABSPATHS (an array of const char * absolute paths) at once.
+   Targets within the same working copy share a single database
+   transaction, which makes assigning large explicit target lists far
+   cheaper than looping over svn_wc_set_changelist2(). */
+svn_error_t *
+svn_wc__set_changelist_many(svn_wc_context_t *wc_ctx,
+                            const apr_array_header_t *local_abspaths,
+                            const char *new_changelist,
+                            svn_depth_t depth,
+                            const apr_array_header_t *changelist_filter,
+                            svn_cancel_func_t cancel_func,
+                            void *cancel_baton,
+                            svn_wc_notify_func2_t notify_func,
+                            void *notify_baton,
+                            apr_pool_t *scratch_pool);
+
 /* Like svn_wc_get_update_editorX and svn_wc_get_status_editorX, but only
    allows updating a file external LOCAL_ABSPATH.
 
@@ -955,6 +972,19 @@ svn_wc__has_switched_subtrees(svn_boolean_t *is_switched,
                               const char *trail_url,
                               apr_pool_t *scratch_pool);
 
+/* If the BASE tree under @a local_abspath is entirely at one revision,
+ * with no switched, sparse, excluded or incomplete nodes, set
+ * @a *revision to that revision; set it to SVN_INVALID_REVNUM otherwise.
+ *
+ * Such a tree is an exact mirror of its repository URL at @a *revision:
+ * comparing it against that same revision cannot produce any difference.
+ * Use @a scratch_pool for temporary allocations. */
+svn_error_t *
+svn_wc__base_uniform_revision(svn_revnum_t *revision,
+                              svn_wc_context_t *wc_ctx,
+                              const char *local_abspath,
+                              apr_pool_t *scratch_pool);
+
 /* Set @a *excluded_subtrees to a hash mapping <tt>const char *</tt>
  * local * absolute paths to <tt>const char *</tt> local absolute paths for
  * every path under @a local_abspath in @a wc_ctx which are excluded
@@ -1042,6 +1072,8 @@ svn_wc__node_get_md5_from_sha1(const svn_checksum_t **md5_checksum,
 
 /* Like svn_wc_get_pristine_contents3(), but keyed on the CHECKSUM
    rather than on the local absolute path of the working file.
+   CHECKSUM may be a SHA-1 or an MD5 checksum; the latter is mapped to
+   the corresponding pristine text, if any.
    WRI_ABSPATH is any versioned path of the working copy in whose
    pristine database we'll be looking for these contents.  */
 svn_error_t *
@@ -112,6 +112,8 @@ typedef struct svn_config_t svn_config_t;
 #define SVN_CONFIG_OPTION_HTTP_MAX_CONNECTIONS      "http-max-connections"
 /** @since New in 1.9. */
 #define SVN_CONFIG_OPTION_HTTP_CHUNKED_REQUESTS     "http-chunked-requests"
+/** @since New in 1.15. */
+#define SVN_CONFIG_OPTION_HTTP_CAPABILITY_CACHE     "http-capability-cache"
 
 /** @since New in 1.9. */
 #define SVN_CONFIG_OPTION_SERF_LOG_COMPONENTS       "serf-log-components"
@@ -161,6 +163,8 @@ typedef struct svn_config_t svn_config_t;
 #define SVN_CONFIG_OPTION_MEMORY_CACHE_SIZE         "memory-cache-size"
 /** @since New in 1.9. */
 #define SVN_CONFIG_OPTION_DIFF_IGNORE_CONTENT_TYPE  "diff-ignore-content-type"
+/** @since New in 1.15. */
+#define SVN_CONFIG_OPTION_BLAME_CACHE               "blame-cache"
 #define SVN_CONFIG_SECTION_TUNNELS              "tunnels"
 #define SVN_CONFIG_SECTION_AUTO_PROPS           "auto-props"
 /** @since New in 1.8. */
@@ -172,6 +176,14 @@ typedef struct svn_config_t svn_config_t;
 /** @since New in 1.9. */
 #define SVN_CONFIG_OPTION_SQLITE_BUSY_TIMEOUT       "busy-timeout"
 /** @since New in 1.15. */
+#define SVN_CONFIG_OPTION_SQLITE_CACHE_SIZE         "cache-size"
+/** @since New in 1.15. */
+#define SVN_CONFIG_OPTION_SQLITE_MMAP_SIZE          "mmap-size"
+/** @since New in 1.15. */
+#define SVN_CONFIG_OPTION_PRISTINE_CACHE_DIR        "pristine-cache-dir"
+/** @since New in 1.15. */
+#define SVN_CONFIG_OPTION_COMPRESS_PRISTINES        "compress-pristines"
+/** @since New in 1.15. */
 #define SVN_CONFIG_OPTION_COMPATIBLE_VERSION        "compatible-version"
 /** @} */
 
@@ -193,6 +205,8 @@ typedef struct svn_config_t svn_config_t;
 #define SVN_CONFIG_OPTION_FORCE_USERNAME_CASE       "force-username-case"
 /** @since New in 1.8. */
 #define SVN_CONFIG_OPTION_HOOKS_ENV                 "hooks-env"
+/** @since New in 1.15. */
+#define SVN_CONFIG_OPTION_BULK_RATE_LIMIT           "bulk-rate-limit"
 /** @since New in 1.5. */
 #define SVN_CONFIG_SECTION_SASL                 "sasl"
 /** @since New in 1.5. */
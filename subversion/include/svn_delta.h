@@ -485,12 +485,16 @@ svn_txdelta_send_contents(const unsigned char *contents,
  * @a *handler_baton is set to the value to pass as the @a baton argument to
  * @a *handler.
  *
- * If @a result_digest is non-NULL, it points to APR_MD5_DIGESTSIZE bytes
- * of storage, and the final call to @a handler populates it with the
- * MD5 digest of the resulting fulltext.
+ * If @a result_md5 is non-NULL, the final call to @a handler sets
+ * @a *result_md5 to the MD5 checksum of the resulting fulltext,
+ * allocated in @a pool.  Likewise, if @a result_sha1 is non-NULL, the
+ * final call sets @a *result_sha1 to the SHA-1 checksum of the resulting
+ * fulltext.  Both checksums are computed incrementally while the delta
+ * is being applied, so requesting them does not cause the target data
+ * to be read back or hashed in a separate pass.
  *
  * If @a error_info is non-NULL, it is inserted parenthetically into
- * the error string for any error returned by svn_txdelta_apply2() or
+ * the error string for any error returned by svn_txdelta_apply3() or
  * @a *handler.  (It is normally used to provide path information,
  * since there's nothing else in the delta application's context to
  * supply a path for error messages.)
@@ -506,6 +510,23 @@ svn_txdelta_send_contents(const unsigned char *contents,
  * @since New in 1.15.
  */
 void
+svn_txdelta_apply3(svn_stream_t *source,
+                   svn_stream_t *target,
+                   svn_checksum_t **result_md5,
+                   svn_checksum_t **result_sha1,
+                   const char *error_info,
+                   apr_pool_t *pool,
+                   svn_txdelta_window_handler_t *handler,
+                   void **handler_baton);
+
+/** Similar to svn_txdelta_apply3(), but without the SHA-1 output.  If
+ * @a result_digest is non-NULL, it points to APR_MD5_DIGESTSIZE bytes
+ * of storage, and the final call to @a handler populates it with the
+ * raw MD5 digest of the resulting fulltext.
+ *
+ * @since New in 1.15.
+ */
+void
 svn_txdelta_apply2(svn_stream_t *source,
                    svn_stream_t *target,
                    unsigned char *result_digest,
@@ -487,6 +487,16 @@ typedef struct svn_diff_file_options_t
    *
    * @since New in 1.9 */
   int context_size;
+
+  /** Whether the LCS computation may be split at a suitable synchronization
+   * point, with the two halves processed concurrently on separate threads.
+   * This speeds up diffs of very large files on multi-core machines, but
+   * may occasionally produce a slightly larger (yet still correct) diff.
+   * Ignored for small inputs and in builds without thread support.
+   * The default is @c FALSE.
+   *
+   * @since New in 1.15 */
+  svn_boolean_t parallel_lcs;
 } svn_diff_file_options_t;
 
 /** Allocate a @c svn_diff_file_options_t structure in @a pool, initializing
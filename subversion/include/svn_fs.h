@@ -146,6 +146,16 @@ typedef struct svn_fs_t svn_fs_t;
  */
 #define SVN_FS_CONFIG_FSFS_BLOCK_READ           "fsfs-block-read"
 
+/** String with a decimal representation of the number of worker threads
+ * that svn_fs_pack() may use to pack independent FSFS shards in parallel.
+ * "0" and "1" (the default) select the single-threaded implementation.
+ *
+ * Ignored if Subversion has been compiled without thread support.
+ *
+ * @since New in 1.15.
+ */
+#define SVN_FS_CONFIG_FSFS_PACK_THREADS         "fsfs-pack-threads"
+
 /** String with a decimal representation of the FSFS format shard size.
  * Zero ("0") means that a repository with linear layout should be created.
  *
@@ -1159,8 +1159,24 @@ svn_stream_for_stderr(svn_stream_t **err,
                       apr_pool_t *pool);
 
 /** Set @a *out to a generic stream connected to stdout, allocated in
- * @a pool.  The stream and its underlying APR handle will be closed
- * when @a pool is cleared or destroyed.
+ * @a pool.  If @a buffered is set, APR buffering will be enabled.
+ * The stream and its underlying APR handle will be closed when @a pool
+ * is cleared or destroyed.
+ *
+ * @note With APR buffering enabled, output may not reach the terminal
+ *       or a consuming pipe until the buffer fills up or the stream is
+ *       closed.  This is inappropriate for interactive or progress
+ *       output but benefits bulk output such as dump streams, where it
+ *       coalesces many small writes into few large ones.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_stream_for_stdout2(svn_stream_t **out,
+                       svn_boolean_t buffered,
+                       apr_pool_t *pool);
+
+/** Similar to svn_stream_for_stdout2(), but with buffering disabled.
  */
 svn_error_t *
 svn_stream_for_stdout(svn_stream_t **out,
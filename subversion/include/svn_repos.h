@@ -1505,6 +1505,82 @@ svn_repos_replay2(svn_fs_root_t *root,
                   void *authz_read_baton,
                   apr_pool_t *pool);
 
+/**
+ * Callback function that checks if a revision replayed by
+ * svn_repos_replay_range() may proceed and provides the editor to
+ * drive for it.
+ *
+ * @a revision is the target revision number of the received replay.
+ *
+ * @a editor and @a edit_baton should provide the editor to drive for
+ * @a revision.
+ *
+ * @a rev_props contains the (readable) revision properties of @a revision.
+ *
+ * @a replay_baton is the baton passed to svn_repos_replay_range().
+ *
+ * @a pool may be used for temporary allocations; it is cleared between
+ * revisions.
+ *
+ * @since New in 1.15.
+ */
+typedef svn_error_t *(*svn_repos_replay_revstart_callback_t)(
+  svn_revnum_t revision,
+  void *replay_baton,
+  const svn_delta_editor_t **editor,
+  void **edit_baton,
+  apr_hash_t *rev_props,
+  apr_pool_t *pool);
+
+/**
+ * Callback function invoked by svn_repos_replay_range() after replaying
+ * a revision.  The arguments have the same meaning as for
+ * #svn_repos_replay_revstart_callback_t; @a editor and @a edit_baton
+ * are the ones returned by the revstart callback for @a revision.
+ *
+ * @since New in 1.15.
+ */
+typedef svn_error_t *(*svn_repos_replay_revfinish_callback_t)(
+  svn_revnum_t revision,
+  void *replay_baton,
+  const svn_delta_editor_t *editor,
+  void *edit_baton,
+  apr_hash_t *rev_props,
+  apr_pool_t *pool);
+
+/**
+ * Replay the revisions @a start_revision through @a end_revision
+ * (inclusive) of the filesystem of @a repos, driving one editor per
+ * revision.  Before each revision, @a revstart_func is called with
+ * @a replay_baton and the revision's properties to obtain the editor for
+ * that revision; after the revision has been replayed, @a revfinish_func
+ * is called.
+ *
+ * The replay of each revision behaves exactly like svn_repos_replay2()
+ * (which see for the semantics of @a base_dir, @a low_water_mark,
+ * @a send_deltas, @a authz_read_func and @a authz_read_baton), but
+ * revision roots and other per-revision context are carried over from
+ * one revision to the next, which is considerably cheaper than calling
+ * svn_repos_replay2() in a loop when replaying many small revisions.
+ *
+ * Use @a scratch_pool for temporary allocations.
+ *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_repos_replay_range(svn_repos_t *repos,
+                       const char *base_dir,
+                       svn_revnum_t start_revision,
+                       svn_revnum_t end_revision,
+                       svn_revnum_t low_water_mark,
+                       svn_boolean_t send_deltas,
+                       svn_repos_replay_revstart_callback_t revstart_func,
+                       svn_repos_replay_revfinish_callback_t revfinish_func,
+                       void *replay_baton,
+                       svn_repos_authz_func_t authz_read_func,
+                       void *authz_read_baton,
+                       apr_pool_t *scratch_pool);
+
 /**
  * Similar to svn_repos_replay2(), but with @a base_dir set to @c "",
  * @a low_water_mark set to #SVN_INVALID_REVNUM, @a send_deltas
@@ -1777,10 +1853,45 @@ typedef svn_error_t *(* svn_repos_dirent_receiver_t)(const char *path,
  * @a path must point to a directory and @a depth must be at least
  * #svn_depth_empty.
  *
+ * @a start_name and @a limit provide paginated access to large
+ * directories.  If @a start_name is not @c NULL, the listing starts at
+ * the first immediate entry of @a path whose name is greater than
+ * @a start_name (strcmp() order), i.e. passing the name of the last
+ * entry received continues the listing right behind it; the starting
+ * @a path itself will then not be reported again.  If @a limit is not
+ * 0, no more than @a limit entries will be reported.  Note that with
+ * @a authz_read_func a page may come back shorter than @a limit even
+ * if further accessible entries exist; continue from the last reported
+ * name until an empty page is returned.
+ *
  * Use @a scratch_pool for temporary memory allocation.
  *
+ * @since New in 1.15.
+ */
+svn_error_t *
+svn_repos_list2(svn_fs_root_t *root,
+                const char *path,
+                const apr_array_header_t *patterns,
+                svn_depth_t depth,
+                svn_boolean_t path_info_only,
+                const char *start_name,
+                apr_size_t limit,
+                svn_repos_authz_func_t authz_read_func,
+                void *authz_read_baton,
+                svn_repos_dirent_receiver_t receiver,
+                void *receiver_baton,
+                svn_cancel_func_t cancel_func,
+                void *cancel_baton,
+                apr_pool_t *scratch_pool);
+
+/**
+ * Similar to svn_repos_list2(), but without pagination, i.e. always
+ * reporting the complete listing.
+ *
  * @since New in 1.10.
+ * @deprecated Provided for backward compatibility with the 1.14 API.
  */
+SVN_DEPRECATED
 svn_error_t *
 svn_repos_list(svn_fs_root_t *root,
                const char *path,
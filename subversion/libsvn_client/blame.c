@@ -36,6 +36,9 @@
 #include "svn_props.h"
 #include "svn_hash.h"
 #include "svn_sorts.h"
+#include "svn_config.h"
+#include "svn_checksum.h"
+#include "svn_io.h"
 
 #include "private/svn_wc_private.h"
 
@@ -101,6 +104,15 @@ struct file_rev_baton {
 
   svn_boolean_t check_mime_type;
 
+  /* Set when the blame chain was seeded from a cached blame table, so
+     that the run does not start with an empty chain and NULL
+     LAST_FILENAME as it usually would. */
+  svn_boolean_t resumed;
+  /* End revision of the cached table we resumed from.  Reset to
+     SVN_INVALID_REVNUM once the first reported revision has been
+     checked against it. */
+  svn_revnum_t resumed_end;
+
   /* When blaming backwards we have to use the changes
      on the *next* revision, as the interesting change
      happens when we move to the previous revision */
@@ -118,6 +130,13 @@ struct delta_baton {
   const char *filename;
   svn_boolean_t is_merged_revision;
   struct rev *rev;     /* the rev struct for the current revision */
+
+  /* Whether the delta windows seen so far reproduce the source verbatim.
+     Set optimistically and cleared by the first window that cannot be an
+     identity copy; lets us skip the diff for unchanged contents. */
+  svn_boolean_t delta_is_identity;
+  /* Number of source bytes the identity windows have copied so far. */
+  apr_off_t identity_len;
 };
 
 
@@ -341,12 +360,16 @@ update_blame(void *baton)
   else
     chain = frb->chain;
 
-  /* Process this file. */
-  SVN_ERR(add_file_blame(frb->last_filename,
-                         dbaton->filename, chain, dbaton->rev,
-                         frb->diff_options,
-                         frb->ctx->cancel_func, frb->ctx->cancel_baton,
-                         frb->currpool));
+  /* Process this file.  If the delta told us the contents are unchanged,
+     the diff could only produce an empty edit script, so don't bother
+     tokenizing and diffing the files at all.  With no previous file the
+     call is still needed to seed the chain. */
+  if (!(dbaton->delta_is_identity && frb->last_filename))
+    SVN_ERR(add_file_blame(frb->last_filename,
+                           dbaton->filename, chain, dbaton->rev,
+                           frb->diff_options,
+                           frb->ctx->cancel_func, frb->ctx->cancel_baton,
+                           frb->currpool));
 
   /* If we are including merged revisions, and the current revision is not a
      merged one, we need to add its blame info to the chain for the original
@@ -405,7 +428,39 @@ window_handler(svn_txdelta_window_t *window, void *baton)
 
   /* We patiently wait for the NULL window marking the end. */
   if (window)
-    return SVN_NO_ERROR;
+    {
+      /* An identity delta copies the source in order, in one op per
+         window, without inserting new data.  Anything else - extra ops,
+         new data, out-of-order source views - may still reproduce the
+         source, but then the diff below will find that out; we only
+         need to recognize the straightforward encoding. */
+      if (dbaton->delta_is_identity && window->tview_len > 0)
+        {
+          if (window->num_ops == 1
+              && window->ops[0].action_code == svn_txdelta_source
+              && window->ops[0].offset == 0
+              && window->ops[0].length == window->tview_len
+              && window->sview_offset == dbaton->identity_len)
+            dbaton->identity_len += window->tview_len;
+          else
+            dbaton->delta_is_identity = FALSE;
+        }
+
+      return SVN_NO_ERROR;
+    }
+
+  /* The windows were all identity copies, but the target may still be a
+     truncated source.  Only a target as long as the source is unchanged. */
+  if (dbaton->delta_is_identity && dbaton->file_rev_baton->last_filename)
+    {
+      apr_finfo_t finfo;
+
+      SVN_ERR(svn_io_stat(&finfo, dbaton->file_rev_baton->last_filename,
+                          APR_FINFO_SIZE,
+                          dbaton->file_rev_baton->currpool));
+      if (finfo.size != dbaton->identity_len)
+        dbaton->delta_is_identity = FALSE;
+    }
 
   /* Diff and update blame info. */
   SVN_ERR(update_blame(baton));
@@ -491,6 +546,32 @@ file_rev_handler(void *baton, const char *path, svn_revnum_t revnum,
       && (!frb->include_merged_revisions || merged_revision))
     return SVN_NO_ERROR;
 
+  /* If we resumed from a cached blame table, the first reported revision
+     tells us whether that table still describes an ancestor of the file:
+     over a continuous line of history the walk reports at least one
+     revision at or below the cached end revision.  If the file was
+     replaced later, the walk stops at the replacement instead, so the
+     cached table belongs to a dead line of history.  Throw away the seed
+     and blame from scratch; the walk delivers all relevant revisions
+     anyway in that case. */
+  if (SVN_IS_VALID_REVNUM(frb->resumed_end))
+    {
+      if (revnum > frb->resumed_end)
+        {
+          struct blame *walk = frb->chain->blame;
+
+          while (walk)
+            {
+              struct blame *next = walk->next;
+              blame_destroy(frb->chain, walk);
+              walk = next;
+            }
+          frb->chain->blame = NULL;
+          frb->last_filename = NULL;
+        }
+      frb->resumed_end = SVN_INVALID_REVNUM;
+    }
+
   /* Create delta baton. */
   delta_baton = apr_pcalloc(frb->currpool, sizeof(*delta_baton));
 
@@ -548,8 +629,10 @@ file_rev_handler(void *baton, const char *path, svn_revnum_t revnum,
   else
     {
       /* We shouldn't get more than one revision outside the
-         specified range (unless we alsoe receive merged revisions) */
+         specified range (unless we alsoe receive merged revisions, or
+         resumed from a cached blame table) */
       SVN_ERR_ASSERT((frb->last_filename == NULL)
+                     || frb->resumed
                      || frb->include_merged_revisions);
 
       /* The file existed before start_rev; generate no blame info for
@@ -578,6 +661,7 @@ file_rev_handler(void *baton, const char *path, svn_revnum_t revnum,
                          frb->currpool,
                          &delta_baton->wrapped_handler,
                          &delta_baton->wrapped_baton);
+      delta_baton->delta_is_identity = TRUE;
       *content_delta_handler = window_handler;
       *content_delta_baton = delta_baton;
     }
@@ -585,8 +669,10 @@ file_rev_handler(void *baton, const char *path, svn_revnum_t revnum,
     {
       /* Apply an empty delta, i.e. simply copy the old contents.
          We can't simply use the existing file due to the pool rotation logic.
-         Trigger the blame update magic. */
+         Trigger the blame update magic.  The contents are unchanged by
+         construction, so the diff can be skipped. */
       SVN_ERR(svn_stream_copy3(last_stream, cur_stream, NULL, NULL, pool));
+      delta_baton->delta_is_identity = TRUE;
       SVN_ERR(update_blame(delta_baton));
     }
 
@@ -657,6 +743,269 @@ normalize_blames(struct blame_chain *chain,
     }
 }
 
+
+/*** Persistent blame cache. ***/
+
+/* When enabled via the blame-cache runtime option, the resolved blame
+   table of a finished plain (non-merge-tracking, forward) blame run is
+   stored in the user configuration area, together with the file's text
+   at the end revision.  A later blame of the same file over a range
+   with the same start revision seeds its blame chain from the cached
+   table and only fetches the revisions younger than the cached end
+   revision.
+
+   Each cache entry is a single file named after the SHA1 of the
+   repository UUID and the file's repository path, in this format:
+
+     format number ("1")
+     repository UUID
+     repository path of the file
+     start and end revision of the cached run
+     number of blame chunks
+     one "<line> <revision>" pair per chunk ("-1" for pre-start lines)
+     the file's full text at the end revision (up to end of file)
+
+   Entries are written to a tempfile and moved into place, so a
+   concurrent reader never sees a partial entry. */
+
+#define BLAME_CACHE_FORMAT 1
+
+/* A blame chunk as read from a cache entry. */
+struct cached_chunk
+{
+  apr_off_t start;
+  svn_revnum_t revision;
+};
+
+/* Set *CACHE_PATH to the full path of the cache entry for the file
+   FS_PATH in the repository identified by UUID, or to NULL if the blame
+   cache is disabled in CTX->config (or no user configuration area is
+   available).  Allocate the result in RESULT_POOL. */
+static svn_error_t *
+blame_cache_path(const char **cache_path,
+                 const char *uuid,
+                 const char *fs_path,
+                 svn_client_ctx_t *ctx,
+                 apr_pool_t *result_pool)
+{
+  svn_config_t *cfg;
+  svn_boolean_t enabled;
+  const char *config_dir = NULL;
+  const char *cache_dir;
+  const char *key;
+  svn_checksum_t *checksum;
+
+  *cache_path = NULL;
+
+  cfg = ctx->config ? svn_hash_gets(ctx->config, SVN_CONFIG_CATEGORY_CONFIG)
+                    : NULL;
+  SVN_ERR(svn_config_get_bool(cfg, &enabled, SVN_CONFIG_SECTION_MISCELLANY,
+                              SVN_CONFIG_OPTION_BLAME_CACHE, FALSE));
+  if (!enabled)
+    return SVN_NO_ERROR;
+
+  if (ctx->auth_baton)
+    config_dir = svn_auth_get_parameter(ctx->auth_baton,
+                                        SVN_AUTH_PARAM_CONFIG_DIR);
+  SVN_ERR(svn_config_get_user_config_path(&cache_dir, config_dir,
+                                          "blame-cache", result_pool));
+  if (cache_dir == NULL)
+    return SVN_NO_ERROR;
+
+  key = apr_pstrcat(result_pool, uuid, ":", fs_path, SVN_VA_NULL);
+  SVN_ERR(svn_checksum(&checksum, svn_checksum_sha1, key, strlen(key),
+                       result_pool));
+  *cache_path = svn_dirent_join(cache_dir,
+                                svn_checksum_to_cstring(checksum,
+                                                        result_pool),
+                                result_pool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Read one header line of a cache entry from STREAM into *LINE,
+   allocated in POOL.  Hitting the end of the entry is an error. */
+static svn_error_t *
+blame_cache_readline(svn_stringbuf_t **line,
+                     svn_stream_t *stream,
+                     apr_pool_t *pool)
+{
+  svn_boolean_t eof;
+
+  SVN_ERR(svn_stream_readline(stream, line, "\n", &eof, pool));
+  if (eof)
+    return svn_error_create(SVN_ERR_MALFORMED_FILE, NULL,
+                            _("Premature end of blame cache entry"));
+
+  return SVN_NO_ERROR;
+}
+
+/* Try to load the cache entry at CACHE_PATH for the file FS_PATH in the
+   repository identified by UUID.  The entry is usable only if it was
+   computed for the same start revision START_REV and for an end
+   revision no younger than END_REV.
+
+   On a usable entry, set *CHUNKS to an array of (struct cached_chunk),
+   *CACHED_END to the entry's end revision and *FULLTEXT_PATH to a
+   tempfile holding the file's text at *CACHED_END; the tempfile is
+   removed when RESULT_POOL is cleared.  On a miss, set *CHUNKS to NULL.
+   An error simply means the entry cannot be used. */
+static svn_error_t *
+blame_cache_load(apr_array_header_t **chunks,
+                 svn_revnum_t *cached_end,
+                 const char **fulltext_path,
+                 const char *cache_path,
+                 const char *uuid,
+                 const char *fs_path,
+                 svn_revnum_t start_rev,
+                 svn_revnum_t end_rev,
+                 apr_pool_t *result_pool,
+                 apr_pool_t *scratch_pool)
+{
+  svn_stream_t *stream;
+  svn_stream_t *fulltext;
+  svn_stringbuf_t *line;
+  svn_error_t *err;
+  apr_int64_t format;
+  apr_int64_t nchunks;
+  svn_revnum_t entry_start;
+  apr_array_header_t *result;
+  const char *p;
+  int i;
+
+  *chunks = NULL;
+
+  err = svn_stream_open_readonly(&stream, cache_path, scratch_pool,
+                                 scratch_pool);
+  if (err)
+    {
+      if (APR_STATUS_IS_ENOENT(err->apr_err))
+        {
+          svn_error_clear(err);
+          return SVN_NO_ERROR;
+        }
+      return svn_error_trace(err);
+    }
+
+  SVN_ERR(blame_cache_readline(&line, stream, scratch_pool));
+  SVN_ERR(svn_cstring_atoi64(&format, line->data));
+  if (format != BLAME_CACHE_FORMAT)
+    return svn_error_trace(svn_stream_close(stream));
+
+  SVN_ERR(blame_cache_readline(&line, stream, scratch_pool));
+  if (strcmp(line->data, uuid) != 0)
+    return svn_error_trace(svn_stream_close(stream));
+
+  SVN_ERR(blame_cache_readline(&line, stream, scratch_pool));
+  if (strcmp(line->data, fs_path) != 0)
+    return svn_error_trace(svn_stream_close(stream));
+
+  SVN_ERR(blame_cache_readline(&line, stream, scratch_pool));
+  entry_start = SVN_STR_TO_REV(line->data);
+  p = strchr(line->data, ' ');
+  if (p == NULL)
+    return svn_error_trace(svn_stream_close(stream));
+  *cached_end = SVN_STR_TO_REV(p + 1);
+
+  /* The cached table describes the range [ENTRY_START, *CACHED_END]; it
+     can seed this run only if the start revisions agree and the cached
+     end does not lie beyond the requested end. */
+  if (entry_start != start_rev
+      || *cached_end < start_rev
+      || *cached_end > end_rev)
+    return svn_error_trace(svn_stream_close(stream));
+
+  SVN_ERR(blame_cache_readline(&line, stream, scratch_pool));
+  SVN_ERR(svn_cstring_atoi64(&nchunks, line->data));
+  if (nchunks < 1 || nchunks > APR_INT32_MAX)
+    return svn_error_trace(svn_stream_close(stream));
+
+  result = apr_array_make(result_pool, (int)nchunks,
+                          sizeof(struct cached_chunk));
+  for (i = 0; i < (int)nchunks; i++)
+    {
+      struct cached_chunk chunk;
+      apr_int64_t val;
+
+      SVN_ERR(blame_cache_readline(&line, stream, scratch_pool));
+      SVN_ERR(svn_cstring_atoi64(&val, line->data));
+      chunk.start = (apr_off_t)val;
+      p = strchr(line->data, ' ');
+      if (p == NULL)
+        return svn_error_trace(svn_stream_close(stream));
+      chunk.revision = SVN_STR_TO_REV(p + 1);
+
+      /* Chunks are stored in order and the first one covers line 0. */
+      if ((i == 0 && chunk.start != 0)
+          || (i > 0 && chunk.start
+                <= APR_ARRAY_IDX(result, i - 1, struct cached_chunk).start))
+        return svn_error_trace(svn_stream_close(stream));
+
+      APR_ARRAY_PUSH(result, struct cached_chunk) = chunk;
+    }
+
+  /* The remainder of the entry is the file's text at *CACHED_END. */
+  SVN_ERR(svn_stream_open_unique(&fulltext, fulltext_path, NULL,
+                                 svn_io_file_del_on_pool_cleanup,
+                                 result_pool, scratch_pool));
+  SVN_ERR(svn_stream_copy3(stream, fulltext, NULL, NULL, scratch_pool));
+
+  *chunks = result;
+  return SVN_NO_ERROR;
+}
+
+/* Write a cache entry to CACHE_PATH recording CHAIN, the blame table of
+   the file FS_PATH in the repository identified by UUID over the range
+   [START_REV, END_REV], together with the file's text at END_REV which
+   lives in LAST_FILENAME. */
+static svn_error_t *
+blame_cache_save(const char *cache_path,
+                 const char *uuid,
+                 const char *fs_path,
+                 svn_revnum_t start_rev,
+                 svn_revnum_t end_rev,
+                 const struct blame_chain *chain,
+                 const char *last_filename,
+                 apr_pool_t *scratch_pool)
+{
+  svn_stream_t *stream;
+  svn_stream_t *fulltext;
+  const char *temp_path;
+  const struct blame *walk;
+  apr_int64_t nchunks = 0;
+
+  for (walk = chain->blame; walk; walk = walk->next)
+    nchunks++;
+
+  SVN_ERR(svn_io_make_dir_recursively(svn_dirent_dirname(cache_path,
+                                                         scratch_pool),
+                                      scratch_pool));
+  SVN_ERR(svn_stream_open_unique(&stream, &temp_path,
+                                 svn_dirent_dirname(cache_path,
+                                                    scratch_pool),
+                                 svn_io_file_del_on_pool_cleanup,
+                                 scratch_pool, scratch_pool));
+
+  SVN_ERR(svn_stream_printf(stream, scratch_pool,
+                            "%d\n%s\n%s\n%ld %ld\n%" APR_INT64_T_FMT "\n",
+                            BLAME_CACHE_FORMAT, uuid, fs_path,
+                            start_rev, end_rev, nchunks));
+  for (walk = chain->blame; walk; walk = walk->next)
+    SVN_ERR(svn_stream_printf(stream, scratch_pool,
+                              "%" APR_OFF_T_FMT " %ld\n", walk->start,
+                              walk->rev ? walk->rev->revision
+                                        : SVN_INVALID_REVNUM));
+
+  SVN_ERR(svn_stream_open_readonly(&fulltext, last_filename, scratch_pool,
+                                   scratch_pool));
+  SVN_ERR(svn_stream_copy3(fulltext, stream, NULL, NULL, scratch_pool));
+
+  SVN_ERR(svn_io_file_rename2(temp_path, cache_path, FALSE, scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+
 svn_error_t *
 svn_client_blame6(svn_revnum_t *start_revnum_p,
                   svn_revnum_t *end_revnum_p,
@@ -680,6 +1029,13 @@ svn_client_blame6(svn_revnum_t *start_revnum_p,
   svn_stream_t *last_stream;
   svn_stream_t *stream;
   const char *target_abspath_or_url;
+  const char *session_url;
+  const char *cache_path = NULL;
+  const char *cache_uuid = NULL;
+  const char *cache_fs_path = NULL;
+  apr_array_header_t *cached_chunks = NULL;
+  svn_revnum_t cached_end = SVN_INVALID_REVNUM;
+  const char *cached_fulltext = NULL;
 
   if (start->kind == svn_opt_revision_unspecified
       || end->kind == svn_opt_revision_unspecified)
@@ -721,6 +1077,8 @@ svn_client_blame6(svn_revnum_t *start_revnum_p,
 
     /* Make the session point to the real URL. */
     SVN_ERR(svn_ra_reparent(ra_session, loc->url, pool));
+
+    session_url = loc->url;
   }
 
   /* We check the mime-type of the yougest revision before getting all
@@ -798,9 +1156,80 @@ svn_client_blame6(svn_revnum_t *start_revnum_p,
   frb.last_revnum = SVN_INVALID_REVNUM;
   frb.last_props = NULL;
   frb.check_mime_type = (frb.backwards && !ignore_mime_type);
+  frb.resumed = FALSE;
+  frb.resumed_end = SVN_INVALID_REVNUM;
 
   SVN_ERR(svn_ra_get_repos_root2(ra_session, &frb.repos_root_url, pool));
 
+  /* Probe the persistent blame cache, if it is enabled.  Merge-aware
+     blame tracks a second chain across other lines of history and
+     backwards blame attributes changes to the following revision, so
+     only plain forward blame is cached. */
+  if (!include_merged_revisions && !frb.backwards)
+    {
+      SVN_ERR(svn_ra_get_uuid2(ra_session, &cache_uuid, pool));
+      cache_fs_path = svn_uri_skip_ancestor(frb.repos_root_url, session_url,
+                                            pool);
+      if (cache_fs_path)
+        SVN_ERR(blame_cache_path(&cache_path, cache_uuid, cache_fs_path,
+                                 ctx, pool));
+
+      if (cache_path)
+        {
+          /* A broken or unreadable entry is no reason to fail the blame;
+             just compute it from scratch (and overwrite the entry). */
+          svn_error_t *err = blame_cache_load(&cached_chunks, &cached_end,
+                                              &cached_fulltext, cache_path,
+                                              cache_uuid, cache_fs_path,
+                                              start_revnum, end_revnum,
+                                              pool, pool);
+          if (err)
+            {
+              svn_error_clear(err);
+              cached_chunks = NULL;
+            }
+        }
+    }
+
+  if (cached_chunks)
+    {
+      /* Seed the blame chain from the cached table.  Revision properties
+         are not cached; fetch them again for each distinct revision in
+         the table. */
+      apr_hash_t *rev_structs = apr_hash_make(pool);
+      struct blame **tail = &frb.chain->blame;
+      int i;
+
+      for (i = 0; i < cached_chunks->nelts; i++)
+        {
+          const struct cached_chunk *chunk
+            = &APR_ARRAY_IDX(cached_chunks, i, struct cached_chunk);
+          struct rev *rev = NULL;
+
+          if (SVN_IS_VALID_REVNUM(chunk->revision))
+            {
+              rev = apr_hash_get(rev_structs, &chunk->revision,
+                                 sizeof(chunk->revision));
+              if (rev == NULL)
+                {
+                  rev = apr_pcalloc(pool, sizeof(*rev));
+                  rev->revision = chunk->revision;
+                  SVN_ERR(svn_ra_rev_proplist(ra_session, chunk->revision,
+                                              &rev->rev_props, pool));
+                  apr_hash_set(rev_structs, &rev->revision,
+                               sizeof(rev->revision), rev);
+                }
+            }
+
+          *tail = blame_create(frb.chain, rev, chunk->start);
+          tail = &(*tail)->next;
+        }
+
+      frb.last_filename = cached_fulltext;
+      frb.resumed = TRUE;
+      frb.resumed_end = cached_end;
+    }
+
   frb.mainpool = pool;
   /* The callback will flip the following two pools, because it needs
      information from the previous call.  Obviously, it can't rely on
@@ -816,13 +1245,33 @@ svn_client_blame6(svn_revnum_t *start_revnum_p,
   /* Collect all blame information.
      We need to ensure that we get one revision before the start_rev,
      if available so that we can know what was actually changed in the start
-     revision. */
-  SVN_ERR(svn_ra_get_file_revs2(ra_session, "",
-                                frb.backwards ? start_revnum
-                                              : MAX(0, start_revnum-1),
-                                end_revnum,
-                                include_merged_revisions,
-                                file_rev_handler, &frb, pool));
+     revision.  When resuming from a cached table we start at its end
+     revision instead; if nothing interesting happened since, the walk
+     reports a no-op change against the text we already have.  If the
+     cache covers the requested end revision there is nothing to fetch
+     at all. */
+  if (!(frb.resumed && cached_end == end_revnum))
+    SVN_ERR(svn_ra_get_file_revs2(ra_session, "",
+                                  frb.resumed ? cached_end
+                                    : frb.backwards ? start_revnum
+                                                    : MAX(0, start_revnum-1),
+                                  end_revnum,
+                                  include_merged_revisions,
+                                  file_rev_handler, &frb, pool));
+
+  /* Remember the result for the next blame of this file.  Local
+     modifications have not been blended in yet, so the chain and the
+     last file still describe the end revision.  Failing to write the
+     cache never fails the blame itself. */
+  if (cache_path && frb.last_filename && frb.chain->blame
+      && !(frb.resumed && cached_end == end_revnum))
+    {
+      svn_error_t *err = blame_cache_save(cache_path, cache_uuid,
+                                          cache_fs_path, start_revnum,
+                                          end_revnum, frb.chain,
+                                          frb.last_filename, pool);
+      svn_error_clear(err);
+    }
 
   if (end->kind == svn_opt_revision_working)
     {
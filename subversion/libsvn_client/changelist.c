@@ -41,46 +41,60 @@
 
 
 
-svn_error_t *
-svn_client_add_to_changelist(const apr_array_header_t *paths,
-                             const char *changelist,
-                             svn_depth_t depth,
-                             const apr_array_header_t *changelists,
-                             svn_client_ctx_t *ctx,
-                             apr_pool_t *pool)
+/* Convert PATHS to an array of absolute paths, returned in
+   *LOCAL_ABSPATHS (allocated in RESULT_POOL), erroring out if any of
+   them is a URL. */
+static svn_error_t *
+check_paths(apr_array_header_t **local_abspaths,
+            const apr_array_header_t *paths,
+            apr_pool_t *result_pool)
 {
-  apr_pool_t *iterpool = svn_pool_create(pool);
   int i;
 
-  if (changelist[0] == '\0')
-    return svn_error_create(SVN_ERR_BAD_CHANGELIST_NAME, NULL,
-                            _("Target changelist name must not be empty"));
+  *local_abspaths = apr_array_make(result_pool, paths->nelts,
+                                   sizeof(const char *));
 
   for (i = 0; i < paths->nelts; i++)
     {
       const char *path = APR_ARRAY_IDX(paths, i, const char *);
+      const char *local_abspath;
 
       if (svn_path_is_url(path))
         return svn_error_createf(SVN_ERR_ILLEGAL_TARGET, NULL,
                                  _("'%s' is not a local path"), path);
+
+      SVN_ERR(svn_dirent_get_absolute(&local_abspath, path, result_pool));
+      APR_ARRAY_PUSH(*local_abspaths, const char *) = local_abspath;
     }
 
-  for (i = 0; i < paths->nelts; i++)
-    {
-      const char *path = APR_ARRAY_IDX(paths, i, const char *);
-      const char *local_abspath;
+  return SVN_NO_ERROR;
+}
 
-      svn_pool_clear(iterpool);
-      SVN_ERR(svn_dirent_get_absolute(&local_abspath, path, iterpool));
 
-      SVN_ERR(svn_wc_set_changelist2(ctx->wc_ctx, local_abspath, changelist,
-                                     depth, changelists,
-                                     ctx->cancel_func, ctx->cancel_baton,
-                                     ctx->notify_func2, ctx->notify_baton2,
-                                     iterpool));
-    }
+svn_error_t *
+svn_client_add_to_changelist(const apr_array_header_t *paths,
+                             const char *changelist,
+                             svn_depth_t depth,
+                             const apr_array_header_t *changelists,
+                             svn_client_ctx_t *ctx,
+                             apr_pool_t *pool)
+{
+  apr_array_header_t *local_abspaths;
+
+  if (changelist[0] == '\0')
+    return svn_error_create(SVN_ERR_BAD_CHANGELIST_NAME, NULL,
+                            _("Target changelist name must not be empty"));
+
+  SVN_ERR(check_paths(&local_abspaths, paths, pool));
+
+  /* Assign all targets in one go, so that each working copy involved
+     sees a single database transaction instead of one per target. */
+  SVN_ERR(svn_wc__set_changelist_many(ctx->wc_ctx, local_abspaths,
+                                      changelist, depth, changelists,
+                                      ctx->cancel_func, ctx->cancel_baton,
+                                      ctx->notify_func2, ctx->notify_baton2,
+                                      pool));
 
-  svn_pool_destroy(iterpool);
   return SVN_NO_ERROR;
 }
 
@@ -92,34 +106,16 @@ svn_client_remove_from_changelists(const apr_array_header_t *paths,
                                    svn_client_ctx_t *ctx,
                                    apr_pool_t *pool)
 {
-  apr_pool_t *iterpool = svn_pool_create(pool);
-  int i;
-
-  for (i = 0; i < paths->nelts; i++)
-    {
-      const char *path = APR_ARRAY_IDX(paths, i, const char *);
-
-      if (svn_path_is_url(path))
-        return svn_error_createf(SVN_ERR_ILLEGAL_TARGET, NULL,
-                                 _("'%s' is not a local path"), path);
-    }
+  apr_array_header_t *local_abspaths;
 
-  for (i = 0; i < paths->nelts; i++)
-    {
-      const char *path = APR_ARRAY_IDX(paths, i, const char *);
-      const char *local_abspath;
-
-      svn_pool_clear(iterpool);
-      SVN_ERR(svn_dirent_get_absolute(&local_abspath, path, iterpool));
+  SVN_ERR(check_paths(&local_abspaths, paths, pool));
 
-      SVN_ERR(svn_wc_set_changelist2(ctx->wc_ctx, local_abspath, NULL,
-                                     depth, changelists,
-                                     ctx->cancel_func, ctx->cancel_baton,
-                                     ctx->notify_func2, ctx->notify_baton2,
-                                     iterpool));
-    }
+  SVN_ERR(svn_wc__set_changelist_many(ctx->wc_ctx, local_abspaths,
+                                      NULL, depth, changelists,
+                                      ctx->cancel_func, ctx->cancel_baton,
+                                      ctx->notify_func2, ctx->notify_baton2,
+                                      pool));
 
-  svn_pool_destroy(iterpool);
   return SVN_NO_ERROR;
 }
 
@@ -226,6 +226,7 @@ svn_client__checkout_internal(svn_revnum_t *result_rev,
       else
         {
           svn_boolean_t wc_store_pristine;
+          svn_boolean_t locked;
 
           SVN_ERR(svn_wc__get_settings(NULL, &wc_store_pristine, ctx->wc_ctx,
                                        local_abspath, scratch_pool));
@@ -260,6 +261,28 @@ svn_client__checkout_internal(svn_revnum_t *result_rev,
                   " but its format is %d instead of the expected %d"),
                 svn_dirent_local_style(local_abspath, scratch_pool),
                 present_format, target_format);
+
+          /* An interrupted checkout leaves the target locked with
+             unfinished work queue items.  Since wc.db records which
+             directories are still incomplete, the update below will
+             re-fetch only the unfinished subtrees -- but it cannot run
+             until those locks are cleared.  Re-running the checkout is
+             the documented way to resume, so finish that business here
+             instead of bailing out and sending the user to
+             'svn cleanup' by hand.  (This carries the same caveat as a
+             manual cleanup: it will break the locks of a checkout that
+             is still running in another process.) */
+          SVN_ERR(svn_wc_locked2(NULL, &locked, ctx->wc_ctx, local_abspath,
+                                 scratch_pool));
+          if (locked)
+            SVN_ERR(svn_wc_cleanup4(ctx->wc_ctx, local_abspath,
+                                    TRUE /* break_locks */,
+                                    FALSE /* fix_recorded_timestamps */,
+                                    FALSE /* clear_dav_cache */,
+                                    FALSE /* vacuum_pristines */,
+                                    ctx->cancel_func, ctx->cancel_baton,
+                                    ctx->notify_func2, ctx->notify_baton2,
+                                    scratch_pool));
         }
     }
   else
@@ -40,12 +40,17 @@
 #include "private/svn_client_private.h"
 #include "private/svn_diff_tree.h"
 #include "private/svn_editor.h"
+#include "private/svn_task.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
 
+/* A cache of idle RA sessions for reuse across operations.
+   Defined in ra.c. */
+typedef struct svn_client__ra_session_cache_t svn_client__ra_session_cache_t;
+
 /* Private client context.
  *
  * This is what is actually allocated by svn_client_create_context2(),
@@ -63,6 +68,14 @@ typedef struct svn_client__private_ctx_t
   /* Total number of bytes transferred over network across all RA sessions. */
   apr_off_t total_progress;
 
+  /* The pool that the context itself got allocated in, i.e. the pool
+     with the same lifetime as the context. */
+  apr_pool_t *pool;
+
+  /* Cache of idle RA sessions for reuse across operations within this
+     context.  NULL until the first cacheable session gets opened. */
+  svn_client__ra_session_cache_t *ra_session_cache;
+
   /* The public context. */
   svn_client_ctx_t public_ctx;
 } svn_client__private_ctx_t;
@@ -73,6 +86,32 @@ typedef struct svn_client__private_ctx_t
 svn_client__private_ctx_t *
 svn_client__get_private_ctx(svn_client_ctx_t *ctx);
 
+/* Run a task tree (see svn_task.h) on behalf of a client operation
+   driven by CTX.  Defined in util.c.
+
+   Like svn_task__run(), employ up to THREAD_COUNT worker threads and
+   process the root task with PROCESS_FUNC and PROCESS_BATON, sending
+   its results through OUTPUT_FUNC called with OUTPUT_BATON.  Worker
+   thread contexts are created with CONTEXT_CONSTRUCTOR and
+   CONTEXT_BATON, if given.  Any of the callbacks may be NULL.
+
+   Unlike with a plain svn_task__run(), CTX->cancel_func does not need
+   to be thread-safe:  it is only ever invoked from the thread calling
+   this function, while worker tasks merely poll a flag that sticks once
+   cancellation has been detected. */
+svn_error_t *
+svn_client__run_tasks(apr_int32_t thread_count,
+                      svn_task__process_func_t process_func,
+                      void *process_baton,
+                      svn_task__output_func_t output_func,
+                      void *output_baton,
+                      svn_task__thread_context_constructor_t
+                        context_constructor,
+                      void *context_baton,
+                      svn_client_ctx_t *ctx,
+                      apr_pool_t *result_pool,
+                      apr_pool_t *scratch_pool);
+
 /* Set *ORIGINAL_REPOS_RELPATH and *ORIGINAL_REVISION to the original location
    that served as the source of the copy from which PATH_OR_URL at REVISION was
    created, or NULL and SVN_INVALID_REVNUM (respectively) if PATH_OR_URL at
@@ -51,6 +51,12 @@
 #define SVN_CLIENT_COMMIT_DEBUG
 */
 
+/* The maximum number of file batons we keep open during an editor drive
+   before transmitting their text deltas.  Each open baton pins a subpool
+   and a temporary file, so without a bound the peak memory usage of a
+   commit scales with the number of modified files. */
+#define MAX_OUTSTANDING_FILE_MODS 1000
+
 /* Wrap an RA error in a nicer error if one is available. */
 static svn_error_t *
 fixup_commit_error(const char *local_abspath,
@@ -1530,14 +1536,100 @@ struct item_commit_baton
   svn_client_ctx_t *ctx;               /* client context baton */
   apr_hash_t *commit_items;            /* the committables */
   const char *base_url;                /* The session url for the commit */
+  apr_hash_t *sha1_checksums;          /* maps paths to checksums; NULL if
+                                          the caller doesn't want them */
+  apr_pool_t *result_pool;             /* pool for the checksums */
 };
 
+/* Transmit the text deltas for all file modifications collected in
+ * ICB->file_mods (a hash of "item-url => file_mod_t *") to EDITOR,
+ * closing the file batons and destroying the associated pools.  Clear
+ * ICB->file_mods when done.
+ *
+ * This is called whenever the number of open file batons reaches
+ * MAX_OUTSTANDING_FILE_MODS while the editor drive is still in progress
+ * --- keeping the commit's memory usage bounded and getting the text
+ * data flowing early --- and once more after the drive has completed.
+ */
+static svn_error_t *
+transmit_file_mods(struct item_commit_baton *icb,
+                   const svn_delta_editor_t *editor,
+                   apr_pool_t *scratch_pool)
+{
+  svn_client_ctx_t *ctx = icb->ctx;
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  apr_hash_index_t *hi;
+
+  for (hi = apr_hash_first(scratch_pool, icb->file_mods);
+       hi;
+       hi = apr_hash_next(hi))
+    {
+      struct file_mod_t *mod = apr_hash_this_val(hi);
+      const svn_client_commit_item3_t *item = mod->item;
+      const svn_checksum_t *new_text_base_md5_checksum;
+      const svn_checksum_t *new_text_base_sha1_checksum;
+      svn_boolean_t fulltext = FALSE;
+      svn_error_t *err;
+
+      svn_pool_clear(iterpool);
+
+      /* Transmit the entry. */
+      if (ctx->cancel_func)
+        SVN_ERR(ctx->cancel_func(ctx->cancel_baton));
+
+      if (ctx->notify_func2)
+        {
+          svn_wc_notify_t *notify;
+          notify = svn_wc_create_notify(item->path,
+                                        svn_wc_notify_commit_postfix_txdelta,
+                                        iterpool);
+          notify->kind = svn_node_file;
+          notify->path_prefix = icb->notify_path_prefix;
+          ctx->notify_func2(ctx->notify_baton2, notify, iterpool);
+        }
+
+      /* If the node has no history, transmit full text */
+      if ((item->state_flags & SVN_CLIENT_COMMIT_ITEM_ADD)
+          && ! (item->state_flags & SVN_CLIENT_COMMIT_ITEM_IS_COPY))
+        fulltext = TRUE;
+
+      err = svn_wc_transmit_text_deltas4(&new_text_base_md5_checksum,
+                                         &new_text_base_sha1_checksum,
+                                         ctx->wc_ctx, item->path,
+                                         fulltext, editor, mod->file_baton,
+                                         icb->result_pool, iterpool);
+
+      if (err)
+        {
+          svn_pool_destroy(iterpool); /* Close tempfiles */
+          return svn_error_trace(fixup_commit_error(item->path,
+                                                    icb->base_url,
+                                                    item->session_relpath,
+                                                    svn_node_file,
+                                                    err, ctx, scratch_pool));
+        }
+
+      if (icb->sha1_checksums)
+        svn_hash_sets(icb->sha1_checksums, item->path,
+                      new_text_base_sha1_checksum);
+
+      svn_pool_destroy(mod->file_pool);
+    }
+
+  svn_pool_destroy(iterpool);
+  apr_hash_clear(icb->file_mods);
+
+  return SVN_NO_ERROR;
+}
+
 
 /* Drive CALLBACK_BATON->editor with the change described by the item in
  * CALLBACK_BATON->commit_items that is keyed by PATH.  If the change
  * includes a text mod, however, call the editor's file_open() function
  * but do not send the text mod to the editor; instead, add a mapping of
  * "item-url => (commit-item, file-baton)" into CALLBACK_BATON->file_mods.
+ * When that hash reaches MAX_OUTSTANDING_FILE_MODS entries, transmit and
+ * release the collected batons before continuing the drive.
  *
  * Before driving the editor, call the cancellation and notification
  * callbacks in CALLBACK_BATON->ctx, if present.
@@ -1836,6 +1928,13 @@ do_item_commit(void **dir_baton,
       mod->file_baton = file_baton;
       mod->file_pool = file_pool;
       svn_hash_sets(file_mods, item->session_relpath, mod);
+
+      /* Don't let the set of open file batons grow without bound; on
+         large commits that would keep one baton, pool and tempfile per
+         modified file alive until the end of the drive.  Any error is
+         already wrapped by fixup_commit_error(), so don't wrap again. */
+      if (apr_hash_count(file_mods) >= MAX_OUTSTANDING_FILE_MODS)
+        SVN_ERR(transmit_file_mods(icb, editor, pool));
     }
   else if (file_baton)
     {
@@ -1870,7 +1969,6 @@ svn_client__do_commit(const char *base_url,
   apr_hash_t *file_mods = apr_hash_make(scratch_pool);
   apr_hash_t *items_hash = apr_hash_make(scratch_pool);
   apr_pool_t *iterpool = svn_pool_create(scratch_pool);
-  apr_hash_index_t *hi;
   int i;
   struct item_commit_baton cb_baton;
   apr_array_header_t *paths =
@@ -1898,66 +1996,16 @@ svn_client__do_commit(const char *base_url,
   cb_baton.ctx = ctx;
   cb_baton.commit_items = items_hash;
   cb_baton.base_url = base_url;
+  cb_baton.sha1_checksums = sha1_checksums ? *sha1_checksums : NULL;
+  cb_baton.result_pool = result_pool;
 
-  /* Drive the commit editor! */
+  /* Drive the commit editor!  Text deltas are transmitted in batches
+     along the way; see transmit_file_mods(). */
   SVN_ERR(svn_delta_path_driver3(editor, edit_baton, paths, TRUE,
                                  do_item_commit, &cb_baton, scratch_pool));
 
   /* Transmit outstanding text deltas. */
-  for (hi = apr_hash_first(scratch_pool, file_mods);
-       hi;
-       hi = apr_hash_next(hi))
-    {
-      struct file_mod_t *mod = apr_hash_this_val(hi);
-      const svn_client_commit_item3_t *item = mod->item;
-      const svn_checksum_t *new_text_base_md5_checksum;
-      const svn_checksum_t *new_text_base_sha1_checksum;
-      svn_boolean_t fulltext = FALSE;
-      svn_error_t *err;
-
-      svn_pool_clear(iterpool);
-
-      /* Transmit the entry. */
-      if (ctx->cancel_func)
-        SVN_ERR(ctx->cancel_func(ctx->cancel_baton));
-
-      if (ctx->notify_func2)
-        {
-          svn_wc_notify_t *notify;
-          notify = svn_wc_create_notify(item->path,
-                                        svn_wc_notify_commit_postfix_txdelta,
-                                        iterpool);
-          notify->kind = svn_node_file;
-          notify->path_prefix = notify_path_prefix;
-          ctx->notify_func2(ctx->notify_baton2, notify, iterpool);
-        }
-
-      /* If the node has no history, transmit full text */
-      if ((item->state_flags & SVN_CLIENT_COMMIT_ITEM_ADD)
-          && ! (item->state_flags & SVN_CLIENT_COMMIT_ITEM_IS_COPY))
-        fulltext = TRUE;
-
-      err = svn_wc_transmit_text_deltas4(&new_text_base_md5_checksum,
-                                         &new_text_base_sha1_checksum,
-                                         ctx->wc_ctx, item->path,
-                                         fulltext, editor, mod->file_baton,
-                                         result_pool, iterpool);
-
-      if (err)
-        {
-          svn_pool_destroy(iterpool); /* Close tempfiles */
-          return svn_error_trace(fixup_commit_error(item->path,
-                                                    base_url,
-                                                    item->session_relpath,
-                                                    svn_node_file,
-                                                    err, ctx, scratch_pool));
-        }
-
-      if (sha1_checksums)
-        svn_hash_sets(*sha1_checksums, item->path, new_text_base_sha1_checksum);
-
-      svn_pool_destroy(mod->file_pool);
-    }
+  SVN_ERR(transmit_file_mods(&cb_baton, editor, scratch_pool));
 
   if (ctx->notify_func2)
     {
@@ -57,6 +57,7 @@
 #include "private/svn_subr_private.h"
 #include "private/svn_io_private.h"
 #include "private/svn_ra_private.h"
+#include "private/svn_task.h"
 
 #include "svn_private_config.h"
 
@@ -688,6 +689,10 @@ display_prop_diffs(const apr_array_header_t *propchanges,
 
 /*** Callbacks for 'svn diff', invoked by the repos-diff editor. ***/
 
+/* State shared between the diff tree walk and the worker tasks of a
+   parallel diff run; see do_diff_parallel(). */
+typedef struct parallel_diff_driver_t parallel_diff_driver_t;
+
 /* Diff writer state */
 typedef struct diff_writer_info_t
 {
@@ -748,6 +753,10 @@ typedef struct diff_writer_info_t
   svn_cancel_func_t cancel_func;
   void *cancel_baton;
 
+  /* During a parallel diff run, the driver state shared with the worker
+     tasks.  NULL in ordinary single-threaded operation. */
+  parallel_diff_driver_t *parallel;
+
   struct diff_driver_info_t ddi;
 } diff_writer_info_t;
 
@@ -1122,6 +1131,266 @@ diff_content_changed(svn_boolean_t *wrote_header,
   return SVN_NO_ERROR;
 }
 
+/* Number of worker tasks used to compute per-file text diffs.  The tree
+   walk runs as one further task, so values below 2 effectively restore
+   single-threaded operation.  Writing the results out happens in the main
+   thread and remains strictly ordered. */
+#define DIFF_PROCESSING_THREADS 8
+
+/* See the typedef earlier in this file. */
+struct parallel_diff_driver_t
+{
+  /* The root task running the tree walk; per-file diffs get added to it
+     as sub-tasks. */
+  svn_task__t *task;
+
+  /* The result pool of the root task's process function.  Partial output
+     buffers must be allocated here. */
+  apr_pool_t *result_pool;
+
+  /* The stream that the user wants the diff to be written to.  Only the
+     main thread may write to it. */
+  svn_stream_t *outstream;
+
+  /* Output produced by the tree walk since the last sub-task was added.
+     DWI->outstream appends to this while the walk is running. */
+  svn_stringbuf_t *buffer;
+};
+
+/* Parameters of one file diff that has been handed over to a worker task.
+   All pointers reference memory in the task's process pool, i.e. they
+   remain valid until the task has been processed. */
+typedef struct parallel_file_diff_baton_t
+{
+  /* Path of the file being diffed, relative to the walk anchor. */
+  const char *relpath;
+
+  /* Left and right version of the file contents.  Both NULL if only
+     properties changed. */
+  const char *left_file;
+  const char *right_file;
+
+  /* The revisions being compared. */
+  svn_revnum_t rev1;
+  svn_revnum_t rev2;
+
+  /* Properties of the left and right version.  The right one may be NULL
+     for deletions. */
+  apr_hash_t *left_props;
+  apr_hash_t *right_props;
+
+  /* Parameters to diff_content_changed(), as determined by the respective
+     tree processor callback. */
+  svn_diff_operation_kind_t operation;
+  svn_boolean_t force_diff;
+  const char *copyfrom_path;
+  svn_revnum_t copyfrom_rev;
+
+  /* Property changes to show after the text diff, or NULL. */
+  apr_array_header_t *prop_changes;
+
+  /* Snapshot of the diff writer state at the time the task was created.
+     The tree walk may modify e.g. the DDI sub-structure while this task
+     is still pending; string members we depend on have therefore been
+     copied into the process pool. */
+  diff_writer_info_t dwi;
+} parallel_file_diff_baton_t;
+
+/* Implements svn_write_fn_t.  Append DATA to the output buffer of the
+   parallel_diff_driver_t given by BATON. */
+static svn_error_t *
+parallel_diff_write(void *baton,
+                    const char *data,
+                    apr_size_t *len)
+{
+  parallel_diff_driver_t *pdd = baton;
+
+  svn_stringbuf_appendbytes(pdd->buffer, data, *len);
+  return SVN_NO_ERROR;
+}
+
+/* Return the output that the tree walk accumulated in PDD since the last
+   call to this function, to be attached to the next sub-task as partial
+   output.  Return NULL if there is none. */
+static void *
+parallel_diff_take_output(parallel_diff_driver_t *pdd)
+{
+  svn_stringbuf_t *buffer = pdd->buffer;
+
+  if (buffer->len == 0)
+    return NULL;
+
+  pdd->buffer = svn_stringbuf_create_empty(pdd->result_pool);
+  return buffer;
+}
+
+/* Implements svn_task__output_func_t.  Write the buffered diff text in
+   RESULT to the output stream given by OUTPUT_BATON. */
+static svn_error_t *
+parallel_diff_output(svn_task__t *task,
+                     void *result,
+                     void *output_baton,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  svn_stringbuf_t *buffer = result;
+  svn_stream_t *outstream = output_baton;
+  apr_size_t len = buffer->len;
+
+  return svn_error_trace(svn_stream_write(outstream, buffer->data, &len));
+}
+
+/* Copy the file at SRC, which may be a temporary file that gets deleted
+   as soon as the current tree processor callback returns, to a new file
+   that lives and dies with the task pool RESULT_POOL.  Set *DST to the
+   copy's path, allocated in RESULT_POOL. */
+static svn_error_t *
+parallel_diff_keep_file(const char **dst,
+                        const char *src,
+                        apr_pool_t *result_pool,
+                        apr_pool_t *scratch_pool)
+{
+  apr_file_t *file;
+
+  SVN_ERR(svn_io_open_unique_file3(&file, dst, NULL,
+                                   svn_io_file_del_on_pool_cleanup,
+                                   result_pool, scratch_pool));
+  SVN_ERR(svn_io_file_close(file, scratch_pool));
+  SVN_ERR(svn_io_copy_file(src, *dst, FALSE, scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__process_func_t.  Produce the diff output for the
+   file described by the parallel_file_diff_baton_t in PROCESS_BATON,
+   writing it into a string buffer returned in *RESULT.  Runs in a worker
+   thread. */
+static svn_error_t *
+parallel_file_diff_process(void **result,
+                           svn_task__t *task,
+                           void *thread_context,
+                           void *process_baton,
+                           svn_cancel_func_t cancel_func,
+                           void *cancel_baton,
+                           apr_pool_t *result_pool,
+                           apr_pool_t *scratch_pool)
+{
+  parallel_file_diff_baton_t *pb = process_baton;
+  svn_stringbuf_t *buffer = svn_stringbuf_create_empty(result_pool);
+  diff_writer_info_t dwi = pb->dwi;
+  svn_boolean_t wrote_header = FALSE;
+
+  dwi.outstream = svn_stream_from_stringbuf(buffer, result_pool);
+  dwi.cancel_func = cancel_func;
+  dwi.cancel_baton = cancel_baton;
+
+  if (pb->left_file && pb->right_file)
+    SVN_ERR(diff_content_changed(&wrote_header, pb->relpath,
+                                 pb->left_file, pb->right_file,
+                                 pb->rev1, pb->rev2,
+                                 pb->left_props, pb->right_props,
+                                 pb->operation, pb->force_diff,
+                                 pb->copyfrom_path, pb->copyfrom_rev,
+                                 &dwi, scratch_pool));
+
+  if (pb->prop_changes && pb->prop_changes->nelts > 0)
+    SVN_ERR(diff_props_changed(pb->relpath, pb->rev1, pb->rev2,
+                               pb->prop_changes,
+                               pb->left_props, pb->right_props,
+                               ! wrote_header, &dwi, scratch_pool));
+
+  *result = buffer->len ? buffer : NULL;
+  return SVN_NO_ERROR;
+}
+
+/* Hand the diff of one file over to a worker task of the parallel diff
+   run that DWI belongs to.  The parameters correspond to those of
+   diff_content_changed() and diff_props_changed(); see
+   parallel_file_diff_baton_t for their meaning.  Any of them that
+   reference callback-local memory get copied into the task's process
+   pool.  Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+parallel_file_diff_add(diff_writer_info_t *dwi,
+                       const char *relpath,
+                       const char *left_file,
+                       const char *right_file,
+                       svn_revnum_t rev1,
+                       svn_revnum_t rev2,
+                       apr_hash_t *left_props,
+                       apr_hash_t *right_props,
+                       svn_diff_operation_kind_t operation,
+                       svn_boolean_t force_diff,
+                       const char *copyfrom_path,
+                       svn_revnum_t copyfrom_rev,
+                       const apr_array_header_t *prop_changes,
+                       apr_pool_t *scratch_pool)
+{
+  parallel_diff_driver_t *pdd = dwi->parallel;
+  apr_pool_t *process_pool;
+  parallel_file_diff_baton_t *pb;
+
+  /* Nothing to diff, nothing to queue. */
+  if (!(left_file && right_file)
+      && !(prop_changes && prop_changes->nelts > 0))
+    return SVN_NO_ERROR;
+
+  process_pool = svn_task__create_process_pool(pdd->task);
+  pb = apr_pcalloc(process_pool, sizeof(*pb));
+
+  pb->relpath = apr_pstrdup(process_pool, relpath);
+  if (left_file && right_file)
+    {
+      /* The temp files only live for the duration of the callback while
+         the task may run long after it returned.  Keep private copies;
+         they come straight from the page cache and are cheap compared to
+         the diff algorithm runs we take off the critical path. */
+      SVN_ERR(parallel_diff_keep_file(&pb->left_file, left_file,
+                                      process_pool, scratch_pool));
+      SVN_ERR(parallel_diff_keep_file(&pb->right_file, right_file,
+                                      process_pool, scratch_pool));
+    }
+  pb->rev1 = rev1;
+  pb->rev2 = rev2;
+  if (left_props)
+    pb->left_props = svn_prop_hash_dup(left_props, process_pool);
+  if (right_props)
+    pb->right_props = svn_prop_hash_dup(right_props, process_pool);
+  pb->operation = operation;
+  pb->force_diff = force_diff;
+  if (copyfrom_path)
+    pb->copyfrom_path = apr_pstrdup(process_pool, copyfrom_path);
+  pb->copyfrom_rev = copyfrom_rev;
+  if (prop_changes && prop_changes->nelts > 0)
+    pb->prop_changes = svn_prop_array_dup(prop_changes, process_pool);
+
+  /* Snapshot the writer state.  The walk may update the DDI members for
+     later portions of the tree, so keep our own copies of the strings
+     that the header output depends on. */
+  pb->dwi = *dwi;
+  pb->dwi.parallel = NULL;
+  pb->dwi.outstream = NULL;
+  pb->dwi.pool = process_pool;
+  if (dwi->ddi.anchor)
+    pb->dwi.ddi.anchor = apr_pstrdup(process_pool, dwi->ddi.anchor);
+  if (dwi->ddi.orig_path_1)
+    pb->dwi.ddi.orig_path_1 = apr_pstrdup(process_pool,
+                                          dwi->ddi.orig_path_1);
+  if (dwi->ddi.orig_path_2)
+    pb->dwi.ddi.orig_path_2 = apr_pstrdup(process_pool,
+                                          dwi->ddi.orig_path_2);
+  if (dwi->ddi.session_relpath)
+    pb->dwi.ddi.session_relpath = apr_pstrdup(process_pool,
+                                              dwi->ddi.session_relpath);
+
+  return svn_error_trace(svn_task__add(pdd->task, process_pool,
+                                       parallel_diff_take_output(pdd),
+                                       parallel_file_diff_process, pb,
+                                       parallel_diff_output,
+                                       pdd->outstream));
+}
+
 /* An svn_diff_tree_processor_t callback. */
 static svn_error_t *
 diff_file_changed(const char *relpath,
@@ -1140,6 +1409,18 @@ diff_file_changed(const char *relpath,
   diff_writer_info_t *dwi = processor->baton;
   svn_boolean_t wrote_header = FALSE;
 
+  if (dwi->parallel)
+    return svn_error_trace(parallel_file_diff_add(
+                             dwi, relpath,
+                             file_modified ? left_file : NULL,
+                             file_modified ? right_file : NULL,
+                             left_source->revision,
+                             right_source->revision,
+                             left_props, right_props,
+                             svn_diff_op_modified, FALSE,
+                             NULL, SVN_INVALID_REVNUM,
+                             prop_changes, scratch_pool));
+
   if (file_modified)
     SVN_ERR(diff_content_changed(&wrote_header, relpath,
                                  left_file, right_file,
@@ -1220,6 +1501,30 @@ diff_file_added(const char *relpath,
 
   SVN_ERR(svn_prop_diffs(&prop_changes, right_props, left_props, scratch_pool));
 
+  if (dwi->parallel)
+    return svn_error_trace(parallel_file_diff_add(
+                             dwi, relpath,
+                             right_file ? left_file : NULL,
+                             right_file,
+                             copyfrom_source ? copyfrom_source->revision
+                                             : DIFF_REVNUM_NONEXISTENT,
+                             right_source->revision,
+                             left_props, right_props,
+                             copyfrom_source
+                               ? (copyfrom_source->moved_from_relpath
+                                    ? svn_diff_op_moved
+                                    : svn_diff_op_copied)
+                               : svn_diff_op_added,
+                             TRUE /* force diff output */,
+                             copyfrom_source
+                               ? (copyfrom_source->moved_from_relpath
+                                    ? copyfrom_source->moved_from_relpath
+                                    : copyfrom_source->repos_relpath)
+                               : NULL,
+                             copyfrom_source ? copyfrom_source->revision
+                                             : SVN_INVALID_REVNUM,
+                             prop_changes, scratch_pool));
+
   if (copyfrom_source && right_file)
     SVN_ERR(diff_content_changed(&wrote_header, relpath,
                                  left_file, right_file,
@@ -1285,12 +1590,29 @@ diff_file_deleted(const char *relpath,
   else
     {
       svn_boolean_t wrote_header = FALSE;
+      apr_array_header_t *prop_changes = NULL;
 
       if (!dwi->empty_file)
         SVN_ERR(svn_io_open_unique_file3(NULL, &dwi->empty_file,
                                          NULL, svn_io_file_del_on_pool_cleanup,
                                          dwi->pool, scratch_pool));
 
+      if (left_props && apr_hash_count(left_props))
+        SVN_ERR(svn_prop_diffs(&prop_changes, apr_hash_make(scratch_pool),
+                               left_props, scratch_pool));
+
+      if (dwi->parallel)
+        return svn_error_trace(parallel_file_diff_add(
+                                 dwi, relpath,
+                                 left_file,
+                                 left_file ? dwi->empty_file : NULL,
+                                 left_source->revision,
+                                 DIFF_REVNUM_NONEXISTENT,
+                                 left_props, NULL,
+                                 svn_diff_op_deleted, FALSE,
+                                 NULL, SVN_INVALID_REVNUM,
+                                 prop_changes, scratch_pool));
+
       if (left_file)
         SVN_ERR(diff_content_changed(&wrote_header, relpath,
                                      left_file, dwi->empty_file,
@@ -1303,20 +1625,13 @@ diff_file_deleted(const char *relpath,
                                      dwi,
                                      scratch_pool));
 
-      if (left_props && apr_hash_count(left_props))
-        {
-          apr_array_header_t *prop_changes;
-
-          SVN_ERR(svn_prop_diffs(&prop_changes, apr_hash_make(scratch_pool),
-                                 left_props, scratch_pool));
-
-          SVN_ERR(diff_props_changed(relpath,
-                                     left_source->revision,
-                                     DIFF_REVNUM_NONEXISTENT,
-                                     prop_changes,
-                                     left_props, NULL,
-                                     ! wrote_header, dwi, scratch_pool));
-        }
+      if (prop_changes)
+        SVN_ERR(diff_props_changed(relpath,
+                                   left_source->revision,
+                                   DIFF_REVNUM_NONEXISTENT,
+                                   prop_changes,
+                                   left_props, NULL,
+                                   ! wrote_header, dwi, scratch_pool));
     }
 
   return SVN_NO_ERROR;
@@ -2569,6 +2884,149 @@ do_diff(diff_driver_info_t *ddi,
   return SVN_NO_ERROR;
 }
 
+/* Baton for parallel_diff_process(), bundling the arguments of
+   do_diff(). */
+struct parallel_diff_baton_t
+{
+  diff_driver_info_t *ddi;
+  const char *path_or_url1;
+  const char *path_or_url2;
+  const svn_opt_revision_t *revision1;
+  const svn_opt_revision_t *revision2;
+  const svn_opt_revision_t *peg_revision;
+  svn_boolean_t no_peg_revision;
+  svn_depth_t depth;
+  svn_boolean_t ignore_ancestry;
+  const apr_array_header_t *changelists;
+  const svn_diff_tree_processor_t *diff_processor;
+  svn_client_ctx_t *ctx;
+
+  /* The writer that DIFF_PROCESSOR reports to. */
+  diff_writer_info_t *dwi;
+
+  /* The stream that the user wants the diff to be written to. */
+  svn_stream_t *outstream;
+};
+
+/* Implements svn_task__process_func_t.  Run the diff tree walk described
+   by the parallel_diff_baton_t in PROCESS_BATON as the root task of a
+   parallel diff run.  The file-level tree processor callbacks will farm
+   the individual text diffs out as sub-tasks; everything else the walk
+   writes gets buffered and attached to those sub-tasks as partial output
+   so that the main thread reproduces it in the original order. */
+static svn_error_t *
+parallel_diff_process(void **result,
+                      svn_task__t *task,
+                      void *thread_context,
+                      void *process_baton,
+                      svn_cancel_func_t cancel_func,
+                      void *cancel_baton,
+                      apr_pool_t *result_pool,
+                      apr_pool_t *scratch_pool)
+{
+  struct parallel_diff_baton_t *pdb = process_baton;
+  diff_writer_info_t *dwi = pdb->dwi;
+  parallel_diff_driver_t pdd;
+  svn_stream_t *buffer_stream;
+  svn_error_t *err;
+
+  pdd.task = task;
+  pdd.result_pool = result_pool;
+  pdd.outstream = pdb->outstream;
+  pdd.buffer = svn_stringbuf_create_empty(result_pool);
+
+  buffer_stream = svn_stream_create(&pdd, scratch_pool);
+  svn_stream_set_write(buffer_stream, parallel_diff_write);
+
+  dwi->outstream = buffer_stream;
+  dwi->parallel = &pdd;
+  dwi->cancel_func = cancel_func;
+  dwi->cancel_baton = cancel_baton;
+
+  err = do_diff(pdb->ddi, pdb->path_or_url1, pdb->path_or_url2,
+                pdb->revision1, pdb->revision2,
+                pdb->peg_revision, pdb->no_peg_revision,
+                pdb->depth, pdb->ignore_ancestry, pdb->changelists,
+                TRUE /* text_deltas */,
+                pdb->diff_processor, pdb->ctx,
+                result_pool, scratch_pool);
+
+  dwi->parallel = NULL;
+  dwi->outstream = pdb->outstream;
+  SVN_ERR(err);
+
+  /* Whatever the walk wrote after the last file diff. */
+  *result = pdd.buffer->len ? pdd.buffer : NULL;
+  return SVN_NO_ERROR;
+}
+
+/* Run do_diff() with the given arguments, farming the per-file text
+   diffs out to DIFF_PROCESSING_THREADS worker tasks while the main
+   thread writes the results to the output stream in the original order.
+
+   DIFF_PROCESSOR must be one created by get_diff_processor().  Output
+   formats that a worker task cannot produce - external diff commands,
+   which write to the error stream, and git-style headers, which require
+   working copy database lookups - fall back to the ordinary sequential
+   walk.  Cancellation is proxied through svn_client__run_tasks(), so
+   CTX->cancel_func need not be thread-safe. */
+static svn_error_t *
+do_diff_parallel(diff_driver_info_t *ddi,
+                 const char *path_or_url1,
+                 const char *path_or_url2,
+                 const svn_opt_revision_t *revision1,
+                 const svn_opt_revision_t *revision2,
+                 const svn_opt_revision_t *peg_revision,
+                 svn_boolean_t no_peg_revision,
+                 svn_depth_t depth,
+                 svn_boolean_t ignore_ancestry,
+                 const apr_array_header_t *changelists,
+                 const svn_diff_tree_processor_t *diff_processor,
+                 svn_client_ctx_t *ctx,
+                 apr_pool_t *pool)
+{
+  diff_writer_info_t *dwi = diff_processor->baton;
+  struct parallel_diff_baton_t pdb;
+
+  if (dwi->diff_cmd || dwi->use_git_diff_format)
+    return svn_error_trace(do_diff(ddi, path_or_url1, path_or_url2,
+                                   revision1, revision2,
+                                   peg_revision, no_peg_revision,
+                                   depth, ignore_ancestry, changelists,
+                                   TRUE /* text_deltas */,
+                                   diff_processor, ctx, pool, pool));
+
+  /* The lazily created empty file is recorded in a pool that the walk,
+     running in a worker thread, must not touch; create it up front. */
+  if (!dwi->empty_file)
+    SVN_ERR(svn_io_open_unique_file3(NULL, &dwi->empty_file,
+                                     NULL, svn_io_file_del_on_pool_cleanup,
+                                     dwi->pool, pool));
+
+  pdb.ddi = ddi;
+  pdb.path_or_url1 = path_or_url1;
+  pdb.path_or_url2 = path_or_url2;
+  pdb.revision1 = revision1;
+  pdb.revision2 = revision2;
+  pdb.peg_revision = peg_revision;
+  pdb.no_peg_revision = no_peg_revision;
+  pdb.depth = depth;
+  pdb.ignore_ancestry = ignore_ancestry;
+  pdb.changelists = changelists;
+  pdb.diff_processor = diff_processor;
+  pdb.ctx = ctx;
+  pdb.dwi = dwi;
+  pdb.outstream = dwi->outstream;
+
+  return svn_error_trace(svn_client__run_tasks(DIFF_PROCESSING_THREADS,
+                                               parallel_diff_process, &pdb,
+                                               parallel_diff_output,
+                                               dwi->outstream,
+                                               NULL, NULL,
+                                               ctx,
+                                               pool, pool));
+}
+
 /* Initialize DWI.diff_cmd and DWI.options,
  * according to OPTIONS and CONFIG.  CONFIG and OPTIONS may be null.
  * Allocate the fields in RESULT_POOL, which should be at least as long-lived
@@ -2833,13 +3291,12 @@ svn_client_diff7(const apr_array_header_t *options,
                              outstream, errstream,
                              ctx, pool));
 
-  return svn_error_trace(do_diff(ddi,
+  return svn_error_trace(do_diff_parallel(ddi,
                                  path_or_url1, path_or_url2,
                                  revision1, revision2,
                                  &peg_revision, TRUE /* no_peg_revision */,
                                  depth, ignore_ancestry, changelists,
-                                 TRUE /* text_deltas */,
-                                 diff_processor, ctx, pool, pool));
+                                 diff_processor, ctx, pool));
 }
 
 svn_error_t *
@@ -2893,13 +3350,12 @@ svn_client_diff_peg7(const apr_array_header_t *options,
                              outstream, errstream,
                              ctx, pool));
 
-  return svn_error_trace(do_diff(ddi,
+  return svn_error_trace(do_diff_parallel(ddi,
                                  path_or_url, path_or_url,
                                  start_revision, end_revision,
                                  peg_revision, FALSE /* no_peg_revision */,
                                  depth, ignore_ancestry, changelists,
-                                 TRUE /* text_deltas */,
-                                 diff_processor, ctx, pool, pool));
+                                 diff_processor, ctx, pool));
 }
 
 svn_error_t *
@@ -747,6 +747,89 @@ handle_external_item_removal(const svn_client_ctx_t *ctx,
   return svn_error_trace(err);
 }
 
+/* A bounded pool of open RA sessions for the repositories that the
+   externals definitions of one working copy refer to.  Without it, every
+   external living in another repository than the parent working copy
+   would open - and pay the full connection and auth setup for - its own
+   session, only to discard it again immediately. */
+typedef struct session_pool_t
+{
+  /* Repository root URL -> svn_ra_session_t * mapping. */
+  apr_hash_t *sessions;
+
+  /* The sessions and their keys get allocated here, i.e. they survive
+     the per-item iteration pools. */
+  apr_pool_t *pool;
+} session_pool_t;
+
+/* Cap on the number of sessions - and hence open network connections -
+   kept in a session_pool_t.  Externals definitions usually refer to only
+   a handful of distinct repositories, so this is rarely reached. */
+#define SESSION_POOL_MAX_SESSIONS 8
+
+/* Set *RA_SESSION to an RA session for URL and *NEW_LOC to the resolved
+   location of URL at PEG_REVISION / REVISION.  Reuse a session from
+   SESSION_POOL if one is already connected to the right repository;
+   otherwise, open a new session and add it to SESSION_POOL, unless the
+   latter is full already.  Allocate *NEW_LOC in SCRATCH_POOL. */
+static svn_error_t *
+session_pool_get(svn_ra_session_t **ra_session,
+                 svn_client__pathrev_t **new_loc,
+                 session_pool_t *session_pool,
+                 const char *url,
+                 const svn_opt_revision_t *peg_revision,
+                 const svn_opt_revision_t *revision,
+                 svn_client_ctx_t *ctx,
+                 apr_pool_t *scratch_pool)
+{
+  apr_hash_index_t *hi;
+
+  /* Try to reuse a session that is connected to the right repository. */
+  for (hi = apr_hash_first(scratch_pool, session_pool->sessions);
+       hi;
+       hi = apr_hash_next(hi))
+    {
+      const char *repos_root_url = apr_hash_this_key(hi);
+
+      if (svn_uri_skip_ancestor(repos_root_url, url, scratch_pool))
+        {
+          *ra_session = apr_hash_this_val(hi);
+          SVN_ERR(svn_ra_reparent(*ra_session, url, scratch_pool));
+          SVN_ERR(svn_client__resolve_rev_and_url(new_loc, *ra_session,
+                                                  url, peg_revision,
+                                                  revision, ctx,
+                                                  scratch_pool));
+          SVN_ERR(svn_ra_reparent(*ra_session, (*new_loc)->url,
+                                  scratch_pool));
+
+          return SVN_NO_ERROR;
+        }
+    }
+
+  /* No match; open a new session.  Keep it around for later items,
+     unless we already have plenty of open connections. */
+  if (apr_hash_count(session_pool->sessions) < SESSION_POOL_MAX_SESSIONS)
+    {
+      SVN_ERR(svn_client__ra_session_from_path2(ra_session, new_loc,
+                                                url, NULL, peg_revision,
+                                                revision, ctx,
+                                                session_pool->pool));
+      svn_hash_sets(session_pool->sessions,
+                    apr_pstrdup(session_pool->pool,
+                                (*new_loc)->repos_root_url),
+                    *ra_session);
+    }
+  else
+    {
+      SVN_ERR(svn_client__ra_session_from_path2(ra_session, new_loc,
+                                                url, NULL, peg_revision,
+                                                revision, ctx,
+                                                scratch_pool));
+    }
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 handle_external_item_change(svn_client_ctx_t *ctx,
                             const char *repos_root_url,
@@ -756,6 +839,7 @@ handle_external_item_change(svn_client_ctx_t *ctx,
                             const char *old_defining_abspath,
                             const svn_wc_external_item2_t *new_item,
                             svn_ra_session_t *ra_session,
+                            session_pool_t *session_pool,
                             svn_boolean_t *timestamp_sleep,
                             apr_pool_t *scratch_pool)
 {
@@ -807,11 +891,9 @@ handle_external_item_change(svn_client_ctx_t *ctx,
     }
 
   if (!ra_session)
-    SVN_ERR(svn_client__ra_session_from_path2(&ra_session, &new_loc,
-                                              new_url, NULL,
-                                              &(new_item->peg_revision),
-                                              &(new_item->revision), ctx,
-                                              scratch_pool));
+    SVN_ERR(session_pool_get(&ra_session, &new_loc, session_pool, new_url,
+                             &(new_item->peg_revision),
+                             &(new_item->revision), ctx, scratch_pool));
 
   SVN_ERR(svn_ra_check_path(ra_session, "", new_loc->rev, &ext_kind,
                             scratch_pool));
@@ -970,6 +1052,7 @@ handle_externals_change(svn_client_ctx_t *ctx,
                         svn_depth_t ambient_depth,
                         svn_depth_t requested_depth,
                         svn_ra_session_t *ra_session,
+                        session_pool_t *session_pool,
                         apr_pool_t *scratch_pool)
 {
   apr_array_header_t *new_desc;
@@ -1039,6 +1122,7 @@ handle_externals_change(svn_client_ctx_t *ctx,
                                                   target_abspath,
                                                   old_defining_abspath,
                                                   new_item, ra_session,
+                                                  session_pool,
                                                   timestamp_sleep,
                                                   iterpool),
                       iterpool));
@@ -1068,11 +1152,17 @@ svn_client__handle_externals(apr_hash_t *externals_new,
   apr_hash_t *old_external_defs;
   apr_hash_index_t *hi;
   apr_pool_t *iterpool;
+  session_pool_t session_pool;
 
   SVN_ERR_ASSERT(repos_root_url);
 
   iterpool = svn_pool_create(scratch_pool);
 
+  /* Share RA sessions between all externals that live in the same
+     (foreign) repository. */
+  session_pool.sessions = apr_hash_make(scratch_pool);
+  session_pool.pool = scratch_pool;
+
   SVN_ERR(svn_wc__externals_defined_below(&old_external_defs,
                                           ctx->wc_ctx, target_abspath,
                                           scratch_pool, iterpool));
@@ -1111,7 +1201,8 @@ svn_client__handle_externals(apr_hash_t *externals_new,
                                       local_abspath,
                                       desc_text, old_external_defs,
                                       ambient_depth, requested_depth,
-                                      ra_session, iterpool));
+                                      ra_session, &session_pool,
+                                      iterpool));
     }
 
   /* Remove the remaining externals */
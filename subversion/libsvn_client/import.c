@@ -31,6 +31,7 @@
 #include <apr_strings.h>
 #include <apr_hash.h>
 #include <apr_md5.h>
+#include <apr_thread_proc.h>
 
 #include "svn_hash.h"
 #include "svn_ra.h"
@@ -51,11 +52,17 @@
 #include "private/svn_sorts_private.h"
 #include "private/svn_subr_private.h"
 #include "private/svn_magic.h"
+#include "private/svn_mutex.h"
+#include "private/svn_thread_cond.h"
 
 #include "svn_private_config.h"
 
 /* Import context baton. */
 
+#if APR_HAS_THREADS
+typedef struct read_ahead_baton_t read_ahead_baton_t;
+#endif
+
 typedef struct import_ctx_t
 {
   /* Whether any changes were made to the repository */
@@ -71,6 +78,12 @@ typedef struct import_ctx_t
      svn:executable, simply map the property name to an empty string.
      May be NULL if autoprops are disabled. */
   apr_hash_t *autoprops;
+
+#if APR_HAS_THREADS
+  /* Coordination with the read-ahead thread,
+     NULL if no such thread is running. */
+  read_ahead_baton_t *read_ahead;
+#endif
 } import_ctx_t;
 
 typedef struct open_txdelta_stream_baton_t
@@ -205,6 +218,191 @@ send_file_contents(svn_checksum_t **result_md5_checksum_p,
 }
 
 
+#if APR_HAS_THREADS
+
+/* Maximum number of bytes the read-ahead thread may be ahead of the
+ * editor drive.  Large enough to hide disk latency behind the network
+ * transfer, small enough not to evict the data from the OS file cache
+ * before the drive gets to read it. */
+#define IMPORT_READ_AHEAD_WINDOW (64 * 1024 * 1024)
+
+/* Chunk size for the read-ahead thread's file reads. */
+#define IMPORT_READ_AHEAD_CHUNK (256 * 1024)
+
+/* Shared state between the editor drive and the read-ahead thread.
+ *
+ * The thread walks the import source in the same lexical order as
+ * import_children() and reads the file contents, pulling them into the
+ * OS file cache just ahead of the editor drive.  The drive then finds
+ * the data in memory and is no longer limited to the speed of a single
+ * cold read stream.  The thread is purely advisory: it never produces
+ * data or errors for the drive and reading a file that the drive later
+ * skips or fails on is harmless. */
+struct read_ahead_baton_t
+{
+  /* Root of the tree being imported and its node kind. */
+  const char *local_abspath;
+  svn_node_kind_t kind;
+
+  /* Number of bytes sent to the editor / read by the thread so far.
+     Protected by MUTEX. */
+  svn_filesize_t drive_bytes;
+  svn_filesize_t warmed_bytes;
+
+  /* Set when the editor drive completed or failed.  Protected by MUTEX. */
+  svn_boolean_t done;
+
+  svn_mutex__t *mutex;
+
+  /* Signalled whenever DRIVE_BYTES grows or DONE gets set. */
+  svn_thread_cond__t *proceed;
+
+  /* The thread allocates from this pool; it uses a serialized allocator
+     because the pool is created by the main thread. */
+  apr_pool_t *pool;
+};
+
+/* Account for LEN bytes read by the read-ahead thread and block until
+ * the editor drive is less than IMPORT_READ_AHEAD_WINDOW bytes behind.
+ * Set *QUIT if the drive has finished and the thread shall terminate.
+ * Called with BATON->MUTEX held. */
+static svn_error_t *
+read_ahead_throttle(svn_boolean_t *quit,
+                    read_ahead_baton_t *baton,
+                    apr_size_t len)
+{
+  baton->warmed_bytes += len;
+  while (!baton->done
+         && baton->warmed_bytes > baton->drive_bytes
+                                  + IMPORT_READ_AHEAD_WINDOW)
+    SVN_ERR(svn_thread_cond__wait(baton->proceed, baton->mutex));
+
+  *quit = baton->done;
+  return SVN_NO_ERROR;
+}
+
+/* Account for LEN file content bytes sent to the editor and wake up the
+ * read-ahead thread.  Called with BATON->MUTEX held. */
+static svn_error_t *
+read_ahead_note_progress(read_ahead_baton_t *baton,
+                         svn_filesize_t len)
+{
+  baton->drive_bytes += len;
+  return svn_error_trace(svn_thread_cond__signal(baton->proceed));
+}
+
+/* Tell the read-ahead thread to terminate.
+ * Called with BATON->MUTEX held. */
+static svn_error_t *
+read_ahead_finish(read_ahead_baton_t *baton)
+{
+  baton->done = TRUE;
+  return svn_error_trace(svn_thread_cond__signal(baton->proceed));
+}
+
+/* Read the contents of LOCAL_ABSPATH in chunks, throttled by the editor
+ * drive's progress.  Set *QUIT if the thread shall terminate.
+ * Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+read_ahead_file(svn_boolean_t *quit,
+                read_ahead_baton_t *baton,
+                const char *local_abspath,
+                apr_pool_t *scratch_pool)
+{
+  apr_file_t *file;
+  char *buffer = apr_palloc(scratch_pool, IMPORT_READ_AHEAD_CHUNK);
+
+  SVN_ERR(svn_io_file_open(&file, local_abspath, APR_READ, APR_OS_DEFAULT,
+                           scratch_pool));
+  while (!*quit)
+    {
+      apr_size_t len = IMPORT_READ_AHEAD_CHUNK;
+      svn_boolean_t eof = FALSE;
+
+      SVN_ERR(svn_io_file_read_full2(file, buffer, len, &len, &eof,
+                                     scratch_pool));
+      SVN_MUTEX__WITH_LOCK(baton->mutex,
+                           read_ahead_throttle(quit, baton, len));
+      if (eof)
+        break;
+    }
+
+  return svn_error_trace(svn_io_file_close(file, scratch_pool));
+}
+
+/* Recursively read the files below DIR_ABSPATH in the same lexical
+ * order in which import_children() will send them.  Set *QUIT if the
+ * thread shall terminate.  Use SCRATCH_POOL for temporary allocations.
+ *
+ * Note that this deliberately does not replicate the exclusion logic of
+ * get_filtered_children(); reading a file that will not be imported
+ * only wastes a little I/O and the read-ahead window keeps that
+ * bounded. */
+static svn_error_t *
+read_ahead_dir(svn_boolean_t *quit,
+               read_ahead_baton_t *baton,
+               const char *dir_abspath,
+               apr_pool_t *scratch_pool)
+{
+  apr_hash_t *dirents;
+  apr_array_header_t *sorted_dirents;
+  int i;
+  apr_pool_t *iterpool;
+
+  SVN_ERR(svn_io_get_dirents3(&dirents, dir_abspath, TRUE, scratch_pool,
+                              scratch_pool));
+  sorted_dirents = svn_sort__hash(dirents, svn_sort_compare_items_lexically,
+                                  scratch_pool);
+
+  iterpool = svn_pool_create(scratch_pool);
+  for (i = 0; i < sorted_dirents->nelts && !*quit; i++)
+    {
+      svn_sort__item_t item = APR_ARRAY_IDX(sorted_dirents, i,
+                                            svn_sort__item_t);
+      const svn_io_dirent2_t *dirent = item.value;
+      const char *this_abspath;
+
+      svn_pool_clear(iterpool);
+      this_abspath = svn_dirent_join(dir_abspath, item.key, iterpool);
+
+      if (dirent->kind == svn_node_dir)
+        SVN_ERR(read_ahead_dir(quit, baton, this_abspath, iterpool));
+      else if (dirent->kind == svn_node_file && !dirent->special)
+        SVN_ERR(read_ahead_file(quit, baton, this_abspath, iterpool));
+    }
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Thread function of the read-ahead thread.  DATA is the
+ * read_ahead_baton_t shared with the editor drive. */
+static void * APR_THREAD_FUNC
+read_ahead_thread(apr_thread_t *thread, void *data)
+{
+  read_ahead_baton_t *baton = data;
+  apr_pool_t *scratch_pool = svn_pool_create(baton->pool);
+  svn_boolean_t quit = FALSE;
+  svn_error_t *err;
+
+  /* Errors (e.g. unreadable files) simply end the read-ahead.  If they
+   * matter, the editor drive will run into them as well and report them
+   * properly. */
+  if (baton->kind == svn_node_dir)
+    err = read_ahead_dir(&quit, baton, baton->local_abspath, scratch_pool);
+  else
+    err = read_ahead_file(&quit, baton, baton->local_abspath, scratch_pool);
+  svn_error_clear(err);
+
+  svn_pool_destroy(scratch_pool);
+
+  apr_thread_exit(thread, APR_SUCCESS);
+  return NULL;
+}
+
+#endif /* APR_HAS_THREADS */
+
+
 /* Import file PATH as EDIT_PATH in the repository directory indicated
  * by DIR_BATON in EDITOR.
  *
@@ -295,6 +493,14 @@ import_file(const svn_delta_editor_t *editor,
   SVN_ERR(send_file_contents(&result_md5_checksum, local_abspath,
                              file_baton, editor, properties, pool));
 
+#if APR_HAS_THREADS
+  /* Let the read-ahead thread know how far we got. */
+  if (import_ctx->read_ahead)
+    SVN_MUTEX__WITH_LOCK(import_ctx->read_ahead->mutex,
+                         read_ahead_note_progress(import_ctx->read_ahead,
+                                                  dirent->filesize));
+#endif
+
   /* Finally, close the file. */
   text_checksum = svn_checksum_to_cstring(result_md5_checksum, pool);
   return svn_error_trace(editor->close_file(file_baton, text_checksum, pool));
@@ -687,6 +893,12 @@ import(svn_boolean_t *updated_repository,
   const char *edit_path = "";
   import_ctx_t import_ctx = { FALSE };
   const svn_io_dirent2_t *dirent;
+  svn_error_t *err = SVN_NO_ERROR;
+#if APR_HAS_THREADS
+  read_ahead_baton_t read_ahead_baton = { 0 };
+  apr_thread_t *read_ahead_thread_id = NULL;
+  apr_status_t status;
+#endif
 
   *updated_repository = FALSE;
 
@@ -744,6 +956,34 @@ import(svn_boolean_t *updated_repository,
      if something underneath it also has our reserved name, then we'll
      error. */
 
+#if APR_HAS_THREADS
+  /* Start a thread that reads the import source just ahead of the
+     editor drive below, overlapping local disk reads with the network
+     transfer.  If the thread cannot be created, simply import without
+     read-ahead.  Until the thread has been joined again, errors from
+     the drive must be collected in ERR instead of returned directly. */
+  if (dirent->kind == svn_node_file || dirent->kind == svn_node_dir)
+    {
+      read_ahead_baton.local_abspath = local_abspath;
+      read_ahead_baton.kind = dirent->kind;
+      SVN_ERR(svn_mutex__init(&read_ahead_baton.mutex, TRUE, pool));
+      SVN_ERR(svn_thread_cond__create(&read_ahead_baton.proceed, pool));
+      read_ahead_baton.pool
+        = apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+
+      status = apr_thread_create(&read_ahead_thread_id, NULL,
+                                 read_ahead_thread, &read_ahead_baton,
+                                 read_ahead_baton.pool);
+      if (status)
+        {
+          svn_pool_destroy(read_ahead_baton.pool);
+          read_ahead_thread_id = NULL;
+        }
+      else
+        import_ctx.read_ahead = &read_ahead_baton;
+    }
+#endif
+
   if (dirent->kind == svn_node_file)
     {
       /* This code path ignores EXCLUDES and FILTER, but they don't make
@@ -756,8 +996,8 @@ import(svn_boolean_t *updated_repository,
            || svn_wc_match_ignore_list(local_abspath, local_ignores, pool));
 
       if (!ignores_match)
-        SVN_ERR(import_file(editor, root_baton, local_abspath, edit_path,
-                            dirent, &import_ctx, ctx, pool));
+        err = import_file(editor, root_baton, local_abspath, edit_path,
+                          dirent, &import_ctx, ctx, pool);
     }
   else if (dirent->kind == svn_node_dir)
     {
@@ -768,25 +1008,49 @@ import(svn_boolean_t *updated_repository,
       if (!no_ignore && new_entries->nelts)
         local_ignores = NULL;
 
-      SVN_ERR(get_filtered_children(&dirents, local_abspath, excludes,
-                                    local_ignores, global_ignores,
-                                    filter_callback, filter_baton, ctx,
-                                    pool, pool));
+      err = get_filtered_children(&dirents, local_abspath, excludes,
+                                  local_ignores, global_ignores,
+                                  filter_callback, filter_baton, ctx,
+                                  pool, pool);
 
-      SVN_ERR(import_children(local_abspath, edit_path, dirents, editor,
+      if (!err)
+        err = import_children(local_abspath, edit_path, dirents, editor,
                               root_baton, depth, excludes, global_ignores,
                               no_ignore, no_autoprops,
                               ignore_unknown_node_types, filter_callback,
-                              filter_baton, &import_ctx, ctx, pool));
-
+                              filter_baton, &import_ctx, ctx, pool);
     }
   else if (dirent->kind == svn_node_none
            || dirent->kind == svn_node_unknown)
     {
-      return svn_error_createf(SVN_ERR_NODE_UNKNOWN_KIND, NULL,
-                               _("'%s' does not exist"),
-                               svn_dirent_local_style(local_abspath, pool));
+      err = svn_error_createf(SVN_ERR_NODE_UNKNOWN_KIND, NULL,
+                              _("'%s' does not exist"),
+                              svn_dirent_local_style(local_abspath, pool));
+    }
+
+#if APR_HAS_THREADS
+  /* Wake up and join the read-ahead thread before evaluating ERR. */
+  if (read_ahead_thread_id)
+    {
+      apr_status_t thread_status;
+
+      svn_error_clear(svn_mutex__lock(read_ahead_baton.mutex));
+      svn_error_clear(svn_mutex__unlock(read_ahead_baton.mutex,
+                                        read_ahead_finish(&read_ahead_baton)));
+
+      status = apr_thread_join(&thread_status, read_ahead_thread_id);
+      if (status)
+        err = svn_error_compose_create(err,
+                  svn_error_wrap_apr(status,
+                                     _("Can't join import read-ahead "
+                                       "thread")));
+
+      svn_pool_destroy(read_ahead_baton.pool);
+      import_ctx.read_ahead = NULL;
     }
+#endif
+
+  SVN_ERR(err);
 
   /* Close up shop; it's time to go home. */
   SVN_ERR(editor->close_directory(root_baton, pool));
@@ -26,6 +26,7 @@
 
 #include <apr_strings.h>
 #include <apr_pools.h>
+#include <apr_thread_proc.h>
 
 #include "svn_pools.h"
 #include "svn_client.h"
@@ -41,6 +42,8 @@
 
 #include "svn_private_config.h"
 #include "private/svn_wc_private.h"
+#include "private/svn_mutex.h"
+#include "private/svn_thread_cond.h"
 
 #include <assert.h>
 
@@ -299,6 +302,277 @@ limit_receiver(void *baton, svn_log_entry_t *log_entry, apr_pool_t *pool)
   return rb->receiver(rb->baton, log_entry, pool);
 }
 
+/*** Pipelined log retrieval. ***/
+
+#if APR_HAS_THREADS
+
+/* Maximum number of parsed log entries the reader thread may buffer ahead
+   of the receiver.  Large enough to hide many round trips worth of network
+   latency behind an interactive consumer, small enough to keep the memory
+   footprint of a slow consumer bounded. */
+#define LOG_PREFETCH_WINDOW 128
+
+/* A single parsed log entry waiting to be delivered.  Each one lives in
+   its own POOL so that its memory can be reclaimed as soon as it has been
+   consumed. */
+typedef struct log_queue_item_t
+{
+  svn_log_entry_t *entry;
+  apr_pool_t *pool;
+  struct log_queue_item_t *next;
+} log_queue_item_t;
+
+/* State shared between the reader thread running svn_ra_get_log2() and
+   the consumer loop in pipelined_ra_get_log(). */
+typedef struct log_pipeline_baton_t
+{
+  /* Parameters of the deferred svn_ra_get_log2() drive. */
+  svn_ra_session_t *ra_session;
+  const apr_array_header_t *paths;
+  svn_revnum_t start;
+  svn_revnum_t end;
+  int limit;
+  svn_boolean_t discover_changed_paths;
+  svn_boolean_t strict_node_history;
+  svn_boolean_t include_merged_revisions;
+  const apr_array_header_t *revprops;
+
+  /* Parent of the per-entry pools and scratch space of the reader thread.
+     Its allocator is serialized because pools get created on the reader
+     thread but destroyed by the consumer. */
+  apr_pool_t *pipeline_pool;
+
+  /* Error status of the whole svn_ra_get_log2() drive.  Only to be read
+     after the reader thread has been joined. */
+  svn_error_t *read_err;
+
+  /* FIFO of parsed entries and its current length.
+     This and all following members are protected by MUTEX. */
+  log_queue_item_t *first;
+  log_queue_item_t *last;
+  int count;
+
+  /* The reader terminated; no further entries will arrive. */
+  svn_boolean_t done;
+
+  /* The consumer failed; the reader should stop as soon as possible. */
+  svn_boolean_t aborted;
+
+  svn_mutex__t *mutex;
+  svn_thread_cond__t *not_empty;
+  svn_thread_cond__t *not_full;
+} log_pipeline_baton_t;
+
+/* Append ITEM to the queue in PB, waiting for a free window slot first.
+   Return SVN_ERR_CANCELLED if the consumer has given up.
+   To be called with PB->MUTEX held. */
+static svn_error_t *
+enqueue_log_entry(log_pipeline_baton_t *pb,
+                  log_queue_item_t *item)
+{
+  while (pb->count >= LOG_PREFETCH_WINDOW && !pb->aborted)
+    SVN_ERR(svn_thread_cond__wait(pb->not_full, pb->mutex));
+
+  if (pb->aborted)
+    return svn_error_create(SVN_ERR_CANCELLED, NULL, NULL);
+
+  if (pb->last)
+    pb->last->next = item;
+  else
+    pb->first = item;
+  pb->last = item;
+  ++pb->count;
+
+  return svn_thread_cond__signal(pb->not_empty);
+}
+
+/* Wait until the reader produced another entry or terminated.  Return
+   the entry in *ITEM, or NULL upon termination.  Entries that arrived
+   before a reader failure are still handed out, preserving the delivery
+   behavior of a synchronous drive.  To be called with PB->MUTEX held. */
+static svn_error_t *
+dequeue_log_entry(log_queue_item_t **item,
+                  log_pipeline_baton_t *pb)
+{
+  while (pb->count == 0 && !pb->done)
+    SVN_ERR(svn_thread_cond__wait(pb->not_empty, pb->mutex));
+
+  *item = pb->first;
+  if (*item)
+    {
+      pb->first = (*item)->next;
+      if (pb->first == NULL)
+        pb->last = NULL;
+      --pb->count;
+      SVN_ERR(svn_thread_cond__signal(pb->not_full));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* The reader terminated.  Wake the consumer up.
+   To be called with PB->MUTEX held. */
+static svn_error_t *
+finish_log_pipeline(log_pipeline_baton_t *pb)
+{
+  pb->done = TRUE;
+  return svn_thread_cond__signal(pb->not_empty);
+}
+
+/* The consumer failed.  Make the reader stop instead of filling the
+   window.  To be called with PB->MUTEX held. */
+static svn_error_t *
+abort_log_pipeline(log_pipeline_baton_t *pb)
+{
+  pb->aborted = TRUE;
+  return svn_thread_cond__signal(pb->not_full);
+}
+
+/* Implements svn_log_entry_receiver_t.  Runs on the reader thread:
+   take a private copy of LOG_ENTRY and queue it for the consumer. */
+static svn_error_t *
+log_reader_receiver(void *baton, svn_log_entry_t *log_entry, apr_pool_t *pool)
+{
+  log_pipeline_baton_t *pb = baton;
+  apr_pool_t *entry_pool = svn_pool_create(pb->pipeline_pool);
+  log_queue_item_t *item = apr_palloc(entry_pool, sizeof(*item));
+
+  item->entry = svn_log_entry_dup(log_entry, entry_pool);
+  item->pool = entry_pool;
+  item->next = NULL;
+
+  SVN_MUTEX__WITH_LOCK(pb->mutex, enqueue_log_entry(pb, item));
+
+  return SVN_NO_ERROR;
+}
+
+/* Reader thread main function:  run the log drive described by DATA,
+   stash its error status and signal termination. */
+static void * APR_THREAD_FUNC
+log_reader_thread(apr_thread_t *thread, void *data)
+{
+  log_pipeline_baton_t *pb = data;
+  apr_pool_t *scratch_pool = svn_pool_create(pb->pipeline_pool);
+
+  pb->read_err = svn_ra_get_log2(pb->ra_session, pb->paths,
+                                 pb->start, pb->end, pb->limit,
+                                 pb->discover_changed_paths,
+                                 pb->strict_node_history,
+                                 pb->include_merged_revisions,
+                                 pb->revprops,
+                                 log_reader_receiver, pb,
+                                 scratch_pool);
+  svn_pool_destroy(scratch_pool);
+
+  /* The mutex acquired here also commits PB->READ_ERR to memory before
+     the consumer can see DONE. */
+  svn_error_clear(svn_mutex__lock(pb->mutex));
+  svn_error_clear(svn_mutex__unlock(pb->mutex, finish_log_pipeline(pb)));
+
+  apr_thread_exit(thread, APR_SUCCESS);
+  return NULL;
+}
+
+/* Deliver the queued entries to RECEIVER / RECEIVER_BATON, until the
+   reader signals termination or the receiver fails. */
+static svn_error_t *
+consume_log_entries(log_pipeline_baton_t *pb,
+                    svn_log_entry_receiver_t receiver,
+                    void *receiver_baton)
+{
+  while (TRUE)
+    {
+      log_queue_item_t *item;
+
+      SVN_MUTEX__WITH_LOCK(pb->mutex, dequeue_log_entry(&item, pb));
+      if (item == NULL)
+        return SVN_NO_ERROR;
+
+      SVN_ERR(receiver(receiver_baton, item->entry, item->pool));
+      svn_pool_destroy(item->pool);
+    }
+}
+
+/* Like svn_ra_get_log2(), but run the network side of the drive on a
+   separate reader thread that parses entries and buffers up to
+   LOG_PREFETCH_WINDOW of them ahead of RECEIVER.  An interactive consumer
+   then renders at display speed instead of waiting out the network on
+   every entry.
+
+   Note that RA_SESSION's callbacks (cancellation, progress) will be
+   invoked from the reader thread, so they must be thread-safe. */
+static svn_error_t *
+pipelined_ra_get_log(svn_ra_session_t *ra_session,
+                     const apr_array_header_t *paths,
+                     svn_revnum_t start,
+                     svn_revnum_t end,
+                     int limit,
+                     svn_boolean_t discover_changed_paths,
+                     svn_boolean_t strict_node_history,
+                     svn_boolean_t include_merged_revisions,
+                     const apr_array_header_t *revprops,
+                     svn_log_entry_receiver_t receiver,
+                     void *receiver_baton,
+                     apr_pool_t *scratch_pool)
+{
+  log_pipeline_baton_t pb = { 0 };
+  apr_thread_t *thread;
+  apr_status_t status;
+  apr_status_t thread_status;
+  svn_error_t *err;
+
+  pb.ra_session = ra_session;
+  pb.paths = paths;
+  pb.start = start;
+  pb.end = end;
+  pb.limit = limit;
+  pb.discover_changed_paths = discover_changed_paths;
+  pb.strict_node_history = strict_node_history;
+  pb.include_merged_revisions = include_merged_revisions;
+  pb.revprops = revprops;
+
+  SVN_ERR(svn_mutex__init(&pb.mutex, TRUE, scratch_pool));
+  SVN_ERR(svn_thread_cond__create(&pb.not_empty, scratch_pool));
+  SVN_ERR(svn_thread_cond__create(&pb.not_full, scratch_pool));
+
+  /* Both threads allocate from sub-pools of this one concurrently, so
+     its allocator must be serialized. */
+  pb.pipeline_pool = apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+
+  status = apr_thread_create(&thread, NULL, log_reader_thread, &pb,
+                             pb.pipeline_pool);
+  if (status)
+    {
+      svn_pool_destroy(pb.pipeline_pool);
+      return svn_error_wrap_apr(status, _("Can't create log reader thread"));
+    }
+
+  err = consume_log_entries(&pb, receiver, receiver_baton);
+  if (err)
+    {
+      /* Unblock the reader; it will abort the drive with an error that
+         we swallow below in favor of the receiver's one. */
+      svn_error_clear(svn_mutex__lock(pb.mutex));
+      svn_error_clear(svn_mutex__unlock(pb.mutex, abort_log_pipeline(&pb)));
+    }
+
+  /* Never leave this function with the reader still running. */
+  status = apr_thread_join(&thread_status, thread);
+  if (status)
+    err = svn_error_compose_create(err,
+              svn_error_wrap_apr(status, _("Can't join log reader thread")));
+
+  if (err)
+    svn_error_clear(pb.read_err);
+  else
+    err = pb.read_err;
+
+  svn_pool_destroy(pb.pipeline_pool);
+  return svn_error_trace(err);
+}
+
+#endif /* APR_HAS_THREADS */
+
 /* Resolve the URLs or WC path in TARGETS as per the svn_client_log5 API.
 
    The limitations on TARGETS specified by svn_client_log5 are enforced here.
@@ -806,6 +1080,23 @@ run_ra_get_log(apr_array_header_t *revision_ranges,
           passed_receiver_baton = &lb;
         }
 
+#if APR_HAS_THREADS
+      /* Read and parse the incoming log entries on a separate thread so
+         that neither network latency nor an expensive receiver stalls the
+         respective other side.  All receivers still run on this thread. */
+      SVN_ERR(pipelined_ra_get_log(ra_session,
+                                   paths,
+                                   range->range_start,
+                                   range->range_end,
+                                   limit,
+                                   discover_changed_paths,
+                                   strict_node_history,
+                                   include_merged_revisions,
+                                   passed_receiver_revprops,
+                                   passed_receiver,
+                                   passed_receiver_baton,
+                                   iterpool));
+#else
       SVN_ERR(svn_ra_get_log2(ra_session,
                               paths,
                               range->range_start,
@@ -818,6 +1109,7 @@ run_ra_get_log(apr_array_header_t *revision_ranges,
                               passed_receiver,
                               passed_receiver_baton,
                               iterpool));
+#endif
 
       if (limit && revision_ranges->nelts > 1)
         {
@@ -267,6 +267,13 @@ typedef struct merge_cmd_baton_t {
      comment) or a similar list for single-file-merges */
   apr_array_header_t *children_with_mergeinfo;
 
+  /* Cache of natural histories fetched from the repository during this
+     merge, mapping "URL@REV" keys to natural_history_cache_entry_t *.
+     It persists across all phases and discrete ranges of the merge so
+     that each location's history is traced at most once, see
+     get_history_as_mergeinfo_cached().  May be NULL (no caching). */
+  apr_hash_t *natural_history_cache;
+
   svn_client_ctx_t *ctx;              /* Client context for callbacks, etc. */
 
   /* The list of any paths which remained in conflict after a
@@ -4308,6 +4315,98 @@ fix_deleted_subtree_ranges(const merge_source_t *source,
 
 /*** Determining What Remains To Be Merged ***/
 
+/* A cached natural history trace, see
+   merge_cmd_baton_t.natural_history_cache.  MERGEINFO describes the
+   natural history of one location over the revision range
+   OLDEST:YOUNGEST (both inclusive). */
+typedef struct natural_history_cache_entry_t
+{
+  svn_revnum_t youngest;
+  svn_revnum_t oldest;
+  svn_mergeinfo_t mergeinfo;
+} natural_history_cache_entry_t;
+
+/* Set *IMPLICIT_MERGEINFO to the natural history of PATHREV between
+   YOUNGEST and OLDEST, allocated in RESULT_POOL.  Both revisions must
+   be valid and YOUNGEST must be greater than OLDEST.
+
+   If NATURAL_HISTORY_CACHE is not NULL, consult it first and answer
+   from memory if it already holds a trace of PATHREV covering the
+   requested range.  On a cache miss, trace a range wide enough to also
+   cover all previously cached ranges for PATHREV and add the result to
+   the cache, bounding the number of repository round trips at one per
+   location for the whole merge.
+
+   RA_SESSION is an RA session open to the repository of PATHREV.  It
+   may be temporarily reparented by this function. */
+static svn_error_t *
+get_history_as_mergeinfo_cached(svn_mergeinfo_t *implicit_mergeinfo,
+                                apr_hash_t *natural_history_cache,
+                                const svn_client__pathrev_t *pathrev,
+                                svn_revnum_t youngest,
+                                svn_revnum_t oldest,
+                                svn_ra_session_t *ra_session,
+                                svn_client_ctx_t *ctx,
+                                apr_pool_t *result_pool,
+                                apr_pool_t *scratch_pool)
+{
+  natural_history_cache_entry_t *entry;
+  const char *key;
+  apr_pool_t *cache_pool;
+
+  if (natural_history_cache == NULL)
+    return svn_error_trace(svn_client__get_history_as_mergeinfo(
+                             implicit_mergeinfo, NULL, pathrev,
+                             youngest, oldest, ra_session, ctx,
+                             result_pool));
+
+  cache_pool = apr_hash_pool_get(natural_history_cache);
+  key = apr_psprintf(scratch_pool, "%s@%ld", pathrev->url, pathrev->rev);
+  entry = svn_hash_gets(natural_history_cache, key);
+
+  if (entry == NULL || entry->youngest < youngest || entry->oldest > oldest)
+    {
+      svn_mergeinfo_t history;
+      svn_revnum_t fetch_youngest = youngest;
+      svn_revnum_t fetch_oldest = oldest;
+
+      /* Widen the trace to cover anything we already had, so the new
+         entry remains good for all ranges seen so far. */
+      if (entry)
+        {
+          fetch_youngest = MAX(fetch_youngest, entry->youngest);
+          fetch_oldest = MIN(fetch_oldest, entry->oldest);
+        }
+      else
+        entry = apr_palloc(cache_pool, sizeof(*entry));
+
+      SVN_ERR(svn_client__get_history_as_mergeinfo(&history, NULL,
+                                                   pathrev,
+                                                   fetch_youngest,
+                                                   fetch_oldest,
+                                                   ra_session, ctx,
+                                                   scratch_pool));
+
+      /* The entry lives for the rest of the merge and gets filtered for
+         every merged range, so keep its ranges in one packed block. */
+      entry->mergeinfo = svn_mergeinfo__dup_packed(history, cache_pool,
+                                                   scratch_pool);
+      entry->youngest = fetch_youngest;
+      entry->oldest = fetch_oldest;
+      svn_hash_sets(natural_history_cache, apr_pstrdup(cache_pool, key),
+                    entry);
+    }
+
+  /* Reduce the cached trace to the requested range.  This yields the
+     same result as tracing YOUNGEST:OLDEST directly because location
+     segments are merely clipped at the range bounds. */
+  return svn_error_trace(svn_mergeinfo__filter_mergeinfo_by_ranges(
+                           implicit_mergeinfo, entry->mergeinfo,
+                           youngest, oldest > 0 ? oldest - 1 : 0,
+                           TRUE /* include_range */,
+                           result_pool, scratch_pool));
+}
+
 /* Get explicit and/or implicit mergeinfo for the working copy path
    TARGET_ABSPATH.
 
@@ -4333,6 +4432,9 @@ fix_deleted_subtree_ranges(const merge_source_t *source,
    is older than START, then the base revision is used as the younger
    bound in place of START.
 
+   If NATURAL_HISTORY_CACHE is not NULL it is used to avoid repeated
+   natural history fetches, see get_history_as_mergeinfo_cached().
+
    RA_SESSION is an RA session open to the repository in which TARGET_ABSPATH
    lives.  It may be temporarily reparented as needed by this function.
 
@@ -4343,6 +4445,7 @@ get_full_mergeinfo(svn_mergeinfo_t *recorded_mergeinfo,
                    svn_mergeinfo_t *implicit_mergeinfo,
                    svn_boolean_t *inherited,
                    svn_mergeinfo_inheritance_t inherit,
+                   apr_hash_t *natural_history_cache,
                    svn_ra_session_t *ra_session,
                    const char *target_abspath,
                    svn_revnum_t start,
@@ -4401,11 +4504,12 @@ get_full_mergeinfo(svn_mergeinfo_t *recorded_mergeinfo,
             start = target->rev;
 
           /* Fetch the implicit mergeinfo. */
-          SVN_ERR(svn_client__get_history_as_mergeinfo(implicit_mergeinfo,
-                                                       NULL,
-                                                       target, start, end,
-                                                       ra_session, ctx,
-                                                       result_pool));
+          SVN_ERR(get_history_as_mergeinfo_cached(implicit_mergeinfo,
+                                                  natural_history_cache,
+                                                  target, start, end,
+                                                  ra_session, ctx,
+                                                  result_pool,
+                                                  scratch_pool));
         }
     } /*if (implicit_mergeinfo) */
 
@@ -4433,6 +4537,7 @@ inherit_implicit_mergeinfo_from_parent(svn_client__merge_path_t *parent,
                                        svn_client__merge_path_t *child,
                                        svn_revnum_t revision1,
                                        svn_revnum_t revision2,
+                                       apr_hash_t *natural_history_cache,
                                        svn_ra_session_t *ra_session,
                                        svn_client_ctx_t *ctx,
                                        apr_pool_t *result_pool,
@@ -4449,6 +4554,7 @@ inherit_implicit_mergeinfo_from_parent(svn_client__merge_path_t *parent,
   if (!parent->implicit_mergeinfo)
     SVN_ERR(get_full_mergeinfo(NULL, &(parent->implicit_mergeinfo),
                                NULL, svn_mergeinfo_inherited,
+                               natural_history_cache,
                                ra_session, child->abspath,
                                MAX(revision1, revision2),
                                MIN(revision1, revision2),
@@ -4490,6 +4596,7 @@ ensure_implicit_mergeinfo(svn_client__merge_path_t *parent,
                           svn_boolean_t child_inherits_parent,
                           svn_revnum_t revision1,
                           svn_revnum_t revision2,
+                          apr_hash_t *natural_history_cache,
                           svn_ra_session_t *ra_session,
                           svn_client_ctx_t *ctx,
                           apr_pool_t *result_pool,
@@ -4506,6 +4613,7 @@ ensure_implicit_mergeinfo(svn_client__merge_path_t *parent,
                                                    child,
                                                    revision1,
                                                    revision2,
+                                                   natural_history_cache,
                                                    ra_session,
                                                    ctx,
                                                    result_pool,
@@ -4514,6 +4622,7 @@ ensure_implicit_mergeinfo(svn_client__merge_path_t *parent,
     SVN_ERR(get_full_mergeinfo(NULL,
                                &(child->implicit_mergeinfo),
                                NULL, svn_mergeinfo_inherited,
+                               natural_history_cache,
                                ra_session, child->abspath,
                                MAX(revision1, revision2),
                                MIN(revision1, revision2),
@@ -4579,6 +4688,7 @@ filter_merged_revisions(svn_client__merge_path_t *parent,
                         svn_revnum_t revision1,
                         svn_revnum_t revision2,
                         svn_boolean_t child_inherits_implicit,
+                        apr_hash_t *natural_history_cache,
                         svn_ra_session_t *ra_session,
                         svn_client_ctx_t *ctx,
                         apr_pool_t *result_pool,
@@ -4666,6 +4776,7 @@ filter_merged_revisions(svn_client__merge_path_t *parent,
                                             child_inherits_implicit,
                                             revision1,
                                             revision2,
+                                            natural_history_cache,
                                             ra_session,
                                             ctx,
                                             result_pool,
@@ -4751,6 +4862,7 @@ filter_merged_revisions(svn_client__merge_path_t *parent,
                                             child_inherits_implicit,
                                             revision1,
                                             revision2,
+                                            natural_history_cache,
                                             ra_session,
                                             ctx,
                                             result_pool,
@@ -4823,6 +4935,7 @@ calculate_remaining_ranges(svn_client__merge_path_t *parent,
                            svn_mergeinfo_t target_mergeinfo,
                            const apr_array_header_t *implicit_src_gap,
                            svn_boolean_t child_inherits_implicit,
+                           apr_hash_t *natural_history_cache,
                            svn_ra_session_t *ra_session,
                            svn_client_ctx_t *ctx,
                            apr_pool_t *result_pool,
@@ -4872,6 +4985,7 @@ calculate_remaining_ranges(svn_client__merge_path_t *parent,
                                   target_rangelist,
                                   source->loc1->rev, source->loc2->rev,
                                   child_inherits_implicit,
+                                  natural_history_cache,
                                   ra_session, ctx, result_pool,
                                   scratch_pool));
 
@@ -5151,7 +5265,9 @@ populate_remaining_ranges(apr_array_header_t *children_with_mergeinfo,
               SVN_ERR(get_full_mergeinfo(NULL, /* child->pre_merge_mergeinfo */
                                          &(child->implicit_mergeinfo),
                                          NULL, /* child->inherited_mergeinfo */
-                                         svn_mergeinfo_inherited, ra_session,
+                                         svn_mergeinfo_inherited,
+                                         merge_b->natural_history_cache,
+                                         ra_session,
                                          child->abspath,
                                          MAX(source->loc1->rev,
                                              source->loc2->rev),
@@ -5179,6 +5295,7 @@ populate_remaining_ranges(apr_array_header_t *children_with_mergeinfo,
                                                 child_inherits_implicit,
                                                 source->loc1->rev,
                                                 source->loc2->rev,
+                                                merge_b->natural_history_cache,
                                                 ra_session, merge_b->ctx,
                                                 result_pool, iterpool));
             }
@@ -5256,7 +5373,7 @@ populate_remaining_ranges(apr_array_header_t *children_with_mergeinfo,
         /* Get implicit only for merge target. */
         (i == 0) ? &(child->implicit_mergeinfo) : NULL,
         &(child->inherited_mergeinfo),
-        svn_mergeinfo_inherited, ra_session,
+        svn_mergeinfo_inherited, merge_b->natural_history_cache, ra_session,
         child->abspath,
         MAX(source->loc1->rev, source->loc2->rev),
         MIN(source->loc1->rev, source->loc2->rev),
@@ -5285,6 +5402,7 @@ populate_remaining_ranges(apr_array_header_t *children_with_mergeinfo,
                                          child->pre_merge_mergeinfo,
                                          merge_b->implicit_src_gap,
                                          child_inherits_implicit,
+                                         merge_b->natural_history_cache,
                                          ra_session,
                                          merge_b->ctx, result_pool,
                                          iterpool));
@@ -7624,6 +7742,7 @@ do_file_merge(svn_mergeinfo_catalog_t result_catalog,
       err = get_full_mergeinfo(&target_mergeinfo,
                                &(merge_target->implicit_mergeinfo),
                                &inherited, svn_mergeinfo_inherited,
+                               merge_b->natural_history_cache,
                                merge_b->ra_session1, target_abspath,
                                MAX(source->loc1->rev, source->loc2->rev),
                                MIN(source->loc1->rev, source->loc2->rev),
@@ -7654,6 +7773,7 @@ do_file_merge(svn_mergeinfo_catalog_t result_catalog,
                                              source,
                                              target_mergeinfo,
                                              merge_b->implicit_src_gap, FALSE,
+                                             merge_b->natural_history_cache,
                                              merge_b->ra_session1,
                                              ctx, scratch_pool,
                                              iterpool));
@@ -10019,6 +10139,10 @@ do_merge(apr_hash_t **modified_subtrees,
   merge_cmd_baton.added_abspaths = apr_hash_make(result_pool);
   merge_cmd_baton.tree_conflicted_abspaths = apr_hash_make(result_pool);
 
+  /* Trace each location's natural history at most once per merge,
+     even when merging several discrete ranges. */
+  merge_cmd_baton.natural_history_cache = apr_hash_make(scratch_pool);
+
   merge_cmd_baton.notify_func = notify_merging;
   merge_cmd_baton.notify_baton = &merge_cmd_baton.notify_begin;
   merge_cmd_baton.notify_begin.merge_b = &merge_cmd_baton;
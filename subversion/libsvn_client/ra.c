@@ -316,29 +316,238 @@ progress_func(apr_off_t progress,
     }
 }
 
+/* === Caching of RA sessions across operations === */
+
+/* Maximum number of RA sessions that we keep alive in a client context
+   after the operation using them has finished. */
+#define RA_CACHE_MAX_SESSIONS 8
+
+/* An idle session that has not been reused for this long is closed
+   instead of being handed out again. */
+#define RA_CACHE_IDLE_TIMEOUT apr_time_from_sec(5 * 60)
+
+/* A single open RA session held by the cache. */
+typedef struct cached_session_t
+{
+  /* The open session, allocated in POOL. */
+  svn_ra_session_t *session;
+
+  /* Root URL of the repository that SESSION is connected to. */
+  const char *root_url;
+
+  /* Subpool of the cache's pool, holding SESSION and this struct. */
+  apr_pool_t *pool;
+
+  /* Is the session currently handed out to some operation? */
+  svn_boolean_t in_use;
+
+  /* If IN_USE, the pool that the session has been handed out into. */
+  apr_pool_t *owner_pool;
+
+  /* When IN_USE last became FALSE. */
+  apr_time_t released;
+} cached_session_t;
+
+/* Cache of idle RA sessions, kept in a client context.  All sessions
+   opened through one context share its authentication baton and
+   configuration, so the repository root URL is all that identifies a
+   compatible session. */
+struct svn_client__ra_session_cache_t
+{
+  /* Pool with the same lifetime as the owning context. */
+  apr_pool_t *pool;
+
+  /* Cached sessions as cached_session_t *, oldest first. */
+  apr_array_header_t *sessions;
+};
+
+static apr_status_t release_cached_session(void *data);
+
+/* Pool cleanup handler: the cache went away while the session described
+   by DATA was still handed out.  Make sure the release handler does not
+   fire later and touch freed memory. */
+static apr_status_t
+detach_cached_session(void *data)
+{
+  cached_session_t *entry = data;
+
+  apr_pool_cleanup_kill(entry->owner_pool, entry, release_cached_session);
+
+  return APR_SUCCESS;
+}
+
+/* Pool cleanup handler: the pool that the session described by DATA was
+   handed out into goes away; return the session to the cache. */
+static apr_status_t
+release_cached_session(void *data)
+{
+  cached_session_t *entry = data;
+
+  apr_pool_cleanup_kill(entry->pool, entry, detach_cached_session);
+  entry->owner_pool = NULL;
+  entry->in_use = FALSE;
+  entry->released = apr_time_now();
+
+  return APR_SUCCESS;
+}
+
+/* Mark ENTRY as handed out into RESULT_POOL and make sure that it
+   returns to the cache when RESULT_POOL gets cleaned up. */
+static void
+checkout_cached_session(cached_session_t *entry,
+                        apr_pool_t *result_pool)
+{
+  entry->in_use = TRUE;
+  entry->owner_pool = result_pool;
+  apr_pool_cleanup_register(result_pool, entry, release_cached_session,
+                            apr_pool_cleanup_null);
+  apr_pool_cleanup_register(entry->pool, entry, detach_cached_session,
+                            apr_pool_cleanup_null);
+}
+
+/* Return the session cache of CTX, creating it if necessary. */
+static svn_client__ra_session_cache_t *
+get_session_cache(svn_client_ctx_t *ctx)
+{
+  svn_client__private_ctx_t *private_ctx = svn_client__get_private_ctx(ctx);
+  svn_client__ra_session_cache_t *cache = private_ctx->ra_session_cache;
+
+  if (cache == NULL)
+    {
+      apr_pool_t *pool = svn_pool_create(private_ctx->pool);
+
+      cache = apr_pcalloc(pool, sizeof(*cache));
+      cache->pool = pool;
+      cache->sessions = apr_array_make(pool, RA_CACHE_MAX_SESSIONS,
+                                       sizeof(cached_session_t *));
+      private_ctx->ra_session_cache = cache;
+    }
+
+  return cache;
+}
+
+/* Try to satisfy a session request for URL from CTX's session cache.
+   Set *RA_SESSION to a reused session handed out into RESULT_POOL, or
+   to NULL if no cached session fits.  Close expired idle sessions along
+   the way. */
+static svn_error_t *
+find_cached_session(svn_ra_session_t **ra_session,
+                    const char *url,
+                    svn_client_ctx_t *ctx,
+                    apr_pool_t *result_pool,
+                    apr_pool_t *scratch_pool)
+{
+  svn_client__ra_session_cache_t *cache = get_session_cache(ctx);
+  apr_time_t now = apr_time_now();
+  int i;
+
+  *ra_session = NULL;
+
+  for (i = cache->sessions->nelts - 1; i >= 0; --i)
+    {
+      cached_session_t *entry
+        = APR_ARRAY_IDX(cache->sessions, i, cached_session_t *);
+      svn_error_t *err;
+
+      if (entry->in_use)
+        continue;
+
+      /* Idle for too long?  The server may well have dropped the
+         connection by now; don't hand out a session that is likely
+         dead. */
+      if (entry->released + RA_CACHE_IDLE_TIMEOUT < now)
+        {
+          SVN_ERR(svn_sort__array_delete2(cache->sessions, i, 1));
+          svn_pool_destroy(entry->pool);
+          continue;
+        }
+
+      if (!svn_uri__is_ancestor(entry->root_url, url))
+        continue;
+
+      /* Point the session at the requested URL.  This doubles as a
+         probe: if the connection died while the session sat idle, we
+         find out now, drop the session and open a fresh one instead. */
+      err = svn_ra_reparent(entry->session, url, scratch_pool);
+      if (err)
+        {
+          svn_error_clear(err);
+          SVN_ERR(svn_sort__array_delete2(cache->sessions, i, 1));
+          svn_pool_destroy(entry->pool);
+          continue;
+        }
+
+      checkout_cached_session(entry, result_pool);
+      *ra_session = entry->session;
+      return SVN_NO_ERROR;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Add SESSION, freshly opened in SESSION_POOL (a subpool of the cache's
+   pool), to CTX's session cache and hand it out into RESULT_POOL.
+   Evict the oldest idle session if the cache is full. */
+static svn_error_t *
+cache_new_session(svn_ra_session_t *session,
+                  apr_pool_t *session_pool,
+                  svn_client_ctx_t *ctx,
+                  apr_pool_t *result_pool)
+{
+  svn_client__ra_session_cache_t *cache = get_session_cache(ctx);
+  cached_session_t *entry;
+
+  if (cache->sessions->nelts >= RA_CACHE_MAX_SESSIONS)
+    {
+      int i;
+
+      for (i = 0; i < cache->sessions->nelts; ++i)
+        {
+          cached_session_t *victim
+            = APR_ARRAY_IDX(cache->sessions, i, cached_session_t *);
+
+          if (!victim->in_use)
+            {
+              SVN_ERR(svn_sort__array_delete2(cache->sessions, i, 1));
+              svn_pool_destroy(victim->pool);
+              break;
+            }
+        }
+    }
+
+  entry = apr_pcalloc(session_pool, sizeof(*entry));
+  entry->session = session;
+  entry->pool = session_pool;
+  SVN_ERR(svn_ra_get_repos_root2(session, &entry->root_url, session_pool));
+
+  APR_ARRAY_PUSH(cache->sessions, cached_session_t *) = entry;
+  checkout_cached_session(entry, result_pool);
+
+  return SVN_NO_ERROR;
+}
+
+
 #define SVN_CLIENT__MAX_REDIRECT_ATTEMPTS 3 /* ### TODO:  Make configurable. */
 
-svn_error_t *
-svn_client__open_ra_session_internal(svn_ra_session_t **ra_session,
-                                     const char **corrected_url,
-                                     const char *base_url,
-                                     const char *base_dir_abspath,
-                                     const apr_array_header_t *commit_items,
-                                     svn_boolean_t write_dav_props,
-                                     svn_boolean_t read_dav_props,
-                                     svn_client_ctx_t *ctx,
-                                     apr_pool_t *result_pool,
-                                     apr_pool_t *scratch_pool)
+/* Open a brand new RA session.  This is the backend for
+   svn_client__open_ra_session_internal() and takes the same arguments;
+   RESULT_POOL determines the lifetime of the new session. */
+static svn_error_t *
+open_new_ra_session(svn_ra_session_t **ra_session,
+                    const char **corrected_url,
+                    const char *base_url,
+                    const char *base_dir_abspath,
+                    const apr_array_header_t *commit_items,
+                    svn_boolean_t write_dav_props,
+                    svn_boolean_t read_dav_props,
+                    svn_client_ctx_t *ctx,
+                    apr_pool_t *result_pool,
+                    apr_pool_t *scratch_pool)
 {
   svn_ra_callbacks2_t *cbtable;
   callback_baton_t *cb = apr_pcalloc(result_pool, sizeof(*cb));
   const char *uuid = NULL;
 
-  SVN_ERR_ASSERT(!write_dav_props || read_dav_props);
-  SVN_ERR_ASSERT(!read_dav_props || base_dir_abspath != NULL);
-  SVN_ERR_ASSERT(base_dir_abspath == NULL
-                        || svn_dirent_is_absolute(base_dir_abspath));
-
   SVN_ERR(svn_ra_create_callbacks(&cbtable, result_pool));
   cbtable->open_tmp_file = open_tmp_file;
   cbtable->get_wc_prop = read_dav_props ? get_wc_prop : NULL;
@@ -471,6 +680,73 @@ svn_client__open_ra_session_internal(svn_ra_session_t **ra_session,
 }
 #undef SVN_CLIENT__MAX_REDIRECT_ATTEMPTS
 
+svn_error_t *
+svn_client__open_ra_session_internal(svn_ra_session_t **ra_session,
+                                     const char **corrected_url,
+                                     const char *base_url,
+                                     const char *base_dir_abspath,
+                                     const apr_array_header_t *commit_items,
+                                     svn_boolean_t write_dav_props,
+                                     svn_boolean_t read_dav_props,
+                                     svn_client_ctx_t *ctx,
+                                     apr_pool_t *result_pool,
+                                     apr_pool_t *scratch_pool)
+{
+  svn_boolean_t cacheable;
+
+  SVN_ERR_ASSERT(!write_dav_props || read_dav_props);
+  SVN_ERR_ASSERT(!read_dav_props || base_dir_abspath != NULL);
+  SVN_ERR_ASSERT(base_dir_abspath == NULL
+                        || svn_dirent_is_absolute(base_dir_abspath));
+
+  /* Sessions tied to a working copy or a commit carry per-operation
+     state in their callback batons, so only plain URL sessions can be
+     shared across operations. */
+  cacheable = (commit_items == NULL
+               && base_dir_abspath == NULL
+               && !write_dav_props
+               && !read_dav_props);
+
+  if (cacheable)
+    {
+      apr_pool_t *session_pool;
+      svn_error_t *err;
+
+      SVN_ERR(find_cached_session(ra_session, base_url, ctx,
+                                  result_pool, scratch_pool));
+      if (*ra_session)
+        {
+          /* The cached session already speaks to the repository's
+             canonical location, so there is no redirect for the caller
+             to learn about. */
+          if (corrected_url)
+            *corrected_url = NULL;
+          return SVN_NO_ERROR;
+        }
+
+      /* Open the new session with cache lifetime so that it can be
+         handed out again once the current operation is over. */
+      session_pool = svn_pool_create(get_session_cache(ctx)->pool);
+      err = open_new_ra_session(ra_session, corrected_url, base_url,
+                                NULL, NULL, FALSE, FALSE,
+                                ctx, session_pool, scratch_pool);
+      if (err)
+        {
+          svn_pool_destroy(session_pool);
+          return svn_error_trace(err);
+        }
+
+      return svn_error_trace(cache_new_session(*ra_session, session_pool,
+                                               ctx, result_pool));
+    }
+
+  return svn_error_trace(open_new_ra_session(ra_session, corrected_url,
+                                             base_url, base_dir_abspath,
+                                             commit_items,
+                                             write_dav_props, read_dav_props,
+                                             ctx, result_pool, scratch_pool));
+}
+
 
 svn_error_t *
 svn_client_open_ra_session2(svn_ra_session_t **session,
@@ -592,6 +592,8 @@ svn_client_status6(svn_revnum_t *result_rev,
       else
         {
           svn_revnum_t revnum;
+          svn_revnum_t uniform_rev;
+          svn_boolean_t skip_drive = FALSE;
           report_baton_t rb;
           svn_depth_t status_depth;
 
@@ -611,41 +613,89 @@ svn_client_status6(svn_revnum_t *result_rev,
                                                       pool));
             }
 
-          if (depth_as_sticky || !server_supports_depth)
-            status_depth = depth;
-          else
-            status_depth = svn_depth_unknown; /* Use depth from WC */
-
-          /* Do the deed.  Let the RA layer drive the status editor. */
-          SVN_ERR(svn_ra_do_status2(ra_session, &rb.wrapped_reporter,
-                                    &rb.wrapped_report_baton,
-                                    target_basename, revnum, status_depth,
-                                    editor, edit_baton, pool));
-
-          /* Init the report baton. */
-          rb.ancestor = apr_pstrdup(pool, URL); /* Edited later */
-          rb.set_locks_baton = set_locks_baton;
-          rb.ctx = ctx;
-          rb.pool = pool;
-
           if (depth == svn_depth_unknown)
             rb.depth = svn_depth_infinity;
           else
             rb.depth = depth;
 
-          /* Drive the reporter structure, describing the revisions
-             within PATH.  When we call reporter->finish_report,
-             EDITOR will be driven to describe differences between our
-             working copy and HEAD. */
-          SVN_ERR(svn_wc_crawl_revisions6(ctx->wc_ctx,
-                                          target_abspath,
-                                          &lock_fetch_reporter, &rb,
-                                          FALSE /* restore_files */,
-                                          depth, (! depth_as_sticky),
-                                          (! server_supports_depth),
-                                          FALSE /* use_commit_times */,
-                                          ctx->cancel_func, ctx->cancel_baton,
-                                          NULL, NULL, pool));
+          /* If the whole BASE tree mirrors one revision and that is the
+             revision we would compare against, the comparison cannot
+             report anything out of date.  This is the common case when
+             IDEs poll an up-to-date working copy, so skip the report
+             and editor drive entirely: just fetch the repository locks
+             (which the drive would have fetched, too) and close the
+             edit, which still runs the local status walk. */
+          SVN_ERR(svn_wc__base_uniform_revision(&uniform_rev, ctx->wc_ctx,
+                                                target_abspath, pool));
+          if (SVN_IS_VALID_REVNUM(uniform_rev))
+            {
+              svn_revnum_t target_rev = revnum;
+
+              if (! SVN_IS_VALID_REVNUM(target_rev))
+                SVN_ERR(svn_ra_get_latest_revnum(ra_session, &target_rev,
+                                                 pool));
+
+              skip_drive = (target_rev == uniform_rev);
+              if (skip_drive)
+                edit_revision = target_rev;
+            }
+
+          if (skip_drive)
+            {
+              apr_hash_t *locks;
+              const char *repos_root;
+              svn_error_t *lock_err;
+
+              lock_err = svn_ra_get_locks2(ra_session, &locks, "", rb.depth,
+                                           pool);
+              if (lock_err && lock_err->apr_err == SVN_ERR_RA_NOT_IMPLEMENTED)
+                {
+                  svn_error_clear(lock_err);
+                  lock_err = SVN_NO_ERROR;
+                  locks = apr_hash_make(pool);
+                }
+              SVN_ERR(lock_err);
+
+              SVN_ERR(svn_ra_get_repos_root2(ra_session, &repos_root, pool));
+              SVN_ERR(svn_wc_status_set_repos_locks(set_locks_baton, locks,
+                                                    repos_root, pool));
+
+              SVN_ERR(editor->close_edit(edit_baton, pool));
+            }
+          else
+            {
+              if (depth_as_sticky || !server_supports_depth)
+                status_depth = depth;
+              else
+                status_depth = svn_depth_unknown; /* Use depth from WC */
+
+              /* Do the deed.  Let the RA layer drive the status editor. */
+              SVN_ERR(svn_ra_do_status2(ra_session, &rb.wrapped_reporter,
+                                        &rb.wrapped_report_baton,
+                                        target_basename, revnum, status_depth,
+                                        editor, edit_baton, pool));
+
+              /* Init the report baton. */
+              rb.ancestor = apr_pstrdup(pool, URL); /* Edited later */
+              rb.set_locks_baton = set_locks_baton;
+              rb.ctx = ctx;
+              rb.pool = pool;
+
+              /* Drive the reporter structure, describing the revisions
+                 within PATH.  When we call reporter->finish_report,
+                 EDITOR will be driven to describe differences between our
+                 working copy and HEAD. */
+              SVN_ERR(svn_wc_crawl_revisions6(ctx->wc_ctx,
+                                              target_abspath,
+                                              &lock_fetch_reporter, &rb,
+                                              FALSE /* restore_files */,
+                                              depth, (! depth_as_sticky),
+                                              (! server_supports_depth),
+                                              FALSE /* use_commit_times */,
+                                              ctx->cancel_func,
+                                              ctx->cancel_baton,
+                                              NULL, NULL, pool));
+            }
         }
 
       if (ctx->notify_func2)
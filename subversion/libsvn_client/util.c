@@ -22,6 +22,7 @@
  */
 
 #include <apr_pools.h>
+#include <apr_portable.h>
 #include <apr_strings.h>
 
 #include "svn_hash.h"
@@ -34,6 +35,7 @@
 #include "svn_wc.h"
 #include "svn_client.h"
 
+#include "private/svn_atomic.h"
 #include "private/svn_client_private.h"
 #include "private/svn_wc_private.h"
 #include "private/svn_fspath.h"
@@ -469,3 +471,87 @@ svn_client__get_shim_callbacks(svn_wc_context_t *wc_ctx,
 
   return callbacks;
 }
+
+/* Baton for task_cancel_func(). */
+typedef struct task_cancel_baton_t
+{
+  /* The client context whose cancellation callback we protect. */
+  svn_client_ctx_t *ctx;
+
+#if APR_HAS_THREADS
+  /* The thread that svn_client__run_tasks() was called on, i.e. the
+     only one that may invoke CTX->cancel_func directly. */
+  apr_os_thread_t main_thread;
+#endif
+
+  /* Sticky flag, set once cancellation has been detected. */
+  svn_atomic_t cancelled;
+} task_cancel_baton_t;
+
+/* Implements svn_cancel_func_t.  Thread-safe proxy for the client
+   context's cancellation callback described in BATON. */
+static svn_error_t *
+task_cancel_func(void *baton)
+{
+  task_cancel_baton_t *b = baton;
+  svn_error_t *err;
+
+  if (svn_atomic_read(&b->cancelled))
+    return svn_error_create(SVN_ERR_CANCELLED, NULL, NULL);
+
+#if APR_HAS_THREADS
+  /* The user's callback is not known to be thread-safe.  Invoke it only
+     from the thread that handed it to us; workers get to see the result
+     through the sticky flag above on their next poll. */
+  if (!apr_os_thread_equal(apr_os_thread_current(), b->main_thread))
+    return SVN_NO_ERROR;
+#endif
+
+  err = b->ctx->cancel_func(b->ctx->cancel_baton);
+  if (err)
+    svn_atomic_set(&b->cancelled, TRUE);
+
+  return svn_error_trace(err);
+}
+
+svn_error_t *
+svn_client__run_tasks(apr_int32_t thread_count,
+                      svn_task__process_func_t process_func,
+                      void *process_baton,
+                      svn_task__output_func_t output_func,
+                      void *output_baton,
+                      svn_task__thread_context_constructor_t
+                        context_constructor,
+                      void *context_baton,
+                      svn_client_ctx_t *ctx,
+                      apr_pool_t *result_pool,
+                      apr_pool_t *scratch_pool)
+{
+  task_cancel_baton_t cb;
+  svn_cancel_func_t cancel_func;
+  void *cancel_baton;
+
+  if (ctx->cancel_func)
+    {
+      cb.ctx = ctx;
+#if APR_HAS_THREADS
+      cb.main_thread = apr_os_thread_current();
+#endif
+      cb.cancelled = FALSE;
+
+      cancel_func = task_cancel_func;
+      cancel_baton = &cb;
+    }
+  else
+    {
+      cancel_func = NULL;
+      cancel_baton = NULL;
+    }
+
+  return svn_error_trace(svn_task__run(thread_count,
+                                       process_func, process_baton,
+                                       output_func, output_baton,
+                                       context_constructor, context_baton,
+                                       cancel_func, cancel_baton,
+                                       result_pool, scratch_pool));
+}
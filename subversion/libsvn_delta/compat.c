@@ -283,35 +283,42 @@ apply_propedit(struct ev2_edit_baton *eb,
 }
 
 
-/* Find all the paths which are immediate children of PATH and return their
-   basenames in a list. */
-static apr_array_header_t *
-get_children(struct ev2_edit_baton *eb,
-             const char *path,
-             apr_pool_t *pool)
+/* Return a mapping of parent relpath to a list of the basenames of its
+   immediate children, covering all paths in EB->CHANGES.  Building the
+   index takes a single pass over the changes, whereas scanning them anew
+   for every added directory used to make large drives quadratic.
+
+   The basenames point into the hash keys of EB->CHANGES, i.e. they stay
+   valid as long as EB does. */
+static apr_hash_t *
+build_child_index(struct ev2_edit_baton *eb,
+                  apr_pool_t *pool)
 {
-  apr_array_header_t *children = apr_array_make(pool, 1, sizeof(const char *));
+  apr_hash_t *child_index = apr_hash_make(pool);
   apr_hash_index_t *hi;
 
   for (hi = apr_hash_first(pool, eb->changes); hi; hi = apr_hash_next(hi))
     {
       const char *repos_relpath = apr_hash_this_key(hi);
-      const char *child;
+      const char *parent;
+      apr_array_header_t *children;
 
-      /* Find potential children. */
-      child = svn_relpath_skip_ancestor(path, repos_relpath);
-      if (!child || !*child)
+      if (!*repos_relpath)
         continue;
 
-      /* If we have a path separator, it's a deep child, so just ignore it.
-         ### Is there an API we should be using for this? */
-      if (strchr(child, '/') != NULL)
-        continue;
+      parent = svn_relpath_dirname(repos_relpath, pool);
+      children = svn_hash_gets(child_index, parent);
+      if (children == NULL)
+        {
+          children = apr_array_make(pool, 4, sizeof(const char *));
+          svn_hash_sets(child_index, parent, children);
+        }
 
-      APR_ARRAY_PUSH(children, const char *) = child;
+      APR_ARRAY_PUSH(children, const char *)
+        = svn_relpath_basename(repos_relpath, NULL);
     }
 
-  return children;
+  return child_index;
 }
 
 
@@ -319,6 +326,7 @@ static svn_error_t *
 process_actions(struct ev2_edit_baton *eb,
                 const char *repos_relpath,
                 const struct change_node *change,
+                apr_hash_t *child_index,
                 apr_pool_t *scratch_pool)
 {
   apr_hash_t *props = NULL;
@@ -403,7 +411,10 @@ process_actions(struct ev2_edit_baton *eb,
             {
               const apr_array_header_t *children;
 
-              children = get_children(eb, repos_relpath, scratch_pool);
+              children = svn_hash_gets(child_index, repos_relpath);
+              if (children == NULL)
+                children = apr_array_make(scratch_pool, 1,
+                                          sizeof(const char *));
               SVN_ERR(svn_editor_add_directory(eb->editor, repos_relpath,
                                                children, props,
                                                replaces_rev));
@@ -464,9 +475,14 @@ run_ev2_actions(struct ev2_edit_baton *eb,
                 apr_pool_t *scratch_pool)
 {
   apr_pool_t *iterpool;
+  apr_hash_t *child_index;
 
   iterpool = svn_pool_create(scratch_pool);
 
+  /* The set of changes is fixed for the duration of this loop, so one
+     index serves all iterations. */
+  child_index = build_child_index(eb, scratch_pool);
+
   /* Possibly pick up where we left off. Occasionally, we do some of these
      as part of close_edit() and then some more as part of abort_edit()  */
   for (; eb->paths_processed < eb->path_order->nelts; ++eb->paths_processed)
@@ -479,7 +495,8 @@ run_ev2_actions(struct ev2_edit_baton *eb,
 
       svn_pool_clear(iterpool);
 
-      SVN_ERR(process_actions(eb, repos_relpath, change, iterpool));
+      SVN_ERR(process_actions(eb, repos_relpath, change, child_index,
+                              iterpool));
     }
   svn_pool_destroy(iterpool);
 
@@ -579,7 +596,7 @@ ev2_add_directory(const char *path,
   apr_pool_t *scratch_pool = result_pool;
   struct ev2_dir_baton *pb = parent_baton;
   struct ev2_dir_baton *cb = apr_pcalloc(result_pool, sizeof(*cb));
-  const char *relpath = map_to_repos_relpath(pb->eb, path, scratch_pool);
+  const char *relpath = map_to_repos_relpath(pb->eb, path, result_pool);
   struct change_node *change = locate_change(pb->eb, relpath);
 
   /* ### assert that RESTRUCTURE is NONE or DELETE?  */
@@ -587,7 +604,7 @@ ev2_add_directory(const char *path,
   change->kind = svn_node_dir;
 
   cb->eb = pb->eb;
-  cb->path = apr_pstrdup(result_pool, relpath);
+  cb->path = relpath;
   cb->base_revision = pb->base_revision;
   *child_baton = cb;
 
@@ -627,10 +644,10 @@ ev2_open_directory(const char *path,
   apr_pool_t *scratch_pool = result_pool;
   struct ev2_dir_baton *pb = parent_baton;
   struct ev2_dir_baton *db = apr_pcalloc(result_pool, sizeof(*db));
-  const char *relpath = map_to_repos_relpath(pb->eb, path, scratch_pool);
+  const char *relpath = map_to_repos_relpath(pb->eb, path, result_pool);
 
   db->eb = pb->eb;
-  db->path = apr_pstrdup(result_pool, relpath);
+  db->path = relpath;
   db->base_revision = base_revision;
 
   if (pb->copyfrom_relpath)
@@ -696,7 +713,7 @@ ev2_add_file(const char *path,
   apr_pool_t *scratch_pool = result_pool;
   struct ev2_file_baton *fb = apr_pcalloc(result_pool, sizeof(*fb));
   struct ev2_dir_baton *pb = parent_baton;
-  const char *relpath = map_to_repos_relpath(pb->eb, path, scratch_pool);
+  const char *relpath = map_to_repos_relpath(pb->eb, path, result_pool);
   struct change_node *change = locate_change(pb->eb, relpath);
 
   /* ### assert that RESTRUCTURE is NONE or DELETE?  */
@@ -704,7 +721,7 @@ ev2_add_file(const char *path,
   change->kind = svn_node_file;
 
   fb->eb = pb->eb;
-  fb->path = apr_pstrdup(result_pool, relpath);
+  fb->path = relpath;
   fb->base_revision = pb->base_revision;
   *file_baton = fb;
 
@@ -742,10 +759,10 @@ ev2_open_file(const char *path,
   apr_pool_t *scratch_pool = result_pool;
   struct ev2_file_baton *fb = apr_pcalloc(result_pool, sizeof(*fb));
   struct ev2_dir_baton *pb = parent_baton;
-  const char *relpath = map_to_repos_relpath(pb->eb, path, scratch_pool);
+  const char *relpath = map_to_repos_relpath(pb->eb, path, result_pool);
 
   fb->eb = pb->eb;
-  fb->path = apr_pstrdup(result_pool, relpath);
+  fb->path = relpath;
   fb->base_revision = base_revision;
 
   if (pb->copyfrom_relpath)
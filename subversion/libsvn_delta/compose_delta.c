@@ -30,6 +30,8 @@
 #include "svn_pools.h"
 #include "delta.h"
 
+#include "private/svn_delta_private.h"
+
 /* Define a MIN macro if this platform doesn't already have one. */
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -126,6 +128,32 @@ free_block(void *ptr, alloc_block_t **free_list)
 }
 
 
+/* ==================================================================== */
+/* State kept alive between compositions. */
+
+struct svn_txdelta__compose_ctx_t
+{
+  /* All recycled structures are allocated in this pool. */
+  apr_pool_t *pool;
+
+  /* Node blocks released by previous compositions. */
+  alloc_block_t *free_list;
+
+  /* Reusable buffer for the offset index, with room for OFFS_CAPACITY
+     entries. */
+  apr_size_t *offs;
+  int offs_capacity;
+};
+
+svn_txdelta__compose_ctx_t *
+svn_txdelta__compose_ctx_create(apr_pool_t *pool)
+{
+  svn_txdelta__compose_ctx_t *ctx = apr_pcalloc(pool, sizeof(*ctx));
+  ctx->pool = pool;
+  return ctx;
+}
+
+
 
 /* ==================================================================== */
 /* Mapping offsets in the target stream to txdelta ops. */
@@ -136,18 +164,36 @@ typedef struct offset_index_t
   apr_size_t *offs;
 } offset_index_t;
 
-/* Create an index mapping target stream offsets to delta ops in
-   WINDOW. Allocate from POOL. */
+/* Initialize *NDX to map target stream offsets to delta ops in WINDOW.
+   If CTX is not null, reuse (and, if necessary, grow) its offset buffer;
+   otherwise allocate the buffer from POOL. */
 
-static offset_index_t *
-create_offset_index(const svn_txdelta_window_t *window, apr_pool_t *pool)
+static void
+init_offset_index(offset_index_t *ndx,
+                  const svn_txdelta_window_t *window,
+                  svn_txdelta__compose_ctx_t *ctx,
+                  apr_pool_t *pool)
 {
-  offset_index_t *ndx = apr_palloc(pool, sizeof(*ndx));
   apr_size_t offset = 0;
   int i;
 
   ndx->length = window->num_ops;
-  ndx->offs = apr_palloc(pool, (ndx->length + 1) * sizeof(*ndx->offs));
+  if (ctx)
+    {
+      if (ctx->offs_capacity < ndx->length + 1)
+        {
+          /* Grow in larger steps, so that a chain of slowly growing
+             windows does not allocate a new buffer for every one. */
+          ctx->offs_capacity = 2 * (ndx->length + 1);
+          ctx->offs = apr_palloc(ctx->pool,
+                                 ctx->offs_capacity * sizeof(*ctx->offs));
+        }
+      ndx->offs = ctx->offs;
+    }
+  else
+    {
+      ndx->offs = apr_palloc(pool, (ndx->length + 1) * sizeof(*ndx->offs));
+    }
 
   for (i = 0; i < ndx->length; ++i)
     {
@@ -155,8 +201,6 @@ create_offset_index(const svn_txdelta_window_t *window, apr_pool_t *pool)
       offset += window->ops[i].length;
     }
   ndx->offs[ndx->length] = offset;
-
-  return ndx;
 }
 
 /* Find the index of the delta op thet defines that data at OFFSET in
@@ -220,15 +264,17 @@ typedef struct range_index_t
   apr_pool_t *pool;
 } range_index_t;
 
-/* Create a range index tree. Allocate from POOL. */
-static range_index_t *
-create_range_index(apr_pool_t *pool)
+/* Initialize the range index tree *NDX.  If CTX is not null, nodes are
+   allocated in its pool and taken from its free list; otherwise they
+   come from POOL. */
+static void
+init_range_index(range_index_t *ndx,
+                 svn_txdelta__compose_ctx_t *ctx,
+                 apr_pool_t *pool)
 {
-  range_index_t *ndx = apr_palloc(pool, sizeof(*ndx));
   ndx->tree = NULL;
-  ndx->pool = pool;
-  ndx->free_list = NULL;
-  return ndx;
+  ndx->pool = ctx ? ctx->pool : pool;
+  ndx->free_list = ctx ? ctx->free_list : NULL;
 }
 
 /* Allocate a node for the range index tree. */
@@ -761,18 +807,24 @@ copy_source_ops(apr_size_t offset, apr_size_t limit,
 
 
 svn_txdelta_window_t *
-svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
-                            const svn_txdelta_window_t *window_B,
-                            apr_pool_t *pool)
+svn_txdelta__compose_windows(const svn_txdelta_window_t *window_A,
+                             const svn_txdelta_window_t *window_B,
+                             svn_txdelta__compose_ctx_t *ctx,
+                             apr_pool_t *pool)
 {
   svn_txdelta__ops_baton_t build_baton = { 0 };
   svn_txdelta_window_t *composite;
-  apr_pool_t *subpool = svn_pool_create(pool);
-  offset_index_t *offset_index = create_offset_index(window_A, subpool);
-  range_index_t *range_index = create_range_index(subpool);
+  apr_pool_t *subpool = ctx ? NULL : svn_pool_create(pool);
+  offset_index_t offset_index_here;
+  range_index_t range_index_here;
+  offset_index_t *offset_index = &offset_index_here;
+  range_index_t *range_index = &range_index_here;
   apr_size_t target_offset = 0;
   int i;
 
+  init_offset_index(offset_index, window_A, ctx, subpool);
+  init_range_index(range_index, ctx, subpool);
+
   /* Read the description of the delta composition algorithm in
      notes/fs-improvements.txt before going any further.
      You have been warned. */
@@ -829,7 +881,15 @@ svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
       target_offset += op->length;
     }
 
-  svn_pool_destroy(subpool);
+  if (ctx)
+    {
+      /* Return the tree's nodes to the context's free list, where the
+         next composition will pick them up again. */
+      delete_subtree(range_index, range_index->tree);
+      ctx->free_list = range_index->free_list;
+    }
+  else
+    svn_pool_destroy(subpool);
 
   composite = svn_txdelta__make_window(&build_baton, pool);
   composite->sview_offset = window_A->sview_offset;
@@ -837,3 +897,12 @@ svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
   composite->tview_len = window_B->tview_len;
   return composite;
 }
+
+
+svn_txdelta_window_t *
+svn_txdelta_compose_windows(const svn_txdelta_window_t *window_A,
+                            const svn_txdelta_window_t *window_B,
+                            apr_pool_t *pool)
+{
+  return svn_txdelta__compose_windows(window_A, window_B, NULL, pool);
+}
@@ -44,6 +44,15 @@ extern "C" {
 
 #define SVN_DELTA_WINDOW_SIZE 102400
 
+/* The largest svndiff window that we accept when decoding, and the upper
+   limit for producer-side window sizes.  We have always emitted windows
+   of SVN_DELTA_WINDOW_SIZE; decoupling the decoder limit from the
+   producer size lets larger windows - which give much better xdelta
+   matches on large binaries - be phased in without choking on data from
+   peers that already use them.  The limit also bounds the memory that a
+   decoder may allocate per window for untrusted input. */
+#define SVN_DELTA_WINDOW_SIZE_MAX (16 * 1024 * 1024)
+
 
 /* Context/baton for building an operation sequence. */
 
@@ -81,12 +90,16 @@ svn_txdelta__make_window(const svn_txdelta__ops_baton_t *build_baton,
                          apr_pool_t *pool);
 
 
-/* Create xdelta window data. Allocate temporary data from POOL. */
+/* Create xdelta window data.  Grow the op and new-data buffers in
+   BUILD_BATON from BUILD_POOL; allocate the temporary match table from
+   SCRATCH_POOL.  This allows callers to reuse BUILD_BATON's buffers
+   across windows while still clearing the per-window scratch data. */
 void svn_txdelta__xdelta(svn_txdelta__ops_baton_t *build_baton,
                          const char *start,
                          apr_size_t source_len,
                          apr_size_t target_len,
-                         apr_pool_t *pool);
+                         apr_pool_t *build_pool,
+                         apr_pool_t *scratch_pool);
 
 
 #ifdef __cplusplus
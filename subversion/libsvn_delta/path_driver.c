@@ -166,7 +166,7 @@ svn_delta_path_driver3(const svn_delta_editor_t *editor,
   if (sort_paths && relpaths->nelts > 1)
     {
       apr_array_header_t *sorted = apr_array_copy(subpool, relpaths);
-      svn_sort__array(sorted, svn_sort_compare_paths);
+      svn_sort__array_paths(sorted);
       relpaths = sorted;
     }
 
@@ -24,6 +24,8 @@
 
 #include <assert.h>
 #include <string.h>
+
+#include <apr_thread_proc.h>
 #include "svn_delta.h"
 #include "svn_io.h"
 #include "delta.h"
@@ -35,17 +37,21 @@
 #include "private/svn_subr_private.h"
 #include "private/svn_string_private.h"
 #include "private/svn_dep_compat.h"
+#include "private/svn_thread_cond.h"
 
 static const char SVNDIFF_V0[] = { 'S', 'V', 'N', 0 };
 static const char SVNDIFF_V1[] = { 'S', 'V', 'N', 1 };
 static const char SVNDIFF_V2[] = { 'S', 'V', 'N', 2 };
+static const char SVNDIFF_V3[] = { 'S', 'V', 'N', 3 };
 
 #define SVNDIFF_HEADER_SIZE (sizeof(SVNDIFF_V0))
 
 static const char *
 get_svndiff_header(int version)
 {
-  if (version == 2)
+  if (version == 3)
+    return SVNDIFF_V3;
+  else if (version == 2)
     return SVNDIFF_V2;
   else if (version == 1)
     return SVNDIFF_V1;
@@ -70,9 +76,10 @@ struct encoder_baton {
 /* This is at least as big as the largest size for a single instruction. */
 #define MAX_INSTRUCTION_LEN (2*SVN__MAX_ENCODED_UINT_LEN+1)
 /* This is at least as big as the largest possible instructions
-   section: in theory, the instructions could be SVN_DELTA_WINDOW_SIZE
+   section: in theory, the instructions could be SVN_DELTA_WINDOW_SIZE_MAX
    1-byte copy-from-source instructions (though this is very unlikely). */
-#define MAX_INSTRUCTION_SECTION_LEN (SVN_DELTA_WINDOW_SIZE*MAX_INSTRUCTION_LEN)
+#define MAX_INSTRUCTION_SECTION_LEN \
+  ((apr_size_t)SVN_DELTA_WINDOW_SIZE_MAX * MAX_INSTRUCTION_LEN)
 
 
 /* Append an encoded integer to a string.  */
@@ -198,7 +205,15 @@ encode_window(svn_stringbuf_t **instructions_p,
   append_encoded_int(header, window->sview_offset);
   append_encoded_int(header, window->sview_len);
   append_encoded_int(header, window->tview_len);
-  if (version == 2)
+  if (version == 3)
+    {
+      svn_stringbuf_t *compressed_instructions;
+      compressed_instructions = svn_stringbuf_create_empty(pool);
+      SVN_ERR(svn__compress_zstd(instructions->data, instructions->len,
+                                 compressed_instructions, compression_level));
+      instructions = compressed_instructions;
+    }
+  else if (version == 2)
     {
       svn_stringbuf_t *compressed_instructions;
       compressed_instructions = svn_stringbuf_create_empty(pool);
@@ -217,7 +232,16 @@ encode_window(svn_stringbuf_t **instructions_p,
   append_encoded_int(header, instructions->len);
 
   /* Encode the data. */
-  if (version == 2)
+  if (version == 3)
+    {
+      svn_stringbuf_t *compressed = svn_stringbuf_create_empty(pool);
+
+      SVN_ERR(svn__compress_zstd(window->new_data->data,
+                                 window->new_data->len,
+                                 compressed, compression_level));
+      newdata = svn_stringbuf__morph_into_string(compressed);
+    }
+  else if (version == 2)
     {
       svn_stringbuf_t *compressed = svn_stringbuf_create_empty(pool);
 
@@ -344,6 +368,569 @@ svn_txdelta_to_svndiff(svn_stream_t *output,
                           SVN_DELTA_COMPRESSION_LEVEL_DEFAULT, pool);
 }
 
+
+/* ----- Pipelined text delta to svndiff ----- */
+
+#if APR_HAS_THREADS
+
+/* More worker threads than this would be starved by a single window
+   producer anyway. */
+#define MAX_ENCODER_THREADS 8
+
+/* Processing states of a pipeline slot. */
+typedef enum pipeline_slot_state_t
+{
+  slot_empty,    /* free for the producer to fill */
+  slot_filled,   /* holds a window, waiting for a worker */
+  slot_busy,     /* a worker is currently encoding the window */
+  slot_done      /* encoded data is ready to be written out */
+} pipeline_slot_state_t;
+
+/* One window making its way through the encoder pipeline. */
+typedef struct pipeline_slot_t
+{
+  pipeline_slot_state_t state;
+
+  /* Sequence number of the window currently in this slot. */
+  apr_uint64_t seq;
+
+  /* The window to encode, copied into POOL. */
+  svn_txdelta_window_t *window;
+
+  /* Encoding results, allocated in POOL (see encode_window()). */
+  svn_stringbuf_t *instructions;
+  svn_stringbuf_t *header;
+  const svn_string_t *newdata;
+
+  /* Error raised while encoding the window, if any. */
+  svn_error_t *err;
+
+  /* Per-slot pool, cleared when the slot gets reused.  A sub-pool of
+     the pipeline's thread-safe SLOT_ROOT pool because producer and
+     workers allocate from sibling slot pools concurrently. */
+  apr_pool_t *pool;
+} pipeline_slot_t;
+
+/* Baton for the pipelined encoder.  The window handler (the producer)
+   runs on the caller's thread and is the only one to touch OUTPUT, so
+   windows leave the encoder in exactly the order they came in. */
+struct pipelined_encoder_baton {
+  svn_stream_t *output;
+  svn_boolean_t header_done;
+  int version;
+  int compression_level;
+
+  /* Worker threads; THREAD_COUNT of them once STARTED. */
+  int thread_count;
+  svn_boolean_t started;
+  apr_thread_t **threads;
+
+  /* After a fatal error, the pipeline is shut down for good. */
+  svn_boolean_t failed;
+
+  /* SLOT_COUNT slots.  The window with sequence number SEQ only ever
+     uses slot SEQ mod SLOT_COUNT, so draining the ring in order is the
+     same as draining it in slot order. */
+  int slot_count;
+  pipeline_slot_t **slots;
+
+  /* Root pool of the per-slot pools and of the worker thread objects,
+     with a thread-safe allocator.  Destroyed once the worker threads
+     have terminated. */
+  apr_pool_t *slot_root;
+
+  /* Sequence number of the next window handed in by the producer and
+     of the next window to write to OUTPUT, respectively. */
+  apr_uint64_t next_in_seq;
+  apr_uint64_t next_out_seq;
+
+  /* Tells the workers to exit once no more filled slots remain. */
+  svn_boolean_t shutdown;
+
+  /* Protects all mutable state in this struct and the slot states. */
+  svn_mutex__t *mutex;
+
+  /* Signalled when a slot becomes filled or SHUTDOWN is set. */
+  svn_thread_cond__t *work_available;
+
+  /* Signalled when a slot becomes done. */
+  svn_thread_cond__t *slot_done;
+
+  /* The pool this baton got allocated in. */
+  apr_pool_t *pool;
+};
+
+/* Find the oldest window in EB waiting for a worker, flag it as being
+   worked on and return its slot in *SLOT.  Sleep while there is nothing
+   to do; return NULL once the pipeline shuts down.
+   To be called with EB->MUTEX held. */
+static svn_error_t *
+pick_filled_slot(pipeline_slot_t **slot,
+                 struct pipelined_encoder_baton *eb)
+{
+  while (TRUE)
+    {
+      int i;
+
+      *slot = NULL;
+      for (i = 0; i < eb->slot_count; ++i)
+        {
+          pipeline_slot_t *candidate = eb->slots[i];
+
+          if (candidate->state == slot_filled
+              && (*slot == NULL || candidate->seq < (*slot)->seq))
+            *slot = candidate;
+        }
+
+      if (*slot != NULL)
+        {
+          (*slot)->state = slot_busy;
+          return SVN_NO_ERROR;
+        }
+
+      if (eb->shutdown)
+        return SVN_NO_ERROR;
+
+      SVN_ERR(svn_thread_cond__wait(eb->work_available, eb->mutex));
+    }
+}
+
+/* Flag SLOT's window as encoded and wake the producer.
+   To be called with EB->MUTEX held. */
+static svn_error_t *
+mark_slot_done(pipeline_slot_t *slot,
+               struct pipelined_encoder_baton *eb)
+{
+  slot->state = slot_done;
+  return svn_error_trace(svn_thread_cond__signal(eb->slot_done));
+}
+
+/* The encoder worker loop: encode filled slots until shutdown.
+   EB is the pipeline to work for. */
+static svn_error_t *
+encoder_worker(struct pipelined_encoder_baton *eb)
+{
+  while (TRUE)
+    {
+      pipeline_slot_t *slot;
+
+      SVN_MUTEX__WITH_LOCK(eb->mutex, pick_filled_slot(&slot, eb));
+      if (slot == NULL)
+        break;
+
+      slot->err = encode_window(&slot->instructions, &slot->header,
+                                &slot->newdata, slot->window,
+                                eb->version, eb->compression_level,
+                                slot->pool);
+
+      SVN_MUTEX__WITH_LOCK(eb->mutex, mark_slot_done(slot, eb));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* The plain APR thread around the worker loop.
+   DATA is the encoder baton to work for. */
+static void * APR_THREAD_FUNC
+encoder_thread(apr_thread_t *thread, void *data)
+{
+  apr_status_t result = APR_SUCCESS;
+  svn_error_t *err = encoder_worker(data);
+
+  if (err)
+    {
+      result = err->apr_err;
+      svn_error_clear(err);
+    }
+
+  /* End the thread explicitly to prevent APR_INCOMPLETE return codes in
+     apr_thread_join(). */
+  apr_thread_exit(thread, result);
+  return NULL;
+}
+
+/* Tell EB's workers to exit as soon as they run out of filled slots.
+   To be called with EB->MUTEX held. */
+static svn_error_t *
+send_shutdown(struct pipelined_encoder_baton *eb)
+{
+  eb->shutdown = TRUE;
+  return svn_error_trace(svn_thread_cond__broadcast(eb->work_available));
+}
+
+/* Wind EB down: tell the workers to finish, wait for them to terminate
+   and release the slot pools.  Returns the errors they reported, if any.
+   It is safe to call this more than once. */
+static svn_error_t *
+stop_pipeline(struct pipelined_encoder_baton *eb)
+{
+  svn_error_t *err = SVN_NO_ERROR;
+  int i;
+
+  if (eb->started)
+    {
+      eb->started = FALSE;
+
+      SVN_MUTEX__WITH_LOCK(eb->mutex, send_shutdown(eb));
+
+      for (i = 0; i < eb->thread_count; ++i)
+        {
+          apr_status_t retval;
+          apr_status_t sync_status = apr_thread_join(&retval,
+                                                     eb->threads[i]);
+
+          if (retval != APR_SUCCESS)
+            err = svn_error_compose_create(err,
+                      svn_error_wrap_apr(retval,
+                                         _("Encoder thread reported error")));
+          if (sync_status != APR_SUCCESS)
+            err = svn_error_compose_create(err,
+                      svn_error_wrap_apr(sync_status,
+                                         _("Encoder thread join error")));
+        }
+    }
+
+  if (eb->slot_root)
+    {
+      svn_pool_destroy(eb->slot_root);
+      eb->slot_root = NULL;
+    }
+
+  return err;
+}
+
+/* Pool cleanup handler: if the edit drive got abandoned without sending
+   the final NULL window, make sure the worker threads of the pipeline
+   described by DATA are gone before the pools they work in disappear. */
+static apr_status_t
+cleanup_pipeline(void *data)
+{
+  struct pipelined_encoder_baton *eb = data;
+
+  svn_error_clear(stop_pipeline(eb));
+
+  return APR_SUCCESS;
+}
+
+/* Bring up the mutex, the condition variables and the worker threads
+   of EB. */
+static svn_error_t *
+start_pipeline(struct pipelined_encoder_baton *eb)
+{
+  int i;
+
+  SVN_ERR(svn_mutex__init(&eb->mutex, TRUE, eb->pool));
+  SVN_ERR(svn_thread_cond__create(&eb->work_available, eb->pool));
+  SVN_ERR(svn_thread_cond__create(&eb->slot_done, eb->pool));
+
+  eb->started = TRUE;
+  for (i = 0; i < eb->thread_count; ++i)
+    {
+      /* The workers end through apr_thread_exit(), which destroys the
+         thread's own pool from the worker thread; create them from
+         SLOT_ROOT, whose serialized allocator makes that safe next to
+         the producer's concurrent slot pool usage. */
+      apr_status_t status = apr_thread_create(&eb->threads[i], NULL,
+                                              encoder_thread, eb,
+                                              eb->slot_root);
+      if (status)
+        {
+          svn_error_t *err =
+            svn_error_wrap_apr(status, _("Creating encoder thread failed"));
+
+          /* Wind down the threads that we did manage to start. */
+          eb->thread_count = i;
+          return svn_error_compose_create(err, stop_pipeline(eb));
+        }
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Write the encoded window in SLOT to EB->OUTPUT, prepending the stream
+   header if it has not been written yet.  Called outside the mutex: the
+   producer is the only one to touch slots in the "done" state. */
+static svn_error_t *
+write_encoded_slot(struct pipelined_encoder_baton *eb,
+                   pipeline_slot_t *slot)
+{
+  apr_size_t len;
+
+  if (slot->err)
+    {
+      svn_error_t *err = slot->err;
+
+      slot->err = SVN_NO_ERROR;
+      return svn_error_trace(err);
+    }
+
+  if (!eb->header_done)
+    {
+      len = SVNDIFF_HEADER_SIZE;
+      SVN_ERR(svn_stream_write(eb->output, get_svndiff_header(eb->version),
+                               &len));
+      eb->header_done = TRUE;
+    }
+
+  len = slot->header->len;
+  SVN_ERR(svn_stream_write(eb->output, slot->header->data, &len));
+  if (slot->instructions->len > 0)
+    {
+      len = slot->instructions->len;
+      SVN_ERR(svn_stream_write(eb->output, slot->instructions->data, &len));
+    }
+  if (slot->newdata->len > 0)
+    {
+      len = slot->newdata->len;
+      SVN_ERR(svn_stream_write(eb->output, slot->newdata->data, &len));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Flag SLOT as ready for reuse and advance EB's output sequence.
+   To be called with EB->MUTEX held. */
+static svn_error_t *
+recycle_slot(pipeline_slot_t *slot,
+             struct pipelined_encoder_baton *eb)
+{
+  slot->state = slot_empty;
+  eb->next_out_seq++;
+
+  return SVN_NO_ERROR;
+}
+
+/* If the slot for the next incoming window of EB is empty, set
+   *OUT_SLOT to NULL.  Otherwise, wait until the oldest outstanding
+   window has been encoded and return its slot in *OUT_SLOT for the
+   producer to write out.  To be called with EB->MUTEX held. */
+static svn_error_t *
+next_slot_to_write(pipeline_slot_t **out_slot,
+                   struct pipelined_encoder_baton *eb)
+{
+  while (TRUE)
+    {
+      pipeline_slot_t *head = eb->slots[eb->next_out_seq % eb->slot_count];
+
+      if (eb->next_out_seq < eb->next_in_seq && head->state == slot_done)
+        {
+          *out_slot = head;
+          return SVN_NO_ERROR;
+        }
+
+      if (eb->slots[eb->next_in_seq % eb->slot_count]->state == slot_empty)
+        {
+          *out_slot = NULL;
+          return SVN_NO_ERROR;
+        }
+
+      /* The ring is full and the oldest window is still being encoded:
+         wait for a worker to finish it. */
+      SVN_ERR(svn_thread_cond__wait(eb->slot_done, eb->mutex));
+    }
+}
+
+/* Like next_slot_to_write(), but keep waiting until every window that
+   entered the pipeline of EB has been encoded; set *OUT_SLOT to NULL
+   only when all of them have been written out.
+   To be called with EB->MUTEX held. */
+static svn_error_t *
+wait_for_head_slot(pipeline_slot_t **out_slot,
+                   struct pipelined_encoder_baton *eb)
+{
+  while (eb->next_out_seq < eb->next_in_seq)
+    {
+      pipeline_slot_t *head = eb->slots[eb->next_out_seq % eb->slot_count];
+
+      if (head->state == slot_done)
+        {
+          *out_slot = head;
+          return SVN_NO_ERROR;
+        }
+
+      SVN_ERR(svn_thread_cond__wait(eb->slot_done, eb->mutex));
+    }
+
+  *out_slot = NULL;
+  return SVN_NO_ERROR;
+}
+
+/* Flag SLOT as waiting for a worker and wake one up.
+   To be called with EB->MUTEX held. */
+static svn_error_t *
+fill_slot(pipeline_slot_t *slot,
+          struct pipelined_encoder_baton *eb)
+{
+  slot->seq = eb->next_in_seq++;
+  slot->state = slot_filled;
+
+  return svn_error_trace(svn_thread_cond__signal(eb->work_available));
+}
+
+/* Hand WINDOW over to EB's encoder pipeline, writing out completed
+   older windows as their slots get recycled.  Blocks while the ring is
+   full and the oldest window has not been encoded yet. */
+static svn_error_t *
+push_window(struct pipelined_encoder_baton *eb,
+            svn_txdelta_window_t *window)
+{
+  pipeline_slot_t *slot = eb->slots[eb->next_in_seq % eb->slot_count];
+
+  while (TRUE)
+    {
+      pipeline_slot_t *out_slot;
+
+      SVN_MUTEX__WITH_LOCK(eb->mutex, next_slot_to_write(&out_slot, eb));
+      if (out_slot == NULL)
+        break;
+
+      SVN_ERR(write_encoded_slot(eb, out_slot));
+      SVN_MUTEX__WITH_LOCK(eb->mutex, recycle_slot(out_slot, eb));
+    }
+
+  /* The slot is empty now and the producer owns it: no lock needed to
+     fill in the window data. */
+  svn_pool_clear(slot->pool);
+  slot->window = svn_txdelta_window_dup(window, slot->pool);
+  slot->err = SVN_NO_ERROR;
+
+  SVN_MUTEX__WITH_LOCK(eb->mutex, fill_slot(slot, eb));
+
+  return SVN_NO_ERROR;
+}
+
+/* Drain all outstanding windows of EB in order, shut down the workers
+   and close the output stream. */
+static svn_error_t *
+finish_pipeline(struct pipelined_encoder_baton *eb)
+{
+  apr_size_t len;
+
+  while (TRUE)
+    {
+      pipeline_slot_t *out_slot;
+
+      SVN_MUTEX__WITH_LOCK(eb->mutex, wait_for_head_slot(&out_slot, eb));
+      if (out_slot == NULL)
+        break;
+
+      SVN_ERR(write_encoded_slot(eb, out_slot));
+      SVN_MUTEX__WITH_LOCK(eb->mutex, recycle_slot(out_slot, eb));
+    }
+
+  SVN_ERR(stop_pipeline(eb));
+
+  /* Write the svndiff header even if there were no windows at all. */
+  if (!eb->header_done)
+    {
+      len = SVNDIFF_HEADER_SIZE;
+      SVN_ERR(svn_stream_write(eb->output, get_svndiff_header(eb->version),
+                               &len));
+      eb->header_done = TRUE;
+    }
+
+  return svn_error_trace(svn_stream_close(eb->output));
+}
+
+/* Window handler for the pipelined encoder; the threaded cousin of
+   window_handler() above. */
+static svn_error_t *
+pipelined_window_handler(svn_txdelta_window_t *window, void *baton)
+{
+  struct pipelined_encoder_baton *eb = baton;
+  svn_error_t *err;
+
+  if (eb->failed)
+    {
+      /* The pipeline has already been torn down.  Accept the obligatory
+         final NULL window silently, but nothing else. */
+      SVN_ERR_ASSERT(window == NULL);
+      return SVN_NO_ERROR;
+    }
+
+  if (!eb->started)
+    {
+      err = start_pipeline(eb);
+      if (err)
+        {
+          eb->failed = TRUE;
+          return svn_error_trace(err);
+        }
+    }
+
+  if (window != NULL)
+    err = push_window(eb, window);
+  else
+    err = finish_pipeline(eb);
+
+  if (err)
+    {
+      eb->failed = TRUE;
+
+      /* Bring the workers down before reporting the problem so that
+         none of them keeps running into pools about to disappear. */
+      return svn_error_compose_create(err, stop_pipeline(eb));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+#endif /* APR_HAS_THREADS */
+
+void
+svn_txdelta__to_svndiff_pipelined(svn_txdelta_window_handler_t *handler,
+                                  void **handler_baton,
+                                  svn_stream_t *output,
+                                  int svndiff_version,
+                                  int compression_level,
+                                  int thread_count,
+                                  apr_pool_t *pool)
+{
+#if APR_HAS_THREADS
+  if (thread_count > 1 && svndiff_version > 0)
+    {
+      struct pipelined_encoder_baton *eb;
+      int i;
+
+      if (thread_count > MAX_ENCODER_THREADS)
+        thread_count = MAX_ENCODER_THREADS;
+
+      eb = apr_pcalloc(pool, sizeof(*eb));
+      eb->output = output;
+      eb->version = svndiff_version;
+      eb->compression_level = compression_level;
+      eb->thread_count = thread_count;
+      eb->threads = apr_palloc(pool, thread_count * sizeof(*eb->threads));
+      eb->slot_count = 2 * thread_count;
+      eb->slots = apr_palloc(pool, eb->slot_count * sizeof(*eb->slots));
+      eb->slot_root =
+        apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+      eb->pool = pool;
+
+      for (i = 0; i < eb->slot_count; ++i)
+        {
+          pipeline_slot_t *slot = apr_pcalloc(pool, sizeof(*slot));
+
+          slot->pool = svn_pool_create(eb->slot_root);
+          eb->slots[i] = slot;
+        }
+
+      apr_pool_cleanup_register(pool, eb, cleanup_pipeline,
+                                apr_pool_cleanup_null);
+
+      *handler = pipelined_window_handler;
+      *handler_baton = eb;
+      return;
+    }
+#endif
+
+  /* Version 0 does not compress, so there is nothing to offload, and
+     without threads there is nobody to offload it to.  Fall back to the
+     plain single-threaded encoder. */
+  svn_txdelta_to_svndiff3(handler, handler_baton, output, svndiff_version,
+                          compression_level, pool);
+}
+
 
 /* ----- svndiff to text delta ----- */
 
@@ -546,12 +1133,17 @@ count_and_verify_instructions(int *ninst,
    the remainder of the window contents, fill in a delta window
    structure *WINDOW.  New allocations will be performed in POOL;
    the new_data field of *WINDOW will refer directly to memory pointed
-   to by DATA. */
+   to by DATA.
+
+   If BORROW_DATA is set, the caller guarantees that DATA is followed
+   by a NUL byte right after the window contents and remains valid and
+   unmodified for the lifetime of *WINDOW.  The new data section will
+   then be referenced in place instead of being copied. */
 static svn_error_t *
 decode_window(svn_txdelta_window_t *window, svn_filesize_t sview_offset,
               apr_size_t sview_len, apr_size_t tview_len, apr_size_t inslen,
               apr_size_t newlen, const unsigned char *data, apr_pool_t *pool,
-              unsigned int version)
+              unsigned int version, svn_boolean_t borrow_data)
 {
   const unsigned char *insend;
   int ninst;
@@ -565,13 +1157,29 @@ decode_window(svn_txdelta_window_t *window, svn_filesize_t sview_offset,
 
   insend = data + inslen;
 
-  if (version == 2)
+  if (version == 3)
+    {
+      svn_stringbuf_t *instout = svn_stringbuf_create_empty(pool);
+      svn_stringbuf_t *ndout = svn_stringbuf_create_empty(pool);
+
+      SVN_ERR(svn__decompress_zstd(insend, newlen, ndout,
+                                   SVN_DELTA_WINDOW_SIZE_MAX));
+      SVN_ERR(svn__decompress_zstd(data, insend - data, instout,
+                                   MAX_INSTRUCTION_SECTION_LEN));
+
+      newlen = ndout->len;
+      data = (unsigned char *)instout->data;
+      insend = (unsigned char *)instout->data + instout->len;
+
+      new_data = svn_stringbuf__morph_into_string(ndout);
+    }
+  else if (version == 2)
     {
       svn_stringbuf_t *instout = svn_stringbuf_create_empty(pool);
       svn_stringbuf_t *ndout = svn_stringbuf_create_empty(pool);
 
       SVN_ERR(svn__decompress_lz4(insend, newlen, ndout,
-                                  SVN_DELTA_WINDOW_SIZE));
+                                  SVN_DELTA_WINDOW_SIZE_MAX));
       SVN_ERR(svn__decompress_lz4(data, insend - data, instout,
                                   MAX_INSTRUCTION_SECTION_LEN));
 
@@ -587,7 +1195,7 @@ decode_window(svn_txdelta_window_t *window, svn_filesize_t sview_offset,
       svn_stringbuf_t *ndout = svn_stringbuf_create_empty(pool);
 
       SVN_ERR(svn__decompress_zlib(insend, newlen, ndout,
-                                   SVN_DELTA_WINDOW_SIZE));
+                                   SVN_DELTA_WINDOW_SIZE_MAX));
       SVN_ERR(svn__decompress_zlib(data, insend - data, instout,
                                    MAX_INSTRUCTION_SECTION_LEN));
 
@@ -597,6 +1205,14 @@ decode_window(svn_txdelta_window_t *window, svn_filesize_t sview_offset,
 
       new_data = svn_stringbuf__morph_into_string(ndout);
     }
+  else if (borrow_data)
+    {
+      /* Zero-copy path: reference the new data in place.  The caller
+         vouches for the data[len]=='\0' invariant of svn_string_t. */
+      new_data = apr_palloc(pool, sizeof(*new_data));
+      new_data->data = (const char *)insend;
+      new_data->len = newlen;
+    }
   else
     {
       /* Copy the data because an svn_string_t must have the invariant
@@ -653,6 +1269,8 @@ write_handler(void *baton,
         db->version = 1;
       else if (memcmp(buffer, SVNDIFF_V2 + db->header_bytes, nheader) == 0)
         db->version = 2;
+      else if (memcmp(buffer, SVNDIFF_V3 + db->header_bytes, nheader) == 0)
+        db->version = 3;
       else
         return svn_error_create(SVN_ERR_SVNDIFF_INVALID_HEADER, NULL,
                                 _("Svndiff has invalid header"));
@@ -710,10 +1328,10 @@ write_handler(void *baton,
           if (p == NULL)
               break;
 
-          if (tview_len > SVN_DELTA_WINDOW_SIZE ||
-              sview_len > SVN_DELTA_WINDOW_SIZE ||
+          if (tview_len > SVN_DELTA_WINDOW_SIZE_MAX ||
+              sview_len > SVN_DELTA_WINDOW_SIZE_MAX ||
               /* for svndiff1, newlen includes the original length */
-              newlen > SVN_DELTA_WINDOW_SIZE + SVN__MAX_ENCODED_UINT_LEN ||
+              newlen > SVN_DELTA_WINDOW_SIZE_MAX + SVN__MAX_ENCODED_UINT_LEN ||
               inslen > MAX_INSTRUCTION_SECTION_LEN)
             return svn_error_create(
                      SVN_ERR_SVNDIFF_CORRUPT_WINDOW, NULL,
@@ -755,11 +1373,29 @@ write_handler(void *baton,
       if ((apr_size_t) (end - p) < db->inslen + db->newlen)
         return SVN_NO_ERROR;
 
-      /* Decode the window and send it off. */
-      SVN_ERR(decode_window(&window, db->sview_offset, db->sview_len,
+      /* Decode the window and send it off.  The window only lives for
+         the duration of the consumer call and DB->BUFFER will not be
+         modified before that call returns.  So, instead of copying the
+         new data section out of the buffer, temporarily NUL-terminate
+         it in place (the svn_string_t invariant) and reference it. */
+      {
+        apr_size_t window_end
+          = (apr_size_t)(p - (const unsigned char *)db->buffer->data)
+            + db->inslen + db->newlen;
+        char saved_byte = db->buffer->data[window_end];
+        svn_error_t *err;
+
+        db->buffer->data[window_end] = '\0';
+
+        err = decode_window(&window, db->sview_offset, db->sview_len,
                             db->tview_len, db->inslen, db->newlen, p,
-                            db->subpool, db->version));
-      SVN_ERR(db->consumer_func(&window, db->consumer_baton));
+                            db->subpool, db->version, TRUE);
+        if (!err)
+          err = db->consumer_func(&window, db->consumer_baton);
+
+        db->buffer->data[window_end] = saved_byte;
+        SVN_ERR(err);
+      }
 
       p += db->inslen + db->newlen;
 
@@ -921,10 +1557,10 @@ read_window_header(svn_stream_t *stream, svn_filesize_t *sview_offset,
   SVN_ERR(read_one_size(inslen, header_len, stream));
   SVN_ERR(read_one_size(newlen, header_len, stream));
 
-  if (*tview_len > SVN_DELTA_WINDOW_SIZE ||
-      *sview_len > SVN_DELTA_WINDOW_SIZE ||
+  if (*tview_len > SVN_DELTA_WINDOW_SIZE_MAX ||
+      *sview_len > SVN_DELTA_WINDOW_SIZE_MAX ||
       /* for svndiff1, newlen includes the original length */
-      *newlen > SVN_DELTA_WINDOW_SIZE + SVN__MAX_ENCODED_UINT_LEN ||
+      *newlen > SVN_DELTA_WINDOW_SIZE_MAX + SVN__MAX_ENCODED_UINT_LEN ||
       *inslen > MAX_INSTRUCTION_SECTION_LEN)
     return svn_error_create(SVN_ERR_SVNDIFF_CORRUPT_WINDOW, NULL,
                             _("Svndiff contains a too-large window"));
@@ -952,14 +1588,18 @@ svn_txdelta_read_svndiff_window(svn_txdelta_window_t **window,
   SVN_ERR(read_window_header(stream, &sview_offset, &sview_len, &tview_len,
                              &inslen, &newlen, &header_len));
   len = inslen + newlen;
-  buf = apr_palloc(pool, len);
+
+  /* Allocate one extra byte for the NUL terminator that allows
+     decode_window() to reference the new data without copying it. */
+  buf = apr_palloc(pool, len + 1);
   SVN_ERR(svn_stream_read_full(stream, (char*)buf, &len));
   if (len < inslen + newlen)
     return svn_error_create(SVN_ERR_SVNDIFF_UNEXPECTED_END, NULL,
                             _("Unexpected end of svndiff input"));
+  buf[len] = '\0';
   *window = apr_palloc(pool, sizeof(**window));
   return decode_window(*window, sview_offset, sview_len, tview_len, inslen,
-                       newlen, buf, pool, svndiff_version);
+                       newlen, buf, pool, svndiff_version, TRUE);
 }
 
 
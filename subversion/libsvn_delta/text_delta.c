@@ -33,6 +33,8 @@
 #include "svn_pools.h"
 #include "svn_checksum.h"
 
+#include "private/svn_delta_private.h"
+
 #include "delta.h"
 
 
@@ -56,11 +58,18 @@ struct txdelta_baton {
   svn_boolean_t more;           /* TRUE if there are more data in the pool. */
   svn_filesize_t pos;           /* Offset of next read in source file. */
   char *buf;                    /* Buffer for input data. */
+  apr_size_t window_size;       /* Max view size of produced windows. */
 
   svn_checksum_ctx_t *context;  /* If not NULL, the context for computing
                                    the checksum. */
   svn_checksum_t *checksum;     /* If non-NULL, the checksum of TARGET. */
 
+  svn_txdelta__ops_baton_t build_scratch;
+                                /* Reusable op / new-data buffers for
+                                   window construction.  Grown on demand
+                                   in RESULT_POOL; allocation-free once
+                                   they reach their high-water mark. */
+
   apr_pool_t *result_pool;      /* For results (e.g. checksum) */
 };
 
@@ -80,6 +89,9 @@ struct tpush_baton {
   apr_size_t source_len;
   svn_boolean_t source_done;
   apr_size_t target_len;
+  svn_txdelta__ops_baton_t build_scratch;
+                                /* Reusable window construction buffers,
+                                   grown on demand in POOL. */
 };
 
 
@@ -102,10 +114,21 @@ struct apply_baton {
   char *tbuf;                   /* Target buffer */
   apr_size_t tbuf_size;         /* Allocated target buffer space */
 
-  svn_checksum_ctx_t *md5_context; /* Leads to result_digest below. */
+  svn_checksum_ctx_t *md5_context; /* Leads to RESULT_DIGEST and RESULT_MD5
+                                      below, or NULL if neither was
+                                      requested. */
+  svn_checksum_ctx_t *sha1_context; /* Leads to RESULT_SHA1 below, or NULL
+                                       if it was not requested. */
   unsigned char *result_digest; /* MD5 digest of resultant fulltext;
                                    must point to at least APR_MD5_DIGESTSIZE
                                    bytes of storage. */
+  svn_checksum_t **result_md5;  /* If non-NULL, receives the MD5 checksum
+                                   of the resultant fulltext, allocated in
+                                   RESULT_POOL. */
+  svn_checksum_t **result_sha1; /* Likewise for the SHA-1 checksum. */
+  apr_pool_t *result_pool;      /* Pool to allocate the result checksums
+                                   in; unlike POOL it survives the final
+                                   window. */
 
   const char *error_info;       /* Optional extra info for error returns. */
 };
@@ -142,28 +165,52 @@ svn_txdelta__make_window(const svn_txdelta__ops_baton_t *build_baton,
 /* Compute and return a delta window using the xdelta algorithm on
    DATA, which contains SOURCE_LEN bytes of source data and TARGET_LEN
    bytes of target data.  SOURCE_OFFSET gives the offset of the source
-   data, and is simply copied into the window's sview_offset field. */
+   data, and is simply copied into the window's sview_offset field.
+
+   The ops and new-data are built up in SCRATCH, whose buffers persist
+   in BUILD_POOL from one window to the next, so that steady-state
+   window production does not have to grow fresh buffers by doubling
+   for every window.  The returned window is a tightly allocated copy
+   in RESULT_POOL and independent of SCRATCH. */
 static svn_txdelta_window_t *
 compute_window(const char *data, apr_size_t source_len, apr_size_t target_len,
-               svn_filesize_t source_offset, apr_pool_t *pool)
+               svn_filesize_t source_offset,
+               svn_txdelta__ops_baton_t *scratch,
+               apr_pool_t *build_pool, apr_pool_t *result_pool)
 {
-  svn_txdelta__ops_baton_t build_baton = { 0 };
   svn_txdelta_window_t *window;
+  svn_string_t *new_data;
 
-  /* Compute the delta operations. */
-  build_baton.new_data = svn_stringbuf_create_empty(pool);
+  /* Compute the delta operations, reusing the scratch buffers. */
+  scratch->num_ops = 0;
+  scratch->src_ops = 0;
+  if (scratch->new_data == NULL)
+    scratch->new_data = svn_stringbuf_create_empty(build_pool);
+  else
+    svn_stringbuf_setempty(scratch->new_data);
 
   if (source_len == 0)
-    svn_txdelta__insert_op(&build_baton, svn_txdelta_new, 0, target_len, data,
-                           pool);
+    svn_txdelta__insert_op(scratch, svn_txdelta_new, 0, target_len, data,
+                           build_pool);
   else
-    svn_txdelta__xdelta(&build_baton, data, source_len, target_len, pool);
+    svn_txdelta__xdelta(scratch, data, source_len, target_len,
+                        build_pool, result_pool);
 
-  /* Create and return the delta window. */
-  window = svn_txdelta__make_window(&build_baton, pool);
+  /* Create and return the delta window.  Exact-sized allocations; the
+     caller may hold on to the window until RESULT_POOL gets cleared. */
+  window = apr_palloc(result_pool, sizeof(*window));
   window->sview_offset = source_offset;
   window->sview_len = source_len;
   window->tview_len = target_len;
+  window->num_ops = scratch->num_ops;
+  window->src_ops = scratch->src_ops;
+  window->ops = apr_pmemdup(result_pool, scratch->ops,
+                            scratch->num_ops * sizeof(*scratch->ops));
+
+  new_data = svn_string_ncreate(scratch->new_data->data,
+                                scratch->new_data->len, result_pool);
+  window->new_data = new_data;
+
   return window;
 }
 
@@ -359,14 +406,14 @@ txdelta_next_window(svn_txdelta_window_t **window,
                     apr_pool_t *pool)
 {
   struct txdelta_baton *b = baton;
-  apr_size_t source_len = SVN_DELTA_WINDOW_SIZE;
-  apr_size_t target_len = SVN_DELTA_WINDOW_SIZE;
+  apr_size_t source_len = b->window_size;
+  apr_size_t target_len = b->window_size;
 
   /* Read the source stream. */
   if (b->more_source)
     {
       SVN_ERR(svn_stream_read_full(b->source, b->buf, &source_len));
-      b->more_source = (source_len == SVN_DELTA_WINDOW_SIZE);
+      b->more_source = (source_len == b->window_size);
     }
   else
     source_len = 0;
@@ -389,7 +436,8 @@ txdelta_next_window(svn_txdelta_window_t **window,
     SVN_ERR(svn_checksum_update(b->context, b->buf + source_len, target_len));
 
   *window = compute_window(b->buf, source_len, target_len,
-                           b->pos - source_len, pool);
+                           b->pos - source_len,
+                           &b->build_scratch, b->result_pool, pool);
 
   /* That's it. */
   return SVN_NO_ERROR;
@@ -435,6 +483,7 @@ svn_txdelta_run(svn_stream_t *source,
   tb.more_source = TRUE;
   tb.more = TRUE;
   tb.pos = 0;
+  tb.window_size = SVN_DELTA_WINDOW_SIZE;
   tb.buf = apr_palloc(scratch_pool, 2 * SVN_DELTA_WINDOW_SIZE);
   tb.result_pool = result_pool;
 
@@ -467,19 +516,28 @@ svn_txdelta_run(svn_stream_t *source,
 
 
 void
-svn_txdelta2(svn_txdelta_stream_t **stream,
-             svn_stream_t *source,
-             svn_stream_t *target,
-             svn_boolean_t calculate_checksum,
-             apr_pool_t *pool)
+svn_txdelta__create_stream(svn_txdelta_stream_t **stream,
+                           svn_stream_t *source,
+                           svn_stream_t *target,
+                           svn_boolean_t calculate_checksum,
+                           apr_size_t window_size,
+                           apr_pool_t *pool)
 {
   struct txdelta_baton *b = apr_pcalloc(pool, sizeof(*b));
 
+  /* Use the standard window size unless the caller asked for something
+     specific; never exceed what decoders are willing to accept. */
+  if (window_size == 0)
+    window_size = SVN_DELTA_WINDOW_SIZE;
+  else if (window_size > SVN_DELTA_WINDOW_SIZE_MAX)
+    window_size = SVN_DELTA_WINDOW_SIZE_MAX;
+
   b->source = source;
   b->target = target;
   b->more_source = TRUE;
   b->more = TRUE;
-  b->buf = apr_palloc(pool, 2 * SVN_DELTA_WINDOW_SIZE);
+  b->window_size = window_size;
+  b->buf = apr_palloc(pool, 2 * window_size);
   b->context = calculate_checksum
              ? svn_checksum_ctx_create(svn_checksum_md5, pool)
              : NULL;
@@ -489,6 +547,17 @@ svn_txdelta2(svn_txdelta_stream_t **stream,
                                       txdelta_md5_digest, pool);
 }
 
+void
+svn_txdelta2(svn_txdelta_stream_t **stream,
+             svn_stream_t *source,
+             svn_stream_t *target,
+             svn_boolean_t calculate_checksum,
+             apr_pool_t *pool)
+{
+  svn_txdelta__create_stream(stream, source, target, calculate_checksum,
+                             SVN_DELTA_WINDOW_SIZE, pool);
+}
+
 void
 svn_txdelta(svn_txdelta_stream_t **stream,
             svn_stream_t *source,
@@ -539,7 +608,8 @@ tpush_write_handler(void *baton, const char *data, apr_size_t *len)
       if (tb->target_len == SVN_DELTA_WINDOW_SIZE)
         {
           window = compute_window(tb->buf, tb->source_len, tb->target_len,
-                                  tb->source_offset, pool);
+                                  tb->source_offset,
+                                  &tb->build_scratch, tb->pool, pool);
           SVN_ERR(tb->wh(window, tb->whb));
           tb->source_offset += tb->source_len;
           tb->source_len = 0;
@@ -565,7 +635,8 @@ tpush_close_handler(void *baton)
   if (tb->target_len > 0)
     {
       window = compute_window(tb->buf, tb->source_len, tb->target_len,
-                              tb->source_offset, tb->pool);
+                              tb->source_offset,
+                              &tb->build_scratch, tb->pool, tb->pool);
       SVN_ERR(tb->wh(window, tb->whb));
     }
 
@@ -593,6 +664,7 @@ svn_txdelta_target_push(svn_txdelta_window_handler_t handler,
   tb->source_len = 0;
   tb->source_done = FALSE;
   tb->target_len = 0;
+  memset(&tb->build_scratch, 0, sizeof(tb->build_scratch));
 
   /* Create and return writable stream. */
   stream = svn_stream_create(tb, pool);
@@ -726,16 +798,27 @@ apply_window(svn_txdelta_window_t *window, void *baton)
       svn_error_t *err = SVN_NO_ERROR;
 
       /* We're done; just clean up.  */
-      if (ab->result_digest)
+      if (ab->md5_context)
         {
           svn_checksum_t *md5_checksum;
 
-          err = svn_checksum_final(&md5_checksum, ab->md5_context, ab->pool);
+          err = svn_checksum_final(&md5_checksum, ab->md5_context,
+                                   ab->result_md5 ? ab->result_pool
+                                                  : ab->pool);
           if (!err)
-            memcpy(ab->result_digest, md5_checksum->digest,
-                   svn_checksum_size(md5_checksum));
+            {
+              if (ab->result_digest)
+                memcpy(ab->result_digest, md5_checksum->digest,
+                       svn_checksum_size(md5_checksum));
+              if (ab->result_md5)
+                *ab->result_md5 = md5_checksum;
+            }
         }
 
+      if (!err && ab->sha1_context)
+        err = svn_checksum_final(ab->result_sha1, ab->sha1_context,
+                                 ab->result_pool);
+
       err = svn_error_compose_create(err, svn_stream_close(ab->source));
       err = svn_error_compose_create(err, svn_stream_close(ab->target));
       svn_pool_destroy(ab->pool);
@@ -749,6 +832,28 @@ apply_window(svn_txdelta_window_t *window, void *baton)
                      && (window->sview_offset + window->sview_len
                          >= ab->sbuf_offset + ab->sbuf_len)));
 
+  /* Fast path for the window shape produced for fresh files: no source
+     view and a single "new data" instruction covering the whole target
+     view.  The new data already is the target view, so write it out
+     directly instead of copying it through the target buffer.  For
+     large adds - checkouts, exports - this skips one full copy of the
+     file contents. */
+  if (window->sview_len == 0
+      && window->num_ops == 1
+      && window->ops[0].action_code == svn_txdelta_new
+      && window->ops[0].length == window->tview_len)
+    {
+      const char *new_data = window->new_data->data + window->ops[0].offset;
+
+      len = window->tview_len;
+      if (ab->md5_context)
+        SVN_ERR(svn_checksum_update(ab->md5_context, new_data, len));
+      if (ab->sha1_context)
+        SVN_ERR(svn_checksum_update(ab->sha1_context, new_data, len));
+
+      return svn_stream_write(ab->target, new_data, &len);
+    }
+
   /* Make sure there's enough room in the target buffer.  */
   SVN_ERR(size_buffer(&ab->tbuf, &ab->tbuf_size, window->tview_len, ab->pool));
 
@@ -796,22 +901,30 @@ apply_window(svn_txdelta_window_t *window, void *baton)
 
   /* Write out the output. */
 
-  /* Just update the context here. */
-  if (ab->result_digest)
+  /* Just update the contexts here. */
+  if (ab->md5_context)
     SVN_ERR(svn_checksum_update(ab->md5_context, ab->tbuf, len));
+  if (ab->sha1_context)
+    SVN_ERR(svn_checksum_update(ab->sha1_context, ab->tbuf, len));
 
   return svn_stream_write(ab->target, ab->tbuf, &len);
 }
 
 
-void
-svn_txdelta_apply2(svn_stream_t *source,
-                   svn_stream_t *target,
-                   unsigned char *result_digest,
-                   const char *error_info,
-                   apr_pool_t *pool,
-                   svn_txdelta_window_handler_t *handler,
-                   void **handler_baton)
+/* Common constructor for svn_txdelta_apply2() and svn_txdelta_apply3().
+   The MD5 of the resulting fulltext is written into RESULT_DIGEST as a
+   raw digest and / or reported through *RESULT_MD5, whichever is
+   non-NULL; its SHA-1 is reported through *RESULT_SHA1, if non-NULL. */
+static void
+apply_create(svn_stream_t *source,
+             svn_stream_t *target,
+             unsigned char *result_digest,
+             svn_checksum_t **result_md5,
+             svn_checksum_t **result_sha1,
+             const char *error_info,
+             apr_pool_t *pool,
+             svn_txdelta_window_handler_t *handler,
+             void **handler_baton)
 {
   apr_pool_t *subpool = svn_pool_create(pool);
   struct apply_baton *ab;
@@ -827,9 +940,19 @@ svn_txdelta_apply2(svn_stream_t *source,
   ab->tbuf = NULL;
   ab->tbuf_size = 0;
   ab->result_digest = result_digest;
+  ab->result_md5 = result_md5;
+  ab->result_sha1 = result_sha1;
+  ab->result_pool = pool;
 
-  if (result_digest)
+  if (result_digest || result_md5)
     ab->md5_context = svn_checksum_ctx_create(svn_checksum_md5, subpool);
+  else
+    ab->md5_context = NULL;
+
+  if (result_sha1)
+    ab->sha1_context = svn_checksum_ctx_create(svn_checksum_sha1, subpool);
+  else
+    ab->sha1_context = NULL;
 
   if (error_info)
     ab->error_info = apr_pstrdup(subpool, error_info);
@@ -840,6 +963,33 @@ svn_txdelta_apply2(svn_stream_t *source,
   *handler_baton = ab;
 }
 
+void
+svn_txdelta_apply3(svn_stream_t *source,
+                   svn_stream_t *target,
+                   svn_checksum_t **result_md5,
+                   svn_checksum_t **result_sha1,
+                   const char *error_info,
+                   apr_pool_t *pool,
+                   svn_txdelta_window_handler_t *handler,
+                   void **handler_baton)
+{
+  apply_create(source, target, NULL, result_md5, result_sha1,
+               error_info, pool, handler, handler_baton);
+}
+
+void
+svn_txdelta_apply2(svn_stream_t *source,
+                   svn_stream_t *target,
+                   unsigned char *result_digest,
+                   const char *error_info,
+                   apr_pool_t *pool,
+                   svn_txdelta_window_handler_t *handler,
+                   void **handler_baton)
+{
+  apply_create(source, target, result_digest, NULL, NULL,
+               error_info, pool, handler, handler_baton);
+}
+
 void
 svn_txdelta_apply(svn_stream_t *source,
                   svn_stream_t *target,
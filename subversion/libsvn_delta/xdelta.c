@@ -373,7 +373,8 @@ compute_delta(svn_txdelta__ops_baton_t *build_baton,
               apr_size_t asize,
               const char *b,
               apr_size_t bsize,
-              apr_pool_t *pool)
+              apr_pool_t *build_pool,
+              apr_pool_t *scratch_pool)
 {
   struct blocks blocks;
   apr_uint32_t rolling;
@@ -386,7 +387,7 @@ compute_delta(svn_txdelta__ops_baton_t *build_baton,
   if ((lo > 4) || (lo == bsize))
     {
       svn_txdelta__insert_op(build_baton, svn_txdelta_source,
-                             0, lo, NULL, pool);
+                             0, lo, NULL, build_pool);
       pending_insert_start = lo;
     }
   else
@@ -396,14 +397,14 @@ compute_delta(svn_txdelta__ops_baton_t *build_baton,
      insert the entire target.  */
   if ((bsize - lo < MATCH_BLOCKSIZE) || (asize < MATCH_BLOCKSIZE))
     {
-      store_delta_trailer(build_baton, a, asize, b, bsize, lo, pool);
+      store_delta_trailer(build_baton, a, asize, b, bsize, lo, build_pool);
       return;
     }
 
   upper = bsize - MATCH_BLOCKSIZE; /* this is now known to be >= LO */
 
   /* Initialize the matches table.  */
-  init_blocks_table(a, asize, &blocks, pool);
+  init_blocks_table(a, asize, &blocks, scratch_pool);
 
   /* Initialize our rolling checksum.  */
   rolling = init_adler32(b + lo);
@@ -444,7 +445,7 @@ compute_delta(svn_txdelta__ops_baton_t *build_baton,
           if (lo - pending_insert_start > 0)
             svn_txdelta__insert_op(build_baton, svn_txdelta_new,
                                    0, lo - pending_insert_start,
-                                   b + pending_insert_start, pool);
+                                   b + pending_insert_start, build_pool);
           else
             {
               /* the match borders on the previous op. Maybe, we found a
@@ -465,7 +466,7 @@ compute_delta(svn_txdelta__ops_baton_t *build_baton,
           lo += matchlen;
           pending_insert_start = lo;
           svn_txdelta__insert_op(build_baton, svn_txdelta_source,
-                                 apos, matchlen, NULL, pool);
+                                 apos, matchlen, NULL, build_pool);
 
           /* Calculate the Adler32 sum for the first block behind the match.
            * Ignore short buffers at the end of B.
@@ -476,7 +477,8 @@ compute_delta(svn_txdelta__ops_baton_t *build_baton,
     }
 
   /* If we still have an insert pending at the end, throw it in.  */
-  store_delta_trailer(build_baton, a, asize, b, bsize, pending_insert_start, pool);
+  store_delta_trailer(build_baton, a, asize, b, bsize, pending_insert_start,
+                      build_pool);
 }
 
 void
@@ -484,7 +486,8 @@ svn_txdelta__xdelta(svn_txdelta__ops_baton_t *build_baton,
                     const char *data,
                     apr_size_t source_len,
                     apr_size_t target_len,
-                    apr_pool_t *pool)
+                    apr_pool_t *build_pool,
+                    apr_pool_t *scratch_pool)
 {
   /*  We should never be asked to compute something when the source_len is 0;
       we just use a single insert op there (and rely on zlib for
@@ -492,5 +495,5 @@ svn_txdelta__xdelta(svn_txdelta__ops_baton_t *build_baton,
   assert(source_len != 0);
   compute_delta(build_baton, data, source_len,
                 data + source_len, target_len,
-                pool);
+                build_pool, scratch_pool);
 }
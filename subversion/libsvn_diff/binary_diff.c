@@ -94,18 +94,38 @@ static const char b85str[] =
     "abcdefghijklmnopqrstuvwxyz"
     "!#$%&()*+-;<=>?@^_`{|}~";
 
+/* Lookup table for base85 characters; b85_reverse[ch] gives a negative
+   value if ch is not a valid base85 character, or otherwise the value
+   of the character represented; '0' => 0 etc.  The inverse of b85str. */
+static const signed char b85_reverse[256] = {
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, 62, -1, 63, 64, 65, 66, -1, 67, 68, 69, 70, -1, 71, -1, -1,
+ 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, 72, 73, 74, 75, 76,
+77, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, 78, 79,
+80, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50,
+51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 81, 82, 83, 84, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
 /* Helper function for svn_diff__base85_decode_line */
 static svn_error_t *
 base85_value(int *value, char c)
 {
-  const char *p = strchr(b85str, c);
-  if (!p)
+  int val = b85_reverse[(unsigned char)c];
+  if (val < 0)
     return svn_error_create(SVN_ERR_DIFF_UNEXPECTED_DATA, NULL,
                             _("Invalid base85 value"));
 
-  /* It's safe to cast the ptrdiff_t value of the pointer difference
-     to int because the value will always be in the range [0..84]. */
-  *value = (int)(p - b85str);
+  *value = val;
   return SVN_NO_ERROR;
 }
 
@@ -180,8 +200,12 @@ write_literal(svn_filesize_t uncompressed_size,
   do
     {
       char chunk[GIT_BASE85_CHUNKSIZE];
+      /* Length byte, the base85 chars and the end-of-line marker. */
+      char line[1 + GIT_BASE85_CHUNKSIZE / 4 * 5 + sizeof(APR_EOL_STR)];
+      char *out = line;
       const unsigned char *next;
       apr_size_t left;
+      apr_size_t line_sz;
 
       rd = sizeof(chunk);
 
@@ -190,19 +214,14 @@ write_literal(svn_filesize_t uncompressed_size,
 
       SVN_ERR(svn_stream_read_full(compressed_data, chunk, &rd));
 
-      {
-        apr_size_t one = 1;
-        SVN_ERR(svn_stream_write(output_stream, &b85lenstr[rd-1], &one));
-      }
+      *out++ = b85lenstr[rd-1];
 
       left = rd;
       next = (void*)chunk;
       while (left)
       {
-        char five[5];
         unsigned info = 0;
         int n;
-        apr_size_t five_sz;
 
         /* Push 4 bytes into the 32 bit info, when available */
         for (n = 24; n >= 0 && left; n -= 8, next++, left--)
@@ -213,15 +232,19 @@ write_literal(svn_filesize_t uncompressed_size,
         /* Write out info as base85 */
         for (n = 4; n >= 0; n--)
         {
-            five[n] = b85str[info % 85];
+            out[n] = b85str[info % 85];
             info /= 85;
         }
-
-        five_sz = 5;
-        SVN_ERR(svn_stream_write(output_stream, five, &five_sz));
+        out += 5;
       }
 
-      SVN_ERR(svn_stream_puts(output_stream, APR_EOL_STR));
+      memcpy(out, APR_EOL_STR, sizeof(APR_EOL_STR) - 1);
+      out += sizeof(APR_EOL_STR) - 1;
+
+      /* A single write per line keeps the per-call overhead of the
+         output stream out of the inner loop. */
+      line_sz = out - line;
+      SVN_ERR(svn_stream_write(output_stream, line, &line_sz));
     }
   while (rd == GIT_BASE85_CHUNKSIZE);
 
@@ -114,6 +114,36 @@ svn_diff__lcs(svn_diff__position_t *position_list1, /* pointer to tail (ring) */
               apr_off_t suffix_lines,
               apr_pool_t *pool);
 
+/*
+ * Variant of svn_diff__lcs() that may divide the problem at a token that
+ * is unique in both sources and solve the two halves concurrently on
+ * separate threads.  The result is always a correct common subsequence
+ * but is not guaranteed to be of maximum length, i.e. the derived diff
+ * may occasionally be slightly larger than the one svn_diff__lcs()
+ * produces.  Falls back to svn_diff__lcs() for small inputs, if no
+ * suitable split point exists, or if this build has no thread support.
+ */
+svn_diff__lcs_t *
+svn_diff__lcs_parallel(svn_diff__position_t *position_list1,
+                       svn_diff__position_t *position_list2,
+                       svn_diff__token_index_t *token_counts_list1,
+                       svn_diff__token_index_t *token_counts_list2,
+                       svn_diff__token_index_t num_tokens,
+                       apr_off_t prefix_lines,
+                       apr_off_t suffix_lines,
+                       apr_pool_t *pool);
+
+/*
+ * Internal version of svn_diff_diff_2().  If PARALLEL_LCS is TRUE, compute
+ * the LCS via svn_diff__lcs_parallel() instead of svn_diff__lcs().
+ */
+svn_error_t *
+svn_diff__diff_2(svn_diff_t **diff,
+                 void *diff_baton,
+                 const svn_diff_fns2_t *vtable,
+                 svn_boolean_t parallel_lcs,
+                 apr_pool_t *pool);
+
 
 /*
  * Returns number of tokens in a tree
@@ -193,7 +223,13 @@ svn_diff__unified_append_no_newline_msg(svn_stringbuf_t *stringbuf,
                                         const char *header_encoding,
                                         apr_pool_t *scratch_pool);
 
-/* Write a unidiff hunk header to OUTPUT_STREAM.
+/* While generating unified diff output, accumulate roughly this many
+ * bytes of formatted hunks before pushing them to the output stream in
+ * a single write.
+ */
+#define SVN_DIFF__UNIFIED_OUTPUT_BUFFER_SIZE (1024 * 1024)
+
+/* Append a unidiff hunk header to TARGET.
  *
  * The header will use HUNK_DELIMITER (which should usually be "@@") before
  * and after the line-number ranges which are formed from OLD_START,
@@ -203,6 +239,20 @@ svn_diff__unified_append_no_newline_msg(svn_stringbuf_t *stringbuf,
  * The text will be encoded into HEADER_ENCODING.
  */
 svn_error_t *
+svn_diff__unified_append_hunk_header(svn_stringbuf_t *target,
+                                     const char *header_encoding,
+                                     const char *hunk_delimiter,
+                                     apr_off_t old_start,
+                                     apr_off_t old_length,
+                                     apr_off_t new_start,
+                                     apr_off_t new_length,
+                                     const char *hunk_extra_context,
+                                     apr_pool_t *scratch_pool);
+
+/* Like svn_diff__unified_append_hunk_header(), but write the header
+ * directly to OUTPUT_STREAM.
+ */
+svn_error_t *
 svn_diff__unified_write_hunk_header(svn_stream_t *output_stream,
                                     const char *header_encoding,
                                     const char *hunk_delimiter,
@@ -1326,7 +1326,8 @@ svn_diff_file_diff_2(svn_diff_t **diff,
   baton.files[1].path = modified;
   baton.pool = svn_pool_create(pool);
 
-  SVN_ERR(svn_diff_diff_2(diff, &baton, &svn_diff__file_vtable, pool));
+  SVN_ERR(svn_diff__diff_2(diff, &baton, &svn_diff__file_vtable,
+                           options->parallel_lcs, pool));
 
   svn_pool_destroy(baton.pool);
   return SVN_NO_ERROR;
@@ -1384,6 +1385,10 @@ svn_diff_file_diff4_2(svn_diff_t **diff,
 /* Maximum length of the extra context to show when show_c_function is set.
  * GNU diff uses 40, let's be brave and use 50 instead. */
 #define SVN_DIFF__EXTRA_CONTEXT_LENGTH 50
+/* Context around the changed ranges is read back from the files in
+ * chunks of this size. */
+#define OUTPUT_READ_BUFFER_SIZE (64 * 1024)
+
 typedef struct svn_diff__file_output_baton_t
 {
   svn_stream_t *output_stream;
@@ -1399,7 +1404,7 @@ typedef struct svn_diff__file_output_baton_t
 
   apr_off_t   current_line[2];
 
-  char        buffer[2][4096];
+  char       *buffer[2]; /* OUTPUT_READ_BUFFER_SIZE bytes each */
   apr_size_t  length[2];
   char       *curp[2];
 
@@ -1407,6 +1412,9 @@ typedef struct svn_diff__file_output_baton_t
   apr_off_t   hunk_length[2];
   svn_stringbuf_t *hunk;
 
+  /* Completed hunks, already formatted, awaiting one large write. */
+  svn_stringbuf_t *output_buffer;
+
   /* Should we emit C functions in the unified diff header */
   svn_boolean_t show_c_function;
   /* Extra strings to skip over if we match. */
@@ -1551,7 +1559,7 @@ output_unified_line(svn_diff__file_output_baton_t *baton,
         }
 
       curp = baton->buffer[idx];
-      length = sizeof(baton->buffer[idx]);
+      length = OUTPUT_READ_BUFFER_SIZE;
 
       err = svn_io_file_read(baton->file[idx], curp, &length, baton->pool);
 
@@ -1618,11 +1626,27 @@ output_unified_diff_range(svn_diff__file_output_baton_t *output_baton,
   return SVN_NO_ERROR;
 }
 
+/* Write the output accumulated in BATON->OUTPUT_BUFFER to the output
+   stream and empty the buffer for reuse. */
+static svn_error_t *
+output_unified_flush_buffer(svn_diff__file_output_baton_t *baton)
+{
+  apr_size_t len = baton->output_buffer->len;
+
+  if (len > 0)
+    {
+      SVN_ERR(svn_stream_write(baton->output_stream,
+                               baton->output_buffer->data, &len));
+      svn_stringbuf_setempty(baton->output_buffer);
+    }
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 output_unified_flush_hunk(svn_diff__file_output_baton_t *baton)
 {
   apr_off_t target_line;
-  apr_size_t hunk_len;
   apr_off_t old_start;
   apr_off_t new_start;
 
@@ -1651,18 +1675,21 @@ output_unified_flush_hunk(svn_diff__file_output_baton_t *baton)
   if (baton->hunk_length[1])
     new_start++;
 
-  /* Write the hunk header */
-  SVN_ERR(svn_diff__unified_write_hunk_header(
-            baton->output_stream, baton->header_encoding, "@@",
+  /* Append the hunk header and content to the output buffer.  The
+     buffer is flushed in large writes instead of one or more writes
+     per hunk; generating big diffs is syscall bound otherwise. */
+  SVN_ERR(svn_diff__unified_append_hunk_header(
+            baton->output_buffer, baton->header_encoding, "@@",
             old_start, baton->hunk_length[0],
             new_start, baton->hunk_length[1],
             baton->hunk_extra_context,
             baton->pool));
 
-  /* Output the hunk content */
-  hunk_len = baton->hunk->len;
-  SVN_ERR(svn_stream_write(baton->output_stream, baton->hunk->data,
-                           &hunk_len));
+  svn_stringbuf_appendbytes(baton->output_buffer, baton->hunk->data,
+                            baton->hunk->len);
+
+  if (baton->output_buffer->len >= SVN_DIFF__UNIFIED_OUTPUT_BUFFER_SIZE)
+    SVN_ERR(output_unified_flush_buffer(baton));
 
   /* Prepare for the next hunk */
   baton->hunk_length[0] = 0;
@@ -1874,6 +1901,7 @@ svn_diff_file_output_unified4(svn_stream_t *output_stream,
       baton.path[0] = original_path;
       baton.path[1] = modified_path;
       baton.hunk = svn_stringbuf_create_empty(pool);
+      baton.output_buffer = svn_stringbuf_create_empty(pool);
       baton.show_c_function = show_c_function;
       baton.extra_context = svn_stringbuf_create_empty(pool);
       baton.context_size = (context_size >= 0) ? context_size
@@ -1936,6 +1964,7 @@ svn_diff_file_output_unified4(svn_stream_t *output_stream,
 
       for (i = 0; i < 2; i++)
         {
+          baton.buffer[i] = apr_palloc(pool, OUTPUT_READ_BUFFER_SIZE);
           SVN_ERR(svn_io_file_open(&baton.file[i], baton.path[i],
                                    APR_READ, APR_OS_DEFAULT, pool));
         }
@@ -1960,6 +1989,7 @@ svn_diff_file_output_unified4(svn_stream_t *output_stream,
                                &svn_diff__file_output_unified_vtable,
                                cancel_func, cancel_baton));
       SVN_ERR(output_unified_flush_hunk(&baton));
+      SVN_ERR(output_unified_flush_buffer(&baton));
 
       for (i = 0; i < 2; i++)
         {
@@ -366,6 +366,9 @@ typedef struct unified_output_baton_t
   apr_off_t hunk_length[2]; /* 0 == original; 1 == modified */
   apr_off_t hunk_start[2];  /* 0 == original; 1 == modified */
 
+  /* Completed hunks, already formatted, awaiting one large write. */
+  svn_stringbuf_t *output_buffer;
+
   /* The delimiters of the hunk header, '@@' for text hunks and '##' for
    * property hunks. */
   const char *hunk_delimiter;
@@ -443,8 +446,25 @@ output_unified_token_range(output_baton_t *btn,
   return SVN_NO_ERROR;
 }
 
+/* Write the output accumulated in BATON->OUTPUT_BUFFER to the BATON's
+   output_stream and empty the buffer for reuse. */
+static svn_error_t *
+output_unified_flush_buffer(output_baton_t *baton)
+{
+  apr_size_t len = baton->output_buffer->len;
+
+  if (len > 0)
+    {
+      SVN_ERR(svn_stream_write(baton->output_stream,
+                               baton->output_buffer->data, &len));
+      svn_stringbuf_setempty(baton->output_buffer);
+    }
+
+  return SVN_NO_ERROR;
+}
+
 /* Flush the hunk currently built up in BATON
-   into the BATON's output_stream.
+   into the BATON's output buffer.
    Use the specified HUNK_DELIMITER.
    If HUNK_DELIMITER is NULL, fall back to the default delimiter. */
 static svn_error_t *
@@ -452,7 +472,6 @@ output_unified_flush_hunk(output_baton_t *baton,
                           const char *hunk_delimiter)
 {
   apr_off_t target_token;
-  apr_size_t hunk_len;
   apr_off_t old_start;
   apr_off_t new_start;
 
@@ -480,17 +499,21 @@ output_unified_flush_hunk(output_baton_t *baton,
   if (baton->hunk_length[1])
     new_start++;
 
-  /* Write the hunk header */
-  SVN_ERR(svn_diff__unified_write_hunk_header(
-            baton->output_stream, baton->header_encoding, hunk_delimiter,
+  /* Append the hunk header and content to the output buffer.  The
+     buffer is flushed in large writes instead of one or more writes
+     per hunk. */
+  SVN_ERR(svn_diff__unified_append_hunk_header(
+            baton->output_buffer, baton->header_encoding, hunk_delimiter,
             old_start, baton->hunk_length[0],
             new_start, baton->hunk_length[1],
             NULL /* hunk_extra_context */,
             baton->pool));
 
-  hunk_len = baton->hunk->len;
-  SVN_ERR(svn_stream_write(baton->output_stream,
-                           baton->hunk->data, &hunk_len));
+  svn_stringbuf_appendbytes(baton->output_buffer,
+                            baton->hunk->data, baton->hunk->len);
+
+  if (baton->output_buffer->len >= SVN_DIFF__UNIFIED_OUTPUT_BUFFER_SIZE)
+    SVN_ERR(output_unified_flush_buffer(baton));
 
   /* Prepare for the next hunk */
   baton->hunk_length[0] = 0;
@@ -634,6 +657,7 @@ svn_diff_mem_string_output_unified3(svn_stream_t *output_stream,
       baton.pool = svn_pool_create(scratch_pool);
       baton.header_encoding = header_encoding;
       baton.hunk = svn_stringbuf_create_empty(scratch_pool);
+      baton.output_buffer = svn_stringbuf_create_empty(scratch_pool);
       baton.hunk_delimiter = hunk_delimiter;
       baton.no_newline_string
         = (hunk_delimiter == NULL || strcmp(hunk_delimiter, "##") != 0)
@@ -667,6 +691,7 @@ svn_diff_mem_string_output_unified3(svn_stream_t *output_stream,
                               cancel_func, cancel_baton));
 
       SVN_ERR(output_unified_flush_hunk(&baton, hunk_delimiter));
+      SVN_ERR(output_unified_flush_buffer(&baton));
 
       svn_pool_destroy(baton.pool);
     }
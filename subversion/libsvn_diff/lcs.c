@@ -25,6 +25,11 @@
 #include <apr.h>
 #include <apr_pools.h>
 #include <apr_general.h>
+#if APR_HAS_THREADS
+#include <apr_thread_proc.h>
+#endif
+
+#include "svn_pools.h"
 
 #include "diff.h"
 
@@ -373,3 +378,279 @@ svn_diff__lcs(svn_diff__position_t *position_list1, /* pointer to tail (ring) */
   else
     return lcs;
 }
+
+
+#if APR_HAS_THREADS
+
+/* Minimum number of tokens per source before svn_diff__lcs_parallel()
+ * considers splitting the computation; below this, the thread and copy
+ * overhead dominates any possible gain.
+ */
+#define SVN_DIFF__PARALLEL_MIN_TOKENS 0x10000
+
+/* All inputs and the output of one half of a split LCS computation,
+ * plus the pool that the half may allocate from.
+ */
+typedef struct lcs_half_baton_t
+{
+  svn_diff__position_t *position_list1;
+  svn_diff__position_t *position_list2;
+  svn_diff__token_index_t *token_counts1;
+  svn_diff__token_index_t *token_counts2;
+  svn_diff__token_index_t num_tokens;
+  apr_off_t prefix_lines;
+  apr_off_t suffix_lines;
+  svn_diff__lcs_t *lcs;
+  apr_pool_t *pool;
+} lcs_half_baton_t;
+
+/* Thread function: solve the half described by DATA (an lcs_half_baton_t).
+ */
+static void * APR_THREAD_FUNC
+lcs_half_thread(apr_thread_t *thread, void *data)
+{
+  lcs_half_baton_t *b = data;
+
+  b->lcs = svn_diff__lcs(b->position_list1, b->position_list2,
+                         b->token_counts1, b->token_counts2,
+                         b->num_tokens, b->prefix_lines, b->suffix_lines,
+                         b->pool);
+
+  apr_thread_exit(thread, APR_SUCCESS);
+  return NULL;
+}
+
+/* Count the tokens of the position ring ending at POSITION_LIST into
+ * TOKEN_COUNTS, an array of NUM_TOKENS zero-initialized entries.
+ */
+static void
+count_ring_tokens(svn_diff__token_index_t *token_counts,
+                  svn_diff__position_t *position_list)
+{
+  svn_diff__position_t *position = position_list->next;
+
+  do
+    {
+      token_counts[position->token_index]++;
+      position = position->next;
+    }
+  while (position != position_list->next);
+}
+
+/* Return a copy of the LCS chain LCS, allocated in POOL.  Only the
+ * offsets of the referenced positions are preserved; that is all the
+ * consumers of a complete lcs chain look at.  Used to move the result
+ * of a worker thread out of its thread-private pool.
+ */
+static svn_diff__lcs_t *
+copy_lcs_chain(const svn_diff__lcs_t *lcs, apr_pool_t *pool)
+{
+  svn_diff__lcs_t *head = NULL;
+  svn_diff__lcs_t **tail = &head;
+
+  while (lcs)
+    {
+      svn_diff__lcs_t *copy = apr_palloc(pool, sizeof(*copy));
+
+      copy->position[0] = apr_pcalloc(pool, sizeof(*copy->position[0]));
+      copy->position[0]->offset = lcs->position[0]->offset;
+      copy->position[1] = apr_pcalloc(pool, sizeof(*copy->position[1]));
+      copy->position[1]->offset = lcs->position[1]->offset;
+      copy->length = lcs->length;
+      copy->refcount = 1;
+      copy->next = NULL;
+
+      *tail = copy;
+      tail = &copy->next;
+      lcs = lcs->next;
+    }
+
+  return head;
+}
+
+#endif /* APR_HAS_THREADS */
+
+
+svn_diff__lcs_t *
+svn_diff__lcs_parallel(svn_diff__position_t *position_list1,
+                       svn_diff__position_t *position_list2,
+                       svn_diff__token_index_t *token_counts_list1,
+                       svn_diff__token_index_t *token_counts_list2,
+                       svn_diff__token_index_t num_tokens,
+                       apr_off_t prefix_lines,
+                       apr_off_t suffix_lines,
+                       apr_pool_t *pool)
+{
+#if APR_HAS_THREADS
+  svn_diff__position_t *head1, *anchor1, *anchor2, *rest1, *rest2;
+  svn_diff__position_t *position;
+  apr_off_t mid_offset, best_distance;
+  apr_off_t length[2];
+  svn_diff__token_index_t *half_counts[4];
+  lcs_half_baton_t baton;
+  apr_thread_t *thread;
+  apr_status_t status, thread_status;
+  apr_pool_t *half_pool, *thread_pool;
+  svn_diff__lcs_t *lcs1, *lcs2;
+  svn_diff__lcs_t **link;
+  int i;
+
+  if (position_list1 == NULL || position_list2 == NULL)
+    return svn_diff__lcs(position_list1, position_list2,
+                         token_counts_list1, token_counts_list2,
+                         num_tokens, prefix_lines, suffix_lines, pool);
+
+  head1 = position_list1->next;
+  length[0] = position_list1->offset - head1->offset + 1;
+  length[1] = position_list2->offset - position_list2->next->offset + 1;
+  if (length[0] < SVN_DIFF__PARALLEL_MIN_TOKENS
+      || length[1] < SVN_DIFF__PARALLEL_MIN_TOKENS)
+    return svn_diff__lcs(position_list1, position_list2,
+                         token_counts_list1, token_counts_list2,
+                         num_tokens, prefix_lines, suffix_lines, pool);
+
+  /* Select the split point: a token that occurs exactly once in either
+   * source - i.e. a pair of positions that any reasonable alignment will
+   * match up - as close as possible to the middle of the first source.
+   * The tail itself is not eligible; the second half must not be empty.
+   */
+  mid_offset = head1->offset + length[0] / 2;
+  anchor1 = NULL;
+  best_distance = 0;
+  for (position = head1;
+       position != position_list1;
+       position = position->next)
+    {
+      apr_off_t distance = position->offset > mid_offset
+                         ? position->offset - mid_offset
+                         : mid_offset - position->offset;
+
+      if (token_counts_list1[position->token_index] == 1
+          && token_counts_list2[position->token_index] == 1
+          && (anchor1 == NULL || distance < best_distance))
+        {
+          anchor1 = position;
+          best_distance = distance;
+        }
+
+      /* Anchors can only get worse from here on. */
+      if (anchor1 && position->offset > mid_offset)
+        break;
+    }
+
+  if (anchor1 == NULL)
+    return svn_diff__lcs(position_list1, position_list2,
+                         token_counts_list1, token_counts_list2,
+                         num_tokens, prefix_lines, suffix_lines, pool);
+
+  /* Find the counterpart position in the second source.  The token is
+   * unique over there as well, so there is exactly one.
+   */
+  anchor2 = position_list2->next;
+  while (anchor2->token_index != anchor1->token_index)
+    anchor2 = anchor2->next;
+
+  if (anchor2 == position_list2)
+    return svn_diff__lcs(position_list1, position_list2,
+                         token_counts_list1, token_counts_list2,
+                         num_tokens, prefix_lines, suffix_lines, pool);
+
+  /* Split each position ring in two: the first halves end at the anchor
+   * positions, the second halves at the original tails.
+   */
+  rest1 = anchor1->next;
+  anchor1->next = head1;
+  position_list1->next = rest1;
+
+  rest2 = anchor2->next;
+  anchor2->next = position_list2->next;
+  position_list2->next = rest2;
+
+  /* Per-half token counts; the second halves are simple differences. */
+  for (i = 0; i < 4; i++)
+    half_counts[i] = apr_pcalloc(pool,
+                                 num_tokens * sizeof(*half_counts[i]));
+  count_ring_tokens(half_counts[0], anchor1);
+  count_ring_tokens(half_counts[1], anchor2);
+  for (i = 0; i < num_tokens; i++)
+    {
+      half_counts[2][i] = token_counts_list1[i] - half_counts[0][i];
+      half_counts[3][i] = token_counts_list2[i] - half_counts[1][i];
+    }
+
+  /* Solve the first half on a worker thread.  It gets a root pool of its
+   * own because APR pools must not be used concurrently; the result gets
+   * copied into POOL after the join.
+   */
+  half_pool = svn_pool_create(NULL);
+
+  baton.position_list1 = anchor1;
+  baton.position_list2 = anchor2;
+  baton.token_counts1 = half_counts[0];
+  baton.token_counts2 = half_counts[1];
+  baton.num_tokens = num_tokens;
+  baton.prefix_lines = prefix_lines;
+  baton.suffix_lines = 0;
+  baton.lcs = NULL;
+  baton.pool = half_pool;
+
+  /* The worker ends through apr_thread_exit(), which destroys the
+   * thread's own pool from the worker thread while this thread keeps
+   * allocating from POOL; the thread must therefore be created from a
+   * pool with a serialized allocator.
+   */
+  thread_pool = apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+
+  status = apr_thread_create(&thread, NULL, lcs_half_thread, &baton,
+                             thread_pool);
+  if (status)
+    {
+      /* No thread, no split.  Restore the rings and run sequentially. */
+      svn_diff__position_t *head2 = anchor2->next;
+
+      svn_pool_destroy(thread_pool);
+      svn_pool_destroy(half_pool);
+      anchor1->next = rest1;
+      position_list1->next = head1;
+      anchor2->next = rest2;
+      position_list2->next = head2;
+
+      return svn_diff__lcs(position_list1, position_list2,
+                           token_counts_list1, token_counts_list2,
+                           num_tokens, prefix_lines, suffix_lines, pool);
+    }
+
+  /* Solve the second half on this thread, straight into POOL. */
+  lcs2 = svn_diff__lcs(position_list1, position_list2,
+                       half_counts[2], half_counts[3], num_tokens,
+                       0, suffix_lines, pool);
+
+  apr_thread_join(&thread_status, thread);
+  lcs1 = copy_lcs_chain(baton.lcs, pool);
+  svn_pool_destroy(thread_pool);
+  svn_pool_destroy(half_pool);
+
+  /* Rejoin the rings. */
+  anchor1->next = rest1;
+  position_list1->next = head1;
+  {
+    svn_diff__position_t *head2 = anchor2->next;
+    anchor2->next = rest2;
+    position_list2->next = head2;
+  }
+
+  /* Splice the chains, dropping the zero-length EOF link that terminates
+   * the first half; the second half ends with the real EOF link.
+   */
+  link = &lcs1;
+  while ((*link)->next)
+    link = &(*link)->next;
+  *link = lcs2;
+
+  return lcs1;
+#else
+  return svn_diff__lcs(position_list1, position_list2,
+                       token_counts_list1, token_counts_list2,
+                       num_tokens, prefix_lines, suffix_lines, pool);
+#endif
+}
@@ -34,17 +34,15 @@
 
 
 /*
- * Prime number to use as the size of the hash table.  This number was
- * not selected by testing of any kind and may need tweaking.
+ * Initial number of slots in the token hash table.  Must be a power of
+ * two.  The table is grown before it becomes 2/3 full, so lookups stay
+ * O(1) even for inputs with millions of distinct tokens; a fixed-size
+ * table degrades into long per-slot searches on such inputs.
  */
-#define SVN_DIFF__HASH_SIZE 127
+#define SVN_DIFF__HASH_SIZE 1024
 
 struct svn_diff__node_t
 {
-  svn_diff__node_t       *parent;
-  svn_diff__node_t       *left;
-  svn_diff__node_t       *right;
-
   apr_uint32_t            hash;
   svn_diff__token_index_t index;
   void                   *token;
@@ -52,7 +50,12 @@ struct svn_diff__node_t
 
 struct svn_diff__tree_t
 {
-  svn_diff__node_t       *root[SVN_DIFF__HASH_SIZE];
+  /* Open-addressing hash table of all nodes, SLOT_COUNT entries.
+   * Empty slots are NULL; collisions are resolved by linear probing.
+   * The nodes themselves are allocated out of POOL.  */
+  svn_diff__node_t      **slots;
+  apr_size_t              slot_count;
+
   apr_pool_t             *pool;
   svn_diff__token_index_t node_count;
 };
@@ -75,11 +78,45 @@ void
 svn_diff__tree_create(svn_diff__tree_t **tree, apr_pool_t *pool)
 {
   *tree = apr_pcalloc(pool, sizeof(**tree));
+  (*tree)->slots = apr_pcalloc(pool, SVN_DIFF__HASH_SIZE
+                                     * sizeof(*(*tree)->slots));
+  (*tree)->slot_count = SVN_DIFF__HASH_SIZE;
   (*tree)->pool = pool;
   (*tree)->node_count = 0;
 }
 
 
+/* Double the size of TREE's slot array and redistribute the existing
+ * nodes.  All tokens in the table are known to be distinct, so they can
+ * be re-inserted purely by probing, without any token comparisons.
+ */
+static void
+tree_grow(svn_diff__tree_t *tree)
+{
+  apr_size_t new_count = tree->slot_count * 2;
+  svn_diff__node_t **new_slots = apr_pcalloc(tree->pool,
+                                             new_count * sizeof(*new_slots));
+  apr_size_t i;
+
+  for (i = 0; i < tree->slot_count; i++)
+    {
+      svn_diff__node_t *node = tree->slots[i];
+      apr_size_t probe;
+
+      if (node == NULL)
+        continue;
+
+      probe = node->hash & (new_count - 1);
+      while (new_slots[probe] != NULL)
+        probe = (probe + 1) & (new_count - 1);
+
+      new_slots[probe] = node;
+    }
+
+  tree->slots = new_slots;
+  tree->slot_count = new_count;
+}
+
 static svn_error_t *
 tree_insert_token(svn_diff__node_t **node, svn_diff__tree_t *tree,
                   void *diff_baton,
@@ -87,56 +124,47 @@ tree_insert_token(svn_diff__node_t **node, svn_diff__tree_t *tree,
                   apr_uint32_t hash, void *token)
 {
   svn_diff__node_t *new_node;
-  svn_diff__node_t **node_ref;
-  svn_diff__node_t *parent;
+  svn_diff__node_t *scan;
+  apr_size_t probe;
   int rv;
 
   SVN_ERR_ASSERT(token);
 
-  parent = NULL;
-  node_ref = &tree->root[hash % SVN_DIFF__HASH_SIZE];
+  /* Keep the load factor below 2/3 so probe sequences stay short. */
+  if ((apr_size_t)tree->node_count * 3 >= tree->slot_count * 2)
+    tree_grow(tree);
 
-  while (*node_ref != NULL)
+  probe = hash & (tree->slot_count - 1);
+  while ((scan = tree->slots[probe]) != NULL)
     {
-      parent = *node_ref;
-
-      rv = hash - parent->hash;
-      if (!rv)
-        SVN_ERR(vtable->token_compare(diff_baton, parent->token, token, &rv));
-
-      if (rv == 0)
+      if (scan->hash == hash)
         {
-          /* Discard the previous token.  This helps in cases where
-           * only recently read tokens are still in memory.
-           */
-          if (vtable->token_discard != NULL)
-            vtable->token_discard(diff_baton, parent->token);
-
-          parent->token = token;
-          *node = parent;
-
-          return SVN_NO_ERROR;
-        }
-      else if (rv > 0)
-        {
-          node_ref = &parent->left;
-        }
-      else
-        {
-          node_ref = &parent->right;
+          SVN_ERR(vtable->token_compare(diff_baton, scan->token, token, &rv));
+          if (rv == 0)
+            {
+              /* Discard the previous token.  This helps in cases where
+               * only recently read tokens are still in memory.
+               */
+              if (vtable->token_discard != NULL)
+                vtable->token_discard(diff_baton, scan->token);
+
+              scan->token = token;
+              *node = scan;
+
+              return SVN_NO_ERROR;
+            }
         }
+
+      probe = (probe + 1) & (tree->slot_count - 1);
     }
 
   /* Create a new node */
   new_node = apr_palloc(tree->pool, sizeof(*new_node));
-  new_node->parent = parent;
-  new_node->left = NULL;
-  new_node->right = NULL;
   new_node->hash = hash;
   new_node->token = token;
   new_node->index = tree->node_count++;
 
-  *node = *node_ref = new_node;
+  *node = tree->slots[probe] = new_node;
 
   return SVN_NO_ERROR;
 }
@@ -24,6 +24,7 @@
 
 #include <apr.h>
 #include <apr_general.h>
+#include <apr_strings.h>
 
 #include "svn_hash.h"
 #include "svn_pools.h"
@@ -365,50 +366,82 @@ svn_diff__unified_append_no_newline_msg(svn_stringbuf_t *stringbuf,
 }
 
 svn_error_t *
-svn_diff__unified_write_hunk_header(svn_stream_t *output_stream,
-                                    const char *header_encoding,
-                                    const char *hunk_delimiter,
-                                    apr_off_t old_start,
-                                    apr_off_t old_length,
-                                    apr_off_t new_start,
-                                    apr_off_t new_length,
-                                    const char *hunk_extra_context,
-                                    apr_pool_t *scratch_pool)
+svn_diff__unified_append_hunk_header(svn_stringbuf_t *target,
+                                     const char *header_encoding,
+                                     const char *hunk_delimiter,
+                                     apr_off_t old_start,
+                                     apr_off_t old_length,
+                                     apr_off_t new_start,
+                                     apr_off_t new_length,
+                                     const char *hunk_extra_context,
+                                     apr_pool_t *scratch_pool)
 {
-  SVN_ERR(svn_stream_printf_from_utf8(output_stream, header_encoding,
-                                      scratch_pool,
-                                      "%s -%" APR_OFF_T_FMT,
-                                      hunk_delimiter, old_start));
+  svn_stringbuf_t *header = svn_stringbuf_create_empty(scratch_pool);
+  const char *out_str;
+
+  svn_stringbuf_appendcstr(header,
+                           apr_psprintf(scratch_pool, "%s -%" APR_OFF_T_FMT,
+                                        hunk_delimiter, old_start));
   /* If the hunk length is 1, suppress the number of lines in the hunk
    * (it is 1 implicitly) */
   if (old_length != 1)
     {
-      SVN_ERR(svn_stream_printf_from_utf8(output_stream, header_encoding,
-                                          scratch_pool,
-                                          ",%" APR_OFF_T_FMT, old_length));
+      svn_stringbuf_appendcstr(header,
+                               apr_psprintf(scratch_pool,
+                                            ",%" APR_OFF_T_FMT, old_length));
     }
 
-  SVN_ERR(svn_stream_printf_from_utf8(output_stream, header_encoding,
-                                      scratch_pool,
-                                      " +%" APR_OFF_T_FMT, new_start));
+  svn_stringbuf_appendcstr(header,
+                           apr_psprintf(scratch_pool, " +%" APR_OFF_T_FMT,
+                                        new_start));
   if (new_length != 1)
     {
-      SVN_ERR(svn_stream_printf_from_utf8(output_stream, header_encoding,
-                                          scratch_pool,
-                                          ",%" APR_OFF_T_FMT, new_length));
+      svn_stringbuf_appendcstr(header,
+                               apr_psprintf(scratch_pool,
+                                            ",%" APR_OFF_T_FMT, new_length));
     }
 
   if (hunk_extra_context == NULL)
       hunk_extra_context = "";
-  SVN_ERR(svn_stream_printf_from_utf8(output_stream, header_encoding,
-                                      scratch_pool,
-                                      " %s%s%s" APR_EOL_STR,
-                                      hunk_delimiter,
-                                      hunk_extra_context[0] ? " " : "",
-                                      hunk_extra_context));
+  svn_stringbuf_appendcstr(header,
+                           apr_psprintf(scratch_pool, " %s%s%s" APR_EOL_STR,
+                                        hunk_delimiter,
+                                        hunk_extra_context[0] ? " " : "",
+                                        hunk_extra_context));
+
+  SVN_ERR(svn_utf_cstring_from_utf8_ex2(&out_str, header->data,
+                                        header_encoding, scratch_pool));
+  svn_stringbuf_appendcstr(target, out_str);
+
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_diff__unified_write_hunk_header(svn_stream_t *output_stream,
+                                    const char *header_encoding,
+                                    const char *hunk_delimiter,
+                                    apr_off_t old_start,
+                                    apr_off_t old_length,
+                                    apr_off_t new_start,
+                                    apr_off_t new_length,
+                                    const char *hunk_extra_context,
+                                    apr_pool_t *scratch_pool)
+{
+  svn_stringbuf_t *header = svn_stringbuf_create_empty(scratch_pool);
+  apr_size_t len;
+
+  SVN_ERR(svn_diff__unified_append_hunk_header(header, header_encoding,
+                                               hunk_delimiter,
+                                               old_start, old_length,
+                                               new_start, new_length,
+                                               hunk_extra_context,
+                                               scratch_pool));
+
+  len = header->len;
+  return svn_error_trace(svn_stream_write(output_stream, header->data,
+                                          &len));
+}
+
 svn_error_t *
 svn_diff__unidiff_write_header(svn_stream_t *output_stream,
                                const char *header_encoding,
@@ -48,6 +48,7 @@
 #include "private/svn_fspath.h"
 #include "private/svn_utf_private.h"
 #include "private/svn_mutex.h"
+#include "private/svn_sorts_private.h"
 #include "private/svn_subr_private.h"
 
 #include "fs-loader.h"
@@ -1462,6 +1463,46 @@ svn_fs_dir_entries(apr_hash_t **entries_p, svn_fs_root_t *root,
                                                    pool));
 }
 
+/* Implements the comparison function for svn_sort__array() below:
+   order svn_fs_dirent_t * elements by their name. */
+static int
+compare_dirent_name(const void *a, const void *b)
+{
+  const svn_fs_dirent_t *lhs = *(const svn_fs_dirent_t *const *)a;
+  const svn_fs_dirent_t *rhs = *(const svn_fs_dirent_t *const *)b;
+
+  return strcmp(lhs->name, rhs->name);
+}
+
+svn_error_t *
+svn_fs__dir_entries_sorted(apr_array_header_t **entries_p,
+                           svn_fs_root_t *root,
+                           const char *path,
+                           apr_pool_t *pool)
+{
+  apr_hash_t *entries;
+  apr_array_header_t *sorted;
+  apr_hash_index_t *hi;
+
+  /* Backends that store directories in sorted order can hand out the
+     listing directly. */
+  if (root->vtable->dir_entries_sorted)
+    return svn_error_trace(root->vtable->dir_entries_sorted(entries_p, root,
+                                                            path, pool));
+
+  /* Otherwise, fetch the hash and sort its values. */
+  SVN_ERR(root->vtable->dir_entries(&entries, root, path, pool));
+
+  sorted = apr_array_make(pool, apr_hash_count(entries),
+                          sizeof(svn_fs_dirent_t *));
+  for (hi = apr_hash_first(pool, entries); hi; hi = apr_hash_next(hi))
+    APR_ARRAY_PUSH(sorted, svn_fs_dirent_t *) = apr_hash_this_val(hi);
+  svn_sort__array(sorted, compare_dirent_name);
+
+  *entries_p = sorted;
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_fs_dir_optimal_order(apr_array_header_t **ordered_p,
                          svn_fs_root_t *root,
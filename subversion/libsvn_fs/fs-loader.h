@@ -382,6 +382,14 @@ typedef struct root_vtable_t
                                     apr_hash_t *entries,
                                     apr_pool_t *result_pool,
                                     apr_pool_t *scratch_pool);
+  /* Optional.  Set *ENTRIES_P to an array of svn_fs_dirent_t *, sorted
+     by entry name, without materializing a hash first.  Backends that
+     keep directories sorted internally can implement this at no extra
+     cost; may be NULL, in which case the loader falls back to
+     DIR_ENTRIES plus an explicit sort.  */
+  svn_error_t *(*dir_entries_sorted)(apr_array_header_t **entries_p,
+                                     svn_fs_root_t *root, const char *path,
+                                     apr_pool_t *pool);
   svn_error_t *(*make_dir)(svn_fs_root_t *root, const char *path,
                            apr_pool_t *pool);
 
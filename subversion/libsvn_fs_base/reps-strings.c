@@ -33,6 +33,8 @@
 #include "bdb/reps-table.h"
 #include "bdb/strings-table.h"
 
+#include "private/svn_delta_private.h"
+
 #include "../libsvn_fs/fs-loader.h"
 #define SVN_WANT_BDB
 #include "svn_private_config.h"
@@ -170,6 +172,10 @@ struct compose_handler_baton
      TRAIL->pool. No allocations will be made from TRAIL->pool itself. */
   trail_t *trail;
 
+  /* Combiner context shared by all compositions of this operation,
+     or NULL. */
+  svn_txdelta__compose_ctx_t *combiner_ctx;
+
   /* TRUE when no more windows have to be read/combined. */
   svn_boolean_t done;
 
@@ -221,8 +227,9 @@ compose_handler(svn_txdelta_window_t *window, void *baton)
           apr_pool_t *composite_pool = svn_pool_create(cb->trail->pool);
           svn_txdelta_window_t *composite;
 
-          composite = svn_txdelta_compose_windows(window, cb->window,
-                                                  composite_pool);
+          composite = svn_txdelta__compose_windows(window, cb->window,
+                                                   cb->combiner_ctx,
+                                                   composite_pool);
           svn_pool_destroy(cb->window_pool);
           cb->window = composite;
           cb->window_pool = composite_pool;
@@ -334,6 +341,12 @@ rep_undeltify_range(svn_fs_t *fs,
 {
   apr_size_t len_read = 0;
 
+  /* Recycle the combiner's scratch structures across all window
+     compositions of this read; deep delta chains re-derive them for
+     every chunk otherwise. */
+  svn_txdelta__compose_ctx_t *combiner_ctx
+    = svn_txdelta__compose_ctx_create(pool);
+
   do
     {
       struct compose_handler_baton cb = { 0 };
@@ -342,6 +355,7 @@ rep_undeltify_range(svn_fs_t *fs,
       int cur_rep;
 
       cb.trail = trail;
+      cb.combiner_ctx = combiner_ctx;
       cb.done = FALSE;
       for (cur_rep = 0; !cb.done && cur_rep < deltas->nelts; ++cur_rep)
         {
@@ -5531,6 +5531,7 @@ static root_vtable_t root_vtable = {
   base_props_changed,
   base_dir_entries,
   base_dir_optimal_order,
+  NULL,
   base_make_dir,
   base_file_length,
   base_file_checksum,
@@ -24,6 +24,11 @@
 
 #include <assert.h>
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <apr_portable.h>
+#endif
+
 #include "svn_hash.h"
 #include "svn_ctype.h"
 #include "svn_sorts.h"
@@ -32,8 +37,10 @@
 #include "private/svn_sorts_private.h"
 #include "private/svn_subr_private.h"
 #include "private/svn_temp_serializer.h"
+#include "private/svn_trace.h"
 
 #include "fs_fs.h"
+#include "fulltext-cache.h"
 #include "id.h"
 #include "index.h"
 #include "low_level.h"
@@ -533,6 +540,53 @@ svn_fs_fs__get_node_revision(node_revision_t **noderev_p,
   return svn_error_trace(err);
 }
 
+svn_error_t *
+svn_fs_fs__get_node_ancestry(svn_fs_fs__noderev_ancestry_t **ancestry_p,
+                             svn_fs_t *fs,
+                             const svn_fs_id_t *id,
+                             apr_pool_t *result_pool,
+                             apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  node_revision_t *noderev;
+  svn_fs_fs__noderev_ancestry_t *ancestry;
+
+  /* Try to extract just the two fields we need from the packed cache
+   * entry.  This keeps long history walks from deserializing (and
+   * allocating) full noderev structures at every step. */
+  if (ffd->node_revision_cache && !svn_fs_fs__id_is_txn(id))
+    {
+      svn_boolean_t is_cached;
+      const svn_fs_fs__id_part_t *rev_item = svn_fs_fs__id_rev_item(id);
+      pair_cache_key_t key = { 0 };
+      key.revision = rev_item->revision;
+      key.second = rev_item->number;
+
+      SVN_ERR(svn_cache__get_partial((void **)ancestry_p, &is_cached,
+                                     ffd->node_revision_cache, &key,
+                                     svn_fs_fs__get_noderev_ancestry, NULL,
+                                     result_pool));
+      if (is_cached)
+        return SVN_NO_ERROR;
+    }
+
+  /* Cache miss.  Fetch the full noderev; this will also populate the
+   * cache for whoever asks next. */
+  SVN_ERR(svn_fs_fs__get_node_revision(&noderev, fs, id, scratch_pool,
+                                       scratch_pool));
+
+  ancestry = apr_pcalloc(result_pool, sizeof(*ancestry));
+  if (noderev->predecessor_id)
+    ancestry->predecessor_id = svn_fs_fs__id_copy(noderev->predecessor_id,
+                                                  result_pool);
+  if (noderev->created_path)
+    ancestry->created_path = apr_pstrdup(result_pool, noderev->created_path);
+
+  *ancestry_p = ancestry;
+
+  return SVN_NO_ERROR;
+}
+
 
 /* Given a revision file REV_FILE, opened to REV in FS, find the Node-ID
    of the header located at OFFSET and store it in *ID_P.  Allocate
@@ -1197,6 +1251,12 @@ struct rep_read_baton
 
   svn_boolean_t checksum_finalized;
 
+  /* Whether this particular read shall verify the reconstructed fulltext
+     against MD5_DIGEST, see the verify-sample-rate config option.  A
+     fulltext collected in CURRENT_FULLTEXT for caching is verified even
+     if this is FALSE. */
+  svn_boolean_t verify_checksum;
+
   /* The stored checksum of the representation we are reading, its
      length, and the amount we've read so far.  Some of this
      information is redundant with rs_list and src_state, but it's
@@ -1422,6 +1482,43 @@ set_cached_combined_window(svn_stringbuf_t *window,
   return SVN_NO_ERROR;
 }
 
+#if defined(POSIX_FADV_WILLNEED)
+/* Ask the OS to start fetching the byte ranges that we are about to read
+   for the delta chain LIST (as produced by build_rep_list).  This overlaps
+   the strictly serialized window reads of the decoding loop with I/O,
+   which is particularly effective on high-latency storage such as NFS.
+   Prefetching is purely advisory, so all errors are ignored.
+   Use SCRATCH_POOL for temporary allocations. */
+static void
+prefetch_rep_list(apr_array_header_t *list,
+                  apr_pool_t *scratch_pool)
+{
+  int i;
+
+  for (i = 0; i < list->nelts; ++i)
+    {
+      rep_state_t *rs = APR_ARRAY_IDX(list, i, rep_state_t *);
+      apr_os_file_t fd;
+      svn_error_t *err;
+
+      /* The start offset may still be unknown.  Resolving it only reads
+         the l2p index, which is small and cached, i.e. cheap compared to
+         the rep data we are about to request. */
+      err = auto_open_shared_file(rs->sfile);
+      if (!err)
+        err = auto_set_start_offset(rs, scratch_pool);
+      if (err)
+        {
+          svn_error_clear(err);
+          continue;
+        }
+
+      if (apr_os_file_get(&fd, rs->sfile->rfile->file) == APR_SUCCESS)
+        posix_fadvise(fd, rs->start, rs->size, POSIX_FADV_WILLNEED);
+    }
+}
+#endif
+
 /* Build an array of rep_state structures in *LIST giving the delta
    reps from first_rep to a plain-text or self-compressed rep.  Set
    *SRC_STATE to the plain-text rep we find at the end of the chain,
@@ -1499,12 +1596,40 @@ build_rep_list(apr_array_header_t **list,
 
       rs = NULL;
     }
+
+#if defined(POSIX_FADV_WILLNEED)
+  /* The complete chain is known now; hint the OS to read the windows
+     ahead of the decoding loop. */
+  prefetch_rep_list(*list, iterpool);
+#endif
+
   svn_pool_destroy(iterpool);
 
   return SVN_NO_ERROR;
 }
 
 
+/* Return whether the upcoming fulltext reconstruction from FS shall
+   verify its result against the stored MD5 sum, applying the sampling
+   rate configured via the verify-sample-rate option. */
+static svn_boolean_t
+select_for_verification(svn_fs_t *fs)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+
+  /* Counts reconstructions performed by this process.  Sampling does not
+     need to be exact, so unsynchronized updates from multiple threads
+     are fine. */
+  static apr_uint64_t read_counter = 0;
+
+  if (ffd->verify_sample_rate == 1)
+    return TRUE;
+  if (ffd->verify_sample_rate == 0)
+    return FALSE;
+
+  return (read_counter++ % (apr_uint64_t)ffd->verify_sample_rate) == 0;
+}
+
 /* Create a rep_read_baton structure for node revision NODEREV in
    filesystem FS and store it in *RB_P.  Perform all allocations in
    POOL.  If rep is mutable, it must be for file contents. */
@@ -1525,6 +1650,7 @@ rep_read_get_baton(struct rep_read_baton **rb_p,
   b->buf = NULL;
   b->md5_checksum_ctx = svn_checksum_ctx_create(svn_checksum_md5, pool);
   b->checksum_finalized = FALSE;
+  b->verify_checksum = select_for_verification(fs);
   memcpy(b->md5_digest, rep->md5_digest, sizeof(rep->md5_digest));
   b->len = rep->expanded_size;
   b->off = 0;
@@ -1682,6 +1808,7 @@ get_combined_window(svn_stringbuf_t **result,
   apr_pool_t *pool, *new_pool, *window_pool;
   int i;
   apr_array_header_t *windows;
+  svn_cache__multi_item_t *cache_items;
   svn_stringbuf_t *source, *buf = rb->base_window;
   rep_state_t *rs;
   apr_pool_t *iterpool;
@@ -1693,6 +1820,40 @@ get_combined_window(svn_stringbuf_t **result,
   window_pool = svn_pool_create(rb->pool);
   windows = apr_array_make(window_pool, 0, sizeof(svn_txdelta_window_t *));
   iterpool = svn_pool_create(rb->pool);
+
+  /* If the window cache can answer batched lookups in a single network
+     round trip, ask it for all windows of this chunk at once instead of
+     paying one round trip per delta in the chain.  This may fetch a few
+     windows beyond an early stop, which is cheap compared to the saved
+     latency. */
+  cache_items = NULL;
+  if (rb->rs_list->nelts > 1)
+    {
+      rs = APR_ARRAY_IDX(rb->rs_list, 0, rep_state_t *);
+      if (svn_cache__supports_multi_get(rs->window_cache))
+        {
+          window_cache_key_t *keys;
+          int count = rb->rs_list->nelts;
+
+          cache_items = apr_pcalloc(window_pool,
+                                    count * sizeof(*cache_items));
+          keys = apr_pcalloc(window_pool, count * sizeof(*keys));
+          for (i = 0; i < count; ++i)
+            {
+              rep_state_t *chain_rs
+                = APR_ARRAY_IDX(rb->rs_list, i, rep_state_t *);
+
+              get_window_key(&keys[i], chain_rs);
+              keys[i].chunk_index = rb->chunk_index;
+              cache_items[i].key
+                = chain_rs->window_cache ? &keys[i] : NULL;
+            }
+
+          SVN_ERR(svn_cache__get_multi(rs->window_cache, cache_items,
+                                       count, window_pool));
+        }
+    }
+
   for (i = 0; i < rb->rs_list->nelts; ++i)
     {
       svn_txdelta_window_t *window;
@@ -1700,8 +1861,22 @@ get_combined_window(svn_stringbuf_t **result,
       svn_pool_clear(iterpool);
 
       rs = APR_ARRAY_IDX(rb->rs_list, i, rep_state_t *);
-      SVN_ERR(read_delta_window(&window, rb->chunk_index, rs, window_pool,
-                                iterpool));
+      if (cache_items && cache_items[i].found)
+        {
+          /* Use the window from the batched lookup above, updating RS
+             the same way get_cached_window() would. */
+          svn_fs_fs__txdelta_cached_window_t *cached_window
+            = cache_items[i].value;
+
+          window = cached_window->window;
+          rs->current = cached_window->end_offset;
+          rs->chunk_index = rb->chunk_index;
+        }
+      else
+        {
+          SVN_ERR(read_delta_window(&window, rb->chunk_index, rs,
+                                    window_pool, iterpool));
+        }
 
       APR_ARRAY_PUSH(windows, svn_txdelta_window_t *) = window;
       if (window->src_ops == 0)
@@ -2086,11 +2261,13 @@ skip_contents(struct rep_read_baton *baton,
           len -= to_read;
 
           /* Make the MD5 calculation catch up with the data delivered
-           * (we did not run MD5 on the data that we took from the cache). */
+           * (we did not run MD5 on the data that we took from the cache).
+           * If this read is not going to verify the sum, don't bother. */
           if (!err)
             {
-              SVN_ERR(svn_checksum_update(baton->md5_checksum_ctx,
-                                          buffer, to_read));
+              if (baton->verify_checksum)
+                SVN_ERR(svn_checksum_update(baton->md5_checksum_ctx,
+                                            buffer, to_read));
               baton->off += to_read;
             }
         }
@@ -2176,8 +2353,11 @@ rep_read_contents(void *baton,
   /* Perform checksumming.  We want to check the checksum as soon as
      the last byte of data is read, in case the caller never performs
      a short read, but we don't want to finalize the MD5 context
-     twice. */
-  if (!rb->checksum_finalized)
+     twice.  Reads not selected for verification skip the summing
+     entirely - unless the fulltext is bound for a cache, which must
+     never be fed unchecked data. */
+  if (!rb->checksum_finalized
+      && (rb->verify_checksum || rb->current_fulltext))
     {
       SVN_ERR(svn_checksum_update(rb->md5_checksum_ctx, buf, *len));
       if (rb->off == rb->len)
@@ -2204,6 +2384,9 @@ rep_read_contents(void *baton,
       fs_fs_data_t *ffd = rb->fs->fsap_data;
       SVN_ERR(svn_cache__set(ffd->fulltext_cache, &rb->fulltext_cache_key,
                              rb->current_fulltext, rb->pool));
+      SVN_ERR(svn_fs_fs__fulltext_cache_store(rb->fs, &rb->rep,
+                                              rb->current_fulltext,
+                                              rb->pool));
       rb->current_fulltext = NULL;
     }
 
@@ -2230,6 +2413,22 @@ svn_fs_fs__get_contents(svn_stream_t **contents_p,
       fulltext_cache_key.revision = rep->revision;
       fulltext_cache_key.second = rep->item_index;
 
+      /* Check the on-disk fulltext cache before setting up the delta
+       * reconstruction machinery.  (The in-memory fulltext cache will be
+       * consulted lazily by the stream itself.) */
+      if (ffd->fulltext_cache_dir && cache_fulltext
+          && fulltext_size_is_cachable(ffd, rep->expanded_size))
+        {
+          svn_stringbuf_t *fulltext;
+          SVN_ERR(svn_fs_fs__fulltext_cache_lookup(&fulltext, fs, rep,
+                                                   pool, pool));
+          if (fulltext)
+            {
+              *contents_p = svn_stream_from_stringbuf(fulltext, pool);
+              return SVN_NO_ERROR;
+            }
+        }
+
       /* Initialize the reader baton.  Some members may added lazily
        * while reading from the stream */
       SVN_ERR(rep_read_get_baton(&rb, fs, rep, fulltext_cache_key, pool));
@@ -2486,8 +2685,14 @@ svn_fs_fs__get_file_delta_stream(svn_txdelta_stream_t **stream_p,
 
   /* Try a shortcut: if the target is stored as a delta against the source,
      then just use that delta.  However, prefer using the fulltext cache
-     whenever that is available. */
-  if (target->data_rep && (source || ! ffd->fulltext_cache))
+     whenever that is available - unless the fulltext is too large to be
+     cached anyway, in which case reconstructing it would only burn CPU
+     and I/O on something the stored self-delta already provides. */
+  if (target->data_rep
+      && (source
+          || ! ffd->fulltext_cache
+          || ! fulltext_size_is_cachable(ffd,
+                                         target->data_rep->expanded_size)))
     {
       /* Read target's base rep if any. */
       SVN_ERR(create_rep_state(&rep_state, &rep_header, NULL,
@@ -2581,11 +2786,17 @@ compare_dirent_name(const void *a, const void *b)
 /* Into *ENTRIES_P, read all directories entries from the key-value text in
  * STREAM.  If INCREMENTAL is TRUE, read until the end of the STREAM and
  * update the data.  ID is provided for nicer error messages.
+ *
+ * If ONLY_NAME is not NULL, skip all entries with a different name, i.e.
+ * return an array with at most one element.  This saves the allocation
+ * and parsing overhead for all the other entries when the caller needs
+ * just one of them.
  */
 static svn_error_t *
 read_dir_entries(apr_array_header_t **entries_p,
                  svn_stream_t *stream,
                  svn_boolean_t incremental,
+                 const char *only_name,
                  const svn_fs_id_t *id,
                  apr_pool_t *result_pool,
                  apr_pool_t *scratch_pool)
@@ -2627,6 +2838,11 @@ read_dir_entries(apr_array_header_t **entries_p,
             break;
         }
 
+      /* If we are looking for a single entry only, skip all others.
+         Deletions of that entry must still be processed below. */
+      if (only_name && strcmp(entry.key, only_name) != 0)
+        continue;
+
       /* Deleted entry? */
       if (entry.val == NULL)
         {
@@ -2676,6 +2892,11 @@ read_dir_entries(apr_array_header_t **entries_p,
         apr_hash_set(hash, dirent->name, entry.keylen, dirent);
       else
         APR_ARRAY_PUSH(entries, svn_fs_dirent_t *) = dirent;
+
+      /* Committed data contains each name only once, so a match ends
+         the search.  Incremental data may override it later on, though. */
+      if (only_name && !incremental)
+        break;
     }
 
   /* Convert container to a sorted array. */
@@ -2730,11 +2951,14 @@ get_txn_dir_info(svn_filesize_t *filesize,
 
 /* Fetch the contents of a directory into DIR.  Values are stored
    as filename to string mappings; further conversion is necessary to
-   convert them into svn_fs_dirent_t values. */
+   convert them into svn_fs_dirent_t values.
+   If ONLY_NAME is not NULL, DIR will contain at most the entry of that
+   name; see read_dir_entries. */
 static svn_error_t *
 get_dir_contents(svn_fs_fs__dir_data_t *dir,
                  svn_fs_t *fs,
                  node_revision_t *noderev,
+                 const char *only_name,
                  apr_pool_t *result_pool,
                  apr_pool_t *scratch_pool)
 {
@@ -2763,8 +2987,8 @@ get_dir_contents(svn_fs_fs__dir_data_t *dir,
       SVN_ERR(svn_io_file_size_get(&dir->txn_filesize, file, scratch_pool));
 
       contents = svn_stream_from_aprfile2(file, FALSE, scratch_pool);
-      SVN_ERR(read_dir_entries(&dir->entries, contents, TRUE, noderev->id,
-                               result_pool, scratch_pool));
+      SVN_ERR(read_dir_entries(&dir->entries, contents, TRUE, only_name,
+                               noderev->id, result_pool, scratch_pool));
       SVN_ERR(svn_stream_close(contents));
     }
   else if (noderev->data_rep)
@@ -2783,8 +3007,8 @@ get_dir_contents(svn_fs_fs__dir_data_t *dir,
 
       /* de-serialize hash */
       contents = svn_stream_from_stringbuf(text, scratch_pool);
-      SVN_ERR(read_dir_entries(&dir->entries, contents, FALSE, noderev->id,
-                               result_pool, scratch_pool));
+      SVN_ERR(read_dir_entries(&dir->entries, contents, FALSE, only_name,
+                               noderev->id, result_pool, scratch_pool));
     }
   else
     {
@@ -2872,7 +3096,8 @@ svn_fs_fs__rep_contents_dir(apr_array_header_t **entries_p,
 
   /* Read in the directory contents. */
   dir = apr_pcalloc(scratch_pool, sizeof(*dir));
-  SVN_ERR(get_dir_contents(dir, fs, noderev, result_pool, scratch_pool));
+  SVN_ERR(get_dir_contents(dir, fs, noderev, NULL, result_pool,
+                           scratch_pool));
   *entries_p = dir->entries;
 
   /* Update the cache, if we are to use one.
@@ -2935,18 +3160,43 @@ svn_fs_fs__rep_contents_dir_entry(svn_fs_dirent_t **dirent,
       svn_fs_dirent_t *entry;
       svn_fs_dirent_t *entry_copy = NULL;
       svn_fs_fs__dir_data_t dir;
+      svn_filesize_t size_estimate;
+
+      /* Estimate whether the directory will fit into the cache, based
+       * on the size of its on-disk representation.  Both are dominated
+       * by the entry names and IDs, so they are of similar magnitude. */
+      if (!noderev->data_rep)
+        size_estimate = 0;
+      else if (svn_fs_fs__id_txn_used(&noderev->data_rep->txn_id))
+        SVN_ERR(get_txn_dir_info(&size_estimate, fs, noderev,
+                                 scratch_pool));
+      else
+        size_estimate = noderev->data_rep->expanded_size;
 
-      /* Read in the directory contents. */
-      SVN_ERR(get_dir_contents(&dir, fs, noderev, scratch_pool,
-                               scratch_pool));
+      if (cache && svn_cache__is_cachable(cache,
+                                          (apr_size_t)size_estimate))
+        {
+          /* Read in the directory contents. */
+          SVN_ERR(get_dir_contents(&dir, fs, noderev, NULL, scratch_pool,
+                                   scratch_pool));
 
-      /* Update the cache, if we are to use one.
-       *
-       * Don't even attempt to serialize very large directories; it would
-       * cause an unnecessary memory allocation peak.  150 bytes / entry is
-       * about right. */
-      if (cache && svn_cache__is_cachable(cache, 150 * dir.entries->nelts))
-        SVN_ERR(svn_cache__set(cache, key, &dir, scratch_pool));
+          /* Update the cache.
+           *
+           * Don't even attempt to serialize very large directories; it
+           * would cause an unnecessary memory allocation peak.  150 bytes
+           * per entry is about right. */
+          if (svn_cache__is_cachable(cache, 150 * dir.entries->nelts))
+            SVN_ERR(svn_cache__set(cache, key, &dir, scratch_pool));
+        }
+      else
+        {
+          /* The directory is too large to cache (or there is no cache).
+           * Materializing, parsing and sorting all entries just to pick
+           * a single one would be wasted work; scan the representation
+           * for NAME only. */
+          SVN_ERR(get_dir_contents(&dir, fs, noderev, name, scratch_pool,
+                                   scratch_pool));
+        }
 
       /* find desired entry and return a copy in POOL, if found */
       entry = svn_fs_fs__find_dir_entry(dir.entries, name, NULL);
@@ -3040,6 +3290,35 @@ svn_fs_fs__get_proplist(apr_hash_t **proplist_p,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_fs_fs__get_cached_proplist_digest(apr_uint64_t *digest,
+                                      svn_boolean_t *found,
+                                      svn_fs_t *fs,
+                                      node_revision_t *noderev,
+                                      apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  representation_t *rep = noderev->prop_rep;
+
+  *found = FALSE;
+  if (rep
+      && !svn_fs_fs__id_txn_used(&rep->txn_id)
+      && ffd->properties_cache
+      && SVN_IS_VALID_REVNUM(rep->revision))
+    {
+      pair_cache_key_t key = { 0 };
+
+      key.revision = rep->revision;
+      key.second = rep->item_index;
+      SVN_ERR(svn_cache__get_partial((void **)digest, found,
+                                     ffd->properties_cache, &key,
+                                     svn_fs_fs__get_proplist_digest, NULL,
+                                     scratch_pool));
+    }
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_fs_fs__create_changes_context(svn_fs_fs__changes_context_t **context,
                                   svn_fs_t *fs,
@@ -3682,14 +3961,8 @@ block_read(void **result,
   apr_array_header_t *entries;
   int run_count = 0;
   int i;
-  apr_pool_t *iterpool;
-
-  /* Block read is an optional feature. If the caller does not want anything
-   * specific we may not have to read anything. */
-  if (!result)
-    return SVN_NO_ERROR;
-
-  iterpool = svn_pool_create(scratch_pool);
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  apr_time_t trace_start = svn_trace__start();
 
   /* don't try this on transaction protorev files */
   SVN_ERR_ASSERT(SVN_IS_VALID_REVNUM(revision));
@@ -3802,5 +4075,7 @@ block_read(void **result,
   assert(!result || *result);
   svn_pool_destroy(iterpool);
 
+  svn_trace__record("fs_fs", "block-read", trace_start);
+
   return SVN_NO_ERROR;
 }
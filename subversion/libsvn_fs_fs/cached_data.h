@@ -27,6 +27,7 @@
 #include "svn_fs.h"
 
 #include "fs.h"
+#include "temp_serializer.h"
 
 
 
@@ -51,6 +52,18 @@ svn_fs_fs__get_node_revision(node_revision_t **noderev_p,
                              apr_pool_t *result_pool,
                              apr_pool_t *scratch_pool);
 
+/* Set *ANCESTRY_P to the ancestry info (predecessor id and created path)
+   of the node-revision for the node ID in FS, allocated in RESULT_POOL.
+   If possible, extract just those fields from the node-revision cache
+   instead of fetching the full node-revision.  Use SCRATCH_POOL for
+   temporaries. */
+svn_error_t *
+svn_fs_fs__get_node_ancestry(svn_fs_fs__noderev_ancestry_t **ancestry_p,
+                             svn_fs_t *fs,
+                             const svn_fs_id_t *id,
+                             apr_pool_t *result_pool,
+                             apr_pool_t *scratch_pool);
+
 /* Set *ROOT_ID to the node-id for the root of revision REV in
    filesystem FS.  Do any allocations in POOL. */
 svn_error_t *
@@ -170,6 +183,18 @@ svn_fs_fs__get_proplist(apr_hash_t **proplist,
                         node_revision_t *noderev,
                         apr_pool_t *pool);
 
+/* If the property list of node-revision NODEREV in FS is in the properties
+   cache, set *DIGEST to its content digest and *FOUND to TRUE.  Otherwise,
+   set *FOUND to FALSE.  Differing digests imply differing property lists;
+   equal digests imply nothing.  Use SCRATCH_POOL for temporary allocations.
+ */
+svn_error_t *
+svn_fs_fs__get_cached_proplist_digest(apr_uint64_t *digest,
+                                      svn_boolean_t *found,
+                                      svn_fs_t *fs,
+                                      node_revision_t *noderev,
+                                      apr_pool_t *scratch_pool);
+
 /* Create a changes retrieval context object in *RESULT_POOL and return it
  * in *CONTEXT.  It will allow svn_fs_fs__get_changes to fetch consecutive
  * blocks (one per invocation) from REV's changed paths list in FS. */
@@ -317,6 +317,21 @@ create_cache(svn_cache__t **cache_p,
       SVN_ERR(svn_cache__create_memcache(cache_p, memcache,
                                          serializer, deserializer, klen,
                                          prefix, result_pool));
+
+      /* Memcached lookups pay a socket round-trip per item.  If we also
+       * have a membuffer, put it in front of the memcache so that hot
+       * data gets served from within this process. */
+      if (membuffer)
+        {
+          svn_cache__t *front;
+          SVN_ERR(svn_cache__create_membuffer_cache(
+                    &front, membuffer, serializer, deserializer,
+                    klen, prefix, priority, FALSE, has_namespace,
+                    result_pool, scratch_pool));
+          SVN_ERR(svn_cache__create_two_level(cache_p, front, *cache_p,
+                                              result_pool));
+        }
+
       error_handler = no_handler
                     ? NULL
                     : warn_and_continue_on_cache_errors;
@@ -436,7 +451,9 @@ svn_fs_fs__initialize_caches(svn_fs_t *fs,
                        fs->pool, pool));
 
   /* 1st level DAG node cache */
-  ffd->dag_node_cache = svn_fs_fs__create_dag_cache(fs->pool);
+  ffd->dag_node_cache
+    = svn_fs_fs__create_dag_cache((apr_size_t)ffd->dag_node_cache_size,
+                                  fs->pool);
 
   /* Very rough estimate: 1K per directory. */
   SVN_ERR(create_cache(&(ffd->dir_cache),
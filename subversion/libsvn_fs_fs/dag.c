@@ -1238,7 +1238,8 @@ svn_fs_fs__dag_open(dag_node_t **child_p,
 
 
 svn_error_t *
-svn_fs_fs__dag_copy(dag_node_t *to_node,
+svn_fs_fs__dag_copy(const svn_fs_id_t **new_id_p,
+                    dag_node_t *to_node,
                     const char *entry,
                     dag_node_t *from_node,
                     svn_boolean_t preserve_history,
@@ -1285,6 +1286,9 @@ svn_fs_fs__dag_copy(dag_node_t *to_node,
       id = svn_fs_fs__dag_get_id(from_node);
     }
 
+  if (new_id_p)
+    *new_id_p = id;
+
   /* Set the entry in to_node to the new id. */
   return svn_fs_fs__dag_set_entry(to_node, entry, id, from_node->kind,
                                   txn_id, pool);
@@ -514,7 +514,9 @@ svn_error_t *svn_fs_fs__dag_make_file(dag_node_t **child_p,
 
 /* Make ENTRY in TO_NODE be a copy of FROM_NODE, allocating from POOL.
    TO_NODE must be mutable.  TXN_ID is the Subversion transaction
-   under which this occurs.
+   under which this occurs.  If NEW_ID_P is not NULL, set *NEW_ID_P to
+   the node revision ID of the copy, so that the caller does not have
+   to walk the target path again just to find it.
 
    If PRESERVE_HISTORY is true, the new node will record that it was
    copied from FROM_PATH in FROM_REV; therefore, FROM_NODE should be
@@ -522,11 +524,13 @@ svn_error_t *svn_fs_fs__dag_make_file(dag_node_t **child_p,
    checked.  FROM_PATH should be canonicalized before being passed
    here.
 
-   If PRESERVE_HISTORY is false, FROM_PATH and FROM_REV are ignored.
+   If PRESERVE_HISTORY is false, FROM_PATH and FROM_REV are ignored
+   and *NEW_ID_P is FROM_NODE's own ID.
 
    Use POOL for all allocations.
  */
-svn_error_t *svn_fs_fs__dag_copy(dag_node_t *to_node,
+svn_error_t *svn_fs_fs__dag_copy(const svn_fs_id_t **new_id_p,
+                                 dag_node_t *to_node,
                                  const char *entry,
                                  dag_node_t *from_node,
                                  svn_boolean_t preserve_history,
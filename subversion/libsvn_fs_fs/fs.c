@@ -32,6 +32,7 @@
 #include "svn_delta.h"
 #include "svn_version.h"
 #include "svn_pools.h"
+#include "batch_fsync.h"
 #include "fs.h"
 #include "fs_fs.h"
 #include "tree.h"
@@ -39,6 +40,8 @@
 #include "hotcopy.h"
 #include "id.h"
 #include "pack.h"
+#include "paths-index.h"
+#include "lock-index.h"
 #include "recovery.h"
 #include "rep-cache.h"
 #include "revprops.h"
@@ -271,11 +274,12 @@ fs_ioctl(svn_fs_t *fs, svn_fs_ioctl_code_t ctlcode,
           svn_fs_fs__ioctl_get_stats_output_t *output;
 
           output = apr_pcalloc(result_pool, sizeof(*output));
-          SVN_ERR(svn_fs_fs__get_stats(&output->stats, fs,
-                                       input->progress_func,
-                                       input->progress_baton,
-                                       cancel_func, cancel_baton,
-                                       result_pool, scratch_pool));
+          SVN_ERR(svn_fs_fs__get_stats_range(&output->stats, fs,
+                                             input->start_rev,
+                                             input->progress_func,
+                                             input->progress_baton,
+                                             cancel_func, cancel_baton,
+                                             result_pool, scratch_pool));
           *output_p = output;
           return SVN_NO_ERROR;
         }
@@ -300,6 +304,19 @@ fs_ioctl(svn_fs_t *fs, svn_fs_ioctl_code_t ctlcode,
           *output_p = NULL;
           return SVN_NO_ERROR;
         }
+      else if (ctlcode.code == SVN_FS_FS__IOCTL_REBUILD_INDEX.code)
+        {
+          svn_fs_fs__ioctl_rebuild_index_input_t *input = input_void;
+
+          SVN_ERR(svn_fs_fs__rebuild_index(fs, input->start_rev,
+                                           input->end_rev,
+                                           input->progress_func,
+                                           input->progress_baton,
+                                           cancel_func, cancel_baton,
+                                           scratch_pool));
+          *output_p = NULL;
+          return SVN_NO_ERROR;
+        }
       else if (ctlcode.code == SVN_FS_FS__IOCTL_REVISION_SIZE.code)
         {
           svn_fs_fs__ioctl_revision_size_input_t *input = input_void;
@@ -325,6 +342,44 @@ fs_ioctl(svn_fs_t *fs, svn_fs_ioctl_code_t ctlcode,
                                              cancel_baton,
                                              scratch_pool));
 
+          *output_p = NULL;
+          return SVN_NO_ERROR;
+        }
+      else if (ctlcode.code == SVN_FS_FS__IOCTL_BUILD_PATHS_INDEX.code)
+        {
+          svn_fs_fs__ioctl_build_paths_index_input_t *input = input_void;
+
+          SVN_ERR(svn_fs_fs__paths_index_build(fs,
+                                               input->end_rev,
+                                               input->progress_func,
+                                               input->progress_baton,
+                                               cancel_func,
+                                               cancel_baton,
+                                               scratch_pool));
+
+          *output_p = NULL;
+          return SVN_NO_ERROR;
+        }
+      else if (ctlcode.code == SVN_FS_FS__IOCTL_QUERY_PATHS_INDEX.code)
+        {
+          svn_fs_fs__ioctl_query_paths_index_input_t *input = input_void;
+          svn_fs_fs__ioctl_query_paths_index_output_t *output
+            = apr_pcalloc(result_pool, sizeof(*output));
+
+          SVN_ERR(svn_fs_fs__paths_index_query(&output->hits, fs,
+                                               input->path,
+                                               input->start_rev,
+                                               input->end_rev,
+                                               result_pool, scratch_pool));
+
+          *output_p = output;
+          return SVN_NO_ERROR;
+        }
+      else if (ctlcode.code == SVN_FS_FS__IOCTL_BUILD_LOCK_INDEX.code)
+        {
+          SVN_ERR(svn_fs_fs__lock_index_build(fs, cancel_func, cancel_baton,
+                                              scratch_pool));
+
           *output_p = NULL;
           return SVN_NO_ERROR;
         }
@@ -705,6 +760,8 @@ svn_fs_fs__init(const svn_version_t *loader_version,
                              loader_version->major);
   SVN_ERR(svn_ver_check_list2(fs_version(), checklist, svn_ver_equal));
 
+  SVN_ERR(svn_fs_fs__batch_fsync_init(common_pool));
+
   *vtable = &library_vtable;
   return SVN_NO_ERROR;
 }
@@ -100,6 +100,8 @@ extern "C" {
 /* Names of sections and options in fsfs.conf. */
 #define CONFIG_SECTION_CACHES            "caches"
 #define CONFIG_OPTION_FAIL_STOP          "fail-stop"
+#define CONFIG_OPTION_FULLTEXT_CACHE_DIR "fulltext-cache-dir"
+#define CONFIG_OPTION_DAG_NODE_CACHE_SIZE "dag-node-cache-size"
 #define CONFIG_SECTION_REP_SHARING       "rep-sharing"
 #define CONFIG_OPTION_ENABLE_REP_SHARING "enable-rep-sharing"
 #define CONFIG_SECTION_DELTIFICATION     "deltification"
@@ -107,18 +109,24 @@ extern "C" {
 #define CONFIG_OPTION_ENABLE_PROPS_DELTIFICATION "enable-props-deltification"
 #define CONFIG_OPTION_MAX_DELTIFICATION_WALK     "max-deltification-walk"
 #define CONFIG_OPTION_MAX_LINEAR_DELTIFICATION   "max-linear-deltification"
+#define CONFIG_OPTION_MAX_DELTA_CHAIN            "max-delta-chain"
 #define CONFIG_OPTION_COMPRESSION_LEVEL  "compression-level"
 #define CONFIG_SECTION_PACKED_REVPROPS   "packed-revprops"
 #define CONFIG_OPTION_REVPROP_PACK_SIZE  "revprop-pack-size"
 #define CONFIG_OPTION_COMPRESS_PACKED_REVPROPS  "compress-packed-revprops"
+#define CONFIG_OPTION_INDEXED_PACKED_REVPROPS   "indexed-packed-revprops"
 #define CONFIG_SECTION_IO                "io"
 #define CONFIG_OPTION_BLOCK_SIZE         "block-size"
 #define CONFIG_OPTION_L2P_PAGE_SIZE      "l2p-page-size"
 #define CONFIG_OPTION_P2L_PAGE_SIZE      "p2l-page-size"
+#define CONFIG_OPTION_UNCACHE_MAINTENANCE_DATA "uncache-maintenance-data"
 #define CONFIG_SECTION_DEBUG             "debug"
 #define CONFIG_OPTION_PACK_AFTER_COMMIT  "pack-after-commit"
 #define CONFIG_OPTION_VERIFY_BEFORE_COMMIT "verify-before-commit"
+#define CONFIG_SECTION_VERIFICATION      "verification"
+#define CONFIG_OPTION_VERIFY_SAMPLE_RATE "verify-sample-rate"
 #define CONFIG_OPTION_COMPRESSION        "compression"
+#define CONFIG_OPTION_COMPRESSION_THREADS "compression-threads"
 
 /* The format number of this filesystem.
    This is independent of the repository format number, and
@@ -347,6 +355,12 @@ typedef struct fs_fs_data_t
    * (not just the one bit that we need, atm). */
   svn_boolean_t use_block_read;
 
+  /* If set, ask the OS to drop rev / pack file data read by whole-shard
+   * maintenance operations (pack, verify) from its page cache once we
+   * are done with the respective file.  This keeps those linear scans
+   * from evicting the hot working set of a live server. */
+  svn_boolean_t uncache_maintenance_data;
+
   /* The revision that was youngest, last time we checked. */
   svn_revnum_t youngest_rev_cache;
 
@@ -360,10 +374,18 @@ typedef struct fs_fs_data_t
      e.g. memcached may be ignored as caching is an optional feature. */
   svn_boolean_t fail_stop;
 
+  /* Directory holding the optional on-disk fulltext cache, as an absolute
+     path.  NULL if that cache is disabled. */
+  const char *fulltext_cache_dir;
+
   /* A cache of revision root IDs, mapping from (svn_revnum_t *) to
      (svn_fs_id_t *).  (Not threadsafe.) */
   svn_cache__t *rev_root_id_cache;
 
+  /* Number of entries in DAG_NODE_CACHE, from the [caches] section of
+     fsfs.conf.  0 means the built-in default. */
+  apr_int64_t dag_node_cache_size;
+
   /* Caches native dag_node_t* instances and acts as a 1st level cache */
   fs_fs_dag_cache_t *dag_node_cache;
 
@@ -405,8 +427,14 @@ typedef struct fs_fs_data_t
   /* Cache for txdelta_window_t objects; the key is window_cache_key_t */
   svn_cache__t *txdelta_window_cache;
 
-  /* Cache for combined windows as svn_stringbuf_t objects;
-     the key is window_cache_key_t */
+  /* Cache for combined windows as svn_stringbuf_t objects, i.e. the
+     expanded result of applying a delta chain up to some intermediate
+     representation; the key is window_cache_key_t.  Concurrent readers
+     of the same content share the composition work through this cache.
+     Only single-chunk representations are cached:  for multi-chunk
+     reps, later chunks would still need the full delta chain, so a
+     cached intermediate result for one chunk could not shorten the
+     chain consistently across chunks.  See get_combined_window(). */
   svn_cache__t *combined_window_cache;
 
   /* Cache for node_revision_t objects; the key is (revision, item_index) */
@@ -462,9 +490,26 @@ typedef struct fs_fs_data_t
   /* The sqlite database used for rep caching. */
   svn_sqlite__db_t *rep_cache_db;
 
+  /* In-memory Bloom filter over the SHA1 keys in REP_CACHE_DB, or NULL
+     if none has been built.  Loaded when the database is opened and
+     updated on every insert through this svn_fs_t; used as a negative
+     cache to skip the SQLite lookup for representations that are
+     certainly not in the database.  REP_CACHE_BLOOM_MASK is the bit
+     index mask, i.e. the filter size in bits minus one. */
+  unsigned char *rep_cache_bloom;
+  apr_size_t rep_cache_bloom_mask;
+
   /* Thread-safe boolean */
   svn_atomic_t rep_cache_db_opened;
 
+  /* The sqlite database used for the optional changed-paths index.
+     NULL until the first use; remains NULL if the index does not exist. */
+  svn_sqlite__db_t *paths_index_db;
+
+  /* The sqlite database used for the optional lock path index.
+     NULL until the first use; remains NULL if the index does not exist. */
+  svn_sqlite__db_t *lock_index_db;
+
   /* The oldest revision not in a pack file.  It also applies to revprops
    * if revprop packing has been enabled by the FSFS format version. */
   svn_revnum_t min_unpacked_rev;
@@ -480,10 +525,16 @@ typedef struct fs_fs_data_t
   /* Whether packed revprop files shall be compressed. */
   svn_boolean_t compress_packed_revprops;
 
+  /* Whether revprops shall be packed in the indexed "PACK2" format with
+   * individually compressed entries that support random access. */
+  svn_boolean_t indexed_packed_revprops;
+
   /* Whether directory nodes shall be deltified just like file nodes. */
   svn_boolean_t deltify_directories;
 
-  /* Whether nodes properties shall be deltified. */
+  /* Whether nodes properties shall be deltified.  Particularly effective
+   * for merge-heavy repositories where large svn:mergeinfo properties
+   * change incrementally from one node-revision to the next. */
   svn_boolean_t deltify_properties;
 
   /* Restart deltification histories after each multiple of this value */
@@ -493,18 +544,34 @@ typedef struct fs_fs_data_t
    * deltification history after which skip deltas will be used. */
   apr_int64_t max_linear_deltification;
 
+  /* Maximum acceptable length of the delta chain of the base rep picked
+   * for a new representation; longer chains cause a restart with a new
+   * fulltext.  0 means "derive the limit from max_linear_deltification"
+   * (the pre-existing behavior). */
+  apr_int64_t max_delta_chain;
+
   /* Compression type to use with txdelta storage format in new revs. */
   compression_type_t delta_compression_type;
 
   /* Compression level (currently, only used with compression_type_zlib). */
   int delta_compression_level;
 
+  /* Number of threads to compress svndiff windows with when writing
+   * new representations; 1 keeps the compression inline. */
+  int delta_compression_threads;
+
   /* Pack after every commit. */
   svn_boolean_t pack_after_commit;
 
   /* Verify each new revision before commit. */
   svn_boolean_t verify_before_commit;
 
+  /* Verify every Nth reconstructed fulltext against its stored MD5 sum.
+     1 verifies every read (the default), 0 disables verification on
+     reads entirely.  Fulltexts about to enter a fulltext cache are
+     always verified, regardless of this setting. */
+  apr_int64_t verify_sample_rate;
+
   /* Per-instance filesystem ID, which provides an additional level of
      uniqueness for filesystems that share the same UUID, but should
      still be distinguishable (e.g. backups produced by svn_fs_hotcopy()
@@ -514,6 +581,11 @@ typedef struct fs_fs_data_t
   /* Ensure that all filesystem changes are written to disk. */
   svn_boolean_t flush_to_disk;
 
+  /* Number of worker threads that svn_fs_fs__pack() may use to pack
+     independent shards concurrently.  Values of 0 and 1 select the
+     single-threaded implementation. */
+  apr_size_t pack_threads;
+
   /* Pointer to svn_fs_open. */
   svn_error_t *(*svn_fs_open_)(svn_fs_t **, const char *, apr_hash_t *,
                                apr_pool_t *, apr_pool_t *);
@@ -73,6 +73,14 @@
    Values < 1 disable deltification. */
 #define SVN_FS_FS_MAX_DELTIFICATION_WALK 1023
 
+/* Reject delta bases whose own delta chain is already this long (or
+   longer) and start over with a fulltext instead.  This caps the number
+   of deltas a cold read has to combine.
+   A value of 0 derives the limit from SVN_FS_FS_MAX_LINEAR_DELTIFICATION
+   as 2 * max-linear-deltification + 2, which matches the behavior of
+   previous releases. */
+#define SVN_FS_FS_MAX_DELTA_CHAIN 0
+
 /* Notes:
 
 To avoid opening and closing the rev-files all the time, it would
@@ -780,6 +788,10 @@ read_config(fs_fs_data_t *ffd,
                                    CONFIG_SECTION_DELTIFICATION,
                                    CONFIG_OPTION_MAX_LINEAR_DELTIFICATION,
                                    SVN_FS_FS_MAX_LINEAR_DELTIFICATION));
+      SVN_ERR(svn_config_get_int64(config, &ffd->max_delta_chain,
+                                   CONFIG_SECTION_DELTIFICATION,
+                                   CONFIG_OPTION_MAX_DELTA_CHAIN,
+                                   SVN_FS_FS_MAX_DELTA_CHAIN));
     }
   else
     {
@@ -787,6 +799,7 @@ read_config(fs_fs_data_t *ffd,
       ffd->deltify_properties = FALSE;
       ffd->max_deltification_walk = SVN_FS_FS_MAX_DELTIFICATION_WALK;
       ffd->max_linear_deltification = SVN_FS_FS_MAX_LINEAR_DELTIFICATION;
+      ffd->max_delta_chain = SVN_FS_FS_MAX_DELTA_CHAIN;
     }
 
   /* Initialize revprop packing settings in ffd. */
@@ -796,6 +809,10 @@ read_config(fs_fs_data_t *ffd,
                                   CONFIG_SECTION_PACKED_REVPROPS,
                                   CONFIG_OPTION_COMPRESS_PACKED_REVPROPS,
                                   FALSE));
+      SVN_ERR(svn_config_get_bool(config, &ffd->indexed_packed_revprops,
+                                  CONFIG_SECTION_PACKED_REVPROPS,
+                                  CONFIG_OPTION_INDEXED_PACKED_REVPROPS,
+                                  FALSE));
       SVN_ERR(svn_config_get_int64(config, &ffd->revprop_pack_size,
                                    CONFIG_SECTION_PACKED_REVPROPS,
                                    CONFIG_OPTION_REVPROP_PACK_SIZE,
@@ -809,6 +826,7 @@ read_config(fs_fs_data_t *ffd,
     {
       ffd->revprop_pack_size = 0x10000;
       ffd->compress_packed_revprops = FALSE;
+      ffd->indexed_packed_revprops = FALSE;
     }
 
   if (ffd->format >= SVN_FS_FS__MIN_LOG_ADDRESSING_FORMAT)
@@ -849,6 +867,21 @@ read_config(fs_fs_data_t *ffd,
       ffd->p2l_page_size = 0x100000;  /* Matches above default in bytes. */
     }
 
+  SVN_ERR(svn_config_get_bool(config, &ffd->uncache_maintenance_data,
+                              CONFIG_SECTION_IO,
+                              CONFIG_OPTION_UNCACHE_MAINTENANCE_DATA,
+                              FALSE));
+
+  /* Size of the in-process first-level DAG node cache.  0 selects the
+   * built-in default; the cache implementation enforces a minimum and
+   * rounds up to a power of two. */
+  SVN_ERR(svn_config_get_int64(config, &ffd->dag_node_cache_size,
+                               CONFIG_SECTION_CACHES,
+                               CONFIG_OPTION_DAG_NODE_CACHE_SIZE,
+                               0));
+  if (ffd->dag_node_cache_size < 0)
+    ffd->dag_node_cache_size = 0;
+
   if (ffd->format >= SVN_FS_FS__MIN_PACKED_FORMAT)
     {
       SVN_ERR(svn_config_get_bool(config, &ffd->pack_after_commit,
@@ -926,6 +959,22 @@ read_config(fs_fs_data_t *ffd,
       ffd->delta_compression_level = SVN_DELTA_COMPRESSION_LEVEL_NONE;
     }
 
+  /* Number of threads to compress new delta windows with.  The encoder
+   * falls back to inline compression for a value of 1 and whenever the
+   * selected svndiff format does not compress at all. */
+  {
+    apr_int64_t threads;
+
+    SVN_ERR(svn_config_get_int64(config, &threads,
+                                 CONFIG_SECTION_DELTIFICATION,
+                                 CONFIG_OPTION_COMPRESSION_THREADS,
+                                 1));
+    if (threads < 1)
+      threads = 1;
+
+    ffd->delta_compression_threads = (int)MIN(threads, 64);
+  }
+
 #ifdef SVN_DEBUG
   SVN_ERR(svn_config_get_bool(config, &ffd->verify_before_commit,
                               CONFIG_SECTION_DEBUG,
@@ -938,6 +987,16 @@ read_config(fs_fs_data_t *ffd,
                               FALSE));
 #endif
 
+  /* Read-time checksum verification configuration. */
+  SVN_ERR(svn_config_get_int64(config, &ffd->verify_sample_rate,
+                               CONFIG_SECTION_VERIFICATION,
+                               CONFIG_OPTION_VERIFY_SAMPLE_RATE,
+                               1));
+  if (ffd->verify_sample_rate < 0)
+    return svn_error_createf(SVN_ERR_BAD_CONFIG_VALUE, NULL,
+                             _("The '%s' config option must not be negative"),
+                             CONFIG_OPTION_VERIFY_SAMPLE_RATE);
+
   /* memcached configuration */
   SVN_ERR(svn_cache__make_memcache_from_config(&ffd->memcache, config,
                                                result_pool, scratch_pool));
@@ -946,6 +1005,26 @@ read_config(fs_fs_data_t *ffd,
                               CONFIG_SECTION_CACHES, CONFIG_OPTION_FAIL_STOP,
                               FALSE));
 
+  /* On-disk fulltext cache configuration. */
+  {
+    const char *cache_dir;
+
+    svn_config_get(config, &cache_dir, CONFIG_SECTION_CACHES,
+                   CONFIG_OPTION_FULLTEXT_CACHE_DIR, NULL);
+    if (cache_dir && *cache_dir)
+      {
+        cache_dir = svn_dirent_internal_style(cache_dir, scratch_pool);
+        if (!svn_dirent_is_absolute(cache_dir))
+          cache_dir = svn_dirent_join(fs_path, cache_dir, scratch_pool);
+
+        ffd->fulltext_cache_dir = apr_pstrdup(result_pool, cache_dir);
+      }
+    else
+      {
+        ffd->fulltext_cache_dir = NULL;
+      }
+  }
+
   return SVN_NO_ERROR;
 }
 
@@ -978,6 +1057,23 @@ write_config(svn_fs_t *fs,
 "### configured (and ignoring it with file:// access).  To make"             NL
 "### Subversion never ignore cache errors, uncomment this line."             NL
 "# " CONFIG_OPTION_FAIL_STOP " = true"                                       NL
+"###"                                                                        NL
+"### Fulltexts reconstructed from deltas can optionally be kept in a"        NL
+"### directory on disk, keyed by their SHA1 checksum, so that frequently"    NL
+"### read files do not need to be reconstructed again after a server"        NL
+"### restart.  The directory will be created on demand; relative paths"      NL
+"### are interpreted relative to the repository's db/ directory.  Note"      NL
+"### that entries are never pruned automatically, so the directory should"   NL
+"### be placed on a volume where it may grow or be cleaned up externally."   NL
+"### The on-disk fulltext cache is disabled by default."                     NL
+"# " CONFIG_OPTION_FULLTEXT_CACHE_DIR " = /var/cache/svn-fulltexts"          NL
+"###"                                                                        NL
+"### Number of entries in the in-process DAG node cache that accelerates"    NL
+"### path lookups.  Larger values help servers that resolve many deep"       NL
+"### paths repeatedly, at the cost of some memory per open filesystem."      NL
+"### The value is rounded up to a power of two; 0 selects the built-in"      NL
+"### default of 256."                                                        NL
+"# " CONFIG_OPTION_DAG_NODE_CACHE_SIZE " = 0"                                NL
 ""                                                                           NL
 "[" CONFIG_SECTION_REP_SHARING "]"                                           NL
 "### To conserve space, the filesystem can optionally avoid storing"         NL
@@ -1056,6 +1152,16 @@ write_config(svn_fs_t *fs,
 "### For 1.8, the default value is 16; earlier versions use 1."              NL
 "# " CONFIG_OPTION_MAX_LINEAR_DELTIFICATION " = 16"                          NL
 "###"                                                                        NL
+"### Reading a node back requires combining every delta along its chain,"    NL
+"### so files that get modified in many consecutive revisions can become"    NL
+"### expensive to reconstruct from a cold cache.  When the delta chain of"   NL
+"### the would-be base representation is already this long, the new"         NL
+"### representation will be stored as fulltext instead, starting a fresh"    NL
+"### chain.  Smaller values trade disk space for lower read latency."        NL
+"### A value of 0 derives the limit from " CONFIG_OPTION_MAX_LINEAR_DELTIFICATION NL
+"### as twice that value plus two, matching previous releases."              NL
+"# " CONFIG_OPTION_MAX_DELTA_CHAIN " = 0"                                    NL
+"###"                                                                        NL
 "### After deltification, we compress the data to minimize on-disk size."    NL
 "### This setting controls the compression algorithm, which will be used in" NL
 "### future revisions.  It can be used to either disable compression or to"  NL
@@ -1080,6 +1186,15 @@ write_config(svn_fs_t *fs,
 "### still be used (and it will result in zlib compression with the"         NL
 "### corresponding compression level)."                                      NL
 "###   " CONFIG_OPTION_COMPRESSION_LEVEL " = 0 ... 9 (default is 5)"         NL
+"###"                                                                        NL
+"### The number of threads used to compress the deltas of new file"          NL
+"### contents while they are being received.  Values greater than 1"         NL
+"### overlap the compression with the I/O of the commit, which can help"     NL
+"### with strong zlib compression of large files, at the cost of the"        NL
+"### extra threads.  The option has no effect when compression has been"     NL
+"### disabled."                                                              NL
+"### delta compression uses a single thread by default."                     NL
+"# " CONFIG_OPTION_COMPRESSION_THREADS " = 1"                                NL
 ""                                                                           NL
 "[" CONFIG_SECTION_PACKED_REVPROPS "]"                                       NL
 "### This parameter controls the size (in kBytes) of packed revprop files."  NL
@@ -1101,6 +1216,18 @@ write_config(svn_fs_t *fs,
 "### even more so writing, become significantly more CPU intensive."         NL
 "### Compressing packed revprops is disabled by default."                    NL
 "# " CONFIG_OPTION_COMPRESS_PACKED_REVPROPS " = false"                       NL
+"###"                                                                        NL
+"### Packed revprop files may be written in an indexed format that"          NL
+"### compresses the revprops of each revision individually.  Reading a"      NL
+"### single revision's revprops then no longer requires decompressing the"   NL
+"### whole pack file, which greatly reduces the CPU cost of e.g. 'svn log'"  NL
+"### over long revision ranges.  The indexed format takes slightly more"     NL
+"### disk space than compressed non-indexed packs.  Once a pack file has"    NL
+"### been written in the indexed format, all processes accessing the"        NL
+"### repository must support it; disabling the option later will only"       NL
+"### affect pack files written afterwards."                                  NL
+"### Writing indexed packed revprops is disabled by default."                NL
+"# " CONFIG_OPTION_INDEXED_PACKED_REVPROPS " = false"                        NL
 ""                                                                           NL
 "[" CONFIG_SECTION_IO "]"                                                    NL
 "### Parameters in this section control the data access granularity in"      NL
@@ -1148,6 +1275,31 @@ write_config(svn_fs_t *fs,
 "### Must be a power of 2."                                                  NL
 "### p2l-page-size is given in kBytes and with a default of 1024 kBytes."    NL
 "# " CONFIG_OPTION_P2L_PAGE_SIZE " = 1024"                                   NL
+"###"                                                                        NL
+"### Maintenance operations such as 'svnadmin pack' and 'svnadmin verify'"   NL
+"### read whole shards of revision data that the server will often never"    NL
+"### touch again.  On a busy server, those linear scans may push the hot"    NL
+"### working set out of the OS page cache.  If this option is enabled,"      NL
+"### such operations will advise the OS to drop the scanned data from its"   NL
+"### page cache as soon as they are done with the respective file.  This"    NL
+"### is advisory only and has no effect on platforms without the relevant"   NL
+"### support (e.g. non-POSIX systems)."                                      NL
+"### uncache-maintenance-data is disabled by default."                       NL
+"# " CONFIG_OPTION_UNCACHE_MAINTENANCE_DATA " = false"                       NL
+""                                                                           NL
+"[" CONFIG_SECTION_VERIFICATION "]"                                          NL
+"### Fulltexts reconstructed from their delta representations are"           NL
+"### normally verified against the MD5 sum recorded at commit time."         NL
+"### On hosts whose repository contents are known to be good, e.g."          NL
+"### read-only replicas fed from a verified master, this re-verification"    NL
+"### mostly burns CPU.  Setting verify-sample-rate to N makes only about"    NL
+"### one in N reconstructions verify its checksum; 0 disables read-time"     NL
+"### verification entirely.  Fulltexts that are about to be stored in a"     NL
+"### fulltext cache are always verified, so caches never serve unchecked"    NL
+"### data.  Do not raise this value on repositories that accept commits"     NL
+"### or whose storage you do not fully trust."                               NL
+"### verify-sample-rate is 1 by default, i.e. every read is verified."       NL
+"# " CONFIG_OPTION_VERIFY_SAMPLE_RATE " = 1"                                 NL
 ""                                                                           NL
 "[" CONFIG_SECTION_DEBUG "]"                                                 NL
 "###"                                                                        NL
@@ -1167,6 +1319,7 @@ static svn_error_t *
 read_global_config(svn_fs_t *fs)
 {
   fs_fs_data_t *ffd = fs->fsap_data;
+  const char *pack_threads_str;
 
   ffd->use_block_read = svn_hash__get_bool(fs->config,
                                            SVN_FS_CONFIG_FSFS_BLOCK_READ,
@@ -1175,6 +1328,17 @@ read_global_config(svn_fs_t *fs)
                                            SVN_FS_CONFIG_NO_FLUSH_TO_DISK,
                                            FALSE);
 
+  ffd->pack_threads = 0;
+  pack_threads_str = svn_hash_gets(fs->config,
+                                   SVN_FS_CONFIG_FSFS_PACK_THREADS);
+  if (pack_threads_str)
+    {
+      apr_int64_t val;
+      SVN_ERR(svn_cstring_strtoi64(&val, pack_threads_str, 0, 1024, 10));
+
+      ffd->pack_threads = (apr_size_t)val;
+    }
+
   /* Ignore the user-specified larger block size if we don't use block-read.
      Defaulting to 4k gives us the same access granularity in format 7 as in
      older formats. */
@@ -1655,6 +1819,28 @@ svn_fs_fs__prop_rep_equal(svn_boolean_t *equal,
       return SVN_NO_ERROR;
     }
 
+  /* If both property lists are in cache, their content digests may tell
+     them apart without deserializing either list.  Equal digests prove
+     nothing, though, so those still take the deep comparison below. */
+  if (rep_a && rep_b)
+    {
+      apr_uint64_t digest_a, digest_b;
+      svn_boolean_t found_a, found_b;
+
+      SVN_ERR(svn_fs_fs__get_cached_proplist_digest(&digest_a, &found_a,
+                                                    fs, a, scratch_pool));
+      if (found_a)
+        {
+          SVN_ERR(svn_fs_fs__get_cached_proplist_digest(&digest_b, &found_b,
+                                                        fs, b, scratch_pool));
+          if (found_b && digest_a != digest_b)
+            {
+              *equal = FALSE;
+              return SVN_NO_ERROR;
+            }
+        }
+    }
+
   /* At least one of the reps has been modified in a txn.
      Fetch and compare them. */
   SVN_ERR(svn_fs_fs__get_proplist(&proplist_a, fs, a, scratch_pool));
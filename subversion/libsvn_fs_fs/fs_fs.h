@@ -319,6 +319,29 @@ svn_fs_fs__get_stats(svn_fs_fs__stats_t **stats,
                      apr_pool_t *result_pool,
                      apr_pool_t *scratch_pool);
 
+/* Same as svn_fs_fs__get_stats() but only scan revisions START_REVISION
+ * through HEAD, e.g. to incrementally update previously gathered stats.
+ * Pass 0 for a full scan.  If START_REVISION lies within the packed part
+ * of the repository, it is rounded down to the pack file boundary.
+ *
+ * Note that references from scanned revisions to representations in
+ * earlier revisions are not followed: such shared reps do not show up
+ * in the result at all and delta chains reaching across the range
+ * boundary are counted with length 2.  Most aggregates (sizes, counts,
+ * histograms) are additive across disjoint ranges, but rep-sharing and
+ * delta chain figures are only exact for full scans.
+ */
+svn_error_t *
+svn_fs_fs__get_stats_range(svn_fs_fs__stats_t **stats,
+                           svn_fs_t *fs,
+                           svn_revnum_t start_revision,
+                           svn_fs_progress_notify_func_t progress_func,
+                           void *progress_baton,
+                           svn_cancel_func_t cancel_func,
+                           void *cancel_baton,
+                           apr_pool_t *result_pool,
+                           apr_pool_t *scratch_pool);
+
 /* Read the P2L index for the rev / pack file containing REVISION in FS.
  * For each index entry, invoke CALLBACK_FUNC with CALLBACK_BATON.
  * If not NULL, call CANCEL_FUNC with CANCEL_BATON from time to time.
@@ -334,6 +357,32 @@ svn_fs_fs__dump_index(svn_fs_t *fs,
                       apr_pool_t *scratch_pool);
 
 
+/* Rewrite the indexes of all rev / pack files in FS containing revisions
+ * START_REV through END_REV.  For each file, read the existing P2L index
+ * and rebuild both index blocks from it, using the index page sizes given
+ * by the current FS configuration - e.g. to re-densify the L2P index after
+ * a config change or format upgrade.  Pass 0 / SVN_INVALID_REVNUM to cover
+ * the full repository.  If START_REV lies within the packed part of the
+ * repository, it is rounded down to the pack file boundary.
+ *
+ * Report progress through PROGRESS_FUNC with PROGRESS_BATON, if
+ * PROGRESS_FUNC is not NULL.  If not NULL, call CANCEL_FUNC with
+ * CANCEL_BATON from time to time.  Use SCRATCH_POOL for temporaries.
+ *
+ * The files in the range must not be accessed by any other process while
+ * this runs.  Rev / pack files are independent of each other, so disjoint
+ * revision ranges may be processed by concurrent *processes*.
+ */
+svn_error_t *
+svn_fs_fs__rebuild_index(svn_fs_t *fs,
+                         svn_revnum_t start_rev,
+                         svn_revnum_t end_rev,
+                         svn_fs_progress_notify_func_t progress_func,
+                         void *progress_baton,
+                         svn_cancel_func_t cancel_func,
+                         void *cancel_baton,
+                         apr_pool_t *scratch_pool);
+
 /* Rewrite the respective index information of the rev / pack file in FS
  * containing REVISION and use the svn_fs_fs__p2l_entry_t * array ENTRIES
  * as the new index contents.  Allocate temporaries from SCRATCH_POOL.
@@ -0,0 +1,138 @@
+/* fulltext-cache.c --- on-disk fulltext cache for FSFS
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <string.h>
+
+#include "svn_checksum.h"
+#include "svn_dirent_uri.h"
+#include "svn_io.h"
+#include "svn_pools.h"
+
+#include "private/svn_subr_private.h"
+
+#include "fulltext-cache.h"
+
+/* Set *PATH to the file where the fulltext addressed by the SHA1 checksum
+   in REP is (or would be) stored in FS's on-disk fulltext cache.
+   Allocate the result in RESULT_POOL. */
+static svn_error_t *
+get_fulltext_path(const char **path,
+                  svn_fs_t *fs,
+                  const representation_t *rep,
+                  apr_pool_t *result_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  svn_checksum_t *checksum
+    = svn_checksum__from_digest_sha1(rep->sha1_digest, result_pool);
+  const char *hex = svn_checksum_to_cstring_display(checksum, result_pool);
+
+  /* Shard the cache directory by the first two hex digits to keep the
+     number of entries per directory manageable. */
+  *path = svn_dirent_join_many(result_pool, ffd->fulltext_cache_dir,
+                               apr_pstrndup(result_pool, hex, 2), hex + 2,
+                               SVN_VA_NULL);
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_fs_fs__fulltext_cache_lookup(svn_stringbuf_t **fulltext,
+                                 svn_fs_t *fs,
+                                 const representation_t *rep,
+                                 apr_pool_t *result_pool,
+                                 apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  const char *path;
+  svn_stringbuf_t *contents;
+  svn_error_t *err;
+
+  *fulltext = NULL;
+  if (ffd->fulltext_cache_dir == NULL || !rep->has_sha1)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(get_fulltext_path(&path, fs, rep, scratch_pool));
+
+  err = svn_stringbuf_from_file2(&contents, path, result_pool);
+  if (err)
+    {
+      /* Typically, a cache miss.  Anything else is a cache malfunction
+         that we may safely ignore - we can always reconstruct the
+         fulltext from the deltas. */
+      svn_error_clear(err);
+      return SVN_NO_ERROR;
+    }
+
+  /* Callers deliver cache hits without running them through the usual
+     MD5 check, so guard against truncated, damaged or manipulated cache
+     entries here.  Treat any deviation as a cache miss; we can always
+     reconstruct the fulltext from the deltas. */
+  if (contents->len == rep->expanded_size)
+    {
+      svn_checksum_t *actual;
+
+      SVN_ERR(svn_checksum(&actual, svn_checksum_sha1, contents->data,
+                           contents->len, scratch_pool));
+      if (memcmp(actual->digest, rep->sha1_digest,
+                 APR_SHA1_DIGESTSIZE) == 0)
+        *fulltext = contents;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_fs_fs__fulltext_cache_store(svn_fs_t *fs,
+                                const representation_t *rep,
+                                const svn_stringbuf_t *fulltext,
+                                apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  const char *path;
+  svn_node_kind_t kind;
+  svn_error_t *err;
+
+  if (ffd->fulltext_cache_dir == NULL || !rep->has_sha1)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(get_fulltext_path(&path, fs, rep, scratch_pool));
+
+  /* An identical SHA1 implies identical contents, so an existing entry
+     never needs to be replaced.  Since we write entries atomically, a
+     concurrent writer racing us on the same entry is harmless as well. */
+  err = svn_io_check_path(path, &kind, scratch_pool);
+  if (!err && kind == svn_node_none)
+    {
+      err = svn_io_make_dir_recursively(svn_dirent_dirname(path,
+                                                           scratch_pool),
+                                        scratch_pool);
+      if (!err)
+        err = svn_io_write_atomic2(path, fulltext->data, fulltext->len,
+                                   NULL, FALSE, scratch_pool);
+    }
+
+  /* The cache is strictly optional; a full disk etc. must not fail the
+     data read that produced FULLTEXT. */
+  svn_error_clear(err);
+
+  return SVN_NO_ERROR;
+}
@@ -0,0 +1,61 @@
+/* fulltext-cache.h : on-disk fulltext cache for FSFS
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#ifndef SVN_LIBSVN_FS_FS_FULLTEXT_CACHE_H
+#define SVN_LIBSVN_FS_FS_FULLTEXT_CACHE_H
+
+#include "svn_error.h"
+
+#include "fs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* If FS has been configured with an on-disk fulltext cache and that cache
+   contains the fulltext for REP, return it in *FULLTEXT, allocated in
+   RESULT_POOL.  Set *FULLTEXT to NULL, otherwise.  Because the cache is
+   strictly optional, misses and I/O problems are not reported as errors.
+   Use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_fs_fs__fulltext_cache_lookup(svn_stringbuf_t **fulltext,
+                                 svn_fs_t *fs,
+                                 const representation_t *rep,
+                                 apr_pool_t *result_pool,
+                                 apr_pool_t *scratch_pool);
+
+/* Add FULLTEXT as the contents of REP to FS's on-disk fulltext cache.
+   This is a no-op if the cache is disabled or if REP carries no SHA1
+   checksum.  I/O problems, e.g. a full disk, are swallowed because the
+   cache is strictly optional.  Use SCRATCH_POOL for temporary
+   allocations. */
+svn_error_t *
+svn_fs_fs__fulltext_cache_store(svn_fs_t *fs,
+                                const representation_t *rep,
+                                const svn_stringbuf_t *fulltext,
+                                apr_pool_t *scratch_pool);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SVN_LIBSVN_FS_FS_FULLTEXT_CACHE_H */
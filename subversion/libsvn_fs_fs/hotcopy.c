@@ -19,6 +19,7 @@
  *    under the License.
  * ====================================================================
  */
+#include "svn_hash.h"
 #include "svn_pools.h"
 #include "svn_path.h"
 #include "svn_dirent_uri.h"
@@ -276,11 +277,59 @@ hotcopy_copy_shard_file(svn_boolean_t *skipped_p,
   return SVN_NO_ERROR;
 }
 
+/* Read the dirent info for all entries of directory PATH into *DIRENTS,
+ * mapping entry names to svn_io_dirent2_t objects.  If PATH does not
+ * exist, set *DIRENTS to an empty hash.  Allocate the result in
+ * RESULT_POOL and use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+hotcopy_read_dirents(apr_hash_t **dirents,
+                     const char *path,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  svn_error_t *err = svn_io_get_dirents3(dirents, path, FALSE, result_pool,
+                                         scratch_pool);
+  if (err && APR_STATUS_IS_ENOENT(err->apr_err))
+    {
+      svn_error_clear(err);
+      *dirents = apr_hash_make(result_pool);
+    }
+  else
+    SVN_ERR(err);
+
+  return SVN_NO_ERROR;
+}
+
+/* Return TRUE if, according to the SRC_DIRENTS and DST_DIRENTS info
+ * gathered by hotcopy_read_dirents() for the respective directories,
+ * file NAME exists at the destination and does not differ from the
+ * source copy, i.e. copying it can be skipped.  Apply the same criteria
+ * as hotcopy_io_dir_file_copy(). */
+static svn_boolean_t
+hotcopy_dirent_up_to_date(apr_hash_t *src_dirents,
+                          apr_hash_t *dst_dirents,
+                          const char *name)
+{
+  const svn_io_dirent2_t *src_dirent = svn_hash_gets(src_dirents, name);
+  const svn_io_dirent2_t *dst_dirent = svn_hash_gets(dst_dirents, name);
+
+  if (src_dirent == NULL || dst_dirent == NULL)
+    return FALSE;
+
+  return src_dirent->kind == dst_dirent->kind
+         && src_dirent->special == dst_dirent->special
+         && src_dirent->filesize == dst_dirent->filesize
+         && src_dirent->mtime <= dst_dirent->mtime;
+}
+
 
 /* Copy a packed shard containing revision REV, and which contains
  * MAX_FILES_PER_DIR revisions, from SRC_FS to DST_FS.
  * Update *DST_MIN_UNPACKED_REV in case the shard is new in DST_FS.
- * Do not re-copy data which already exists in DST_FS.
+ * Do not re-copy data which already exists in DST_FS.  If SKIP_REV_PACK
+ * is set, assume that the (immutable) revision pack already exists at
+ * the destination and only deal with the revprops, which may still
+ * change after packing.
  * Set *SKIPPED_P to FALSE only if at least one part of the shard
  * was copied, do not change the value in *SKIPPED_P otherwise.
  * SKIPPED_P may be NULL if not required.
@@ -292,6 +341,7 @@ hotcopy_copy_packed_shard(svn_boolean_t *skipped_p,
                           svn_fs_t *dst_fs,
                           svn_revnum_t rev,
                           int max_files_per_dir,
+                          svn_boolean_t skip_rev_pack,
                           apr_pool_t *scratch_pool)
 {
   const char *src_subdir;
@@ -309,11 +359,13 @@ hotcopy_copy_packed_shard(svn_boolean_t *skipped_p,
                               rev / max_files_per_dir);
   src_subdir_packed_shard = svn_dirent_join(src_subdir, packed_shard,
                                             scratch_pool);
-  SVN_ERR(hotcopy_io_copy_dir_recursively(skipped_p, src_subdir_packed_shard,
-                                          dst_subdir, packed_shard,
-                                          TRUE /* copy_perms */,
-                                          NULL /* cancel_func */, NULL,
-                                          scratch_pool));
+  if (!skip_rev_pack)
+    SVN_ERR(hotcopy_io_copy_dir_recursively(skipped_p,
+                                            src_subdir_packed_shard,
+                                            dst_subdir, packed_shard,
+                                            TRUE /* copy_perms */,
+                                            NULL /* cancel_func */, NULL,
+                                            scratch_pool));
 
   /* Copy revprops belonging to revisions in this pack. */
   src_subdir = svn_dirent_join(src_fs->path, PATH_REVPROPS_DIR, scratch_pool);
@@ -322,14 +374,37 @@ hotcopy_copy_packed_shard(svn_boolean_t *skipped_p,
   if (   src_ffd->format < SVN_FS_FS__MIN_PACKED_REVPROP_FORMAT
       || src_ffd->min_unpacked_rev < rev + max_files_per_dir)
     {
-      /* copy unpacked revprops rev by rev */
+      /* copy unpacked revprops rev by rev.  Read the source and
+       * destination shard directories once and compare the dirent info
+       * instead of stat()ing each of the (usually unchanged) files
+       * individually. */
+      apr_hash_t *src_dirents;
+      apr_hash_t *dst_dirents;
+      const char *shard = apr_psprintf(scratch_pool, "%ld",
+                                       rev / max_files_per_dir);
+
+      SVN_ERR(hotcopy_read_dirents(&src_dirents,
+                                   svn_dirent_join(src_subdir, shard,
+                                                   scratch_pool),
+                                   scratch_pool, scratch_pool));
+      SVN_ERR(hotcopy_read_dirents(&dst_dirents,
+                                   svn_dirent_join(dst_subdir, shard,
+                                                   scratch_pool),
+                                   scratch_pool, scratch_pool));
+
       iterpool = svn_pool_create(scratch_pool);
       for (revprop_rev = rev;
            revprop_rev < rev + max_files_per_dir;
            revprop_rev++)
         {
+          const char *rev_name;
+
           svn_pool_clear(iterpool);
 
+          rev_name = apr_psprintf(iterpool, "%ld", revprop_rev);
+          if (hotcopy_dirent_up_to_date(src_dirents, dst_dirents, rev_name))
+            continue;
+
           SVN_ERR(hotcopy_copy_shard_file(skipped_p, src_subdir, dst_subdir,
                                           revprop_rev, max_files_per_dir,
                                           iterpool));
@@ -561,8 +636,14 @@ hotcopy_revisions(svn_fs_t *src_fs,
   int max_files_per_dir = src_ffd->max_files_per_dir;
   svn_revnum_t src_min_unpacked_rev;
   svn_revnum_t dst_min_unpacked_rev;
+  svn_revnum_t dst_initial_min_unpacked_rev;
   svn_revnum_t rev;
   apr_pool_t *iterpool;
+  apr_pool_t *shard_pool;
+  apr_hash_t *src_rev_dirents = NULL;
+  apr_hash_t *dst_rev_dirents = NULL;
+  apr_hash_t *src_revprop_dirents = NULL;
+  apr_hash_t *dst_revprop_dirents = NULL;
 
   /* Copy the min unpacked rev, and read its value. */
   if (src_ffd->format >= SVN_FS_FS__MIN_PACKED_FORMAT)
@@ -600,11 +681,19 @@ hotcopy_revisions(svn_fs_t *src_fs,
    * Copy the necessary rev files.
    */
 
+  /* Shards that the destination already considered packed before this
+   * run are immutable on both sides - only their revprops may still
+   * change.  Remember the initial destination state so frequent
+   * incremental runs don't re-scan the full packed history. */
+  dst_initial_min_unpacked_rev = dst_min_unpacked_rev;
+
   iterpool = svn_pool_create(pool);
   /* First, copy packed shards. */
   for (rev = 0; rev < src_min_unpacked_rev; rev += max_files_per_dir)
     {
       svn_boolean_t skipped = TRUE;
+      svn_boolean_t already_packed
+        = (rev + max_files_per_dir <= dst_initial_min_unpacked_rev);
       svn_revnum_t pack_end_rev;
 
       svn_pool_clear(iterpool);
@@ -616,6 +705,7 @@ hotcopy_revisions(svn_fs_t *src_fs,
       SVN_ERR(hotcopy_copy_packed_shard(&skipped, &dst_min_unpacked_rev,
                                         src_fs, dst_fs,
                                         rev, max_files_per_dir,
+                                        already_packed,
                                         iterpool));
 
       pack_end_rev = rev + max_files_per_dir - 1;
@@ -637,8 +727,10 @@ hotcopy_revisions(svn_fs_t *src_fs,
       if (notify_func && !skipped)
         notify_func(notify_baton, rev, pack_end_rev, iterpool);
 
-      /* Remove revision files which are now packed. */
-      if (incremental)
+      /* Remove revision files which are now packed.  If the shard had
+       * already been packed at the destination before this run, any
+       * leftovers have been cleaned up by a previous hotcopy. */
+      if (incremental && !already_packed)
         {
           SVN_ERR(hotcopy_remove_rev_files(dst_fs, rev,
                                            rev + max_files_per_dir,
@@ -652,12 +744,17 @@ hotcopy_revisions(svn_fs_t *src_fs,
 
       /* Now that all revisions have moved into the pack, the original
        * rev dir can be removed. */
-      SVN_ERR(remove_folder(svn_fs_fs__path_rev_shard(dst_fs, rev, iterpool),
-                            cancel_func, cancel_baton, iterpool));
-      if (rev > 0 && dst_ffd->format >= SVN_FS_FS__MIN_PACKED_REVPROP_FORMAT)
-        SVN_ERR(remove_folder(svn_fs_fs__path_revprops_shard(dst_fs, rev,
-                                                             iterpool),
-                              cancel_func, cancel_baton, iterpool));
+      if (!already_packed)
+        {
+          SVN_ERR(remove_folder(svn_fs_fs__path_rev_shard(dst_fs, rev,
+                                                          iterpool),
+                                cancel_func, cancel_baton, iterpool));
+          if (rev > 0
+              && dst_ffd->format >= SVN_FS_FS__MIN_PACKED_REVPROP_FORMAT)
+            SVN_ERR(remove_folder(svn_fs_fs__path_revprops_shard(dst_fs, rev,
+                                                                 iterpool),
+                                  cancel_func, cancel_baton, iterpool));
+        }
     }
 
   if (cancel_func)
@@ -668,15 +765,64 @@ hotcopy_revisions(svn_fs_t *src_fs,
 
   /* Now, copy pairs of non-packed revisions and revprop files.
    * If necessary, update 'current' after copying all files from a shard. */
+  shard_pool = svn_pool_create(pool);
   for (; rev <= src_youngest; rev++)
     {
       svn_boolean_t skipped = TRUE;
+      const char *rev_name;
 
       svn_pool_clear(iterpool);
 
       if (cancel_func)
         SVN_ERR(cancel_func(cancel_baton));
 
+      /* Whenever we enter a new shard, read the source and destination
+       * shard directories in one go.  Answering "is this file already
+       * up to date?" from the dirent info costs two directory scans per
+       * shard instead of four stat() calls per revision, keeping the
+       * cost of frequent incremental hotcopies proportional to the
+       * amount of new data rather than the size of the repository. */
+      if (src_rev_dirents == NULL
+          || (max_files_per_dir && rev % max_files_per_dir == 0))
+        {
+          const char *shard_name = max_files_per_dir
+                                 ? apr_psprintf(iterpool, "%ld",
+                                                rev / max_files_per_dir)
+                                 : NULL;
+          const char *src_shard = shard_name
+                                ? svn_dirent_join(src_revs_dir, shard_name,
+                                                  iterpool)
+                                : src_revs_dir;
+          const char *dst_shard = shard_name
+                                ? svn_dirent_join(dst_revs_dir, shard_name,
+                                                  iterpool)
+                                : dst_revs_dir;
+          const char *src_revprop_shard = shard_name
+                                        ? svn_dirent_join(src_revprops_dir,
+                                                          shard_name,
+                                                          iterpool)
+                                        : src_revprops_dir;
+          const char *dst_revprop_shard = shard_name
+                                        ? svn_dirent_join(dst_revprops_dir,
+                                                          shard_name,
+                                                          iterpool)
+                                        : dst_revprops_dir;
+
+          svn_pool_clear(shard_pool);
+          SVN_ERR(hotcopy_read_dirents(&src_rev_dirents, src_shard,
+                                       shard_pool, iterpool));
+          SVN_ERR(hotcopy_read_dirents(&dst_rev_dirents, dst_shard,
+                                       shard_pool, iterpool));
+          SVN_ERR(hotcopy_read_dirents(&src_revprop_dirents,
+                                       src_revprop_shard,
+                                       shard_pool, iterpool));
+          SVN_ERR(hotcopy_read_dirents(&dst_revprop_dirents,
+                                       dst_revprop_shard,
+                                       shard_pool, iterpool));
+        }
+
+      rev_name = apr_psprintf(iterpool, "%ld", rev);
+
       /* Copying non-packed revisions is racy in case the source repository is
        * being packed concurrently with this hotcopy operation. The race can
        * happen with FS formats prior to SVN_FS_FS__MIN_PACK_LOCK_FORMAT that
@@ -691,15 +837,19 @@ hotcopy_revisions(svn_fs_t *src_fs,
        * longer where we expect it to be). */
 
       /* Copy the rev file. */
-      SVN_ERR(hotcopy_copy_shard_file(&skipped,
-                                      src_revs_dir, dst_revs_dir, rev,
-                                      max_files_per_dir,
-                                      iterpool));
+      if (!hotcopy_dirent_up_to_date(src_rev_dirents, dst_rev_dirents,
+                                     rev_name))
+        SVN_ERR(hotcopy_copy_shard_file(&skipped,
+                                        src_revs_dir, dst_revs_dir, rev,
+                                        max_files_per_dir,
+                                        iterpool));
       /* Copy the revprop file. */
-      SVN_ERR(hotcopy_copy_shard_file(&skipped,
-                                      src_revprops_dir, dst_revprops_dir,
-                                      rev, max_files_per_dir,
-                                      iterpool));
+      if (!hotcopy_dirent_up_to_date(src_revprop_dirents,
+                                     dst_revprop_dirents, rev_name))
+        SVN_ERR(hotcopy_copy_shard_file(&skipped,
+                                        src_revprops_dir, dst_revprops_dir,
+                                        rev, max_files_per_dir,
+                                        iterpool));
 
       /* Whenever this revision did not previously exist in the destination,
        * checkpoint the progress via 'current' (do that once per full shard
@@ -716,6 +866,7 @@ hotcopy_revisions(svn_fs_t *src_fs,
       if (notify_func && !skipped)
         notify_func(notify_baton, rev, rev, iterpool);
     }
+  svn_pool_destroy(shard_pool);
   svn_pool_destroy(iterpool);
 
   /* We assume that all revisions were copied now, i.e. we didn't exit the
@@ -29,6 +29,7 @@
 #include "../libsvn_fs/fs-loader.h"
 #include "private/svn_temp_serializer.h"
 #include "private/svn_string_private.h"
+#include "private/svn_subr_private.h"
 
 
 typedef struct fs_fs__id_t
@@ -644,3 +645,79 @@ svn_fs_fs__id_deserialize(void *buffer, svn_fs_id_t **in_out)
   id->generic_id.fsap_data = id;
 }
 
+/* Utility function to write PART to the buffer P in packed format.
+ * Return the pointer to the first byte after the representation.
+ */
+static unsigned char *
+part_pack(unsigned char *p,
+          const svn_fs_fs__id_part_t *part)
+{
+  /* Encode the revision shifted by one such that SVN_INVALID_REVNUM
+   * maps to the single byte 0. */
+  p = svn__encode_uint(p, (apr_uint64_t)(part->revision + 1));
+  return svn__encode_uint(p, part->number);
+}
+
+/* Utility function to read PART from the packed representation at P,
+ * never reading at or beyond END.  Return the pointer to the first byte
+ * after the representation or NULL, if the data is malformed.
+ */
+static const unsigned char *
+part_unpack(svn_fs_fs__id_part_t *part,
+            const unsigned char *p,
+            const unsigned char *end)
+{
+  apr_uint64_t value;
+
+  p = svn__decode_uint(&value, p, end);
+  if (p == NULL)
+    return NULL;
+  part->revision = (svn_revnum_t)value - 1;
+
+  p = svn__decode_uint(&value, p, end);
+  if (p == NULL)
+    return NULL;
+  part->number = value;
+
+  return p;
+}
+
+unsigned char *
+svn_fs_fs__id_pack(unsigned char *p,
+                   const svn_fs_id_t *in)
+{
+  const fs_fs__id_t *id = (const fs_fs__id_t *)in;
+
+  p = part_pack(p, &id->private_id.node_id);
+  p = part_pack(p, &id->private_id.copy_id);
+  p = part_pack(p, &id->private_id.txn_id);
+  return part_pack(p, &id->private_id.rev_item);
+}
+
+const unsigned char *
+svn_fs_fs__id_unpack(const svn_fs_id_t **id_p,
+                     const unsigned char *p,
+                     const unsigned char *end,
+                     apr_pool_t *pool)
+{
+  fs_fs__id_t *id = apr_pcalloc(pool, sizeof(*id));
+
+  p = part_unpack(&id->private_id.node_id, p, end);
+  if (p)
+    p = part_unpack(&id->private_id.copy_id, p, end);
+  if (p)
+    p = part_unpack(&id->private_id.txn_id, p, end);
+  if (p)
+    p = part_unpack(&id->private_id.rev_item, p, end);
+
+  if (p == NULL)
+    return NULL;
+
+  id->generic_id.vtable = &id_vtable;
+  id->generic_id.fsap_data = id;
+
+  *id_p = (svn_fs_id_t *)id;
+
+  return p;
+}
+
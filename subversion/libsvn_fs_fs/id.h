@@ -156,6 +156,31 @@ void
 svn_fs_fs__id_deserialize(void *buffer,
                           svn_fs_id_t **id);
 
+/* Maximum number of bytes that svn_fs_fs__id_pack may write
+ * (8 7b/8b-encoded 64 bit integers). */
+#define SVN_FS_FS__PACKED_ID_MAX_LEN 80
+
+/**
+ * Write @a id into the buffer @a p using a compact format of up to
+ * #SVN_FS_FS__PACKED_ID_MAX_LEN bytes and return a pointer to the first
+ * byte after the packed representation.
+ */
+unsigned char *
+svn_fs_fs__id_pack(unsigned char *p,
+                   const svn_fs_id_t *id);
+
+/**
+ * Set @a *id_p to an id, allocated in @a pool, read from the packed
+ * representation starting at @a p and never reading at or beyond @a end.
+ * Return a pointer to the first byte after the packed representation or
+ * NULL, if the data is malformed.
+ */
+const unsigned char *
+svn_fs_fs__id_unpack(const svn_fs_id_t **id_p,
+                     const unsigned char *p,
+                     const unsigned char *end,
+                     apr_pool_t *pool);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
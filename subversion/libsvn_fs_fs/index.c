@@ -186,6 +186,10 @@ struct svn_fs_fs__packed_number_stream_t
   /* underlying data file containing the packed values */
   apr_file_t *file;
 
+  /* if not NULL, a read-only memory mapping of the whole data file.
+   * Reads will then be served from this buffer instead of FILE. */
+  const char *mmap_data;
+
   /* Offset within FILE at which the stream data starts
    * (i.e. which offset will reported as offset 0 by packed_stream_offset). */
   apr_off_t stream_start;
@@ -264,10 +268,21 @@ packed_stream_read(svn_fs_fs__packed_number_stream_t *stream)
   /* packed numbers are usually not aligned to MAX_NUMBER_PREFETCH blocks,
    * i.e. the last number has been incomplete (and not buffered in stream)
    * and need to be re-read.  Therefore, always correct the file pointer.
+   * With a memory-mapped file, there is no file pointer nor any block
+   * cache to align with - simply read from NEXT_OFFSET.
    */
-  SVN_ERR(svn_io_file_aligned_seek(stream->file, stream->block_size,
-                                   &block_start, stream->next_offset,
-                                   stream->pool));
+  if (stream->mmap_data)
+    {
+      block_start = stream->next_offset
+                  - (stream->next_offset % stream->block_size);
+      err = APR_SUCCESS;
+    }
+  else
+    {
+      SVN_ERR(svn_io_file_aligned_seek(stream->file, stream->block_size,
+                                       &block_start, stream->next_offset,
+                                       stream->pool));
+    }
 
   /* prefetch at least one number but, if feasible, don't cross block
    * boundaries.  This shall prevent jumping back and forth between two
@@ -283,10 +298,17 @@ packed_stream_read(svn_fs_fs__packed_number_stream_t *stream)
   bytes_read = (apr_size_t)MIN(bytes_read,
                                stream->stream_end - stream->next_offset);
 
-  err = apr_file_read(stream->file, buffer, &bytes_read);
-  if (err && !APR_STATUS_IS_EOF(err))
-    return stream_error_create(stream, err,
-      _("Can't read index file '%s' at offset 0x%s"));
+  if (stream->mmap_data)
+    {
+      memcpy(buffer, stream->mmap_data + stream->next_offset, bytes_read);
+    }
+  else
+    {
+      err = apr_file_read(stream->file, buffer, &bytes_read);
+      if (err && !APR_STATUS_IS_EOF(err))
+        return stream_error_create(stream, err,
+          _("Can't read index file '%s' at offset 0x%s"));
+    }
 
   /* if the last number is incomplete, trim it from the buffer */
   while (bytes_read > 0 && buffer[bytes_read-1] >= 0x80)
@@ -346,11 +368,14 @@ packed_stream_read(svn_fs_fs__packed_number_stream_t *stream)
 /* Create and open a packed number stream reading from offsets START to
  * END in FILE and return it in *STREAM.  Access the file in chunks of
  * BLOCK_SIZE bytes.  Expect the stream to be prefixed by STREAM_PREFIX.
+ * If MMAP_DATA is not NULL, it is a read-only memory mapping of the whole
+ * FILE and all reads will be served from it.
  * Allocate *STREAM in RESULT_POOL and use SCRATCH_POOL for temporaries.
  */
 static svn_error_t *
 packed_stream_open(svn_fs_fs__packed_number_stream_t **stream,
                    apr_file_t *file,
+                   const char *mmap_data,
                    apr_off_t start,
                    apr_off_t end,
                    const char *stream_prefix,
@@ -367,10 +392,17 @@ packed_stream_open(svn_fs_fs__packed_number_stream_t **stream,
   SVN_ERR_ASSERT(len < sizeof(buffer));
 
   /* Read the header prefix and compare it with the expected prefix */
-  SVN_ERR(svn_io_file_aligned_seek(file, block_size, NULL, start,
-                                   scratch_pool));
-  SVN_ERR(svn_io_file_read_full2(file, buffer, len, NULL, NULL,
-                                 scratch_pool));
+  if (mmap_data)
+    {
+      memcpy(buffer, mmap_data + start, len);
+    }
+  else
+    {
+      SVN_ERR(svn_io_file_aligned_seek(file, block_size, NULL, start,
+                                       scratch_pool));
+      SVN_ERR(svn_io_file_read_full2(file, buffer, len, NULL, NULL,
+                                     scratch_pool));
+    }
 
   if (strncmp(buffer, stream_prefix, len))
     return svn_error_createf(SVN_ERR_FS_INDEX_CORRUPTION, NULL,
@@ -383,6 +415,7 @@ packed_stream_open(svn_fs_fs__packed_number_stream_t **stream,
 
   result->pool = result_pool;
   result->file = file;
+  result->mmap_data = mmap_data;
   result->stream_start = start + len;
   result->stream_end = end;
 
@@ -417,6 +450,27 @@ packed_stream_get(apr_uint64_t *value,
   return SVN_NO_ERROR;
 }
 
+/* Return the number of values that can be read from STREAM without
+ * triggering a buffer refill, i.e. without any possibility of an error.
+ */
+static apr_size_t
+packed_stream_buffered(svn_fs_fs__packed_number_stream_t *stream)
+{
+  return stream->used - stream->current;
+}
+
+/* Return the next value from STREAM.  The caller must have verified
+ * through packed_stream_buffered() that the value is available in the
+ * stream buffer.  Unlike packed_stream_get(), this cannot fail, which
+ * allows tight loops to hoist the per-value error propagation out of
+ * the loop body.
+ */
+static APR_INLINE apr_uint64_t
+packed_stream_get_buffered(svn_fs_fs__packed_number_stream_t *stream)
+{
+  return stream->buffer[stream->current++].value;
+}
+
 /* Navigate STREAM to packed stream offset OFFSET.  There will be no checks
  * whether the given OFFSET is valid.
  */
@@ -947,6 +1001,7 @@ auto_open_l2p_index(svn_fs_fs__revision_file_t *rev_file,
       SVN_ERR(svn_fs_fs__auto_read_footer(rev_file));
       SVN_ERR(packed_stream_open(&rev_file->l2p_stream,
                                  rev_file->file,
+                                 rev_file->mmap_data,
                                  rev_file->l2p_offset,
                                  rev_file->p2l_offset,
                                  L2P_STREAM_PREFIX,
@@ -959,15 +1014,15 @@ auto_open_l2p_index(svn_fs_fs__revision_file_t *rev_file,
 }
 
 /* Read the header data structure of the log-to-phys index for REVISION
- * in FS and return it in *HEADER, allocated in RESULT_POOL.  Use REV_FILE
- * to access on-disk data.  Use SCRATCH_POOL for temporary allocations.
+ * in FS and return it in *HEADER, allocated in REV_FILE->POOL and kept
+ * in REV_FILE->L2P_HEADER.  Use REV_FILE to access on-disk data.  Use
+ * SCRATCH_POOL for temporary allocations.
  */
 static svn_error_t *
 get_l2p_header_body(l2p_header_t **header,
                     svn_fs_fs__revision_file_t *rev_file,
                     svn_fs_t *fs,
                     svn_revnum_t revision,
-                    apr_pool_t *result_pool,
                     apr_pool_t *scratch_pool)
 {
   fs_fs_data_t *ffd = fs->fsap_data;
@@ -975,7 +1030,7 @@ get_l2p_header_body(l2p_header_t **header,
   apr_size_t i;
   apr_size_t page, page_count;
   apr_off_t offset;
-  l2p_header_t *result = apr_pcalloc(result_pool, sizeof(*result));
+  l2p_header_t *result = apr_pcalloc(rev_file->pool, sizeof(*result));
   apr_size_t page_table_index;
   svn_revnum_t next_rev;
 
@@ -1024,10 +1079,10 @@ get_l2p_header_body(l2p_header_t **header,
 
   /* allocate the page tables */
   result->page_table
-    = apr_pcalloc(result_pool, page_count * sizeof(*result->page_table));
+    = apr_pcalloc(rev_file->pool, page_count * sizeof(*result->page_table));
   result->page_table_index
-    = apr_pcalloc(result_pool, (result->revision_count + 1)
-                             * sizeof(*result->page_table_index));
+    = apr_pcalloc(rev_file->pool, (result->revision_count + 1)
+                                * sizeof(*result->page_table_index));
 
   /* read per-revision page table sizes (i.e. number of pages per rev) */
   page_table_index = 0;
@@ -1077,7 +1132,8 @@ get_l2p_header_body(l2p_header_t **header,
       offset += result->page_table[page].size;
     }
 
-  /* return and cache the header */
+  /* keep the deserialized header with the rev file, return and cache it */
+  rev_file->l2p_header = result;
   *header = result;
   SVN_ERR(svn_cache__set(ffd->l2p_header_cache, &key, result, scratch_pool));
 
@@ -1170,31 +1226,6 @@ l2p_page_info_copy(l2p_page_info_baton_t *baton,
   return SVN_NO_ERROR;
 }
 
-/* Implement svn_cache__partial_getter_func_t: copy the data requested in
- * l2p_page_info_baton_t *BATON from l2p_header_t *DATA into the output
- * fields in *BATON.
- */
-static svn_error_t *
-l2p_page_info_access_func(void **out,
-                          const void *data,
-                          apr_size_t data_len,
-                          void *baton,
-                          apr_pool_t *result_pool)
-{
-  /* resolve all pointer values of in-cache data */
-  const l2p_header_t *header = data;
-  const l2p_page_table_entry_t *page_table
-    = svn_temp_deserializer__ptr(header,
-                                 (const void *const *)&header->page_table);
-  const apr_size_t *page_table_index
-    = svn_temp_deserializer__ptr(header,
-                           (const void *const *)&header->page_table_index);
-
-  /* copy the info */
-  return l2p_page_info_copy(baton, header, page_table, page_table_index,
-                            result_pool);
-}
-
 /* Get the page info requested in *BATON from FS and set the output fields
  * in *BATON.  Use REV_FILE for on-disk file access.
  * Use SCRATCH_POOL for temporary allocations.
@@ -1208,26 +1239,35 @@ get_l2p_page_info(l2p_page_info_baton_t *baton,
   fs_fs_data_t *ffd = fs->fsap_data;
   l2p_header_t *result;
   svn_boolean_t is_cached = FALSE;
-  void *dummy = NULL;
-
-  /* try to find the info in the cache */
   pair_cache_key_t key;
+
+  /* the deserialized header kept with REV_FILE is the fastest route */
+  if (rev_file->l2p_header)
+    {
+      result = rev_file->l2p_header;
+      return svn_error_trace(l2p_page_info_copy(baton, result,
+                                                result->page_table,
+                                                result->page_table_index,
+                                                scratch_pool));
+    }
+
+  /* try to find the header in the cache.  Fetch the full structure - we
+   * will need it for the next lookups on this file anyway. */
   key.revision = rev_file->start_revision;
   key.second = rev_file->is_packed;
-  SVN_ERR(svn_cache__get_partial((void**)&dummy, &is_cached,
-                                 ffd->l2p_header_cache, &key,
-                                 l2p_page_info_access_func, baton,
-                                 scratch_pool));
+  SVN_ERR(svn_cache__get((void**)&result, &is_cached,
+                         ffd->l2p_header_cache, &key, rev_file->pool));
   if (is_cached)
-    return SVN_NO_ERROR;
-
-  /* read from disk, cache and copy the result */
-  SVN_ERR(get_l2p_header_body(&result, rev_file, fs, baton->revision,
-                              scratch_pool, scratch_pool));
-  SVN_ERR(l2p_page_info_copy(baton, result, result->page_table,
-                             result->page_table_index, scratch_pool));
+    rev_file->l2p_header = result;
+  else
+    /* read from disk, cache and pin the result */
+    SVN_ERR(get_l2p_header_body(&result, rev_file, fs, baton->revision,
+                                scratch_pool));
 
-  return SVN_NO_ERROR;
+  return svn_error_trace(l2p_page_info_copy(baton, result,
+                                            result->page_table,
+                                            result->page_table_index,
+                                            scratch_pool));
 }
 
 /* Data request structure used by l2p_page_table_access_func.
@@ -1242,6 +1282,29 @@ typedef struct l2p_page_table_baton_t
   apr_array_header_t *pages;
 } l2p_page_table_baton_t;
 
+/* Copy the page table entries for REVISION from HEADER, with its pointer
+ * members given as PAGE_TABLE and PAGE_TABLE_INDEX, into PAGES.
+ */
+static void
+l2p_page_table_copy(apr_array_header_t *pages,
+                    const l2p_header_t *header,
+                    const l2p_page_table_entry_t *page_table,
+                    const apr_size_t *page_table_index,
+                    svn_revnum_t revision)
+{
+  apr_size_t rel_revision = revision - header->first_revision;
+  if (rel_revision < header->revision_count)
+    {
+      const l2p_page_table_entry_t *entry
+        = page_table + page_table_index[rel_revision];
+      const l2p_page_table_entry_t *last_entry
+        = page_table + page_table_index[rel_revision + 1];
+
+      for (; entry < last_entry; ++entry)
+        APR_ARRAY_PUSH(pages, l2p_page_table_entry_t) = *entry;
+    }
+}
+
 /* Implement svn_cache__partial_getter_func_t: copy the data requested in
  * l2p_page_baton_t *BATON from l2p_page_t *DATA into BATON->PAGES and *OUT.
  */
@@ -1263,18 +1326,8 @@ l2p_page_table_access_func(void **out,
                            (const void *const *)&header->page_table_index);
 
   /* copy the revision's page table into BATON */
-  apr_size_t rel_revision = table_baton->revision - header->first_revision;
-  if (rel_revision < header->revision_count)
-    {
-      const l2p_page_table_entry_t *entry
-        = page_table + page_table_index[rel_revision];
-      const l2p_page_table_entry_t *last_entry
-        = page_table + page_table_index[rel_revision + 1];
-
-      for (; entry < last_entry; ++entry)
-        APR_ARRAY_PUSH(table_baton->pages, l2p_page_table_entry_t)
-          = *entry;
-    }
+  l2p_page_table_copy(table_baton->pages, header, page_table,
+                      page_table_index, table_baton->revision);
 
   /* set output as a courtesy to the caller */
   *out = table_baton->pages;
@@ -1306,6 +1359,16 @@ get_l2p_page_table(apr_array_header_t *pages,
   key.second = rev_file->is_packed;
 
   apr_array_clear(pages);
+
+  /* the deserialized header kept with REV_FILE is the fastest route */
+  if (rev_file->l2p_header)
+    {
+      const l2p_header_t *header = rev_file->l2p_header;
+      l2p_page_table_copy(pages, header, header->page_table,
+                          header->page_table_index, revision);
+      return SVN_NO_ERROR;
+    }
+
   baton.revision = revision;
   baton.pages = pages;
   SVN_ERR(svn_cache__get_partial((void**)&pages, &is_cached,
@@ -1342,13 +1405,27 @@ get_l2p_page(l2p_page_t **page,
   result->offsets = apr_pcalloc(result_pool, result->entry_count
                                            * sizeof(*result->offsets));
 
-  /* read all page entries (offsets in rev file and container sub-items) */
-  for (i = 0; i < result->entry_count; ++i)
+  /* read all page entries (offsets in rev file and container sub-items).
+   * Errors can only occur when the stream buffer needs to be refilled,
+   * so process the entries in buffer-sized chunks and keep the innermost
+   * loop free of error propagation. */
+  for (i = 0; i < result->entry_count; )
     {
-      apr_uint64_t value = 0;
-      SVN_ERR(packed_stream_get(&value, rev_file->l2p_stream));
-      last_value += decode_int(value);
-      result->offsets[i] = last_value - 1;
+      apr_uint32_t k, chunk;
+
+      if (packed_stream_buffered(rev_file->l2p_stream) == 0)
+        SVN_ERR(packed_stream_read(rev_file->l2p_stream));
+
+      chunk = (apr_uint32_t)MIN(packed_stream_buffered(rev_file->l2p_stream),
+                                result->entry_count - i);
+      for (k = 0; k < chunk; ++k)
+        {
+          last_value += decode_int(packed_stream_get_buffered(
+                                     rev_file->l2p_stream));
+          result->offsets[i + k] = last_value - 1;
+        }
+
+      i += chunk;
     }
 
   /* After reading all page entries, the read cursor must have moved by
@@ -1676,32 +1753,40 @@ l2p_proto_index_lookup(apr_off_t *offset,
 
 /* Read the log-to-phys header info of the index covering REVISION from FS
  * and return it in *HEADER.  REV_FILE provides the pack / rev status.
- * Allocate *HEADER in RESULT_POOL, use SCRATCH_POOL for temporary
- * allocations.
+ * *HEADER will be allocated in REV_FILE->POOL and kept with REV_FILE for
+ * re-use.  Use SCRATCH_POOL for temporary allocations.
  */
 static svn_error_t *
 get_l2p_header(l2p_header_t **header,
                svn_fs_fs__revision_file_t *rev_file,
                svn_fs_t *fs,
                svn_revnum_t revision,
-               apr_pool_t *result_pool,
                apr_pool_t *scratch_pool)
 {
   fs_fs_data_t *ffd = fs->fsap_data;
   svn_boolean_t is_cached = FALSE;
-
-  /* first, try cache lookop */
   pair_cache_key_t key;
+
+  /* the deserialized header kept with REV_FILE is the fastest route */
+  if (rev_file->l2p_header)
+    {
+      *header = rev_file->l2p_header;
+      return SVN_NO_ERROR;
+    }
+
+  /* otherwise, try the header cache */
   key.revision = rev_file->start_revision;
   key.second = rev_file->is_packed;
   SVN_ERR(svn_cache__get((void**)header, &is_cached, ffd->l2p_header_cache,
-                         &key, result_pool));
+                         &key, rev_file->pool));
   if (is_cached)
-    return SVN_NO_ERROR;
+    {
+      rev_file->l2p_header = *header;
+      return SVN_NO_ERROR;
+    }
 
-  /* read from disk and cache the result */
-  SVN_ERR(get_l2p_header_body(header, rev_file, fs, revision, result_pool,
-                              scratch_pool));
+  /* read from disk, cache and pin the result */
+  SVN_ERR(get_l2p_header_body(header, rev_file, fs, revision, scratch_pool));
 
   return SVN_NO_ERROR;
 }
@@ -1723,8 +1808,7 @@ svn_fs_fs__l2p_get_max_ids(apr_array_header_t **max_ids,
   /* read index master data structure for the index covering START_REV */
   SVN_ERR(svn_fs_fs__open_pack_or_rev_file(&rev_file, fs, start_rev,
                                            header_pool, header_pool));
-  SVN_ERR(get_l2p_header(&header, rev_file, fs, start_rev, header_pool,
-                         header_pool));
+  SVN_ERR(get_l2p_header(&header, rev_file, fs, start_rev, header_pool));
   SVN_ERR(svn_fs_fs__close_revision_file(rev_file));
 
   /* Determine the length of the item index list for each rev.
@@ -1746,7 +1830,7 @@ svn_fs_fs__l2p_get_max_ids(apr_array_header_t **max_ids,
           SVN_ERR(svn_fs_fs__open_pack_or_rev_file(&rev_file, fs, revision,
                                                   header_pool, header_pool));
           SVN_ERR(get_l2p_header(&header, rev_file, fs, revision,
-                                 header_pool, header_pool));
+                                 header_pool));
           SVN_ERR(svn_fs_fs__close_revision_file(rev_file));
         }
 
@@ -1767,6 +1851,58 @@ svn_fs_fs__l2p_get_max_ids(apr_array_header_t **max_ids,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_fs_fs__l2p_get_offsets(apr_array_header_t **offsets,
+                           svn_fs_t *fs,
+                           svn_fs_fs__revision_file_t *rev_file,
+                           svn_revnum_t revision,
+                           apr_pool_t *result_pool,
+                           apr_pool_t *scratch_pool)
+{
+  l2p_header_t *header = NULL;
+  apr_size_t page_index;
+  apr_size_t first_page_index, last_page_index;
+  apr_uint64_t full_page_count;
+  apr_uint64_t item_count;
+  apr_pool_t *iterpool;
+
+  /* read index master data structure for the index covering REVISION */
+  SVN_ERR(get_l2p_header(&header, rev_file, fs, revision, scratch_pool));
+
+  /* select the page range for REVISION and determine the item count
+   * (the first N-1 index pages of a revision are always "full") */
+  first_page_index
+    = header->page_table_index[revision - header->first_revision];
+  last_page_index
+    = header->page_table_index[revision - header->first_revision + 1];
+  full_page_count = last_page_index - first_page_index - 1;
+  item_count = full_page_count * header->page_size
+             + header->page_table[last_page_index - 1].entry_count;
+
+  *offsets = apr_array_make(result_pool, (int)item_count,
+                            sizeof(apr_off_t));
+
+  /* read the index pages sequentially and expand them into *OFFSETS */
+  iterpool = svn_pool_create(scratch_pool);
+  for (page_index = first_page_index;
+       page_index < last_page_index;
+       ++page_index)
+    {
+      l2p_page_t *page = NULL;
+      apr_uint32_t i;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(get_l2p_page(&page, rev_file, fs, header->first_revision,
+                           &header->page_table[page_index], iterpool));
+
+      for (i = 0; i < page->entry_count; ++i)
+        APR_ARRAY_PUSH(*offsets, apr_off_t) = (apr_off_t)page->offsets[i];
+    }
+
+  svn_pool_destroy(iterpool);
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_fs_fs__item_offset(apr_off_t *absolute_position,
                        svn_fs_t *fs,
@@ -2139,6 +2275,7 @@ auto_open_p2l_index(svn_fs_fs__revision_file_t *rev_file,
       SVN_ERR(svn_fs_fs__auto_read_footer(rev_file));
       SVN_ERR(packed_stream_open(&rev_file->p2l_stream,
                                  rev_file->file,
+                                 rev_file->mmap_data,
                                  rev_file->p2l_offset,
                                  rev_file->footer_offset,
                                  P2L_STREAM_PREFIX,
@@ -2152,15 +2289,15 @@ auto_open_p2l_index(svn_fs_fs__revision_file_t *rev_file,
 
 
 /* Read the header data structure of the phys-to-log index for REVISION in
- * FS and return it in *HEADER, allocated in RESULT_POOL. Use REV_FILE to
- * access on-disk data.  Use SCRATCH_POOL for temporary allocations.
+ * FS and return it in *HEADER, allocated in REV_FILE->POOL and kept with
+ * REV_FILE for re-use.  Use REV_FILE to access on-disk data.  Use
+ * SCRATCH_POOL for temporary allocations.
  */
 static svn_error_t *
 get_p2l_header(p2l_header_t **header,
                svn_fs_fs__revision_file_t *rev_file,
                svn_fs_t *fs,
                svn_revnum_t revision,
-               apr_pool_t *result_pool,
                apr_pool_t *scratch_pool)
 {
   fs_fs_data_t *ffd = fs->fsap_data;
@@ -2169,16 +2306,26 @@ get_p2l_header(p2l_header_t **header,
   apr_off_t offset;
   p2l_header_t *result;
   svn_boolean_t is_cached = FALSE;
+  pair_cache_key_t key;
+
+  /* the deserialized header kept with REV_FILE is the fastest route */
+  if (rev_file->p2l_header)
+    {
+      *header = rev_file->p2l_header;
+      return SVN_NO_ERROR;
+    }
 
   /* look for the header data in our cache */
-  pair_cache_key_t key;
   key.revision = rev_file->start_revision;
   key.second = rev_file->is_packed;
 
   SVN_ERR(svn_cache__get((void**)header, &is_cached, ffd->p2l_header_cache,
-                         &key, result_pool));
+                         &key, rev_file->pool));
   if (is_cached)
-    return SVN_NO_ERROR;
+    {
+      rev_file->p2l_header = *header;
+      return SVN_NO_ERROR;
+    }
 
   /* not found -> must read it from disk.
    * Open index file or position read pointer to the begin of the file */
@@ -2188,7 +2335,7 @@ get_p2l_header(p2l_header_t **header,
     packed_stream_seek(rev_file->p2l_stream, 0);
 
   /* allocate result data structure */
-  result = apr_pcalloc(result_pool, sizeof(*result));
+  result = apr_pcalloc(rev_file->pool, sizeof(*result));
 
   /* Read table sizes, check them for plausibility and allocate page array. */
   SVN_ERR(packed_stream_get(&value, rev_file->p2l_stream));
@@ -2216,7 +2363,8 @@ get_p2l_header(p2l_header_t **header,
                    _("P2L page count does not match rev / pack file size"));
 
   result->offsets
-    = apr_pcalloc(result_pool, (result->page_count + 1) * sizeof(*result->offsets));
+    = apr_pcalloc(rev_file->pool,
+                  (result->page_count + 1) * sizeof(*result->offsets));
 
   /* read page sizes and derive page description offsets from them */
   result->offsets[0] = 0;
@@ -2234,7 +2382,8 @@ get_p2l_header(p2l_header_t **header,
   /* cache the header data */
   SVN_ERR(svn_cache__set(ffd->p2l_header_cache, &key, result, scratch_pool));
 
-  /* return the result */
+  /* keep the deserialized header with the rev file and return it */
+  rev_file->p2l_header = result;
   *header = result;
 
   return SVN_NO_ERROR;
@@ -2308,27 +2457,6 @@ p2l_page_info_copy(p2l_page_info_baton_t *baton,
   baton->page_count = header->page_count;
 }
 
-/* Implement svn_cache__partial_getter_func_t: extract the p2l page info
- * requested by BATON and return it in BATON.
- */
-static svn_error_t *
-p2l_page_info_func(void **out,
-                   const void *data,
-                   apr_size_t data_len,
-                   void *baton,
-                   apr_pool_t *result_pool)
-{
-  /* all the pointers to cached data we need */
-  const p2l_header_t *header = data;
-  const apr_off_t *offsets
-    = svn_temp_deserializer__ptr(header,
-                                 (const void *const *)&header->offsets);
-
-  /* copy data from cache to BATON */
-  p2l_page_info_copy(baton, header, offsets);
-  return SVN_NO_ERROR;
-}
-
 /* Read the header data structure of the phys-to-log index for revision
  * BATON->REVISION in FS.  Return in *BATON all info relevant to read the
  * index page for the rev / pack file offset BATON->OFFSET.  Use REV_FILE
@@ -2340,24 +2468,11 @@ get_p2l_page_info(p2l_page_info_baton_t *baton,
                   svn_fs_t *fs,
                   apr_pool_t *scratch_pool)
 {
-  fs_fs_data_t *ffd = fs->fsap_data;
   p2l_header_t *header;
-  svn_boolean_t is_cached = FALSE;
-  void *dummy = NULL;
-
-  /* look for the header data in our cache */
-  pair_cache_key_t key;
-  key.revision = rev_file->start_revision;
-  key.second = rev_file->is_packed;
-
-  SVN_ERR(svn_cache__get_partial(&dummy, &is_cached, ffd->p2l_header_cache,
-                                 &key, p2l_page_info_func, baton,
-                                 scratch_pool));
-  if (is_cached)
-    return SVN_NO_ERROR;
 
+  /* get the header, preferably the deserialized copy kept with REV_FILE */
   SVN_ERR(get_p2l_header(&header, rev_file, fs, baton->revision,
-                         scratch_pool, scratch_pool));
+                         scratch_pool));
 
   /* copy the requested info into *BATON */
   p2l_page_info_copy(baton, header, header->offsets);
@@ -3026,23 +3141,6 @@ svn_fs_fs__p2l_entry_lookup(svn_fs_fs__p2l_entry_t **entry_p,
   return SVN_NO_ERROR;
 }
 
-/* Implements svn_cache__partial_getter_func_t for P2L headers, setting *OUT
- * to the largest the first offset not covered by this P2L index.
- */
-static svn_error_t *
-p2l_get_max_offset_func(void **out,
-                        const void *data,
-                        apr_size_t data_len,
-                        void *baton,
-                        apr_pool_t *result_pool)
-{
-  const p2l_header_t *header = data;
-  apr_off_t max_offset = header->file_size;
-  *out = apr_pmemdup(result_pool, &max_offset, sizeof(max_offset));
-
-  return SVN_NO_ERROR;
-}
-
 /* Core functionality of to svn_fs_fs__p2l_get_max_offset with identical
  * signature. */
 static svn_error_t *
@@ -3052,28 +3150,10 @@ p2l_get_max_offset(apr_off_t *offset,
                    svn_revnum_t revision,
                    apr_pool_t *scratch_pool)
 {
-  fs_fs_data_t *ffd = fs->fsap_data;
   p2l_header_t *header;
-  svn_boolean_t is_cached = FALSE;
-  apr_off_t *offset_p;
 
-  /* look for the header data in our cache */
-  pair_cache_key_t key;
-  key.revision = rev_file->start_revision;
-  key.second = rev_file->is_packed;
-
-  SVN_ERR(svn_cache__get_partial((void **)&offset_p, &is_cached,
-                                 ffd->p2l_header_cache, &key,
-                                 p2l_get_max_offset_func, NULL,
-                                 scratch_pool));
-  if (is_cached)
-    {
-      *offset = *offset_p;
-      return SVN_NO_ERROR;
-    }
-
-  SVN_ERR(get_p2l_header(&header, rev_file, fs, revision, scratch_pool,
-                         scratch_pool));
+  /* get the header, preferably the deserialized copy kept with REV_FILE */
+  SVN_ERR(get_p2l_header(&header, rev_file, fs, revision, scratch_pool));
   *offset = header->file_size;
 
   return SVN_NO_ERROR;
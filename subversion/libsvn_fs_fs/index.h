@@ -214,6 +214,21 @@ svn_fs_fs__l2p_get_max_ids(apr_array_header_t **max_ids,
                            apr_pool_t *result_pool,
                            apr_pool_t *scratch_pool);
 
+/* Use the log-to-phys index in FS to determine the rev / pack file
+ * offsets of all items in REVISION.  Return them as an array of
+ * apr_off_t, indexed by item index, in *OFFSETS, allocated in
+ * RESULT_POOL.  Offsets will be -1 for unused item index values.
+ * The index pages are read sequentially from REV_FILE, bypassing the
+ * page caches.  Use SCRATCH_POOL for temporary allocations.
+ */
+svn_error_t *
+svn_fs_fs__l2p_get_offsets(apr_array_header_t **offsets,
+                           svn_fs_t *fs,
+                           svn_fs_fs__revision_file_t *rev_file,
+                           svn_revnum_t revision,
+                           apr_pool_t *result_pool,
+                           apr_pool_t *scratch_pool);
+
 /* In *OFFSET, return the last OFFSET in the pack / rev file containing.
  * REV_FILE determines whether to access single rev or pack file data.
  * If that is not available anymore (neither in cache nor on disk), re-open
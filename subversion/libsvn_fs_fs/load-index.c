@@ -93,6 +93,99 @@ compare_p2l_entry_revision(const void *lhs,
   return lhs_entry->offset == rhs_entry->offset ? 0 : 1;
 }
 
+/* Baton type to be used with collect_entry. */
+typedef struct collect_entries_baton_t
+{
+  /* Array of svn_fs_fs__p2l_entry_t *, one element per index entry. */
+  apr_array_header_t *entries;
+
+  /* Allocate the collected entries here - they must outlive the
+   * iteration that produces them. */
+  apr_pool_t *pool;
+} collect_entries_baton_t;
+
+/* Implements svn_fs_fs__dump_index_func_t.  Copy ENTRY into the entry
+ * list given as collect_entries_baton_t in BATON. */
+static svn_error_t *
+collect_entry(const svn_fs_fs__p2l_entry_t *entry,
+              void *baton,
+              apr_pool_t *scratch_pool)
+{
+  collect_entries_baton_t *b = baton;
+  APR_ARRAY_PUSH(b->entries, svn_fs_fs__p2l_entry_t *)
+    = apr_pmemdup(b->pool, entry, sizeof(*entry));
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_fs_fs__rebuild_index(svn_fs_t *fs,
+                         svn_revnum_t start_rev,
+                         svn_revnum_t end_rev,
+                         svn_fs_progress_notify_func_t progress_func,
+                         void *progress_baton,
+                         svn_cancel_func_t cancel_func,
+                         void *cancel_baton,
+                         apr_pool_t *scratch_pool)
+{
+  svn_revnum_t head, min_unpacked_rev, revision;
+  int shard_size;
+  apr_pool_t *iterpool;
+
+  /* Check the FS format number. */
+  if (! svn_fs_fs__use_log_addressing(fs))
+    return svn_error_create(SVN_ERR_FS_UNSUPPORTED_FORMAT, NULL, NULL);
+
+  /* Determine the range of rev / pack files to process. */
+  SVN_ERR(svn_fs_fs__youngest_rev(&head, fs, scratch_pool));
+  SVN_ERR(svn_fs_fs__min_unpacked_rev(&min_unpacked_rev, fs, scratch_pool));
+  shard_size = svn_fs_fs__shard_size(fs);
+
+  if (start_rev < 0)
+    start_rev = 0;
+  if (!SVN_IS_VALID_REVNUM(end_rev) || end_rev > head)
+    end_rev = head;
+
+  /* Pack files can only be re-indexed as a whole.
+   * Round down to the pack file boundary. */
+  if (start_rev < min_unpacked_rev)
+    start_rev -= start_rev % shard_size;
+
+  /* Process the rev / pack files one at a time. */
+  iterpool = svn_pool_create(scratch_pool);
+  for (revision = start_rev; revision <= end_rev; )
+    {
+      collect_entries_baton_t baton;
+
+      svn_pool_clear(iterpool);
+      if (cancel_func)
+        SVN_ERR(cancel_func(cancel_baton));
+
+      /* Read the existing index contents into memory ... */
+      baton.entries = apr_array_make(iterpool, 16, sizeof(void *));
+      baton.pool = iterpool;
+      SVN_ERR(svn_fs_fs__dump_index(fs, revision, collect_entry, &baton,
+                                    cancel_func, cancel_baton, iterpool));
+
+      /* ... and rewrite both index blocks from it.  The new indexes will
+       * use the page sizes given by the current FS configuration. */
+      SVN_ERR(svn_fs_fs__load_index(fs, revision, baton.entries, iterpool));
+
+      if (progress_func)
+        progress_func(revision, progress_baton, iterpool);
+
+      /* Next rev / pack file. */
+      if (revision < min_unpacked_rev)
+        revision += shard_size;
+      else
+        revision++;
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_fs_fs__load_index(svn_fs_t *fs,
                       svn_revnum_t revision,
@@ -0,0 +1,57 @@
+/* lock-index-db.sql -- schema for the lock path index
+ *   This is intended for use with SQLite 3
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+-- STMT_CREATE_SCHEMA
+/* One row per locked path.  The lock data itself stays in the digest
+   files; the index only answers "which paths at or below X are locked"
+   via indexed range scans instead of one digest file per lock. */
+CREATE TABLE lock_index (
+  path TEXT NOT NULL PRIMARY KEY
+  ) WITHOUT ROWID;
+
+PRAGMA USER_VERSION = 1;
+
+-- STMT_ADD_LOCKED_PATH
+INSERT OR REPLACE INTO lock_index (path)
+VALUES (?1)
+
+-- STMT_DELETE_LOCKED_PATH
+DELETE FROM lock_index
+WHERE path = ?1
+
+-- STMT_SELECT_LOCKED_PATH
+SELECT path
+FROM lock_index
+WHERE path = ?1
+
+-- STMT_SELECT_LOCKS_BELOW_PATH
+/* All locked paths strictly below directory ?1.  ?2 must be ?1 with the
+   last character incremented, which together with the trailing '/' on ?1
+   forms a half-open prefix range. */
+SELECT path
+FROM lock_index
+WHERE path > ?1 AND path < ?2
+ORDER BY path
+
+-- STMT_DELETE_ALL
+DELETE FROM lock_index
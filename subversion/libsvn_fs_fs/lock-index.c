@@ -0,0 +1,320 @@
+/* lock-index.c --- the lock path index for fsfs
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include "svn_pools.h"
+#include "svn_dirent_uri.h"
+
+#include "svn_private_config.h"
+
+#include "fs_fs.h"
+#include "fs.h"
+#include "lock.h"
+#include "lock-index.h"
+#include "util.h"
+
+#include "private/svn_fspath.h"
+#include "private/svn_sqlite.h"
+
+#include "lock-index-db.h"
+
+LOCK_INDEX_DB_SQL_DECLARE_STATEMENTS(statements);
+
+
+
+/** Helper functions. **/
+static APR_INLINE const char *
+path_lock_index_db(const char *fs_path,
+                   apr_pool_t *result_pool)
+{
+  return svn_dirent_join(fs_path, LOCK_INDEX_DB_NAME, result_pool);
+}
+
+/* Open the lock index database of FS and return it in *SDB, creating it
+   if CREATE is set.  If the database does not exist and CREATE is not
+   set, return NULL in *SDB.  The handle is kept in the fs data and
+   remains valid until FS->pool is destroyed. */
+static svn_error_t *
+open_lock_index(svn_sqlite__db_t **sdb,
+                svn_fs_t *fs,
+                svn_boolean_t create,
+                apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  const char *db_path;
+  svn_node_kind_t kind;
+  int version;
+
+  if (ffd->lock_index_db)
+    {
+      *sdb = ffd->lock_index_db;
+      return SVN_NO_ERROR;
+    }
+
+  db_path = path_lock_index_db(fs->path, pool);
+  SVN_ERR(svn_io_check_path(db_path, &kind, pool));
+  if (kind == svn_node_none && !create)
+    {
+      *sdb = NULL;
+      return SVN_NO_ERROR;
+    }
+
+#ifndef WIN32
+  if (kind == svn_node_none)
+    {
+      /* We want to extend the permissions that apply to the repository
+         as a whole when creating the index and not simply default
+         to umask. */
+      const char *current = svn_fs_fs__path_current(fs, pool);
+      svn_error_t *err = svn_io_file_create_empty(db_path, pool);
+
+      if (err && !APR_STATUS_IS_EEXIST(err->apr_err))
+        /* A real error. */
+        return svn_error_trace(err);
+      else if (err)
+        /* Some other thread/process created the file. */
+        svn_error_clear(err);
+      else
+        /* We created the file. */
+        SVN_ERR(svn_io_copy_perms(current, db_path, pool));
+    }
+#endif
+
+  SVN_ERR(svn_sqlite__open(sdb, db_path,
+                           create ? svn_sqlite__mode_rwcreate
+                                  : svn_sqlite__mode_readwrite,
+                           statements, 0, NULL, 0,
+                           fs->pool, pool));
+
+  SVN_SQLITE__ERR_CLOSE(svn_sqlite__read_schema_version(&version, *sdb,
+                                                        pool),
+                        *sdb);
+  /* If we have an uninitialized database, go ahead and create the schema. */
+  if (version <= 0)
+    SVN_SQLITE__ERR_CLOSE(svn_sqlite__exec_statements(*sdb,
+                                                      STMT_CREATE_SCHEMA),
+                          *sdb);
+
+  ffd->lock_index_db = *sdb;
+
+  return SVN_NO_ERROR;
+}
+
+
+/** Building the index. **/
+
+/* Baton for build_callback(). */
+typedef struct build_baton_t
+{
+  svn_sqlite__db_t *sdb;
+  svn_cancel_func_t cancel_func;
+  void *cancel_baton;
+} build_baton_t;
+
+/* Implements svn_fs_get_locks_callback_t: insert LOCK's path into the
+   index in BATON->sdb. */
+static svn_error_t *
+build_callback(void *baton,
+               svn_lock_t *lock,
+               apr_pool_t *pool)
+{
+  build_baton_t *bb = baton;
+  svn_sqlite__stmt_t *stmt;
+
+  if (bb->cancel_func)
+    SVN_ERR(bb->cancel_func(bb->cancel_baton));
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, bb->sdb, STMT_ADD_LOCKED_PATH));
+  SVN_ERR(svn_sqlite__bindf(stmt, "s", lock->path));
+  SVN_ERR(svn_sqlite__step_done(stmt));
+
+  return SVN_NO_ERROR;
+}
+
+/* The effective arguments for build_body() below. */
+typedef struct build_body_baton_t
+{
+  svn_fs_t *fs;
+  svn_cancel_func_t cancel_func;
+  void *cancel_baton;
+} build_body_baton_t;
+
+/* Implements the svn_fs_fs__with_write_lock() 'body' callback type:
+   create the index database and re-populate it from the digest files. */
+static svn_error_t *
+build_body(void *baton, apr_pool_t *pool)
+{
+  build_body_baton_t *bbb = baton;
+  build_baton_t bb;
+  svn_error_t *err;
+
+  SVN_ERR(open_lock_index(&bb.sdb, bbb->fs, TRUE, pool));
+  bb.cancel_func = bbb->cancel_func;
+  bb.cancel_baton = bbb->cancel_baton;
+
+  /* Build the whole index as a single transaction; concurrent readers
+     either see the complete index or none at all. */
+  SVN_ERR(svn_sqlite__begin_transaction(bb.sdb));
+
+  err = svn_sqlite__exec_statements(bb.sdb, STMT_DELETE_ALL);
+  if (!err)
+    /* Pass FALSE for HAVE_WRITE_LOCK so that the walk does not try to
+       remove expired locks while our index transaction is open; they
+       are simply not reported and thus not indexed. */
+    err = svn_fs_fs__walk_digest_locks(bbb->fs, "/", build_callback, &bb,
+                                       FALSE, pool);
+
+  return svn_error_trace(svn_sqlite__finish_transaction(bb.sdb, err));
+}
+
+svn_error_t *
+svn_fs_fs__lock_index_build(svn_fs_t *fs,
+                            svn_cancel_func_t cancel_func,
+                            void *cancel_baton,
+                            apr_pool_t *pool)
+{
+  build_body_baton_t bbb;
+
+  bbb.fs = fs;
+  bbb.cancel_func = cancel_func;
+  bbb.cancel_baton = cancel_baton;
+
+  /* Take the write lock so that no locks are added or removed while we
+     read the digest tree. */
+  return svn_error_trace(svn_fs_fs__with_write_lock(fs, build_body, &bbb,
+                                                    pool));
+}
+
+
+/** Maintenance. **/
+
+/* Run STMT_IDX with each element of PATHS (const char *) bound as the
+   only parameter against the lock index of FS, as a single transaction.
+   Do nothing if the index does not exist. */
+static svn_error_t *
+run_for_paths(svn_fs_t *fs,
+              int stmt_idx,
+              apr_array_header_t *paths,
+              apr_pool_t *scratch_pool)
+{
+  svn_sqlite__db_t *sdb;
+  svn_error_t *err = SVN_NO_ERROR;
+  int i;
+
+  if (!paths->nelts)
+    return SVN_NO_ERROR;
+
+  /* The index is strictly opt-in: do nothing unless the administrator
+     created it with 'svnadmin build-lockindex'. */
+  SVN_ERR(open_lock_index(&sdb, fs, FALSE, scratch_pool));
+  if (!sdb)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_sqlite__begin_transaction(sdb));
+  for (i = 0; i < paths->nelts && !err; ++i)
+    {
+      const char *path = APR_ARRAY_IDX(paths, i, const char *);
+      svn_sqlite__stmt_t *stmt;
+
+      err = svn_sqlite__get_statement(&stmt, sdb, stmt_idx);
+      if (!err)
+        err = svn_sqlite__bindf(stmt, "s", path);
+      if (!err)
+        err = svn_sqlite__step_done(stmt);
+    }
+
+  return svn_error_trace(svn_sqlite__finish_transaction(sdb, err));
+}
+
+svn_error_t *
+svn_fs_fs__lock_index_add_paths(svn_fs_t *fs,
+                                apr_array_header_t *paths,
+                                apr_pool_t *scratch_pool)
+{
+  return svn_error_trace(run_for_paths(fs, STMT_ADD_LOCKED_PATH, paths,
+                                       scratch_pool));
+}
+
+svn_error_t *
+svn_fs_fs__lock_index_delete_paths(svn_fs_t *fs,
+                                   apr_array_header_t *paths,
+                                   apr_pool_t *scratch_pool)
+{
+  return svn_error_trace(run_for_paths(fs, STMT_DELETE_LOCKED_PATH, paths,
+                                       scratch_pool));
+}
+
+
+/** Queries. **/
+
+svn_error_t *
+svn_fs_fs__lock_index_get_subtree(apr_array_header_t **locked_paths,
+                                  svn_fs_t *fs,
+                                  const char *path,
+                                  apr_pool_t *result_pool,
+                                  apr_pool_t *scratch_pool)
+{
+  svn_sqlite__db_t *sdb;
+  svn_sqlite__stmt_t *stmt;
+  svn_boolean_t have_row;
+  const char *below_lower, *below_upper;
+  svn_stringbuf_t *upper_buf;
+
+  *locked_paths = NULL;
+
+  SVN_ERR(open_lock_index(&sdb, fs, FALSE, scratch_pool));
+  if (!sdb)
+    return SVN_NO_ERROR;
+
+  *locked_paths = apr_array_make(result_pool, 4, sizeof(const char *));
+
+  /* The path itself. */
+  SVN_ERR(svn_sqlite__get_statement(&stmt, sdb, STMT_SELECT_LOCKED_PATH));
+  SVN_ERR(svn_sqlite__bindf(stmt, "s", path));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+  if (have_row)
+    APR_ARRAY_PUSH(*locked_paths, const char *)
+      = apr_pstrdup(result_pool, svn_sqlite__column_text(stmt, 0, NULL));
+  SVN_ERR(svn_sqlite__reset(stmt));
+
+  /* Everything below it, via a half-open prefix range scan. */
+  below_lower = svn_fspath__is_root(path, strlen(path))
+                  ? path
+                  : apr_pstrcat(scratch_pool, path, "/", SVN_VA_NULL);
+  upper_buf = svn_stringbuf_create(below_lower, scratch_pool);
+  upper_buf->data[upper_buf->len - 1]++;   /* '/' becomes '0' */
+  below_upper = upper_buf->data;
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, sdb,
+                                    STMT_SELECT_LOCKS_BELOW_PATH));
+  SVN_ERR(svn_sqlite__bindf(stmt, "ss", below_lower, below_upper));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+  while (have_row)
+    {
+      APR_ARRAY_PUSH(*locked_paths, const char *)
+        = apr_pstrdup(result_pool, svn_sqlite__column_text(stmt, 0, NULL));
+
+      SVN_ERR(svn_sqlite__step(&have_row, stmt));
+    }
+  SVN_ERR(svn_sqlite__reset(stmt));
+
+  return SVN_NO_ERROR;
+}
@@ -0,0 +1,93 @@
+/* lock-index.h : interface to the lock path index
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#ifndef SVN_LIBSVN_FS_FS_LOCK_INDEX_H
+#define SVN_LIBSVN_FS_FS_LOCK_INDEX_H
+
+#include "svn_error.h"
+#include "svn_fs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+#define LOCK_INDEX_DB_NAME       "lock-index.db"
+
+/* The lock path index is an optional SQLite companion to the digest file
+   tree under db/locks: one row per locked path, answering subtree lock
+   queries with an indexed range scan instead of reading one digest file
+   per locked descendant.
+
+   The digest files remain the canonical lock store; a row without a
+   matching digest file merely means "not locked" to readers.  Writers
+   therefore add rows before writing lock files and remove lock files
+   before removing rows, mirroring the ordering used for the digest
+   children lists.  Once the index exists, all writers accessing the
+   repository must maintain it, so it is strictly opt-in via
+   'svnadmin build-lockindex'. */
+
+/* Create the lock path index database for FS if it does not exist yet
+   and (re-)populate it from the current digest file tree.  This takes
+   the FS write lock.  Use POOL for temporary allocations. */
+svn_error_t *
+svn_fs_fs__lock_index_build(svn_fs_t *fs,
+                            svn_cancel_func_t cancel_func,
+                            void *cancel_baton,
+                            apr_pool_t *pool);
+
+/* If the lock path index database exists for FS, add rows for all PATHS
+   (const char *, in canonical fspath form); otherwise, do nothing.  The
+   caller must hold the FS write lock.  Use SCRATCH_POOL for temporary
+   allocations. */
+svn_error_t *
+svn_fs_fs__lock_index_add_paths(svn_fs_t *fs,
+                                apr_array_header_t *paths,
+                                apr_pool_t *scratch_pool);
+
+/* If the lock path index database exists for FS, remove the rows for all
+   PATHS (const char *, in canonical fspath form); otherwise, do nothing.
+   The caller must hold the FS write lock.  Use SCRATCH_POOL for
+   temporary allocations. */
+svn_error_t *
+svn_fs_fs__lock_index_delete_paths(svn_fs_t *fs,
+                                   apr_array_header_t *paths,
+                                   apr_pool_t *scratch_pool);
+
+/* Set *LOCKED_PATHS to the paths at or below PATH (in canonical fspath
+   form) that have a row in the lock path index of FS, as const char *
+   elements in ascending order, allocated in RESULT_POOL.  Set
+   *LOCKED_PATHS to NULL if the index does not exist.  The result may
+   contain stale entries; callers must verify each path against its
+   digest file.  Use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_fs_fs__lock_index_get_subtree(apr_array_header_t **locked_paths,
+                                  svn_fs_t *fs,
+                                  const char *path,
+                                  apr_pool_t *result_pool,
+                                  apr_pool_t *scratch_pool);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SVN_LIBSVN_FS_FS_LOCK_INDEX_H */
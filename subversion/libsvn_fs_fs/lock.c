@@ -34,6 +34,7 @@
 #include <apr_file_info.h>
 
 #include "lock.h"
+#include "lock-index.h"
 #include "tree.h"
 #include "fs_fs.h"
 #include "util.h"
@@ -594,6 +595,85 @@ walk_locks(svn_fs_t *fs,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_fs_fs__walk_digest_locks(svn_fs_t *fs,
+                             const char *path,
+                             svn_fs_get_locks_callback_t get_locks_func,
+                             void *get_locks_baton,
+                             svn_boolean_t have_write_lock,
+                             apr_pool_t *pool)
+{
+  const char *digest_path;
+
+  path = svn_fs__canonicalize_abspath(path, pool);
+  SVN_ERR(digest_path_from_path(&digest_path, fs->path, path, pool));
+
+  return svn_error_trace(walk_locks(fs, digest_path, get_locks_func,
+                                    get_locks_baton, have_write_lock,
+                                    pool));
+}
+
+/* Like walk_locks(), but served from the lock path index.  Set *DONE to
+   TRUE if the index exists and the walk completed; FALSE means the
+   caller must fall back to walking the digest tree.  PATH is the
+   canonical fspath whose subtree to walk. */
+static svn_error_t *
+walk_locks_indexed(svn_boolean_t *done,
+                   svn_fs_t *fs,
+                   const char *path,
+                   svn_fs_get_locks_callback_t get_locks_func,
+                   void *get_locks_baton,
+                   svn_boolean_t have_write_lock,
+                   apr_pool_t *pool)
+{
+  apr_array_header_t *locked_paths;
+  apr_pool_t *subpool;
+  int i;
+
+  SVN_ERR(svn_fs_fs__lock_index_get_subtree(&locked_paths, fs, path,
+                                            pool, pool));
+  if (! locked_paths)
+    {
+      *done = FALSE;
+      return SVN_NO_ERROR;
+    }
+  *done = TRUE;
+
+  subpool = svn_pool_create(pool);
+  for (i = 0; i < locked_paths->nelts; ++i)
+    {
+      const char *locked_path = APR_ARRAY_IDX(locked_paths, i, const char *);
+      const char *digest_path;
+      svn_lock_t *lock;
+
+      svn_pool_clear(subpool);
+
+      SVN_ERR(digest_path_from_path(&digest_path, fs->path, locked_path,
+                                    subpool));
+      SVN_ERR(read_digest_file(NULL, &lock, fs->path, digest_path, subpool));
+
+      /* A row without a lock merely means "not locked", cf. the ordering
+         rationale in lock_body(). */
+      if (! lock)
+        continue;
+
+      if (lock_expired(lock))
+        {
+          /* Only remove the lock if we have the write lock.
+             Read operations shouldn't change the filesystem.
+             Unlocking also removes the index row. */
+          if (have_write_lock)
+            SVN_ERR(unlock_single(fs, lock, subpool));
+        }
+      else
+        {
+          SVN_ERR(get_locks_func(get_locks_baton, lock, pool));
+        }
+    }
+  svn_pool_destroy(subpool);
+  return SVN_NO_ERROR;
+}
+
 
 /* Utility function:  verify that a lock can be used.  Interesting
    errors returned from this function:
@@ -651,11 +731,19 @@ svn_fs_fs__allow_locked_operation(const char *path,
   path = svn_fs__canonicalize_abspath(path, pool);
   if (recurse)
     {
-      /* Discover all locks at or below the path. */
-      const char *digest_path;
-      SVN_ERR(digest_path_from_path(&digest_path, fs->path, path, pool));
-      SVN_ERR(walk_locks(fs, digest_path, get_locks_callback,
-                         fs, have_write_lock, pool));
+      /* Discover all locks at or below the path, preferably through
+         the lock path index. */
+      svn_boolean_t done;
+
+      SVN_ERR(walk_locks_indexed(&done, fs, path, get_locks_callback,
+                                 fs, have_write_lock, pool));
+      if (! done)
+        {
+          const char *digest_path;
+          SVN_ERR(digest_path_from_path(&digest_path, fs->path, path, pool));
+          SVN_ERR(walk_locks(fs, digest_path, get_locks_callback,
+                             fs, have_write_lock, pool));
+        }
     }
   else
     {
@@ -843,6 +931,8 @@ lock_body(void *baton, apr_pool_t *pool)
   const char *rev_0_path;
   int i;
   apr_hash_t *index_updates = apr_hash_make(pool);
+  apr_array_header_t *indexed_paths
+    = apr_array_make(pool, lb->targets->nelts, sizeof(const char *));
   apr_hash_index_t *hi;
   apr_pool_t *iterpool = svn_pool_create(pool);
 
@@ -871,7 +961,10 @@ lock_body(void *baton, apr_pool_t *pool)
       /* If no error occurred while pre-checking, schedule the index updates for
          this path. */
       if (!info.fs_err)
-        schedule_index_update(index_updates, info.path, iterpool);
+        {
+          schedule_index_update(index_updates, info.path, iterpool);
+          APR_ARRAY_PUSH(indexed_paths, const char *) = info.path;
+        }
 
       APR_ARRAY_PUSH(lb->infos, struct lock_info_t) = info;
     }
@@ -885,7 +978,11 @@ lock_body(void *baton, apr_pool_t *pool)
      index without a lock is consistent in that it always shows up as
      unlocked in svn_fs_fs__allow_locked_operation.  A lock without an
      index is inconsistent, svn_fs_fs__allow_locked_operation will
-     show locked on the file but unlocked on the parent. */
+     show locked on the file but unlocked on the parent.
+
+     The same ordering argument applies to the lock path index rows. */
+
+  SVN_ERR(svn_fs_fs__lock_index_add_paths(lb->fs, indexed_paths, pool));
 
   for (hi = apr_hash_first(pool, index_updates); hi; hi = apr_hash_next(hi))
     {
@@ -995,6 +1092,8 @@ unlock_body(void *baton, apr_pool_t *pool)
   const char *rev_0_path;
   int i;
   apr_hash_t *indices_updates = apr_hash_make(pool);
+  apr_array_header_t *indexed_paths
+    = apr_array_make(pool, ub->targets->nelts, sizeof(const char *));
   apr_hash_index_t *hi;
   apr_pool_t *iterpool = svn_pool_create(pool);
 
@@ -1042,6 +1141,7 @@ unlock_body(void *baton, apr_pool_t *pool)
         {
           SVN_ERR(delete_lock(ub->fs->path, info->path, iterpool));
           info->done = TRUE;
+          APR_ARRAY_PUSH(indexed_paths, const char *) = info->path;
         }
     }
 
@@ -1055,6 +1155,8 @@ unlock_body(void *baton, apr_pool_t *pool)
                                  iterpool));
     }
 
+  SVN_ERR(svn_fs_fs__lock_index_delete_paths(ub->fs, indexed_paths, pool));
+
   svn_pool_destroy(iterpool);
   return SVN_NO_ERROR;
 }
@@ -1348,8 +1450,8 @@ svn_fs_fs__get_locks(svn_fs_t *fs,
                      void *get_locks_baton,
                      apr_pool_t *pool)
 {
-  const char *digest_path;
   get_locks_filter_baton_t glfb;
+  svn_boolean_t done;
 
   SVN_ERR(svn_fs__check_fs(fs, TRUE));
   path = svn_fs__canonicalize_abspath(path, pool);
@@ -1359,9 +1461,16 @@ svn_fs_fs__get_locks(svn_fs_t *fs,
   glfb.get_locks_func = get_locks_func;
   glfb.get_locks_baton = get_locks_baton;
 
-  /* Get the top digest path in our tree of interest, and then walk it. */
-  SVN_ERR(digest_path_from_path(&digest_path, fs->path, path, pool));
-  SVN_ERR(walk_locks(fs, digest_path, get_locks_filter_func, &glfb,
-                     FALSE, pool));
+  /* Preferably walk the subtree through the lock path index. */
+  SVN_ERR(walk_locks_indexed(&done, fs, path, get_locks_filter_func, &glfb,
+                             FALSE, pool));
+  if (! done)
+    {
+      /* Get the top digest path in our tree of interest, and then walk it. */
+      const char *digest_path;
+      SVN_ERR(digest_path_from_path(&digest_path, fs->path, path, pool));
+      SVN_ERR(walk_locks(fs, digest_path, get_locks_filter_func, &glfb,
+                         FALSE, pool));
+    }
   return SVN_NO_ERROR;
 }
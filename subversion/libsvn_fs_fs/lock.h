@@ -73,6 +73,18 @@ svn_error_t *svn_fs_fs__get_locks(svn_fs_t *fs,
                                   apr_pool_t *pool);
 
 
+/* Like svn_fs_fs__get_locks() with svn_depth_infinity, but always walk
+   the digest file tree, ignoring the lock path index.  Used to
+   (re-)build that index.  If the caller (directly or indirectly) has
+   the FS write lock, HAVE_WRITE_LOCK should be true. */
+svn_error_t *svn_fs_fs__walk_digest_locks(svn_fs_t *fs,
+                                          const char *path,
+                                          svn_fs_get_locks_callback_t
+                                            get_locks_func,
+                                          void *get_locks_baton,
+                                          svn_boolean_t have_write_lock,
+                                          apr_pool_t *pool);
+
 /* Examine PATH for existing locks, and check whether they can be
    used.  Use POOL for temporary allocations.
 
@@ -677,67 +677,60 @@ svn_fs_fs__write_changes(svn_stream_t *stream,
   return SVN_NO_ERROR;
 }
 
-/* Given a revision file FILE that has been pre-positioned at the
-   beginning of a Node-Rev header block, read in that header block and
-   store it in the apr_hash_t HEADERS.  All allocations will be from
-   RESULT_POOL. */
+/* Given a revision file STREAM that has been pre-positioned within a
+   Node-Rev header block, read the next header line.  Set *NAME and
+   *VALUE to the header name and value, or set *NAME to NULL upon
+   reaching the end of the block.  Both point into a single line
+   buffer allocated in RESULT_POOL and may be modified by the caller. */
 static svn_error_t *
-read_header_block(apr_hash_t **headers,
-                  svn_stream_t *stream,
-                  apr_pool_t *result_pool)
+read_header_line(char **name,
+                 char **value,
+                 svn_stream_t *stream,
+                 apr_pool_t *result_pool)
 {
-  *headers = svn_hash__make(result_pool);
+  svn_stringbuf_t *header_str;
+  apr_size_t i = 0;
+  svn_boolean_t eof;
 
-  while (1)
-    {
-      svn_stringbuf_t *header_str;
-      const char *name, *value;
-      apr_size_t i = 0;
-      apr_size_t name_len;
-      svn_boolean_t eof;
-
-      SVN_ERR(svn_stream_readline(stream, &header_str, "\n", &eof,
-                                  result_pool));
-
-      if (eof || header_str->len == 0)
-        break; /* end of header block */
-
-      while (header_str->data[i] != ':')
-        {
-          if (header_str->data[i] == '\0')
-            return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
-                                     _("Found malformed header '%s' in "
-                                       "revision file"),
-                                     header_str->data);
-          i++;
-        }
+  SVN_ERR(svn_stream_readline(stream, &header_str, "\n", &eof,
+                              result_pool));
 
-      /* Create a 'name' string and point to it. */
-      header_str->data[i] = '\0';
-      name = header_str->data;
-      name_len = i;
-
-      /* Check if we have enough data to parse. */
-      if (i + 2 > header_str->len)
-        {
-          /* Restore the original line for the error. */
-          header_str->data[i] = ':';
-          return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
-                                   _("Found malformed header '%s' in "
-                                     "revision file"),
-                                   header_str->data);
-        }
+  if (eof || header_str->len == 0)
+    {
+      /* end of header block */
+      *name = NULL;
+      *value = NULL;
+      return SVN_NO_ERROR;
+    }
 
-      /* Skip over the NULL byte and the space following it. */
-      i += 2;
+  while (header_str->data[i] != ':')
+    {
+      if (header_str->data[i] == '\0')
+        return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
+                                 _("Found malformed header '%s' in "
+                                   "revision file"),
+                                 header_str->data);
+      i++;
+    }
 
-      value = header_str->data + i;
+  /* Create a 'name' string and point to it. */
+  header_str->data[i] = '\0';
+  *name = header_str->data;
 
-      /* header_str is safely in our pool, so we can use bits of it as
-         key and value. */
-      apr_hash_set(*headers, name, name_len, value);
+  /* Check if we have enough data to parse. */
+  if (i + 2 > header_str->len)
+    {
+      /* Restore the original line for the error. */
+      header_str->data[i] = ':';
+      return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
+                               _("Found malformed header '%s' in "
+                                 "revision file"),
+                               header_str->data);
     }
 
+  /* Skip over the NULL byte and the space following it. */
+  *value = header_str->data + i + 2;
+
   return SVN_NO_ERROR;
 }
 
@@ -920,68 +913,132 @@ svn_fs_fs__read_noderev(node_revision_t **noderev_p,
                         apr_pool_t *result_pool,
                         apr_pool_t *scratch_pool)
 {
-  apr_hash_t *headers;
   node_revision_t *noderev;
+  char *id_str = NULL;
+  char *type_str = NULL;
+  char *count_str = NULL;
+  char *props_str = NULL;
+  char *text_str = NULL;
+  char *cpath_str = NULL;
+  char *pred_str = NULL;
+  char *copyfrom_str = NULL;
+  char *copyroot_str = NULL;
+  char *minfo_cnt_str = NULL;
+  svn_boolean_t is_fresh_txn_root = FALSE;
+  svn_boolean_t has_mergeinfo = FALSE;
   char *value;
   const char *noderev_id;
 
-  SVN_ERR(read_header_block(&headers, stream, scratch_pool));
+  /* Dispatch each header line directly into the respective variable
+     instead of collecting all of them in a hash table first.  The
+     header names are drawn from a small fixed set, so a switch on the
+     first character followed by a single string comparison replaces
+     the hashing and lookup passes on this hot path. */
+  while (1)
+    {
+      char *name;
+
+      SVN_ERR(read_header_line(&name, &value, stream, scratch_pool));
+      if (name == NULL)
+        break; /* end of header block */
+
+      switch (name[0])
+        {
+        case 'i':
+          if (strcmp(name, HEADER_ID) == 0)
+            id_str = value;
+          else if (strcmp(name, HEADER_FRESHTXNRT) == 0)
+            is_fresh_txn_root = TRUE;
+          break;
+
+        case 't':
+          if (strcmp(name, HEADER_TYPE) == 0)
+            type_str = value;
+          else if (strcmp(name, HEADER_TEXT) == 0)
+            text_str = value;
+          break;
+
+        case 'c':
+          if (strcmp(name, HEADER_COUNT) == 0)
+            count_str = value;
+          else if (strcmp(name, HEADER_CPATH) == 0)
+            cpath_str = value;
+          else if (strcmp(name, HEADER_COPYFROM) == 0)
+            copyfrom_str = value;
+          else if (strcmp(name, HEADER_COPYROOT) == 0)
+            copyroot_str = value;
+          break;
+
+        case 'p':
+          if (strcmp(name, HEADER_PROPS) == 0)
+            props_str = value;
+          else if (strcmp(name, HEADER_PRED) == 0)
+            pred_str = value;
+          break;
+
+        case 'm':
+          if (strcmp(name, HEADER_MINFO_CNT) == 0)
+            minfo_cnt_str = value;
+          else if (strcmp(name, HEADER_MINFO_HERE) == 0)
+            has_mergeinfo = TRUE;
+          break;
+
+        default:
+          /* Unknown headers have always been ignored. */
+          break;
+        }
+    }
 
   noderev = apr_pcalloc(result_pool, sizeof(*noderev));
+  noderev->is_fresh_txn_root = is_fresh_txn_root;
+  noderev->has_mergeinfo = has_mergeinfo;
 
   /* Read the node-rev id. */
-  value = svn_hash_gets(headers, HEADER_ID);
-  if (value == NULL)
+  if (id_str == NULL)
       /* ### More information: filename/offset coordinates */
       return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
                               _("Missing id field in node-rev"));
 
   SVN_ERR(svn_stream_close(stream));
 
-  SVN_ERR(svn_fs_fs__id_parse(&noderev->id, value, result_pool));
-  noderev_id = value; /* for error messages later */
+  SVN_ERR(svn_fs_fs__id_parse(&noderev->id, id_str, result_pool));
+  noderev_id = id_str; /* for error messages later */
 
   /* Read the type. */
-  value = svn_hash_gets(headers, HEADER_TYPE);
-
-  if ((value == NULL) ||
-      (   strcmp(value, SVN_FS_FS__KIND_FILE)
-       && strcmp(value, SVN_FS_FS__KIND_DIR)))
+  if ((type_str == NULL) ||
+      (   strcmp(type_str, SVN_FS_FS__KIND_FILE)
+       && strcmp(type_str, SVN_FS_FS__KIND_DIR)))
     /* ### s/kind/type/ */
     return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
                              _("Missing kind field in node-rev '%s'"),
                              noderev_id);
 
-  noderev->kind = (strcmp(value, SVN_FS_FS__KIND_FILE) == 0)
+  noderev->kind = (strcmp(type_str, SVN_FS_FS__KIND_FILE) == 0)
                 ? svn_node_file
                 : svn_node_dir;
 
   /* Read the 'count' field. */
-  value = svn_hash_gets(headers, HEADER_COUNT);
-  if (value)
-    SVN_ERR(svn_cstring_atoi(&noderev->predecessor_count, value));
+  if (count_str)
+    SVN_ERR(svn_cstring_atoi(&noderev->predecessor_count, count_str));
   else
     noderev->predecessor_count = 0;
 
   /* Get the properties location. */
-  value = svn_hash_gets(headers, HEADER_PROPS);
-  if (value)
+  if (props_str)
     {
-      SVN_ERR(read_rep_offsets(&noderev->prop_rep, value,
+      SVN_ERR(read_rep_offsets(&noderev->prop_rep, props_str,
                                noderev->id, result_pool, scratch_pool));
     }
 
   /* Get the data location. */
-  value = svn_hash_gets(headers, HEADER_TEXT);
-  if (value)
+  if (text_str)
     {
-      SVN_ERR(read_rep_offsets(&noderev->data_rep, value,
+      SVN_ERR(read_rep_offsets(&noderev->data_rep, text_str,
                                noderev->id, result_pool, scratch_pool));
     }
 
   /* Get the created path. */
-  value = svn_hash_gets(headers, HEADER_CPATH);
-  if (value == NULL)
+  if (cpath_str == NULL)
     {
       return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
                                _("Missing cpath field in node-rev '%s'"),
@@ -989,29 +1046,28 @@ svn_fs_fs__read_noderev(node_revision_t **noderev_p,
     }
   else
     {
-      if (!svn_fspath__is_canonical(value))
+      if (!svn_fspath__is_canonical(cpath_str))
         return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
                             _("Non-canonical cpath field in node-rev '%s'"),
                             noderev_id);
 
-      noderev->created_path = apr_pstrdup(result_pool, value);
+      noderev->created_path = apr_pstrdup(result_pool, cpath_str);
     }
 
   /* Get the predecessor ID. */
-  value = svn_hash_gets(headers, HEADER_PRED);
-  if (value)
-    SVN_ERR(svn_fs_fs__id_parse(&noderev->predecessor_id, value,
+  if (pred_str)
+    SVN_ERR(svn_fs_fs__id_parse(&noderev->predecessor_id, pred_str,
                                 result_pool));
 
   /* Get the copyroot. */
-  value = svn_hash_gets(headers, HEADER_COPYROOT);
-  if (value == NULL)
+  if (copyroot_str == NULL)
     {
       noderev->copyroot_path = apr_pstrdup(result_pool, noderev->created_path);
       noderev->copyroot_rev = svn_fs_fs__id_rev(noderev->id);
     }
   else
     {
+      value = copyroot_str;
       SVN_ERR(parse_revnum(&noderev->copyroot_rev, (const char **)&value));
 
       if (!svn_fspath__is_canonical(value))
@@ -1022,14 +1078,14 @@ svn_fs_fs__read_noderev(node_revision_t **noderev_p,
     }
 
   /* Get the copyfrom. */
-  value = svn_hash_gets(headers, HEADER_COPYFROM);
-  if (value == NULL)
+  if (copyfrom_str == NULL)
     {
       noderev->copyfrom_path = NULL;
       noderev->copyfrom_rev = SVN_INVALID_REVNUM;
     }
   else
     {
+      value = copyfrom_str;
       SVN_ERR(parse_revnum(&noderev->copyfrom_rev, (const char **)&value));
 
       if (*value == 0)
@@ -1039,21 +1095,12 @@ svn_fs_fs__read_noderev(node_revision_t **noderev_p,
       noderev->copyfrom_path = apr_pstrdup(result_pool, value);
     }
 
-  /* Get whether this is a fresh txn root. */
-  value = svn_hash_gets(headers, HEADER_FRESHTXNRT);
-  noderev->is_fresh_txn_root = (value != NULL);
-
   /* Get the mergeinfo count. */
-  value = svn_hash_gets(headers, HEADER_MINFO_CNT);
-  if (value)
-    SVN_ERR(svn_cstring_atoi64(&noderev->mergeinfo_count, value));
+  if (minfo_cnt_str)
+    SVN_ERR(svn_cstring_atoi64(&noderev->mergeinfo_count, minfo_cnt_str));
   else
     noderev->mergeinfo_count = 0;
 
-  /* Get whether *this* node has mergeinfo. */
-  value = svn_hash_gets(headers, HEADER_MINFO_HERE);
-  noderev->has_mergeinfo = (value != NULL);
-
   *noderev_p = noderev;
 
   return SVN_NO_ERROR;
@@ -22,6 +22,9 @@
 #include <assert.h>
 #include <string.h>
 
+#include <apr_thread_proc.h>
+#include <apr_thread_mutex.h>
+
 #include "svn_pools.h"
 #include "svn_dirent_uri.h"
 #include "svn_sorts.h"
@@ -1422,6 +1425,9 @@ pack_range(pack_context_t *context,
           if (context->cancel_func)
             SVN_ERR(context->cancel_func(context->cancel_baton));
         }
+
+      /* We are done reading from this rev file. */
+      svn_fs_fs__uncache_revision_file(rev_file, context->fs);
     }
 
   svn_pool_destroy(iterpool2);
@@ -1529,6 +1535,7 @@ append_revision(pack_context_t *context,
   svn_pool_destroy(iterpool);
   context->pack_offset += revdata_size;
 
+  svn_fs_fs__uncache_revision_file(rev_file, context->fs);
   SVN_ERR(svn_fs_fs__close_revision_file(rev_file));
 
   return SVN_NO_ERROR;
@@ -1873,6 +1880,11 @@ struct pack_baton
 
   /* Additional entries valid when entering synced_pack_shard(). */
   const char *rev_shard_path;
+
+  /* Set when the pack file for SHARD has already been created by a
+     parallel packing worker.  pack_shard() will then skip the expensive
+     packing step and only perform the synchronized switch-over. */
+  svn_boolean_t rev_shard_packed;
 };
 
 
@@ -1912,6 +1924,7 @@ synced_pack_shard(void *baton,
                                              ffd->compress_packed_revprops
                                                ? SVN__COMPRESSION_ZLIB_DEFAULT
                                                : SVN__COMPRESSION_NONE,
+                                             ffd->indexed_packed_revprops,
                                              ffd->flush_to_disk,
                                              pb->cancel_func,
                                              pb->cancel_baton,
@@ -1986,11 +1999,13 @@ pack_shard(struct pack_baton *baton,
                                                        baton->shard),
                                           pool);
 
-  /* pack the revision content */
-  SVN_ERR(pack_rev_shard(baton->fs, rev_pack_file_dir, baton->rev_shard_path,
-                         baton->shard, ffd->max_files_per_dir,
-                         baton->max_mem, ffd->flush_to_disk,
-                         baton->cancel_func, baton->cancel_baton, pool));
+  /* pack the revision content, unless a parallel worker did so already */
+  if (!baton->rev_shard_packed)
+    SVN_ERR(pack_rev_shard(baton->fs, rev_pack_file_dir,
+                           baton->rev_shard_path,
+                           baton->shard, ffd->max_files_per_dir,
+                           baton->max_mem, ffd->flush_to_disk,
+                           baton->cancel_func, baton->cancel_baton, pool));
 
   /* For newer repo formats, we only acquired the pack lock so far.
      Before modifying the repo state by switching over to the packed
@@ -2009,6 +2024,221 @@ pack_shard(struct pack_baton *baton,
   return SVN_NO_ERROR;
 }
 
+#if APR_HAS_THREADS
+
+/* Open a new, private FS handle to the repository accessed through
+   MASTER_FS, allocated in POOL, and return it in *FS_P.  The private
+   handle comes with its own file handles and cache front-ends; the
+   front-ends created by svn_fs_fs__initialize_caches() are not
+   thread-safe, so MASTER_FS must not be used from multiple worker
+   threads concurrently. */
+static svn_error_t *
+open_private_fs(svn_fs_t **fs_p,
+                svn_fs_t *master_fs,
+                apr_pool_t *pool)
+{
+  fs_fs_data_t *master_ffd = master_fs->fsap_data;
+  svn_fs_t *fs = apr_pcalloc(pool, sizeof(*fs));
+  fs_fs_data_t *ffd = apr_pcalloc(pool, sizeof(*ffd));
+
+  fs->pool = pool;
+  fs->vtable = master_fs->vtable;
+  fs->config = master_fs->config;
+  fs->fsap_data = ffd;
+
+  SVN_ERR(svn_fs_fs__open(fs, master_fs->path, pool));
+  SVN_ERR(svn_fs_fs__initialize_caches(fs, pool));
+
+  /* The shared data is keyed by UUID and instance ID in process-global
+     storage, so the master handle's pointer is exactly what the usual
+     serialized lookup would yield for this handle. */
+  ffd->shared = master_ffd->shared;
+
+  *fs_p = fs;
+  return SVN_NO_ERROR;
+}
+
+/* State shared between all shard-packing worker threads spawned by
+   pack_shards_parallel().  Workers pick the next shard to pack from
+   NEXT_SHARD until all shards have been handed out or TERMINATED has
+   been set. */
+struct pack_worker_shared
+{
+  /* The pack baton handed to pack_body().  REVS_DIR must be valid. */
+  struct pack_baton *pb;
+
+  /* Serializes access to all following members. */
+  apr_thread_mutex_t *mutex;
+
+  /* Next shard index to hand out to a worker. */
+  apr_int64_t next_shard;
+
+  /* First shard index not to pack. */
+  apr_int64_t end_shard;
+
+  /* First error encountered by any worker, or SVN_NO_ERROR. */
+  svn_error_t *err;
+
+  /* Set when a worker failed or the user cancelled the operation;
+     tells the remaining workers to wind down early. */
+  svn_boolean_t terminated;
+};
+
+/* Implements apr_thread_start_t.  BATON is a 'struct pack_worker_shared *'.
+   Keep packing rev shards picked from BATON until none are left.  Errors
+   are reported through BATON->ERR; the thread itself always "succeeds". */
+static void * APR_THREAD_FUNC
+pack_worker(apr_thread_t *thread,
+            void *baton)
+{
+  struct pack_worker_shared *shared = baton;
+  struct pack_baton *pb = shared->pb;
+  fs_fs_data_t *ffd;
+  svn_fs_t *fs;
+  svn_error_t *open_err;
+
+  /* Thread-private root pool; the pool handed to pack_shards_parallel()
+     must not see unsynchronized allocations from multiple threads. */
+  apr_pool_t *pool = svn_pool_create(NULL);
+  apr_pool_t *iterpool = svn_pool_create(pool);
+
+  /* Each worker uses its own FS handle: the cache front-ends hanging
+     off PB->fs are not thread-safe, so sharing that handle between
+     workers could tear cache keys and serve wrong index data. */
+  open_err = open_private_fs(&fs, pb->fs, pool);
+  if (open_err)
+    {
+      apr_thread_mutex_lock(shared->mutex);
+      if (shared->err)
+        svn_error_clear(open_err);
+      else
+        shared->err = open_err;
+      shared->terminated = TRUE;
+      apr_thread_mutex_unlock(shared->mutex);
+
+      svn_pool_destroy(pool);
+      return NULL;
+    }
+  ffd = fs->fsap_data;
+
+  while (TRUE)
+    {
+      apr_int64_t shard;
+      const char *rev_pack_file_dir;
+      const char *rev_shard_path;
+      svn_error_t *err;
+
+      /* Pick the next piece of work, if any. */
+      apr_thread_mutex_lock(shared->mutex);
+      if (shared->terminated || shared->next_shard >= shared->end_shard)
+        shard = -1;
+      else
+        shard = shared->next_shard++;
+      apr_thread_mutex_unlock(shared->mutex);
+
+      if (shard < 0)
+        break;
+
+      svn_pool_clear(iterpool);
+      rev_pack_file_dir = svn_dirent_join(pb->revs_dir,
+                      apr_psprintf(iterpool,
+                                   "%" APR_INT64_T_FMT PATH_EXT_PACKED_SHARD,
+                                   shard),
+                      iterpool);
+      rev_shard_path = svn_dirent_join(pb->revs_dir,
+                      apr_psprintf(iterpool, "%" APR_INT64_T_FMT, shard),
+                      iterpool);
+
+      /* Create the pack file for SHARD.  The switch-over to it will be
+         performed later by the main thread, in shard order and with the
+         required locks held. */
+      err = pack_rev_shard(fs, rev_pack_file_dir, rev_shard_path,
+                           shard, ffd->max_files_per_dir, pb->max_mem,
+                           ffd->flush_to_disk, pb->cancel_func,
+                           pb->cancel_baton, iterpool);
+      if (err)
+        {
+          apr_thread_mutex_lock(shared->mutex);
+          if (shared->err)
+            svn_error_clear(err);
+          else
+            shared->err = err;
+          shared->terminated = TRUE;
+          apr_thread_mutex_unlock(shared->mutex);
+          break;
+        }
+    }
+
+  svn_pool_destroy(pool);
+  return NULL;
+}
+
+/* Pack the rev shards FIRST_SHARD .. END_SHARD-1 described by PB using
+   up to THREAD_COUNT concurrent worker threads.  Only the shard pack
+   files are being created; the repository is not switched over to them.
+   Note that PB->cancel_func, if any, will be called concurrently from
+   multiple threads and therefore must be thread-safe.
+   Use POOL for temporary allocations. */
+static svn_error_t *
+pack_shards_parallel(struct pack_baton *pb,
+                     apr_int64_t first_shard,
+                     apr_int64_t end_shard,
+                     apr_size_t thread_count,
+                     apr_pool_t *pool)
+{
+  struct pack_worker_shared shared = { 0 };
+  apr_array_header_t *threads;
+  apr_status_t status;
+  apr_size_t i;
+  int k;
+
+  /* No point in spawning more workers than there are shards to pack. */
+  if (thread_count > (apr_size_t)(end_shard - first_shard))
+    thread_count = (apr_size_t)(end_shard - first_shard);
+
+  shared.pb = pb;
+  shared.next_shard = first_shard;
+  shared.end_shard = end_shard;
+
+  status = apr_thread_mutex_create(&shared.mutex, APR_THREAD_MUTEX_DEFAULT,
+                                   pool);
+  if (status)
+    return svn_error_wrap_apr(status,
+                              _("Can't create parallel pack mutex"));
+
+  threads = apr_array_make(pool, (int)thread_count, sizeof(apr_thread_t *));
+  for (i = 0; i < thread_count; ++i)
+    {
+      apr_thread_t *thread;
+      status = apr_thread_create(&thread, NULL, pack_worker, &shared, pool);
+      if (status)
+        {
+          /* Wind down the workers we did manage to start. */
+          apr_thread_mutex_lock(shared.mutex);
+          shared.terminated = TRUE;
+          if (!shared.err)
+            shared.err = svn_error_wrap_apr(status,
+                                  _("Can't create parallel pack thread"));
+          apr_thread_mutex_unlock(shared.mutex);
+          break;
+        }
+
+      APR_ARRAY_PUSH(threads, apr_thread_t *) = thread;
+    }
+
+  /* Wait for all workers to complete.  They only terminate early upon
+     error or cancellation. */
+  for (k = 0; k < threads->nelts; ++k)
+    {
+      apr_status_t retval;
+      apr_thread_join(&retval, APR_ARRAY_IDX(threads, k, apr_thread_t *));
+    }
+
+  return svn_error_trace(shared.err);
+}
+
+#endif /* APR_HAS_THREADS */
+
 /* Read the youngest rev and the first non-packed rev info for FS from disk.
    Set *FULLY_PACKED when there is no completed unpacked shard.
    Use SCRATCH_POOL for temporary allocations.
@@ -2080,6 +2310,24 @@ pack_body(void *baton,
     pb->revsprops_dir = svn_dirent_join(pb->fs->path, PATH_REVPROPS_DIR,
                                         pool);
 
+#if APR_HAS_THREADS
+  /* If so configured, pre-build the pack files for all shards with a pool
+     of worker threads before switching the repository over to them.  The
+     switch-over itself remains strictly sequential, in shard order and
+     with the required locks held. */
+  if (ffd->pack_threads > 1
+      && completed_shards - ffd->min_unpacked_rev / ffd->max_files_per_dir
+         > 1)
+    {
+      SVN_ERR(pack_shards_parallel(pb,
+                                   ffd->min_unpacked_rev
+                                     / ffd->max_files_per_dir,
+                                   completed_shards, ffd->pack_threads,
+                                   pool));
+      pb->rev_shard_packed = TRUE;
+    }
+#endif
+
   iterpool = svn_pool_create(pool);
   for (pb->shard = ffd->min_unpacked_rev / ffd->max_files_per_dir;
        pb->shard < completed_shards;
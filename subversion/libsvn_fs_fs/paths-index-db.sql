@@ -0,0 +1,73 @@
+/* paths-index-db.sql -- schema for the changed-paths index
+ *   This is intended for use with SQLite 3
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+-- STMT_CREATE_SCHEMA
+/* One row per entry in a revision's changed-paths list.  KIND is the
+   svn_fs_path_change_kind_t of the change.  The primary key makes both
+   path prefix scans and (path, revision range) scans index-only. */
+CREATE TABLE paths_index (
+  path TEXT NOT NULL,
+  revision INTEGER NOT NULL,
+  kind INTEGER NOT NULL,
+  PRIMARY KEY (path, revision)
+  ) WITHOUT ROWID;
+
+/* The single-row watermark table.  All revisions up to and including
+   REVISION have been indexed; queries beyond it must not use the index. */
+CREATE TABLE indexed_revision (
+  id INTEGER NOT NULL PRIMARY KEY,
+  revision INTEGER NOT NULL
+  );
+
+PRAGMA USER_VERSION = 1;
+
+-- STMT_GET_INDEXED_REVISION
+SELECT revision
+FROM indexed_revision
+WHERE id = 1
+
+-- STMT_SET_INDEXED_REVISION
+INSERT OR REPLACE INTO indexed_revision (id, revision)
+VALUES (1, ?1)
+
+-- STMT_INSERT_PATH
+INSERT OR REPLACE INTO paths_index (path, revision, kind)
+VALUES (?1, ?2, ?3)
+
+-- STMT_GET_REVS_FOR_PATH
+/* All changes to ?1 itself within the revision range [?2, ?3]. */
+SELECT revision, kind
+FROM paths_index
+WHERE path = ?1 AND revision >= ?2 AND revision <= ?3
+
+-- STMT_GET_REVS_BELOW_PATH
+/* All changes strictly below directory ?1 within the revision range
+   [?3, ?4].  ?2 must be ?1 with the last character incremented, which
+   together with the trailing '/' on ?1 forms a half-open prefix range. */
+SELECT DISTINCT revision
+FROM paths_index
+WHERE path > ?1 AND path < ?2 AND revision >= ?3 AND revision <= ?4
+
+-- STMT_DEL_REVS_YOUNGER_THAN_REV
+DELETE FROM paths_index
+WHERE revision > ?1
@@ -0,0 +1,433 @@
+/* paths-index.c --- the changed-paths index for fsfs
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include "svn_pools.h"
+#include "svn_path.h"
+#include "svn_dirent_uri.h"
+
+#include "svn_private_config.h"
+
+#include "cached_data.h"
+#include "fs_fs.h"
+#include "fs.h"
+#include "paths-index.h"
+
+#include "private/svn_fspath.h"
+#include "private/svn_sorts_private.h"
+#include "private/svn_sqlite.h"
+
+#include "paths-index-db.h"
+
+PATHS_INDEX_DB_SQL_DECLARE_STATEMENTS(statements);
+
+
+
+/** Helper functions. **/
+static APR_INLINE const char *
+path_paths_index_db(const char *fs_path,
+                    apr_pool_t *result_pool)
+{
+  return svn_dirent_join(fs_path, PATHS_INDEX_DB_NAME, result_pool);
+}
+
+/* Open the index database of FS and return it in *SDB, creating it if
+   CREATE is set.  If the database does not exist and CREATE is not set,
+   return NULL in *SDB.  The handle is kept in the fs data and remains
+   valid until FS->pool is destroyed. */
+static svn_error_t *
+open_paths_index(svn_sqlite__db_t **sdb,
+                 svn_fs_t *fs,
+                 svn_boolean_t create,
+                 apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  const char *db_path;
+  svn_node_kind_t kind;
+  int version;
+
+  if (ffd->paths_index_db)
+    {
+      *sdb = ffd->paths_index_db;
+      return SVN_NO_ERROR;
+    }
+
+  db_path = path_paths_index_db(fs->path, pool);
+  SVN_ERR(svn_io_check_path(db_path, &kind, pool));
+  if (kind == svn_node_none && !create)
+    {
+      *sdb = NULL;
+      return SVN_NO_ERROR;
+    }
+
+#ifndef WIN32
+  if (kind == svn_node_none)
+    {
+      /* We want to extend the permissions that apply to the repository
+         as a whole when creating the index and not simply default
+         to umask. */
+      const char *current = svn_fs_fs__path_current(fs, pool);
+      svn_error_t *err = svn_io_file_create_empty(db_path, pool);
+
+      if (err && !APR_STATUS_IS_EEXIST(err->apr_err))
+        /* A real error. */
+        return svn_error_trace(err);
+      else if (err)
+        /* Some other thread/process created the file. */
+        svn_error_clear(err);
+      else
+        /* We created the file. */
+        SVN_ERR(svn_io_copy_perms(current, db_path, pool));
+    }
+#endif
+
+  SVN_ERR(svn_sqlite__open(sdb, db_path,
+                           create ? svn_sqlite__mode_rwcreate
+                                  : svn_sqlite__mode_readwrite,
+                           statements, 0, NULL, 0,
+                           fs->pool, pool));
+
+  SVN_SQLITE__ERR_CLOSE(svn_sqlite__read_schema_version(&version, *sdb,
+                                                        pool),
+                        *sdb);
+  /* If we have an uninitialized database, go ahead and create the schema. */
+  if (version <= 0)
+    SVN_SQLITE__ERR_CLOSE(svn_sqlite__exec_statements(*sdb,
+                                                      STMT_CREATE_SCHEMA),
+                          *sdb);
+
+  ffd->paths_index_db = *sdb;
+
+  return SVN_NO_ERROR;
+}
+
+/* Set *INDEXED_REV to the index watermark in SDB, i.e. the youngest
+   revision covered by the index, or to SVN_INVALID_REVNUM for an empty
+   index. */
+static svn_error_t *
+get_indexed_revision(svn_revnum_t *indexed_rev,
+                     svn_sqlite__db_t *sdb)
+{
+  svn_sqlite__stmt_t *stmt;
+  svn_boolean_t have_row;
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, sdb,
+                                    STMT_GET_INDEXED_REVISION));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+  if (have_row)
+    *indexed_rev = (svn_revnum_t)svn_sqlite__column_int64(stmt, 0);
+  else
+    *indexed_rev = SVN_INVALID_REVNUM;
+
+  return svn_error_trace(svn_sqlite__reset(stmt));
+}
+
+/* Add the changed-paths list of revision REV in FS to SDB.
+   Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+index_revision(svn_fs_t *fs,
+               svn_sqlite__db_t *sdb,
+               svn_revnum_t rev,
+               apr_pool_t *scratch_pool)
+{
+  svn_fs_fs__changes_context_t *context;
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+
+  SVN_ERR(svn_fs_fs__create_changes_context(&context, fs, rev,
+                                            scratch_pool));
+  while (!context->eol)
+    {
+      apr_array_header_t *changes;
+      int i;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_fs_fs__get_changes(&changes, context, iterpool,
+                                     iterpool));
+
+      for (i = 0; i < changes->nelts; ++i)
+        {
+          change_t *change = APR_ARRAY_IDX(changes, i, change_t *);
+          svn_sqlite__stmt_t *stmt;
+
+          SVN_ERR(svn_sqlite__get_statement(&stmt, sdb,
+                                            STMT_INSERT_PATH));
+          SVN_ERR(svn_sqlite__bindf(stmt, "sii", change->path.data,
+                                    (apr_int64_t)rev,
+                                    (apr_int64_t)change->info.change_kind));
+          SVN_ERR(svn_sqlite__step_done(stmt));
+        }
+    }
+
+  svn_pool_destroy(iterpool);
+  return SVN_NO_ERROR;
+}
+
+/* Index all revisions from SDB's watermark up to and including END_REV
+   in FS, advancing the watermark.  Report progress through
+   PROGRESS_FUNC and check CANCEL_FUNC as in svn_fs_fs__paths_index_build.
+   Use POOL for temporary allocations. */
+static svn_error_t *
+index_revisions(svn_fs_t *fs,
+                svn_sqlite__db_t *sdb,
+                svn_revnum_t end_rev,
+                svn_fs_progress_notify_func_t progress_func,
+                void *progress_baton,
+                svn_cancel_func_t cancel_func,
+                void *cancel_baton,
+                apr_pool_t *pool)
+{
+  svn_revnum_t indexed_rev;
+  svn_revnum_t rev;
+  apr_pool_t *iterpool;
+  svn_sqlite__stmt_t *stmt;
+
+  SVN_ERR(get_indexed_revision(&indexed_rev, sdb));
+
+  /* The watermark may be ahead of END_REV if revisions have been rolled
+     back, e.g. by 'svnadmin recover'.  Drop the affected rows so that
+     the re-committed revisions get indexed correctly. */
+  if (SVN_IS_VALID_REVNUM(indexed_rev) && indexed_rev > end_rev)
+    {
+      SVN_ERR(svn_sqlite__get_statement(&stmt, sdb,
+                                        STMT_DEL_REVS_YOUNGER_THAN_REV));
+      SVN_ERR(svn_sqlite__bindf(stmt, "i", (apr_int64_t)end_rev));
+      SVN_ERR(svn_sqlite__step_done(stmt));
+
+      indexed_rev = end_rev;
+    }
+
+  iterpool = svn_pool_create(pool);
+  for (rev = SVN_IS_VALID_REVNUM(indexed_rev) ? indexed_rev + 1 : 0;
+       rev <= end_rev;
+       ++rev)
+    {
+      svn_pool_clear(iterpool);
+
+      if (cancel_func)
+        SVN_ERR(cancel_func(cancel_baton));
+      if (progress_func)
+        progress_func(rev, progress_baton, iterpool);
+
+      SVN_ERR(index_revision(fs, sdb, rev, iterpool));
+    }
+  svn_pool_destroy(iterpool);
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, sdb,
+                                    STMT_SET_INDEXED_REVISION));
+  SVN_ERR(svn_sqlite__bindf(stmt, "i", (apr_int64_t)end_rev));
+  SVN_ERR(svn_sqlite__step_done(stmt));
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_fs_fs__paths_index_build(svn_fs_t *fs,
+                             svn_revnum_t end_rev,
+                             svn_fs_progress_notify_func_t progress_func,
+                             void *progress_baton,
+                             svn_cancel_func_t cancel_func,
+                             void *cancel_baton,
+                             apr_pool_t *pool)
+{
+  svn_sqlite__db_t *sdb;
+  svn_revnum_t youngest;
+  svn_error_t *err;
+
+  SVN_ERR(svn_fs_fs__youngest_rev(&youngest, fs, pool));
+  if (!SVN_IS_VALID_REVNUM(end_rev) || end_rev > youngest)
+    end_rev = youngest;
+
+  SVN_ERR(open_paths_index(&sdb, fs, TRUE, pool));
+
+  /* Build the whole batch as a single transaction; it is much faster
+     than per-row commits and keeps concurrent readers consistent. */
+  SVN_ERR(svn_sqlite__begin_transaction(sdb));
+  err = index_revisions(fs, sdb, end_rev, progress_func, progress_baton,
+                        cancel_func, cancel_baton, pool);
+  return svn_error_trace(svn_sqlite__finish_transaction(sdb, err));
+}
+
+svn_error_t *
+svn_fs_fs__paths_index_update(svn_fs_t *fs,
+                              svn_revnum_t new_rev,
+                              apr_pool_t *pool)
+{
+  svn_sqlite__db_t *sdb;
+  svn_error_t *err;
+
+  /* The index is strictly opt-in: do nothing unless the administrator
+     created it with 'svnadmin build-pathsindex'. */
+  SVN_ERR(open_paths_index(&sdb, fs, FALSE, pool));
+  if (!sdb)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_sqlite__begin_transaction(sdb));
+  err = index_revisions(fs, sdb, new_rev, NULL, NULL, NULL, NULL, pool);
+  return svn_error_trace(svn_sqlite__finish_transaction(sdb, err));
+}
+
+
+/** Queries. **/
+
+/* Find the hit entry for REVISION in the REVISION -> hit map HITS
+   (allocated in RESULT_POOL), creating it if necessary. */
+static svn_fs_fs__paths_index_hit_t *
+get_hit(apr_hash_t *hits,
+        svn_revnum_t revision,
+        apr_pool_t *result_pool)
+{
+  svn_fs_fs__paths_index_hit_t *hit
+    = apr_hash_get(hits, &revision, sizeof(revision));
+
+  if (!hit)
+    {
+      hit = apr_pcalloc(result_pool, sizeof(*hit));
+      hit->revision = revision;
+      apr_hash_set(hits, &hit->revision, sizeof(hit->revision), hit);
+    }
+
+  return hit;
+}
+
+/* Compare two svn_fs_fs__paths_index_hit_t * by revision. */
+static int
+compare_hits(const void *a, const void *b)
+{
+  const svn_fs_fs__paths_index_hit_t *lhs
+    = *(const svn_fs_fs__paths_index_hit_t * const *)a;
+  const svn_fs_fs__paths_index_hit_t *rhs
+    = *(const svn_fs_fs__paths_index_hit_t * const *)b;
+
+  if (lhs->revision < rhs->revision)
+    return -1;
+
+  return lhs->revision == rhs->revision ? 0 : 1;
+}
+
+svn_error_t *
+svn_fs_fs__paths_index_query(apr_array_header_t **hits,
+                             svn_fs_t *fs,
+                             const char *path,
+                             svn_revnum_t start_rev,
+                             svn_revnum_t end_rev,
+                             apr_pool_t *result_pool,
+                             apr_pool_t *scratch_pool)
+{
+  svn_sqlite__db_t *sdb;
+  svn_revnum_t indexed_rev;
+  svn_sqlite__stmt_t *stmt;
+  svn_boolean_t have_row;
+  apr_hash_t *hit_map;
+  apr_hash_index_t *hi;
+  const char *below_lower, *below_upper;
+  svn_stringbuf_t *upper_buf;
+  const char *current;
+
+  *hits = NULL;
+
+  SVN_ERR(open_paths_index(&sdb, fs, FALSE, scratch_pool));
+  if (!sdb)
+    return SVN_NO_ERROR;
+
+  /* A stale index must never make us skip revisions. */
+  SVN_ERR(get_indexed_revision(&indexed_rev, sdb));
+  if (!SVN_IS_VALID_REVNUM(indexed_rev) || indexed_rev < end_rev)
+    return SVN_NO_ERROR;
+
+  hit_map = apr_hash_make(scratch_pool);
+
+  /* Changes to PATH itself and to each of its ancestors.  For the
+     ancestors, only additions and replacements are relevant: they are
+     the points where the node first appeared under this name. */
+  current = path;
+  while (TRUE)
+    {
+      svn_boolean_t is_self = (current == path);
+
+      SVN_ERR(svn_sqlite__get_statement(&stmt, sdb,
+                                        STMT_GET_REVS_FOR_PATH));
+      SVN_ERR(svn_sqlite__bindf(stmt, "sii", current,
+                                (apr_int64_t)start_rev,
+                                (apr_int64_t)end_rev));
+      SVN_ERR(svn_sqlite__step(&have_row, stmt));
+      while (have_row)
+        {
+          svn_revnum_t rev = (svn_revnum_t)svn_sqlite__column_int64(stmt, 0);
+          apr_int64_t kind = svn_sqlite__column_int64(stmt, 1);
+          svn_boolean_t added = (kind == svn_fs_path_change_add
+                                 || kind == svn_fs_path_change_replace);
+
+          if (is_self || added)
+            {
+              svn_fs_fs__paths_index_hit_t *hit
+                = get_hit(hit_map, rev, result_pool);
+
+              if (is_self)
+                hit->self_or_below = TRUE;
+              if (added)
+                hit->added_here = TRUE;
+            }
+
+          SVN_ERR(svn_sqlite__step(&have_row, stmt));
+        }
+      SVN_ERR(svn_sqlite__reset(stmt));
+
+      if (svn_fspath__is_root(current, strlen(current)))
+        break;
+      current = svn_fspath__dirname(current, scratch_pool);
+    }
+
+  /* Changes somewhere below PATH, via a half-open prefix range scan. */
+  below_lower = svn_fspath__is_root(path, strlen(path))
+                  ? path
+                  : apr_pstrcat(scratch_pool, path, "/", SVN_VA_NULL);
+  upper_buf = svn_stringbuf_create(below_lower, scratch_pool);
+  upper_buf->data[upper_buf->len - 1]++;   /* '/' becomes '0' */
+  below_upper = upper_buf->data;
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, sdb,
+                                    STMT_GET_REVS_BELOW_PATH));
+  SVN_ERR(svn_sqlite__bindf(stmt, "ssii", below_lower, below_upper,
+                            (apr_int64_t)start_rev,
+                            (apr_int64_t)end_rev));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+  while (have_row)
+    {
+      svn_revnum_t rev = (svn_revnum_t)svn_sqlite__column_int64(stmt, 0);
+
+      get_hit(hit_map, rev, result_pool)->self_or_below = TRUE;
+
+      SVN_ERR(svn_sqlite__step(&have_row, stmt));
+    }
+  SVN_ERR(svn_sqlite__reset(stmt));
+
+  /* Return the hits as an array sorted by revision. */
+  *hits = apr_array_make(result_pool, apr_hash_count(hit_map),
+                         sizeof(svn_fs_fs__paths_index_hit_t *));
+  for (hi = apr_hash_first(scratch_pool, hit_map); hi;
+       hi = apr_hash_next(hi))
+    APR_ARRAY_PUSH(*hits, svn_fs_fs__paths_index_hit_t *)
+      = apr_hash_this_val(hi);
+
+  svn_sort__array(*hits, compare_hits);
+
+  return SVN_NO_ERROR;
+}
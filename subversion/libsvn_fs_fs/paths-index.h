@@ -0,0 +1,81 @@
+/* paths-index.h : interface to the changed-paths index
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#ifndef SVN_LIBSVN_FS_FS_PATHS_INDEX_H
+#define SVN_LIBSVN_FS_FS_PATHS_INDEX_H
+
+#include "svn_error.h"
+
+#include "private/svn_fs_fs_private.h"
+
+#include "fs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+#define PATHS_INDEX_DB_NAME      "paths-index.db"
+
+/* Create the changed-paths index database for FS if it does not exist
+   yet and index all revisions from the current watermark up to and
+   including END_REV.  If END_REV is SVN_INVALID_REVNUM, index up to the
+   youngest revision.  Report progress through PROGRESS_FUNC /
+   PROGRESS_BATON (may be NULL).  Use POOL for temporary allocations. */
+svn_error_t *
+svn_fs_fs__paths_index_build(svn_fs_t *fs,
+                             svn_revnum_t end_rev,
+                             svn_fs_progress_notify_func_t progress_func,
+                             void *progress_baton,
+                             svn_cancel_func_t cancel_func,
+                             void *cancel_baton,
+                             apr_pool_t *pool);
+
+/* If the changed-paths index database exists for FS, bring it up to date
+   with revision NEW_REV; otherwise, do nothing.  This is called at the
+   end of each commit, so it must be cheap when the index does not exist.
+   Use POOL for temporary allocations. */
+svn_error_t *
+svn_fs_fs__paths_index_update(svn_fs_t *fs,
+                              svn_revnum_t new_rev,
+                              apr_pool_t *pool);
+
+/* Query the changed-paths index of FS for changes relevant to PATH
+   within the inclusive revision range [START_REV, END_REV] and return
+   them in *HITS, sorted by revision in ascending order, as
+   svn_fs_fs__paths_index_hit_t elements allocated in RESULT_POOL.
+   Set *HITS to NULL if the index does not exist or does not cover
+   END_REV yet.  Use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_fs_fs__paths_index_query(apr_array_header_t **hits,
+                             svn_fs_t *fs,
+                             const char *path,
+                             svn_revnum_t start_rev,
+                             svn_revnum_t end_rev,
+                             apr_pool_t *result_pool,
+                             apr_pool_t *scratch_pool);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SVN_LIBSVN_FS_FS_PATHS_INDEX_H */
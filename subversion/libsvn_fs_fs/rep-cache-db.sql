@@ -70,6 +70,16 @@ SELECT hash, revision, offset, size, expanded_size
 FROM rep_cache
 WHERE revision >= ?1 AND revision <= ?2
 
+-- STMT_GET_REP_COUNT
+/* Works for both V1 and V2 schemas. */
+SELECT COUNT(*)
+FROM rep_cache
+
+-- STMT_GET_ALL_HASHES
+/* Works for both V1 and V2 schemas. */
+SELECT hash
+FROM rep_cache
+
 -- STMT_GET_MAX_REV
 /* Works for both V1 and V2 schemas. */
 SELECT MAX(revision)
@@ -48,6 +48,135 @@ path_rep_cache_db(const char *fs_path,
   return svn_dirent_join(fs_path, REP_CACHE_DB_NAME, result_pool);
 }
 
+
+/** Bloom filter over the SHA1 keys in the rep-cache.
+ *
+ * Most lookups during a commit are misses: the vast majority of new
+ * representations have never been seen before.  The filter answers
+ * "certainly not in the database" from memory and saves the SQLite
+ * roundtrip for those.  A positive answer merely means "maybe" and
+ * falls through to the actual query.
+ *
+ * The filter only covers rows present when it was built plus rows
+ * inserted through this svn_fs_t.  Rows inserted concurrently by other
+ * processes may therefore be reported as absent; the cost is a missed
+ * sharing opportunity, never incorrect data.  Similarly, rows deleted
+ * by svn_fs_fs__del_rep_reference() leave stale bits behind, which
+ * only cause a redundant query.
+ **/
+
+/* Number of bits set per key. */
+#define BLOOM_PROBE_COUNT 4
+
+/* Bounds for the filter size in bits.  Both must be powers of two.
+   The lower bound avoids degenerate filters for near-empty databases;
+   the upper bound (32MB worth of bits) caps the memory overhead for
+   huge repositories, at the price of a higher false positive rate. */
+#define BLOOM_MIN_BITS 0x10000
+#define BLOOM_MAX_BITS 0x10000000
+
+/* Set the filter bits for the 20-byte SHA1 DIGEST.  SHA1 output is
+   uniformly distributed, so simply use consecutive 32-bit words of the
+   digest as the probe indexes. */
+static void
+bloom_insert(fs_fs_data_t *ffd,
+             const unsigned char *digest)
+{
+  int i;
+  for (i = 0; i < BLOOM_PROBE_COUNT; ++i)
+    {
+      apr_size_t bit = (  ((apr_size_t)digest[4*i  ] << 24)
+                        | ((apr_size_t)digest[4*i+1] << 16)
+                        | ((apr_size_t)digest[4*i+2] <<  8)
+                        |  (apr_size_t)digest[4*i+3])
+                       & ffd->rep_cache_bloom_mask;
+      ffd->rep_cache_bloom[bit / 8] |= (unsigned char)(1 << (bit % 8));
+    }
+}
+
+/* Return FALSE iff the 20-byte SHA1 DIGEST is certainly not in the
+   filter. */
+static svn_boolean_t
+bloom_maybe_contains(fs_fs_data_t *ffd,
+                     const unsigned char *digest)
+{
+  int i;
+  for (i = 0; i < BLOOM_PROBE_COUNT; ++i)
+    {
+      apr_size_t bit = (  ((apr_size_t)digest[4*i  ] << 24)
+                        | ((apr_size_t)digest[4*i+1] << 16)
+                        | ((apr_size_t)digest[4*i+2] <<  8)
+                        |  (apr_size_t)digest[4*i+3])
+                       & ffd->rep_cache_bloom_mask;
+      if (!(ffd->rep_cache_bloom[bit / 8] & (1 << (bit % 8))))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Build the Bloom filter for FS from the contents of SDB, allocating
+   it in FS->pool.  Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+load_bloom_filter(svn_fs_t *fs,
+                  svn_sqlite__db_t *sdb,
+                  apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  svn_sqlite__stmt_t *stmt;
+  svn_boolean_t have_row;
+  apr_int64_t count;
+  apr_size_t bits;
+  int iterations = 0;
+  apr_pool_t *iterpool;
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, sdb, STMT_GET_REP_COUNT));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+  count = svn_sqlite__column_int64(stmt, 0);
+  SVN_ERR(svn_sqlite__reset(stmt));
+
+  /* Aim for ~8 bits per key, i.e. a false positive rate of roughly 2%
+     with BLOOM_PROBE_COUNT probes, rounded up to a power of two so that
+     masking can replace the modulo operation. */
+  bits = BLOOM_MIN_BITS;
+  while (bits < BLOOM_MAX_BITS && (apr_int64_t)bits < count * 8)
+    bits *= 2;
+
+  ffd->rep_cache_bloom_mask = bits - 1;
+  ffd->rep_cache_bloom = apr_pcalloc(fs->pool, bits / 8);
+
+  iterpool = svn_pool_create(scratch_pool);
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, sdb, STMT_GET_ALL_HASHES));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+  while (have_row)
+    {
+      const char *hex = svn_sqlite__column_text(stmt, 0, NULL);
+      svn_checksum_t *checksum;
+      svn_error_t *err;
+
+      /* Clear ITERPOOL occasionally. */
+      if (iterations++ % 16 == 0)
+        svn_pool_clear(iterpool);
+
+      /* Skip rows that are not valid SHA1 keys, such as the 'dummy' row
+         temporarily inserted by STMT_LOCK_REP. */
+      err = svn_checksum_parse_hex(&checksum, svn_checksum_sha1,
+                                   hex, iterpool);
+      if (err)
+        svn_error_clear(err);
+      else if (checksum)
+        bloom_insert(ffd, checksum->digest);
+
+      SVN_ERR(svn_sqlite__step(&have_row, stmt));
+    }
+
+  SVN_ERR(svn_sqlite__reset(stmt));
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
 
 /** Library-private API's. **/
 
@@ -112,6 +241,11 @@ open_rep_cache(void *baton,
       SVN_SQLITE__ERR_CLOSE(svn_sqlite__exec_statements(sdb, stmt), sdb);
     }
 
+  /* Remember which SHA1 keys exist so that the lookups for new
+     representations (the common case during commits) can be answered
+     without querying SQLite. */
+  SVN_SQLITE__ERR_CLOSE(load_bloom_filter(fs, sdb, pool), sdb);
+
   /* This is used as a flag that the database is available so don't
      set it earlier. */
   ffd->rep_cache_db = sdb;
@@ -141,6 +275,7 @@ svn_fs_fs__close_rep_cache(svn_fs_t *fs)
     {
       SVN_ERR(svn_sqlite__close(ffd->rep_cache_db));
       ffd->rep_cache_db = NULL;
+      ffd->rep_cache_bloom = NULL;
       ffd->rep_cache_db_opened = 0;
     }
 
@@ -281,6 +416,15 @@ svn_fs_fs__get_rep_reference(representation_t **rep_p,
                             _("Only SHA1 checksums can be used as keys in the "
                               "rep_cache table.\n"));
 
+  /* If the filter can prove that the key is not in the database, don't
+     bother SQLite with the query. */
+  if (ffd->rep_cache_bloom
+      && !bloom_maybe_contains(ffd, checksum->digest))
+    {
+      *rep_p = NULL;
+      return SVN_NO_ERROR;
+    }
+
   SVN_ERR(svn_sqlite__get_statement(&stmt, ffd->rep_cache_db, STMT_GET_REP));
   SVN_ERR(svn_sqlite__bindf(stmt, "s",
                             svn_checksum_to_cstring(checksum, pool)));
@@ -352,6 +496,11 @@ svn_fs_fs__set_rep_reference(svn_fs_t *fs,
 
   SVN_ERR(svn_sqlite__insert(NULL, stmt));
 
+  /* Keep the filter in sync with our own inserts so that a later lookup
+     for the same key is not short-circuited to "absent". */
+  if (ffd->rep_cache_bloom)
+    bloom_insert(ffd, rep->sha1_digest);
+
   return SVN_NO_ERROR;
 }
 
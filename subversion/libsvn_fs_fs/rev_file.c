@@ -20,6 +20,13 @@
  * ====================================================================
  */
 
+#include <apr_mmap.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <apr_portable.h>
+#endif
+
 #include "rev_file.h"
 #include "fs_fs.h"
 #include "index.h"
@@ -46,8 +53,12 @@ init_revision_file(svn_fs_fs__revision_file_t *file,
 
   file->file = NULL;
   file->stream = NULL;
+  file->mmap_data = NULL;
+  file->mmap_size = 0;
   file->p2l_stream = NULL;
   file->l2p_stream = NULL;
+  file->l2p_header = NULL;
+  file->p2l_header = NULL;
   file->block_size = ffd->block_size;
   file->l2p_offset = -1;
   file->l2p_checksum = NULL;
@@ -120,6 +131,38 @@ auto_make_writable(const char *path,
   return SVN_NO_ERROR;
 }
 
+/* Try to memory-map the read-only, open APR_FILE and make the mapping
+ * available through FILE's mmap_data / mmap_size members.  The mapping
+ * shares APR_FILE's life time, i.e. RESULT_POOL.  Leave FILE unchanged
+ * if the file cannot be mapped for whatever reason - callers must be
+ * prepared to fall back to plain file I/O anyway. */
+static void
+auto_map_file(svn_fs_fs__revision_file_t *file,
+              apr_file_t *apr_file,
+              apr_pool_t *result_pool)
+{
+#if APR_HAS_MMAP
+  apr_finfo_t finfo;
+  apr_mmap_t *mm;
+
+  if (apr_file_info_get(&finfo, APR_FINFO_SIZE, apr_file) != APR_SUCCESS)
+    return;
+
+  /* Empty files have nothing to map; files larger than the address
+   * space cannot be mapped in one go. */
+  if (finfo.size == 0 || (apr_uint64_t)finfo.size > APR_SIZE_MAX)
+    return;
+
+  if (apr_mmap_create(&mm, apr_file, 0, (apr_size_t)finfo.size,
+                      APR_MMAP_READ, result_pool) != APR_SUCCESS)
+    return;
+
+  /* The mapping gets removed automatically when RESULT_POOL is cleared. */
+  file->mmap_data = mm->mm;
+  file->mmap_size = finfo.size;
+#endif
+}
+
 /* Core implementation of svn_fs_fs__open_pack_or_rev_file working on an
  * existing, initialized FILE structure.  If WRITABLE is TRUE, give write
  * access to the file - temporarily resetting the r/o state if necessary.
@@ -160,6 +203,10 @@ open_pack_or_rev_file(svn_fs_fs__revision_file_t *file,
                                                   result_pool);
           file->is_packed = svn_fs_fs__is_packed_rev(fs, rev);
 
+          /* Writable files may grow, invalidating any mapping. */
+          if (!writable)
+            auto_map_file(file, apr_file, result_pool);
+
           return SVN_NO_ERROR;
         }
 
@@ -236,24 +283,43 @@ svn_fs_fs__auto_read_footer(svn_fs_fs__revision_file_t *file)
       unsigned char footer_length;
       svn_stringbuf_t *footer;
 
-      /* Determine file size. */
-      SVN_ERR(svn_io_file_seek(file->file, APR_END, &filesize, file->pool));
-
-      /* Read last byte (containing the length of the footer). */
-      SVN_ERR(svn_io_file_aligned_seek(file->file, file->block_size, NULL,
-                                       filesize - 1, file->pool));
-      SVN_ERR(svn_io_file_read_full2(file->file, &footer_length,
-                                     sizeof(footer_length), NULL, NULL,
-                                     file->pool));
-
-      /* Read footer. */
-      footer = svn_stringbuf_create_ensure(footer_length, file->pool);
-      SVN_ERR(svn_io_file_aligned_seek(file->file, file->block_size, NULL,
-                                       filesize - 1 - footer_length,
-                                       file->pool));
-      SVN_ERR(svn_io_file_read_full2(file->file, footer->data, footer_length,
-                                     &footer->len, NULL, file->pool));
-      footer->data[footer->len] = '\0';
+      if (file->mmap_data)
+        {
+          /* Serve the footer from the file mapping. */
+          filesize = file->mmap_size;
+          footer_length = (unsigned char)file->mmap_data[filesize - 1];
+          if ((apr_off_t)footer_length + 1 > filesize)
+            return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
+                                     _("Revision file r%ld footer too large"),
+                                     file->start_revision);
+
+          footer = svn_stringbuf_ncreate(
+                       file->mmap_data + filesize - 1 - footer_length,
+                       footer_length, file->pool);
+        }
+      else
+        {
+          /* Determine file size. */
+          SVN_ERR(svn_io_file_seek(file->file, APR_END, &filesize,
+                                   file->pool));
+
+          /* Read last byte (containing the length of the footer). */
+          SVN_ERR(svn_io_file_aligned_seek(file->file, file->block_size, NULL,
+                                           filesize - 1, file->pool));
+          SVN_ERR(svn_io_file_read_full2(file->file, &footer_length,
+                                         sizeof(footer_length), NULL, NULL,
+                                         file->pool));
+
+          /* Read footer. */
+          footer = svn_stringbuf_create_ensure(footer_length, file->pool);
+          SVN_ERR(svn_io_file_aligned_seek(file->file, file->block_size, NULL,
+                                           filesize - 1 - footer_length,
+                                           file->pool));
+          SVN_ERR(svn_io_file_read_full2(file->file, footer->data,
+                                         footer_length, &footer->len, NULL,
+                                         file->pool));
+          footer->data[footer->len] = '\0';
+        }
 
       /* Extract index locations. */
       SVN_ERR(svn_fs_fs__parse_footer(&file->l2p_offset, &file->l2p_checksum,
@@ -290,6 +356,24 @@ svn_fs_fs__open_proto_rev_file(svn_fs_fs__revision_file_t **file,
   return SVN_NO_ERROR;
 }
 
+void
+svn_fs_fs__uncache_revision_file(svn_fs_fs__revision_file_t *file,
+                                 svn_fs_t *fs)
+{
+#if defined(POSIX_FADV_DONTNEED)
+  fs_fs_data_t *ffd = fs->fsap_data;
+
+  if (ffd->uncache_maintenance_data && file->file)
+    {
+      apr_os_file_t fd;
+
+      /* This is a pure optimization, so ignore all errors. */
+      if (apr_os_file_get(&fd, file->file) == APR_SUCCESS)
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+#endif
+}
+
 svn_error_t *
 svn_fs_fs__close_revision_file(svn_fs_fs__revision_file_t *file)
 {
@@ -300,8 +384,12 @@ svn_fs_fs__close_revision_file(svn_fs_fs__revision_file_t *file)
 
   file->file = NULL;
   file->stream = NULL;
+  file->mmap_data = NULL;
+  file->mmap_size = 0;
   file->l2p_stream = NULL;
   file->p2l_stream = NULL;
+  file->l2p_header = NULL;
+  file->p2l_header = NULL;
 
   return SVN_NO_ERROR;
 }
@@ -57,12 +57,32 @@ typedef struct svn_fs_fs__revision_file_t
   /* stream based on FILE and not NULL exactly when FILE is not NULL */
   svn_stream_t *stream;
 
+  /* If not NULL, the whole rev / pack file is memory-mapped read-only
+   * and reads of up to MMAP_SIZE bytes may be served directly from this
+   * buffer instead of FILE.  NULL for writable files, txn proto-rev
+   * files and whenever the platform or file size prevents mapping. */
+  const char *mmap_data;
+
+  /* Size of the buffer MMAP_DATA.  0 if MMAP_DATA is NULL. */
+  apr_off_t mmap_size;
+
   /* the opened P2L index stream or NULL.  Always NULL for txns. */
   svn_fs_fs__packed_number_stream_t *p2l_stream;
 
   /* the opened L2P index stream or NULL.  Always NULL for txns. */
   svn_fs_fs__packed_number_stream_t *l2p_stream;
 
+  /* Deserialized header ("root pages") of the L2P index of this file,
+   * kept here from the first L2P lookup onwards, or NULL.  The index is
+   * immutable, so the copy stays valid for the lifetime of this object
+   * and gives all further lookups direct pointer access to the page
+   * tables instead of a (de-)serializing cache round-trip per lookup.
+   * Always NULL for txns. */
+  struct l2p_header_t *l2p_header;
+
+  /* Same for the header of the P2L index.  Always NULL for txns. */
+  struct p2l_header_t *p2l_header;
+
   /* Copied from FS->FFD->BLOCK_SIZE upon creation.  It allows us to
    * use aligned seek() without having the FS handy. */
   apr_off_t block_size;
@@ -137,6 +157,16 @@ svn_fs_fs__open_proto_rev_file(svn_fs_fs__revision_file_t **file,
                                apr_pool_t* result_pool,
                                apr_pool_t *scratch_pool);
 
+/* If the UNCACHE_MAINTENANCE_DATA option is enabled in FS, advise the OS
+ * to drop the data of FILE from its page cache.  To be called by whole-
+ * shard maintenance operations (pack, verify) once they are done reading
+ * FILE, typically right before closing it.  This is advisory only and a
+ * no-op on platforms without the relevant support.
+ */
+void
+svn_fs_fs__uncache_revision_file(svn_fs_fs__revision_file_t *file,
+                                 svn_fs_t *fs);
+
 /* Close all files and streams in FILE.
  */
 svn_error_t *
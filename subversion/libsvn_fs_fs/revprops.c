@@ -79,6 +79,7 @@ svn_fs_fs__upgrade_pack_revprops(svn_fs_t *fs,
                                              shard, ffd->max_files_per_dir,
                                              (int)(0.9 * ffd->revprop_pack_size),
                                              compression_level,
+                                             ffd->indexed_packed_revprops,
                                              ffd->flush_to_disk,
                                              cancel_func, cancel_baton,
                                              iterpool));
@@ -440,11 +441,197 @@ same_shard(svn_fs_t *fs,
   return (r1 / ffd->max_files_per_dir) == (r2 / ffd->max_files_per_dir);
 }
 
+/* The first bytes of a packed revprop file in the indexed format.
+ *
+ * This cannot clash with the non-indexed format:  there, the file starts
+ * with the 7b/8b-encoded length of the uncompressed content.  A leading
+ * 'P' would parse as a complete one-byte length, followed either by a
+ * zlib stream (which begins with a compression method byte, never 'A')
+ * or by the stored plain text (which begins with the decimal first
+ * revision number).
+ */
+#define PACK_FORMAT2_SIGNATURE "PACK2\n"
+#define PACK_FORMAT2_SIGNATURE_LEN (sizeof(PACK_FORMAT2_SIGNATURE) - 1)
+
+/* Return TRUE if the packed revprop file CONTENT uses the indexed format.
+ */
+static svn_boolean_t
+is_packed_revprops_v2(svn_stringbuf_t *content)
+{
+  return content->len > PACK_FORMAT2_SIGNATURE_LEN
+      && memcmp(content->data, PACK_FORMAT2_SIGNATURE,
+                PACK_FORMAT2_SIGNATURE_LEN) == 0;
+}
+
+/* Implementation of parse_packed_revprops() for the indexed format.
+ * REVPROPS->PACKED_REVPROPS contains the raw file content; only those
+ * entries that are actually being requested or cached get decompressed.
+ */
+static svn_error_t *
+parse_packed_revprops_v2(svn_fs_t *fs,
+                         packed_revprops_t *revprops,
+                         svn_boolean_t read_all,
+                         svn_boolean_t populate_cache,
+                         apr_pool_t *result_pool,
+                         apr_pool_t *scratch_pool)
+{
+  svn_stream_t *stream;
+  apr_int64_t first_rev, count, i;
+  apr_size_t offset;
+  const char *header_end;
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  svn_stringbuf_t *packed = revprops->packed_revprops;
+  svn_stringbuf_t *uncompressed = NULL;
+  svn_stringbuf_t *entry = svn_stringbuf_create_empty(scratch_pool);
+  svn_string_t *header = apr_palloc(scratch_pool, sizeof(*header));
+
+  /* Initial value for the "Leaking bucket" pattern. */
+  int bucket = 4;
+
+  /* The header is stored as plain text right after the signature. */
+  header->data = packed->data + PACK_FORMAT2_SIGNATURE_LEN;
+  header->len = packed->len - PACK_FORMAT2_SIGNATURE_LEN;
+  stream = svn_stream_from_string(header, scratch_pool);
+
+  /* read first revision number and number of revisions in the pack */
+  SVN_ERR(svn_fs_fs__read_number_from_stream(&first_rev, NULL, stream,
+                                             iterpool));
+  SVN_ERR(svn_fs_fs__read_number_from_stream(&count, NULL, stream,
+                                             iterpool));
+
+  /* Check revision range for validity. */
+  if (   !same_shard(fs, revprops->revision, first_rev)
+      || !same_shard(fs, revprops->revision, first_rev + count - 1)
+      || count < 1)
+    return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
+                             _("Revprop pack for revision r%ld"
+                               " contains revprops for r%ld .. r%ld"),
+                             revprops->revision,
+                             (svn_revnum_t)first_rev,
+                             (svn_revnum_t)(first_rev + count -1));
+
+  /* Since start & end are in the same shard, it is enough to just test
+   * the FIRST_REV for being actually packed.  That will also cover the
+   * special case of rev 0 never being packed. */
+  if (!svn_fs_fs__is_packed_revprop(fs, first_rev))
+    return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
+                             _("Revprop pack for revision r%ld"
+                               " starts at non-packed revisions r%ld"),
+                             revprops->revision, (svn_revnum_t)first_rev);
+
+  /* The first compressed entry follows the header. */
+  header_end = strstr(header->data, "\n\n");
+  if (header_end == NULL)
+    return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
+                            _("Header end not found"));
+
+  offset = (header_end + 2) - packed->data;
+
+  revprops->start_revision = (svn_revnum_t)first_rev;
+  if (read_all)
+    {
+      /* Init / construct REVPROPS members. */
+      revprops->sizes = apr_array_make(result_pool, (int)count,
+                                       sizeof(offset));
+      revprops->offsets = apr_array_make(result_pool, (int)count,
+                                         sizeof(offset));
+      uncompressed = svn_stringbuf_create_empty(result_pool);
+    }
+
+  /* Now walk, revision by revision, over the compressed entries.  In
+   * contrast to the non-indexed format, entries that nobody asked for
+   * will simply be skipped. */
+  for (i = 0, revprops->total_size = 0; i < count; ++i)
+    {
+      apr_int64_t size;
+      svn_revnum_t revision = (svn_revnum_t)(first_rev + i);
+      svn_boolean_t is_revision = (revision == revprops->revision);
+      svn_pool_clear(iterpool);
+
+      /* read & check the compressed size */
+      SVN_ERR(svn_fs_fs__read_number_from_stream(&size, NULL, stream,
+                                                 iterpool));
+      if (size < 1 || size > (apr_int64_t)(packed->len - offset))
+        return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
+                        _("Packed revprop size exceeds pack file size"));
+
+      /* Decompress this revprop list only if anyone is interested in it. */
+      if (read_all || populate_cache || is_revision)
+        {
+          svn_string_t serialized;
+          SVN_ERR(svn__decompress_lz4(packed->data + offset,
+                                      (apr_size_t)size, entry,
+                                      APR_SIZE_MAX));
+          serialized.data = entry->data;
+          serialized.len = entry->len;
+
+          if (is_revision)
+            {
+              /* Parse the one revprop list we care about. */
+              SVN_ERR(parse_revprop(&revprops->properties, fs, revision,
+                                    &serialized, result_pool, iterpool));
+              revprops->serialized_size = serialized.len;
+            }
+
+          if (populate_cache)
+            {
+              /* Same "Leaking bucket" heuristics as for the non-indexed
+               * format:  stop adding entries once too many of them turn
+               * out to be cached already. */
+              svn_boolean_t already_cached;
+              SVN_ERR(cache_revprops(&already_cached, fs, revision,
+                                     &serialized, iterpool));
+
+              if (!already_cached)
+                {
+                  ++bucket;
+                }
+              else
+                {
+                  bucket -= 2;
+                  if (bucket < 0)
+                    populate_cache = FALSE;
+                }
+            }
+
+          if (read_all)
+            {
+              /* fill REVPROPS data structures */
+              APR_ARRAY_PUSH(revprops->sizes, apr_size_t) = serialized.len;
+              APR_ARRAY_PUSH(revprops->offsets, apr_size_t)
+                = uncompressed->len;
+              svn_stringbuf_appendbytes(uncompressed, serialized.data,
+                                        serialized.len);
+              revprops->total_size += serialized.len;
+            }
+
+          /* If we only wanted the revprops for REVISION then we are done. */
+          if (is_revision && !read_all && !populate_cache)
+            break;
+        }
+
+      offset += (apr_size_t)size;
+    }
+
+  if (read_all)
+    {
+      /* From here on, expose the concatenated plain-text representation
+       * such that the modification / repacking code sees the very same
+       * data structures as for non-indexed packs. */
+      revprops->packed_revprops = uncompressed;
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
 /* Given FS and the full packed file content in REVPROPS->PACKED_REVPROPS,
  * fill the START_REVISION member, and make PACKED_REVPROPS point to the
  * first serialized revprop.  If READ_ALL is set, initialize the SIZES
  * and OFFSETS members as well.  If POPULATE_CACHE is set, cache all
- * revprops found in this pack.
+ * revprops found in this pack.  Files in the indexed format will be
+ * detected automatically and handed over to parse_packed_revprops_v2().
  *
  * Parse the revprops for REVPROPS->REVISION and set the PROPERTIES as
  * well as the SERIALIZED_SIZE member.  If revprop caching has been
@@ -467,10 +654,18 @@ parse_packed_revprops(svn_fs_t *fs,
   /* Initial value for the "Leaking bucket" pattern. */
   int bucket = 4;
 
-  /* decompress (even if the data is only "stored", there is still a
-   * length header to remove) */
   svn_stringbuf_t *compressed = revprops->packed_revprops;
   svn_stringbuf_t *uncompressed = svn_stringbuf_create_empty(result_pool);
+
+  /* Indexed pack files have their own parser. */
+  if (is_packed_revprops_v2(compressed))
+    return svn_error_trace(parse_packed_revprops_v2(fs, revprops, read_all,
+                                                    populate_cache,
+                                                    result_pool,
+                                                    scratch_pool));
+
+  /* decompress (even if the data is only "stored", there is still a
+   * length header to remove) */
   SVN_ERR(svn__decompress_zlib(compressed->data, compressed->len,
                                uncompressed, APR_SIZE_MAX));
 
@@ -937,6 +1132,131 @@ serialize_revprops_header(svn_stream_t *stream,
   return SVN_NO_ERROR;
 }
 
+/* Write the header of an indexed pack file to STREAM.  The pack starts
+ * at revision START_REVISION and ENTRIES contains the individually
+ * compressed revprop list of each revision (svn_stringbuf_t *).
+ */
+static svn_error_t *
+serialize_revprops_header_v2(svn_stream_t *stream,
+                             svn_revnum_t start_revision,
+                             apr_array_header_t *entries,
+                             apr_pool_t *pool)
+{
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  int i;
+
+  SVN_ERR_ASSERT(entries->nelts > 0);
+
+  /* signature, start revision and entry count */
+  SVN_ERR(svn_stream_puts(stream, PACK_FORMAT2_SIGNATURE));
+  SVN_ERR(svn_stream_printf(stream, pool, "%ld\n", start_revision));
+  SVN_ERR(svn_stream_printf(stream, pool, "%d\n", entries->nelts));
+
+  /* the compressed sizes array */
+  for (i = 0; i < entries->nelts; ++i)
+    {
+      svn_stringbuf_t *entry = APR_ARRAY_IDX(entries, i, svn_stringbuf_t *);
+      SVN_ERR(svn_stream_printf(stream, iterpool, "%" APR_SIZE_T_FMT "\n",
+                                entry->len));
+    }
+
+  /* the double newline char indicates the end of the header */
+  SVN_ERR(svn_stream_puts(stream, "\n"));
+
+  svn_pool_destroy(iterpool);
+  return SVN_NO_ERROR;
+}
+
+/* Write a complete indexed pack file covering the revisions starting at
+ * START_REVISION to FILE; flush (if FLUSH_TO_DISK is set) and close it.
+ * ENTRIES contains the individually compressed revprop list of each
+ * revision (svn_stringbuf_t *).  Use POOL for temporary allocations.
+ */
+static svn_error_t *
+write_revprops_pack_v2(apr_file_t *file,
+                       svn_revnum_t start_revision,
+                       apr_array_header_t *entries,
+                       svn_boolean_t flush_to_disk,
+                       apr_pool_t *pool)
+{
+  svn_stream_t *stream;
+  int i;
+  svn_stringbuf_t *content = svn_stringbuf_create_empty(pool);
+
+  /* construct the pack file content in memory */
+  stream = svn_stream_from_stringbuf(content, pool);
+  SVN_ERR(serialize_revprops_header_v2(stream, start_revision, entries,
+                                       pool));
+
+  for (i = 0; i < entries->nelts; ++i)
+    {
+      svn_stringbuf_t *entry = APR_ARRAY_IDX(entries, i, svn_stringbuf_t *);
+      apr_size_t len = entry->len;
+      SVN_ERR(svn_stream_write(stream, entry->data, &len));
+    }
+
+  /* flush the stream buffer (if any) to our underlying data buffer */
+  SVN_ERR(svn_stream_close(stream));
+
+  /* finally, write the content to the target file, flush and close it */
+  SVN_ERR(svn_io_file_write_full(file, content->data, content->len,
+                                 NULL, pool));
+  if (flush_to_disk)
+    SVN_ERR(svn_io_file_flush_to_disk(file, pool));
+  SVN_ERR(svn_io_file_close(file, pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Implementation of repack_revprops() for the indexed pack format.
+ * Parameters are as for repack_revprops(); no total size hint is needed
+ * because every revprop list gets compressed on its own.
+ */
+static svn_error_t *
+repack_revprops_v2(svn_fs_t *fs,
+                   packed_revprops_t *revprops,
+                   int start,
+                   int end,
+                   int changed_index,
+                   svn_stringbuf_t *new_serialized,
+                   apr_file_t *file,
+                   apr_pool_t *pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  int i;
+  apr_array_header_t *entries
+    = apr_array_make(pool, end - start, sizeof(svn_stringbuf_t *));
+
+  /* compress each revprop list individually */
+  for (i = start; i < end; ++i)
+    {
+      svn_stringbuf_t *compressed = svn_stringbuf_create_empty(pool);
+
+      if (i == changed_index)
+        {
+          SVN_ERR(svn__compress_lz4(new_serialized->data,
+                                    new_serialized->len, compressed));
+        }
+      else
+        {
+          apr_size_t size = APR_ARRAY_IDX(revprops->sizes, i, apr_size_t);
+          apr_size_t offset = APR_ARRAY_IDX(revprops->offsets, i,
+                                            apr_size_t);
+
+          SVN_ERR(svn__compress_lz4(revprops->packed_revprops->data + offset,
+                                    size, compressed));
+        }
+
+      APR_ARRAY_PUSH(entries, svn_stringbuf_t *) = compressed;
+    }
+
+  return svn_error_trace(write_revprops_pack_v2(file,
+                                                revprops->start_revision
+                                                  + start,
+                                                entries, ffd->flush_to_disk,
+                                                pool));
+}
+
 /* Writes the a pack file to FILE.  It copies the serialized data
  * from REVPROPS for the indexes [START,END) except for index CHANGED_INDEX.
  *
@@ -946,6 +1266,10 @@ serialize_revprops_header(svn_stream_t *stream,
  *
  * NEW_TOTAL_SIZE is a hint for pre-allocating buffers of appropriate size.
  * POOL is used for temporary allocations.
+ *
+ * If the indexed pack format has been enabled in FS, the file will be
+ * written in that format - regardless of the format of the pack file
+ * that the data came from.
  */
 static svn_error_t *
 repack_revprops(svn_fs_t *fs,
@@ -961,12 +1285,19 @@ repack_revprops(svn_fs_t *fs,
   fs_fs_data_t *ffd = fs->fsap_data;
   svn_stream_t *stream;
   int i;
+  svn_stringbuf_t *uncompressed;
+  svn_stringbuf_t *compressed;
+
+  /* The indexed format has its own writer. */
+  if (ffd->indexed_packed_revprops)
+    return svn_error_trace(repack_revprops_v2(fs, revprops, start, end,
+                                              changed_index, new_serialized,
+                                              file, pool));
 
   /* create data empty buffers and the stream object */
-  svn_stringbuf_t *uncompressed
-    = svn_stringbuf_create_ensure((apr_size_t)new_total_size, pool);
-  svn_stringbuf_t *compressed
-    = svn_stringbuf_create_empty(pool);
+  uncompressed = svn_stringbuf_create_ensure((apr_size_t)new_total_size,
+                                             pool);
+  compressed = svn_stringbuf_create_empty(pool);
   stream = svn_stream_from_stringbuf(uncompressed, pool);
 
   /* write the header*/
@@ -1339,6 +1670,64 @@ svn_fs_fs__packed_revprop_available(svn_boolean_t *missing,
 
 /****** Packing FSFS shards *********/
 
+/* Implementation of svn_fs_fs__copy_revprops() for the indexed pack
+ * format.  Parameters are as for that function; no compression level
+ * applies because the entries are always LZ4-compressed individually.
+ */
+static svn_error_t *
+copy_revprops_v2(const char *pack_file_dir,
+                 const char *pack_filename,
+                 const char *shard_path,
+                 svn_revnum_t start_rev,
+                 svn_revnum_t end_rev,
+                 svn_boolean_t flush_to_disk,
+                 svn_cancel_func_t cancel_func,
+                 void *cancel_baton,
+                 apr_pool_t *scratch_pool)
+{
+  apr_file_t *pack_file;
+  svn_revnum_t rev;
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  apr_array_header_t *entries
+    = apr_array_make(scratch_pool, (int)(end_rev - start_rev + 1),
+                     sizeof(svn_stringbuf_t *));
+
+  /* Iterate over the revisions in this shard, compressing each revprop
+   * list on its own. */
+  for (rev = start_rev; rev <= end_rev; rev++)
+    {
+      const char *path;
+      svn_stringbuf_t *content;
+      svn_stringbuf_t *compressed = svn_stringbuf_create_empty(scratch_pool);
+
+      svn_pool_clear(iterpool);
+
+      if (cancel_func)
+        SVN_ERR(cancel_func(cancel_baton));
+
+      /* Construct the file name. */
+      path = svn_dirent_join(shard_path, apr_psprintf(iterpool, "%ld", rev),
+                             iterpool);
+
+      SVN_ERR(svn_stringbuf_from_file2(&content, path, iterpool));
+      SVN_ERR(svn__compress_lz4(content->data, content->len, compressed));
+      APR_ARRAY_PUSH(entries, svn_stringbuf_t *) = compressed;
+    }
+
+  /* write the pack file in a single operation */
+  SVN_ERR(svn_io_file_open(&pack_file, svn_dirent_join(pack_file_dir,
+                                                       pack_filename,
+                                                       scratch_pool),
+                           APR_WRITE | APR_CREATE, APR_OS_DEFAULT,
+                           scratch_pool));
+  SVN_ERR(write_revprops_pack_v2(pack_file, start_rev, entries,
+                                 flush_to_disk, scratch_pool));
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_fs_fs__copy_revprops(const char *pack_file_dir,
                          const char *pack_filename,
@@ -1348,6 +1737,7 @@ svn_fs_fs__copy_revprops(const char *pack_file_dir,
                          apr_array_header_t *sizes,
                          apr_size_t total_size,
                          int compression_level,
+                         svn_boolean_t indexed,
                          svn_boolean_t flush_to_disk,
                          svn_cancel_func_t cancel_func,
                          void *cancel_baton,
@@ -1356,13 +1746,23 @@ svn_fs_fs__copy_revprops(const char *pack_file_dir,
   svn_stream_t *pack_stream;
   apr_file_t *pack_file;
   svn_revnum_t rev;
-  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  apr_pool_t *iterpool;
+  svn_stringbuf_t *uncompressed;
+  svn_stringbuf_t *compressed;
+
+  /* The indexed format has its own writer. */
+  if (indexed)
+    return svn_error_trace(copy_revprops_v2(pack_file_dir, pack_filename,
+                                            shard_path, start_rev, end_rev,
+                                            flush_to_disk,
+                                            cancel_func, cancel_baton,
+                                            scratch_pool));
+
+  iterpool = svn_pool_create(scratch_pool);
 
   /* create empty data buffer and a write stream on top of it */
-  svn_stringbuf_t *uncompressed
-    = svn_stringbuf_create_ensure(total_size, scratch_pool);
-  svn_stringbuf_t *compressed
-    = svn_stringbuf_create_empty(scratch_pool);
+  uncompressed = svn_stringbuf_create_ensure(total_size, scratch_pool);
+  compressed = svn_stringbuf_create_empty(scratch_pool);
   pack_stream = svn_stream_from_stringbuf(uncompressed, scratch_pool);
 
   /* write the pack file header */
@@ -1425,6 +1825,7 @@ svn_fs_fs__pack_revprops_shard(const char *pack_file_dir,
                                int max_files_per_dir,
                                apr_int64_t max_pack_size,
                                int compression_level,
+                               svn_boolean_t indexed,
                                svn_boolean_t flush_to_disk,
                                svn_cancel_func_t cancel_func,
                                void *cancel_baton,
@@ -1497,7 +1898,8 @@ svn_fs_fs__pack_revprops_shard(const char *pack_file_dir,
           SVN_ERR(svn_fs_fs__copy_revprops(pack_file_dir, pack_filename,
                                            shard_path, start_rev, rev-1,
                                            sizes, total_size,
-                                           compression_level, flush_to_disk,
+                                           compression_level, indexed,
+                                           flush_to_disk,
                                            cancel_func, cancel_baton,
                                            iterpool));
 
@@ -1525,7 +1927,8 @@ svn_fs_fs__pack_revprops_shard(const char *pack_file_dir,
     SVN_ERR(svn_fs_fs__copy_revprops(pack_file_dir, pack_filename,
                                      shard_path, start_rev, rev-1,
                                      sizes, (apr_size_t)total_size,
-                                     compression_level, flush_to_disk,
+                                     compression_level, indexed,
+                                     flush_to_disk,
                                      cancel_func, cancel_baton, iterpool));
 
   /* flush the manifest file to disk and update permissions */
@@ -155,10 +155,15 @@ typedef struct revision_info_t
   /* total size of file noderevs (i.e. the structs - not the rep) */
   apr_uint64_t file_noderev_size;
 
-  /* all rep_stats_t of this revision (in no particular order),
+  /* all rep_stats_t of this revision (sorted by item index),
    * i.e. those that point back to this struct */
   apr_array_header_t *representations;
 
+  /* while the revision is being read, insertion buffer wrapped around
+   * REPRESENTATIONS so that out-of-order discoveries do not cost an
+   * O(N) memmove each; NULL once the revision is complete */
+  svn_sorted_array__t *rep_index;
+
   /* Temporary rev / pack file access object, used in phys. addressing
    * mode only.  NULL when done reading this revision. */
   svn_fs_fs__revision_file_t *rev_file;
@@ -182,7 +187,11 @@ typedef struct query_t
   /* First non-packed revision. */
   svn_revnum_t min_unpacked_rev;
 
-  /* all revisions */
+  /* First revision to scan; 0 for a full scan.  Always aligned to a pack
+   * file boundary if it lies within the packed part of the repo. */
+  svn_revnum_t start_revision;
+
+  /* all revisions; entries for revisions before START_REVISION are NULL */
   apr_array_header_t *revisions;
 
   /* empty representation.
@@ -370,24 +379,35 @@ compare_representation_item_index(const void *data, const void *key)
   return (lhs > rhs ? 1 : 0);
 }
 
+/* Comparator ordering two rep_stats_t ** by their item index.  This is
+ * the element ordering of revision_info_t->representations.
+ */
+static int
+compare_representation_items(const void *lhs, const void *rhs)
+{
+  apr_uint64_t lhs_index = (*(const rep_stats_t *const *)lhs)->item_index;
+  apr_uint64_t rhs_index = (*(const rep_stats_t *const *)rhs)->item_index;
+
+  if (lhs_index < rhs_index)
+    return -1;
+  return (lhs_index > rhs_index ? 1 : 0);
+}
+
 /* Find the revision_info_t object to the given REVISION in QUERY and
  * return it in *REVISION_INFO. For performance reasons, we skip the
  * lookup if the info is already provided.
  *
  * In that revision, look for the rep_stats_t object for item ITEM_INDEX.
- * If it already exists, set *IDX to its index in *REVISION_INFO's
- * representations list and return the representation object. Otherwise,
- * set the index to where it must be inserted and return NULL.
+ * If it already exists, return it; otherwise, return NULL.
  */
 static rep_stats_t *
-find_representation(int *idx,
-                    query_t *query,
+find_representation(query_t *query,
                     revision_info_t **revision_info,
                     svn_revnum_t revision,
                     apr_uint64_t item_index)
 {
   revision_info_t *info;
-  *idx = -1;
+  rep_stats_t **result;
 
   /* first let's find the revision */
   info = revision_info ? *revision_info : NULL;
@@ -403,20 +423,15 @@ find_representation(int *idx,
     return NULL;
 
   /* look for the representation */
-  *idx = svn_sort__bsearch_lower_bound(info->representations,
-                                       &item_index,
-                                       compare_representation_item_index);
-  if (*idx < info->representations->nelts)
-    {
-      /* return the representation, if this is the one we were looking for */
-      rep_stats_t *result
-        = APR_ARRAY_IDX(info->representations, *idx, rep_stats_t *);
-      if (result->item_index == item_index)
-        return result;
-    }
+  if (info->rep_index)
+    result = svn_sorted_array__lookup(info->rep_index, &item_index,
+                                      compare_representation_item_index);
+  else
+    result = svn_sort__array_lookup(info->representations, &item_index,
+                                    NULL, compare_representation_item_index);
 
-  /* not parsed, yet */
-  return NULL;
+  /* not parsed, yet, if NULL */
+  return result ? *result : NULL;
 }
 
 /* Find / auto-construct the representation stats for REP in QUERY and
@@ -434,12 +449,19 @@ parse_representation(rep_stats_t **representation,
                      apr_pool_t *scratch_pool)
 {
   rep_stats_t *result;
-  int idx;
+
+  /* Reps in revisions before the scanned range have been accounted for
+   * by a previous run; references to them are not tracked. */
+  if (rep->revision < query->start_revision)
+    {
+      *representation = NULL;
+      return SVN_NO_ERROR;
+    }
 
   /* read location (revision, offset) and size */
 
   /* look it up */
-  result = find_representation(&idx, query, &revision_info, rep->revision,
+  result = find_representation(query, &revision_info, rep->revision,
                                rep->item_index);
   if (!result)
     {
@@ -473,14 +495,17 @@ parse_representation(rep_stats_t **representation,
           /* Determine length of the delta chain. */
           if (header->type == svn_fs_fs__rep_delta)
             {
-              int base_idx;
               rep_stats_t *base_rep
-                = find_representation(&base_idx, query, NULL,
+                = find_representation(query, NULL,
                                       header->base_revision,
                                       header->base_item_index);
 
-              result->chain_length = 1 + MIN(base_rep->chain_length,
-                                             (apr_byte_t)0xfe);
+              /* The base may lie before the scanned range; its chain
+               * length is then unknown, so count only the link we saw. */
+              result->chain_length = base_rep
+                                   ? 1 + MIN(base_rep->chain_length,
+                                             (apr_byte_t)0xfe)
+                                   : 2;
             }
           else
             {
@@ -488,7 +513,20 @@ parse_representation(rep_stats_t **representation,
             }
         }
 
-      SVN_ERR(svn_sort__array_insert2(revision_info->representations, &result, idx));
+      if (revision_info->rep_index)
+        {
+          svn_sorted_array__insert(revision_info->rep_index, &result);
+        }
+      else
+        {
+          /* Rare: a reference into an already completed revision. */
+          int idx
+            = svn_sort__bsearch_lower_bound(revision_info->representations,
+                                            &rep->item_index,
+                                            compare_representation_item_index);
+          SVN_ERR(svn_sort__array_insert2(revision_info->representations,
+                                          &result, idx));
+        }
     }
 
   *representation = result;
@@ -629,7 +667,7 @@ read_noderev(query_t *query,
                                    result_pool, scratch_pool));
 
       /* if we are the first to use this rep, mark it as "text rep" */
-      if (++text->ref_count == 1)
+      if (text && ++text->ref_count == 1)
         text->kind = noderev->kind == svn_node_dir ? dir_rep : file_rep;
     }
 
@@ -640,7 +678,7 @@ read_noderev(query_t *query,
                                    result_pool, scratch_pool));
 
       /* if we are the first to use this rep, mark it as "prop rep" */
-      if (++props->ref_count == 1)
+      if (props && ++props->ref_count == 1)
         props->kind = noderev->kind == svn_node_dir ? dir_property_rep
                                                     : file_property_rep;
     }
@@ -788,6 +826,9 @@ read_phys_pack_file(query_t *query,
       info = apr_pcalloc(result_pool, sizeof(*info));
       info->representations = apr_array_make(result_pool, 4,
                                              sizeof(rep_stats_t*));
+      info->rep_index = svn_sorted_array__create(info->representations,
+                                                 compare_representation_items,
+                                                 iterpool);
       info->rev_file = rev_file;
 
       info->revision = base + i;
@@ -801,6 +842,10 @@ read_phys_pack_file(query_t *query,
 
       SVN_ERR(read_phys_revision(query, info, result_pool, iterpool));
 
+      /* Finalize the ordering and dispose of the build-time buffer. */
+      svn_sorted_array__flush(info->rep_index);
+      info->rep_index = NULL;
+
       info->representations = apr_array_copy(result_pool,
                                              info->representations);
 
@@ -851,6 +896,9 @@ read_phys_revision_file(query_t *query,
 
   /* create the revision info for the current rev */
   info->representations = apr_array_make(result_pool, 4, sizeof(rep_stats_t*));
+  info->rep_index = svn_sorted_array__create(info->representations,
+                                             compare_representation_items,
+                                             scratch_pool);
 
   info->rev_file = rev_file;
   info->revision = revision;
@@ -859,6 +907,10 @@ read_phys_revision_file(query_t *query,
 
   SVN_ERR(read_phys_revision(query, info, result_pool, scratch_pool));
 
+  /* Finalize the ordering and dispose of the build-time buffer. */
+  svn_sorted_array__flush(info->rep_index);
+  info->rep_index = NULL;
+
   /* Done with this revision. */
   SVN_ERR(svn_fs_fs__close_revision_file(rev_file));
   info->rev_file = NULL;
@@ -955,9 +1007,8 @@ resolve_representation_refs(query_t *query,
   /* Build up the CHAIN_LENGTH values. */
   for (i = 0; i < rep_refs->nelts; ++i)
     {
-      int idx;
       rep_ref_t *ref = APR_ARRAY_IDX(rep_refs, i, rep_ref_t *);
-      rep_stats_t *rep = find_representation(&idx, query, NULL,
+      rep_stats_t *rep = find_representation(query, NULL,
                                              ref->revision, ref->item_index);
 
       /* No dangling pointers and all base reps have been processed. */
@@ -976,12 +1027,23 @@ resolve_representation_refs(query_t *query,
         {
           rep_stats_t *base;
 
-          base = find_representation(&idx, query, NULL, ref->base_revision,
+          base = find_representation(query, NULL, ref->base_revision,
                                      ref->base_item_index);
-          SVN_ERR_ASSERT(base);
-          SVN_ERR_ASSERT(base->chain_length);
+          if (base)
+            {
+              SVN_ERR_ASSERT(base->chain_length);
 
-          rep->chain_length = 1 + MIN(base->chain_length, (apr_byte_t)0xfe);
+              rep->chain_length = 1 + MIN(base->chain_length,
+                                          (apr_byte_t)0xfe);
+            }
+          else
+            {
+              /* All in-range base reps have been processed already, so
+               * this base must lie before the scanned range.  Its chain
+               * length is unknown; count only the link we saw. */
+              SVN_ERR_ASSERT(ref->base_revision < query->start_revision);
+              rep->chain_length = 2;
+            }
         }
     }
 
@@ -1021,6 +1083,9 @@ read_log_rev_or_packfile(query_t *query,
       revision_info_t *info = apr_pcalloc(result_pool, sizeof(*info));
       info->representations = apr_array_make(result_pool, 4,
                                              sizeof(rep_stats_t*));
+      info->rep_index = svn_sorted_array__create(info->representations,
+                                                 compare_representation_items,
+                                                 scratch_pool);
       info->revision = base + i;
 
       APR_ARRAY_PUSH(query->revisions, revision_info_t*) = info;
@@ -1125,6 +1190,16 @@ read_log_rev_or_packfile(query_t *query,
         }
     }
 
+  /* Finalize the representation lists and dispose of the build-time
+   * buffers. */
+  for (i = 0; i < count; ++i)
+    {
+      revision_info_t *info = APR_ARRAY_IDX(query->revisions, base + i,
+                                            revision_info_t*);
+      svn_sorted_array__flush(info->rep_index);
+      info->rep_index = NULL;
+    }
+
   /* Resolve the delta chain links. */
   SVN_ERR(resolve_representation_refs(query, rep_refs));
 
@@ -1196,8 +1271,8 @@ read_revisions(query_t *query,
   apr_pool_t *iterpool = svn_pool_create(scratch_pool);
   svn_revnum_t revision;
 
-  /* read all packed revs */
-  for ( revision = 0
+  /* read all packed revs (within the requested range) */
+  for ( revision = query->start_revision
       ; revision < query->min_unpacked_rev
       ; revision += query->shard_size)
     {
@@ -1267,12 +1342,18 @@ aggregate_stats(const apr_array_header_t *revisions,
   int i, k;
 
   /* aggregate info from all revisions */
-  stats->revision_count = revisions->nelts;
+  stats->revision_count = 0;
   for (i = 0; i < revisions->nelts; ++i)
     {
       revision_info_t *revision = APR_ARRAY_IDX(revisions, i,
                                                 revision_info_t *);
 
+      /* revisions before the scanned range have no info */
+      if (revision == NULL)
+        continue;
+
+      stats->revision_count++;
+
       /* data gathered on a revision level */
       stats->change_count += revision->change_count;
       stats->change_len += revision->changes_len;
@@ -1331,14 +1412,16 @@ create_stats(apr_pool_t *result_pool)
 }
 
 /* Create a *QUERY, allocated in RESULT_POOL, reading filesystem FS and
- * collecting results in STATS.  Store the optional PROCESS_FUNC and
- * PROGRESS_BATON as well as CANCEL_FUNC and CANCEL_BATON in *QUERY, too.
- * Use SCRATCH_POOL for temporary allocations.
+ * collecting results in STATS.  Limit the scan to revisions
+ * START_REVISION and later; pass 0 for a full scan.  Store the optional
+ * PROCESS_FUNC and PROGRESS_BATON as well as CANCEL_FUNC and CANCEL_BATON
+ * in *QUERY, too.  Use SCRATCH_POOL for temporary allocations.
  */
 static svn_error_t *
 create_query(query_t **query,
              svn_fs_t *fs,
              svn_fs_fs__stats_t *stats,
+             svn_revnum_t start_revision,
              svn_fs_progress_notify_func_t progress_func,
              void *progress_baton,
              svn_cancel_func_t cancel_func,
@@ -1346,6 +1429,8 @@ create_query(query_t **query,
              apr_pool_t *result_pool,
              apr_pool_t *scratch_pool)
 {
+  svn_revnum_t revision;
+
   *query = apr_pcalloc(result_pool, sizeof(**query));
 
   /* Read repository dimensions. */
@@ -1354,6 +1439,16 @@ create_query(query_t **query,
   SVN_ERR(svn_fs_fs__min_unpacked_rev(&(*query)->min_unpacked_rev, fs,
                                       scratch_pool));
 
+  /* Constrain the range to scan.  Pack files can only be read as a
+   * whole, so align the start to the pack file boundary if it lies
+   * within the packed part of the repo. */
+  if (start_revision < 0)
+    start_revision = 0;
+  if (   (*query)->shard_size
+      && start_revision < (*query)->min_unpacked_rev)
+    start_revision -= start_revision % (*query)->shard_size;
+  (*query)->start_revision = start_revision;
+
   /* create data containers and caches
    * Note: this assumes that int is at least 32-bits and that we only support
    * 32-bit wide revision numbers (actually 31-bits due to the signedness
@@ -1365,6 +1460,11 @@ create_query(query_t **query,
   (*query)->null_base = apr_pcalloc(result_pool,
                                     sizeof(*(*query)->null_base));
 
+  /* Pre-fill the slots for revisions before the scanned range such that
+   * the array index of every scanned revision equals its revnum. */
+  for (revision = 0; revision < start_revision; ++revision)
+    APR_ARRAY_PUSH((*query)->revisions, revision_info_t *) = NULL;
+
   /* Store other parameters */
   (*query)->fs = fs;
   (*query)->stats = stats;
@@ -1377,19 +1477,21 @@ create_query(query_t **query,
 }
 
 svn_error_t *
-svn_fs_fs__get_stats(svn_fs_fs__stats_t **stats,
-                     svn_fs_t *fs,
-                     svn_fs_progress_notify_func_t progress_func,
-                     void *progress_baton,
-                     svn_cancel_func_t cancel_func,
-                     void *cancel_baton,
-                     apr_pool_t *result_pool,
-                     apr_pool_t *scratch_pool)
+svn_fs_fs__get_stats_range(svn_fs_fs__stats_t **stats,
+                           svn_fs_t *fs,
+                           svn_revnum_t start_revision,
+                           svn_fs_progress_notify_func_t progress_func,
+                           void *progress_baton,
+                           svn_cancel_func_t cancel_func,
+                           void *cancel_baton,
+                           apr_pool_t *result_pool,
+                           apr_pool_t *scratch_pool)
 {
   query_t *query;
 
   *stats = create_stats(result_pool);
-  SVN_ERR(create_query(&query, fs, *stats, progress_func, progress_baton,
+  SVN_ERR(create_query(&query, fs, *stats, start_revision,
+                       progress_func, progress_baton,
                        cancel_func, cancel_baton, scratch_pool,
                        scratch_pool));
   SVN_ERR(read_revisions(query, scratch_pool, scratch_pool));
@@ -1398,6 +1500,25 @@ svn_fs_fs__get_stats(svn_fs_fs__stats_t **stats,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_fs_fs__get_stats(svn_fs_fs__stats_t **stats,
+                     svn_fs_t *fs,
+                     svn_fs_progress_notify_func_t progress_func,
+                     void *progress_baton,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  return svn_error_trace(svn_fs_fs__get_stats_range(stats, fs, 0,
+                                                    progress_func,
+                                                    progress_baton,
+                                                    cancel_func,
+                                                    cancel_baton,
+                                                    result_pool,
+                                                    scratch_pool));
+}
+
 /* Baton for rev_size_index_entry_cb. */
 struct rev_size_baton_t {
   svn_revnum_t revision;
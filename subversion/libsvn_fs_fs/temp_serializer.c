@@ -37,6 +37,8 @@
 #include "low_level.h"
 #include "cached_data.h"
 
+#include "svn_private_config.h"
+
 /* Utility to encode a signed NUMBER into a variable-length sequence of
  * 8-bit chars in KEY_BUFFER and return the last written position.
  *
@@ -167,37 +169,38 @@ typedef struct dir_data_t
    * append more data in situ later) */
   apr_size_t len;
 
-  /* reference to the entries */
-  svn_fs_dirent_t **entries;
-
-  /* size of the serialized entries and don't be too wasteful
-   * (needed since the entries are no longer in sequence) */
-  apr_uint32_t *lengths;
+  /* reference to the packed entries.  Each entry starts with its
+   * NUL-terminated name, followed by a single node kind byte and the
+   * packed node revision id. */
+  const char **entries;
 } dir_data_t;
 
-/* Utility function to serialize the *ENTRY_P into a the given
- * serialization CONTEXT. Return the serialized size of the
- * dir entry in *LENGTH.
+/* Utility function to serialize ENTRY in packed format into the given
+ * serialization CONTEXT, referenced by *PACKED_P.  The name is stored
+ * first such that the binary search in find_entry() can compare names
+ * without unpacking anything.  Use SCRATCH_POOL for temporary allocations.
  */
 static void
 serialize_dir_entry(svn_temp_serializer__context_t *context,
-                    svn_fs_dirent_t **entry_p,
-                    apr_uint32_t *length)
+                    const char **packed_p,
+                    const svn_fs_dirent_t *entry,
+                    apr_pool_t *scratch_pool)
 {
-  svn_fs_dirent_t *entry = *entry_p;
-  apr_size_t initial_length = svn_temp_serializer__get_length(context);
-
-  svn_temp_serializer__push(context,
-                            (const void * const *)entry_p,
-                            sizeof(**entry_p));
-
-  svn_fs_fs__id_serialize(context, &entry->id);
-  svn_temp_serializer__add_string(context, &entry->name);
-
-  *length = (apr_uint32_t)(  svn_temp_serializer__get_length(context)
-                           - APR_ALIGN_DEFAULT(initial_length));
-
-  svn_temp_serializer__pop(context);
+  apr_size_t name_len = strlen(entry->name) + 1;
+  unsigned char *packed
+    = apr_palloc(scratch_pool,
+                 name_len + 1 + SVN_FS_FS__PACKED_ID_MAX_LEN);
+  unsigned char *p = packed;
+
+  memcpy(p, entry->name, name_len);
+  p += name_len;
+  *p++ = (unsigned char)entry->kind;
+  p = svn_fs_fs__id_pack(p, entry->id);
+
+  *packed_p = (const char *)packed;
+  svn_temp_serializer__add_leaf(context,
+                                (const void * const *)packed_p,
+                                p - packed);
 }
 
 /* Utility function to serialize the DIR into a new serialization
@@ -216,24 +219,19 @@ serialize_dir(svn_fs_fs__dir_data_t *dir, apr_pool_t *pool)
   apr_size_t over_provision = 2 + count / 4;
   apr_size_t total_count = count + over_provision;
   apr_size_t entries_len = total_count * sizeof(*dir_data.entries);
-  apr_size_t lengths_len = total_count * sizeof(*dir_data.lengths);
 
   /* copy the hash entries to an auxiliary struct of known layout */
   dir_data.count = count;
   dir_data.txn_filesize = dir->txn_filesize;
   dir_data.over_provision = over_provision;
   dir_data.operations = 0;
-  dir_data.entries = apr_palloc(pool, entries_len);
-  dir_data.lengths = apr_palloc(pool, lengths_len);
-
-  for (i = 0; i < count; ++i)
-    dir_data.entries[i] = APR_ARRAY_IDX(entries, i, svn_fs_dirent_t *);
+  dir_data.entries = apr_pcalloc(pool, entries_len);
 
   /* Serialize that aux. structure into a new one. Also, provide a good
    * estimate for the size of the buffer that we will need. */
   context = svn_temp_serializer__init(&dir_data,
                                       sizeof(dir_data),
-                                      50 + count * 200 + entries_len,
+                                      50 + count * 80 + entries_len,
                                       pool);
 
   /* serialize entries references */
@@ -241,33 +239,32 @@ serialize_dir(svn_fs_fs__dir_data_t *dir, apr_pool_t *pool)
                             (const void * const *)&dir_data.entries,
                             entries_len);
 
-  /* serialize the individual entries and their sub-structures */
+  /* serialize the individual entries in packed format */
   for (i = 0; i < count; ++i)
     serialize_dir_entry(context,
                         &dir_data.entries[i],
-                        &dir_data.lengths[i]);
+                        APR_ARRAY_IDX(entries, i, svn_fs_dirent_t *),
+                        pool);
 
   svn_temp_serializer__pop(context);
 
-  /* serialize entries references */
-  svn_temp_serializer__push(context,
-                            (const void * const *)&dir_data.lengths,
-                            lengths_len);
-
   return context;
 }
 
-/* Utility function to reconstruct a dir entries struct from serialized data
- * in BUFFER and DIR_DATA. Allocation will be made form POOL.
+/* Utility function to reconstruct a dir entries struct in *RESULT_P from
+ * serialized data in BUFFER and DIR_DATA. Allocation will be made form POOL.
  */
-static svn_fs_fs__dir_data_t *
-deserialize_dir(void *buffer, dir_data_t *dir_data, apr_pool_t *pool)
+static svn_error_t *
+deserialize_dir(svn_fs_fs__dir_data_t **result_p,
+                void *buffer,
+                dir_data_t *dir_data,
+                apr_pool_t *pool)
 {
   svn_fs_fs__dir_data_t *result;
   apr_size_t i;
   apr_size_t count;
-  svn_fs_dirent_t *entry;
-  svn_fs_dirent_t **entries;
+  const char **entries;
+  const unsigned char *end = (const unsigned char *)buffer + dir_data->len;
 
   /* Construct empty directory object. */
   result = apr_pcalloc(pool, sizeof(*result));
@@ -279,22 +276,31 @@ deserialize_dir(void *buffer, dir_data_t *dir_data, apr_pool_t *pool)
   svn_temp_deserializer__resolve(buffer, (void **)&dir_data->entries);
   entries = dir_data->entries;
 
-  /* fixup the references within each entry and add it to the RESULT */
+  /* unpack the entries and add them to the RESULT */
   for (i = 0, count = dir_data->count; i < count; ++i)
     {
+      const unsigned char *packed;
+      svn_fs_dirent_t *entry;
+
       svn_temp_deserializer__resolve(entries, (void **)&entries[i]);
-      entry = dir_data->entries[i];
+      packed = (const unsigned char *)entries[i];
 
-      /* pointer fixup */
-      svn_temp_deserializer__resolve(entry, (void **)&entry->name);
-      svn_fs_fs__id_deserialize(entry, (svn_fs_id_t **)&entry->id);
+      entry = apr_palloc(pool, sizeof(*entry));
+      entry->name = (const char *)packed;
+      packed += strlen(entry->name) + 1;
+      entry->kind = (svn_node_kind_t)*packed++;
+      packed = svn_fs_fs__id_unpack(&entry->id, packed, end, pool);
+      if (packed == NULL)
+        return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
+                                _("Directory entry corrupt in cache"));
 
       /* add the entry to the hash */
       APR_ARRAY_PUSH(result->entries, svn_fs_dirent_t *) = entry;
     }
 
   /* return the now complete hash */
-  return result;
+  *result_p = result;
+  return SVN_NO_ERROR;
 }
 
 void
@@ -534,6 +540,12 @@ typedef struct properties_data_t
   /* number of entries in the hash */
   apr_size_t count;
 
+  /* 64 bit FNV-1a digest over all keys and values.  Combined in an
+     order-independent way such that equal hash contents always yield
+     equal digests, no matter the iteration order.  Different digests
+     imply different contents; equal digests imply nothing. */
+  apr_uint64_t digest;
+
   /* reference to the keys */
   const char **keys;
 
@@ -601,11 +613,19 @@ svn_fs_fs__serialize_properties(void **data,
   properties.keys = apr_palloc(pool, sizeof(const char*) * (properties.count + 1));
   properties.values = apr_palloc(pool, sizeof(const svn_string_t *) * properties.count);
 
-  /* populate it with the hash entries */
+  /* populate it with the hash entries and calculate the content digest.
+     Sum up the per-entry digests b/c the iteration order is arbitrary
+     and equal contents must produce equal digests. */
+  properties.digest = properties.count;
   for (hi = apr_hash_first(pool, hash), i=0; hi; hi = apr_hash_next(hi), ++i)
     {
-      properties.keys[i] = apr_hash_this_key(hi);
-      properties.values[i] = apr_hash_this_val(hi);
+      const char *key = apr_hash_this_key(hi);
+      const svn_string_t *value = apr_hash_this_val(hi);
+
+      properties.keys[i] = key;
+      properties.values[i] = value;
+      properties.digest += svn__fnv1a_64(key, strlen(key) + 1)
+                         ^ svn__fnv1a_64(value->data, value->len);
     }
 
   /* serialize it */
@@ -743,29 +763,235 @@ svn_fs_fs__deserialize_id(void **out,
 
 /** Caching node_revision_t objects. **/
 
+/* Cache entries for single noderevs use a packed format: varint-coded
+ * numbers, packed ids and NUL-terminated strings instead of a copy of
+ * the full structures.  Optional parts are described by the flags below;
+ * absent parts occupy no space at all.  This shrinks the typical entry
+ * to a fraction of the structure size, i.e. the same noderev cache
+ * memory holds several times as many entries.
+ *
+ * Note that noderevs embedded in larger cache entries (see dag.c) still
+ * use the generic temp_serializer format via svn_fs_fs__noderev_serialize.
+ */
+
+/* Flags describing which optional parts of a packed noderev are present. */
+#define NODEREV_HAS_ID              0x01
+#define NODEREV_HAS_PREDECESSOR     0x02
+#define NODEREV_HAS_COPYFROM        0x04
+#define NODEREV_HAS_COPYROOT_PATH   0x08
+#define NODEREV_HAS_CREATED_PATH    0x10
+#define NODEREV_HAS_PROP_REP        0x20
+#define NODEREV_HAS_DATA_REP        0x40
+#define NODEREV_IS_FRESH_TXN_ROOT   0x80
+
+/* Append VALUE in 7b/8b-encoding to BUF. */
+static void
+pack_uint(svn_stringbuf_t *buf, apr_uint64_t value)
+{
+  unsigned char scratch[SVN__MAX_ENCODED_UINT_LEN];
+  svn_stringbuf_appendbytes(buf, (const char *)scratch,
+                            svn__encode_uint(scratch, value) - scratch);
+}
+
+/* Append VALUE in signed 7b/8b-encoding to BUF. */
+static void
+pack_int(svn_stringbuf_t *buf, apr_int64_t value)
+{
+  unsigned char scratch[SVN__MAX_ENCODED_UINT_LEN];
+  svn_stringbuf_appendbytes(buf, (const char *)scratch,
+                            svn__encode_int(scratch, value) - scratch);
+}
+
+/* Append ID in packed format to BUF. */
+static void
+pack_id(svn_stringbuf_t *buf, const svn_fs_id_t *id)
+{
+  unsigned char scratch[SVN_FS_FS__PACKED_ID_MAX_LEN];
+  svn_stringbuf_appendbytes(buf, (const char *)scratch,
+                            svn_fs_fs__id_pack(scratch, id) - scratch);
+}
+
+/* Append STRING, including its terminating NUL, to BUF. */
+static void
+pack_string(svn_stringbuf_t *buf, const char *string)
+{
+  svn_stringbuf_appendbytes(buf, string, strlen(string) + 1);
+}
+
+/* Append REP in packed format to BUF. */
+static void
+pack_representation(svn_stringbuf_t *buf, const representation_t *rep)
+{
+  svn_stringbuf_appendbyte(buf, rep->has_sha1 ? 1 : 0);
+  if (rep->has_sha1)
+    svn_stringbuf_appendbytes(buf, (const char *)rep->sha1_digest,
+                              sizeof(rep->sha1_digest));
+  svn_stringbuf_appendbytes(buf, (const char *)rep->md5_digest,
+                            sizeof(rep->md5_digest));
+
+  pack_int(buf, rep->revision);
+  pack_uint(buf, rep->item_index);
+  pack_int(buf, rep->size);
+  pack_int(buf, rep->expanded_size);
+  pack_int(buf, rep->txn_id.revision);
+  pack_uint(buf, rep->txn_id.number);
+  pack_int(buf, rep->uniquifier.noderev_txn_id.revision);
+  pack_uint(buf, rep->uniquifier.noderev_txn_id.number);
+  pack_uint(buf, rep->uniquifier.number);
+}
+
+/* Set *STRING to the NUL-terminated string starting at P, which must end
+ * before END.  The string data is not copied, i.e. *STRING aliases the
+ * cache entry buffer.  Return the position right after the terminating
+ * NUL or NULL, if the data is malformed. */
+static const unsigned char *
+unpack_string(const char **string, const unsigned char *p,
+              const unsigned char *end)
+{
+  const unsigned char *nul = memchr(p, 0, end - p);
+  if (nul == NULL)
+    return NULL;
+
+  *string = (const char *)p;
+  return nul + 1;
+}
+
+/* Set *REP_P to a representation, allocated in POOL, read from the
+ * packed representation starting at P and never reading at or beyond
+ * END.  Return the position right after it or NULL, if the data is
+ * malformed. */
+static const unsigned char *
+unpack_representation(representation_t **rep_p,
+                      const unsigned char *p,
+                      const unsigned char *end,
+                      apr_pool_t *pool)
+{
+  representation_t *rep = apr_pcalloc(pool, sizeof(*rep));
+  apr_int64_t signed_value;
+  apr_uint64_t value;
+
+  if (p == end)
+    return NULL;
+  rep->has_sha1 = (*p++ != 0);
+
+  if (rep->has_sha1)
+    {
+      if (end - p < (apr_ssize_t)sizeof(rep->sha1_digest))
+        return NULL;
+      memcpy(rep->sha1_digest, p, sizeof(rep->sha1_digest));
+      p += sizeof(rep->sha1_digest);
+    }
+
+  if (end - p < (apr_ssize_t)sizeof(rep->md5_digest))
+    return NULL;
+  memcpy(rep->md5_digest, p, sizeof(rep->md5_digest));
+  p += sizeof(rep->md5_digest);
+
+  p = svn__decode_int(&signed_value, p, end);
+  if (p == NULL)
+    return NULL;
+  rep->revision = (svn_revnum_t)signed_value;
+
+  p = svn__decode_uint(&value, p, end);
+  if (p == NULL)
+    return NULL;
+  rep->item_index = value;
+
+  p = svn__decode_int(&signed_value, p, end);
+  if (p == NULL)
+    return NULL;
+  rep->size = signed_value;
+
+  p = svn__decode_int(&signed_value, p, end);
+  if (p == NULL)
+    return NULL;
+  rep->expanded_size = signed_value;
+
+  p = svn__decode_int(&signed_value, p, end);
+  if (p == NULL)
+    return NULL;
+  rep->txn_id.revision = (svn_revnum_t)signed_value;
+
+  p = svn__decode_uint(&rep->txn_id.number, p, end);
+  if (p == NULL)
+    return NULL;
+
+  p = svn__decode_int(&signed_value, p, end);
+  if (p == NULL)
+    return NULL;
+  rep->uniquifier.noderev_txn_id.revision = (svn_revnum_t)signed_value;
+
+  p = svn__decode_uint(&rep->uniquifier.noderev_txn_id.number, p, end);
+  if (p == NULL)
+    return NULL;
+
+  p = svn__decode_uint(&rep->uniquifier.number, p, end);
+  if (p == NULL)
+    return NULL;
+
+  *rep_p = rep;
+  return p;
+}
+
 svn_error_t *
 svn_fs_fs__serialize_node_revision(void **buffer,
                                    apr_size_t *buffer_size,
                                    void *item,
                                    apr_pool_t *pool)
 {
-  svn_stringbuf_t *serialized;
   node_revision_t *noderev = item;
+  svn_stringbuf_t *buf = svn_stringbuf_create_ensure(128, pool);
+  unsigned char flags = 0;
+
+  if (noderev->id)
+    flags |= NODEREV_HAS_ID;
+  if (noderev->predecessor_id)
+    flags |= NODEREV_HAS_PREDECESSOR;
+  if (noderev->copyfrom_path)
+    flags |= NODEREV_HAS_COPYFROM;
+  if (noderev->copyroot_path)
+    flags |= NODEREV_HAS_COPYROOT_PATH;
+  if (noderev->created_path)
+    flags |= NODEREV_HAS_CREATED_PATH;
+  if (noderev->prop_rep)
+    flags |= NODEREV_HAS_PROP_REP;
+  if (noderev->data_rep)
+    flags |= NODEREV_HAS_DATA_REP;
+  if (noderev->is_fresh_txn_root)
+    flags |= NODEREV_IS_FRESH_TXN_ROOT;
+
+  svn_stringbuf_appendbyte(buf, (char)noderev->kind);
+  svn_stringbuf_appendbyte(buf, (char)flags);
+  svn_stringbuf_appendbyte(buf, noderev->has_mergeinfo ? 1 : 0);
+
+  if (noderev->id)
+    pack_id(buf, noderev->id);
+  if (noderev->predecessor_id)
+    pack_id(buf, noderev->predecessor_id);
+
+  if (noderev->copyfrom_path)
+    {
+      pack_string(buf, noderev->copyfrom_path);
+      pack_int(buf, noderev->copyfrom_rev);
+    }
 
-  /* create an (empty) serialization context with plenty of (initial)
-   * buffer space. */
-  svn_temp_serializer__context_t *context =
-      svn_temp_serializer__init(NULL, 0,
-                                1024 - SVN_TEMP_SERIALIZER__OVERHEAD,
-                                pool);
+  pack_int(buf, noderev->copyroot_rev);
+  if (noderev->copyroot_path)
+    pack_string(buf, noderev->copyroot_path);
 
-  /* serialize the noderev */
-  svn_fs_fs__noderev_serialize(context, &noderev);
+  if (noderev->created_path)
+    pack_string(buf, noderev->created_path);
 
-  /* return serialized data */
-  serialized = svn_temp_serializer__get(context);
-  *buffer = serialized->data;
-  *buffer_size = serialized->len;
+  pack_int(buf, noderev->predecessor_count);
+  pack_int(buf, noderev->mergeinfo_count);
+
+  if (noderev->prop_rep)
+    pack_representation(buf, noderev->prop_rep);
+  if (noderev->data_rep)
+    pack_representation(buf, noderev->data_rep);
+
+  *buffer = buf->data;
+  *buffer_size = buf->len;
 
   return SVN_NO_ERROR;
 }
@@ -776,15 +1002,179 @@ svn_fs_fs__deserialize_node_revision(void **item,
                                      apr_size_t buffer_size,
                                      apr_pool_t *pool)
 {
-  /* Copy the _full_ buffer as it also contains the sub-structures. */
-  node_revision_t *noderev = (node_revision_t *)buffer;
+  const unsigned char *p = buffer;
+  const unsigned char *end = p + buffer_size;
+  node_revision_t *noderev = apr_pcalloc(pool, sizeof(*noderev));
+  unsigned char flags;
+  apr_int64_t signed_value;
+
+  /* Strings inside the packed data are referenced in place, so the
+   * noderev's lifetime is that of BUFFER - same as with the generic
+   * serialization format. */
+  if (end - p < 3)
+    goto corrupt;
+
+  noderev->kind = (svn_node_kind_t)*p++;
+  flags = *p++;
+  noderev->has_mergeinfo = (*p++ != 0);
+  noderev->is_fresh_txn_root = (flags & NODEREV_IS_FRESH_TXN_ROOT) != 0;
+
+  if (flags & NODEREV_HAS_ID)
+    {
+      p = svn_fs_fs__id_unpack(&noderev->id, p, end, pool);
+      if (p == NULL)
+        goto corrupt;
+    }
 
-  /* fixup of all pointers etc. */
-  svn_fs_fs__noderev_deserialize(noderev, &noderev);
+  if (flags & NODEREV_HAS_PREDECESSOR)
+    {
+      p = svn_fs_fs__id_unpack(&noderev->predecessor_id, p, end, pool);
+      if (p == NULL)
+        goto corrupt;
+    }
+
+  if (flags & NODEREV_HAS_COPYFROM)
+    {
+      p = unpack_string(&noderev->copyfrom_path, p, end);
+      if (p == NULL)
+        goto corrupt;
+
+      p = svn__decode_int(&signed_value, p, end);
+      if (p == NULL)
+        goto corrupt;
+      noderev->copyfrom_rev = (svn_revnum_t)signed_value;
+    }
+  else
+    {
+      noderev->copyfrom_rev = SVN_INVALID_REVNUM;
+    }
+
+  p = svn__decode_int(&signed_value, p, end);
+  if (p == NULL)
+    goto corrupt;
+  noderev->copyroot_rev = (svn_revnum_t)signed_value;
+
+  if (flags & NODEREV_HAS_COPYROOT_PATH)
+    {
+      p = unpack_string(&noderev->copyroot_path, p, end);
+      if (p == NULL)
+        goto corrupt;
+    }
+
+  if (flags & NODEREV_HAS_CREATED_PATH)
+    {
+      p = unpack_string(&noderev->created_path, p, end);
+      if (p == NULL)
+        goto corrupt;
+    }
+
+  p = svn__decode_int(&signed_value, p, end);
+  if (p == NULL)
+    goto corrupt;
+  noderev->predecessor_count = (int)signed_value;
+
+  p = svn__decode_int(&noderev->mergeinfo_count, p, end);
+  if (p == NULL)
+    goto corrupt;
+
+  if (flags & NODEREV_HAS_PROP_REP)
+    {
+      p = unpack_representation(&noderev->prop_rep, p, end, pool);
+      if (p == NULL)
+        goto corrupt;
+    }
+
+  if (flags & NODEREV_HAS_DATA_REP)
+    {
+      p = unpack_representation(&noderev->data_rep, p, end, pool);
+      if (p == NULL)
+        goto corrupt;
+    }
 
-  /* done */
   *item = noderev;
   return SVN_NO_ERROR;
+
+corrupt:
+  return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
+                          _("Node revision corrupt in cache"));
+}
+
+svn_error_t *
+svn_fs_fs__get_noderev_ancestry(void **out,
+                                const void *data,
+                                apr_size_t data_len,
+                                void *baton,
+                                apr_pool_t *pool)
+{
+  const unsigned char *p = data;
+  const unsigned char *end = p + data_len;
+  svn_fs_fs__noderev_ancestry_t *ancestry
+    = apr_pcalloc(pool, sizeof(*ancestry));
+  unsigned char flags;
+  apr_int64_t signed_value;
+  const char *string;
+
+  /* Walk the packed entry only as far as the created path; everything
+   * we keep must be copied into POOL because DATA is the in-cache
+   * buffer. */
+  if (end - p < 3)
+    goto corrupt;
+
+  p++;                          /* skip the node kind */
+  flags = *p++;
+  p++;                          /* skip has_mergeinfo */
+
+  if (flags & NODEREV_HAS_ID)
+    {
+      const svn_fs_id_t *id;
+      p = svn_fs_fs__id_unpack(&id, p, end, pool);
+      if (p == NULL)
+        goto corrupt;
+    }
+
+  if (flags & NODEREV_HAS_PREDECESSOR)
+    {
+      p = svn_fs_fs__id_unpack(&ancestry->predecessor_id, p, end, pool);
+      if (p == NULL)
+        goto corrupt;
+    }
+
+  if (flags & NODEREV_HAS_COPYFROM)
+    {
+      p = unpack_string(&string, p, end);
+      if (p == NULL)
+        goto corrupt;
+
+      p = svn__decode_int(&signed_value, p, end);
+      if (p == NULL)
+        goto corrupt;
+    }
+
+  p = svn__decode_int(&signed_value, p, end);
+  if (p == NULL)
+    goto corrupt;
+
+  if (flags & NODEREV_HAS_COPYROOT_PATH)
+    {
+      p = unpack_string(&string, p, end);
+      if (p == NULL)
+        goto corrupt;
+    }
+
+  if (flags & NODEREV_HAS_CREATED_PATH)
+    {
+      p = unpack_string(&string, p, end);
+      if (p == NULL)
+        goto corrupt;
+      ancestry->created_path = apr_pstrdup(pool, string);
+    }
+
+  *out = ancestry;
+  return SVN_NO_ERROR;
+
+corrupt:
+  return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
+                          _("Node revision corrupt in cache"));
 }
 
 /* Utility function that returns the directory serialized inside CONTEXT
@@ -847,9 +1237,8 @@ svn_fs_fs__deserialize_dir_entries(void **out,
   dir_data_t *dir_data = (dir_data_t *)data;
 
   /* reconstruct the hash from the serialized data */
-  *out = deserialize_dir(dir_data, dir_data, pool);
-
-  return SVN_NO_ERROR;
+  return deserialize_dir((svn_fs_fs__dir_data_t **)out, dir_data, dir_data,
+                         pool);
 }
 
 svn_error_t *
@@ -867,6 +1256,20 @@ svn_fs_fs__get_sharded_offset(void **out,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_fs_fs__get_proplist_digest(void **out,
+                               const void *data,
+                               apr_size_t data_len,
+                               void *baton,
+                               apr_pool_t *pool)
+{
+  const properties_data_t *properties = data;
+
+  *(apr_uint64_t *)out = properties->digest;
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_fs_fs__extract_dir_filesize(void **out,
                                 const void *data,
@@ -887,22 +1290,22 @@ svn_fs_fs__extract_dir_filesize(void **out,
  * the number of valid entries in ENTRIES.
  */
 static apr_size_t
-find_entry(svn_fs_dirent_t **entries,
+find_entry(const char **entries,
            const char *name,
            apr_size_t count,
            svn_boolean_t *found)
 {
-  /* binary search for the desired entry by name */
+  /* binary search for the desired entry by name.  Packed entries start
+   * with their NUL-terminated name, so a single pointer resolution gives
+   * us the string to compare against. */
   apr_size_t lower = 0;
   apr_size_t upper = count;
   apr_size_t middle;
 
   for (middle = upper / 2; lower < upper; middle = (upper + lower) / 2)
     {
-      const svn_fs_dirent_t *entry =
+      const char *entry_name =
           svn_temp_deserializer__ptr(entries, (const void *const *)&entries[middle]);
-      const char* entry_name =
-          svn_temp_deserializer__ptr(entry, (const void *const *)&entry->name);
 
       int diff = strcmp(entry_name, name);
       if (diff < 0)
@@ -915,10 +1318,8 @@ find_entry(svn_fs_dirent_t **entries,
   *found = FALSE;
   if (lower < count)
     {
-      const svn_fs_dirent_t *entry =
+      const char *entry_name =
           svn_temp_deserializer__ptr(entries, (const void *const *)&entries[lower]);
-      const char* entry_name =
-          svn_temp_deserializer__ptr(entry, (const void *const *)&entry->name);
 
       if (strcmp(entry_name, name) == 0)
         *found = TRUE;
@@ -939,20 +1340,16 @@ svn_fs_fs__extract_dir_entry(void **out,
   svn_boolean_t found;
 
   /* resolve the reference to the entries array */
-  const svn_fs_dirent_t * const *entries =
+  const char **entries = (const char **)
     svn_temp_deserializer__ptr(data, (const void *const *)&dir_data->entries);
 
-  /* resolve the reference to the lengths array */
-  const apr_uint32_t *lengths =
-    svn_temp_deserializer__ptr(data, (const void *const *)&dir_data->lengths);
-
   /* binary search for the desired entry by name */
-  apr_size_t pos = find_entry((svn_fs_dirent_t **)entries,
+  apr_size_t pos = find_entry(entries,
                               entry_baton->name,
                               dir_data->count,
                               &found);
 
-  /* de-serialize that entry or return NULL, if no match has been found.
+  /* unpack that entry or return NULL, if no match has been found.
    * Be sure to check that the directory contents is still up-to-date. */
   entry_baton->out_of_date
     = dir_data->txn_filesize != entry_baton->txn_filesize;
@@ -960,21 +1357,22 @@ svn_fs_fs__extract_dir_entry(void **out,
   *out = NULL;
   if (found && !entry_baton->out_of_date)
     {
-      const svn_fs_dirent_t *source =
+      const unsigned char *packed = (const unsigned char *)
           svn_temp_deserializer__ptr(entries, (const void *const *)&entries[pos]);
+      const unsigned char *end
+        = (const unsigned char *)data + dir_data->len;
 
-      /* Entries have been serialized one-by-one, each time including all
-       * nested structures and strings. Therefore, they occupy a single
-       * block of memory whose end-offset is either the beginning of the
-       * next entry or the end of the buffer
-       */
-      apr_size_t size = lengths[pos];
+      /* unpack the entry into a fresh allocation */
+      svn_fs_dirent_t *new_entry = apr_palloc(pool, sizeof(*new_entry));
 
-      /* copy & deserialize the entry */
-      svn_fs_dirent_t *new_entry = apr_pmemdup(pool, source, size);
+      new_entry->name = apr_pstrdup(pool, (const char *)packed);
+      packed += strlen(new_entry->name) + 1;
+      new_entry->kind = (svn_node_kind_t)*packed++;
+      packed = svn_fs_fs__id_unpack(&new_entry->id, packed, end, pool);
+      if (packed == NULL)
+        return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
+                                _("Directory entry corrupt in cache"));
 
-      svn_temp_deserializer__resolve(new_entry, (void **)&new_entry->name);
-      svn_fs_fs__id_deserialize(new_entry, (svn_fs_id_t **)&new_entry->id);
       *(svn_fs_dirent_t **)out = new_entry;
     }
 
@@ -1034,9 +1432,7 @@ svn_fs_fs__replace_dir_entry(void **data,
   replace_baton_t *replace_baton = (replace_baton_t *)baton;
   dir_data_t *dir_data = (dir_data_t *)*data;
   svn_boolean_t found;
-  svn_fs_dirent_t **entries;
-  apr_uint32_t *lengths;
-  apr_uint32_t length;
+  const char **entries;
   apr_size_t pos;
 
   svn_temp_serializer__context_t *context;
@@ -1054,15 +1450,10 @@ svn_fs_fs__replace_dir_entry(void **data,
     return slowly_replace_dir_entry(data, data_len, baton, pool);
 
   /* resolve the reference to the entries array */
-  entries = (svn_fs_dirent_t **)
+  entries = (const char **)
     svn_temp_deserializer__ptr(dir_data,
                                (const void *const *)&dir_data->entries);
 
-  /* resolve the reference to the lengths array */
-  lengths = (apr_uint32_t *)
-    svn_temp_deserializer__ptr(dir_data,
-                               (const void *const *)&dir_data->lengths);
-
   /* binary search for the desired entry by name */
   pos = find_entry(entries, replace_baton->name, dir_data->count, &found);
 
@@ -1075,9 +1466,6 @@ svn_fs_fs__replace_dir_entry(void **data,
           memmove(&entries[pos],
                   &entries[pos + 1],
                   sizeof(entries[pos]) * (dir_data->count - pos));
-          memmove(&lengths[pos],
-                  &lengths[pos + 1],
-                  sizeof(lengths[pos]) * (dir_data->count - pos));
 
           dir_data->count--;
           dir_data->over_provision++;
@@ -1100,38 +1488,23 @@ svn_fs_fs__replace_dir_entry(void **data,
       memmove(&entries[pos + 1],
               &entries[pos],
               sizeof(entries[pos]) * (dir_data->count - pos));
-      memmove(&lengths[pos + 1],
-              &lengths[pos],
-              sizeof(lengths[pos]) * (dir_data->count - pos));
 
       dir_data->count++;
       dir_data->over_provision--;
       dir_data->operations++;
     }
 
-  /* de-serialize the new entry */
-  entries[pos] = replace_baton->new_entry;
+  /* serialize the new entry */
   context = svn_temp_serializer__init_append(dir_data,
                                              entries,
                                              dir_data->len,
                                              *data_len,
                                              pool);
-  serialize_dir_entry(context, &entries[pos], &length);
+  serialize_dir_entry(context, &entries[pos], replace_baton->new_entry,
+                      pool);
 
   /* return the updated serialized data */
-  SVN_ERR(return_serialized_dir_context(context, data, data_len, TRUE));
-
-  /* since the previous call may have re-allocated the buffer, the lengths
-   * pointer may no longer point to the entry in that buffer. Therefore,
-   * re-map it again and store the length value after that. */
-
-  dir_data = (dir_data_t *)*data;
-  lengths = (apr_uint32_t *)
-    svn_temp_deserializer__ptr(dir_data,
-                               (const void *const *)&dir_data->lengths);
-  lengths[pos] = length;
-
-  return SVN_NO_ERROR;
+  return return_serialized_dir_context(context, data, data_len, TRUE);
 }
 
 svn_error_t *
@@ -158,6 +158,19 @@ svn_fs_fs__deserialize_properties(void **out,
                                   apr_size_t data_len,
                                   apr_pool_t *pool);
 
+/**
+ * Implements #svn_cache__partial_getter_func_t.  Set (apr_uint64_t) @a *out
+ * to the content digest of the serialized properties hash in @a data and
+ * @a data_len.  Different digests imply different property lists but equal
+ * digests do not guarantee equal contents.
+ */
+svn_error_t *
+svn_fs_fs__get_proplist_digest(void **out,
+                               const void *data,
+                               apr_size_t data_len,
+                               void *baton,
+                               apr_pool_t *pool);
+
 /**
  * Implements #svn_cache__serialize_func_t for a properties hash
  * (@a in is an #apr_hash_t of svn_string_t elements, keyed by const char*).
@@ -214,6 +227,32 @@ svn_fs_fs__deserialize_node_revision(void **item,
                                      apr_size_t buffer_size,
                                      apr_pool_t *pool);
 
+/**
+ * The subset of a #node_revision_t that drives a plain history walk:
+ * where this node lives and where it came from.
+ */
+typedef struct svn_fs_fs__noderev_ancestry_t
+{
+  /** the ID of the node's immediate predecessor, or NULL if it has none */
+  const svn_fs_id_t *predecessor_id;
+
+  /** the path at which this node was created, or NULL if unknown */
+  const char *created_path;
+} svn_fs_fs__noderev_ancestry_t;
+
+/**
+ * Implements #svn_cache__partial_getter_func_t.  Set
+ * (#svn_fs_fs__noderev_ancestry_t *) @a *out to the ancestry info of the
+ * serialized noderev in @a data and @a data_len, allocated in @a pool.
+ * @a baton is unused.
+ */
+svn_error_t *
+svn_fs_fs__get_noderev_ancestry(void **out,
+                                const void *data,
+                                apr_size_t data_len,
+                                void *baton,
+                                apr_pool_t *pool);
+
 /**
  * Implements #svn_cache__serialize_func_t for a #svn_fs_fs__dir_data_t
  */
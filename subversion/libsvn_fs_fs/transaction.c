@@ -32,6 +32,7 @@
 #include "svn_time.h"
 #include "svn_dirent_uri.h"
 
+#include "batch_fsync.h"
 #include "fs_fs.h"
 #include "index.h"
 #include "tree.h"
@@ -41,8 +42,10 @@
 #include "temp_serializer.h"
 #include "cached_data.h"
 #include "lock.h"
+#include "paths-index.h"
 #include "rep-cache.h"
 
+#include "private/svn_delta_private.h"
 #include "private/svn_fs_util.h"
 #include "private/svn_fspath.h"
 #include "private/svn_sorts_private.h"
@@ -2092,6 +2095,7 @@ choose_delta_base(representation_t **rep,
     {
       int chain_length = 0;
       int shard_count = 0;
+      int max_chain;
 
       /* Very short rep bases are simply not worth it as we are unlikely
        * to re-coup the deltification space overhead of 20+ bytes. */
@@ -2109,8 +2113,13 @@ choose_delta_base(representation_t **rep,
                                           *rep, fs, pool));
 
       /* Some reasonable limit, depending on how acceptable longer linear
-       * chains are in this repo.  Also, allow for some minimal chain. */
-      if (chain_length >= 2 * (int)ffd->max_linear_deltification + 2)
+       * chains are in this repo.  Also, allow for some minimal chain.
+       * The repository may cap the chain explicitly to bound the cost
+       * of cold reads on frequently modified nodes. */
+      max_chain = ffd->max_delta_chain
+                ? (int)ffd->max_delta_chain
+                : 2 * (int)ffd->max_linear_deltification + 2;
+      if (chain_length >= max_chain)
         *rep = NULL;
       else
         /* To make it worth opening additional shards / pack files, we
@@ -2184,8 +2193,14 @@ txdelta_to_svndiff(svn_txdelta_window_handler_t *handler,
       svndiff_version = 0;
     }
 
-  svn_txdelta_to_svndiff3(handler, handler_baton, output, svndiff_version,
-                          ffd->delta_compression_level, pool);
+  /* With more than one compression thread configured, the windows get
+     compressed on worker threads while this thread keeps producing and
+     writing them; the helper falls back to the plain inline encoder
+     when threading is unavailable or would not help. */
+  svn_txdelta__to_svndiff_pipelined(handler, handler_baton, output,
+                                    svndiff_version,
+                                    ffd->delta_compression_level,
+                                    ffd->delta_compression_threads, pool);
 }
 
 /* Get a rep_write_baton and store it in *WB_P for the representation
@@ -2356,19 +2371,23 @@ get_shared_rep(representation_t **old_rep,
    */
   if (*old_rep == NULL && is_txn_rep(rep))
     {
-      svn_node_kind_t kind;
+      svn_stringbuf_t *rep_string;
       const char *file_name
         = path_txn_sha1(fs, &rep->txn_id, rep->sha1_digest, scratch_pool);
 
       /* in our txn, is there a rep file named with the wanted SHA1?
-         If so, read it and use that rep.
+         If so, read it and use that rep.  Try the read right away and
+         treat a missing file as a cache miss; most reps are unique, so
+         this saves a stat() per rep over probing the path first.
        */
-      SVN_ERR(svn_io_check_path(file_name, &kind, scratch_pool));
-      if (kind == svn_node_file)
+      err = svn_stringbuf_from_file2(&rep_string, file_name, scratch_pool);
+      if (err && APR_STATUS_IS_ENOENT(err->apr_err))
         {
-          svn_stringbuf_t *rep_string;
-          SVN_ERR(svn_stringbuf_from_file2(&rep_string, file_name,
-                                           scratch_pool));
+          svn_error_clear(err);
+        }
+      else
+        {
+          SVN_ERR(err);
           SVN_ERR(svn_fs_fs__parse_representation(old_rep, rep_string,
                                                   result_pool, scratch_pool));
         }
@@ -3265,6 +3284,12 @@ write_final_rev(const svn_fs_id_t **new_id_p,
       SVN_ERR(set_uniquifier(fs, noderev->prop_rep, pool));
       noderev->prop_rep->revision = rev;
 
+      /* With deltification enabled, the proplist is stored as a binary
+         delta against the predecessor's props.  For merge-tracking
+         repositories this is the main space saver:  a multi-MB
+         svn:mergeinfo value that grows by one rangelist entry per merge
+         costs only the size of that change here instead of a full copy
+         per affected node-revision. */
       if (ffd->deltify_properties)
         SVN_ERR(write_container_delta_rep(noderev->prop_rep, file, proplist,
                                           write_hash_to_stream, fs, noderev,
@@ -3593,13 +3618,14 @@ verify_locks(svn_fs_t *fs,
 }
 
 /* Writes final revision properties to file PATH applying permissions
-   from file PERMS_REFERENCE. This involves setting svn:date and
-   removing any temporary properties associated with the commit flags. */
+   from file PERMS_REFERENCE.  Schedule the necessary fsync calls in
+   BATCH.  This involves setting svn:date and removing any temporary
+   properties associated with the commit flags. */
 static svn_error_t *
 write_final_revprop(const char *path,
                     const char *perms_reference,
                     svn_fs_txn_t *txn,
-                    svn_boolean_t flush_to_disk,
+                    svn_fs_fs__batch_fsync_t *batch,
                     apr_pool_t *pool)
 {
   apr_hash_t *txnprops;
@@ -3607,6 +3633,7 @@ write_final_revprop(const char *path,
   svn_string_t *client_date;
   apr_file_t *revprop_file;
   svn_stream_t *stream;
+  apr_off_t offset = 0;
 
   SVN_ERR(svn_fs_fs__txn_proplist(&txnprops, txn, pool));
 
@@ -3629,19 +3656,19 @@ write_final_revprop(const char *path,
       svn_hash_sets(txnprops, SVN_PROP_REVISION_DATE, &date);
     }
 
-  /* Create new revprops file. Tell OS to truncate existing file,
-     since  file may already exists from failed transaction. */
-  SVN_ERR(svn_io_file_open(&revprop_file, path,
-                           APR_WRITE | APR_CREATE | APR_TRUNCATE
-                           | APR_BUFFERED, APR_OS_DEFAULT, pool));
+  /* Create / open the new revprops file through BATCH, which will flush
+     and close it when the batch is run. */
+  SVN_ERR(svn_fs_fs__batch_fsync_open_file(&revprop_file, batch, path,
+                                           pool));
 
   stream = svn_stream_from_aprfile2(revprop_file, TRUE, pool);
   SVN_ERR(svn_hash_write2(txnprops, stream, SVN_HASH_TERMINATOR, pool));
   SVN_ERR(svn_stream_close(stream));
 
-  if (flush_to_disk)
-    SVN_ERR(svn_io_file_flush_to_disk(revprop_file, pool));
-  SVN_ERR(svn_io_file_close(revprop_file, pool));
+  /* The file may already exist from a failed transaction.  Truncate it
+     to the data just written to drop any leftovers beyond it. */
+  SVN_ERR(svn_io_file_seek(revprop_file, APR_CUR, &offset, pool));
+  SVN_ERR(svn_io_file_trunc(revprop_file, offset, pool));
 
   SVN_ERR(svn_io_copy_perms(perms_reference, path, pool));
 
@@ -3732,6 +3759,12 @@ struct commit_baton {
   apr_array_header_t *reps_to_cache;
   apr_hash_t *reps_hash;
   apr_pool_t *reps_pool;
+
+  /* The transaction's changed paths, fetched before acquiring the write
+     lock.  They are transaction-private data, so reading and parsing
+     them - potentially tens of thousands of entries - does not need to
+     be serialized with other writers. */
+  apr_hash_t *changed_paths;
 };
 
 /* The work-horse for svn_fs_fs__commit, called with the FS write lock.
@@ -3749,7 +3782,9 @@ commit_body(void *baton, apr_pool_t *pool)
   apr_uint64_t start_copy_id;
   svn_revnum_t old_rev, new_rev;
   apr_file_t *proto_file;
+  apr_file_t *final_rev_file;
   void *proto_file_lockcookie;
+  svn_fs_fs__batch_fsync_t *batch;
   apr_off_t initial_offset, changed_path_offset;
   const svn_fs_fs__id_part_t *txn_id = svn_fs_fs__txn_get_id(cb->txn);
   apr_hash_t *changed_paths;
@@ -3786,9 +3821,8 @@ commit_body(void *baton, apr_pool_t *pool)
                             _("Transaction out of date"));
 
   /* We need the changes list for verification as well as for writing it
-     to the final rev file. */
-  SVN_ERR(svn_fs_fs__txn_changes_fetch(&changed_paths, cb->fs, txn_id,
-                                       pool));
+     to the final rev file; it has already been fetched by our caller. */
+  changed_paths = cb->changed_paths;
 
   /* Locks may have been added (or stolen) between the calling of
      previous svn_fs.h functions and svn_fs_commit_txn(), so we need
@@ -3799,6 +3833,10 @@ commit_body(void *baton, apr_pool_t *pool)
   /* We are going to be one better than this puny old revision. */
   new_rev = old_rev + 1;
 
+  /* Use this to force all data to be flushed to physical storage
+     (to the degree our environment will allow). */
+  SVN_ERR(svn_fs_fs__batch_fsync_create(&batch, ffd->flush_to_disk, pool));
+
   /* Get a write handle on the proto revision file. */
   SVN_ERR(get_writable_proto_rev(&proto_file, &proto_file_lockcookie,
                                  cb->fs, txn_id, pool));
@@ -3837,8 +3875,9 @@ commit_body(void *baton, apr_pool_t *pool)
                                      NULL, pool));
     }
 
-  if (ffd->flush_to_disk)
-    SVN_ERR(svn_io_file_flush_to_disk(proto_file, pool));
+  /* Close the proto-rev file without fsync'ing it here.  Its contents
+     will be flushed to disk as part of BATCH, together with the other
+     files of this commit, once the file has been moved into place. */
   SVN_ERR(svn_io_file_close(proto_file, pool));
 
   /* We don't unlock the prototype revision file immediately to avoid a
@@ -3863,6 +3902,7 @@ commit_body(void *baton, apr_pool_t *pool)
                                                     PATH_REVS_DIR,
                                                     pool),
                                     new_dir, pool));
+          SVN_ERR(svn_fs_fs__batch_fsync_new_path(batch, new_dir, pool));
         }
 
       /* Create the revprops shard. */
@@ -3879,6 +3919,7 @@ commit_body(void *baton, apr_pool_t *pool)
                                                     PATH_REVPROPS_DIR,
                                                     pool),
                                     new_dir, pool));
+          SVN_ERR(svn_fs_fs__batch_fsync_new_path(batch, new_dir, pool));
         }
     }
 
@@ -3891,8 +3932,13 @@ commit_body(void *baton, apr_pool_t *pool)
   rev_filename = svn_fs_fs__path_rev(cb->fs, new_rev, pool);
   proto_filename = svn_fs_fs__path_txn_proto_rev(cb->fs, txn_id, pool);
   SVN_ERR(svn_fs_fs__move_into_place(proto_filename, rev_filename,
-                                     old_rev_filename, ffd->flush_to_disk,
-                                     pool));
+                                     old_rev_filename, FALSE, pool));
+
+  /* Schedule the rev file contents and its new directory entry for the
+     batch flush below instead of fsync'ing them right away. */
+  SVN_ERR(svn_fs_fs__batch_fsync_open_file(&final_rev_file, batch,
+                                           rev_filename, pool));
+  SVN_ERR(svn_fs_fs__batch_fsync_new_path(batch, rev_filename, pool));
 
   /* Now that we've moved the prototype revision file out of the way,
      we can unlock it (since further attempts to write to the file
@@ -3904,7 +3950,7 @@ commit_body(void *baton, apr_pool_t *pool)
   SVN_ERR_ASSERT(! svn_fs_fs__is_packed_revprop(cb->fs, new_rev));
   revprop_filename = svn_fs_fs__path_revprops(cb->fs, new_rev, pool);
   SVN_ERR(write_final_revprop(revprop_filename, old_rev_filename,
-                              cb->txn, ffd->flush_to_disk, pool));
+                              cb->txn, batch, pool));
 
   /* Run paranoia checks. */
   if (ffd->verify_before_commit)
@@ -3912,6 +3958,12 @@ commit_body(void *baton, apr_pool_t *pool)
       SVN_ERR(verify_before_commit(cb->fs, new_rev, pool));
     }
 
+  /* Commit all changes to disk in a single flush barrier:  the rev file,
+     the revprops file and any new shard directories get fsync'ed
+     concurrently instead of one after another.  Only then may 'current'
+     make the new revision visible. */
+  SVN_ERR(svn_fs_fs__batch_fsync_run(batch, pool));
+
   /* Update the 'current' file. */
   SVN_ERR(write_final_current(cb->fs, txn_id, new_rev, start_node_id,
                               start_copy_id, pool));
@@ -3929,28 +3981,58 @@ commit_body(void *baton, apr_pool_t *pool)
    * visible. */
   SVN_ERR(promote_cached_directories(cb->fs, directory_ids, pool));
 
-  /* Remove this transaction directory. */
-  SVN_ERR(svn_fs_fs__purge_txn(cb->fs, cb->txn->id, pool));
+  /* The transaction directory gets removed by our caller, after this
+     function has released the write lock:  unlinking a large transaction
+     tree takes a while and needs no serialization with other writers
+     (see svn_fs_fs__abort_txn). */
 
   return SVN_NO_ERROR;
 }
 
+/* Number of rep-cache entries to write per sqlite transaction.  Grouping
+ * the inserts amortizes the per-transaction overhead (journal handling
+ * etc.; see <http://www.sqlite.org/faq.html#q19>), while capping the
+ * group size keeps a commit that touches thousands of files from holding
+ * the database lock, and thereby starving other (reader/writer) commits,
+ * for the duration of one huge transaction. */
+#define WRITE_REPS_BATCH_SIZE 128
+
 /* Add the representations in REPS_TO_CACHE (an array of representation_t *)
- * to the rep-cache database of FS. */
+ * to the rep-cache database of FS, writing them in batches of bounded
+ * size so that concurrent commits get a chance to access the database
+ * in between. */
 static svn_error_t *
 write_reps_to_cache(svn_fs_t *fs,
                     const apr_array_header_t *reps_to_cache,
                     apr_pool_t *scratch_pool)
 {
-  int i;
+  fs_fs_data_t *ffd = fs->fsap_data;
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  int i = 0;
 
-  for (i = 0; i < reps_to_cache->nelts; i++)
+  while (i < reps_to_cache->nelts)
     {
-      representation_t *rep = APR_ARRAY_IDX(reps_to_cache, i, representation_t *);
+      svn_error_t *err = SVN_NO_ERROR;
+      int batch_end = i + WRITE_REPS_BATCH_SIZE;
+      if (batch_end > reps_to_cache->nelts)
+        batch_end = reps_to_cache->nelts;
+
+      SVN_ERR(svn_sqlite__begin_transaction(ffd->rep_cache_db));
+      for (; i < batch_end; i++)
+        {
+          representation_t *rep
+            = APR_ARRAY_IDX(reps_to_cache, i, representation_t *);
 
-      SVN_ERR(svn_fs_fs__set_rep_reference(fs, rep, scratch_pool));
+          svn_pool_clear(iterpool);
+          err = svn_fs_fs__set_rep_reference(fs, rep, iterpool);
+          if (err)
+            break;
+        }
+      SVN_ERR(svn_sqlite__finish_transaction(ffd->rep_cache_db, err));
     }
 
+  svn_pool_destroy(iterpool);
+
   return SVN_NO_ERROR;
 }
 
@@ -3980,28 +4062,35 @@ svn_fs_fs__commit(svn_revnum_t *new_rev_p,
       cb.reps_pool = NULL;
     }
 
+  /* Read and parse the transaction's changed paths while we don't hold
+     the write lock, yet.  They are private to this transaction, so no
+     other writer can modify them anymore. */
+  SVN_ERR(svn_fs_fs__txn_changes_fetch(&cb.changed_paths, fs,
+                                       svn_fs_fs__txn_get_id(txn), pool));
+
   SVN_ERR(svn_fs_fs__with_write_lock(fs, commit_body, &cb, pool));
 
   /* At this point, *NEW_REV_P has been set, so errors below won't affect
      the success of the commit.  (See svn_fs_commit_txn().)  */
 
-  if (ffd->rep_sharing_allowed)
+  /* Remove the now committed transaction's directory.  This used to
+     happen under the write lock but would make every other writer wait
+     for a potentially large tree of unlinks. */
+  SVN_ERR(svn_fs_fs__purge_txn(fs, txn->id, pool));
+
+  /* Only open the rep cache if there is anything to add.  During bulk
+     operations such as 'svnadmin load', most revisions add no new
+     entries -- their reps were deduplicated against the cache -- and a
+     no-op sqlite transaction per revision is pure overhead. */
+  if (ffd->rep_sharing_allowed && cb.reps_to_cache->nelts > 0)
     {
       svn_error_t *err;
 
       SVN_ERR(svn_fs_fs__open_rep_cache(fs, pool));
 
-      /* Write new entries to the rep-sharing database.
-       *
-       * We use an sqlite transaction to speed things up;
-       * see <http://www.sqlite.org/faq.html#q19>.
-       */
-      /* ### A commit that touches thousands of files will starve other
-             (reader/writer) commits for the duration of the below call.
-             Maybe write in batches? */
-      SVN_ERR(svn_sqlite__begin_transaction(ffd->rep_cache_db));
+      /* Write new entries to the rep-sharing database.  This batches
+       * the inserts into bounded sqlite transactions internally. */
       err = write_reps_to_cache(fs, cb.reps_to_cache, pool);
-      err = svn_sqlite__finish_transaction(ffd->rep_cache_db, err);
 
       if (svn_error_find_cause(err, SVN_ERR_SQLITE_ROLLBACK_FAILED))
         {
@@ -4016,6 +4105,11 @@ svn_fs_fs__commit(svn_revnum_t *new_rev_p,
         return svn_error_trace(err);
     }
 
+  /* Keep the optional changed-paths index up to date.  Like the rep
+     cache, it is updated outside the write lock and an error here no
+     longer affects the success of the commit. */
+  SVN_ERR(svn_fs_fs__paths_index_update(fs, *new_rev_p, pool));
+
   return SVN_NO_ERROR;
 }
 
@@ -146,17 +146,17 @@ typedef struct cache_entry_t
   dag_node_t *node;
 } cache_entry_t;
 
-/* Number of entries in the cache.  Keep this low to keep pressure on the
-   CPU caches low as well.  A binary value is most efficient.  If we walk
-   a directory tree, we want enough entries to store nodes for all files
-   without overwriting the nodes for the parent folder.  That way, there
-   will be no unnecessary misses (except for a few random ones caused by
-   hash collision).
+/* Default number of entries in the cache.  Keep this low to keep pressure
+   on the CPU caches low as well.  A binary value is most efficient.  If we
+   walk a directory tree, we want enough entries to store nodes for all
+   files without overwriting the nodes for the parent folder.  That way,
+   there will be no unnecessary misses (except for a few random ones caused
+   by hash collision).
 
    The actual number of instances may be higher but entries that got
    overwritten are no longer visible.
  */
-enum { BUCKET_COUNT = 256 };
+enum { DEFAULT_BUCKET_COUNT = 256 };
 
 /* The actual cache structure.  All nodes will be allocated in POOL.
    When the number of INSERTIONS (i.e. objects created form that pool)
@@ -165,8 +165,11 @@ enum { BUCKET_COUNT = 256 };
  */
 struct fs_fs_dag_cache_t
 {
-  /* fixed number of (possibly empty) cache entries */
-  cache_entry_t buckets[BUCKET_COUNT];
+  /* BUCKET_COUNT (possibly empty) cache entries */
+  cache_entry_t *buckets;
+
+  /* number of entries in BUCKETS; always a power of two */
+  apr_size_t bucket_count;
 
   /* pool used for all node allocation */
   apr_pool_t *pool;
@@ -187,9 +190,21 @@ struct fs_fs_dag_cache_t
 };
 
 fs_fs_dag_cache_t*
-svn_fs_fs__create_dag_cache(apr_pool_t *pool)
+svn_fs_fs__create_dag_cache(apr_size_t bucket_count,
+                            apr_pool_t *pool)
 {
   fs_fs_dag_cache_t *result = apr_pcalloc(pool, sizeof(*result));
+  apr_size_t rounded;
+
+  /* Round the configured size up to a power of two, so bucket selection
+     can use a simple bit mask.  Enforce a sane minimum. */
+  if (bucket_count == 0)
+    bucket_count = DEFAULT_BUCKET_COUNT;
+  for (rounded = 16; rounded < bucket_count; rounded *= 2)
+    ;
+
+  result->buckets = apr_pcalloc(pool, rounded * sizeof(*result->buckets));
+  result->bucket_count = rounded;
   result->pool = svn_pool_create(pool);
 
   return result;
@@ -200,11 +215,12 @@ svn_fs_fs__create_dag_cache(apr_pool_t *pool)
 static void
 auto_clear_dag_cache(fs_fs_dag_cache_t* cache)
 {
-  if (cache->insertions > BUCKET_COUNT)
+  if (cache->insertions > cache->bucket_count)
     {
       svn_pool_clear(cache->pool);
 
-      memset(cache->buckets, 0, sizeof(cache->buckets));
+      memset(cache->buckets, 0,
+             cache->bucket_count * sizeof(*cache->buckets));
       cache->insertions = 0;
     }
 }
@@ -300,7 +316,8 @@ cache_lookup( fs_fs_dag_cache_t *cache
   hash_value = hash_func(revision, path, path_len);
 
   bucket_index = hash_value + (hash_value >> 16);
-  bucket_index = (bucket_index + (bucket_index >> 8)) % BUCKET_COUNT;
+  bucket_index = (bucket_index + (bucket_index >> 8))
+                 & (cache->bucket_count - 1);
 
   /* access the corresponding bucket and remember its location */
   result = &cache->buckets[bucket_index];
@@ -345,7 +362,8 @@ cache_insert(fs_fs_dag_cache_t *cache,
   hash_value = hash_func(revision, path, path_len);
 
   bucket_index = hash_value + (hash_value >> 16);
-  bucket_index = (bucket_index + (bucket_index >> 8)) % BUCKET_COUNT;
+  bucket_index = (bucket_index + (bucket_index >> 8))
+                 & (cache->bucket_count - 1);
 
   /* access the corresponding bucket and remember its location */
   entry = &cache->buckets[bucket_index];
@@ -2499,6 +2517,22 @@ fs_dir_entries(apr_hash_t **table_p,
   return SVN_NO_ERROR;
 }
 
+/* Set *ENTRIES_P to an array of svn_fs_dirent_t * for the directory at
+   PATH in ROOT, sorted by entry name.  Since FSFS stores directories in
+   sorted order, this simply hands out the entries array as read from
+   disk.  Allocate the result in POOL. */
+static svn_error_t *
+fs_dir_entries_sorted(apr_array_header_t **entries_p,
+                      svn_fs_root_t *root,
+                      const char *path,
+                      apr_pool_t *pool)
+{
+  dag_node_t *node;
+
+  SVN_ERR(get_dag(&node, root, path, pool));
+  return svn_error_trace(svn_fs_fs__dag_dir_entries(entries_p, node, pool));
+}
+
 static svn_error_t *
 fs_dir_optimal_order(apr_array_header_t **ordered_p,
                      svn_fs_root_t *root,
@@ -2713,7 +2747,7 @@ copy_helper(svn_fs_root_t *from_root,
   if (! from_root->is_txn_root)
     {
       svn_fs_path_change_kind_t kind;
-      dag_node_t *new_node;
+      const svn_fs_id_t *new_id;
       const char *from_canonpath;
       apr_int64_t mergeinfo_start;
       apr_int64_t mergeinfo_end;
@@ -2744,7 +2778,8 @@ copy_helper(svn_fs_root_t *from_root,
       /* Canonicalize the copyfrom path. */
       from_canonpath = svn_fs__canonicalize_abspath(from_path, pool);
 
-      SVN_ERR(svn_fs_fs__dag_copy(to_parent_path->parent->node,
+      SVN_ERR(svn_fs_fs__dag_copy(&new_id,
+                                  to_parent_path->parent->node,
                                   to_parent_path->entry,
                                   from_node,
                                   preserve_history,
@@ -2763,10 +2798,13 @@ copy_helper(svn_fs_root_t *from_root,
                                             mergeinfo_end - mergeinfo_start,
                                             pool));
 
-      /* Make a record of this modification in the changes table. */
-      SVN_ERR(get_dag(&new_node, to_root, to_path, pool));
+      /* Make a record of this modification in the changes table.
+         svn_fs_fs__dag_copy() already told us the copy's node revision
+         ID; re-walking TO_PATH just to look it up again used to
+         dominate the cost of tag-style commits consisting of many
+         small copies. */
       SVN_ERR(add_change(to_root->fs, txn_id, to_path,
-                         svn_fs_fs__dag_get_id(new_node), kind, FALSE,
+                         new_id, kind, FALSE,
                          FALSE, FALSE, svn_fs_fs__dag_node_kind(from_node),
                          from_root->rev, from_canonpath, pool));
     }
@@ -3909,28 +3947,31 @@ history_prev(svn_fs_history_t **prev_history,
     {
       /* We know the last reported node (CURRENT_ID) and the NEXT_COPY
          revision is somewhat further in the past. */
-      node_revision_t *noderev;
+      svn_fs_fs__noderev_ancestry_t *ancestry;
       assert(reported);
 
       /* Get the previous node change.  If there is none, then we already
-         reported the initial addition and this history traversal is done. */
-      SVN_ERR(svn_fs_fs__get_node_revision(&noderev, fs, fhd->current_id,
+         reported the initial addition and this history traversal is done.
+         We only need the ancestry info here, which can often be extracted
+         straight from the noderev cache entry without deserializing the
+         full node-revision. */
+      SVN_ERR(svn_fs_fs__get_node_ancestry(&ancestry, fs, fhd->current_id,
                                            scratch_pool, scratch_pool));
-      if (! noderev->predecessor_id)
+      if (! ancestry->predecessor_id)
         return SVN_NO_ERROR;
 
       /* If the previous node change is younger than the next copy, it is
          part of the linear history section. */
-      commit_rev = svn_fs_fs__id_rev(noderev->predecessor_id);
+      commit_rev = svn_fs_fs__id_rev(ancestry->predecessor_id);
       if (commit_rev > fhd->next_copy)
         {
           /* Within the linear history, simply report all node changes and
              continue with the respective predecessor. */
-          *prev_history = assemble_history(fs, noderev->created_path,
+          *prev_history = assemble_history(fs, ancestry->created_path,
                                            commit_rev, TRUE, NULL,
                                            SVN_INVALID_REVNUM,
                                            fhd->next_copy,
-                                           noderev->predecessor_id,
+                                           ancestry->predecessor_id,
                                            result_pool);
 
           return SVN_NO_ERROR;
@@ -4296,10 +4337,69 @@ mergeinfo_cache_key(const char *path,
   return svn_fs_fs__combine_number_and_string(number, path, pool);
 }
 
+/* Fetch the explicit mergeinfo of NODE and parse it into *MERGEINFO,
+   allocated in RESULT_POOL.  PATH and REV identify NODE in error
+   messages.  Syntactically invalid mergeinfo is reported as NULL
+   (issue #3896: treat it as if no mergeinfo were present rather than
+   raising a parse error).  Use SCRATCH_POOL for temporaries. */
+static svn_error_t *
+parse_node_mergeinfo(svn_mergeinfo_t *mergeinfo,
+                     dag_node_t *node,
+                     const char *path,
+                     svn_revnum_t rev,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  apr_hash_t *proplist;
+  svn_string_t *mergeinfo_string;
+  svn_error_t *err;
+
+  SVN_ERR(svn_fs_fs__dag_get_proplist(&proplist, node, scratch_pool));
+  mergeinfo_string = svn_hash_gets(proplist, SVN_PROP_MERGEINFO);
+  if (!mergeinfo_string)
+    return svn_error_createf
+      (SVN_ERR_FS_CORRUPT, NULL,
+       _("Node-revision '%s@%ld' claims to have mergeinfo but doesn't"),
+       path, rev);
+
+  err = svn_mergeinfo_parse(mergeinfo, mergeinfo_string->data, result_pool);
+  if (err)
+    {
+      if (err->apr_err != SVN_ERR_MERGEINFO_PARSE_ERROR)
+        return svn_error_trace(err);
+
+      svn_error_clear(err);
+      *mergeinfo = NULL;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Parsed mergeinfo of a single inheritance source node, shared between
+   all paths of one get_mergeinfos_for_paths() request that inherit from
+   that node. */
+typedef struct inherited_mergeinfo_t
+{
+  /* Parsed explicit mergeinfo of the node; NULL if unparsable. */
+  svn_mergeinfo_t mergeinfo;
+
+  /* MERGEINFO with non-inheritable ranges removed.  Only filled in when
+     the request adjusts inherited mergeinfo; NULL otherwise or if
+     MERGEINFO is NULL. */
+  svn_mergeinfo_t inheritable;
+} inherited_mergeinfo_t;
+
 /* Calculates the mergeinfo for PATH under REV_ROOT using inheritance
    type INHERIT.  Returns it in *MERGEINFO, or NULL if there is none.
    The result is allocated in RESULT_POOL; SCRATCH_POOL is
    used for temporary allocations.
+
+   ANCESTOR_CACHE, if not NULL, maps the paths of inheritance source
+   nodes to inherited_mergeinfo_t * and lives as long as the current
+   multi-path request.  Paths inheriting from the same ancestor - the
+   common case when querying whole subtrees - then share one parse of
+   that ancestor's (potentially large) mergeinfo property instead of
+   re-parsing it for every path.
  */
 static svn_error_t *
 get_mergeinfo_for_path_internal(svn_mergeinfo_t *mergeinfo,
@@ -4307,12 +4407,11 @@ get_mergeinfo_for_path_internal(svn_mergeinfo_t *mergeinfo,
                                 const char *path,
                                 svn_mergeinfo_inheritance_t inherit,
                                 svn_boolean_t adjust_inherited_mergeinfo,
+                                apr_hash_t *ancestor_cache,
                                 apr_pool_t *result_pool,
                                 apr_pool_t *scratch_pool)
 {
   parent_path_t *parent_path, *nearest_ancestor;
-  apr_hash_t *proplist;
-  svn_string_t *mergeinfo_string;
 
   path = svn_fs__canonicalize_abspath(path, scratch_pool);
 
@@ -4350,34 +4449,60 @@ get_mergeinfo_for_path_internal(svn_mergeinfo_t *mergeinfo,
         }
     }
 
-  SVN_ERR(svn_fs_fs__dag_get_proplist(&proplist, nearest_ancestor->node,
-                                      scratch_pool));
-  mergeinfo_string = svn_hash_gets(proplist, SVN_PROP_MERGEINFO);
-  if (!mergeinfo_string)
-    return svn_error_createf
-      (SVN_ERR_FS_CORRUPT, NULL,
-       _("Node-revision '%s@%ld' claims to have mergeinfo but doesn't"),
-       parent_path_path(nearest_ancestor, scratch_pool), rev_root->rev);
+  /* Inheriting from some ancestor?  Resolve the ancestor's mergeinfo
+     once per request and share it between all paths below it. */
+  if (ancestor_cache && (nearest_ancestor != parent_path))
+    {
+      const char *ancestor_path = parent_path_path(nearest_ancestor,
+                                                   scratch_pool);
+      inherited_mergeinfo_t *inherited = svn_hash_gets(ancestor_cache,
+                                                       ancestor_path);
 
-  /* Parse the mergeinfo; store the result in *MERGEINFO. */
-  {
-    /* Issue #3896: If a node has syntactically invalid mergeinfo, then
-       treat it as if no mergeinfo is present rather than raising a parse
-       error. */
-    svn_error_t *err = svn_mergeinfo_parse(mergeinfo,
-                                           mergeinfo_string->data,
-                                           result_pool);
-    if (err)
-      {
-        if (err->apr_err == SVN_ERR_MERGEINFO_PARSE_ERROR)
-          {
-            svn_error_clear(err);
-            err = NULL;
-            *mergeinfo = NULL;
-          }
-        return svn_error_trace(err);
-      }
-  }
+      if (inherited == NULL)
+        {
+          apr_pool_t *cache_pool = apr_hash_pool_get(ancestor_cache);
+
+          inherited = apr_pcalloc(cache_pool, sizeof(*inherited));
+          SVN_ERR(parse_node_mergeinfo(&inherited->mergeinfo,
+                                       nearest_ancestor->node,
+                                       ancestor_path, rev_root->rev,
+                                       cache_pool, scratch_pool));
+          if (inherited->mergeinfo && adjust_inherited_mergeinfo)
+            SVN_ERR(svn_mergeinfo_inheritable2(&inherited->inheritable,
+                                               inherited->mergeinfo,
+                                               NULL, SVN_INVALID_REVNUM,
+                                               SVN_INVALID_REVNUM, TRUE,
+                                               cache_pool, scratch_pool));
+
+          svn_hash_sets(ancestor_cache,
+                        apr_pstrdup(cache_pool, ancestor_path), inherited);
+        }
+
+      if (inherited->mergeinfo == NULL)
+        return SVN_NO_ERROR;
+
+      /* Only the telescoping of the merged-from paths is specific to
+         PATH; everything else comes from the shared ancestor info. */
+      if (adjust_inherited_mergeinfo)
+        SVN_ERR(svn_fs__append_to_merged_froms(mergeinfo,
+                                               inherited->inheritable,
+                                               parent_path_relpath(
+                                                 parent_path,
+                                                 nearest_ancestor,
+                                                 scratch_pool),
+                                               result_pool));
+      else
+        *mergeinfo = svn_mergeinfo_dup(inherited->mergeinfo, result_pool);
+
+      return SVN_NO_ERROR;
+    }
+
+  SVN_ERR(parse_node_mergeinfo(mergeinfo, nearest_ancestor->node,
+                               parent_path_path(nearest_ancestor,
+                                                scratch_pool),
+                               rev_root->rev, result_pool, scratch_pool));
+  if (*mergeinfo == NULL)
+    return SVN_NO_ERROR;
 
   /* If our nearest ancestor is the very path we inquired about, we
      can return the mergeinfo results directly.  Otherwise, we're
@@ -4409,6 +4534,7 @@ get_mergeinfo_for_path(svn_mergeinfo_t *mergeinfo,
                        const char *path,
                        svn_mergeinfo_inheritance_t inherit,
                        svn_boolean_t adjust_inherited_mergeinfo,
+                       apr_hash_t *ancestor_cache,
                        apr_pool_t *result_pool,
                        apr_pool_t *scratch_pool)
 {
@@ -4437,6 +4563,7 @@ get_mergeinfo_for_path(svn_mergeinfo_t *mergeinfo,
       SVN_ERR(get_mergeinfo_for_path_internal(mergeinfo, rev_root, path,
                                               inherit,
                                               adjust_inherited_mergeinfo,
+                                              ancestor_cache,
                                               result_pool, scratch_pool));
       if (ffd->mergeinfo_existence_cache)
         {
@@ -4497,6 +4624,10 @@ get_mergeinfos_for_paths(svn_fs_root_t *root,
   apr_pool_t *iterpool = svn_pool_create(scratch_pool);
   int i;
 
+  /* Mergeinfo of inheritance source nodes, shared between all paths of
+     this request.  Must live in SCRATCH_POOL as it spans iterations. */
+  apr_hash_t *ancestor_cache = apr_hash_make(scratch_pool);
+
   for (i = 0; i < paths->nelts; i++)
     {
       svn_error_t *err;
@@ -4507,7 +4638,7 @@ get_mergeinfos_for_paths(svn_fs_root_t *root,
 
       err = get_mergeinfo_for_path(&path_mergeinfo, root, path,
                                    inherit, adjust_inherited_mergeinfo,
-                                   iterpool, iterpool);
+                                   ancestor_cache, iterpool, iterpool);
       if (err)
         {
           if (err->apr_err == SVN_ERR_MERGEINFO_PARSE_ERROR)
@@ -4591,6 +4722,7 @@ static root_vtable_t root_vtable = {
   fs_props_changed,
   fs_dir_entries,
   fs_dir_optimal_order,
+  fs_dir_entries_sorted,
   fs_make_dir,
   fs_file_length,
   fs_file_checksum,
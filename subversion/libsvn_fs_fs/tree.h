@@ -31,10 +31,12 @@ extern "C" {
 
 
 
-/* In POOL, create an instance of a DAG node 1st level cache.
-   The POOL will be cleared at regular intervals. */
+/* In POOL, create an instance of a DAG node 1st level cache with
+   BUCKET_COUNT entries (rounded up to a power of two; pass 0 for the
+   built-in default).  The POOL will be cleared at regular intervals. */
 fs_fs_dag_cache_t*
-svn_fs_fs__create_dag_cache(apr_pool_t *pool);
+svn_fs_fs__create_dag_cache(apr_size_t bucket_count,
+                            apr_pool_t *pool);
 
 /* Set *ROOT_P to the root directory of revision REV in filesystem FS.
    Allocate the structure in POOL. */
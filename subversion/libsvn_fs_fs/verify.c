@@ -243,6 +243,7 @@ verify_index_checksums(svn_fs_t *fs,
                                 cancel_func, cancel_baton, scratch_pool));
 
   /* Done. */
+  svn_fs_fs__uncache_revision_file(rev_file, fs);
   SVN_ERR(svn_fs_fs__close_revision_file(rev_file));
 
   return SVN_NO_ERROR;
@@ -263,40 +264,42 @@ compare_l2p_to_p2l_index(svn_fs_t *fs,
 {
   svn_revnum_t i;
   apr_pool_t *iterpool = svn_pool_create(pool);
-  apr_array_header_t *max_ids;
+  apr_pool_t *entry_pool = svn_pool_create(pool);
 
   /* common file access structure */
   svn_fs_fs__revision_file_t *rev_file;
   SVN_ERR(svn_fs_fs__open_pack_or_rev_file(&rev_file, fs, start, pool,
                                            iterpool));
 
-  /* determine the range of items to check for each revision */
-  SVN_ERR(svn_fs_fs__l2p_get_max_ids(&max_ids, fs, start, count, pool,
-                                     iterpool));
-
   /* check all items in all revisions if the given range */
-  for (i = 0; i < max_ids->nelts; ++i)
+  for (i = 0; i < (svn_revnum_t)count; ++i)
     {
-      apr_uint64_t k;
-      apr_uint64_t max_id = APR_ARRAY_IDX(max_ids, i, apr_uint64_t);
+      int k;
+      apr_array_header_t *offsets;
       svn_revnum_t revision = start + i;
 
-      for (k = 0; k < max_id; ++k)
+      svn_pool_clear(iterpool);
+
+      /* get all L2P entries for REVISION at once, streaming the index
+       * pages instead of looking up each item through the page caches */
+      SVN_ERR(svn_fs_fs__l2p_get_offsets(&offsets, fs, rev_file, revision,
+                                         iterpool, iterpool));
+
+      for (k = 0; k < offsets->nelts; ++k)
         {
-          apr_off_t offset;
+          apr_off_t offset = APR_ARRAY_IDX(offsets, k, apr_off_t);
           svn_fs_fs__p2l_entry_t *p2l_entry;
-          svn_pool_clear(iterpool);
 
-          /* get L2P entry.  Ignore unused entries. */
-          SVN_ERR(svn_fs_fs__item_offset(&offset, fs, rev_file, revision,
-                                         NULL, k, iterpool));
+          /* Ignore unused entries. */
           if (offset == -1)
             continue;
 
+          svn_pool_clear(entry_pool);
+
           /* find the corresponding P2L entry */
           SVN_ERR(svn_fs_fs__p2l_entry_lookup(&p2l_entry, fs, rev_file,
-                                              revision, offset, iterpool,
-                                              iterpool));
+                                              revision, offset, entry_pool,
+                                              entry_pool));
 
           if (p2l_entry == NULL)
             return svn_error_createf(SVN_ERR_FS_INDEX_INCONSISTENT,
@@ -323,8 +326,10 @@ compare_l2p_to_p2l_index(svn_fs_t *fs,
         SVN_ERR(cancel_func(cancel_baton));
     }
 
+  svn_pool_destroy(entry_pool);
   svn_pool_destroy(iterpool);
 
+  svn_fs_fs__uncache_revision_file(rev_file, fs);
   SVN_ERR(svn_fs_fs__close_revision_file(rev_file));
 
   return SVN_NO_ERROR;
@@ -435,6 +440,7 @@ compare_p2l_to_l2p_index(svn_fs_t *fs,
 
   svn_pool_destroy(iterpool);
 
+  svn_fs_fs__uncache_revision_file(rev_file, fs);
   SVN_ERR(svn_fs_fs__close_revision_file(rev_file));
 
   return SVN_NO_ERROR;
@@ -734,6 +740,7 @@ compare_p2l_to_rev(svn_fs_t *fs,
 
   svn_pool_destroy(iterpool);
 
+  svn_fs_fs__uncache_revision_file(rev_file, fs);
   SVN_ERR(svn_fs_fs__close_revision_file(rev_file));
 
   return SVN_NO_ERROR;
@@ -899,6 +906,11 @@ svn_fs_fs__verify(svn_fs_t *fs,
 {
   fs_fs_data_t *ffd = fs->fsap_data;
 
+  /* An explicit verification run must check everything, whatever
+     sampling rate the verify-sample-rate option configured for regular
+     reads through this filesystem object. */
+  ffd->verify_sample_rate = 1;
+
   /* Input validation. */
   if (! SVN_IS_VALID_REVNUM(start))
     start = 0;
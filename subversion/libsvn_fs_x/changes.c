@@ -26,7 +26,7 @@
 #include "private/svn_packed_data.h"
 
 #include "changes.h"
-#include "string_table.h"
+#include "private/svn_string_table.h"
 #include "temp_serializer.h"
 
 /* These flags will be used with the FLAGS field in binary_change_t.
@@ -84,8 +84,8 @@ struct svn_fs_x__changes_t
 {
   /* The paths - either in 'builder' mode or finalized mode.
    * The respective other pointer will be NULL. */
-  string_table_builder_t *builder;
-  string_table_t *paths;
+  svn_string_table_builder_t *builder;
+  svn_string_table_t *paths;
 
   /* All changes of all change lists concatenated.
    * Array elements are binary_change_t.structs (not pointer!) */
@@ -120,7 +120,7 @@ svn_fs_x__changes_create(apr_size_t initial_count,
 {
   svn_fs_x__changes_t *changes = changes_create_body(initial_count,
                                                      result_pool);
-  changes->builder = svn_fs_x__string_table_builder_create(result_pool);
+  changes->builder = svn_string_table__builder_create(result_pool);
 
   return changes;
 }
@@ -147,7 +147,7 @@ append_change(svn_fs_x__changes_t *changes,
 
   /* Path of the change. */
   binary_change.path
-    = svn_fs_x__string_table_builder_add(changes->builder,
+    = svn_string_table__builder_add(changes->builder,
                                          change->path.data,
                                          change->path.len);
 
@@ -156,7 +156,7 @@ append_change(svn_fs_x__changes_t *changes,
     {
       binary_change.copyfrom_rev = change->copyfrom_rev;
       binary_change.copyfrom_path
-        = svn_fs_x__string_table_builder_add(changes->builder,
+        = svn_string_table__builder_add(changes->builder,
                                              change->copyfrom_path,
                                              0);
     }
@@ -203,7 +203,7 @@ svn_fs_x__changes_estimate_size(const svn_fs_x__changes_t *changes)
   /* string table code makes its own prediction,
    * changes should be < 10 bytes each,
    * some static overhead should be assumed */
-  return svn_fs_x__string_table_builder_estimate_size(changes->builder)
+  return svn_string_table__builder_estimate_size(changes->builder)
        + changes->changes->nelts * 10
        + 100;
 }
@@ -256,7 +256,7 @@ svn_fs_x__changes_get_list(apr_array_header_t **list,
 
       /* convert BINARY_CHANGE into a standard FSX svn_fs_x__change_t */
       svn_fs_x__change_t *change = apr_pcalloc(result_pool, sizeof(*change));
-      change->path.data = svn_fs_x__string_table_get(changes->paths,
+      change->path.data = svn_string_table__get(changes->paths,
                                                      binary_change->path,
                                                      &change->path.len,
                                                      result_pool);
@@ -275,7 +275,7 @@ svn_fs_x__changes_get_list(apr_array_header_t **list,
       change->copyfrom_known = TRUE;
       if (SVN_IS_VALID_REVNUM(binary_change->copyfrom_rev))
         change->copyfrom_path
-          = svn_fs_x__string_table_get(changes->paths,
+          = svn_string_table__get(changes->paths,
                                         binary_change->copyfrom_path,
                                         NULL,
                                         result_pool);
@@ -294,9 +294,9 @@ svn_fs_x__write_changes_container(svn_stream_t *stream,
 {
   int i;
 
-  string_table_t *paths = changes->paths
+  svn_string_table_t *paths = changes->paths
                         ? changes->paths
-                        : svn_fs_x__string_table_create(changes->builder,
+                        : svn_string_table__create(changes->builder,
                                                         scratch_pool);
 
   svn_packed__data_root_t *root = svn_packed__data_create_root(scratch_pool);
@@ -333,7 +333,7 @@ svn_fs_x__write_changes_container(svn_stream_t *stream,
     }
 
   /* write to disk */
-  SVN_ERR(svn_fs_x__write_string_table(stream, paths, scratch_pool));
+  SVN_ERR(svn_string_table__write(stream, paths, scratch_pool));
   SVN_ERR(svn_packed__data_write(stream, root, scratch_pool));
 
   return SVN_NO_ERROR;
@@ -355,7 +355,7 @@ svn_fs_x__read_changes_container(svn_fs_x__changes_t **changes_p,
   svn_packed__int_stream_t *changes_stream;
 
   /* read from disk */
-  SVN_ERR(svn_fs_x__read_string_table(&changes->paths, stream,
+  SVN_ERR(svn_string_table__read(&changes->paths, stream,
                                       result_pool, scratch_pool));
 
   SVN_ERR(svn_packed__data_read(&root, stream, result_pool, scratch_pool));
@@ -414,7 +414,7 @@ svn_fs_x__serialize_changes_container(void **data,
     = svn_temp_serializer__init(changes, sizeof(*changes), size, pool);
 
   /* serialize sub-structures */
-  svn_fs_x__serialize_string_table(context, &changes->paths);
+  svn_string_table__serialize(context, &changes->paths);
   svn_fs_x__serialize_apr_array(context, &changes->changes);
   svn_fs_x__serialize_apr_array(context, &changes->offsets);
 
@@ -436,7 +436,7 @@ svn_fs_x__deserialize_changes_container(void **out,
   svn_fs_x__changes_t *changes = (svn_fs_x__changes_t *)data;
 
   /* de-serialize sub-structures */
-  svn_fs_x__deserialize_string_table(changes, &changes->paths);
+  svn_string_table__deserialize(changes, &changes->paths);
   svn_fs_x__deserialize_apr_array(changes, &changes->changes, result_pool);
   svn_fs_x__deserialize_apr_array(changes, &changes->offsets, result_pool);
 
@@ -463,7 +463,7 @@ svn_fs_x__changes_get_list_func(void **out,
   const svn_fs_x__changes_t *container = data;
 
   /* resolve all the sub-container pointers we need */
-  const string_table_t *paths
+  const svn_string_table_t *paths
     = svn_temp_deserializer__ptr(container,
                                  (const void *const *)&container->paths);
   const apr_array_header_t *serialized_offsets
@@ -506,7 +506,7 @@ svn_fs_x__changes_get_list_func(void **out,
       /* convert BINARY_CHANGE into a standard FSX svn_fs_x__change_t */
       svn_fs_x__change_t *change = apr_pcalloc(pool, sizeof(*change));
       change->path.data
-        = svn_fs_x__string_table_get_func(paths, binary_change->path,
+        = svn_string_table__get_func(paths, binary_change->path,
                                           &change->path.len, pool);
 
       change->change_kind = (svn_fs_path_change_kind_t)
@@ -520,7 +520,7 @@ svn_fs_x__changes_get_list_func(void **out,
       change->copyfrom_known = TRUE;
       if (SVN_IS_VALID_REVNUM(binary_change->copyfrom_rev))
         change->copyfrom_path
-          = svn_fs_x__string_table_get_func(paths,
+          = svn_string_table__get_func(paths,
                                             binary_change->copyfrom_path,
                                             NULL,
                                             pool);
@@ -28,7 +28,7 @@
 #include "private/svn_temp_serializer.h"
 
 #include "noderevs.h"
-#include "string_table.h"
+#include "private/svn_string_table.h"
 #include "temp_serializer.h"
 
 /* These flags will be used with the FLAGS field in binary_noderev_t.
@@ -123,8 +123,8 @@ struct svn_fs_x__noderevs_t
 {
   /* The paths - either in 'builder' mode or finalized mode.
    * The respective other pointer will be NULL. */
-  string_table_builder_t *builder;
-  string_table_t *paths;
+  svn_string_table_builder_t *builder;
+  svn_string_table_t *paths;
 
   /* During construction, maps a full binary_id_t to an index into IDS */
   apr_hash_t *ids_dict;
@@ -150,7 +150,7 @@ svn_fs_x__noderevs_create(int initial_count,
   svn_fs_x__noderevs_t *noderevs
     = apr_palloc(result_pool, sizeof(*noderevs));
 
-  noderevs->builder = svn_fs_x__string_table_builder_create(result_pool);
+  noderevs->builder = svn_string_table__builder_create(result_pool);
   noderevs->ids_dict = svn_hash__make(result_pool);
   noderevs->reps_dict = svn_hash__make(result_pool);
   noderevs->paths = NULL;
@@ -244,7 +244,7 @@ svn_fs_x__noderevs_add(svn_fs_x__noderevs_t *container,
   if (noderev->copyfrom_path)
     {
       binary_noderev.copyfrom_path
-        = svn_fs_x__string_table_builder_add(container->builder,
+        = svn_string_table__builder_add(container->builder,
                                              noderev->copyfrom_path,
                                              0);
       binary_noderev.copyfrom_rev = noderev->copyfrom_rev;
@@ -253,7 +253,7 @@ svn_fs_x__noderevs_add(svn_fs_x__noderevs_t *container,
   if (noderev->copyroot_path)
     {
       binary_noderev.copyroot_path
-        = svn_fs_x__string_table_builder_add(container->builder,
+        = svn_string_table__builder_add(container->builder,
                                              noderev->copyroot_path,
                                              0);
       binary_noderev.copyroot_rev = noderev->copyroot_rev;
@@ -269,7 +269,7 @@ svn_fs_x__noderevs_add(svn_fs_x__noderevs_t *container,
 
   if (noderev->created_path)
     binary_noderev.created_path
-      = svn_fs_x__string_table_builder_add(container->builder,
+      = svn_string_table__builder_add(container->builder,
                                            noderev->created_path,
                                            0);
 
@@ -293,7 +293,7 @@ svn_fs_x__noderevs_estimate_size(const svn_fs_x__noderevs_t *container)
    * data representations < 40 bytes each,
    * property representations < 30 bytes each,
    * some static overhead should be assumed */
-  return svn_fs_x__string_table_builder_estimate_size(container->builder)
+  return svn_string_table__builder_estimate_size(container->builder)
        + container->noderevs->nelts * 16
        + container->ids->nelts * 4
        + container->reps->nelts * 40
@@ -395,7 +395,7 @@ svn_fs_x__noderevs_get(svn_fs_x__noderev_t **noderev_p,
   if (binary_noderev->flags & NODEREV_HAS_COPYFROM)
     {
       noderev->copyfrom_path
-        = svn_fs_x__string_table_get(container->paths,
+        = svn_string_table__get(container->paths,
                                      binary_noderev->copyfrom_path,
                                      NULL,
                                      result_pool);
@@ -410,7 +410,7 @@ svn_fs_x__noderevs_get(svn_fs_x__noderev_t **noderev_p,
   if (binary_noderev->flags & NODEREV_HAS_COPYROOT)
     {
       noderev->copyroot_path
-        = svn_fs_x__string_table_get(container->paths,
+        = svn_string_table__get(container->paths,
                                      binary_noderev->copyroot_path,
                                      NULL,
                                      result_pool);
@@ -431,7 +431,7 @@ svn_fs_x__noderevs_get(svn_fs_x__noderev_t **noderev_p,
 
   if (binary_noderev->flags & NODEREV_HAS_CPATH)
     noderev->created_path
-      = svn_fs_x__string_table_get(container->paths,
+      = svn_string_table__get(container->paths,
                                    binary_noderev->created_path,
                                    NULL,
                                    result_pool);
@@ -504,9 +504,9 @@ svn_fs_x__write_noderevs_container(svn_stream_t *stream,
 {
   int i;
 
-  string_table_t *paths = container->paths
+  svn_string_table_t *paths = container->paths
                         ? container->paths
-                        : svn_fs_x__string_table_create(container->builder,
+                        : svn_string_table__create(container->builder,
                                                         scratch_pool);
 
   svn_packed__data_root_t *root = svn_packed__data_create_root(scratch_pool);
@@ -572,7 +572,7 @@ svn_fs_x__write_noderevs_container(svn_stream_t *stream,
     }
 
   /* write to disk */
-  SVN_ERR(svn_fs_x__write_string_table(stream, paths, scratch_pool));
+  SVN_ERR(svn_string_table__write(stream, paths, scratch_pool));
   SVN_ERR(svn_packed__data_write(stream, root, scratch_pool));
 
   return SVN_NO_ERROR;
@@ -663,7 +663,7 @@ svn_fs_x__read_noderevs_container(svn_fs_x__noderevs_t **container,
   svn_packed__byte_stream_t *digests_stream;
 
   /* read everything from disk */
-  SVN_ERR(svn_fs_x__read_string_table(&noderevs->paths, stream,
+  SVN_ERR(svn_string_table__read(&noderevs->paths, stream,
                                       result_pool, scratch_pool));
   SVN_ERR(svn_packed__data_read(&root, stream, result_pool, scratch_pool));
 
@@ -749,7 +749,7 @@ svn_fs_x__serialize_noderevs_container(void **data,
     = svn_temp_serializer__init(noderevs, sizeof(*noderevs), size, pool);
 
   /* serialize sub-structures */
-  svn_fs_x__serialize_string_table(context, &noderevs->paths);
+  svn_string_table__serialize(context, &noderevs->paths);
   svn_fs_x__serialize_apr_array(context, &noderevs->ids);
   svn_fs_x__serialize_apr_array(context, &noderevs->reps);
   svn_fs_x__serialize_apr_array(context, &noderevs->noderevs);
@@ -772,7 +772,7 @@ svn_fs_x__deserialize_noderevs_container(void **out,
   svn_fs_x__noderevs_t *noderevs = (svn_fs_x__noderevs_t *)data;
 
   /* de-serialize sub-structures */
-  svn_fs_x__deserialize_string_table(noderevs, &noderevs->paths);
+  svn_string_table__deserialize(noderevs, &noderevs->paths);
   svn_fs_x__deserialize_apr_array(noderevs, &noderevs->ids, result_pool);
   svn_fs_x__deserialize_apr_array(noderevs, &noderevs->reps, result_pool);
   svn_fs_x__deserialize_apr_array(noderevs, &noderevs->noderevs, result_pool);
@@ -819,7 +819,7 @@ svn_fs_x__noderevs_get_func(void **out,
   const svn_fs_x__noderevs_t *container = data;
 
   /* Resolve all container pointers */
-  const string_table_t *paths
+  const svn_string_table_t *paths
     = svn_temp_deserializer__ptr(container,
                          (const void *const *)&container->paths);
 
@@ -841,7 +841,7 @@ svn_fs_x__noderevs_get_func(void **out,
   if (binary_noderev->flags & NODEREV_HAS_COPYFROM)
     {
       noderev->copyfrom_path
-        = svn_fs_x__string_table_get_func(paths,
+        = svn_string_table__get_func(paths,
                                           binary_noderev->copyfrom_path,
                                           NULL,
                                           pool);
@@ -856,7 +856,7 @@ svn_fs_x__noderevs_get_func(void **out,
   if (binary_noderev->flags & NODEREV_HAS_COPYROOT)
     {
       noderev->copyroot_path
-        = svn_fs_x__string_table_get_func(paths,
+        = svn_string_table__get_func(paths,
                                           binary_noderev->copyroot_path,
                                           NULL,
                                           pool);
@@ -877,7 +877,7 @@ svn_fs_x__noderevs_get_func(void **out,
 
   if (binary_noderev->flags & NODEREV_HAS_CPATH)
     noderev->created_path
-      = svn_fs_x__string_table_get_func(paths,
+      = svn_string_table__get_func(paths,
                                         binary_noderev->created_path,
                                         NULL,
                                         pool);
@@ -3243,6 +3243,7 @@ static root_vtable_t root_vtable = {
   x_props_changed,
   x_dir_entries,
   x_dir_optimal_order,
+  NULL,
   x_make_dir,
   x_file_length,
   x_file_checksum,
@@ -1652,7 +1652,17 @@ svn_ra_local__replay_range(svn_ra_session_t *session,
                            void *replay_baton,
                            apr_pool_t *pool)
 {
-  return svn_error_create(SVN_ERR_RA_NOT_IMPLEMENTED, NULL, NULL);
+  svn_ra_local__session_baton_t *sess = session->priv;
+
+  /* The svn_repos callback types intentionally match their svn_ra
+     counterparts, so the caller's callbacks can be passed through. */
+  return svn_error_trace(svn_repos_replay_range(sess->repos,
+                                                sess->fs_path->data,
+                                                start_revision, end_revision,
+                                                low_water_mark, send_deltas,
+                                                revstart_func, revfinish_func,
+                                                replay_baton, NULL, NULL,
+                                                pool));
 }
 
 
@@ -1854,13 +1864,15 @@ svn_ra_local__list(svn_ra_session_t *session,
 
   SVN_ERR(svn_fs_revision_root(&root, sess->fs, revision, pool));
   path = svn_dirent_join(sess->fs_path->data, path, pool);
-  return svn_error_trace(svn_repos_list(root, path, patterns, depth,
-                                        path_info_only, NULL, NULL,
-                                        dirent_receiver, &baton,
-                                        sess->callbacks
-                                          ? sess->callbacks->cancel_func
-                                          : NULL,
-                                        sess->callback_baton, pool));
+  return svn_error_trace(svn_repos_list2(root, path, patterns, depth,
+                                         path_info_only,
+                                         NULL, 0, /* no pagination */
+                                         NULL, NULL,
+                                         dirent_receiver, &baton,
+                                         sess->callbacks
+                                           ? sess->callbacks->cancel_func
+                                           : NULL,
+                                         sess->callback_baton, pool));
 }
 
 static svn_error_t *
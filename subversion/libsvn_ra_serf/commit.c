@@ -40,6 +40,7 @@
 #include "private/svn_dep_compat.h"
 #include "private/svn_fspath.h"
 #include "private/svn_skel.h"
+#include "private/svn_subr_private.h"
 
 #include "ra_serf.h"
 #include "../libsvn_ra/ra_loader.h"
@@ -1875,7 +1876,11 @@ negotiate_put_encoding(int *svndiff_version_p,
 
   if (session->using_compression == svn_tristate_unknown)
     {
-      /* With http-compression=auto, prefer svndiff2 to svndiff1 with a
+      /* Prefer zstd-based svndiff3 whenever both sides support it: it
+       * combines the speed of svndiff2 with a compression ratio at least
+       * as good as svndiff1's.
+       *
+       * With http-compression=auto, prefer svndiff2 to svndiff1 with a
        * low latency connection (assuming the underlying network has high
        * bandwidth), as it is faster and in this case, we don't care about
        * worse compression ratio.
@@ -1883,8 +1888,10 @@ negotiate_put_encoding(int *svndiff_version_p,
        * Note: For future compatibility, we also handle a theoretically
        * possible case where the server has advertised only svndiff2 support.
        */
-      if (session->supports_svndiff2 &&
-          svn_ra_serf__is_low_latency_connection(session))
+      if (session->supports_svndiff3 && svn__zstd_available())
+        svndiff_version = 3;
+      else if (session->supports_svndiff2 &&
+               svn_ra_serf__is_low_latency_connection(session))
         svndiff_version = 2;
       else if (session->supports_svndiff1)
         svndiff_version = 1;
@@ -1895,7 +1902,9 @@ negotiate_put_encoding(int *svndiff_version_p,
     }
   else if (session->using_compression == svn_tristate_true)
     {
-      /* Otherwise, prefer svndiff1, as svndiff2 is not a reasonable
+      /* Again, svndiff3 is the best choice when available.
+       *
+       * Otherwise, prefer svndiff1, as svndiff2 is not a reasonable
        * substitute for svndiff1 with default compression level.  (It gives
        * better speed and compression ratio comparable to svndiff1 with
        * compression level 1, but not 5).
@@ -1903,7 +1912,9 @@ negotiate_put_encoding(int *svndiff_version_p,
        * Note: For future compatibility, we also handle a theoretically
        * possible case where the server has advertised only svndiff2 support.
        */
-      if (session->supports_svndiff1)
+      if (session->supports_svndiff3 && svn__zstd_available())
+        svndiff_version = 3;
+      else if (session->supports_svndiff1)
         svndiff_version = 1;
       else if (session->supports_svndiff2)
         svndiff_version = 2;
@@ -71,6 +71,11 @@ typedef struct stream_ctx_t {
   /* This is the amount of data that we have read so far. */
   apr_off_t read_size;
 
+  /* Did we ask the server for just the remainder of the content via a
+   * Range header after an aborted read?
+   */
+  svn_boolean_t range_requested;
+
   /* If we're writing this file to a stream, this will be non-NULL. */
   svn_stream_t *result_stream;
 
@@ -93,6 +98,23 @@ headers_fetch(serf_bucket_t *headers,
       serf_bucket_headers_setn(headers, "Accept-Encoding", "gzip");
     }
 
+  /* If our previous response died mid-stream, ask the server for just the
+   * bytes we are missing instead of re-downloading everything we already
+   * wrote out.  With compression enabled we cannot do this: READ_SIZE
+   * counts decoded bytes while a Range header addresses the encoded
+   * entity, so in that case we fall back to skipping in handle_stream().
+   */
+  fetch_ctx->range_requested = FALSE;
+  if (fetch_ctx->aborted_read
+      && fetch_ctx->session->using_compression == svn_tristate_false)
+    {
+      serf_bucket_headers_setn(headers, "Range",
+                               apr_psprintf(pool,
+                                            "bytes=%" APR_OFF_T_FMT "-",
+                                            fetch_ctx->aborted_read_size));
+      fetch_ctx->range_requested = TRUE;
+    }
+
   return SVN_NO_ERROR;
 }
 
@@ -200,9 +222,25 @@ handle_stream(serf_request_t *request,
   stream_ctx_t *fetch_ctx = handler_baton;
   apr_status_t status;
 
-  if (fetch_ctx->handler->sline.code != 200)
+  if (fetch_ctx->range_requested
+      && fetch_ctx->handler->sline.code == 206)
+    {
+      /* The server honored our Range request; the response body picks up
+       * right where the aborted response left off, so there is nothing
+       * to skip.  If the server ignored the Range header and sent a 200,
+       * the skip logic below handles the overlap as before.
+       */
+      if (fetch_ctx->aborted_read)
+        {
+          fetch_ctx->aborted_read = FALSE;
+          fetch_ctx->read_size = fetch_ctx->aborted_read_size;
+        }
+    }
+  else if (fetch_ctx->handler->sline.code != 200)
     return svn_error_trace(svn_ra_serf__unexpected_status(fetch_ctx->handler));
 
+  fetch_ctx->read_headers = TRUE;
+
   while (1)
     {
       const char *data;
@@ -392,10 +430,28 @@ svn_ra_serf__get_file(svn_ra_session_t *ra_session,
         {
           stream_ctx_t *stream_ctx;
           svn_ra_serf__handler_t *handler;
+          svn_checksum_t *expected_checksum = NULL;
+          svn_checksum_t *actual_checksum = NULL;
+          svn_stream_t *dst_stream = stream;
+
+          /* If the server told us the content checksum, verify what we
+           * reassemble on our end -- in particular after a ranged resume
+           * of an aborted fetch. */
+          if (fb.sha1_checksum)
+            {
+              SVN_ERR(svn_checksum_parse_hex(&expected_checksum,
+                                             svn_checksum_sha1,
+                                             fb.sha1_checksum,
+                                             scratch_pool));
+              dst_stream = svn_stream_checksummed2(
+                             svn_stream_disown(stream, scratch_pool),
+                             NULL, &actual_checksum,
+                             svn_checksum_sha1, TRUE, scratch_pool);
+            }
 
           /* Create the fetch context. */
           stream_ctx = apr_pcalloc(scratch_pool, sizeof(*stream_ctx));
-          stream_ctx->result_stream = stream;
+          stream_ctx->result_stream = dst_stream;
           stream_ctx->session = session;
 
           handler = svn_ra_serf__create_handler(session, scratch_pool);
@@ -419,8 +475,21 @@ svn_ra_serf__get_file(svn_ra_session_t *ra_session,
 
           SVN_ERR(svn_ra_serf__context_run_one(handler, scratch_pool));
 
-          if (handler->sline.code != 200)
+          if (handler->sline.code != 200
+              && !(stream_ctx->range_requested && handler->sline.code == 206))
             return svn_error_trace(svn_ra_serf__unexpected_status(handler));
+
+          if (expected_checksum)
+            {
+              SVN_ERR(svn_stream_close(dst_stream));
+
+              if (!svn_checksum_match(expected_checksum, actual_checksum))
+                return svn_checksum_mismatch_err(expected_checksum,
+                                                 actual_checksum,
+                                                 scratch_pool,
+                                                 _("Checksum mismatch for '%s'"),
+                                                 path);
+            }
         }
     }
 
@@ -479,7 +548,8 @@ svn_ra_serf__fetch_file_contents(svn_ra_session_t *ra_session,
 
   if (err)
     return svn_error_trace(err);
-  else if (handler->sline.code != 200)
+  else if (handler->sline.code != 200
+           && !(stream_ctx->range_requested && handler->sline.code == 206))
     return svn_error_trace(svn_ra_serf__unexpected_status(handler));
 
   return SVN_NO_ERROR;
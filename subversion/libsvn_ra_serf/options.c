@@ -27,12 +27,15 @@
 
 #include <serf.h>
 
+#include "svn_checksum.h"
 #include "svn_dirent_uri.h"
 #include "svn_hash.h"
+#include "svn_io.h"
 #include "svn_pools.h"
 #include "svn_path.h"
 #include "svn_ra.h"
 #include "svn_dav.h"
+#include "svn_time.h"
 #include "svn_xml.h"
 #include "svn_ctype.h"
 
@@ -149,6 +152,349 @@ static const char *const capability_no = "no";
 static const char *const capability_server_yes = "server-yes";
 
 
+/** Persistent capability cache.
+ *
+ * When the http-capability-cache servers option is enabled, the outcome
+ * of the initial OPTIONS exchange - capabilities, repository UUID and
+ * root, and the HTTP v2 information - is written to a file under the
+ * runtime configuration area, one file per session URL, in the same
+ * hash-dump format that the auth area uses.  A later session against
+ * the same URL can then be initialized from disk and skip the OPTIONS
+ * round trip entirely.
+ *
+ * There is no cheap way to revalidate this data against the server
+ * without paying the round trip we are trying to save, so entries are
+ * simply trusted for OPTIONS_CACHE_MAX_AGE and refreshed by the next
+ * real exchange after that.  Capabilities effectively change only on
+ * server or repository upgrades, so a stale entry is at worst a
+ * temporarily missed feature, never a correctness problem.
+ */
+
+/* How long a cached OPTIONS exchange remains usable. */
+#define OPTIONS_CACHE_MAX_AGE apr_time_from_sec(24 * 60 * 60)
+
+/* Boolean session flags stored in the cache's "flags" item. */
+#define OPTIONS_CACHE_FLAG_INLINE_PROPS "inline-props"
+#define OPTIONS_CACHE_FLAG_REV_RSRC_REPLAY "rev-rsrc-replay"
+#define OPTIONS_CACHE_FLAG_SVNDIFF1 "svndiff1"
+#define OPTIONS_CACHE_FLAG_SVNDIFF2 "svndiff2"
+#define OPTIONS_CACHE_FLAG_SVNDIFF3 "svndiff3"
+#define OPTIONS_CACHE_FLAG_PUT_RESULT_CHECKSUM "put-result-checksum"
+
+/* Prefix of the cache items holding SESSION->capabilities entries. */
+#define OPTIONS_CACHE_CAP_PREFIX "cap:"
+
+/* Set *PATH to the cache file for SESSION's URL, or to NULL if the
+   session has no known configuration area.  Allocate *PATH in POOL. */
+static svn_error_t *
+options_cache_path(const char **path,
+                   svn_ra_serf__session_t *session,
+                   apr_pool_t *pool)
+{
+  const char *config_dir = NULL;
+  svn_checksum_t *checksum;
+
+  if (session->auth_baton)
+    config_dir = svn_auth_get_parameter(session->auth_baton,
+                                        SVN_AUTH_PARAM_CONFIG_DIR);
+  if (!config_dir)
+    {
+      *path = NULL;
+      return SVN_NO_ERROR;
+    }
+
+  /* One file per URL, named like the auth area names its entries. */
+  SVN_ERR(svn_checksum(&checksum, svn_checksum_sha1,
+                       session->session_url_str,
+                       strlen(session->session_url_str), pool));
+  *path = svn_dirent_join_many(pool, config_dir, "http-capabilities",
+                               svn_checksum_to_cstring_display(checksum,
+                                                               pool),
+                               SVN_VA_NULL);
+  return SVN_NO_ERROR;
+}
+
+/* Return the value of the ITEMS entry for KEY, or NULL if there is
+   no such entry. */
+static const char *
+options_cache_item(apr_hash_t *items, const char *key)
+{
+  svn_string_t *value = svn_hash_gets(items, key);
+
+  return value ? value->data : NULL;
+}
+
+/* If ITEMS has an entry for KEY, dup its value into SESSION->pool and
+   return it; return NULL otherwise. */
+static const char *
+options_cache_dup_item(apr_hash_t *items,
+                       const char *key,
+                       svn_ra_serf__session_t *session)
+{
+  const char *value = options_cache_item(items, key);
+
+  return value ? apr_pstrdup(session->pool, value) : NULL;
+}
+
+/* Add an entry for KEY with value VALUE to ITEMS, allocated in POOL.
+   Do nothing if VALUE is NULL. */
+static void
+options_cache_set_item(apr_hash_t *items,
+                       const char *key,
+                       const char *value,
+                       apr_pool_t *pool)
+{
+  if (value)
+    svn_hash_sets(items, key, svn_string_create(value, pool));
+}
+
+svn_error_t *
+svn_ra_serf__options_cache_load(svn_boolean_t *cache_hit,
+                                svn_ra_serf__session_t *serf_sess,
+                                apr_pool_t *scratch_pool)
+{
+  const char *path;
+  const char *url;
+  const char *timestamp;
+  const char *value;
+  apr_time_t written;
+  svn_stream_t *stream;
+  apr_hash_t *items;
+  apr_hash_index_t *hi;
+  svn_error_t *err;
+
+  *cache_hit = FALSE;
+
+  SVN_ERR(options_cache_path(&path, serf_sess, scratch_pool));
+  if (!path)
+    return SVN_NO_ERROR;
+
+  /* Whatever goes wrong while reading the cache, the worst valid
+     answer is "no usable entry"; never fail the session over it. */
+  items = apr_hash_make(scratch_pool);
+  err = svn_stream_open_readonly(&stream, path, scratch_pool, scratch_pool);
+  if (!err)
+    err = svn_error_compose_create(svn_hash_read2(items, stream,
+                                                  SVN_HASH_TERMINATOR,
+                                                  scratch_pool),
+                                   svn_stream_close(stream));
+  if (err)
+    {
+      svn_error_clear(err);
+      return SVN_NO_ERROR;
+    }
+
+  /* The file name is a hash of the URL; make sure we really found the
+     entry for this session and that it has not expired yet. */
+  url = options_cache_item(items, "url");
+  timestamp = options_cache_item(items, "timestamp");
+  if (!url || !timestamp || strcmp(url, serf_sess->session_url_str) != 0)
+    return SVN_NO_ERROR;
+
+  err = svn_time_from_cstring(&written, timestamp, scratch_pool);
+  if (err)
+    {
+      svn_error_clear(err);
+      return SVN_NO_ERROR;
+    }
+  if (written + OPTIONS_CACHE_MAX_AGE < apr_time_now()
+      || written > apr_time_now())
+    return SVN_NO_ERROR;
+
+  /* Capability table.  The values must be the well-known constants so
+     that pointer comparisons keep working; skip anything else. */
+  for (hi = apr_hash_first(scratch_pool, items); hi; hi = apr_hash_next(hi))
+    {
+      const char *key = apr_hash_this_key(hi);
+      const svn_string_t *val = apr_hash_this_val(hi);
+      const char *capability;
+
+      if (strncmp(key, OPTIONS_CACHE_CAP_PREFIX,
+                  strlen(OPTIONS_CACHE_CAP_PREFIX)) != 0)
+        continue;
+
+      capability = apr_pstrdup(serf_sess->pool,
+                               key + strlen(OPTIONS_CACHE_CAP_PREFIX));
+      if (strcmp(val->data, capability_yes) == 0)
+        svn_hash_sets(serf_sess->capabilities, capability, capability_yes);
+      else if (strcmp(val->data, capability_no) == 0)
+        svn_hash_sets(serf_sess->capabilities, capability, capability_no);
+      else if (strcmp(val->data, capability_server_yes) == 0)
+        svn_hash_sets(serf_sess->capabilities, capability,
+                      capability_server_yes);
+    }
+
+  /* Repository identity. */
+  serf_sess->uuid = options_cache_dup_item(items, "uuid", serf_sess);
+  value = options_cache_dup_item(items, "repos-root", serf_sess);
+  if (value)
+    {
+      SVN_ERR(svn_ra_serf__uri_parse(&serf_sess->repos_root, value,
+                                     serf_sess->pool));
+      serf_sess->repos_root_str = value;
+    }
+  serf_sess->activity_collection_url
+    = options_cache_dup_item(items, "activity-url", serf_sess);
+
+  /* HTTP v2 information. */
+  serf_sess->me_resource
+    = options_cache_dup_item(items, "me-resource", serf_sess);
+  serf_sess->rev_stub = options_cache_dup_item(items, "rev-stub", serf_sess);
+  serf_sess->rev_root_stub
+    = options_cache_dup_item(items, "rev-root-stub", serf_sess);
+  serf_sess->txn_stub = options_cache_dup_item(items, "txn-stub", serf_sess);
+  serf_sess->txn_root_stub
+    = options_cache_dup_item(items, "txn-root-stub", serf_sess);
+  serf_sess->vtxn_stub = options_cache_dup_item(items, "vtxn-stub",
+                                                serf_sess);
+  serf_sess->vtxn_root_stub
+    = options_cache_dup_item(items, "vtxn-root-stub", serf_sess);
+
+  value = options_cache_item(items, "supported-posts");
+  if (value)
+    {
+      apr_array_header_t *vals = svn_cstring_split(value, ",", TRUE,
+                                                   serf_sess->pool);
+      int i;
+
+      serf_sess->supported_posts = apr_hash_make(serf_sess->pool);
+      for (i = 0; i < vals->nelts; i++)
+        svn_hash_sets(serf_sess->supported_posts,
+                      APR_ARRAY_IDX(vals, i, const char *), (void *)1);
+    }
+
+  serf_sess->server_allows_bulk
+    = options_cache_dup_item(items, "allow-bulk-updates", serf_sess);
+
+  value = options_cache_item(items, "flags");
+  if (value)
+    {
+      apr_array_header_t *vals = svn_cstring_split(value, " ", TRUE,
+                                                   scratch_pool);
+
+      serf_sess->supports_inline_props
+        = svn_cstring_match_list(OPTIONS_CACHE_FLAG_INLINE_PROPS, vals);
+      serf_sess->supports_rev_rsrc_replay
+        = svn_cstring_match_list(OPTIONS_CACHE_FLAG_REV_RSRC_REPLAY, vals);
+      serf_sess->supports_svndiff1
+        = svn_cstring_match_list(OPTIONS_CACHE_FLAG_SVNDIFF1, vals);
+      serf_sess->supports_svndiff2
+        = svn_cstring_match_list(OPTIONS_CACHE_FLAG_SVNDIFF2, vals);
+      serf_sess->supports_svndiff3
+        = svn_cstring_match_list(OPTIONS_CACHE_FLAG_SVNDIFF3, vals);
+      serf_sess->supports_put_result_checksum
+        = svn_cstring_match_list(OPTIONS_CACHE_FLAG_PUT_RESULT_CHECKSUM,
+                                 vals);
+    }
+
+  *cache_hit = TRUE;
+
+  return SVN_NO_ERROR;
+}
+
+/* Write SESSION's capability data to the cache file for its URL, if a
+   configuration area is known.  Use SCRATCH_POOL for all temporary
+   allocations. */
+static svn_error_t *
+options_cache_save(svn_ra_serf__session_t *session,
+                   apr_pool_t *scratch_pool)
+{
+  const char *path;
+  apr_hash_t *items = apr_hash_make(scratch_pool);
+  svn_stringbuf_t *buf = svn_stringbuf_create_empty(scratch_pool);
+  svn_stringbuf_t *flags = svn_stringbuf_create_empty(scratch_pool);
+  svn_stream_t *stream;
+  apr_hash_index_t *hi;
+
+  SVN_ERR(options_cache_path(&path, session, scratch_pool));
+  if (!path)
+    return SVN_NO_ERROR;
+
+  options_cache_set_item(items, "url", session->session_url_str,
+                         scratch_pool);
+  options_cache_set_item(items, "timestamp",
+                         svn_time_to_cstring(apr_time_now(), scratch_pool),
+                         scratch_pool);
+
+  for (hi = apr_hash_first(scratch_pool, session->capabilities);
+       hi; hi = apr_hash_next(hi))
+    {
+      const char *capability = apr_hash_this_key(hi);
+      const char *value = apr_hash_this_val(hi);
+
+      if (value)
+        options_cache_set_item(items,
+                               apr_pstrcat(scratch_pool,
+                                           OPTIONS_CACHE_CAP_PREFIX,
+                                           capability, SVN_VA_NULL),
+                               value, scratch_pool);
+    }
+
+  options_cache_set_item(items, "uuid", session->uuid, scratch_pool);
+  options_cache_set_item(items, "repos-root", session->repos_root_str,
+                         scratch_pool);
+  options_cache_set_item(items, "activity-url",
+                         session->activity_collection_url, scratch_pool);
+
+  options_cache_set_item(items, "me-resource", session->me_resource,
+                         scratch_pool);
+  options_cache_set_item(items, "rev-stub", session->rev_stub, scratch_pool);
+  options_cache_set_item(items, "rev-root-stub", session->rev_root_stub,
+                         scratch_pool);
+  options_cache_set_item(items, "txn-stub", session->txn_stub, scratch_pool);
+  options_cache_set_item(items, "txn-root-stub", session->txn_root_stub,
+                         scratch_pool);
+  options_cache_set_item(items, "vtxn-stub", session->vtxn_stub,
+                         scratch_pool);
+  options_cache_set_item(items, "vtxn-root-stub", session->vtxn_root_stub,
+                         scratch_pool);
+
+  if (session->supported_posts)
+    {
+      svn_stringbuf_t *posts = svn_stringbuf_create_empty(scratch_pool);
+
+      for (hi = apr_hash_first(scratch_pool, session->supported_posts);
+           hi; hi = apr_hash_next(hi))
+        {
+          if (posts->len > 0)
+            svn_stringbuf_appendbyte(posts, ',');
+          svn_stringbuf_appendcstr(posts, apr_hash_this_key(hi));
+        }
+      options_cache_set_item(items, "supported-posts", posts->data,
+                             scratch_pool);
+    }
+
+  options_cache_set_item(items, "allow-bulk-updates",
+                         session->server_allows_bulk, scratch_pool);
+
+  if (session->supports_inline_props)
+    svn_stringbuf_appendcstr(flags, " " OPTIONS_CACHE_FLAG_INLINE_PROPS);
+  if (session->supports_rev_rsrc_replay)
+    svn_stringbuf_appendcstr(flags, " " OPTIONS_CACHE_FLAG_REV_RSRC_REPLAY);
+  if (session->supports_svndiff1)
+    svn_stringbuf_appendcstr(flags, " " OPTIONS_CACHE_FLAG_SVNDIFF1);
+  if (session->supports_svndiff2)
+    svn_stringbuf_appendcstr(flags, " " OPTIONS_CACHE_FLAG_SVNDIFF2);
+  if (session->supports_svndiff3)
+    svn_stringbuf_appendcstr(flags, " " OPTIONS_CACHE_FLAG_SVNDIFF3);
+  if (session->supports_put_result_checksum)
+    svn_stringbuf_appendcstr(flags,
+                             " " OPTIONS_CACHE_FLAG_PUT_RESULT_CHECKSUM);
+  options_cache_set_item(items, "flags", flags->data, scratch_pool);
+
+  stream = svn_stream_from_stringbuf(buf, scratch_pool);
+  SVN_ERR(svn_hash_write2(items, stream, SVN_HASH_TERMINATOR, scratch_pool));
+  SVN_ERR(svn_stream_close(stream));
+
+  SVN_ERR(svn_io_make_dir_recursively(svn_dirent_dirname(path, scratch_pool),
+                                      scratch_pool));
+  SVN_ERR(svn_io_write_atomic2(path, buf->data, buf->len, NULL, FALSE,
+                               scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+
 /* This implements serf_bucket_headers_do_callback_fn_t.
  */
 static int
@@ -247,6 +593,11 @@ capabilities_headers_iterator_callback(void *baton,
           /* Same for svndiff2. */
           session->supports_svndiff2 = TRUE;
         }
+      if (svn_cstring_match_list(SVN_DAV_NS_DAV_SVN_SVNDIFF3, vals))
+        {
+          /* And for svndiff3. */
+          session->supports_svndiff3 = TRUE;
+        }
       if (svn_cstring_match_list(SVN_DAV_NS_DAV_SVN_PUT_RESULT_CHECKSUM, vals))
         {
           session->supports_put_result_checksum = TRUE;
@@ -627,6 +978,12 @@ svn_ra_serf__exchange_capabilities(svn_ra_serf__session_t *serf_sess,
         apr_pstrdup(serf_sess->pool, opt_ctx->activity_collection);
     }
 
+  /* Remember the outcome for future sessions.  This is strictly
+     best-effort: a read-only configuration area is no reason to fail
+     an exchange which has already succeeded. */
+  if (serf_sess->use_capability_cache)
+    svn_error_clear(options_cache_save(serf_sess, scratch_pool));
+
   return SVN_NO_ERROR;
 }
 
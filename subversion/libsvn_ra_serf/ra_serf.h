@@ -269,11 +269,20 @@ struct svn_ra_serf__session_t {
   /* Indicates whether the server can understand svndiff version 2. */
   svn_boolean_t supports_svndiff2;
 
+  /* Indicates whether the server can understand svndiff version 3. */
+  svn_boolean_t supports_svndiff3;
+
   /* Indicates whether the server sends the result checksum in the response
    * to a successful PUT request. */
   svn_boolean_t supports_put_result_checksum;
 
   apr_interval_time_t conn_latency;
+
+  /* Whether the persistent capability cache is enabled for this server
+     (the http-capability-cache servers file option).  When set, session
+     setup reuses a recent OPTIONS exchange from disk instead of issuing
+     a fresh one. */
+  svn_boolean_t use_capability_cache;
 };
 
 #define SVN_RA_SERF__HAVE_HTTPV2_SUPPORT(sess) ((sess)->me_resource != NULL)
@@ -1476,6 +1485,20 @@ svn_ra_serf__exchange_capabilities(svn_ra_serf__session_t *serf_sess,
                                    apr_pool_t *result_pool,
                                    apr_pool_t *scratch_pool);
 
+/* Try to initialize SERF_SESS's capabilities, repository UUID and root,
+ * and HTTP v2 data from the on-disk cache written by an earlier
+ * svn_ra_serf__exchange_capabilities() for the same session URL.  Set
+ * *CACHE_HIT to TRUE iff a sufficiently fresh entry was found, in which
+ * case the initial OPTIONS round trip may be skipped.
+ *
+ * A missing, stale or unreadable cache entry is not an error; it simply
+ * results in *CACHE_HIT being FALSE.
+ */
+svn_error_t *
+svn_ra_serf__options_cache_load(svn_boolean_t *cache_hit,
+                                svn_ra_serf__session_t *serf_sess,
+                                apr_pool_t *scratch_pool);
+
 /* Implements svn_ra__vtable_t.has_capability(). */
 svn_error_t *
 svn_ra_serf__has_capability(svn_ra_session_t *ra_session,
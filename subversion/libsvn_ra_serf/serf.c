@@ -251,6 +251,12 @@ load_config(svn_ra_serf__session_t *session,
                                   SVN_CONFIG_OPTION_HTTP_CHUNKED_REQUESTS,
                                   "auto", svn_tristate_unknown));
 
+  /* Should session setup reuse a recently cached OPTIONS exchange? */
+  SVN_ERR(svn_config_get_bool(config, &session->use_capability_cache,
+                              SVN_CONFIG_SECTION_GLOBAL,
+                              SVN_CONFIG_OPTION_HTTP_CAPABILITY_CACHE,
+                              FALSE));
+
 #if SERF_VERSION_AT_LEAST(1, 4, 0) && !defined(SVN_SERF_NO_LOGGING)
   SVN_ERR(svn_config_get_int64(config, &log_components,
                                SVN_CONFIG_SECTION_GLOBAL,
@@ -318,6 +324,12 @@ load_config(svn_ra_serf__session_t *session,
                                       SVN_CONFIG_OPTION_HTTP_CHUNKED_REQUESTS,
                                       "auto", chunked_requests));
 
+      /* Load the group capability cache flag. */
+      SVN_ERR(svn_config_get_bool(config, &session->use_capability_cache,
+                                  server_group,
+                                  SVN_CONFIG_OPTION_HTTP_CAPABILITY_CACHE,
+                                  session->use_capability_cache));
+
 #if SERF_VERSION_AT_LEAST(1, 4, 0) && !defined(SVN_SERF_NO_LOGGING)
       SVN_ERR(svn_config_get_int64(config, &log_components,
                                    server_group,
@@ -489,6 +501,7 @@ svn_ra_serf__open(svn_ra_session_t *session,
   svn_ra_serf__session_t *serf_sess;
   apr_uri_t url;
   const char *client_string = NULL;
+  svn_boolean_t cache_hit = FALSE;
   svn_error_t *err;
 
   if (corrected_url)
@@ -601,15 +614,24 @@ svn_ra_serf__open(svn_ra_session_t *session,
      OPTIONS request. */
   serf_sess->conn_latency = -1;
 
-  err = svn_ra_serf__exchange_capabilities(serf_sess, corrected_url,
-                                           redirect_url,
-                                           result_pool, scratch_pool);
+  /* If enabled, a sufficiently fresh cached OPTIONS exchange for this
+     URL lets us skip the initial round trip altogether. */
+  if (serf_sess->use_capability_cache)
+    SVN_ERR(svn_ra_serf__options_cache_load(&cache_hit, serf_sess,
+                                            scratch_pool));
 
-  /* serf should produce a usable error code instead of APR_EGENERAL */
-  if (err && err->apr_err == APR_EGENERAL)
-    err = svn_error_createf(SVN_ERR_RA_DAV_REQUEST_FAILED, err,
-                            _("Connection to '%s' failed"), session_URL);
-  SVN_ERR(err);
+  if (!cache_hit)
+    {
+      err = svn_ra_serf__exchange_capabilities(serf_sess, corrected_url,
+                                               redirect_url,
+                                               result_pool, scratch_pool);
+
+      /* serf should produce a usable error code instead of APR_EGENERAL */
+      if (err && err->apr_err == APR_EGENERAL)
+        err = svn_error_createf(SVN_ERR_RA_DAV_REQUEST_FAILED, err,
+                                _("Connection to '%s' failed"), session_URL);
+      SVN_ERR(err);
+    }
 
   /* We have set up a useful connection (that doesn't indication a redirect).
      If we've been told there is possibly a worrisome proxy in our path to the
@@ -762,6 +784,7 @@ ra_serf_dup_session(svn_ra_session_t *new_session,
   /* supports_rev_rsrc_replay */
   /* supports_svndiff1 */
   /* supports_svndiff2 */
+  /* supports_svndiff3 */
   /* supports_put_result_checksum */
   /* conn_latency */
 
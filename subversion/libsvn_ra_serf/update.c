@@ -251,9 +251,14 @@ static const svn_ra_serf__xml_transition_t update_ttable[] = {
    can make the measurements quite imprecise.
 
    We measure outstanding requests as the sum of NUM_ACTIVE_FETCHES and
-   NUM_ACTIVE_PROPFINDS in the report_context_t structure.  */
-#define REQUEST_COUNT_TO_PAUSE 50
-#define REQUEST_COUNT_TO_RESUME 40
+   NUM_ACTIVE_PROPFINDS in the report_context_t structure.
+
+   The thresholds scale with the number of connections that have been
+   opened so far: a single shared window too small to fill even one
+   connection's bandwidth-delay product would leave high-latency links
+   idle, no matter how many connections we open.  */
+#define REQUEST_COUNT_TO_PAUSE_PER_CONN 50
+#define REQUEST_COUNT_TO_RESUME_PER_CONN 40
 
 #define SPILLBUF_BLOCKSIZE 4096
 #define SPILLBUF_MAXBUFFSIZE 131072
@@ -619,7 +624,7 @@ get_best_connection(report_context_t *ctx)
 #if SERF_VERSION_AT_LEAST(1, 4, 0)
       /* Often one connection is slower than others, e.g. because the server
          process/thread has to do more work for the particular set of requests.
-         In the worst case, when REQUEST_COUNT_TO_RESUME requests are queued
+         In the worst case, when all allowed requests are queued
          on such a slow connection, ra_serf will completely stop sending
          requests.
 
@@ -1013,7 +1018,11 @@ handle_fetch(serf_request_t *request,
       svn_txdelta_op_t delta_op;
       svn_string_t window_data;
 
-      status = serf_bucket_read(response, 8000, &data, &len);
+      /* Read the largest span the response bucket can hand us in one
+         call.  Over TLS, serf buffers at least a whole decrypted record
+         at a time, so capping the read at a few KB only multiplies the
+         number of iterations (and bucket reads) per delta. */
+      status = serf_bucket_read(response, SERF_READ_ALL_AVAIL, &data, &len);
       if (SERF_BUCKET_READ_ERROR(status))
         {
           return svn_ra_serf__wrap_err(status, NULL);
@@ -1238,16 +1247,22 @@ fetch_for_file(file_baton_t *file,
         }
 
       if (file->fetch_file
-          && file->final_sha1_checksum
+          && (file->final_sha1_checksum || file->final_md5_checksum)
           && ctx->sess->wc_callbacks->get_wc_contents)
         {
           svn_error_t *err;
           svn_stream_t *cached_contents = NULL;
+          /* Prefer the SHA-1 as that is what the pristine store is keyed
+             on; pre-1.7 servers only send the MD5, which the working copy
+             can still map to a pristine text. */
+          const svn_checksum_t *checksum = file->final_sha1_checksum
+                                             ? file->final_sha1_checksum
+                                             : file->final_md5_checksum;
 
           err = ctx->sess->wc_callbacks->get_wc_contents(
                                                 ctx->sess->wc_callback_baton,
                                                 &cached_contents,
-                                                file->final_sha1_checksum,
+                                                checksum,
                                                 scratch_pool);
 
           if (err || !cached_contents)
@@ -2251,7 +2266,7 @@ update_delay_handler(serf_request_t *request,
         }
 
       while ((udb->report->num_active_fetches + udb->report->num_active_propfinds)
-                 < REQUEST_COUNT_TO_RESUME)
+                 < REQUEST_COUNT_TO_RESUME_PER_CONN * udb->report->sess->num_conns)
         {
           const char *data;
           apr_size_t len;
@@ -2306,8 +2321,9 @@ update_delay_handler(serf_request_t *request,
       const char *data;
       apr_size_t len;
 
-      /* ### What blocksize should we pass? */
-      status = serf_bucket_read(response, 8*PARSE_CHUNK_SIZE, &data, &len);
+      /* Drain whatever the bucket has buffered in as few reads as
+         possible; the spill buffer chops it up as it sees fit. */
+      status = serf_bucket_read(response, SERF_READ_ALL_AVAIL, &data, &len);
 
       if (!SERF_BUCKET_READ_ERROR(status))
         SVN_ERR(svn_spillbuf__write(udb->spillbuf, data, len, scratch_pool));
@@ -2335,7 +2351,7 @@ process_pending(update_delay_baton_t *udb,
   serf_bucket_alloc_t *alloc = NULL;
 
   while ((udb->report->num_active_fetches + udb->report->num_active_propfinds)
-            < REQUEST_COUNT_TO_RESUME)
+            < REQUEST_COUNT_TO_RESUME_PER_CONN * udb->report->sess->num_conns)
     {
       const char *data;
       apr_size_t len;
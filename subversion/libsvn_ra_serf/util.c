@@ -45,6 +45,8 @@
 #include "private/svn_fspath.h"
 #include "private/svn_auth_private.h"
 #include "private/svn_cert.h"
+#include "private/svn_subr_private.h"
+#include "private/svn_trace.h"
 
 #include "ra_serf.h"
 
@@ -971,6 +973,7 @@ svn_ra_serf__context_run_wait(svn_boolean_t *done,
 {
   apr_pool_t *iterpool;
   apr_interval_time_t waittime_left = sess->timeout;
+  apr_time_t trace_start = svn_trace__start();
 
   assert(sess->pending_error == SVN_NO_ERROR);
 
@@ -991,6 +994,8 @@ svn_ra_serf__context_run_wait(svn_boolean_t *done,
     }
   svn_pool_destroy(iterpool);
 
+  svn_trace__record("ra_serf", "context-run-wait", trace_start);
+
   return SVN_NO_ERROR;
 }
 
@@ -2059,10 +2064,15 @@ svn_ra_serf__setup_svndiff_accept_encoding(serf_bucket_t *headers,
       /* With http-compression=auto, advertise that we prefer svndiff2
          to svndiff1 with a low latency connection (assuming the underlying
          network has high bandwidth), as it is faster and in this case, we
-         don't care about worse compression ratio. */
+         don't care about worse compression ratio.
+
+         If this build can decode zstd, prefer svndiff3 above both: it is
+         as fast as svndiff2 while compressing better than svndiff1. */
       serf_bucket_headers_setn(
         headers, "Accept-Encoding",
-        "gzip,svndiff2;q=0.9,svndiff1;q=0.8,svndiff;q=0.7");
+        svn__zstd_available()
+          ? "gzip,svndiff3;q=0.95,svndiff2;q=0.9,svndiff1;q=0.8,svndiff;q=0.7"
+          : "gzip,svndiff2;q=0.9,svndiff1;q=0.8,svndiff;q=0.7");
     }
   else
     {
@@ -2070,10 +2080,13 @@ svn_ra_serf__setup_svndiff_accept_encoding(serf_bucket_t *headers,
          svndiff2 is not a reasonable substitute for svndiff1 with default
          compression level, because, while it is faster, it also gives worse
          compression ratio.  While we can use svndiff2 in some cases (see
-         above), we can't do this generally. */
+         above), we can't do this generally.  Svndiff3, when available,
+         beats both and comes first. */
       serf_bucket_headers_setn(
         headers, "Accept-Encoding",
-        "gzip,svndiff1;q=0.9,svndiff2;q=0.8,svndiff;q=0.7");
+        svn__zstd_available()
+          ? "gzip,svndiff3;q=0.95,svndiff1;q=0.9,svndiff2;q=0.8,svndiff;q=0.7"
+          : "gzip,svndiff1;q=0.9,svndiff2;q=0.8,svndiff;q=0.7");
     }
 }
 
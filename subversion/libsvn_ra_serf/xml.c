@@ -42,10 +42,6 @@
 #include "ra_serf.h"
 
 
-/* Read/write chunks of this size into the spillbuf.  */
-#define PARSE_CHUNK_SIZE 8000
-
-
 struct svn_ra_serf__xml_context_t {
   /* Current state information.  */
   svn_ra_serf__xml_estate_t *current;
@@ -68,6 +64,15 @@ struct svn_ra_serf__xml_context_t {
   /* Linked list of free states.  */
   svn_ra_serf__xml_estate_t *free_states;
 
+  /* Linked list of closed states whose pools are merely cleared, ready
+     for reuse by the next element that needs to collect data.  */
+  svn_ra_serf__xml_estate_t *recycled_states;
+
+  /* The pool this context was allocated in.  Recyclable state objects
+     and their pools are allocated here, so that they can outlive the
+     elements they were first used for.  */
+  apr_pool_t *pool;
+
 #ifdef SVN_DEBUG
   /* Used to verify we are not re-entering a callback, specifically to
      ensure SCRATCH_POOL is not cleared while an outer callback is
@@ -113,6 +118,11 @@ struct svn_ra_serf__xml_estate_t {
   /* A pool may be constructed for this state.  */
   apr_pool_t *state_pool;
 
+  /* Is this state allocated in the context's pool, owning STATE_POOL?
+     If so, both will be recycled when the state is popped, instead of
+     being destroyed.  */
+  svn_boolean_t recyclable;
+
   /* The namespaces extent for this state/element. This will start with
      the parent's NS_LIST, and we will push new namespaces into our
      local list. The parent will be unaffected by our locally-scoped data. */
@@ -483,7 +493,7 @@ svn_ra_serf__xml_context_done(svn_ra_serf__xml_context_t *xmlctx)
                                _("XML stream truncated: closing '%s' missing"),
                                xmlctx->current->tag.name);
     }
-  else if (! xmlctx->free_states)
+  else if (! xmlctx->free_states && ! xmlctx->recycled_states)
     {
       /* If we have no items on the free_states list, we didn't push anything,
          which tells us that we found an empty xml body */
@@ -538,6 +548,7 @@ svn_ra_serf__xml_context_create(
   xmlctx->cdata_cb = cdata_cb;
   xmlctx->baton = baton;
   xmlctx->scratch_pool = svn_pool_create(result_pool);
+  xmlctx->pool = result_pool;
 
   xes = apr_pcalloc(result_pool, sizeof(*xes));
   /* XES->STATE == 0  */
@@ -692,20 +703,37 @@ xml_cb_start(svn_ra_serf__xml_context_t *xmlctx,
 
   /* ### todo. push state  */
 
-  /* ### how to use free states?  */
   /* This state should be allocated in the extent pool. If we will be
-     collecting information for this state, then construct a subpool.
-
-     ### potentially optimize away the subpool if none of the
-     ### attributes are present. subpools are cheap, tho...  */
-  new_pool = xes_pool(current);
+     collecting information for this state, then use a pool of its own,
+     which is recycled from state to state: high-volume reports open and
+     close such elements hundreds of thousands of times, so clearing an
+     existing pool is much cheaper than constructing a fresh one.  */
   if (scan->collect_cdata || scan->collect_attrs[0])
     {
-      new_pool = svn_pool_create(new_pool);
-
-      /* Prep the new state.  */
-      new_xes = apr_pcalloc(new_pool, sizeof(*new_xes));
-      new_xes->state_pool = new_pool;
+      if (xmlctx->recycled_states)
+        {
+          /* Reuse a state (and its already-cleared pool) that an earlier
+             element is done with.  */
+          new_xes = xmlctx->recycled_states;
+          xmlctx->recycled_states = new_xes->prev;
+          new_pool = new_xes->state_pool;
+
+          new_xes->attrs = NULL;
+          new_xes->cdata = NULL;
+        }
+      else
+        {
+          /* Allocate the state in the context's pool, so that it can be
+             recycled after this element closes.  Its data pool hangs off
+             the context's pool as well: the state stack guarantees that
+             inner states are done with their data before any outer state
+             releases its own.  */
+          new_pool = svn_pool_create(xmlctx->pool);
+
+          new_xes = apr_pcalloc(xmlctx->pool, sizeof(*new_xes));
+          new_xes->state_pool = new_pool;
+          new_xes->recyclable = TRUE;
+        }
 
       /* If we're supposed to collect cdata, then set up a buffer for
          this. The existence of this buffer will instruct our cdata
@@ -749,6 +777,7 @@ xml_cb_start(svn_ra_serf__xml_context_t *xmlctx,
   else
     {
       /* Prep the new state.  */
+      new_pool = xes_pool(current);
       new_xes = apr_pcalloc(new_pool, sizeof(*new_xes));
       /* STATE_POOL remains NULL.  */
     }
@@ -820,16 +849,28 @@ xml_cb_end(svn_ra_serf__xml_context_t *xmlctx,
   /* Pop the state.  */
   xmlctx->current = xes->prev;
 
-  /* ### not everything should go on the free state list. XES may go
-     ### away with the state pool.  */
-  xes->prev = xmlctx->free_states;
-  xmlctx->free_states = xes;
+  if (xes->recyclable)
+    {
+      /* This state owns its pool.  Clear it and keep both around for
+         the next element that needs to collect data.  */
+      svn_pool_clear(xes->state_pool);
 
-  /* If there is a STATE_POOL, then toss it. This will get rid of as much
-     memory as possible. Potentially the XES (if we didn't create a pool
-     right away, then XES may be in a parent pool).  */
-  if (xes->state_pool)
-    svn_pool_destroy(xes->state_pool);
+      xes->prev = xmlctx->recycled_states;
+      xmlctx->recycled_states = xes;
+    }
+  else
+    {
+      /* ### not everything should go on the free state list. XES may go
+         ### away with the state pool.  */
+      xes->prev = xmlctx->free_states;
+      xmlctx->free_states = xes;
+
+      /* If there is a STATE_POOL, then toss it. This will get rid of as
+         much memory as possible. Potentially the XES (if we didn't create
+         a pool right away, then XES may be in a parent pool).  */
+      if (xes->state_pool)
+        svn_pool_destroy(xes->state_pool);
+    }
 
   return SVN_NO_ERROR;
 }
@@ -980,7 +1021,10 @@ expat_response_handler(serf_request_t *request,
       apr_size_t len;
       svn_boolean_t at_eof = FALSE;
 
-      status = serf_bucket_read(response, PARSE_CHUNK_SIZE, &data, &len);
+      /* Feed Expat the largest span the bucket will give us per call;
+         smaller caps just mean more loop iterations for a large
+         buffered (e.g. TLS-decrypted) response. */
+      status = serf_bucket_read(response, SERF_READ_ALL_AVAIL, &data, &len);
       if (SERF_BUCKET_READ_ERROR(status))
         return svn_ra_serf__wrap_err(status, NULL);
       else if (APR_STATUS_IS_EOF(status))
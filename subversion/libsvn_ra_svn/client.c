@@ -184,6 +184,18 @@ static svn_error_t *make_connection(const char *hostname, unsigned short port,
       /* It's not a fatal error if we cannot enable keep-alives. */
     }
 
+  /* Disable Nagle's algorithm.  We buffer and coalesce outgoing data
+   * ourselves, so every segment we hand to the kernel should go onto
+   * the wire immediately; letting it sit there waiting for an ACK of
+   * the previous request only adds round-trips to the many small
+   * command/response exchanges of this protocol on high-latency
+   * links. */
+  status = apr_socket_opt_set(*sock, APR_TCP_NODELAY, 1);
+  if (status)
+    {
+      /* Not fatal either; we merely keep the default send behavior. */
+    }
+
   return SVN_NO_ERROR;
 }
 
@@ -746,12 +758,16 @@ static svn_error_t *open_session(svn_ra_svn__session_baton_t **sess_p,
   /* In protocol version 2, we send back our protocol version, our
    * capability list, and the URL, and subsequently there is an auth
    * request. */
-  /* Client-side capabilities list: */
-  SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "n(wwwwwww)cc(?c)",
+  /* Client-side capabilities list:
+   * (we can only accept svndiff3 if this build has zstd) */
+  SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "n(www?wwwww)cc(?c)",
                                   (apr_uint64_t) 2,
                                   SVN_RA_SVN_CAP_EDIT_PIPELINE,
                                   SVN_RA_SVN_CAP_SVNDIFF1,
                                   SVN_RA_SVN_CAP_SVNDIFF2_ACCEPTED,
+                                  svn__zstd_available()
+                                    ? SVN_RA_SVN_CAP_SVNDIFF3_ACCEPTED
+                                    : NULL,
                                   SVN_RA_SVN_CAP_ABSENT_ENTRIES,
                                   SVN_RA_SVN_CAP_DEPTH,
                                   SVN_RA_SVN_CAP_MERGEINFO,
@@ -178,6 +178,10 @@ static svn_error_t *ra_svn_target_rev(void *edit_baton, svn_revnum_t rev,
 {
   ra_svn_edit_baton_t *eb = edit_baton;
 
+  /* An edit drive is starting; batch the pipelined editor commands
+   * into large frames (no-op if the buffer is already big enough). */
+  SVN_ERR(svn_ra_svn__set_buffer_sizes(eb->conn, 0,
+                                       SVN_RA_SVN__EDIT_FRAME_SIZE, pool));
   SVN_ERR(check_for_error(eb, pool));
   SVN_ERR(svn_ra_svn__write_cmd_target_rev(eb->conn, pool, rev));
   return SVN_NO_ERROR;
@@ -189,6 +193,10 @@ static svn_error_t *ra_svn_open_root(void *edit_baton, svn_revnum_t rev,
   ra_svn_edit_baton_t *eb = edit_baton;
   svn_string_t *token = make_token('d', eb, pool);
 
+  /* Commit drives don't send target-rev, so this may be the first
+   * command of the edit; see ra_svn_target_rev. */
+  SVN_ERR(svn_ra_svn__set_buffer_sizes(eb->conn, 0,
+                                       SVN_RA_SVN__EDIT_FRAME_SIZE, pool));
   SVN_ERR(check_for_error(eb, pool));
   SVN_ERR(svn_ra_svn__write_cmd_open_root(eb->conn, pool, rev, token));
   *root_baton = ra_svn_make_baton(eb->conn, pool, eb, token);
@@ -1086,6 +1094,12 @@ svn_error_t *svn_ra_svn_drive_editor2(svn_ra_svn_conn_t *conn,
   SVN_ERR(svn_atomic__init_once(&cmd_hash_initialized, init_cmd_hash, NULL,
                                 pool));
 
+  /* The other side will pipeline the whole edit at us.  Decoding it from
+   * a few large frames instead of many small reads avoids stalls on
+   * high-latency links. */
+  SVN_ERR(svn_ra_svn__set_buffer_sizes(conn, SVN_RA_SVN__EDIT_FRAME_SIZE, 0,
+                                       pool));
+
   state.editor = editor;
   state.edit_baton = edit_baton;
   state.tokens = svn_hash__make(pool);
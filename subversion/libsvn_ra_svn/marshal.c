@@ -179,6 +179,27 @@ svn_ra_svn__to_private_array(const apr_array_header_t *source,
 
 /* --- CONNECTION INITIALIZATION --- */
 
+/* Point CONN's read and write buffers at a fresh, page-aligned memory
+ * block allocated in POOL, with READ_SIZE and WRITE_SIZE usable bytes,
+ * respectively.  Both sizes must be multiples of SVN_RA_SVN__PAGE_SIZE.
+ * The read / write positions are not touched. */
+static void
+alloc_buffers(svn_ra_svn_conn_t *conn,
+              apr_size_t read_size,
+              apr_size_t write_size,
+              apr_pool_t *pool)
+{
+  void *mem = apr_palloc(pool, read_size + write_size
+                               + SVN_RA_SVN__PAGE_SIZE);
+  char *aligned = (char *)APR_ALIGN((apr_uintptr_t)mem,
+                                    SVN_RA_SVN__PAGE_SIZE);
+
+  conn->read_buf = aligned;
+  conn->read_buf_size = read_size;
+  conn->write_buf = aligned + read_size;
+  conn->write_buf_size = write_size;
+}
+
 svn_ra_svn_conn_t *svn_ra_svn_create_conn5(apr_socket_t *sock,
                                            svn_stream_t *in_stream,
                                            svn_stream_t *out_stream,
@@ -189,9 +210,7 @@ svn_ra_svn_conn_t *svn_ra_svn_create_conn5(apr_socket_t *sock,
                                            apr_uint64_t max_out,
                                            apr_pool_t *result_pool)
 {
-  svn_ra_svn_conn_t *conn;
-  void *mem = apr_palloc(result_pool, sizeof(*conn) + SVN_RA_SVN__PAGE_SIZE);
-  conn = (void*)APR_ALIGN((apr_uintptr_t)mem, SVN_RA_SVN__PAGE_SIZE);
+  svn_ra_svn_conn_t *conn = apr_palloc(result_pool, sizeof(*conn));
 
   assert((sock && !in_stream && !out_stream)
          || (!sock && in_stream && out_stream));
@@ -200,6 +219,8 @@ svn_ra_svn_conn_t *svn_ra_svn_create_conn5(apr_socket_t *sock,
   conn->encrypted = FALSE;
 #endif
   conn->session = NULL;
+  alloc_buffers(conn, SVN_RA_SVN__READBUF_SIZE, SVN_RA_SVN__WRITEBUF_SIZE,
+                result_pool);
   conn->read_ptr = conn->read_buf;
   conn->read_end = conn->read_buf;
   conn->write_pos = 0;
@@ -210,6 +231,9 @@ svn_ra_svn_conn_t *svn_ra_svn_create_conn5(apr_socket_t *sock,
   conn->current_in = 0;
   conn->max_out = max_out;
   conn->current_out = 0;
+  conn->throttle_bps = 0;
+  conn->throttle_tokens = 0;
+  conn->throttle_timestamp = 0;
   conn->block_handler = NULL;
   conn->block_baton = NULL;
   conn->capabilities = apr_hash_make(result_pool);
@@ -273,6 +297,12 @@ svn_ra_svn__svndiff_version(svn_ra_svn_conn_t *conn)
   if (svn_ra_svn_compression_level(conn) <= 0)
     return 0;
 
+  /* Prefer SVNDIFF3 (zstd) when both sides support it; it combines a
+   * better compression ratio than SVNDIFF1 with SVNDIFF2-like speed. */
+  if (svn__zstd_available()
+      && svn_ra_svn_has_capability(conn, SVN_RA_SVN_CAP_SVNDIFF3_ACCEPTED))
+    return 3;
+
   /* Prefer SVNDIFF2 over SVNDIFF1. */
   if (svn_ra_svn_has_capability(conn, SVN_RA_SVN_CAP_SVNDIFF2_ACCEPTED))
     return 2;
@@ -363,29 +393,82 @@ check_io_limits(svn_ra_svn_conn_t *conn)
   return SVN_NO_ERROR;
 }
 
-/* Write data to socket or output file as appropriate. */
-static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
-                                    const char *data, apr_size_t len)
+void
+svn_ra_svn__set_bandwidth_limit(svn_ra_svn_conn_t *conn,
+                                apr_uint64_t bytes_per_sec)
 {
-  const char *end = data + len;
-  apr_size_t count;
+  conn->throttle_bps = bytes_per_sec;
+  conn->throttle_tokens = bytes_per_sec;
+  conn->throttle_timestamp = apr_time_now();
+}
+
+/* Delay the pending write of LEN bytes on CONN as long as necessary to
+ * keep the output rate within CONN->THROTTLE_BPS.  Standard token bucket:
+ * tokens accumulate at the configured rate up to one second's worth of
+ * burst, each write consumes tokens, and a write that finds the bucket
+ * short sleeps until the deficit has been earned back. */
+static void
+throttle_output(svn_ra_svn_conn_t *conn, apr_size_t len)
+{
+  apr_time_t now = apr_time_now();
+
+  if (now > conn->throttle_timestamp)
+    {
+      apr_uint64_t fill = (apr_uint64_t)(now - conn->throttle_timestamp)
+                          * conn->throttle_bps / APR_USEC_PER_SEC;
+
+      conn->throttle_tokens += fill;
+      if (conn->throttle_tokens > conn->throttle_bps)
+        conn->throttle_tokens = conn->throttle_bps;
+    }
+  conn->throttle_timestamp = now;
+
+  if (len > conn->throttle_tokens)
+    {
+      apr_uint64_t deficit = len - conn->throttle_tokens;
+
+      apr_sleep((apr_time_t)(deficit * APR_USEC_PER_SEC
+                             / conn->throttle_bps));
+      conn->throttle_tokens = 0;
+      conn->throttle_timestamp = apr_time_now();
+    }
+  else
+    {
+      conn->throttle_tokens -= len;
+    }
+}
+
+/* Write the NVEC data blocks in VEC to socket or output file as
+ * appropriate.  Socket output will put all blocks onto the wire with a
+ * single gather write, keeping them in the same TCP segment(s).
+ * VEC is modified as the data gets written. */
+static svn_error_t *writebuf_output_vec(svn_ra_svn_conn_t *conn,
+                                        apr_pool_t *pool,
+                                        struct iovec *vec, apr_size_t nvec)
+{
+  apr_size_t len = 0;
+  apr_size_t i, count;
   apr_pool_t *subpool = NULL;
   svn_ra_svn__session_baton_t *session = conn->session;
 
+  for (i = 0; i < nvec; ++i)
+    len += vec[i].iov_len;
+
   /* Limit the size of the response, if a limit has been configured.
    * This is to limit the server load in case users e.g. accidentally ran
    * an export on the root folder. */
   conn->current_out += len;
   SVN_ERR(check_io_limits(conn));
 
-  while (data < end)
-    {
-      count = end - data;
+  if (conn->throttle_bps)
+    throttle_output(conn, len);
 
+  while (nvec > 0)
+    {
       if (session && session->callbacks && session->callbacks->cancel_func)
         SVN_ERR((session->callbacks->cancel_func)(session->callbacks_baton));
 
-      SVN_ERR(svn_ra_svn__stream_write(conn->stream, data, &count));
+      SVN_ERR(svn_ra_svn__stream_writev(conn->stream, vec, nvec, &count));
       if (count == 0)
         {
           if (!subpool)
@@ -394,7 +477,6 @@ static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
             svn_pool_clear(subpool);
           SVN_ERR(conn->block_handler(conn, subpool, conn->block_baton));
         }
-      data += count;
 
       if (session)
         {
@@ -405,6 +487,19 @@ static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
             (cb->progress_func)(session->bytes_written + session->bytes_read,
                                 -1, cb->progress_baton, subpool);
         }
+
+      /* Advance the vector past the data that just got written. */
+      while (nvec > 0 && count >= vec[0].iov_len)
+        {
+          count -= vec[0].iov_len;
+          ++vec;
+          --nvec;
+        }
+      if (nvec > 0 && count > 0)
+        {
+          vec[0].iov_base = (char *)vec[0].iov_base + count;
+          vec[0].iov_len -= count;
+        }
     }
 
   conn->written_since_error_check += len;
@@ -416,6 +511,17 @@ static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   return SVN_NO_ERROR;
 }
 
+/* Write data to socket or output file as appropriate. */
+static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
+                                    const char *data, apr_size_t len)
+{
+  struct iovec vec;
+  vec.iov_base = (void *)data;
+  vec.iov_len = len;
+
+  return svn_error_trace(writebuf_output_vec(conn, pool, &vec, 1));
+}
+
 /* Write data from the write buffer out to the socket. */
 static svn_error_t *writebuf_flush(svn_ra_svn_conn_t *conn, apr_pool_t *pool)
 {
@@ -430,17 +536,32 @@ static svn_error_t *writebuf_flush(svn_ra_svn_conn_t *conn, apr_pool_t *pool)
 static svn_error_t *writebuf_write(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
                                    const char *data, apr_size_t len)
 {
-  /* data >= 8k is sent immediately */
-  if (len >= sizeof(conn->write_buf) / 2)
+  /* data of at least half the buffer size is sent immediately */
+  if (len >= conn->write_buf_size / 2)
     {
       if (conn->write_pos > 0)
-        SVN_ERR(writebuf_flush(conn, pool));
+        {
+          /* Send the buffered data and the new block with a single
+           * gather write instead of flushing the buffer first.  That
+           * way, e.g. the header of a large string ends up in the same
+           * TCP segment as (the beginning of) the string contents. */
+          struct iovec vec[2];
+          vec[0].iov_base = conn->write_buf;
+          vec[0].iov_len = conn->write_pos;
+          vec[1].iov_base = (void *)data;
+          vec[1].iov_len = len;
+
+          /* Clear conn->write_pos first in case the block handler
+           * does a read. */
+          conn->write_pos = 0;
+          return writebuf_output_vec(conn, pool, vec, 2);
+        }
 
       return writebuf_output(conn, pool, data, len);
     }
 
   /* ensure room for the data to add */
-  if (conn->write_pos + len > sizeof(conn->write_buf))
+  if (conn->write_pos + len > conn->write_buf_size)
     SVN_ERR(writebuf_flush(conn, pool));
 
   /* buffer the new data block as well */
@@ -461,7 +582,7 @@ static svn_error_t *writebuf_write(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
 static APR_INLINE svn_error_t *
 writebuf_writechar(svn_ra_svn_conn_t *conn, apr_pool_t *pool, char data)
 {
-  if (conn->write_pos < sizeof(conn->write_buf))
+  if (conn->write_pos < conn->write_buf_size)
   {
     conn->write_buf[conn->write_pos] = data;
     conn->write_pos++;
@@ -475,6 +596,49 @@ writebuf_writechar(svn_ra_svn_conn_t *conn, apr_pool_t *pool, char data)
   }
 }
 
+svn_error_t *
+svn_ra_svn__set_buffer_sizes(svn_ra_svn_conn_t *conn,
+                             apr_size_t read_size,
+                             apr_size_t write_size,
+                             apr_pool_t *scratch_pool)
+{
+  apr_size_t unread;
+  char *old_read_ptr;
+
+  /* Round up to full pages.  Never shrink a buffer; that also makes
+   * 0 mean "leave this buffer unchanged". */
+  read_size = APR_ALIGN(read_size, SVN_RA_SVN__PAGE_SIZE);
+  write_size = APR_ALIGN(write_size, SVN_RA_SVN__PAGE_SIZE);
+  if (read_size < conn->read_buf_size)
+    read_size = conn->read_buf_size;
+  if (write_size < conn->write_buf_size)
+    write_size = conn->write_buf_size;
+
+  /* Nothing to grow?  Then don't waste memory on new buffers.
+   * This is the common case as we get called at the beginning of every
+   * editor drive over a long-lived connection. */
+  if (   read_size == conn->read_buf_size
+      && write_size == conn->write_buf_size)
+    return SVN_NO_ERROR;
+
+  /* Pending outgoing data lives in the old write buffer; get it onto
+   * the wire before we switch buffers. */
+  if (conn->write_pos)
+    SVN_ERR(writebuf_flush(conn, scratch_pool));
+
+  /* Unread incoming data must be carried over into the new read buffer.
+   * It always fits because we never shrink. */
+  unread = conn->read_end - conn->read_ptr;
+  old_read_ptr = conn->read_ptr;
+  alloc_buffers(conn, read_size, write_size, conn->pool);
+  if (unread)
+    memcpy(conn->read_buf, old_read_ptr, unread);
+  conn->read_ptr = conn->read_buf;
+  conn->read_end = conn->read_buf + unread;
+
+  return SVN_NO_ERROR;
+}
+
 /* --- READ BUFFER MANAGEMENT --- */
 
 /* Read bytes into DATA until either the read buffer is empty or
@@ -535,7 +699,7 @@ static svn_error_t *readbuf_skip(svn_ra_svn_conn_t *conn, apr_uint64_t len)
     if (len == 0)
       break;
 
-    buflen = sizeof(conn->read_buf);
+    buflen = conn->read_buf_size;
     SVN_ERR(svn_ra_svn__stream_read(conn->stream, conn->read_buf, &buflen));
     if (buflen == 0)
       return svn_error_create(SVN_ERR_RA_SVN_CONNECTION_CLOSED, NULL, NULL);
@@ -561,7 +725,7 @@ static svn_error_t *readbuf_fill(svn_ra_svn_conn_t *conn, apr_pool_t *pool)
     SVN_ERR(writebuf_flush(conn, pool));
 
   /* Fill (some of the) buffer. */
-  len = sizeof(conn->read_buf);
+  len = conn->read_buf_size;
   SVN_ERR(readbuf_input(conn, conn->read_buf, &len, pool));
   conn->read_ptr = conn->read_buf;
   conn->read_end = conn->read_buf + len;
@@ -602,7 +766,7 @@ static svn_error_t *readbuf_read(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   data = readbuf_drain(conn, data, end);
 
   /* Read large chunks directly into buffer. */
-  while (end - data > (apr_ssize_t)sizeof(conn->read_buf))
+  while (end - data > (apr_ssize_t)conn->read_buf_size)
     {
       SVN_ERR(writebuf_flush(conn, pool));
       count = end - data;
@@ -624,7 +788,7 @@ static svn_error_t *readbuf_read(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
 static svn_error_t *readbuf_skip_leading_garbage(svn_ra_svn_conn_t *conn,
                                                  apr_pool_t *pool)
 {
-  char buf[256];  /* Must be smaller than sizeof(conn->read_buf) - 1. */
+  char buf[256];  /* Must be smaller than the read buffer size - 1. */
   const char *p, *end;
   apr_size_t len;
   svn_boolean_t lparen = FALSE;
@@ -668,7 +832,7 @@ static svn_error_t *write_number(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
 
   /* SVN_INT64_BUFFER_SIZE includes space for a terminating NUL that
    * svn__ui64toa will always append. */
-  if (conn->write_pos + SVN_INT64_BUFFER_SIZE >= sizeof(conn->write_buf))
+  if (conn->write_pos + SVN_INT64_BUFFER_SIZE >= conn->write_buf_size)
     SVN_ERR(writebuf_flush(conn, pool));
 
   written = svn__ui64toa(conn->write_buf + conn->write_pos, number);
@@ -728,7 +892,7 @@ svn_ra_svn__write_ncstring(svn_ra_svn_conn_t *conn,
 {
   /* Apart from LEN bytes of string contents, we need room for a number,
      a colon and a space. */
-  apr_size_t max_fill = sizeof(conn->write_buf) - SVN_INT64_BUFFER_SIZE - 2;
+  apr_size_t max_fill = conn->write_buf_size - SVN_INT64_BUFFER_SIZE - 2;
 
   /* In most cases, there is enough left room in the WRITE_BUF
      the we can serialize directly into it.  On platforms with
@@ -830,7 +994,7 @@ svn_error_t *
 svn_ra_svn__start_list(svn_ra_svn_conn_t *conn,
                        apr_pool_t *pool)
 {
-  if (conn->write_pos + 2 <= sizeof(conn->write_buf))
+  if (conn->write_pos + 2 <= conn->write_buf_size)
     {
       conn->write_buf[conn->write_pos] = '(';
       conn->write_buf[conn->write_pos+1] = ' ';
@@ -845,7 +1009,7 @@ svn_error_t *
 svn_ra_svn__end_list(svn_ra_svn_conn_t *conn,
                      apr_pool_t *pool)
 {
-  if (conn->write_pos + 2 <= sizeof(conn->write_buf))
+  if (conn->write_pos + 2 <= conn->write_buf_size)
   {
     conn->write_buf[conn->write_pos] = ')';
     conn->write_buf[conn->write_pos+1] = ' ';
@@ -990,7 +1154,7 @@ write_tuple_string_opt_list(svn_ra_svn_conn_t *conn,
 
   /* If this how far we can fill the WRITE_BUF with string data and still
      guarantee that the length info will fit in as well. */
-  max_fill = sizeof(conn->write_buf)
+  max_fill = conn->write_buf_size
            - 2                       /* open list */
            - SVN_INT64_BUFFER_SIZE   /* string length + separator */
            - 2;                      /* close list */
@@ -2845,7 +3009,7 @@ svn_ra_svn__write_data_log_changed_path(svn_ra_svn_conn_t *conn,
   apr_size_t flags_len = flags_str->len;
 
   /* How much buffer space can we use for non-string data (worst case)? */
-  apr_size_t max_fill = sizeof(conn->write_buf)
+  apr_size_t max_fill = conn->write_buf_size
                       - 2                          /* list start */
                       - 2 - SVN_INT64_BUFFER_SIZE  /* path */
                       - 2                          /* action */
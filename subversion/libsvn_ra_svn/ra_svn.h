@@ -62,11 +62,18 @@ typedef svn_error_t *(*ra_svn_block_handler_t)(svn_ra_svn_conn_t *conn,
 #define SVN_RA_SVN__DEFAULT_USERAGENT  "SVN/" SVN_VER_NUMBER\
                                        " (" SVN_BUILD_TARGET ")"
 
-/* The size of our per-connection read and write buffers. */
+/* The initial size of our per-connection read and write buffers. */
 #define SVN_RA_SVN__PAGE_SIZE 4096
 #define SVN_RA_SVN__READBUF_SIZE (4 * SVN_RA_SVN__PAGE_SIZE)
 #define SVN_RA_SVN__WRITEBUF_SIZE (4 * SVN_RA_SVN__PAGE_SIZE)
 
+/* The buffer size we switch to while marshalling an editor drive.
+ * Editor commands are pipelined without intermediate responses, so
+ * coalescing them into frames of this size before hitting the network
+ * keeps high-latency links busy instead of stalling on many small
+ * transfers.  Must be a multiple of SVN_RA_SVN__PAGE_SIZE. */
+#define SVN_RA_SVN__EDIT_FRAME_SIZE (256 * SVN_RA_SVN__PAGE_SIZE)
+
 /* Create forward reference */
 typedef struct svn_ra_svn__session_baton_t svn_ra_svn__session_baton_t;
 
@@ -74,9 +81,13 @@ typedef struct svn_ra_svn__session_baton_t svn_ra_svn__session_baton_t;
  * first few fields during setup and cleanup. */
 struct svn_ra_svn_conn_st {
 
-  /* I/O buffers */
-  char write_buf[SVN_RA_SVN__WRITEBUF_SIZE];
-  char read_buf[SVN_RA_SVN__READBUF_SIZE];
+  /* I/O buffers.  Page-aligned; allocated at connection creation time
+   * with the default sizes above.  svn_ra_svn__set_buffer_sizes() may
+   * replace them with larger ones later on. */
+  char *write_buf;
+  char *read_buf;
+  apr_size_t write_buf_size;
+  apr_size_t read_buf_size;
   char *read_ptr;
   char *read_end;
   apr_size_t write_pos;
@@ -102,6 +113,15 @@ struct svn_ra_svn_conn_st {
   apr_uint64_t max_out;
   apr_uint64_t current_out;
 
+  /* Output bandwidth throttle, implemented as a token bucket.
+   * THROTTLE_BPS is the maximum sustained send rate in bytes per second
+   * with up to one second's worth of burst; 0 disables throttling.
+   * THROTTLE_TOKENS is the number of bytes that may be sent without
+   * delay; tokens were last replenished at THROTTLE_TIMESTAMP. */
+  apr_uint64_t throttle_bps;
+  apr_uint64_t throttle_tokens;
+  apr_time_t throttle_timestamp;
+
   /* repository info */
   const char *uuid;
   const char *repos_root;
@@ -171,6 +191,18 @@ void svn_ra_svn__set_block_handler(svn_ra_svn_conn_t *conn,
                                    ra_svn_block_handler_t callback,
                                    void *baton);
 
+/* Grow the read and write buffers of CONN to at least READ_SIZE and
+ * WRITE_SIZE bytes, respectively.  The sizes are lower bounds: they get
+ * rounded up to full pages, buffers are never shrunk, and passing 0
+ * leaves the respective buffer unchanged.  Any pending outgoing data is
+ * flushed before the write buffer is replaced; unread incoming data is
+ * carried over.  Use SCRATCH_POOL for temporary allocations.
+ */
+svn_error_t *svn_ra_svn__set_buffer_sizes(svn_ra_svn_conn_t *conn,
+                                          apr_size_t read_size,
+                                          apr_size_t write_size,
+                                          apr_pool_t *scratch_pool);
+
 /* Return true if there is input waiting on conn. */
 svn_error_t *svn_ra_svn__data_available(svn_ra_svn_conn_t *conn,
                                        svn_boolean_t *data_available);
@@ -222,6 +254,16 @@ svn_ra_svn__stream_t *svn_ra_svn__stream_create(svn_stream_t *in_stream,
 svn_error_t *svn_ra_svn__stream_write(svn_ra_svn__stream_t *stream,
                                       const char *data, apr_size_t *len);
 
+/* Write data from the NVEC blocks in VEC to STREAM, returning the total
+ * number of bytes written in *LEN.  Socket-backed streams put all blocks
+ * onto the wire with a single gather write; other stream types may write
+ * less, possibly only (part of) the first block.
+ */
+svn_error_t *svn_ra_svn__stream_writev(svn_ra_svn__stream_t *stream,
+                                       struct iovec *vec,
+                                       apr_size_t nvec,
+                                       apr_size_t *len);
+
 /* Read *LEN bytes from STREAM into DATA, returning the number of bytes
  * read in *LEN.
  */
@@ -42,6 +42,10 @@ struct svn_ra_svn__stream_st {
   svn_stream_t *out_stream;
   void *timeout_baton;
   ra_svn_timeout_fn_t timeout_fn;
+
+  /* The socket behind OUT_STREAM, if the output side writes to a plain
+     socket; NULL otherwise.  Enables vectored (gather) output. */
+  apr_socket_t *out_sock;
 };
 
 typedef struct sock_baton_t {
@@ -167,6 +171,7 @@ svn_ra_svn__stream_from_sock(apr_socket_t *sock,
 {
   sock_baton_t *b = apr_palloc(result_pool, sizeof(*b));
   svn_stream_t *sock_stream;
+  svn_ra_svn__stream_t *s;
 
   b->sock = sock;
   b->pool = svn_pool_create(result_pool);
@@ -177,8 +182,11 @@ svn_ra_svn__stream_from_sock(apr_socket_t *sock,
   svn_stream_set_write(sock_stream, sock_write_cb);
   svn_stream_set_data_available(sock_stream, sock_pending_cb);
 
-  return svn_ra_svn__stream_create(sock_stream, sock_stream,
-                                   b, sock_timeout_cb, result_pool);
+  s = svn_ra_svn__stream_create(sock_stream, sock_stream,
+                                b, sock_timeout_cb, result_pool);
+  s->out_sock = sock;
+
+  return s;
 }
 
 svn_ra_svn__stream_t *
@@ -193,6 +201,7 @@ svn_ra_svn__stream_create(svn_stream_t *in_stream,
   s->out_stream = out_stream;
   s->timeout_baton = timeout_baton;
   s->timeout_fn = timeout_cb;
+  s->out_sock = NULL;
   return s;
 }
 
@@ -203,6 +212,29 @@ svn_ra_svn__stream_write(svn_ra_svn__stream_t *stream,
   return svn_error_trace(svn_stream_write(stream->out_stream, data, len));
 }
 
+svn_error_t *
+svn_ra_svn__stream_writev(svn_ra_svn__stream_t *stream,
+                          struct iovec *vec,
+                          apr_size_t nvec,
+                          apr_size_t *len)
+{
+  if (stream->out_sock)
+    {
+      apr_status_t status = apr_socket_sendv(stream->out_sock, vec,
+                                             (apr_int32_t)nvec, len);
+      if (status)
+        return svn_error_wrap_apr(status, _("Can't write to connection"));
+      return SVN_NO_ERROR;
+    }
+
+  /* The output side does not support gather writes, e.g. it is a tunnel
+     or SASL-encrypted.  Make a single write attempt on the first block;
+     the caller will advance the vector by the number of bytes written. */
+  *len = vec[0].iov_len;
+  return svn_error_trace(svn_stream_write(stream->out_stream,
+                                          vec[0].iov_base, len));
+}
+
 svn_error_t *
 svn_ra_svn__stream_read(svn_ra_svn__stream_t *stream, char *data,
                         apr_size_t *len)
@@ -31,12 +31,14 @@
 #include "svn_pools.h"
 #include "svn_error.h"
 #include "svn_dirent_uri.h"
+#include "svn_io.h"
 #include "svn_path.h"
 #include "svn_repos.h"
 #include "svn_config.h"
 #include "svn_ctype.h"
 #include "private/svn_atomic.h"
 #include "private/svn_fspath.h"
+#include "private/svn_mutex.h"
 #include "private/svn_repos_private.h"
 #include "private/svn_sorts_private.h"
 #include "private/svn_subr_private.h"
@@ -130,6 +132,24 @@ static svn_object_pool__t *authz_pool = NULL;
 static svn_object_pool__t *filtered_pool = NULL;
 static svn_atomic_t authz_pool_initialized = FALSE;
 
+/* A stat()-validated entry in the authz path index.  As long as the
+ * file's mtime and size are unchanged, we may assume its content still
+ * matches CHECKSUM and serve the parsed model from AUTHZ_POOL without
+ * re-reading the file. */
+typedef struct authz_file_info_t
+{
+  svn_checksum_t *checksum;
+  apr_time_t mtime;
+  svn_filesize_t size;
+} authz_file_info_t;
+
+/* Maps (const char *) local authz / groups file path to the
+ * (authz_file_info_t *) recorded when that file was last read.
+ * Instantiated together with the object pools above. */
+static apr_hash_t *authz_path_index = NULL;
+static svn_mutex__t *authz_path_index_mutex = NULL;
+static apr_pool_t *authz_path_index_pool = NULL;
+
 /*
  * Ensure that we will initialize authz again if the pool which
  * our authz caches depend on is cleared.
@@ -150,6 +170,9 @@ deinit_authz(void *data)
   /* The two object pools run their own cleanup handlers. */
   authz_pool = NULL;
   filtered_pool = NULL;
+  authz_path_index = NULL;
+  authz_path_index_mutex = NULL;
+  authz_path_index_pool = NULL;
   authz_pool_initialized = FALSE;
   return APR_SUCCESS;
 }
@@ -167,6 +190,10 @@ synchronized_authz_initialize(void *baton, apr_pool_t *pool)
   SVN_ERR(svn_object_pool__create(&authz_pool, multi_threaded, pool));
   SVN_ERR(svn_object_pool__create(&filtered_pool, multi_threaded, pool));
 
+  authz_path_index = apr_hash_make(pool);
+  SVN_ERR(svn_mutex__init(&authz_path_index_mutex, multi_threaded, pool));
+  authz_path_index_pool = pool;
+
   apr_pool_cleanup_register(pool, NULL, deinit_authz, apr_pool_cleanup_null);
   return SVN_NO_ERROR;
 }
@@ -180,6 +207,68 @@ svn_repos_authz_initialize(apr_pool_t *pool)
                                                NULL, pool));
 }
 
+/* The amount by which an authz file's mtime must predate the time of its
+ * indexing for the index entry to be usable.  Modifications within that
+ * window may not be reflected in the mtime due to timestamp granularity,
+ * so such files must be re-read and re-checksummed every time.
+ */
+#define FILE_INFO_TRUST_WINDOW apr_time_from_sec(1)
+
+/* If the authz path index has an entry for PATH that matches FINFO,
+ * return the content checksum recorded there in *CHECKSUM, allocated in
+ * RESULT_POOL.  Return NULL otherwise.
+ *
+ * Must be called with AUTHZ_PATH_INDEX_MUTEX held.
+ */
+static svn_error_t *
+path_index_lookup(svn_checksum_t **checksum,
+                  const char *path,
+                  const apr_finfo_t *finfo,
+                  apr_pool_t *result_pool)
+{
+  const authz_file_info_t *info = svn_hash_gets(authz_path_index, path);
+
+  if (info && info->mtime == finfo->mtime && info->size == finfo->size)
+    *checksum = svn_checksum_dup(info->checksum, result_pool);
+  else
+    *checksum = NULL;
+
+  return SVN_NO_ERROR;
+}
+
+/* Record in the authz path index that PATH with the stat data in FINFO
+ * has the content checksum CHECKSUM.  Files whose mtime is too recent
+ * to be trusted are not recorded.
+ *
+ * Must be called with AUTHZ_PATH_INDEX_MUTEX held.
+ */
+static svn_error_t *
+path_index_update(const char *path,
+                  const apr_finfo_t *finfo,
+                  const svn_checksum_t *checksum)
+{
+  authz_file_info_t *info;
+
+  if (apr_time_now() - finfo->mtime < FILE_INFO_TRUST_WINDOW)
+    return SVN_NO_ERROR;
+
+  /* Reuse the old entry where possible; path index entries cannot be
+   * freed as long as the index itself is in use. */
+  info = svn_hash_gets(authz_path_index, path);
+  if (!info)
+    {
+      info = apr_pcalloc(authz_path_index_pool, sizeof(*info));
+      svn_hash_sets(authz_path_index,
+                    apr_pstrdup(authz_path_index_pool, path), info);
+    }
+
+  info->checksum = svn_checksum_dup(checksum, authz_path_index_pool);
+  info->mtime = finfo->mtime;
+  info->size = finfo->size;
+
+  return SVN_NO_ERROR;
+}
+
 /* Return a combination of AUTHZ_KEY and GROUPS_KEY, allocated in RESULT_POOL.
  * GROUPS_KEY may be NULL.  This is the key for the AUTHZ_POOL.
  */
@@ -240,6 +329,263 @@ construct_filtered_key(const char *repos_name,
 }
 
 
+/*** Precompiled glob patterns. ***/
+
+/* The kinds of elements a compiled glob pattern consists of. */
+typedef enum glob_op_t
+{
+  /* Match the literal string in TEXT. */
+  glob_op_literal,
+
+  /* Match exactly one arbitrary character. */
+  glob_op_any_char,
+
+  /* Match one character for which the bit in BITMAP is set. */
+  glob_op_class,
+
+  /* Match any number (including zero) of arbitrary characters. */
+  glob_op_star
+} glob_op_t;
+
+/* A single element of a compiled glob pattern. */
+typedef struct glob_token_t
+{
+  glob_op_t op;
+
+  /* For GLOB_OP_LITERAL: the text to match. */
+  svn_string_t text;
+
+  /* For GLOB_OP_CLASS: 256-bit character membership map. */
+  const unsigned char *bitmap;
+} glob_token_t;
+
+/* A glob pattern, compiled into a token sequence for quick matching. */
+typedef struct glob_pattern_t
+{
+  glob_token_t *tokens;
+  int count;
+} glob_pattern_t;
+
+/* Try to compile the fnmatch-style PATTERN into *COMPILED, allocated in
+ * RESULT_POOL.  Set *COMPILED to NULL for constructs that we don't support
+ * (e.g. malformed bracket expressions); the caller shall then fall back
+ * to apr_fnmatch().  Escaping and case-sensitivity follow apr_fnmatch()
+ * with FLAGS 0, i.e. backslash quotes the next character.
+ */
+static void
+compile_glob(glob_pattern_t **compiled,
+             const svn_string_t *pattern,
+             apr_pool_t *result_pool)
+{
+  apr_array_header_t *tokens = apr_array_make(result_pool, 4,
+                                              sizeof(glob_token_t));
+  svn_stringbuf_t *literal = svn_stringbuf_create_empty(result_pool);
+  const char *p = pattern->data;
+  glob_pattern_t *result;
+
+  *compiled = NULL;
+
+  while (*p)
+    {
+      glob_token_t token = { glob_op_literal };
+
+      switch (*p)
+        {
+        case '?':
+          token.op = glob_op_any_char;
+          ++p;
+          break;
+
+        case '*':
+          token.op = glob_op_star;
+          while (*p == '*')          /* Consecutive stars collapse. */
+            ++p;
+          break;
+
+        case '[':
+          {
+            unsigned char *bitmap = apr_pcalloc(result_pool, 256 / 8);
+            svn_boolean_t negate = FALSE;
+            svn_boolean_t first = TRUE;
+
+            ++p;
+            if (*p == '!' || *p == '^')
+              {
+                negate = TRUE;
+                ++p;
+              }
+
+            /* A ']' right at the start is a literal class member. */
+            while (*p != ']' || first)
+              {
+                unsigned char c = (unsigned char)*p;
+
+                if (c == '\0')
+                  return;            /* Unterminated class. */
+                if (c == '\\')
+                  {
+                    c = (unsigned char)*++p;
+                    if (c == '\0')
+                      return;
+                  }
+
+                if (p[1] == '-' && p[2] != ']' && p[2] != '\0')
+                  {
+                    /* Character range.  Keep the compiler simple and punt
+                     * on escapes within ranges. */
+                    unsigned char hi = (unsigned char)p[2];
+                    unsigned char i;
+
+                    if (hi == '\\')
+                      return;
+                    if (c > hi)
+                      return;        /* Inverted range. */
+                    for (i = c; i <= hi && i > 0; ++i)
+                      bitmap[i / 8] |= 1 << (i % 8);
+                    p += 3;
+                  }
+                else
+                  {
+                    bitmap[c / 8] |= 1 << (c % 8);
+                    ++p;
+                  }
+
+                first = FALSE;
+              }
+            ++p;                     /* Skip the closing ']'. */
+
+            if (negate)
+              {
+                int i;
+                for (i = 0; i < 256 / 8; ++i)
+                  bitmap[i] = (unsigned char)~bitmap[i];
+
+                /* NUL terminates the segment and never matches. */
+                bitmap[0] &= (unsigned char)~1;
+              }
+
+            token.op = glob_op_class;
+            token.bitmap = bitmap;
+          }
+          break;
+
+        default:
+          {
+            /* Gather a run of literal characters. */
+            svn_stringbuf_setempty(literal);
+            while (*p && *p != '?' && *p != '*' && *p != '[')
+              {
+                char c = *p;
+
+                if (c == '\\')
+                  {
+                    c = *++p;
+                    if (c == '\0')
+                      return;        /* Trailing escape. */
+                  }
+                svn_stringbuf_appendbyte(literal, c);
+                ++p;
+              }
+
+            token.text.data = apr_pstrmemdup(result_pool, literal->data,
+                                             literal->len);
+            token.text.len = literal->len;
+          }
+        }
+
+      APR_ARRAY_PUSH(tokens, glob_token_t) = token;
+    }
+
+  result = apr_pcalloc(result_pool, sizeof(*result));
+  result->tokens = (glob_token_t *)tokens->elts;
+  result->count = tokens->nelts;
+
+  *compiled = result;
+}
+
+/* Return whether the LEN bytes at STR match the compiled GLOB.
+ * Uses the classic greedy wildcard algorithm: tokens following a star are
+ * re-tried at ever later positions until the remainder of the pattern
+ * matches the remainder of the string.
+ */
+static svn_boolean_t
+match_glob(const glob_pattern_t *glob,
+           const char *str,
+           apr_size_t len)
+{
+  int ti = 0;
+  apr_size_t si = 0;
+  int star_ti = -1;              /* Last star seen, or -1. */
+  apr_size_t star_si = 0;        /* Restart position for that star. */
+
+  while (TRUE)
+    {
+      if (ti < glob->count)
+        {
+          const glob_token_t *token = &glob->tokens[ti];
+          svn_boolean_t matched = FALSE;
+
+          switch (token->op)
+            {
+            case glob_op_star:
+              star_ti = ti;
+              star_si = si;
+              ++ti;
+              continue;
+
+            case glob_op_literal:
+              if (   si + token->text.len <= len
+                  && memcmp(str + si, token->text.data,
+                            token->text.len) == 0)
+                {
+                  si += token->text.len;
+                  matched = TRUE;
+                }
+              break;
+
+            case glob_op_any_char:
+              if (si < len)
+                {
+                  ++si;
+                  matched = TRUE;
+                }
+              break;
+
+            case glob_op_class:
+              if (si < len)
+                {
+                  unsigned char c = (unsigned char)str[si];
+                  if (token->bitmap[c / 8] & (1 << (c % 8)))
+                    {
+                      ++si;
+                      matched = TRUE;
+                    }
+                }
+              break;
+            }
+
+          if (matched)
+            {
+              ++ti;
+              continue;
+            }
+        }
+      else if (si == len)
+        {
+          return TRUE;             /* Whole string consumed. */
+        }
+
+      /* Mismatch.  Let the last star swallow one more character. */
+      if (star_ti < 0 || star_si >= len)
+        return FALSE;
+
+      ++star_si;
+      si = star_si;
+      ti = star_ti + 1;
+    }
+}
+
+
 /*** Constructing the prefix tree. ***/
 
 /* Since prefix arrays may have more than one hit, we need to link them
@@ -305,6 +651,11 @@ typedef struct node_t
 
   /* If not NULL, this contains the pattern-based segment sub-nodes. */
   node_pattern_t *pattern_sub_nodes;
+
+  /* For nodes in the "complex" pattern category: the compiled form of
+   * SEGMENT, or NULL to fall back to apr_fnmatch().  Always NULL for
+   * other nodes. */
+  glob_pattern_t *compiled;
 } node_t;
 
 /* Create a new tree node for SEGMENT.
@@ -510,6 +861,11 @@ insert_path(construction_context_t *ctx,
     case authz_rule_fnmatch:
       sub_node = ensure_node_in_array(&node->pattern_sub_nodes->complex,
                                       segment, result_pool);
+
+      /* Compile the pattern once per authz load instead of having
+       * apr_fnmatch() re-interpret it upon every lookup. */
+      if (!sub_node->compiled)
+        compile_glob(&sub_node->compiled, &sub_node->segment, result_pool);
       break;
 
       /* Then it must be a literal. */
@@ -1210,7 +1566,14 @@ add_complex_matches(lookup_state_t *state,
   for (i = 0; i < patterns->nelts; ++i)
     {
       node_t *node = APR_ARRAY_IDX(patterns, i, sorted_pattern_t).node;
-      if (0 == apr_fnmatch(node->segment.data, segment->data, 0))
+      svn_boolean_t matches;
+
+      if (node->compiled)
+        matches = match_glob(node->compiled, segment->data, segment->len);
+      else
+        matches = (0 == apr_fnmatch(node->segment.data, segment->data, 0));
+
+      if (matches)
         add_next_node(state, node);
     }
 }
@@ -1471,6 +1834,12 @@ matches_filtered_tree(const authz_user_rules_t *authz,
   return strcmp(repos_name, authz->repository) == 0;
 }
 
+/* Upper limit to the number of per-user entries kept in the USER_RULES
+ * cache of a single svn_authz_t.  Filtered trees beyond this limit are
+ * still available through the global FILTERED_POOL, so exceeding it only
+ * costs the per-object bookkeeping to be rebuilt. */
+#define MAX_USER_RULES 16
+
 /* Check if AUTHZ's already contains a path rule tree filtered for this
  * USER, REPOS_NAME combination.  If that does not exist, yet, create one
  * but don't construct the actual filtered tree, yet.
@@ -1481,17 +1850,45 @@ get_user_rules(svn_authz_t *authz,
                const char *user)
 {
   apr_pool_t *pool;
+  int i;
 
-  /* Search our cache for a suitable previously filtered tree. */
-  if (authz->filtered)
+  /* Most checks are repeats for the user-repository combination of the
+   * previous one. */
+  if (   authz->filtered
+      && matches_filtered_tree(authz->filtered, repos_name, user))
+    return authz->filtered;
+
+  /* Search our cache for a suitable previously filtered tree.  Keeping
+   * all of them around (instead of only the latest) matters for servers
+   * that alternate between users within the same authz object, e.g.
+   * anonymous and authenticated access in mod_authz_svn. */
+  if (authz->user_rules)
+    {
+      for (i = 0; i < authz->user_rules->nelts; ++i)
+        {
+          authz_user_rules_t *rules
+            = APR_ARRAY_IDX(authz->user_rules, i, authz_user_rules_t *);
+          if (matches_filtered_tree(rules, repos_name, user))
+            {
+              authz->filtered = rules;
+              return rules;
+            }
+        }
+    }
+  else
     {
-      /* Is this a suitable filtered tree? */
-      if (matches_filtered_tree(authz->filtered, repos_name, user))
-        return authz->filtered;
+      authz->user_rules = apr_array_make(authz->pool, 4,
+                                         sizeof(authz_user_rules_t *));
+    }
 
-      /* Drop the old filtered tree before creating a new one. */
-      svn_pool_destroy(authz->filtered->pool);
-      authz->filtered = NULL;
+  /* Keep the cache from growing indefinitely for pathological usage
+   * patterns with many different users per authz object. */
+  if (authz->user_rules->nelts >= MAX_USER_RULES)
+    {
+      for (i = 0; i < authz->user_rules->nelts; ++i)
+        svn_pool_destroy(APR_ARRAY_IDX(authz->user_rules, i,
+                                       authz_user_rules_t *)->pool);
+      apr_array_clear(authz->user_rules);
     }
 
   /* Global cache lookup.  Filter the full model only if necessary. */
@@ -1508,6 +1905,8 @@ get_user_rules(svn_authz_t *authz,
   svn_authz__get_global_rights(&authz->filtered->global_rights,
                                authz->full, user, repos_name);
 
+  APR_ARRAY_PUSH(authz->user_rules, authz_user_rules_t *) = authz->filtered;
+
   return authz->filtered;
 }
 
@@ -1602,9 +2001,67 @@ authz_read(authz_full_t **authz_p,
   svn_stream_t *groups_stream = NULL;
   svn_checksum_t *rules_checksum = NULL;
   svn_checksum_t *groups_checksum = NULL;
+  apr_finfo_t rules_finfo;
+  apr_finfo_t groups_finfo;
+  svn_boolean_t have_rules_finfo = FALSE;
+  svn_boolean_t have_groups_finfo = FALSE;
+
+  config_access_t *config_access;
+
+  /* If we read and checksummed these files before and their stat data is
+     unchanged, we may serve the parsed model straight from AUTHZ_POOL,
+     without re-reading and re-checksumming the files.  This matters for
+     servers that load the authz configuration on every connection. */
+  if (authz_pool && !svn_path_is_url(path))
+    {
+      err = svn_io_stat(&rules_finfo, path,
+                        APR_FINFO_MTIME | APR_FINFO_SIZE, scratch_pool);
+      if (err)
+        svn_error_clear(err);
+      else
+        have_rules_finfo = TRUE;
+
+      if (groups_path && !svn_path_is_url(groups_path))
+        {
+          err = svn_io_stat(&groups_finfo, groups_path,
+                            APR_FINFO_MTIME | APR_FINFO_SIZE, scratch_pool);
+          if (err)
+            svn_error_clear(err);
+          else
+            have_groups_finfo = TRUE;
+        }
 
-  config_access_t *config_access =
-    svn_repos__create_config_access(repos_hint, scratch_pool);
+      err = SVN_NO_ERROR;
+
+      if (have_rules_finfo && (!groups_path || have_groups_finfo))
+        {
+          SVN_MUTEX__WITH_LOCK(authz_path_index_mutex,
+                               path_index_lookup(&rules_checksum, path,
+                                                 &rules_finfo, scratch_pool));
+          if (groups_path && rules_checksum)
+            SVN_MUTEX__WITH_LOCK(authz_path_index_mutex,
+                                 path_index_lookup(&groups_checksum,
+                                                   groups_path, &groups_finfo,
+                                                   scratch_pool));
+
+          if (rules_checksum && (!groups_path || groups_checksum))
+            {
+              *authz_id = construct_authz_key(rules_checksum, groups_checksum,
+                                              result_pool);
+              SVN_ERR(svn_object_pool__lookup((void **)authz_p, authz_pool,
+                                              *authz_id, result_pool));
+              if (*authz_p)
+                return SVN_NO_ERROR;
+            }
+
+          /* Not in the cache (or stale); take the regular read path and
+           * let it compute the checksums from the actual contents. */
+          rules_checksum = NULL;
+          groups_checksum = NULL;
+        }
+    }
+
+  config_access = svn_repos__create_config_access(repos_hint, scratch_pool);
 
   /* Open the main authz file */
   SVN_ERR(svn_repos__get_config(&rules_stream, &rules_checksum, config_access,
@@ -1665,6 +2122,20 @@ authz_read(authz_full_t **authz_p,
           "Error while parsing authz file: '%s':", path);
     }
 
+  /* Remember the stat data for the contents we just processed, so the
+   * next read can skip straight to the cache lookup. */
+  if (!err && authz_pool)
+    {
+      if (have_rules_finfo)
+        SVN_MUTEX__WITH_LOCK(authz_path_index_mutex,
+                             path_index_update(path, &rules_finfo,
+                                               rules_checksum));
+      if (have_groups_finfo)
+        SVN_MUTEX__WITH_LOCK(authz_path_index_mutex,
+                             path_index_update(groups_path, &groups_finfo,
+                                               groups_checksum));
+    }
+
   svn_repos__destroy_config_access(config_access);
 
   return err;
@@ -1718,6 +2189,31 @@ svn_repos_authz_parse2(svn_authz_t **authz_p,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_repos_authz__get_global_access(svn_boolean_t *access_granted,
+                                   svn_authz_t *authz,
+                                   const char *repos_name,
+                                   const char *user,
+                                   svn_repos_authz_access_t required_access)
+{
+  const authz_access_t required =
+    ((required_access & svn_authz_read ? authz_access_read_flag : 0)
+     | (required_access & svn_authz_write ? authz_access_write_flag : 0));
+
+  /* Pick or create the suitable pre-filtered path rule tree. */
+  authz_user_rules_t *rules = get_user_rules(
+      authz,
+      (repos_name ? repos_name : AUTHZ_ANY_REPOSITORY),
+      user);
+
+  /* The minimal access rights over the whole tree are a by-product of
+   * the rule filtering, so no path rule tree walk is needed here. */
+  *access_granted
+    = ((rules->global_rights.min_access & required) == required);
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_repos_authz_check_access(svn_authz_t *authz, const char *repos_name,
                              const char *path, const char *user,
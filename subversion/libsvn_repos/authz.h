@@ -168,10 +168,16 @@ struct svn_authz_t
    * (a hash value that can be used for e.g. cache lookups). */
   svn_membuf_t *authz_id;
 
-  /* Rules filtered for a particular user-repository combination.
-   * May be NULL. */
+  /* Most recently used entry of USER_RULES, i.e. the rules filtered for
+   * the user-repository combination of the last check.  May be NULL. */
   authz_user_rules_t *filtered;
 
+  /* All user-repository combinations that rules have been filtered for
+   * within this authz object, as authz_user_rules_t *.  Entries are
+   * kept (rather than rebuilt) when the user changes between checks.
+   * NULL until the first use. */
+  apr_array_header_t *user_rules;
+
   /* The pool from which all the parsed authz data is allocated.
      This is the RESULT_POOL passed to svn_authz__tng_parse.
 
@@ -1311,6 +1311,19 @@ complete_cb(void *baton,
      Other errors may have occurred within the FS (specified by the
      POST_COMMIT_ERR localvar), but we need to run the hooks.  */
   SVN_ERR_ASSERT(SVN_IS_VALID_REVNUM(revision));
+
+  /* Notify in-process subscribers before starting the post-commit hook
+     script. */
+  err = svn_repos__notify_commit_subscribers(eb->repos, revision,
+                                             scratch_pool);
+  if (err)
+    {
+      err = svn_error_create(SVN_ERR_REPOS_POST_COMMIT_HOOK_FAILED, err,
+                             _("Commit succeeded, but commit notification "
+                               "failed"));
+      post_commit_err = svn_error_compose_create(post_commit_err, err);
+    }
+
   err = svn_repos__hooks_post_commit(eb->repos, hooks_env, revision,
                                      eb->txn_name, scratch_pool);
   if (err)
@@ -25,9 +25,12 @@
 
 
 #include "svn_checksum.h"
+#include "svn_hash.h"
+#include "svn_io.h"
 #include "svn_path.h"
 #include "svn_pools.h"
 
+#include "private/svn_mutex.h"
 #include "private/svn_subr_private.h"
 #include "private/svn_repos_private.h"
 
@@ -35,6 +38,33 @@
 
 #include "config_file.h"
 
+
+/* A stat()-validated entry in the per-path index of a config pool.
+ * As long as the file's mtime and size are unchanged, we may assume its
+ * content still matches CHECKSUM and serve the parsed configuration from
+ * the object pool without re-reading the file.
+ */
+typedef struct config_file_info_t
+{
+  svn_checksum_t *checksum;
+  apr_time_t mtime;
+  svn_filesize_t size;
+} config_file_info_t;
+
+struct svn_repos__config_pool_t
+{
+  /* Parsed, read-only configurations, keyed by content checksum. */
+  svn_object_pool__t *object_pool;
+
+  /* Maps (const char *) path to (config_file_info_t *).
+   * Both the hash and its contents are allocated in POOL.
+   * Protected by MUTEX. */
+  apr_hash_t *path_index;
+  svn_mutex__t *mutex;
+
+  apr_pool_t *pool;
+};
+
 
 /* Return a memory buffer structure allocated in POOL and containing the
  * data from CHECKSUM.
@@ -70,8 +100,8 @@ find_config(svn_config_t **cfg,
 {
   /* First, attempt the cache lookup. */
   svn_membuf_t *key = checksum_as_key(checksum, scratch_pool);
-  SVN_ERR(svn_object_pool__lookup((void **)cfg, config_pool, key,
-                                  result_pool));
+  SVN_ERR(svn_object_pool__lookup((void **)cfg, config_pool->object_pool,
+                                  key, result_pool));
 
   /* Not found? => parse and cache */
   if (!*cfg)
@@ -79,20 +109,87 @@ find_config(svn_config_t **cfg,
       svn_config_t *config;
 
       /* create a pool for the new config object and parse the data into it */
-      apr_pool_t *cfg_pool = svn_object_pool__new_item_pool(config_pool);
+      apr_pool_t *cfg_pool
+        = svn_object_pool__new_item_pool(config_pool->object_pool);
       SVN_ERR(svn_config_parse(&config, stream, FALSE, FALSE, cfg_pool));
 
       /* switch config data to r/o mode to guarantee thread-safe access */
       svn_config__set_read_only(config, cfg_pool);
 
       /* add config in pool, handle loads races and return the right config */
-      SVN_ERR(svn_object_pool__insert((void **)cfg, config_pool, key,
+      SVN_ERR(svn_object_pool__insert((void **)cfg,
+                                      config_pool->object_pool, key,
                                       config, cfg_pool, result_pool));
     }
 
   return SVN_NO_ERROR;
 }
 
+/* The amount by which a config file's mtime must predate the time of its
+ * indexing for the index entry to be usable.  Modifications within that
+ * window may not be reflected in the mtime due to timestamp granularity,
+ * so such files must be re-read and re-checksummed every time.
+ */
+#define FILE_INFO_TRUST_WINDOW apr_time_from_sec(1)
+
+/* If CONFIG_POOL's path index has an entry for PATH that matches FINFO,
+ * return the content checksum recorded there in *CHECKSUM, allocated in
+ * RESULT_POOL.  Return NULL otherwise.
+ *
+ * Must be called with CONFIG_POOL->MUTEX held.
+ */
+static svn_error_t *
+path_index_lookup(svn_checksum_t **checksum,
+                  svn_repos__config_pool_t *config_pool,
+                  const char *path,
+                  const apr_finfo_t *finfo,
+                  apr_pool_t *result_pool)
+{
+  const config_file_info_t *info
+    = svn_hash_gets(config_pool->path_index, path);
+
+  if (info && info->mtime == finfo->mtime && info->size == finfo->size)
+    *checksum = svn_checksum_dup(info->checksum, result_pool);
+  else
+    *checksum = NULL;
+
+  return SVN_NO_ERROR;
+}
+
+/* Record in CONFIG_POOL's path index that PATH with the stat data in
+ * FINFO has the content checksum CHECKSUM.  Files whose mtime is too
+ * recent to be trusted are not recorded.
+ *
+ * Must be called with CONFIG_POOL->MUTEX held.
+ */
+static svn_error_t *
+path_index_update(svn_repos__config_pool_t *config_pool,
+                  const char *path,
+                  const apr_finfo_t *finfo,
+                  const svn_checksum_t *checksum)
+{
+  config_file_info_t *info;
+
+  if (apr_time_now() - finfo->mtime < FILE_INFO_TRUST_WINDOW)
+    return SVN_NO_ERROR;
+
+  /* Reuse the old entry where possible; path index entries cannot be
+   * freed as long as the pool itself is in use. */
+  info = svn_hash_gets(config_pool->path_index, path);
+  if (!info)
+    {
+      info = apr_pcalloc(config_pool->pool, sizeof(*info));
+      svn_hash_sets(config_pool->path_index,
+                    apr_pstrdup(config_pool->pool, path), info);
+    }
+
+  info->checksum = svn_checksum_dup(checksum, config_pool->pool);
+  info->mtime = finfo->mtime;
+  info->size = finfo->size;
+
+  return SVN_NO_ERROR;
+}
+
 /* API implementation */
 
 svn_error_t *
@@ -100,8 +197,16 @@ svn_repos__config_pool_create(svn_repos__config_pool_t **config_pool,
                               svn_boolean_t thread_safe,
                               apr_pool_t *pool)
 {
-  return svn_error_trace(svn_object_pool__create(config_pool,
-                                                 thread_safe, pool));
+  svn_repos__config_pool_t *result = apr_pcalloc(pool, sizeof(*result));
+
+  SVN_ERR(svn_object_pool__create(&result->object_pool, thread_safe, pool));
+  result->path_index = apr_hash_make(pool);
+  SVN_ERR(svn_mutex__init(&result->mutex, thread_safe, pool));
+  result->pool = pool;
+
+  *config_pool = result;
+
+  return SVN_NO_ERROR;
 }
 
 svn_error_t *
@@ -118,15 +223,56 @@ svn_repos__config_pool_get(svn_config_t **cfg,
                                                             scratch_pool);
   svn_stream_t *stream;
   svn_checksum_t *checksum;
+  apr_finfo_t finfo;
+  svn_boolean_t have_finfo = FALSE;
 
   *cfg = NULL;
-  err = svn_repos__get_config(&stream, &checksum, access, path, must_exist,
-                              scratch_pool);
-  if (!err)
-    err = svn_error_quick_wrapf(find_config(cfg, config_pool, stream,
-                                            checksum, pool, scratch_pool),
-                                "Error while parsing config file: '%s':",
-                                path);
+
+  /* If we read and checksummed this file before and its stat data is
+     unchanged, we may serve the parsed configuration straight from the
+     object pool, without re-reading the file. */
+  if (!svn_path_is_url(path))
+    {
+      err = svn_io_stat(&finfo, path, APR_FINFO_MTIME | APR_FINFO_SIZE,
+                        scratch_pool);
+      if (err)
+        svn_error_clear(err);
+      else
+        {
+          svn_checksum_t *cached_checksum;
+
+          have_finfo = TRUE;
+          SVN_MUTEX__WITH_LOCK(config_pool->mutex,
+                               path_index_lookup(&cached_checksum,
+                                                 config_pool, path, &finfo,
+                                                 scratch_pool));
+          if (cached_checksum)
+            SVN_ERR(svn_object_pool__lookup((void **)cfg,
+                                            config_pool->object_pool,
+                                            checksum_as_key(cached_checksum,
+                                                            scratch_pool),
+                                            pool));
+        }
+
+      err = SVN_NO_ERROR;
+    }
+
+  if (!*cfg)
+    err = svn_repos__get_config(&stream, &checksum, access, path, must_exist,
+                                scratch_pool);
+  if (!err && !*cfg)
+    {
+      err = svn_error_quick_wrapf(find_config(cfg, config_pool, stream,
+                                              checksum, pool, scratch_pool),
+                                  "Error while parsing config file: '%s':",
+                                  path);
+
+      /* Remember the stat data for the content we just processed. */
+      if (!err && have_finfo)
+        SVN_MUTEX__WITH_LOCK(config_pool->mutex,
+                             path_index_update(config_pool, path, &finfo,
+                                               checksum));
+    }
 
   /* Let the standard implementation handle all the difficult cases.
    * Note that for in-repo configs, there are no further special cases to
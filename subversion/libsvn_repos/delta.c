@@ -22,6 +22,8 @@
  */
 
 
+#include <string.h>
+
 #include <apr_hash.h>
 
 #include "svn_hash.h"
@@ -33,7 +35,10 @@
 #include "svn_repos.h"
 #include "svn_pools.h"
 #include "svn_props.h"
+#include "svn_sorts.h"
 #include "svn_private_config.h"
+#include "private/svn_sorts_private.h"
+#include "private/svn_task.h"
 #include "repos.h"
 
 
@@ -61,6 +66,11 @@ struct context {
   svn_boolean_t text_deltas;
   svn_boolean_t entry_props;
   svn_boolean_t ignore_ancestry;
+
+  /* Maps 'const char *' target path to the compare_dir for that
+     directory, or NULL if no change manifest has been built for this
+     traversal.  See the compare phase below. */
+  apr_hash_t *change_manifest;
 };
 
 
@@ -196,6 +206,403 @@ authz_root_check(svn_fs_root_t *root,
 }
 
 
+/* The parallel compare phase.
+
+   Finding out *what* changed between two trees - loading directories
+   and comparing node ids - is read-only work on immutable revision
+   data, while actually driving the editor must remain strictly
+   sequential.  When the preconditions below are met, we therefore run
+   the tree comparison up front with a pool of worker threads, recording
+   the decisions in a "change manifest", and let the subsequent serial
+   editor drive replay the manifest instead of repeating the FS reads.
+
+   Filesystem objects must not be shared between threads, so every
+   worker opens private svn_fs_t instances for the source and target and
+   re-derives the two revision roots from them.  Consequently, this only
+   works when both roots are revision roots; transaction roots (and
+   depth-limited drives, which are cheap anyway) fall back to the
+   classic single-pass traversal.  Authorization and property/text
+   comparisons are not part of the manifest - they happen during the
+   serial drive, exactly as before.  */
+
+/* Number of worker threads used for the compare phase. */
+#define DIR_DELTA_COMPARE_THREADS 4
+
+/* What the editor drive shall do for one directory entry. */
+enum compare_action
+{
+  /* Entry exists in the target only: add it. */
+  compare_action_add,
+
+  /* Entries are related: replace the source with the target. */
+  compare_action_replace,
+
+  /* Entries are of different kinds or unrelated: delete, then add. */
+  compare_action_delete_add,
+
+  /* Entry exists in the source only: delete it. */
+  compare_action_delete
+};
+
+/* One changed entry of a directory.  Unchanged entries are not
+   recorded. */
+struct compare_entry
+{
+  /* Entry name within the directory. */
+  const char *name;
+
+  /* What to do about it. */
+  enum compare_action action;
+
+  /* Node kind in the target tree; undefined for pure deletions. */
+  svn_node_kind_t tgt_kind;
+};
+
+/* The manifest entry for one directory, keyed by its target path. */
+struct compare_dir
+{
+  /* Target path of the directory; this is also the manifest key. */
+  const char *target_path;
+
+  /* The matching source path, or NULL if this directory is being
+     added. */
+  const char *source_path;
+
+  /* The changed entries as 'struct compare_entry *', in lexical order
+     with deletions last - mirroring the order of the classic
+     traversal. */
+  apr_array_header_t *entries;
+};
+
+/* Everything the compare tasks share.  Lives in the caller's pool for
+   the duration of svn_task__run(). */
+struct compare_phase_baton
+{
+  /* On-disk locations of the two filesystems. */
+  const char *src_fs_path;
+  const char *tgt_fs_path;
+
+  /* Configurations to re-open them with. */
+  apr_hash_t *src_fs_config;
+  apr_hash_t *tgt_fs_config;
+
+  /* The two revisions being compared. */
+  svn_revnum_t src_rev;
+  svn_revnum_t tgt_rev;
+
+  /* Same as the respective flag of the main traversal. */
+  svn_boolean_t ignore_ancestry;
+};
+
+/* Per-worker-thread context: private FS instances and roots. */
+struct compare_context
+{
+  svn_fs_root_t *source_root;
+  svn_fs_root_t *target_root;
+};
+
+/* Baton for compare_process(), describing one directory pair. */
+struct compare_baton
+{
+  /* The shared parameters. */
+  struct compare_phase_baton *phase;
+
+  /* Source path of the directory, or NULL if it is being added. */
+  const char *source_path;
+
+  /* Target path of the directory. */
+  const char *target_path;
+};
+
+/* Implements svn_task__thread_context_constructor_t.  Open private
+   filesystem instances for the worker thread. */
+static svn_error_t *
+compare_context_construct(void **thread_context,
+                          void *context_baton,
+                          apr_pool_t *result_pool,
+                          apr_pool_t *scratch_pool)
+{
+  struct compare_phase_baton *pb = context_baton;
+  struct compare_context *context = apr_pcalloc(result_pool,
+                                                sizeof(*context));
+  svn_fs_t *fs;
+
+  SVN_ERR(svn_fs_open2(&fs, pb->src_fs_path, pb->src_fs_config,
+                       result_pool, scratch_pool));
+  SVN_ERR(svn_fs_revision_root(&context->source_root, fs, pb->src_rev,
+                               result_pool));
+
+  SVN_ERR(svn_fs_open2(&fs, pb->tgt_fs_path, pb->tgt_fs_config,
+                       result_pool, scratch_pool));
+  SVN_ERR(svn_fs_revision_root(&context->target_root, fs, pb->tgt_rev,
+                               result_pool));
+
+  *thread_context = context;
+
+  return SVN_NO_ERROR;
+}
+
+/* Append an entry with the given NAME, ACTION and TGT_KIND to the
+   directory comparison result DIR, allocated in RESULT_POOL. */
+static void
+compare_add_entry(struct compare_dir *dir,
+                  const char *name,
+                  enum compare_action action,
+                  svn_node_kind_t tgt_kind,
+                  apr_pool_t *result_pool)
+{
+  struct compare_entry *entry = apr_pcalloc(result_pool, sizeof(*entry));
+
+  entry->name = apr_pstrdup(result_pool, name);
+  entry->action = action;
+  entry->tgt_kind = tgt_kind;
+  APR_ARRAY_PUSH(dir->entries, struct compare_entry *) = entry;
+}
+
+/* Add a sub-task of TASK comparing the directory pair given by
+   SOURCE_PATH (may be NULL) and TARGET_PATH, sharing the parameters of
+   the current compare_baton PB. */
+static svn_error_t *
+compare_add_subtask(svn_task__t *task,
+                    struct compare_baton *pb,
+                    const char *source_path,
+                    const char *target_path)
+{
+  apr_pool_t *process_pool = svn_task__create_process_pool(task);
+  struct compare_baton *child = apr_pcalloc(process_pool, sizeof(*child));
+
+  child->phase = pb->phase;
+  child->source_path = source_path
+                     ? apr_pstrdup(process_pool, source_path)
+                     : NULL;
+  child->target_path = apr_pstrdup(process_pool, target_path);
+
+  return svn_error_trace(svn_task__add_similar(task, process_pool, NULL,
+                                               child));
+}
+
+/* Implements svn_task__process_func_t.  Compare the directory pair
+   described by the compare_baton in PROCESS_BATON, return the decisions
+   as intermediate result and add one sub-task for every sub-directory
+   that needs further comparison. */
+static svn_error_t *
+compare_process(void **result,
+                svn_task__t *task,
+                void *thread_context,
+                void *process_baton,
+                svn_cancel_func_t cancel_func,
+                void *cancel_baton,
+                apr_pool_t *result_pool,
+                apr_pool_t *scratch_pool)
+{
+  struct compare_baton *pb = process_baton;
+  struct compare_context *context = thread_context;
+  struct compare_dir *dir;
+  apr_hash_t *s_entries = NULL, *t_entries;
+  apr_array_header_t *sorted;
+  int i;
+
+  if (cancel_func)
+    SVN_ERR(cancel_func(cancel_baton));
+
+  SVN_ERR(svn_fs_dir_entries(&t_entries, context->target_root,
+                             pb->target_path, scratch_pool));
+  if (pb->source_path)
+    SVN_ERR(svn_fs_dir_entries(&s_entries, context->source_root,
+                               pb->source_path, scratch_pool));
+
+  dir = apr_pcalloc(result_pool, sizeof(*dir));
+  dir->target_path = apr_pstrdup(result_pool, pb->target_path);
+  dir->source_path = pb->source_path
+                   ? apr_pstrdup(result_pool, pb->source_path)
+                   : NULL;
+  dir->entries = apr_array_make(result_pool, apr_hash_count(t_entries),
+                                sizeof(struct compare_entry *));
+
+  /* Make the same decisions that the classic traversal in delta_dirs()
+     makes, in a stable order. */
+  sorted = svn_sort__hash(t_entries, svn_sort_compare_items_lexically,
+                          scratch_pool);
+  for (i = 0; i < sorted->nelts; i++)
+    {
+      const svn_sort__item_t *item = &APR_ARRAY_IDX(sorted, i,
+                                                    svn_sort__item_t);
+      const svn_fs_dirent_t *t_entry = item->value;
+      const svn_fs_dirent_t *s_entry
+        = s_entries ? apr_hash_get(s_entries, item->key, item->klen) : NULL;
+      svn_boolean_t recurse = FALSE;
+      const char *s_fullpath = NULL;
+
+      if (s_entry)
+        {
+          int distance = svn_fs_compare_ids(s_entry->id, t_entry->id);
+
+          if (distance == 0)
+            {
+              /* No change; don't record anything. */
+            }
+          else if ((s_entry->kind != t_entry->kind)
+                   || ((distance == -1) && (! pb->phase->ignore_ancestry)))
+            {
+              compare_add_entry(dir, t_entry->name,
+                                compare_action_delete_add, t_entry->kind,
+                                result_pool);
+              recurse = (t_entry->kind == svn_node_dir);
+            }
+          else
+            {
+              compare_add_entry(dir, t_entry->name, compare_action_replace,
+                                t_entry->kind, result_pool);
+              recurse = (t_entry->kind == svn_node_dir);
+              s_fullpath = svn_relpath_join(pb->source_path, t_entry->name,
+                                            scratch_pool);
+            }
+
+          apr_hash_set(s_entries, item->key, item->klen, NULL);
+        }
+      else
+        {
+          compare_add_entry(dir, t_entry->name, compare_action_add,
+                            t_entry->kind, result_pool);
+          recurse = (t_entry->kind == svn_node_dir);
+        }
+
+      if (recurse)
+        SVN_ERR(compare_add_subtask(task, pb, s_fullpath,
+                                    svn_relpath_join(pb->target_path,
+                                                     t_entry->name,
+                                                     scratch_pool)));
+    }
+
+  /* Whatever remains in the source entries needs to be deleted. */
+  if (s_entries && apr_hash_count(s_entries))
+    {
+      sorted = svn_sort__hash(s_entries, svn_sort_compare_items_lexically,
+                              scratch_pool);
+      for (i = 0; i < sorted->nelts; i++)
+        {
+          const svn_sort__item_t *item = &APR_ARRAY_IDX(sorted, i,
+                                                        svn_sort__item_t);
+          const svn_fs_dirent_t *s_entry = item->value;
+
+          compare_add_entry(dir, s_entry->name, compare_action_delete,
+                            svn_node_unknown, result_pool);
+        }
+    }
+
+  *result = dir;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__output_func_t.  Add the RESULT of one compare
+   task to the manifest hash given by OUTPUT_BATON. */
+static svn_error_t *
+compare_output(svn_task__t *task,
+               void *result,
+               void *output_baton,
+               svn_cancel_func_t cancel_func,
+               void *cancel_baton,
+               apr_pool_t *result_pool,
+               apr_pool_t *scratch_pool)
+{
+  apr_hash_t *manifest = output_baton;
+  apr_pool_t *manifest_pool = apr_hash_pool_get(manifest);
+  struct compare_dir *r = result;
+  struct compare_dir *dir = apr_pcalloc(manifest_pool, sizeof(*dir));
+  int i;
+
+  /* The intermediate result may be reclaimed after this call returns;
+     copy it into the manifest pool. */
+  dir->target_path = apr_pstrdup(manifest_pool, r->target_path);
+  dir->source_path = r->source_path
+                   ? apr_pstrdup(manifest_pool, r->source_path)
+                   : NULL;
+  dir->entries = apr_array_make(manifest_pool, r->entries->nelts,
+                                sizeof(struct compare_entry *));
+  for (i = 0; i < r->entries->nelts; i++)
+    {
+      const struct compare_entry *entry
+        = APR_ARRAY_IDX(r->entries, i, struct compare_entry *);
+      struct compare_entry *copy = apr_pcalloc(manifest_pool, sizeof(*copy));
+
+      copy->name = apr_pstrdup(manifest_pool, entry->name);
+      copy->action = entry->action;
+      copy->tgt_kind = entry->tgt_kind;
+      APR_ARRAY_PUSH(dir->entries, struct compare_entry *) = copy;
+    }
+
+  svn_hash_sets(manifest, dir->target_path, dir);
+
+  return SVN_NO_ERROR;
+}
+
+/* Set *MANIFEST to a change manifest for turning SOURCE_PATH in
+   SRC_ROOT into TARGET_PATH in TGT_ROOT, built with a pool of worker
+   threads, or to NULL if the preconditions for the parallel compare
+   phase are not met.  IGNORE_ANCESTRY is the corresponding flag of the
+   main traversal.  Allocate the manifest in RESULT_POOL and use
+   SCRATCH_POOL for temporaries. */
+static svn_error_t *
+build_change_manifest(apr_hash_t **manifest,
+                      svn_fs_root_t *src_root,
+                      const char *source_path,
+                      svn_fs_root_t *tgt_root,
+                      const char *target_path,
+                      svn_boolean_t ignore_ancestry,
+                      apr_pool_t *result_pool,
+                      apr_pool_t *scratch_pool)
+{
+#if APR_HAS_THREADS
+  struct compare_phase_baton phase;
+  struct compare_baton pb;
+  svn_error_t *err;
+
+  *manifest = NULL;
+
+  /* Workers re-open the filesystems by path, so only revision roots can
+     be re-derived on their side. */
+  if (!svn_fs_is_revision_root(src_root)
+      || !svn_fs_is_revision_root(tgt_root))
+    return SVN_NO_ERROR;
+
+  phase.src_fs_path = svn_fs_path(svn_fs_root_fs(src_root), scratch_pool);
+  phase.tgt_fs_path = svn_fs_path(svn_fs_root_fs(tgt_root), scratch_pool);
+  phase.src_fs_config = svn_fs_config(svn_fs_root_fs(src_root),
+                                      scratch_pool);
+  phase.tgt_fs_config = svn_fs_config(svn_fs_root_fs(tgt_root),
+                                      scratch_pool);
+  phase.src_rev = svn_fs_revision_root_revision(src_root);
+  phase.tgt_rev = svn_fs_revision_root_revision(tgt_root);
+  phase.ignore_ancestry = ignore_ancestry;
+
+  pb.phase = &phase;
+  pb.source_path = source_path;
+  pb.target_path = target_path;
+
+  *manifest = apr_hash_make(result_pool);
+  err = svn_task__run(DIR_DELTA_COMPARE_THREADS,
+                      compare_process, &pb,
+                      compare_output, *manifest,
+                      compare_context_construct, &phase,
+                      NULL, NULL,
+                      result_pool, scratch_pool);
+  if (err)
+    {
+      /* The serial drive can fully recover from a missing or partial
+         manifest; it re-reads anything it doesn't find in it.  So, upon
+         any problem here, simply fall back to the classic traversal. */
+      svn_error_clear(err);
+      *manifest = NULL;
+    }
+#else
+  *manifest = NULL;
+#endif
+
+  return SVN_NO_ERROR;
+}
+
+
 /* Public interface to computing directory deltas.  */
 svn_error_t *
 svn_repos_dir_delta2(svn_fs_root_t *src_root,
@@ -304,6 +711,7 @@ svn_repos_dir_delta2(svn_fs_root_t *src_root,
   c.text_deltas = text_deltas;
   c.entry_props = entry_props;
   c.ignore_ancestry = ignore_ancestry;
+  c.change_manifest = NULL;
 
   /* Get our editor root's revision. */
   rootrev = get_path_revision(src_root, src_parent_dir, pool);
@@ -327,6 +735,10 @@ svn_repos_dir_delta2(svn_fs_root_t *src_root,
       SVN_ERR(authz_root_check(tgt_root, authz_root_path,
                                authz_read_func, authz_read_baton, pool));
       SVN_ERR(editor->open_root(edit_baton, rootrev, pool, &root_baton));
+      if (depth == svn_depth_infinity && tgt_kind == svn_node_dir)
+        SVN_ERR(build_change_manifest(&c.change_manifest, src_root, NULL,
+                                      tgt_root, tgt_fullpath,
+                                      ignore_ancestry, pool, pool));
       SVN_ERR(add_file_or_dir(&c, root_baton, depth, tgt_fullpath,
                               src_entry, tgt_kind, pool));
       goto cleanup;
@@ -353,6 +765,10 @@ svn_repos_dir_delta2(svn_fs_root_t *src_root,
                                    authz_read_func, authz_read_baton, pool));
           SVN_ERR(editor->open_root(edit_baton, rootrev, pool, &root_baton));
           SVN_ERR(delete(&c, root_baton, src_entry, pool));
+          if (depth == svn_depth_infinity && tgt_kind == svn_node_dir)
+            SVN_ERR(build_change_manifest(&c.change_manifest, src_root, NULL,
+                                          tgt_root, tgt_fullpath,
+                                          ignore_ancestry, pool, pool));
           SVN_ERR(add_file_or_dir(&c, root_baton, depth, tgt_fullpath,
                                   src_entry, tgt_kind, pool));
         }
@@ -362,6 +778,11 @@ svn_repos_dir_delta2(svn_fs_root_t *src_root,
           SVN_ERR(authz_root_check(tgt_root, authz_root_path,
                                    authz_read_func, authz_read_baton, pool));
           SVN_ERR(editor->open_root(edit_baton, rootrev, pool, &root_baton));
+          if (depth == svn_depth_infinity && tgt_kind == svn_node_dir)
+            SVN_ERR(build_change_manifest(&c.change_manifest, src_root,
+                                          src_fullpath, tgt_root,
+                                          tgt_fullpath, ignore_ancestry,
+                                          pool, pool));
           SVN_ERR(replace_file_or_dir(&c, root_baton, depth, src_fullpath,
                                       tgt_fullpath, src_entry,
                                       tgt_kind, pool));
@@ -373,6 +794,10 @@ svn_repos_dir_delta2(svn_fs_root_t *src_root,
       SVN_ERR(authz_root_check(tgt_root, authz_root_path,
                                authz_read_func, authz_read_baton, pool));
       SVN_ERR(editor->open_root(edit_baton, rootrev, pool, &root_baton));
+      if (depth == svn_depth_infinity)
+        SVN_ERR(build_change_manifest(&c.change_manifest, src_root,
+                                      src_fullpath, tgt_root, tgt_fullpath,
+                                      ignore_ancestry, pool, pool));
       SVN_ERR(delta_dirs(&c, root_baton, depth, src_fullpath,
                          tgt_fullpath, "", pool));
     }
@@ -855,6 +1280,72 @@ delta_dirs(struct context *c,
   SVN_ERR(delta_proplists(c, source_path, target_path,
                           change_dir_prop, dir_baton, pool));
 
+  /* If the compare phase has already made all the decisions below,
+     replay them instead of re-reading and comparing the directories.
+     A manifest miss simply means this directory pair was not covered;
+     fall through to the classic traversal then. */
+  if (c->change_manifest && depth == svn_depth_infinity)
+    {
+      const struct compare_dir *dir = svn_hash_gets(c->change_manifest,
+                                                    target_path);
+
+      if (dir
+          && ((dir->source_path == NULL && source_path == NULL)
+              || (dir->source_path && source_path
+                  && strcmp(dir->source_path, source_path) == 0)))
+        {
+          int i;
+
+          subpool = svn_pool_create(pool);
+          for (i = 0; i < dir->entries->nelts; i++)
+            {
+              const struct compare_entry *entry
+                = APR_ARRAY_IDX(dir->entries, i, struct compare_entry *);
+              const char *e_fullpath;
+
+              svn_pool_clear(subpool);
+              e_fullpath = svn_relpath_join(edit_path, entry->name, subpool);
+
+              switch (entry->action)
+                {
+                case compare_action_delete_add:
+                  SVN_ERR(delete(c, dir_baton, e_fullpath, subpool));
+                  /* fall through */
+                case compare_action_add:
+                  SVN_ERR(add_file_or_dir(c, dir_baton,
+                                          MAYBE_DEMOTE_DEPTH(depth),
+                                          svn_relpath_join(target_path,
+                                                           entry->name,
+                                                           subpool),
+                                          e_fullpath, entry->tgt_kind,
+                                          subpool));
+                  break;
+
+                case compare_action_replace:
+                  SVN_ERR(replace_file_or_dir(c, dir_baton,
+                                              MAYBE_DEMOTE_DEPTH(depth),
+                                              svn_relpath_join(source_path,
+                                                               entry->name,
+                                                               subpool),
+                                              svn_relpath_join(target_path,
+                                                               entry->name,
+                                                               subpool),
+                                              e_fullpath, entry->tgt_kind,
+                                              subpool));
+                  break;
+
+                case compare_action_delete:
+                  SVN_ERR(delete(c, dir_baton, e_fullpath, subpool));
+                  break;
+                }
+            }
+
+          svn_pool_destroy(subpool);
+
+          return SVN_NO_ERROR;
+        }
+    }
+
   /* Get the list of entries in each of source and target.  */
   SVN_ERR(svn_fs_dir_entries(&t_entries, c->target_root,
                              target_path, pool));
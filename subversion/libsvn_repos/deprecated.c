@@ -639,6 +639,28 @@ svn_repos_get_logs(svn_repos_t *repos,
                              receiver, receiver_baton, pool);
 }
 
+/*** From list.c ***/
+svn_error_t *
+svn_repos_list(svn_fs_root_t *root,
+               const char *path,
+               const apr_array_header_t *patterns,
+               svn_depth_t depth,
+               svn_boolean_t path_info_only,
+               svn_repos_authz_func_t authz_read_func,
+               void *authz_read_baton,
+               svn_repos_dirent_receiver_t receiver,
+               void *receiver_baton,
+               svn_cancel_func_t cancel_func,
+               void *cancel_baton,
+               apr_pool_t *scratch_pool)
+{
+  return svn_repos_list2(root, path, patterns, depth, path_info_only,
+                         NULL, 0, /* no pagination */
+                         authz_read_func, authz_read_baton,
+                         receiver, receiver_baton,
+                         cancel_func, cancel_baton, scratch_pool);
+}
+
 /*** From rev_hunt.c ***/
 svn_error_t *
 svn_repos_history(svn_fs_t *fs,
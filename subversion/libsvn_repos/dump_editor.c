@@ -88,16 +88,19 @@ struct dir_baton
   /* Headers accumulated so far for this directory */
   svn_repos__dumpfile_headers_t *headers;
 
-  /* Properties which were modified during change_dir_prop. */
+  /* Properties which were modified during change_dir_prop;
+     NULL until the first modification. */
   apr_hash_t *props;
 
-  /* Properties which were deleted during change_dir_prop. */
+  /* Properties which were deleted during change_dir_prop;
+     NULL until the first deletion. */
   apr_hash_t *deleted_props;
 
   /* Hash of paths that need to be deleted, though some -might- be
      replaced.  Maps const char * paths to this dir_baton. Note that
      they're full paths, because that's what the editor driver gives
-     us, although they're all really within this directory. */
+     us, although they're all really within this directory.
+     NULL until the first deletion. */
   apr_hash_t *deleted_entries;
 
   /* Flag to trigger dumping props. */
@@ -116,10 +119,12 @@ struct file_baton
   /* the path to this file */
   const char *repos_relpath; /* a relpath */
 
-  /* Properties which were modified during change_file_prop. */
+  /* Properties which were modified during change_file_prop;
+     NULL until the first modification. */
   apr_hash_t *props;
 
-  /* Properties which were deleted during change_file_prop. */
+  /* Properties which were deleted during change_file_prop;
+     NULL until the first deletion. */
   apr_hash_t *deleted_props;
 
   /* The checksum of the file the delta is being applied to */
@@ -211,9 +216,10 @@ make_dir_baton(struct dir_baton **dbp,
                             : NULL;
   new_db->copyfrom_rev = copyfrom_rev;
   new_db->headers = NULL;
-  new_db->props = apr_hash_make(pool);
-  new_db->deleted_props = apr_hash_make(pool);
-  new_db->deleted_entries = apr_hash_make(pool);
+
+  /* The props and deleted_entries hashes are created lazily, on first
+     use.  Most directories are only opened because some child of theirs
+     changed and never touch any of them. */
 
   *dbp = new_db;
   return SVN_NO_ERROR;
@@ -233,8 +239,6 @@ make_file_baton(const char *path,
   new_fb->eb = pb->eb;
   new_fb->pool = pool;
   new_fb->repos_relpath = svn_relpath_canonicalize(path, pool);
-  new_fb->props = apr_hash_make(pool);
-  new_fb->deleted_props = apr_hash_make(pool);
   new_fb->is_copy = FALSE;
   new_fb->copyfrom_path = NULL;
   new_fb->copyfrom_rev = SVN_INVALID_REVNUM;
@@ -245,6 +249,8 @@ make_file_baton(const char *path,
 
 /* Append to HEADERS the required headers, and set *CONTENT to the property
  * content section, to represent the property delta of PROPS/DELETED_PROPS.
+ * Either or both of PROPS and DELETED_PROPS may be NULL, meaning no
+ * modified resp. deleted properties.
  */
 static svn_error_t *
 get_props_content(svn_repos__dumpfile_headers_t *headers,
@@ -261,7 +267,10 @@ get_props_content(svn_repos__dumpfile_headers_t *headers,
 
   content_stream = svn_stream_from_stringbuf(*content, scratch_pool);
 
-  SVN_ERR(normalize_props(&normal_props, props, scratch_pool));
+  if (props)
+    SVN_ERR(normalize_props(&normal_props, props, scratch_pool));
+  else
+    normal_props = apr_hash_make(scratch_pool);
   SVN_ERR(svn_hash_write_incremental(normal_props, deleted_props,
                                      content_stream, "PROPS-END",
                                      scratch_pool));
@@ -479,8 +488,7 @@ dump_mkdir(struct dump_edit_baton *eb,
     headers, SVN_REPOS_DUMPFILE_NODE_ACTION, "add");
 
   /* Dump the (empty) property block. */
-  SVN_ERR(get_props_content(headers, &prop_content,
-                            apr_hash_make(pool), apr_hash_make(pool),
+  SVN_ERR(get_props_content(headers, &prop_content, NULL, NULL,
                             pool, pool));
   SVN_ERR(svn_repos__dump_node_record(eb->stream, headers, prop_content,
                                       FALSE, 0, FALSE /*content_length_always*/,
@@ -522,8 +530,10 @@ dump_pending_dir(struct dump_edit_baton *eb,
   if (db->dump_props)
     {
       /* Cleanup so that data is never dumped twice. */
-      apr_hash_clear(db->props);
-      apr_hash_clear(db->deleted_props);
+      if (db->props)
+        apr_hash_clear(db->props);
+      if (db->deleted_props)
+        apr_hash_clear(db->deleted_props);
       db->dump_props = FALSE;
     }
 
@@ -619,6 +629,8 @@ delete_entry(const char *path,
      to the deleted_entries of the parent directory baton.  That way,
      we can tell (later) an addition from a replacement.  All the real
      deletions get handled in close_directory().  */
+  if (! pb->deleted_entries)
+    pb->deleted_entries = apr_hash_make(pb->pool);
   svn_hash_sets(pb->deleted_entries, apr_pstrdup(pb->pool, path), pb);
 
   return SVN_NO_ERROR;
@@ -643,7 +655,9 @@ add_directory(const char *path,
                          pb, pb->pool));
 
   /* This might be a replacement -- is the path already deleted? */
-  was_deleted = svn_hash_gets(pb->deleted_entries, path);
+  was_deleted = pb->deleted_entries
+                  ? svn_hash_gets(pb->deleted_entries, path)
+                  : NULL;
 
   /* Detect an add-with-history */
   is_copy = ARE_VALID_COPY_ARGS(copyfrom_path, copyfrom_rev);
@@ -733,18 +747,21 @@ close_directory(void *dir_baton,
     }
 
   /* Dump the deleted directory entries */
-  for (hi = apr_hash_first(pool, db->deleted_entries); hi;
-       hi = apr_hash_next(hi))
+  if (db->deleted_entries)
     {
-      const char *path = apr_hash_this_key(hi);
+      for (hi = apr_hash_first(pool, db->deleted_entries); hi;
+           hi = apr_hash_next(hi))
+        {
+          const char *path = apr_hash_this_key(hi);
 
-      SVN_ERR(dump_node_delete(db->eb->stream, path, pool));
-      /* This deletion record is complete -- write an extra newline */
-      SVN_ERR(svn_stream_puts(db->eb->stream, "\n"));
-    }
+          SVN_ERR(dump_node_delete(db->eb->stream, path, pool));
+          /* This deletion record is complete -- write an extra newline */
+          SVN_ERR(svn_stream_puts(db->eb->stream, "\n"));
+        }
 
-  /* ### should be unnecessary */
-  apr_hash_clear(db->deleted_entries);
+      /* ### should be unnecessary */
+      apr_hash_clear(db->deleted_entries);
+    }
 
   return SVN_NO_ERROR;
 }
@@ -767,7 +784,9 @@ add_file(const char *path,
   fb = make_file_baton(path, pb, pool);
 
   /* This might be a replacement -- is the path already deleted? */
-  was_deleted = svn_hash_gets(pb->deleted_entries, path);
+  was_deleted = pb->deleted_entries
+                  ? svn_hash_gets(pb->deleted_entries, path)
+                  : NULL;
 
   /* Detect add-with-history. */
   if (ARE_VALID_COPY_ARGS(copyfrom_path, copyfrom_rev))
@@ -834,11 +853,19 @@ change_dir_prop(void *parent_baton,
     return SVN_NO_ERROR;
 
   if (value)
-    svn_hash_sets(db->props,
-                  apr_pstrdup(db->pool, name),
-                  svn_string_dup(value, db->pool));
+    {
+      if (! db->props)
+        db->props = apr_hash_make(db->pool);
+      svn_hash_sets(db->props,
+                    apr_pstrdup(db->pool, name),
+                    svn_string_dup(value, db->pool));
+    }
   else
-    svn_hash_sets(db->deleted_props, apr_pstrdup(db->pool, name), "");
+    {
+      if (! db->deleted_props)
+        db->deleted_props = apr_hash_make(db->pool);
+      svn_hash_sets(db->deleted_props, apr_pstrdup(db->pool, name), "");
+    }
 
   /* Make sure we eventually output the props */
   db->dump_props = TRUE;
@@ -858,11 +885,19 @@ change_file_prop(void *file_baton,
     return SVN_NO_ERROR;
 
   if (value)
-    svn_hash_sets(fb->props,
-                  apr_pstrdup(fb->pool, name),
-                  svn_string_dup(value, fb->pool));
+    {
+      if (! fb->props)
+        fb->props = apr_hash_make(fb->pool);
+      svn_hash_sets(fb->props,
+                    apr_pstrdup(fb->pool, name),
+                    svn_string_dup(value, fb->pool));
+    }
   else
-    svn_hash_sets(fb->deleted_props, apr_pstrdup(fb->pool, name), "");
+    {
+      if (! fb->deleted_props)
+        fb->deleted_props = apr_hash_make(fb->pool);
+      svn_hash_sets(fb->deleted_props, apr_pstrdup(fb->pool, name), "");
+    }
 
   /* Dump the property headers and wait; close_file might need
      to write text headers too depending on whether
@@ -955,8 +990,10 @@ close_file(void *file_baton,
     {
       /* Cleanup */
       fb->dump_props = FALSE;
-      apr_hash_clear(fb->props);
-      apr_hash_clear(fb->deleted_props);
+      if (fb->props)
+        apr_hash_clear(fb->props);
+      if (fb->deleted_props)
+        apr_hash_clear(fb->deleted_props);
     }
 
   /* Dump the text */
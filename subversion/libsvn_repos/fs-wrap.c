@@ -111,6 +111,17 @@ svn_repos_fs_commit_txn(const char **conflict_p,
       return err;
     }
 
+  /* Notify in-process subscribers before starting the post-commit hook
+     script; they get the changed-paths list without re-reading the
+     revision. */
+  if ((err2 = svn_repos__notify_commit_subscribers(repos, *new_rev, pool)))
+    {
+      err2 = svn_error_create
+               (SVN_ERR_REPOS_POST_COMMIT_HOOK_FAILED, err2,
+                _("Commit succeeded, but commit notification failed"));
+      err = svn_error_compose_create(err, err2);
+    }
+
   /* Run post-commit hooks. */
   if ((err2 = svn_repos__hooks_post_commit(repos, hooks_env,
                                            *new_rev, txn_name, pool)))
@@ -867,7 +878,10 @@ struct get_locks_baton_t
   svn_fs_root_t *head_root;
   svn_repos_authz_func_t authz_read_func;
   void *authz_read_baton;
-  apr_hash_t *locks;
+
+  /* The caller's callback, invoked for each readable lock. */
+  svn_fs_get_locks_callback_t get_locks_func;
+  void *get_locks_baton;
 };
 
 
@@ -879,32 +893,30 @@ get_locks_callback(void *baton,
 {
   struct get_locks_baton_t *b = baton;
   svn_boolean_t readable = TRUE;
-  apr_pool_t *hash_pool = apr_hash_pool_get(b->locks);
 
   /* If there's auth to deal with, deal with it. */
   if (b->authz_read_func)
     SVN_ERR(b->authz_read_func(&readable, b->head_root, lock->path,
                                b->authz_read_baton, pool));
 
-  /* If we can read this lock path, add the lock to the return hash. */
+  /* If we can read this lock path, pass the lock on to the caller. */
   if (readable)
-    svn_hash_sets(b->locks, apr_pstrdup(hash_pool, lock->path),
-                  svn_lock_dup(lock, hash_pool));
+    SVN_ERR(b->get_locks_func(b->get_locks_baton, lock, pool));
 
   return SVN_NO_ERROR;
 }
 
 
 svn_error_t *
-svn_repos_fs_get_locks2(apr_hash_t **locks,
-                        svn_repos_t *repos,
-                        const char *path,
-                        svn_depth_t depth,
-                        svn_repos_authz_func_t authz_read_func,
-                        void *authz_read_baton,
-                        apr_pool_t *pool)
+svn_repos__fs_get_locks_stream(svn_repos_t *repos,
+                               const char *path,
+                               svn_depth_t depth,
+                               svn_repos_authz_func_t authz_read_func,
+                               void *authz_read_baton,
+                               svn_fs_get_locks_callback_t get_locks_func,
+                               void *get_locks_baton,
+                               apr_pool_t *pool)
 {
-  apr_hash_t *all_locks = apr_hash_make(pool);
   svn_revnum_t head_rev;
   struct get_locks_baton_t baton;
 
@@ -917,17 +929,53 @@ svn_repos_fs_get_locks2(apr_hash_t **locks,
 
   /* Populate our callback baton. */
   baton.fs = repos->fs;
-  baton.locks = all_locks;
   baton.authz_read_func = authz_read_func;
   baton.authz_read_baton = authz_read_baton;
+  baton.get_locks_func = get_locks_func;
+  baton.get_locks_baton = get_locks_baton;
   SVN_ERR(svn_fs_revision_root(&(baton.head_root), repos->fs,
                                head_rev, pool));
 
   /* Get all the locks. */
-  SVN_ERR(svn_fs_get_locks2(repos->fs, path, depth,
-                            get_locks_callback, &baton, pool));
+  return svn_error_trace(svn_fs_get_locks2(repos->fs, path, depth,
+                                           get_locks_callback, &baton, pool));
+}
+
+
+/* Implements svn_fs_get_locks_callback_t, adding LOCK to the hash
+   given as BATON. */
+static svn_error_t *
+hash_locks_callback(void *baton,
+                    svn_lock_t *lock,
+                    apr_pool_t *pool)
+{
+  apr_hash_t *locks = baton;
+  apr_pool_t *hash_pool = apr_hash_pool_get(locks);
+
+  svn_hash_sets(locks, apr_pstrdup(hash_pool, lock->path),
+                svn_lock_dup(lock, hash_pool));
+
+  return SVN_NO_ERROR;
+}
+
+
+svn_error_t *
+svn_repos_fs_get_locks2(apr_hash_t **locks,
+                        svn_repos_t *repos,
+                        const char *path,
+                        svn_depth_t depth,
+                        svn_repos_authz_func_t authz_read_func,
+                        void *authz_read_baton,
+                        apr_pool_t *pool)
+{
+  apr_hash_t *all_locks = apr_hash_make(pool);
+
+  SVN_ERR(svn_repos__fs_get_locks_stream(repos, path, depth,
+                                         authz_read_func, authz_read_baton,
+                                         hash_locks_callback, all_locks,
+                                         pool));
 
-  *locks = baton.locks;
+  *locks = all_locks;
   return SVN_NO_ERROR;
 }
 
@@ -26,6 +26,7 @@
 
 #include <apr_pools.h>
 #include <apr_file_io.h>
+#include <apr_network_io.h>
 
 #include "svn_config.h"
 #include "svn_hash.h"
@@ -45,6 +46,55 @@
 
 /*** Hook drivers. ***/
 
+/* Return the error describing the failure of hook NAME that exited
+   cleanly with the non-zero code EXITCODE.  UTF8_STDERR is the hook's
+   error output, which may be empty.  Allocate the error in POOL. */
+static svn_error_t *
+hook_failure_error(const char *name,
+                   int exitcode,
+                   const char *utf8_stderr,
+                   apr_pool_t *pool)
+{
+  svn_stringbuf_t *failure_message;
+  const char *action;
+
+  if (strcmp(name, "start-commit") == 0
+      || strcmp(name, "pre-commit") == 0)
+    action = _("Commit");
+  else if (strcmp(name, "pre-revprop-change") == 0)
+    action = _("Revprop change");
+  else if (strcmp(name, "pre-lock") == 0)
+    action = _("Lock");
+  else if (strcmp(name, "pre-unlock") == 0)
+    action = _("Unlock");
+  else
+    action = NULL;
+
+  if (action == NULL)
+    failure_message = svn_stringbuf_createf(
+        pool, _("%s hook failed (exit code %d)"),
+        name, exitcode);
+  else
+    failure_message = svn_stringbuf_createf(
+        pool, _("%s blocked by %s hook (exit code %d)"),
+        action, name, exitcode);
+
+  if (utf8_stderr[0])
+    {
+      svn_stringbuf_appendcstr(failure_message,
+                               _(" with output:\n"));
+      svn_stringbuf_appendcstr(failure_message, utf8_stderr);
+    }
+  else
+    {
+      svn_stringbuf_appendcstr(failure_message,
+                               _(" with no output."));
+    }
+
+  return svn_error_create(SVN_ERR_REPOS_HOOK_FAILURE, NULL,
+                          failure_message->data);
+}
+
 /* Helper function for run_hook_cmd().  Wait for a hook to finish
    executing and return either SVN_NO_ERROR if the hook script completed
    without error, or an error describing the reason for failure.
@@ -121,45 +171,25 @@ check_hook_result(const char *name, const char *cmd, apr_proc_t *cmd_proc,
         _("'%s' hook failed (did not exit cleanly: "
           "apr_exit_why_e was %d, exitcode was %d).  "),
         name, exitwhy, exitcode);
-    }
-  else
-    {
-      const char *action;
-      if (strcmp(name, "start-commit") == 0
-          || strcmp(name, "pre-commit") == 0)
-        action = _("Commit");
-      else if (strcmp(name, "pre-revprop-change") == 0)
-        action = _("Revprop change");
-      else if (strcmp(name, "pre-lock") == 0)
-        action = _("Lock");
-      else if (strcmp(name, "pre-unlock") == 0)
-        action = _("Unlock");
-      else
-        action = NULL;
-      if (action == NULL)
-        failure_message = svn_stringbuf_createf(
-            pool, _("%s hook failed (exit code %d)"),
-            name, exitcode);
+
+      if (utf8_stderr[0])
+        {
+          svn_stringbuf_appendcstr(failure_message,
+                                   _(" with output:\n"));
+          svn_stringbuf_appendcstr(failure_message, utf8_stderr);
+        }
       else
-        failure_message = svn_stringbuf_createf(
-            pool, _("%s blocked by %s hook (exit code %d)"),
-            action, name, exitcode);
-    }
+        {
+          svn_stringbuf_appendcstr(failure_message,
+                                   _(" with no output."));
+        }
 
-  if (utf8_stderr[0])
-    {
-      svn_stringbuf_appendcstr(failure_message,
-                               _(" with output:\n"));
-      svn_stringbuf_appendcstr(failure_message, utf8_stderr);
-    }
-  else
-    {
-      svn_stringbuf_appendcstr(failure_message,
-                               _(" with no output."));
+      return svn_error_create(SVN_ERR_REPOS_HOOK_FAILURE, err,
+                              failure_message->data);
     }
 
-  return svn_error_create(SVN_ERR_REPOS_HOOK_FAILURE, err,
-                          failure_message->data);
+  return svn_error_trace(hook_failure_error(name, exitcode, utf8_stderr,
+                                            pool));
 }
 
 /* Copy the environment given as key/value pairs of ENV_HASH into
@@ -193,6 +223,208 @@ env_from_env_hash(apr_hash_t *env_hash,
   return env;
 }
 
+#ifdef APR_UNIX
+
+/* Parse one "KEYWORD SP <decimal length> LF <length bytes> LF" frame
+   at *P, which must end before END.  On success set *VALUE / *VALUE_LEN
+   to the (unterminated) payload, advance *P past the frame and return
+   TRUE.  Return FALSE if the data does not match the frame format. */
+static svn_boolean_t
+parse_sized_frame(const char **value,
+                  apr_size_t *value_len,
+                  const char **p,
+                  const char *end,
+                  const char *keyword)
+{
+  apr_size_t key_len = strlen(keyword);
+  const char *q = *p;
+  apr_uint64_t size = 0;
+
+  if ((apr_size_t)(end - q) < key_len + 1
+      || memcmp(q, keyword, key_len) != 0
+      || q[key_len] != ' ')
+    return FALSE;
+  q += key_len + 1;
+
+  if (q == end || *q < '0' || *q > '9')
+    return FALSE;
+  while (q < end && *q >= '0' && *q <= '9')
+    size = size * 10 + (apr_uint64_t)(*q++ - '0');
+  if (q == end || *q++ != '\n')
+    return FALSE;
+
+  if (size + 1 > (apr_uint64_t)(end - q))
+    return FALSE;
+  *value = q;
+  *value_len = (apr_size_t)size;
+  q += size;
+  if (*q++ != '\n')
+    return FALSE;
+
+  *p = q;
+  return TRUE;
+}
+
+/* Dispatch hook NAME with ARGS and the contents of STDIN_HANDLE (may
+   be NULL) to the long-lived hook server listening on the Unix-domain
+   socket at SERVER_PATH instead of executing the hook script.  The
+   exchange carries the same argument and stdin contract as the script
+   invocation would:
+
+     request:   "hook" SP <name> LF
+                "arg" SP <length> LF <bytes> LF     (once per argument)
+                "stdin" SP <length> LF <bytes> LF
+                "run" LF
+     response:  "exit" SP <code> LF
+                "stderr" SP <length> LF <bytes> LF
+                "stdout" SP <length> LF <bytes> LF
+
+   The server may keep its interpreter and any expensive state loaded
+   across requests; one request maps to one connection, terminated by
+   the server after sending the response.  Exit codes and stderr are
+   treated exactly like those of an exec'd hook.  If RESULT is
+   non-null, set *RESULT to the response's stdout payload. */
+static svn_error_t *
+run_hook_server(svn_string_t **result,
+                const char *name,
+                const char *server_path,
+                const char **args,
+                apr_file_t *stdin_handle,
+                apr_pool_t *pool)
+{
+  apr_socket_t *sock;
+  apr_sockaddr_t *sa;
+  apr_status_t apr_err;
+  svn_stringbuf_t *request = svn_stringbuf_create_empty(pool);
+  svn_stringbuf_t *response = svn_stringbuf_create_empty(pool);
+  svn_stringbuf_t *stdin_buf = NULL;
+  const char **arg;
+  const char *p;
+  const char *end;
+  const char *data;
+  apr_size_t data_len;
+  apr_size_t remaining;
+  const char *utf8_stderr;
+  svn_error_t *err;
+  long exitcode = 0;
+  char buffer[4096];
+
+  if (stdin_handle)
+    SVN_ERR(svn_stringbuf_from_aprfile(&stdin_buf, stdin_handle, pool));
+
+  /* Marshal the whole request up front so it goes out in few writes. */
+  svn_stringbuf_appendcstr(request,
+                           apr_psprintf(pool, "hook %s\n", name));
+  for (arg = args; *arg; arg++)
+    {
+      svn_stringbuf_appendcstr(request,
+                               apr_psprintf(pool, "arg %" APR_SIZE_T_FMT "\n",
+                                            strlen(*arg)));
+      svn_stringbuf_appendcstr(request, *arg);
+      svn_stringbuf_appendbyte(request, '\n');
+    }
+  svn_stringbuf_appendcstr(request,
+                           apr_psprintf(pool, "stdin %" APR_SIZE_T_FMT "\n",
+                                        stdin_buf ? stdin_buf->len : 0));
+  if (stdin_buf)
+    svn_stringbuf_appendbytes(request, stdin_buf->data, stdin_buf->len);
+  svn_stringbuf_appendbyte(request, '\n');
+  svn_stringbuf_appendcstr(request, "run\n");
+
+  apr_err = apr_sockaddr_info_get(&sa, server_path, APR_UNIX, 0, 0, pool);
+  if (!apr_err)
+    apr_err = apr_socket_create(&sock, sa->family, SOCK_STREAM, 0, pool);
+  if (!apr_err)
+    apr_err = apr_socket_connect(sock, sa);
+  if (apr_err)
+    return svn_error_wrap_apr(apr_err,
+                              _("Can't connect to hook server '%s' "
+                                "for hook '%s'"),
+                              server_path, name);
+
+  data = request->data;
+  remaining = request->len;
+  while (remaining)
+    {
+      apr_size_t len = remaining;
+      apr_err = apr_socket_send(sock, data, &len);
+      if (apr_err)
+        return svn_error_wrap_apr(apr_err,
+                                  _("Can't send request to hook server "
+                                    "'%s' for hook '%s'"),
+                                  server_path, name);
+      data += len;
+      remaining -= len;
+    }
+  apr_socket_shutdown(sock, APR_SHUTDOWN_WRITE);
+
+  while (TRUE)
+    {
+      apr_size_t len = sizeof(buffer);
+      apr_err = apr_socket_recv(sock, buffer, &len);
+      if (len)
+        svn_stringbuf_appendbytes(response, buffer, len);
+      if (APR_STATUS_IS_EOF(apr_err))
+        break;
+      if (apr_err)
+        return svn_error_wrap_apr(apr_err,
+                                  _("Error reading response of hook server "
+                                    "'%s' for hook '%s'"),
+                                  server_path, name);
+    }
+  apr_socket_close(sock);
+
+  /* Parse "exit <code>\n" followed by the stderr and stdout frames. */
+  p = response->data;
+  end = p + response->len;
+  if ((apr_size_t)(end - p) > strlen("exit ")
+      && memcmp(p, "exit ", strlen("exit ")) == 0
+      && p[strlen("exit ")] >= '0' && p[strlen("exit ")] <= '9')
+    {
+      p += strlen("exit ");
+      while (p < end && *p >= '0' && *p <= '9')
+        exitcode = exitcode * 10 + (*p++ - '0');
+    }
+  else
+    p = end;
+
+  if (p == end || *p++ != '\n'
+      || !parse_sized_frame(&data, &data_len, &p, end, "stderr"))
+    return svn_error_createf(SVN_ERR_REPOS_HOOK_FAILURE, NULL,
+                             _("Malformed response from hook server '%s' "
+                               "for hook '%s'"),
+                             server_path, name);
+
+  if (exitcode != 0)
+    {
+      err = svn_utf_cstring_to_utf8(&utf8_stderr,
+                                    apr_pstrmemdup(pool, data, data_len),
+                                    pool);
+      if (err)
+        {
+          svn_error_clear(err);
+          utf8_stderr = _("[Error output could not be translated from "
+                          "the native locale to UTF-8.]");
+        }
+      return svn_error_trace(hook_failure_error(name, (int)exitcode,
+                                                utf8_stderr, pool));
+    }
+
+  if (result)
+    {
+      if (!parse_sized_frame(&data, &data_len, &p, end, "stdout"))
+        return svn_error_createf(SVN_ERR_REPOS_HOOK_FAILURE, NULL,
+                                 _("Malformed response from hook server "
+                                   "'%s' for hook '%s'"),
+                                 server_path, name);
+      *result = svn_string_ncreate(data, data_len, pool);
+    }
+
+  return SVN_NO_ERROR;
+}
+
+#endif /* APR_UNIX */
+
 /* NAME, CMD and ARGS are the name, path to and arguments for the hook
    program that is to be run.  The hook's exit status will be checked,
    and if an error occurred the hook's stderr output will be added to
@@ -219,6 +451,32 @@ run_hook_cmd(svn_string_t **result,
   apr_pool_t *cmd_pool;
   apr_hash_t *hook_env = NULL;
 
+  /* Check if a custom environment is defined for this hook, or else
+   * whether a default environment is defined. */
+  if (hooks_env)
+    {
+      hook_env = svn_hash_gets(hooks_env, name);
+      if (hook_env == NULL)
+        hook_env = svn_hash_gets(hooks_env,
+                                 SVN_REPOS__HOOKS_ENV_DEFAULT_SECTION);
+    }
+
+#ifdef APR_UNIX
+  /* If this hook is configured to be handled by a long-lived hook
+   * server, dispatch it there instead of spawning the hook script.
+   * This saves the fork/exec and, more importantly, the interpreter
+   * startup of script hooks on every invocation. */
+  if (hook_env)
+    {
+      const char *server_path
+        = svn_hash_gets(hook_env, SVN_REPOS__HOOKS_ENV_HOOK_SERVER);
+
+      if (server_path)
+        return svn_error_trace(run_hook_server(result, name, server_path,
+                                               args, stdin_handle, pool));
+    }
+#endif
+
   if (result)
     {
       null_handle = NULL;
@@ -237,16 +495,6 @@ run_hook_cmd(svn_string_t **result,
    * destroy in order to clean up the stderr pipe opened for the process. */
   cmd_pool = svn_pool_create(pool);
 
-  /* Check if a custom environment is defined for this hook, or else
-   * whether a default environment is defined. */
-  if (hooks_env)
-    {
-      hook_env = svn_hash_gets(hooks_env, name);
-      if (hook_env == NULL)
-        hook_env = svn_hash_gets(hooks_env,
-                                 SVN_REPOS__HOOKS_ENV_DEFAULT_SECTION);
-    }
-
   err = svn_io_start_cmd3(&cmd_proc, ".", cmd, args,
                           env_from_env_hash(hook_env, pool, pool),
                           FALSE, FALSE, stdin_handle, result != NULL,
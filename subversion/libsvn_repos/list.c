@@ -29,6 +29,7 @@
 #include "svn_time.h"
 
 #include "private/svn_repos_private.h"
+#include "private/svn_fs_private.h"
 #include "private/svn_sorts_private.h"
 #include "private/svn_utf_private.h"
 #include "svn_private_config.h" /* for SVN_TEMPLATE_ROOT_DIR */
@@ -146,22 +147,24 @@ typedef struct filtered_dirent_t
   svn_boolean_t is_match;
 } filtered_dirent_t;
 
-/* Implement a standard sort function for filtered_dirent_t *, sorting them
- * by entry name. */
+/* Compare the name of the svn_fs_dirent_t * in *A to the plain entry
+ * name in *B, as for svn_sort__bsearch_lower_bound. */
 static int
-compare_filtered_dirent(const void *lhs,
-                        const void *rhs)
+compare_dirent_to_name(const void *a, const void *b)
 {
-  const filtered_dirent_t *lhs_dirent = (const filtered_dirent_t *)lhs;
-  const filtered_dirent_t *rhs_dirent = (const filtered_dirent_t *)rhs;
+  const svn_fs_dirent_t *lhs = *(const svn_fs_dirent_t *const *)a;
+  const char *rhs = b;
 
-  return strcmp(lhs_dirent->dirent->name, rhs_dirent->dirent->name);
+  return strcmp(lhs->name, rhs);
 }
 
-/* Core of svn_repos_list with the same parameter list.
+/* Core of svn_repos_list2 with the same parameter list.
  *
  * However, DEPTH is not svn_depth_empty and PATH has already been reported.
- * Therefore, we can call this recursively.
+ * Therefore, we can call this recursively.  START_NAME applies to the
+ * immediate entries of PATH only and will be NULL in recursive calls.
+ * If REMAINING is not NULL, report no more than *REMAINING entries and
+ * decrement the counter for each entry reported.
  *
  * Uses SCRATCH_BUFFER for temporary string contents.
  */
@@ -171,6 +174,8 @@ do_list(svn_fs_root_t *root,
         const apr_array_header_t *patterns,
         svn_depth_t depth,
         svn_boolean_t path_info_only,
+        const char *start_name,
+        apr_size_t *remaining,
         svn_repos_authz_func_t authz_read_func,
         void *authz_read_baton,
         svn_repos_dirent_receiver_t receiver,
@@ -180,29 +185,45 @@ do_list(svn_fs_root_t *root,
         svn_membuf_t *scratch_buffer,
         apr_pool_t *scratch_pool)
 {
-  apr_hash_t *entries;
+  apr_array_header_t *entries;
   apr_pool_t *iterpool = svn_pool_create(scratch_pool);
-  apr_hash_index_t *hi;
   apr_array_header_t *sorted;
+  int start_index;
   int i;
 
-  /* Fetch all directory entries, filter and sort them.
+  /* Fetch all directory entries, in sorted order, and filter them.
+   * Backends that store directories sorted hand the listing out as-is,
+   * so there is no per-directory re-sort here.  Filtering preserves the
+   * order.
    *
    * Performance trade-off:
-   * Constructing a full path vs. faster sort due to authz filtering.
    * We filter according to DEPTH and PATTERNS only because constructing
    * the full path required for authz is somewhat expensive and we don't
    * want to do this twice while authz will rarely filter paths out.
    */
-  SVN_ERR(svn_fs_dir_entries(&entries, root, path, scratch_pool));
-  sorted = apr_array_make(scratch_pool, apr_hash_count(entries),
+  SVN_ERR(svn_fs__dir_entries_sorted(&entries, root, path, scratch_pool));
+
+  /* For a paginated listing, skip everything up to and including
+   * START_NAME before even looking at the entries. */
+  start_index = 0;
+  if (start_name && *start_name)
+    {
+      start_index = svn_sort__bsearch_lower_bound(entries, start_name,
+                                                  compare_dirent_to_name);
+      if (   start_index < entries->nelts
+          && !strcmp(APR_ARRAY_IDX(entries, start_index,
+                                   svn_fs_dirent_t *)->name, start_name))
+        ++start_index;
+    }
+
+  sorted = apr_array_make(scratch_pool, entries->nelts - start_index,
                           sizeof(filtered_dirent_t));
-  for (hi = apr_hash_first(scratch_pool, entries); hi; hi = apr_hash_next(hi))
+  for (i = start_index; i < entries->nelts; ++i)
     {
       filtered_dirent_t filtered;
       svn_pool_clear(iterpool);
 
-      filtered.dirent = apr_hash_this_val(hi);
+      filtered.dirent = APR_ARRAY_IDX(entries, i, svn_fs_dirent_t *);
 
       /* Skip directories if we want to report files only. */
       if (filtered.dirent->kind == svn_node_dir && depth == svn_depth_files)
@@ -217,8 +238,6 @@ do_list(svn_fs_root_t *root,
       APR_ARRAY_PUSH(sorted, filtered_dirent_t) = filtered;
     }
 
-  svn_sort__array(sorted, compare_filtered_dirent);
-
   /* Iterate over all remaining directory entries and report them.
    * Recurse into sub-directories if requested. */
   for (i = 0; i < sorted->nelts; ++i)
@@ -227,6 +246,10 @@ do_list(svn_fs_root_t *root,
       filtered_dirent_t *filtered;
       svn_fs_dirent_t *dirent;
 
+      /* Reported as many entries as the caller asked for? */
+      if (remaining && *remaining == 0)
+        break;
+
       svn_pool_clear(iterpool);
 
       filtered = &APR_ARRAY_IDX(sorted, i, filtered_dirent_t);
@@ -245,8 +268,12 @@ do_list(svn_fs_root_t *root,
 
       /* Report entry, if it passed the filter. */
       if (filtered->is_match)
-        SVN_ERR(report_dirent(root, sub_path, dirent->kind, path_info_only,
-                              receiver, receiver_baton, iterpool));
+        {
+          SVN_ERR(report_dirent(root, sub_path, dirent->kind, path_info_only,
+                                receiver, receiver_baton, iterpool));
+          if (remaining)
+            --*remaining;
+        }
 
       /* Check for cancellation before recursing down.  This should be
        * slightly more responsive for deep trees. */
@@ -256,7 +283,8 @@ do_list(svn_fs_root_t *root,
       /* Recurse on directories. */
       if (depth == svn_depth_infinity && dirent->kind == svn_node_dir)
         SVN_ERR(do_list(root, sub_path, patterns, svn_depth_infinity,
-                        path_info_only, authz_read_func, authz_read_baton,
+                        path_info_only, NULL, remaining,
+                        authz_read_func, authz_read_baton,
                         receiver, receiver_baton, cancel_func,
                         cancel_baton, scratch_buffer, iterpool));
     }
@@ -267,20 +295,23 @@ do_list(svn_fs_root_t *root,
 }
 
 svn_error_t *
-svn_repos_list(svn_fs_root_t *root,
-               const char *path,
-               const apr_array_header_t *patterns,
-               svn_depth_t depth,
-               svn_boolean_t path_info_only,
-               svn_repos_authz_func_t authz_read_func,
-               void *authz_read_baton,
-               svn_repos_dirent_receiver_t receiver,
-               void *receiver_baton,
-               svn_cancel_func_t cancel_func,
-               void *cancel_baton,
-               apr_pool_t *scratch_pool)
+svn_repos_list2(svn_fs_root_t *root,
+                const char *path,
+                const apr_array_header_t *patterns,
+                svn_depth_t depth,
+                svn_boolean_t path_info_only,
+                const char *start_name,
+                apr_size_t limit,
+                svn_repos_authz_func_t authz_read_func,
+                void *authz_read_baton,
+                svn_repos_dirent_receiver_t receiver,
+                void *receiver_baton,
+                svn_cancel_func_t cancel_func,
+                void *cancel_baton,
+                apr_pool_t *scratch_pool)
 {
   svn_membuf_t scratch_buffer;
+  apr_size_t remaining = limit;
 
   /* Parameter check. */
   svn_node_kind_t kind;
@@ -323,16 +354,23 @@ svn_repos_list(svn_fs_root_t *root,
    * Create one with a reasonable initial size. */
   svn_membuf__create(&scratch_buffer, 256, scratch_pool);
 
-  /* Actually report PATH, if it passes the filters. */
-  if (matches_any(svn_dirent_basename(path, scratch_pool), patterns,
-                  &scratch_buffer))
-    SVN_ERR(report_dirent(root, path, kind, path_info_only,
-                          receiver, receiver_baton, scratch_pool));
+  /* Actually report PATH, if it passes the filters.  For a continued
+   * listing, the caller already received PATH on the first page. */
+  if (!start_name
+      && matches_any(svn_dirent_basename(path, scratch_pool), patterns,
+                     &scratch_buffer))
+    {
+      SVN_ERR(report_dirent(root, path, kind, path_info_only,
+                            receiver, receiver_baton, scratch_pool));
+      if (limit && --remaining == 0)
+        return SVN_NO_ERROR;
+    }
 
   /* Report directory contents if requested. */
   if (depth > svn_depth_empty)
     SVN_ERR(do_list(root, path, patterns, depth,
-                    path_info_only, authz_read_func, authz_read_baton,
+                    path_info_only, start_name, limit ? &remaining : NULL,
+                    authz_read_func, authz_read_baton,
                     receiver, receiver_baton, cancel_func, cancel_baton,
                     &scratch_buffer, scratch_pool));
 
@@ -53,74 +53,122 @@ stream_malformed(void)
                           _("Dumpstream data appears to be malformed"));
 }
 
+/* Longest header or property meta data line that we are willing to
+   accept.  Valid dump streams stay far below this limit; anything longer
+   almost certainly means we are reading binary garbage, and buffering it
+   without bounds could consume all available memory. */
+#define MAX_LINE_LEN 65536
+
+/* Read a single line from STREAM into LINEBUF, replacing its previous
+   contents and leaving its allocated buffer in place for reuse.  The
+   terminating newline is consumed but not stored.  Set *EOF to TRUE if
+   the stream ran out before a newline was found.  Error out if the line
+   exceeds MAX_LINE_LEN. */
+static svn_error_t *
+read_line(svn_stringbuf_t *linebuf,
+          svn_boolean_t *eof,
+          svn_stream_t *stream)
+{
+  svn_stringbuf_setempty(linebuf);
+  *eof = FALSE;
+
+  while (1)
+    {
+      char c;
+      apr_size_t len = 1;
+
+      SVN_ERR(svn_stream_read_full(stream, &c, &len));
+      if (len != 1)
+        {
+          *eof = TRUE;
+          break;
+        }
+
+      if (c == '\n')
+        break;
+
+      if (linebuf->len >= MAX_LINE_LEN)
+        return svn_error_create(SVN_ERR_STREAM_MALFORMED_DATA, NULL,
+                                _("Line in dumpstream exceeds the maximum "
+                                  "supported line length"));
+
+      svn_stringbuf_appendbyte(linebuf, c);
+    }
+
+  return SVN_NO_ERROR;
+}
+
 /* Allocate a new hash *HEADERS in POOL, and read a series of
    RFC822-style headers from STREAM.  Duplicate each header's name and
    value into POOL and store in hash as a const char * ==> const char *.
 
+   On entry, LINEBUF contains the first header line, already read by the
+   caller.  It is reused as scratch space for the remaining lines, so
+   its contents are undefined upon return.
+
    The headers are assumed to be terminated by a single blank line,
    which will be permanently sucked from the stream and tossed.
-
-   If the caller has already read in the first header line, it should
-   be passed in as FIRST_HEADER.  If not, pass NULL instead.
  */
 static svn_error_t *
 read_header_block(svn_stream_t *stream,
-                  svn_stringbuf_t *first_header,
+                  svn_stringbuf_t *linebuf,
                   apr_hash_t **headers,
                   apr_pool_t *pool)
 {
+  svn_boolean_t first_header = TRUE;
+
   *headers = apr_hash_make(pool);
 
   while (1)
     {
-      svn_stringbuf_t *header_str;
       const char *name, *value;
       svn_boolean_t eof;
       apr_size_t i = 0;
 
-      if (first_header != NULL)
+      if (first_header)
         {
-          header_str = first_header;
-          first_header = NULL;  /* so we never visit this block again. */
+          first_header = FALSE;  /* so we never visit this block again. */
           eof = FALSE;
         }
 
       else
-        /* Read the next line into a stringbuf. */
-        SVN_ERR(svn_stream_readline(stream, &header_str, "\n", &eof, pool));
+        /* Read the next line into the reusable line buffer. */
+        SVN_ERR(read_line(linebuf, &eof, stream));
 
-      if (svn_stringbuf_isempty(header_str))
+      if (svn_stringbuf_isempty(linebuf))
         break;    /* end of header block */
       else if (eof)
         return stream_ran_dry();
 
       /* Find the next colon in the stringbuf. */
-      while (header_str->data[i] != ':')
+      while (linebuf->data[i] != ':')
         {
-          if (header_str->data[i] == '\0')
+          if (linebuf->data[i] == '\0')
             return svn_error_createf(SVN_ERR_STREAM_MALFORMED_DATA, NULL,
                                      _("Dump stream contains a malformed "
                                        "header (with no ':') at '%.20s'"),
-                                     header_str->data);
+                                     linebuf->data);
           i++;
         }
       /* Create a 'name' string and point to it. */
-      header_str->data[i] = '\0';
-      name = header_str->data;
+      linebuf->data[i] = '\0';
+      name = linebuf->data;
 
       /* Skip over the NULL byte and the space following it.  */
       i += 2;
-      if (i > header_str->len)
+      if (i > linebuf->len)
         return svn_error_createf(SVN_ERR_STREAM_MALFORMED_DATA, NULL,
                                  _("Dump stream contains a malformed "
                                    "header (with no value) at '%.20s'"),
-                                 header_str->data);
+                                 linebuf->data);
 
       /* Point to the 'value' string. */
-      value = header_str->data + i;
+      value = linebuf->data + i;
 
-      /* Store name/value in hash. */
-      svn_hash_sets(*headers, name, value);
+      /* LINEBUF will be overwritten by the next line, so give the hash
+         its own copy of the data. */
+      svn_hash_sets(*headers, apr_pstrdup(pool, name),
+                    apr_pstrdup(pool, value));
     }
 
   return SVN_NO_ERROR;
@@ -137,7 +185,9 @@ read_key_or_val(char **pbuf,
                 apr_size_t len,
                 apr_pool_t *pool)
 {
-  char *buf = apr_pcalloc(pool, len + 1);
+  /* No need to zero out the buffer: we overwrite all of it below, and
+     property values can be huge, making the memset pure overhead. */
+  char *buf = apr_palloc(pool, len + 1);
   apr_size_t numread;
   char c;
 
@@ -181,7 +231,9 @@ parse_property_block(svn_stream_t *stream,
                      svn_filesize_t *actual_length,
                      apr_pool_t *pool)
 {
-  svn_stringbuf_t *strbuf;
+  /* The meta data lines are tiny, so one reusable buffer serves all of
+     them without any per-property allocations. */
+  svn_stringbuf_t *strbuf = svn_stringbuf_create_empty(pool);
   apr_pool_t *proppool = svn_pool_create(pool);
 
   *actual_length = 0;
@@ -193,7 +245,7 @@ parse_property_block(svn_stream_t *stream,
       svn_pool_clear(proppool);
 
       /* Read a key length line.  (Actually, it might be PROPS_END). */
-      SVN_ERR(svn_stream_readline(stream, &strbuf, "\n", &eof, proppool));
+      SVN_ERR(read_line(strbuf, &eof, stream));
 
       if (eof)
         {
@@ -220,7 +272,7 @@ parse_property_block(svn_stream_t *stream,
                                   stream, (apr_size_t)len, proppool));
 
           /* Read a val length line */
-          SVN_ERR(svn_stream_readline(stream, &strbuf, "\n", &eof, proppool));
+          SVN_ERR(read_line(strbuf, &eof, stream));
           if (eof)
             return stream_ran_dry();
 
@@ -373,11 +425,9 @@ parse_format_version(int *version,
      This is particularly troublesome, because users may incorrectly attempt
      to load arbitrary large files instead of proper dump files.
 
-     As a workaround, parse the first line with a length limit.  While this
-     is not a complete solution, doing so handles the common case described
-     above.  For a complete solution, svn_stream_readline() may need to grow
-     a `limit` argument that would allow us to safely use it everywhere within
-     this parser.
+     As a workaround, parse the first line with a tight length limit; the
+     rest of the parser reads all lines through read_line() above, which
+     enforces a more generous limit of its own.
    */
   linebuf = svn_stringbuf_create_empty(scratch_pool);
   while (1)
@@ -567,7 +617,7 @@ svn_repos_parse_dumpstream3(svn_stream_t *stream,
                             apr_pool_t *pool)
 {
   svn_boolean_t eof;
-  svn_stringbuf_t *linebuf;
+  svn_stringbuf_t *linebuf = svn_stringbuf_create_empty(pool);
   void *rev_baton = NULL;
   char *buffer = apr_palloc(pool, SVN__STREAM_CHUNK_SIZE);
   apr_size_t buflen = SVN__STREAM_CHUNK_SIZE;
@@ -622,7 +672,7 @@ svn_repos_parse_dumpstream3(svn_stream_t *stream,
 
       /* Keep reading blank lines until we discover a new record, or until
          the stream runs out. */
-      SVN_ERR(svn_stream_readline(stream, &linebuf, "\n", &eof, linepool));
+      SVN_ERR(read_line(linebuf, &eof, stream));
 
       if (eof)
         {
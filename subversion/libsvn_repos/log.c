@@ -40,6 +40,7 @@
 #include "repos.h"
 #include "private/svn_fspath.h"
 #include "private/svn_fs_private.h"
+#include "private/svn_fs_fs_private.h"
 #include "private/svn_mergeinfo_private.h"
 #include "private/svn_subr_private.h"
 #include "private/svn_sorts_private.h"
@@ -2297,6 +2298,98 @@ get_paths_history_as_mergeinfo(svn_mergeinfo_t *paths_history_mergeinfo,
   return SVN_NO_ERROR;
 }
 
+/* Try to answer a strict-history log query for the single FSPATH between
+   START and END (ascending, both valid) using the filesystem's optional
+   changed-paths index.  If the index exists and covers the range, send
+   the matching revisions through CALLBACKS -- in descending order if
+   DESCENDING_ORDER is set, at most LIMIT revisions if LIMIT is greater
+   than 0 -- and set *SENT to TRUE.  Otherwise, set *SENT to FALSE
+   without sending anything, so the caller can fall back to the history
+   crawl in do_logs().  REVPROPS is interpreted as in do_logs(). */
+static svn_error_t *
+do_logs_indexed(svn_boolean_t *sent,
+                svn_fs_t *fs,
+                const char *fspath,
+                svn_revnum_t start,
+                svn_revnum_t end,
+                int limit,
+                const apr_array_header_t *revprops,
+                svn_boolean_t descending_order,
+                const log_callbacks_t *callbacks,
+                apr_pool_t *scratch_pool)
+{
+  svn_fs_fs__ioctl_query_paths_index_input_t input;
+  svn_fs_fs__ioctl_query_paths_index_output_t *output;
+  svn_node_kind_t kind;
+  svn_fs_root_t *root;
+  apr_array_header_t *revs;
+  apr_pool_t *iterpool;
+  svn_error_t *err;
+  int i;
+
+  *sent = FALSE;
+
+  /* The history reported below is anchored on FSPATH@END.  If the path
+     does not exist there, fall back so that the error gets raised by
+     the same code as before. */
+  SVN_ERR(svn_fs_revision_root(&root, fs, end, scratch_pool));
+  SVN_ERR(svn_fs_check_path(&kind, root, fspath, scratch_pool));
+  if (kind == svn_node_none)
+    return SVN_NO_ERROR;
+
+  input.path = fspath;
+  input.start_rev = start;
+  input.end_rev = end;
+  err = svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_QUERY_PATHS_INDEX, &input,
+                     (void **)&output, NULL, NULL, scratch_pool,
+                     scratch_pool);
+  if (err && err->apr_err == SVN_ERR_FS_UNRECOGNIZED_IOCTL_CODE)
+    {
+      /* Not an FSFS filesystem; it cannot have such an index. */
+      svn_error_clear(err);
+      return SVN_NO_ERROR;
+    }
+  SVN_ERR(err);
+
+  /* No index, or it does not cover END, yet. */
+  if (!output->hits)
+    return SVN_NO_ERROR;
+
+  /* Collect the revisions to report, youngest first.  Walking towards
+     the past, the revision that brought FSPATH into existence under
+     this name (a copy or plain add of the path itself or of one of its
+     parents) is part of its history and concludes the strict crawl. */
+  revs = apr_array_make(scratch_pool, output->hits->nelts,
+                        sizeof(svn_revnum_t));
+  for (i = output->hits->nelts - 1; i >= 0; --i)
+    {
+      svn_fs_fs__paths_index_hit_t *hit
+        = APR_ARRAY_IDX(output->hits, i, svn_fs_fs__paths_index_hit_t *);
+
+      if (hit->self_or_below || hit->added_here)
+        APR_ARRAY_PUSH(revs, svn_revnum_t) = hit->revision;
+      if (hit->added_here)
+        break;
+    }
+
+  iterpool = svn_pool_create(scratch_pool);
+  for (i = 0; i < revs->nelts && (limit <= 0 || i < limit); ++i)
+    {
+      svn_revnum_t rev = descending_order
+                       ? APR_ARRAY_IDX(revs, i, svn_revnum_t)
+                       : APR_ARRAY_IDX(revs, revs->nelts - 1 - i,
+                                       svn_revnum_t);
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(send_log(rev, fs, NULL, NULL, FALSE, FALSE,
+                       revprops, FALSE, callbacks, iterpool));
+    }
+  svn_pool_destroy(iterpool);
+
+  *sent = TRUE;
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_repos_get_logs5(svn_repos_t *repos,
                     const apr_array_header_t *paths,
@@ -2454,6 +2547,25 @@ svn_repos_get_logs5(svn_repos_t *repos,
       svn_pool_destroy(subpool);
     }
 
+  /* For the common "svn log --stop-on-copy PATH" shape of query, give
+     the optional FSFS changed-paths index a shot before falling back to
+     the revision-by-revision history crawl.  Authz'ed queries keep
+     using do_logs() which checks every revision along the history. */
+  if (!include_merged_revisions && strict_node_history
+      && !authz_read_func && paths->nelts == 1)
+    {
+      svn_boolean_t sent;
+      const char *fspath
+        = svn_fspath__canonicalize(APR_ARRAY_IDX(paths, 0, const char *),
+                                   scratch_pool);
+
+      SVN_ERR(do_logs_indexed(&sent, fs, fspath, start, end, limit,
+                              revprops, descending_order, &callbacks,
+                              scratch_pool));
+      if (sent)
+        return SVN_NO_ERROR;
+    }
+
   return do_logs(repos->fs, paths, paths_history_mergeinfo, NULL, NULL,
                  start, end, limit, strict_node_history,
                  include_merged_revisions, FALSE, FALSE, FALSE,
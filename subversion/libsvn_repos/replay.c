@@ -914,18 +914,22 @@ get_relevant_changes(apr_hash_t **changed_paths,
   return SVN_NO_ERROR;
 }
 
-svn_error_t *
-svn_repos_replay2(svn_fs_root_t *root,
-                  const char *base_path,
-                  svn_revnum_t low_water_mark,
-                  svn_boolean_t send_deltas,
-                  const svn_delta_editor_t *editor,
-                  void *edit_baton,
-                  svn_repos_authz_func_t authz_read_func,
-                  void *authz_read_baton,
-                  apr_pool_t *pool)
+/* Common implementation of svn_repos_replay2() and one iteration of
+   svn_repos_replay_range().  If COMPARE_ROOT is not NULL, use it as the
+   delta base root instead of opening the base revision root ourselves;
+   it must then refer to ROOT's base revision. */
+static svn_error_t *
+replay_revision(svn_fs_root_t *root,
+                const char *base_path,
+                svn_revnum_t low_water_mark,
+                svn_boolean_t send_deltas,
+                svn_fs_root_t *compare_root,
+                const svn_delta_editor_t *editor,
+                void *edit_baton,
+                svn_repos_authz_func_t authz_read_func,
+                void *authz_read_baton,
+                apr_pool_t *pool)
 {
-#ifndef USE_EV2_IMPL
   apr_hash_t *changed_paths;
   apr_array_header_t *paths;
   struct path_driver_cb_baton cb_baton;
@@ -964,12 +968,15 @@ svn_repos_replay2(svn_fs_root_t *root,
 
   if (send_deltas)
     {
-      SVN_ERR(svn_fs_revision_root(&cb_baton.compare_root,
-                                   svn_fs_root_fs(root),
-                                   svn_fs_is_revision_root(root)
-                                     ? svn_fs_revision_root_revision(root) - 1
-                                     : svn_fs_txn_root_base_revision(root),
-                                   pool));
+      if (compare_root)
+        cb_baton.compare_root = compare_root;
+      else
+        SVN_ERR(svn_fs_revision_root(&cb_baton.compare_root,
+                                     svn_fs_root_fs(root),
+                                     svn_fs_is_revision_root(root)
+                                       ? svn_fs_revision_root_revision(root) - 1
+                                       : svn_fs_txn_root_base_revision(root),
+                                     pool));
     }
 
   cb_baton.copies = apr_array_make(pool, 4, sizeof(struct copy_info *));
@@ -987,6 +994,24 @@ svn_repos_replay2(svn_fs_root_t *root,
   return svn_delta_path_driver3(editor, edit_baton,
                                 paths, TRUE,
                                 path_driver_cb_func, &cb_baton, pool);
+}
+
+svn_error_t *
+svn_repos_replay2(svn_fs_root_t *root,
+                  const char *base_path,
+                  svn_revnum_t low_water_mark,
+                  svn_boolean_t send_deltas,
+                  const svn_delta_editor_t *editor,
+                  void *edit_baton,
+                  svn_repos_authz_func_t authz_read_func,
+                  void *authz_read_baton,
+                  apr_pool_t *pool)
+{
+#ifndef USE_EV2_IMPL
+  return svn_error_trace(replay_revision(root, base_path, low_water_mark,
+                                         send_deltas, NULL, editor,
+                                         edit_baton, authz_read_func,
+                                         authz_read_baton, pool));
 #else
   svn_editor_t *editorv2;
   struct svn_delta__extra_baton *exb;
@@ -1046,6 +1071,74 @@ svn_repos_replay2(svn_fs_root_t *root,
 #endif
 }
 
+svn_error_t *
+svn_repos_replay_range(svn_repos_t *repos,
+                       const char *base_dir,
+                       svn_revnum_t start_revision,
+                       svn_revnum_t end_revision,
+                       svn_revnum_t low_water_mark,
+                       svn_boolean_t send_deltas,
+                       svn_repos_replay_revstart_callback_t revstart_func,
+                       svn_repos_replay_revfinish_callback_t revfinish_func,
+                       void *replay_baton,
+                       svn_repos_authz_func_t authz_read_func,
+                       void *authz_read_baton,
+                       apr_pool_t *scratch_pool)
+{
+  svn_fs_t *fs = svn_repos_fs(repos);
+  svn_fs_root_t *prev_root = NULL;
+
+  /* We keep each revision's root alive into the following iteration to
+     serve as that revision's delta base, so per-revision data must live
+     in two alternating subpools. */
+  apr_pool_t *subpools[2];
+  svn_revnum_t rev;
+
+  SVN_ERR_ASSERT(SVN_IS_VALID_REVNUM(start_revision)
+                 && SVN_IS_VALID_REVNUM(end_revision)
+                 && start_revision <= end_revision);
+
+  subpools[0] = svn_pool_create(scratch_pool);
+  subpools[1] = svn_pool_create(scratch_pool);
+
+  for (rev = start_revision; rev <= end_revision; rev++)
+    {
+      apr_pool_t *iterpool = subpools[rev & 1];
+      svn_fs_root_t *root;
+      apr_hash_t *rev_props;
+      const svn_delta_editor_t *editor;
+      void *edit_baton;
+
+      /* The previous iteration in this pool ended two revisions ago, so
+         nothing in here is referenced anymore. */
+      svn_pool_clear(iterpool);
+
+      SVN_ERR(svn_fs_revision_root(&root, fs, rev, iterpool));
+      SVN_ERR(svn_repos_fs_revision_proplist(&rev_props, repos, rev,
+                                             authz_read_func,
+                                             authz_read_baton, iterpool));
+
+      SVN_ERR(revstart_func(rev, replay_baton, &editor, &edit_baton,
+                            rev_props, iterpool));
+
+      /* PREV_ROOT is exactly REV's base revision root and, having just
+         driven the previous edit, comes with warm node caches. */
+      SVN_ERR(replay_revision(root, base_dir, low_water_mark, send_deltas,
+                              prev_root, editor, edit_baton,
+                              authz_read_func, authz_read_baton, iterpool));
+
+      SVN_ERR(revfinish_func(rev, replay_baton, editor, edit_baton,
+                             rev_props, iterpool));
+
+      prev_root = root;
+    }
+
+  svn_pool_destroy(subpools[0]);
+  svn_pool_destroy(subpools[1]);
+
+  return SVN_NO_ERROR;
+}
+
 
 /*****************************************************************
  *                      Ev2 Implementation                       *
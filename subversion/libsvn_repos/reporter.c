@@ -883,6 +883,86 @@ add_file_smartly(report_baton_t *b,
 }
 
 
+/* Set *UNCHANGED to TRUE if the directories S_PATH in S_ROOT and
+   T_PATH in T_ROOT have equal subtrees, i.e. the same properties and
+   the same entry list, with each entry pair either sharing a node
+   revision id or, recursively, having equal subtrees themselves (file
+   pairs are compared by props and contents).  A shared id proves the
+   respective subtree equal, so we never descend into one; the first
+   difference found ends the walk as well.  Use POOL for temporary
+   allocations. */
+static svn_error_t *
+subtree_unchanged(svn_boolean_t *unchanged,
+                  svn_fs_root_t *s_root, const char *s_path,
+                  svn_fs_root_t *t_root, const char *t_path,
+                  apr_pool_t *pool)
+{
+  apr_hash_t *s_entries, *t_entries;
+  apr_hash_index_t *hi;
+  apr_pool_t *subpool;
+  svn_boolean_t changed;
+
+  *unchanged = FALSE;
+
+  SVN_ERR(svn_fs_props_changed(&changed, s_root, s_path, t_root, t_path,
+                               pool));
+  if (changed)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_fs_dir_entries(&s_entries, s_root, s_path, pool));
+  SVN_ERR(svn_fs_dir_entries(&t_entries, t_root, t_path, pool));
+  if (apr_hash_count(s_entries) != apr_hash_count(t_entries))
+    return SVN_NO_ERROR;
+
+  subpool = svn_pool_create(pool);
+  for (hi = apr_hash_first(pool, t_entries); hi; hi = apr_hash_next(hi))
+    {
+      const svn_fs_dirent_t *t_entry = apr_hash_this_val(hi);
+      const svn_fs_dirent_t *s_entry
+        = apr_hash_get(s_entries, apr_hash_this_key(hi),
+                       apr_hash_this_key_len(hi));
+      const char *s_fullpath, *t_fullpath;
+
+      if (!s_entry || s_entry->kind != t_entry->kind)
+        break;
+
+      /* A shared id means shared storage; those subtrees must match. */
+      if (svn_fs_compare_ids(s_entry->id, t_entry->id) == 0)
+        continue;
+
+      svn_pool_clear(subpool);
+      s_fullpath = svn_fspath__join(s_path, t_entry->name, subpool);
+      t_fullpath = svn_fspath__join(t_path, t_entry->name, subpool);
+
+      if (t_entry->kind == svn_node_dir)
+        {
+          svn_boolean_t sub_unchanged;
+
+          SVN_ERR(subtree_unchanged(&sub_unchanged, s_root, s_fullpath,
+                                    t_root, t_fullpath, subpool));
+          if (!sub_unchanged)
+            break;
+        }
+      else
+        {
+          SVN_ERR(svn_fs_props_changed(&changed, s_root, s_fullpath,
+                                       t_root, t_fullpath, subpool));
+          if (!changed)
+            SVN_ERR(svn_fs_contents_changed(&changed, s_root, s_fullpath,
+                                            t_root, t_fullpath, subpool));
+          if (changed)
+            break;
+        }
+    }
+  svn_pool_destroy(subpool);
+
+  /* HI is NULL iff we ran out of entries without finding a difference. */
+  *unchanged = (hi == NULL);
+
+  return SVN_NO_ERROR;
+}
+
+
 /* Emit a series of editing operations to transform a source entry to
    a target entry.
 
@@ -981,6 +1061,27 @@ update_entry(report_baton_t *b, svn_revnum_t s_rev, const char *s_path,
                                             b->t_root, t_path, pool));
         }
 
+      /* Directory copies get the same treatment: if the copied subtree
+       * is entirely unchanged, reporting it would only open and close a
+       * chain of directories without emitting any real change.  Only
+       * probe when the conditions below would otherwise let us skip the
+       * entry; a shared id below the copy root ends the probe early, so
+       * its cost is proportional to the changed part of the subtree. */
+      if (!b->ignore_ancestry && t_entry->kind == svn_node_dir
+          && distance == 1
+          && !any_path_info(b, e_path)
+          && requested_depth <= wc_depth)
+        {
+          svn_boolean_t unchanged;
+
+          if (s_root == NULL)
+            SVN_ERR(get_source_root(b, &s_root, s_rev));
+
+          SVN_ERR(subtree_unchanged(&unchanged, s_root, s_path,
+                                    b->t_root, t_path, pool));
+          changed = !unchanged;
+        }
+
       if ((distance == 0 || !changed) && !any_path_info(b, e_path)
           && (requested_depth <= wc_depth || t_entry->kind == svn_node_file))
         {
@@ -878,6 +878,13 @@ create_conf(svn_repos_t *repos, apr_pool_t *pool)
 "### Unless you specify an absolute path, the file's location is relative"   NL
 "### to the directory containing this file."                                 NL
 "# hooks-env = " SVN_REPOS__CONF_HOOKS_ENV                                   NL
+"### The bulk-rate-limit option caps the rate, in KiB per second, at"        NL
+"### which svnserve sends data while serving bulk revision-streaming"        NL
+"### commands (replay, replay-range, get-file-revs), so that e.g. a"         NL
+"### full svnsync or svnrdump export cannot starve interactive clients"      NL
+"### of server I/O.  Interactive commands are never throttled."              NL
+"### The default is 0, meaning no limit."                                    NL
+"# bulk-rate-limit = 0"                                                      NL
 ""                                                                           NL
 "[sasl]"                                                                     NL
 "### This option specifies whether you want to use the Cyrus SASL"           NL
@@ -979,7 +986,16 @@ create_conf(svn_repos_t *repos, apr_pool_t *pool)
 ""                                                                           NL
 "### This sets the PATH environment variable for the pre-commit hook."       NL
 "[pre-commit]"                                                               NL
-"PATH = /usr/local/bin:/usr/bin:/usr/sbin"                                   NL;
+"PATH = /usr/local/bin:/usr/bin:/usr/sbin"                                   NL
+""                                                                           NL
+"### The special option SVN_HOOK_SERVER does not name an environment"        NL
+"### variable.  If it is set in a hook's section, the hook script is not"    NL
+"### executed; instead the hook's name, arguments and stdin are sent to a"   NL
+"### long-lived hook server listening on the named Unix-domain socket,"      NL
+"### which responds with an exit code, stderr and stdout.  This avoids"      NL
+"### paying interpreter startup costs on every hook invocation.  The hook"   NL
+"### script file must still exist for the hook to be considered enabled."    NL
+"# SVN_HOOK_SERVER = /var/run/svn-hook-server.sock"                          NL;
 
     SVN_ERR_W(svn_io_file_create(svn_dirent_join(repos->conf_path,
                                                  SVN_REPOS__CONF_HOOKS_ENV \
@@ -1028,12 +1044,78 @@ create_svn_repos_t(const char *path, apr_pool_t *pool)
   repos->lock_path = svn_dirent_join(path, SVN_REPOS__LOCK_DIR, pool);
   repos->hooks_env_path = NULL;
   repos->repository_capabilities = apr_hash_make(pool);
+  repos->commit_subscribers = NULL;
   repos->pool = pool;
 
   return repos;
 }
 
 
+void
+svn_repos__subscribe_to_commits(svn_repos_t *repos,
+                                svn_repos__commit_notify_func_t notify_func,
+                                void *notify_baton)
+{
+  svn_repos__commit_subscriber_t *subscriber;
+
+  if (repos->commit_subscribers == NULL)
+    repos->commit_subscribers
+      = apr_array_make(repos->pool, 1,
+                       sizeof(svn_repos__commit_subscriber_t));
+
+  subscriber = apr_array_push(repos->commit_subscribers);
+  subscriber->notify_func = notify_func;
+  subscriber->notify_baton = notify_baton;
+}
+
+svn_error_t *
+svn_repos__notify_commit_subscribers(svn_repos_t *repos,
+                                     svn_revnum_t revision,
+                                     apr_pool_t *scratch_pool)
+{
+  svn_fs_root_t *rev_root;
+  svn_fs_path_change_iterator_t *iterator;
+  svn_fs_path_change3_t *change;
+  apr_hash_t *changed_paths;
+  int i;
+
+  if (repos->commit_subscribers == NULL
+      || repos->commit_subscribers->nelts == 0)
+    return SVN_NO_ERROR;
+
+  /* Materialize the changed-paths list once for all subscribers.  This
+     does not re-read the revision from disk: right after the commit,
+     the changes are still in the FS caches. */
+  SVN_ERR(svn_fs_revision_root(&rev_root, repos->fs, revision,
+                               scratch_pool));
+  SVN_ERR(svn_fs_paths_changed3(&iterator, rev_root, scratch_pool,
+                                scratch_pool));
+
+  changed_paths = apr_hash_make(scratch_pool);
+  SVN_ERR(svn_fs_path_change_get(&change, iterator));
+  while (change)
+    {
+      svn_fs_path_change3_t *copy
+        = svn_fs_path_change3_dup(change, scratch_pool);
+
+      apr_hash_set(changed_paths, copy->path.data, copy->path.len, copy);
+      SVN_ERR(svn_fs_path_change_get(&change, iterator));
+    }
+
+  for (i = 0; i < repos->commit_subscribers->nelts; i++)
+    {
+      const svn_repos__commit_subscriber_t *subscriber
+        = &APR_ARRAY_IDX(repos->commit_subscribers, i,
+                         svn_repos__commit_subscriber_t);
+
+      SVN_ERR(subscriber->notify_func(subscriber->notify_baton, revision,
+                                      changed_paths, scratch_pool));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+
 static svn_error_t *
 create_repos_structure(svn_repos_t *repos,
                        const char *path,
@@ -29,6 +29,8 @@
 #include "svn_fs.h"
 #include "svn_config.h"
 
+#include "private/svn_repos_private.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -92,6 +94,10 @@ extern "C" {
 #define SVN_REPOS__CONF_HOOKS_ENV "hooks-env"
 /* The name of the default section in the hooks-env config file. */
 #define SVN_REPOS__HOOKS_ENV_DEFAULT_SECTION "default"
+/* The hooks-env option which, when set in a hook's section, names the
+ * Unix-domain socket of a long-lived hook server that handles the hook
+ * instead of the hook script being executed. */
+#define SVN_REPOS__HOOKS_ENV_HOOK_SERVER "SVN_HOOK_SERVER"
 
 /* The configuration file for svnserve, in the repository conf directory. */
 #define SVN_REPOS__CONF_SVNSERVE_CONF "svnserve.conf"
@@ -103,6 +109,14 @@ extern "C" {
 #define SVN_REPOS__CONF_AUTHZ "authz"
 #define SVN_REPOS__CONF_GROUPS "groups"
 
+/* One in-process commit notification subscriber, as registered by
+   svn_repos__subscribe_to_commits(). */
+typedef struct svn_repos__commit_subscriber_t
+{
+  svn_repos__commit_notify_func_t notify_func;
+  void *notify_baton;
+} svn_repos__commit_subscriber_t;
+
 /* The Repository object, created by svn_repos_open2() and
    svn_repos_create(). */
 struct svn_repos_t
@@ -153,6 +167,12 @@ struct svn_repos_t
      those constants' addresses, therefore). */
   apr_hash_t *repository_capabilities;
 
+  /* In-process observers to notify after every successful commit made
+     through this object, in subscription order.  Elements are of type
+     svn_repos__commit_subscriber_t.  NULL if nobody ever subscribed;
+     see svn_repos__subscribe_to_commits(). */
+  apr_array_header_t *commit_subscribers;
+
   /* Pool from which this structure was allocated.  Also used for
      auxiliary repository-related data that requires a matching
      lifespan.  (As the svn_repos_t structure tends to be relatively
@@ -161,6 +181,18 @@ struct svn_repos_t
 };
 
 
+/* Notify all subscribers of REPOS (if any) that REVISION has just been
+   committed, handing each of them the revision's changed-paths list.
+   The list is materialized at most once and only if there are
+   subscribers; right after a commit it is served from the FS caches.
+
+   Use SCRATCH_POOL for temporary allocations.  */
+svn_error_t *
+svn_repos__notify_commit_subscribers(svn_repos_t *repos,
+                                     svn_revnum_t revision,
+                                     apr_pool_t *scratch_pool);
+
+
 /*** Hook-running Functions ***/
 
 /* Set *HOOKS_ENV_P to the parsed contents of the hooks-env file
@@ -491,6 +491,193 @@ svn_auth_ssl_server_cert_info_dup
   return new_info;
 }
 
+#if defined(SVN_HAVE_GNOME_KEYRING) || defined(SVN_HAVE_KWALLET) || defined (SVN_HAVE_LIBSECRET)
+
+/* Baton for the lazy wrapper around auth providers implemented in a
+   separately loaded DSO.  Loading such a DSO may drag in large GUI
+   toolkit libraries, so we defer it until somebody actually asks for
+   credentials; commands that never authenticate no longer pay for it
+   at startup. */
+typedef struct dso_provider_baton_t
+{
+  /* Name and type the wrapped provider was requested with. */
+  const char *provider_name;
+  const char *provider_type;
+
+  /* The pool this baton (and, on demand, the wrapped provider) is
+     allocated in. */
+  apr_pool_t *pool;
+
+  /* The wrapped provider; NULL until loaded successfully. */
+  svn_auth_provider_object_t *wrapped;
+
+  /* Set after the first load attempt; failures are not retried. */
+  svn_boolean_t load_attempted;
+} dso_provider_baton_t;
+
+/* Load the DSO implementing the provider named PROVIDER_NAME of type
+   PROVIDER_TYPE and set *PROVIDER to it, allocated in POOL.  Set
+   *PROVIDER to NULL if the library or the requested entry point is not
+   available. */
+static svn_error_t *
+load_dso_provider(svn_auth_provider_object_t **provider,
+                  const char *provider_name,
+                  const char *provider_type,
+                  apr_pool_t *pool)
+{
+  apr_dso_handle_t *dso;
+  apr_dso_handle_sym_t provider_function_symbol, version_function_symbol;
+  const char *library_label, *library_name;
+  const char *provider_function_name, *version_function_name;
+
+  *provider = NULL;
+
+  library_name = apr_psprintf(pool,
+                              "libsvn_auth_%s-%d.so.%d",
+                              provider_name,
+                              SVN_VER_MAJOR, SVN_SOVERSION);
+  library_label = apr_psprintf(pool, "svn_%s", provider_name);
+  provider_function_name = apr_psprintf(pool,
+                                        "svn_auth_get_%s_%s_provider",
+                                        provider_name, provider_type);
+  version_function_name = apr_psprintf(pool,
+                                       "svn_auth_%s_version",
+                                       provider_name);
+  SVN_ERR(svn_dso_load(&dso, library_name));
+  if (dso)
+    {
+      if (apr_dso_sym(&version_function_symbol,
+                      dso,
+                      version_function_name) == 0)
+        {
+          svn_version_func_t version_function
+            = version_function_symbol;
+          svn_version_checklist_t check_list[2];
+
+          check_list[0].label = library_label;
+          check_list[0].version_query = version_function;
+          check_list[1].label = NULL;
+          check_list[1].version_query = NULL;
+          SVN_ERR(svn_ver_check_list2(svn_subr_version(), check_list,
+                                      svn_ver_equal));
+        }
+      if (apr_dso_sym(&provider_function_symbol,
+                      dso,
+                      provider_function_name) == 0)
+        {
+          if (strcmp(provider_type, "simple") == 0)
+            {
+              svn_auth_simple_provider_func_t provider_function
+                = provider_function_symbol;
+              provider_function(provider, pool);
+            }
+          else if (strcmp(provider_type, "ssl_client_cert_pw") == 0)
+            {
+              svn_auth_ssl_client_cert_pw_provider_func_t provider_function
+                = provider_function_symbol;
+              provider_function(provider, pool);
+            }
+        }
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Set *WRAPPED to the provider wrapped by BATON, loading it upon the
+   first call.  *WRAPPED will be NULL if the provider is unavailable. */
+static svn_error_t *
+ensure_dso_provider(svn_auth_provider_object_t **wrapped,
+                    dso_provider_baton_t *baton)
+{
+  if (!baton->load_attempted)
+    {
+      baton->load_attempted = TRUE;
+      SVN_ERR(load_dso_provider(&baton->wrapped, baton->provider_name,
+                                baton->provider_type, baton->pool));
+    }
+
+  *wrapped = baton->wrapped;
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_auth_provider_t.first_credentials for the lazy DSO
+   provider wrapper. */
+static svn_error_t *
+dso_provider_first_credentials(void **credentials,
+                               void **iter_baton,
+                               void *provider_baton,
+                               apr_hash_t *parameters,
+                               const char *realmstring,
+                               apr_pool_t *pool)
+{
+  dso_provider_baton_t *baton = provider_baton;
+  svn_auth_provider_object_t *wrapped;
+
+  *credentials = NULL;
+  *iter_baton = NULL;
+
+  SVN_ERR(ensure_dso_provider(&wrapped, baton));
+  if (wrapped == NULL)
+    return SVN_NO_ERROR;
+
+  return svn_error_trace(wrapped->vtable->first_credentials(
+                             credentials, iter_baton,
+                             wrapped->provider_baton, parameters,
+                             realmstring, pool));
+}
+
+/* Implements svn_auth_provider_t.next_credentials for the lazy DSO
+   provider wrapper. */
+static svn_error_t *
+dso_provider_next_credentials(void **credentials,
+                              void *iter_baton,
+                              void *provider_baton,
+                              apr_hash_t *parameters,
+                              const char *realmstring,
+                              apr_pool_t *pool)
+{
+  dso_provider_baton_t *baton = provider_baton;
+  svn_auth_provider_object_t *wrapped;
+
+  *credentials = NULL;
+
+  SVN_ERR(ensure_dso_provider(&wrapped, baton));
+  if (wrapped == NULL || wrapped->vtable->next_credentials == NULL)
+    return SVN_NO_ERROR;
+
+  return svn_error_trace(wrapped->vtable->next_credentials(
+                             credentials, iter_baton,
+                             wrapped->provider_baton, parameters,
+                             realmstring, pool));
+}
+
+/* Implements svn_auth_provider_t.save_credentials for the lazy DSO
+   provider wrapper. */
+static svn_error_t *
+dso_provider_save_credentials(svn_boolean_t *saved,
+                              void *credentials,
+                              void *provider_baton,
+                              apr_hash_t *parameters,
+                              const char *realmstring,
+                              apr_pool_t *pool)
+{
+  dso_provider_baton_t *baton = provider_baton;
+  svn_auth_provider_object_t *wrapped;
+
+  *saved = FALSE;
+
+  SVN_ERR(ensure_dso_provider(&wrapped, baton));
+  if (wrapped == NULL || wrapped->vtable->save_credentials == NULL)
+    return SVN_NO_ERROR;
+
+  return svn_error_trace(wrapped->vtable->save_credentials(
+                             saved, credentials,
+                             wrapped->provider_baton, parameters,
+                             realmstring, pool));
+}
+
+#endif /* SVN_HAVE_GNOME_KEYRING || SVN_HAVE_KWALLET || SVN_HAVE_LIBSECRET */
+
 svn_error_t *
 svn_auth_get_platform_specific_provider(svn_auth_provider_object_t **provider,
                                         const char *provider_name,
@@ -503,57 +690,31 @@ svn_auth_get_platform_specific_provider(svn_auth_provider_object_t **provider,
       apr_strnatcmp(provider_name, "kwallet") == 0)
     {
 #if defined(SVN_HAVE_GNOME_KEYRING) || defined(SVN_HAVE_KWALLET) || defined (SVN_HAVE_LIBSECRET)
-      apr_dso_handle_t *dso;
-      apr_dso_handle_sym_t provider_function_symbol, version_function_symbol;
-      const char *library_label, *library_name;
-      const char *provider_function_name, *version_function_name;
-      library_name = apr_psprintf(pool,
-                                  "libsvn_auth_%s-%d.so.%d",
-                                  provider_name,
-                                  SVN_VER_MAJOR, SVN_SOVERSION);
-      library_label = apr_psprintf(pool, "svn_%s", provider_name);
-      provider_function_name = apr_psprintf(pool,
-                                            "svn_auth_get_%s_%s_provider",
-                                            provider_name, provider_type);
-      version_function_name = apr_psprintf(pool,
-                                           "svn_auth_%s_version",
-                                           provider_name);
-      SVN_ERR(svn_dso_load(&dso, library_name));
-      if (dso)
-        {
-          if (apr_dso_sym(&version_function_symbol,
-                          dso,
-                          version_function_name) == 0)
-            {
-              svn_version_func_t version_function
-                = version_function_symbol;
-              svn_version_checklist_t check_list[2];
-
-              check_list[0].label = library_label;
-              check_list[0].version_query = version_function;
-              check_list[1].label = NULL;
-              check_list[1].version_query = NULL;
-              SVN_ERR(svn_ver_check_list2(svn_subr_version(), check_list,
-                                          svn_ver_equal));
-            }
-          if (apr_dso_sym(&provider_function_symbol,
-                          dso,
-                          provider_function_name) == 0)
-            {
-              if (strcmp(provider_type, "simple") == 0)
-                {
-                  svn_auth_simple_provider_func_t provider_function
-                    = provider_function_symbol;
-                  provider_function(provider, pool);
-                }
-              else if (strcmp(provider_type, "ssl_client_cert_pw") == 0)
-                {
-                  svn_auth_ssl_client_cert_pw_provider_func_t provider_function
-                    = provider_function_symbol;
-                  provider_function(provider, pool);
-                }
-            }
-        }
+      dso_provider_baton_t *baton;
+      svn_auth_provider_t *vtable;
+
+      /* Hand out a cheap wrapper; the DSO gets loaded when credentials
+         are first requested from it. */
+      vtable = apr_pcalloc(pool, sizeof(*vtable));
+      if (strcmp(provider_type, "simple") == 0)
+        vtable->cred_kind = SVN_AUTH_CRED_SIMPLE;
+      else if (strcmp(provider_type, "ssl_client_cert_pw") == 0)
+        vtable->cred_kind = SVN_AUTH_CRED_SSL_CLIENT_CERT_PW;
+      else
+        return SVN_NO_ERROR;  /* same as "provider not available" */
+
+      vtable->first_credentials = dso_provider_first_credentials;
+      vtable->next_credentials = dso_provider_next_credentials;
+      vtable->save_credentials = dso_provider_save_credentials;
+
+      baton = apr_pcalloc(pool, sizeof(*baton));
+      baton->provider_name = apr_pstrdup(pool, provider_name);
+      baton->provider_type = apr_pstrdup(pool, provider_type);
+      baton->pool = pool;
+
+      *provider = apr_pcalloc(pool, sizeof(**provider));
+      (*provider)->vtable = vtable;
+      (*provider)->provider_baton = baton;
 #endif
     }
   else
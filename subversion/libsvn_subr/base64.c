@@ -33,6 +33,7 @@
 #include "svn_io.h"
 #include "svn_error.h"
 #include "svn_base64.h"
+#include "private/svn_atomic.h"
 #include "private/svn_string_private.h"
 #include "private/svn_subr_private.h"
 
@@ -50,6 +51,41 @@
 static const char base64tab[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ" \
                                 "abcdefghijklmnopqrstuvwxyz0123456789+/";
 
+/* Larger lookup tables for the encoding and decoding hot paths, derived
+   from base64tab and reverse_base64, respectively.  They are built on
+   first use because spelling out several KB of generated constants here
+   would be much harder to verify than the 30-odd lines of init code.
+
+   base64_etab maps 12 bits of input to the two corresponding base64
+   chars, halving the number of table lookups per group.
+
+   base64_dtab0..3 map an input char to its 6-bit payload, pre-shifted
+   for the char's position within a group, so that a full group decodes
+   with three ORs.  Invalid chars map to a marker above the 24 payload
+   bits which survives the ORing. */
+#define BASE64_INVALID 0x01000000u
+
+static unsigned char base64_etab[4096][2];
+static apr_uint32_t base64_dtab0[256];
+static apr_uint32_t base64_dtab1[256];
+static apr_uint32_t base64_dtab2[256];
+static apr_uint32_t base64_dtab3[256];
+
+static volatile svn_atomic_t base64_tables_initialized = 0;
+
+/* Build the larger lookup tables above.  Implements
+   svn_atomic__str_init_func_t; defined next to reverse_base64 below. */
+static const char *
+init_base64_tables(void *baton);
+
+/* Make sure the larger lookup tables are ready for use. */
+static APR_INLINE void
+ensure_base64_tables(void)
+{
+  svn_atomic__init_once_no_error(&base64_tables_initialized,
+                                 init_base64_tables, NULL);
+}
+
 
 /* Binary input --> base64-encoded output */
 
@@ -70,19 +106,15 @@ struct encode_baton {
 static APR_INLINE void
 encode_group(const unsigned char *in, char *out)
 {
-  /* Expand input bytes to machine word length (with zero extra cost
-     on x86/x64) ... */
-  apr_size_t part0 = in[0];
-  apr_size_t part1 = in[1];
-  apr_size_t part2 = in[2];
-
-  /* ... to prevent these arithmetic operations from being limited to
-     byte size.  This saves non-zero cost conversions of the result when
-     calculating the addresses within base64tab. */
-  out[0] = base64tab[part0 >> 2];
-  out[1] = base64tab[((part0 & 3) << 4) | (part1 >> 4)];
-  out[2] = base64tab[((part1 & 0xf) << 2) | (part2 >> 6)];
-  out[3] = base64tab[part2 & 0x3f];
+  /* Combine the input bytes into one 24 bit value (expanded to machine
+     word length, which comes at zero extra cost on x86/x64) ... */
+  apr_size_t packed = ((apr_size_t)in[0] << 16)
+                    | ((apr_size_t)in[1] << 8)
+                    | in[2];
+
+  /* ... and translate 12 bits, i.e. two output chars, per lookup. */
+  memcpy(out, base64_etab[packed >> 12], 2);
+  memcpy(out + 2, base64_etab[packed & 0xfff], 2);
 }
 
 /* Base64-encode a line, i.e. BYTES_PER_LINE bytes from DATA into
@@ -257,6 +289,8 @@ svn_base64_encode2(svn_stream_t *output,
   struct encode_baton *eb = apr_palloc(pool, sizeof(*eb));
   svn_stream_t *stream;
 
+  ensure_base64_tables();
+
   eb->output = output;
   eb->buflen = 0;
   eb->linelen = 0;
@@ -279,6 +313,8 @@ svn_base64_encode_string2(const svn_string_t *str,
   size_t ingrouplen = 0;
   size_t linelen = 0;
 
+  ensure_base64_tables();
+
   encode_bytes(encoded, str->data, str->len, ingroup, &ingrouplen, &linelen,
                break_lines);
   encode_partial_group(encoded, ingroup, ingrouplen, linelen,
@@ -339,6 +375,42 @@ static const signed char reverse_base64[256] = {
 -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
 };
 
+/* See the declaration at the top of this file.
+   Implements svn_atomic__str_init_func_t. */
+static const char *
+init_base64_tables(void *baton)
+{
+  int i;
+
+  for (i = 0; i < 4096; i++)
+    {
+      base64_etab[i][0] = (unsigned char)base64tab[i >> 6];
+      base64_etab[i][1] = (unsigned char)base64tab[i & 0x3f];
+    }
+
+  for (i = 0; i < 256; i++)
+    {
+      signed char find = reverse_base64[i];
+
+      if (find < 0)
+        {
+          base64_dtab0[i] = BASE64_INVALID;
+          base64_dtab1[i] = BASE64_INVALID;
+          base64_dtab2[i] = BASE64_INVALID;
+          base64_dtab3[i] = BASE64_INVALID;
+        }
+      else
+        {
+          base64_dtab0[i] = (apr_uint32_t)find << 18;
+          base64_dtab1[i] = (apr_uint32_t)find << 12;
+          base64_dtab2[i] = (apr_uint32_t)find << 6;
+          base64_dtab3[i] = (apr_uint32_t)find;
+        }
+    }
+
+  return NULL;
+}
+
 /* Similar to decode_group but this function also translates the
    6-bit values from the IN buffer before translating them.
    Return FALSE if a non-base64 char (e.g. '=' or new line)
@@ -346,19 +418,20 @@ static const signed char reverse_base64[256] = {
 static APR_INLINE svn_boolean_t
 decode_group_directly(const unsigned char *in, char *out)
 {
-  /* Translate the base64 chars in values [0..63, 0xff] */
-  apr_size_t part0 = (unsigned char)reverse_base64[(unsigned char)in[0]];
-  apr_size_t part1 = (unsigned char)reverse_base64[(unsigned char)in[1]];
-  apr_size_t part2 = (unsigned char)reverse_base64[(unsigned char)in[2]];
-  apr_size_t part3 = (unsigned char)reverse_base64[(unsigned char)in[3]];
-
-  /* Pack 4x6 bits into 3x8.*/
-  out[0] = (char)((part0 << 2) | (part1 >> 4));
-  out[1] = (char)(((part1 & 0xf) << 4) | (part2 >> 2));
-  out[2] = (char)(((part2 & 0x3) << 6) | part3);
-
-  /* FALSE, iff any part is 0xff. */
-  return (part0 | part1 | part2 | part3) != (unsigned char)(-1);
+  /* The tables hold the 6-bit payloads pre-shifted for each position,
+     so three ORs assemble the full 24 bit value. */
+  apr_uint32_t packed = base64_dtab0[in[0]]
+                      | base64_dtab1[in[1]]
+                      | base64_dtab2[in[2]]
+                      | base64_dtab3[in[3]];
+
+  /* Split 24 bits into 3x8. */
+  out[0] = (char)(packed >> 16);
+  out[1] = (char)(packed >> 8);
+  out[2] = (char)packed;
+
+  /* FALSE, iff any char was not a base64 char (e.g. '=' or new line). */
+  return packed < BASE64_INVALID;
 }
 
 /* Base64-encode up to BASE64_LINELEN chars from *DATA and append it to
@@ -506,6 +579,8 @@ svn_base64_decode(svn_stream_t *output, apr_pool_t *pool)
   struct decode_baton *db = apr_palloc(pool, sizeof(*db));
   svn_stream_t *stream;
 
+  ensure_base64_tables();
+
   db->output = output;
   db->buflen = 0;
   db->done = FALSE;
@@ -525,6 +600,8 @@ svn_base64_decode_string(const svn_string_t *str, apr_pool_t *pool)
   int ingrouplen = 0;
   svn_boolean_t done = FALSE;
 
+  ensure_base64_tables();
+
   decode_bytes(decoded, str->data, str->len, ingroup, &ingrouplen, &done);
   return svn_stringbuf__morph_into_string(decoded);
 }
@@ -546,6 +623,8 @@ base64_from_checksum(const svn_checksum_t *checksum, apr_pool_t *pool)
   size_t linelen = 0;
   checksum_str = svn_stringbuf_create_empty(pool);
 
+  ensure_base64_tables();
+
   encode_bytes(checksum_str, checksum->digest,
                svn_checksum_size(checksum), ingroup, &ingrouplen,
                &linelen, TRUE);
@@ -125,10 +125,37 @@
  * is then unique, too, and can never conflict.  No full key construction,
  * storage and comparison is needed in that case.
  *
+ * Tiny items - node-existence answers, ids and similar values of up to
+ * 16 bytes - make up a large share of the entry count on busy servers but
+ * would each still consume a full alignment granule of buffer space plus
+ * the churn of competing for the insertion window.  If such an item's key
+ * is completely described by the fingerprint, we therefore store its data
+ * inline in the directory entry itself.  Inline entries use no buffer
+ * space at all, are marked by a reserved offset value and take part in
+ * neither entry chain; they only compete for directory slots within
+ * their group.
+ *
  * All access to the cached data needs to be serialized. Because we want
  * to scale well despite that bottleneck, we simply segment the cache into
  * a number of independent caches (segments). Items will be multiplexed based
  * on their hash key.
+ *
+ * Segmentation also interacts nicely with NUMA machines: the entry
+ * directory is initialized lazily and the data buffer pages are not
+ * touched before an item gets written to them.  Under the first-touch
+ * placement policy of most OSes, a segment's memory will therefore
+ * gravitate towards the nodes of the threads actually using it.  Admins
+ * of multi-socket servers may increase the segment count beyond the
+ * auto-selected value to strengthen that effect - see
+ * svn_cache__set_global_membuffer_segments().
+ *
+ * In addition, full-item reads first try an optimistic, lock-free path:
+ * each segment maintains a change counter in the style of a seqlock that
+ * writers bump before and after every modification.  A reader snapshots
+ * the counter, copies the data out without taking the segment lock and
+ * only trusts the copy if the counter has not moved in the meantime.
+ * Only when that fails - i.e. when racing an actual write to the same
+ * segment - does the reader fall back to the lock-protected code path.
  */
 
 /* APR's read-write lock implementation on Windows is horribly inefficient.
@@ -190,6 +217,11 @@
  */
 #define NO_INDEX APR_UINT32_MAX
 
+/* Reserved data buffer offset value marking entries whose serialized item
+ * is stored inline in the directory entry instead of the data buffer.
+ */
+#define NO_OFFSET APR_UINT64_MAX
+
 /* To save space in our group structure, we only use 32 bit size values
  * and, therefore, limit the size of each entry to just below 4GB.
  * Supporting larger items is not a good idea as the data transfer
@@ -197,6 +229,14 @@
  */
 #define MAX_ITEM_SIZE ((apr_uint32_t)(0 - ITEM_ALIGNMENT))
 
+/* Serialized items of up to this size get stored directly in the directory
+ * entry instead of the data buffer, provided their full key is completely
+ * described by the fingerprint (see entry_t.small_value).  Keeping this at
+ * ITEM_ALIGNMENT is a natural choice because smaller items could not
+ * occupy less buffer space anyway.
+ */
+#define SMALL_VALUE_SIZE ITEM_ALIGNMENT
+
 /* We use this structure to identify cache entries. There cannot be two
  * entries with the same entry key. However unlikely, though, two different
  * full keys (see full_key_t) may have the same entry key.  That is a
@@ -555,7 +595,8 @@ typedef struct entry_t
   entry_key_t key;
 
   /* The offset of the cached item's serialized data within the caches
-   * DATA buffer.
+   * DATA buffer.  NO_OFFSET for inline entries, i.e. entries whose item
+   * data is stored in SMALL_VALUE instead of the data buffer.
    */
   apr_uint64_t offset;
 
@@ -565,6 +606,17 @@ typedef struct entry_t
    */
   apr_size_t size;
 
+  /* For inline entries, i.e. iff OFFSET is NO_OFFSET, the serialized
+   * item data of SIZE bytes.  KEY.KEY_LEN is always 0 for those entries.
+   * The union member ensures that inline items give at least the same
+   * alignment guarantees as items in the data buffer.
+   */
+  union
+  {
+    char data[SMALL_VALUE_SIZE];
+    apr_uint64_t aligner;
+  } small_value;
+
   /* Number of (read) hits for this entry. Will be reset upon write.
    * Only valid for used entries.
    */
@@ -574,14 +626,15 @@ typedef struct entry_t
    * NO_INDEX indicates the end of the list; this entry must be referenced
    * by the caches cache_level_t.last member.  NO_INDEX also implies that
    * the data buffer is not used beyond offset+size.
-   * Only valid for used entries.
+   * Only valid for used entries.  Always NO_INDEX for inline entries
+   * because they are not linked into any entry chain.
    */
   apr_uint32_t next;
 
   /* Reference to the previous used entry in the order defined by offset.
    * NO_INDEX indicates the end of the list; this entry must be referenced
    * by the caches cache_level_t.first member.
-   * Only valid for used entries.
+   * Only valid for used entries.  Always NO_INDEX for inline entries.
    */
   apr_uint32_t previous;
 
@@ -775,6 +828,15 @@ struct svn_membuffer_t
    */
   apr_uint32_t used_entries;
 
+  /* Number of used dictionary entries and data buffer bytes in use,
+   * broken down by priority class (see priority_class()).
+   * Purely statistical information that may be used for profiling only.
+   * Updates are not synchronized and values may be nonsensicle on some
+   * platforms.
+   */
+  apr_uint32_t used_entries_per_class[3];
+  apr_uint64_t data_used_per_class[3];
+
   /* Total number of calls to membuffer_cache_get.
    * Purely statistical information that may be used for profiling only.
    * Updates are not synchronized and values may be nonsensicle on some
@@ -813,6 +875,16 @@ struct svn_membuffer_t
   svn_boolean_t allow_blocking_writes;
 #endif
 
+  /* Modification counter for this segment, in the style of a seqlock.
+   * It gets bumped once before and once after every modification made
+   * while the write lock is being held, i.e. the value is odd for
+   * exactly as long as a write is in progress.  Readers may snapshot
+   * this value, copy data out without taking the segment lock and then
+   * verify that the value is still the same and even - only then is
+   * the copy known to be consistent.  See membuffer_cache_get_lockfree.
+   */
+  svn_atomic_t change_count;
+
   /* A write lock counter, must be either 0 or 1.
    * This one is only used in debug assertions to verify that you used
    * the correct multi-threading settings. */
@@ -902,6 +974,31 @@ force_write_lock_cache(svn_membuffer_t *cache)
 #endif
 }
 
+/* Read the current value of CACHE's change counter.
+ *
+ * All accesses to the counter go through svn_atomic_cas because mixing
+ * it with the other atomic primitives is not portable (see
+ * svn_atomic.h) and because, unlike a plain atomic read, it comes with
+ * the full memory barrier that the seqlock scheme requires even on
+ * weakly ordered hardware.
+ */
+static APR_INLINE apr_uint32_t
+get_change_count(svn_membuffer_t *cache)
+{
+  return svn_atomic_cas(&cache->change_count, 0, 0);
+}
+
+/* Mark the beginning or the end of a modification of CACHE by bumping
+ * its change counter.  The caller must hold the write lock, making it
+ * the only writer to the counter.
+ */
+static APR_INLINE void
+mark_cache_change(svn_membuffer_t *cache)
+{
+  apr_uint32_t old = get_change_count(cache);
+  svn_atomic_cas(&cache->change_count, old + 1, old);
+}
+
 /* If locking is supported for CACHE, release the current lock
  * (read or write).  Return ERR upon success.
  */
@@ -927,6 +1024,16 @@ unlock_cache(svn_membuffer_t *cache, svn_error_t *err)
 #endif
 }
 
+/* Mark the end of a modification of CACHE and release the write lock,
+ * returning ERR.
+ */
+static svn_error_t *
+unlock_after_write(svn_membuffer_t *cache, svn_error_t *err)
+{
+  mark_cache_change(cache);
+  return unlock_cache(cache, err);
+}
+
 /* If supported, guard the execution of EXPR with a read lock to CACHE.
  * The macro has been modeled after SVN_MUTEX__WITH_LOCK.
  */
@@ -959,7 +1066,8 @@ do {                                                            \
       else                                                      \
         break;                                                  \
     }                                                           \
-  SVN_ERR(unlock_cache(cache, (expr)));                         \
+  mark_cache_change(cache);                                     \
+  SVN_ERR(unlock_after_write(cache, (expr)));                   \
 } while (0)
 
 /* Returns 0 if the entry group identified by GROUP_INDEX in CACHE has not
@@ -1109,7 +1217,18 @@ get_index(svn_membuffer_t *cache, entry_t *entry)
        + (apr_uint32_t)(entry - cache->directory[group_index].entries);
 }
 
-/* Return the cache level of ENTRY in CACHE.
+/* Return whether ENTRY stores its item data inline, i.e. in the
+ * directory entry itself instead of the data buffer.
+ */
+static APR_INLINE svn_boolean_t
+is_inline_entry(const entry_t *entry)
+{
+  return entry->offset == NO_OFFSET;
+}
+
+/* Return the cache level of ENTRY in CACHE.  Inline entries report as
+ * L2, which makes the group eviction heuristics treat them like any
+ * other aged content.
  */
 static cache_level_t *
 get_cache_level(svn_membuffer_t *cache, entry_t *entry)
@@ -1199,6 +1318,20 @@ unchain_entry(svn_membuffer_t *cache,
     get_entry(cache, entry->next)->previous = entry->previous;
 }
 
+/* Map the entry priority PRIORITY onto one of the three standard
+ * priority classes: 0 for low, 1 for default and 2 for high priority.
+ * Aged entries may have in-between values; classify those with the
+ * highest class boundary that they still reach.
+ */
+static APR_INLINE int
+priority_class(apr_uint32_t priority)
+{
+  if (priority <= SVN_CACHE__MEMBUFFER_LOW_PRIORITY)
+    return 0;
+
+  return priority >= SVN_CACHE__MEMBUFFER_HIGH_PRIORITY ? 2 : 1;
+}
+
 /* Remove the used ENTRY from the CACHE, i.e. make it "unused".
  * In contrast to insertion, removal is possible for any entry.
  */
@@ -1215,39 +1348,51 @@ drop_entry(svn_membuffer_t *cache, entry_t *entry)
     = (apr_uint32_t) ((last_group - cache->directory) * GROUP_SIZE
     + last_group->header.used - 1);
 
-  cache_level_t *level = get_cache_level(cache, entry);
-
   /* update global cache usage counters
    */
   cache->used_entries--;
-  cache->data_used -= entry->size;
+  cache->used_entries_per_class[priority_class(entry->priority)]--;
 
-  /* extend the insertion window, if the entry happens to border it
+  /* Inline entries occupy no data buffer space and belong to no entry
+   * chain, so there is neither an insertion window nor a chain to
+   * update for them.
    */
-  if (idx == level->next)
-    level->next = entry->next;
-  else
-    if (entry->next == level->next)
-      {
-        /* insertion window starts right behind the entry to remove
-         */
-        if (entry->previous == NO_INDEX)
-          {
-            /* remove the first entry -> insertion may start at pos 0, now */
-            level->current_data = level->start_offset;
-          }
-        else
+  if (! is_inline_entry(entry))
+    {
+      cache_level_t *level = get_cache_level(cache, entry);
+
+      cache->data_used -= entry->size;
+      cache->data_used_per_class[priority_class(entry->priority)]
+        -= entry->size;
+
+      /* extend the insertion window, if the entry happens to border it
+       */
+      if (idx == level->next)
+        level->next = entry->next;
+      else
+        if (entry->next == level->next)
           {
-            /* insertion may start right behind the previous entry */
-            entry_t *previous = get_entry(cache, entry->previous);
-            level->current_data = ALIGN_VALUE(  previous->offset
-                                              + previous->size);
+            /* insertion window starts right behind the entry to remove
+             */
+            if (entry->previous == NO_INDEX)
+              {
+                /* remove the first entry -> insertion may start at pos 0,
+                 * now */
+                level->current_data = level->start_offset;
+              }
+            else
+              {
+                /* insertion may start right behind the previous entry */
+                entry_t *previous = get_entry(cache, entry->previous);
+                level->current_data = ALIGN_VALUE(  previous->offset
+                                                  + previous->size);
+              }
           }
-      }
 
-  /* unlink it from the chain of used entries
-   */
-  unchain_entry(cache, level, entry, idx);
+      /* unlink it from the chain of used entries
+       */
+      unchain_entry(cache, level, entry, idx);
+    }
 
   /* Move last entry into hole (if the removed one is not the last used).
    * We need to do this since all used entries are at the beginning of
@@ -1259,24 +1404,28 @@ drop_entry(svn_membuffer_t *cache, entry_t *entry)
        */
       *entry = last_group->entries[last_group->header.used-1];
 
-      /* this ENTRY may belong to a different cache level than the entry
-       * we have just removed */
-      level = get_cache_level(cache, entry);
+      /* Inline entries have no chain links that would need fixing up. */
+      if (! is_inline_entry(entry))
+        {
+          /* this ENTRY may belong to a different cache level than the entry
+           * we have just removed */
+          cache_level_t *level = get_cache_level(cache, entry);
 
-      /* update foreign links to new index
-       */
-      if (last_in_group == level->next)
-        level->next = idx;
+          /* update foreign links to new index
+           */
+          if (last_in_group == level->next)
+            level->next = idx;
 
-      if (entry->previous == NO_INDEX)
-        level->first = idx;
-      else
-        get_entry(cache, entry->previous)->next = idx;
+          if (entry->previous == NO_INDEX)
+            level->first = idx;
+          else
+            get_entry(cache, entry->previous)->next = idx;
 
-      if (entry->next == NO_INDEX)
-        level->last = idx;
-      else
-        get_entry(cache, entry->next)->previous = idx;
+          if (entry->next == NO_INDEX)
+            level->last = idx;
+          else
+            get_entry(cache, entry->next)->previous = idx;
+        }
     }
 
   /* Update the number of used entries.
@@ -1314,6 +1463,8 @@ insert_entry(svn_membuffer_t *cache, entry_t *entry)
    */
   cache->used_entries++;
   cache->data_used += entry->size;
+  cache->used_entries_per_class[priority_class(entry->priority)]++;
+  cache->data_used_per_class[priority_class(entry->priority)] += entry->size;
   entry->hit_count = 0;
   group->header.used++;
 
@@ -1327,6 +1478,37 @@ insert_entry(svn_membuffer_t *cache, entry_t *entry)
   assert(level->current_data <= level->start_offset + level->size);
 }
 
+/* Insert ENTRY as an inline entry, i.e. one that stores its item data
+ * in the directory entry itself.  The size, small_value and priority
+ * members must already have been initialized.
+ */
+static void
+insert_inline_entry(svn_membuffer_t *cache, entry_t *entry)
+{
+  /* the group that ENTRY belongs to plus a number of useful index values
+   */
+  apr_uint32_t idx = get_index(cache, entry);
+  apr_uint32_t group_index = idx / GROUP_SIZE;
+  entry_group_t *group = &cache->directory[group_index];
+
+  /* The entry must be the first unused entry in the group.
+   */
+  assert(idx == group_index * GROUP_SIZE + group->header.used);
+
+  /* Inline entries use no data buffer space and no chain links.
+   */
+  entry->offset = NO_OFFSET;
+  entry->next = NO_INDEX;
+  entry->previous = NO_INDEX;
+
+  /* update usage counters
+   */
+  cache->used_entries++;
+  cache->used_entries_per_class[priority_class(entry->priority)]++;
+  entry->hit_count = 0;
+  group->header.used++;
+}
+
 /* Map a KEY of 16 bytes to the CACHE and group that shall contain the
  * respective item.
  */
@@ -1361,7 +1543,25 @@ let_entry_age(svn_membuffer_t *cache, entry_t *entry)
     }
   else
     {
+      int old_class = priority_class(entry->priority);
+      int new_class;
+
       entry->priority /= 2;
+
+      /* Aging may demote the entry into a lower priority class. */
+      new_class = priority_class(entry->priority);
+      if (new_class != old_class)
+        {
+          cache->used_entries_per_class[old_class]--;
+          cache->used_entries_per_class[new_class]++;
+
+          /* Inline entries are not accounted in the data usage stats. */
+          if (! is_inline_entry(entry))
+            {
+              cache->data_used_per_class[old_class] -= entry->size;
+              cache->data_used_per_class[new_class] += entry->size;
+            }
+        }
     }
 }
 
@@ -1910,9 +2110,6 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
          && segment_count < MAX_SEGMENT_COUNT)
     segment_count *= 2;
 
-  /* allocate cache as an array of segments / cache objects */
-  c = apr_palloc(pool, segment_count * sizeof(*c));
-
   /* Split total cache size into segments of equal size
    */
   total_size /= segment_count;
@@ -1963,6 +2160,10 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
   assert(spare_group_count > 0 && main_group_count > 0);
 
   group_init_size = 1 + group_count / (8 * GROUP_INIT_GRANULARITY);
+
+  /* allocate cache as an array of segments / cache objects */
+  c = apr_palloc(pool, segment_count * sizeof(*c));
+
   for (seg = 0; seg < segment_count; ++seg)
     {
       /* allocate buffers and initialize cache members
@@ -2009,6 +2210,10 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
       c[seg].max_entry_size = max_entry_size;
 
       c[seg].used_entries = 0;
+      memset(c[seg].used_entries_per_class, 0,
+             sizeof(c[seg].used_entries_per_class));
+      memset(c[seg].data_used_per_class, 0,
+             sizeof(c[seg].data_used_per_class));
       c[seg].total_reads = 0;
       c[seg].total_writes = 0;
       c[seg].total_hits = 0;
@@ -2045,6 +2250,7 @@ svn_cache__membuffer_cache_create(svn_membuffer_t **cache,
       c[seg].allow_blocking_writes = allow_blocking_writes;
 #endif
       /* No writers at the moment. */
+      c[seg].change_count = 0;
       c[seg].write_lock_count = 0;
     }
 
@@ -2078,6 +2284,7 @@ svn_cache__membuffer_clear(svn_membuffer_t *cache)
     {
       /* Unconditionally acquire the write lock. */
       SVN_ERR(force_write_lock_cache(&cache[seg]));
+      mark_cache_change(&cache[seg]);
 
       /* Mark all groups as "not initialized", which implies "empty". */
       cache[seg].first_spare_group = NO_INDEX;
@@ -2100,9 +2307,13 @@ svn_cache__membuffer_clear(svn_membuffer_t *cache)
       /* Reset content counters. */
       cache[seg].data_used = 0;
       cache[seg].used_entries = 0;
+      memset(cache[seg].used_entries_per_class, 0,
+             sizeof(cache[seg].used_entries_per_class));
+      memset(cache[seg].data_used_per_class, 0,
+             sizeof(cache[seg].data_used_per_class));
 
       /* Segment may be used again. */
-      SVN_ERR(unlock_cache(&cache[seg], SVN_NO_ERROR));
+      SVN_ERR(unlock_after_write(&cache[seg], SVN_NO_ERROR));
     }
 
   /* done here */
@@ -2219,15 +2430,59 @@ membuffer_cache_set_internal(svn_membuffer_t *cache,
       buffer = NULL;
     }
 
+  /* Serialized items that fit into the directory entry bypass the data
+   * buffer entirely.  This requires the key to be fully described by the
+   * fingerprint (KEY_LEN == 0), because there is no room to store it.
+   */
+  if (buffer && size <= SMALL_VALUE_SIZE && !to_find->entry_key.key_len)
+    {
+      /* Drop any old version of that entry and get an unused one for
+       * the key.  This also releases any data buffer space used by a
+       * previous, non-inline incarnation.
+       */
+      entry = find_entry(cache, group_index, to_find, TRUE);
+      entry->size = size;
+      entry->priority = priority;
+      if (size)
+        memcpy(entry->small_value.data, buffer, size);
+
+#ifdef SVN_DEBUG_CACHE_MEMBUFFER
+
+      /* Remember original content, type and key (hashes)
+       */
+      SVN_ERR(store_content_part(tag, buffer, item_size, scratch_pool));
+      memcpy(&entry->tag, tag, sizeof(*tag));
+
+#endif
+
+      /* Update the usage counters.
+       */
+      insert_inline_entry(cache, entry);
+
+      cache->total_writes++;
+
+      /* Putting the decrement into an assert() to make it disappear
+       * in production code. */
+      assert(0 == svn_atomic_dec(&cache->write_lock_count));
+      return SVN_NO_ERROR;
+    }
+
   /* if there is an old version of that entry and the new data fits into
    * the old spot, just re-use that space. */
   if (entry && buffer && ALIGN_VALUE(entry->size) >= size)
     {
+      int old_class = priority_class(entry->priority);
+      int new_class = priority_class(priority);
+
       /* Careful! We need to cast SIZE to the full width of CACHE->DATA_USED
        * lest we run into trouble with 32 bit underflow *not* treated as a
        * negative value.
        */
       cache->data_used += (apr_uint64_t)size - entry->size;
+      cache->used_entries_per_class[old_class]--;
+      cache->used_entries_per_class[new_class]++;
+      cache->data_used_per_class[old_class] -= entry->size;
+      cache->data_used_per_class[new_class] += size;
       entry->size = size;
       entry->priority = priority;
 
@@ -2407,7 +2662,11 @@ membuffer_cache_get_internal(svn_membuffer_t *cache,
 
   size = ALIGN_VALUE(entry->size) - entry->key.key_len;
   *buffer = apr_palloc(result_pool, size);
-  memcpy(*buffer, cache->data + entry->offset + entry->key.key_len, size);
+  memcpy(*buffer,
+         is_inline_entry(entry)
+           ? entry->small_value.data
+           : cache->data + entry->offset + entry->key.key_len,
+         size);
 
 #ifdef SVN_DEBUG_CACHE_MEMBUFFER
 
@@ -2433,6 +2692,169 @@ membuffer_cache_get_internal(svn_membuffer_t *cache,
   return SVN_NO_ERROR;
 }
 
+#ifndef SVN_DEBUG_CACHE_MEMBUFFER
+
+/* Optimistic, lock-free variant of membuffer_cache_get_internal: look
+ * for the entry identified by TO_FIND in group GROUP_INDEX of CACHE and
+ * copy its serialized data out without taking the segment lock.  The
+ * copy is then validated against the segment's change counter: if any
+ * write began or completed in the meantime, it must be considered
+ * garbage.
+ *
+ * Return TRUE upon a consistent result (hit or miss), with *BUFFER and
+ * *ITEM_SIZE set as in membuffer_cache_get_internal.  Return FALSE if
+ * no consistent result could be obtained; the caller should retry under
+ * the regular read lock.  All index references and sizes read here may
+ * be torn, so they get bounds-checked before being used for memory
+ * access - inconsistent data may at worst yield a copy of arbitrary
+ * buffer contents, never an out-of-bounds access, and such a copy never
+ * passes the final validation.
+ */
+static svn_boolean_t
+membuffer_cache_get_lockfree(svn_membuffer_t *cache,
+                             apr_uint32_t group_index,
+                             const full_key_t *to_find,
+                             char **buffer,
+                             apr_size_t *item_size,
+                             apr_pool_t *result_pool)
+{
+  apr_uint32_t change_count;
+  const entry_group_t *group;
+  const entry_t *entry = NULL;
+  apr_uint64_t offset;
+  apr_uint64_t data_size;
+  apr_size_t size;
+  apr_size_t key_len;
+  apr_size_t to_copy;
+  apr_uint32_t chain_length = 0;
+  apr_size_t i;
+  char *copy;
+
+  /* Snapshot the segment state.  An odd value means a write is active
+   * right now; don't wait for it to complete, just use the locked path.
+   */
+  change_count = get_change_count(cache);
+  if (change_count & 1)
+    return FALSE;
+
+  /* Look for the entry, replicating the lookup part of find_entry()
+   * with the index references checked against the directory size.
+   */
+  if (is_group_initialized(cache, group_index))
+    {
+      group = &cache->directory[group_index];
+      while (1)
+        {
+          apr_uint32_t used = group->header.used;
+          apr_uint32_t next = group->header.next;
+
+          if (used > GROUP_SIZE)
+            return FALSE;
+
+          for (i = 0; i < used; ++i)
+            if (entry_keys_match(&group->entries[i].key,
+                                 &to_find->entry_key))
+              {
+                entry = &group->entries[i];
+                break;
+              }
+
+          if (entry || next == NO_INDEX)
+            break;
+
+          if (   next >= cache->group_count + cache->spare_group_count
+              || ++chain_length > MAX_GROUP_CHAIN_LENGTH)
+            return FALSE;
+
+          group = &cache->directory[next];
+        }
+    }
+
+  if (entry == NULL)
+    {
+      /* No entry for that key.  This is conclusive only if nothing
+       * changed while we were searching. */
+      if (get_change_count(cache) != change_count)
+        return FALSE;
+
+      cache->total_reads++;
+      *buffer = NULL;
+      *item_size = 0;
+      return TRUE;
+    }
+
+  offset = entry->offset;
+  size = entry->size;
+  key_len = entry->key.key_len;
+
+  /* Items stored inline in the directory entry need no buffer access
+   * at all; just bounds-check the (potentially torn) size.
+   */
+  if (offset == NO_OFFSET)
+    {
+      if (size > SMALL_VALUE_SIZE || key_len)
+        return FALSE;
+
+      copy = apr_palloc(result_pool, SMALL_VALUE_SIZE);
+      memcpy(copy, entry->small_value.data, SMALL_VALUE_SIZE);
+
+      /* Did any write intervene?  Then the copy may be garbage. */
+      if (get_change_count(cache) != change_count)
+        return FALSE;
+
+      cache->total_reads++;
+      increment_hit_counters(cache, (entry_t *)entry);
+      *buffer = copy;
+      *item_size = size;
+
+      return TRUE;
+    }
+
+  /* Bounds-check what we are about to copy. */
+  data_size = cache->l2.start_offset + cache->l2.size;
+  if (   size > cache->max_entry_size
+      || size < key_len
+      || offset > data_size
+      || ALIGN_VALUE(size) > data_size - offset)
+    return FALSE;
+
+  /* Compare the full key, if the fingerprint alone is not unique. */
+  if (   key_len
+      && memcmp(to_find->full_key.data, cache->data + offset, key_len))
+    {
+      /* Key conflict - the entry to find cannot be anywhere else.
+       * But the stored key may have been torn by a concurrent write. */
+      if (get_change_count(cache) != change_count)
+        return FALSE;
+
+      cache->total_reads++;
+      *buffer = NULL;
+      *item_size = 0;
+      return TRUE;
+    }
+
+  to_copy = ALIGN_VALUE(size) - key_len;
+  copy = apr_palloc(result_pool, to_copy);
+  memcpy(copy, cache->data + offset + key_len, to_copy);
+
+  /* Did any write intervene?  Then the copy may be garbage. */
+  if (get_change_count(cache) != change_count)
+    return FALSE;
+
+  /* The copy is consistent.  ENTRY still describes it because no write
+   * completed since the copy was taken; a write that started just now
+   * will at worst see the extra hit on whatever uses the slot next.
+   */
+  cache->total_reads++;
+  increment_hit_counters(cache, (entry_t *)entry);
+  *buffer = copy;
+  *item_size = size - key_len;
+
+  return TRUE;
+}
+
+#endif /* !SVN_DEBUG_CACHE_MEMBUFFER */
+
 /* Look for the *ITEM identified by KEY. If no item has been stored
  * for KEY, *ITEM will be NULL. Otherwise, the DESERIALIZER is called
  * to re-construct the proper object from the serialized data.
@@ -2453,6 +2875,17 @@ membuffer_cache_get(svn_membuffer_t *cache,
   /* find the entry group that will hold the key.
    */
   group_index = get_group_index(&cache, &key->entry_key);
+
+#ifndef SVN_DEBUG_CACHE_MEMBUFFER
+  /* Try the optimistic, lock-free read path first.  In read-mostly
+   * workloads, cache hits then leave the segment lock untouched and
+   * scale with the number of reader threads.  With the consistency
+   * checks enabled, always use the locked path so that the tags keep
+   * their authority.
+   */
+  if (!membuffer_cache_get_lockfree(cache, group_index, key,
+                                    &buffer, &size, result_pool))
+#endif
   WITH_READ_LOCK(cache,
                  membuffer_cache_get_internal(cache,
                                               group_index,
@@ -2559,7 +2992,10 @@ membuffer_cache_get_partial_internal(svn_membuffer_t *cache,
     }
   else
     {
-      const void *item_data = cache->data + entry->offset + entry->key.key_len;
+      const void *item_data
+        = is_inline_entry(entry)
+        ? (const void *)entry->small_value.data
+        : (const void *)(cache->data + entry->offset + entry->key.key_len);
       apr_size_t item_size = entry->size - entry->key.key_len;
       *found = TRUE;
       increment_hit_counters(cache, entry);
@@ -2642,7 +3078,9 @@ membuffer_cache_set_partial_internal(svn_membuffer_t *cache,
 
       /* access the serialized cache item */
       apr_size_t key_len = entry->key.key_len;
-      void *item_data = cache->data + entry->offset + key_len;
+      void *item_data = is_inline_entry(entry)
+                      ? (void *)entry->small_value.data
+                      : (void *)(cache->data + entry->offset + key_len);
       void *orig_data = item_data;
       apr_size_t item_size = entry->size - key_len;
 
@@ -2690,7 +3128,18 @@ membuffer_cache_set_partial_internal(svn_membuffer_t *cache,
                * it is shorter than the MAX_ENTRY_SIZE.
                */
               drop_entry(cache, entry);
-              if (   (cache->max_entry_size - key_len >= item_size)
+              if (item_size <= SMALL_VALUE_SIZE && !key_len)
+                {
+                  /* The modified item fits into the directory entry.
+                   */
+                  entry = find_entry(cache, group_index, to_find, TRUE);
+                  entry->size = item_size;
+                  if (item_size)
+                    memcpy(entry->small_value.data, item_data, item_size);
+
+                  insert_inline_entry(cache, entry);
+                }
+              else if (   (cache->max_entry_size - key_len >= item_size)
                   && ensure_data_insertable_l1(cache, item_size + key_len))
                 {
                   /* Write the new entry.
@@ -2827,7 +3276,6 @@ combine_long_key(svn_membuffer_cache_t *cache,
                  const void *key,
                  apr_ssize_t key_len)
 {
-  apr_uint32_t *digest_buffer;
   char *key_copy;
   apr_size_t prefix_len = cache->prefix.key_len;
   apr_size_t aligned_key_len;
@@ -2847,9 +3295,12 @@ combine_long_key(svn_membuffer_cache_t *cache,
   memcpy(key_copy, key, key_len);
   memset(key_copy + key_len, 0, aligned_key_len - key_len);
 
-  /* Hash key into 16 bytes. */
-  digest_buffer = (apr_uint32_t *)cache->combined_key.entry_key.fingerprint;
-  svn__fnv1a_32x4_raw(digest_buffer, key, key_len);
+  /* Hash key into 16 bytes.  The mixing step matters here: the raw lane
+   * values feed the modulus folding in get_group_index() and similar
+   * keys would otherwise cluster in a few entry groups. */
+  svn__fnv1a_32x4_digest(
+      (unsigned char *)cache->combined_key.entry_key.fingerprint,
+      key, key_len);
 
   /* Combine with prefix. */
   cache->combined_key.entry_key.fingerprint[0]
@@ -3132,6 +3583,12 @@ svn_membuffer_get_segment_info(svn_membuffer_t *segment,
   info->used_entries += segment->used_entries;
   info->total_entries += segment->group_count * GROUP_SIZE;
 
+  for (i = 0; i < 3; ++i)
+    {
+      info->used_entries_per_class[i] += segment->used_entries_per_class[i];
+      info->used_size_per_class[i] += segment->data_used_per_class[i];
+    }
+
   if (include_histogram)
     for (i = 0; i < segment->group_count; ++i)
       if (is_group_initialized(segment, i))
@@ -3186,7 +3643,8 @@ static svn_cache__vtable_t membuffer_cache_vtable = {
   svn_membuffer_cache_is_cachable,
   svn_membuffer_cache_get_partial,
   svn_membuffer_cache_set_partial,
-  svn_membuffer_cache_get_info
+  svn_membuffer_cache_get_info,
+  NULL /* get_multi */
 };
 
 /* Implement svn_cache__vtable_t.get and serialize all cache access.
@@ -3299,7 +3757,8 @@ static svn_cache__vtable_t membuffer_cache_synced_vtable = {
   svn_membuffer_cache_is_cachable,        /* no sync required */
   svn_membuffer_cache_get_partial_synced,
   svn_membuffer_cache_set_partial_synced,
-  svn_membuffer_cache_get_info            /* no sync required */
+  svn_membuffer_cache_get_info,           /* no sync required */
+  NULL                                    /* get_multi */
 };
 
 /* standard serialization function for svn_stringbuf_t items.
@@ -3354,7 +3813,6 @@ svn_cache__create_membuffer_cache(svn_cache__t **cache_p,
                                   apr_pool_t *result_pool,
                                   apr_pool_t *scratch_pool)
 {
-  svn_checksum_t *checksum;
   apr_size_t prefix_len, prefix_orig_len;
 
   /* allocate the cache header structures
@@ -3386,14 +3844,11 @@ svn_cache__create_membuffer_cache(svn_cache__t **cache_p,
     return svn_error_create(SVN_ERR_INCORRECT_PARAMS, NULL,
                             _("Prefix too long"));
 
-  /* Construct the folded prefix key. */
-  SVN_ERR(svn_checksum(&checksum,
-                       svn_checksum_md5,
-                       prefix,
-                       strlen(prefix),
-                       scratch_pool));
-  memcpy(cache->prefix.fingerprint, checksum->digest,
-         sizeof(cache->prefix.fingerprint));
+  /* Construct the folded prefix key.  This only serves to mask entry
+   * fingerprints per cache instance, so a fast non-cryptographic digest
+   * is good enough - caches get created on every repository open. */
+  svn__fnv1a_32x4_digest((unsigned char *)cache->prefix.fingerprint,
+                         prefix, strlen(prefix));
   cache->prefix.key_len = prefix_len;
 
   /* Fix-length keys of up to 16 bytes may be handled without storing the
@@ -214,6 +214,77 @@ memcache_get(void **value_p,
   return SVN_NO_ERROR;
 }
 
+/* Implement vtable.get_multi: answer the whole batch of lookups with a
+ * single multi-get request to the server.
+ */
+static svn_error_t *
+memcache_get_multi(void *cache_void,
+                   svn_cache__multi_item_t *items,
+                   apr_size_t count,
+                   apr_pool_t *result_pool)
+{
+  memcache_t *cache = cache_void;
+  apr_pool_t *subpool = svn_pool_create(result_pool);
+  const char **mc_keys = apr_palloc(subpool, count * sizeof(*mc_keys));
+  apr_hash_t *values = apr_hash_make(subpool);
+  apr_status_t apr_err;
+  apr_size_t i;
+
+  for (i = 0; i < count; ++i)
+    {
+      if (items[i].key == NULL)
+        {
+          mc_keys[i] = NULL;
+          continue;
+        }
+
+      SVN_ERR(build_key(&mc_keys[i], cache, items[i].key, subpool));
+      apr_memcache_add_multget_key(subpool, mc_keys[i], &values);
+    }
+
+  /* Note that the values themselves are allocated in RESULT_POOL, so
+     the deserializers below may safely alias the buffers. */
+  apr_err = apr_memcache_multgetp(cache->memcache, subpool, result_pool,
+                                  values);
+  if (apr_err != APR_SUCCESS && apr_err != APR_NOTFOUND)
+    {
+      svn_pool_destroy(subpool);
+      return svn_error_wrap_apr(apr_err,
+                                _("Unknown memcached error while reading"));
+    }
+
+  for (i = 0; i < count; ++i)
+    {
+      apr_memcache_value_t *value;
+
+      if (mc_keys[i] == NULL)
+        continue;
+
+      value = apr_hash_get(values, mc_keys[i], APR_HASH_KEY_STRING);
+      if (value == NULL || value->status != APR_SUCCESS || !value->data)
+        continue;
+
+      if (cache->deserialize_func)
+        {
+          SVN_ERR((cache->deserialize_func)(&items[i].value, value->data,
+                                            value->len, result_pool));
+        }
+      else
+        {
+          svn_stringbuf_t *buf = svn_stringbuf_create_empty(result_pool);
+          buf->data = value->data;
+          buf->blocksize = value->len;
+          buf->len = value->len - 1; /* account for trailing NUL */
+          items[i].value = buf;
+        }
+
+      items[i].found = TRUE;
+    }
+
+  svn_pool_destroy(subpool);
+  return SVN_NO_ERROR;
+}
+
 /* Implement vtable.has_key in terms of the getter.
  */
 static svn_error_t *
@@ -398,7 +469,8 @@ static svn_cache__vtable_t memcache_vtable = {
   memcache_is_cachable,
   memcache_get_partial,
   memcache_set_partial,
-  memcache_get_info
+  memcache_get_info,
+  memcache_get_multi
 };
 
 svn_error_t *
@@ -0,0 +1,281 @@
+/*
+ * cache-twolevel.c: two-level caching object for Subversion
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include "svn_pools.h"
+
+#include "svn_private_config.h"
+#include "cache.h"
+
+/* A simple combination of two caches.  All lookups are served from the
+ * FRONT cache first - typically a fast, process-local membuffer - and
+ * only on a miss do we consult the larger but more expensive BACK cache,
+ * e.g. a host-shared memcached instance.  Back-end hits get promoted
+ * into the front cache, so repeated access to hot data stops paying the
+ * back-end round-trip.  Writes go to both levels.
+ *
+ * The combined cache has no storage of its own; consistency between the
+ * levels is the same "best effort" that each individual cache provides.
+ */
+
+/* Internal cache structure referring to the two levels. */
+typedef struct two_level_cache_t
+{
+  /* The fast, smaller first level cache. */
+  svn_cache__t *front;
+
+  /* The slower, larger second level cache. */
+  svn_cache__t *back;
+} two_level_cache_t;
+
+static svn_error_t *
+two_level_cache_get(void **value_p,
+                    svn_boolean_t *found,
+                    void *cache_void,
+                    const void *key,
+                    apr_pool_t *result_pool)
+{
+  two_level_cache_t *cache = cache_void;
+
+  SVN_ERR(svn_cache__get(value_p, found, cache->front, key, result_pool));
+  if (*found)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_cache__get(value_p, found, cache->back, key, result_pool));
+
+  /* Serve future lookups from the front cache. */
+  if (*found)
+    SVN_ERR(svn_cache__set(cache->front, key, *value_p, result_pool));
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+two_level_cache_has_key(svn_boolean_t *found,
+                        void *cache_void,
+                        const void *key,
+                        apr_pool_t *scratch_pool)
+{
+  two_level_cache_t *cache = cache_void;
+
+  SVN_ERR(svn_cache__has_key(found, cache->front, key, scratch_pool));
+  if (*found)
+    return SVN_NO_ERROR;
+
+  return svn_error_trace(svn_cache__has_key(found, cache->back, key,
+                                            scratch_pool));
+}
+
+static svn_error_t *
+two_level_cache_set(void *cache_void,
+                    const void *key,
+                    void *value,
+                    apr_pool_t *scratch_pool)
+{
+  two_level_cache_t *cache = cache_void;
+
+  SVN_ERR(svn_cache__set(cache->front, key, value, scratch_pool));
+  return svn_error_trace(svn_cache__set(cache->back, key, value,
+                                        scratch_pool));
+}
+
+static svn_error_t *
+two_level_cache_iter(svn_boolean_t *completed,
+                     void *cache_void,
+                     svn_iter_apr_hash_cb_t user_cb,
+                     void *user_baton,
+                     apr_pool_t *scratch_pool)
+{
+  two_level_cache_t *cache = cache_void;
+
+  /* Neither level holds the full data set, so iteration is only as
+   * meaningful as the back end's.  Both membuffer and memcached caches
+   * don't support it anyway. */
+  return svn_error_trace(svn_cache__iter(completed, cache->back, user_cb,
+                                         user_baton, scratch_pool));
+}
+
+static svn_boolean_t
+two_level_cache_is_cachable(void *cache_void,
+                            apr_size_t size)
+{
+  two_level_cache_t *cache = cache_void;
+
+  /* Data that fits into either level is worth storing; set() forwards
+   * to both and each level rejects what it cannot hold. */
+  return svn_cache__is_cachable(cache->front, size)
+         || svn_cache__is_cachable(cache->back, size);
+}
+
+static svn_error_t *
+two_level_cache_get_partial(void **value_p,
+                            svn_boolean_t *found,
+                            void *cache_void,
+                            const void *key,
+                            svn_cache__partial_getter_func_t func,
+                            void *baton,
+                            apr_pool_t *result_pool)
+{
+  two_level_cache_t *cache = cache_void;
+
+  SVN_ERR(svn_cache__get_partial(value_p, found, cache->front, key, func,
+                                 baton, result_pool));
+  if (*found)
+    return SVN_NO_ERROR;
+
+  /* No promotion here - we never see the full item. */
+  return svn_error_trace(svn_cache__get_partial(value_p, found, cache->back,
+                                                key, func, baton,
+                                                result_pool));
+}
+
+static svn_error_t *
+two_level_cache_set_partial(void *cache_void,
+                            const void *key,
+                            svn_cache__partial_setter_func_t func,
+                            void *baton,
+                            apr_pool_t *scratch_pool)
+{
+  two_level_cache_t *cache = cache_void;
+
+  /* Update the item wherever it currently exists. */
+  SVN_ERR(svn_cache__set_partial(cache->front, key, func, baton,
+                                 scratch_pool));
+  return svn_error_trace(svn_cache__set_partial(cache->back, key, func,
+                                                baton, scratch_pool));
+}
+
+static svn_error_t *
+two_level_cache_get_info(void *cache_void,
+                         svn_cache__info_t *info,
+                         svn_boolean_t reset,
+                         apr_pool_t *result_pool)
+{
+  two_level_cache_t *cache = cache_void;
+  svn_cache__info_t back_info;
+
+  SVN_ERR(svn_cache__get_info(cache->front, info, reset, result_pool));
+  SVN_ERR(svn_cache__get_info(cache->back, &back_info, reset, result_pool));
+
+  /* Combine the capacity / usage figures of both levels.  The access
+   * statistics of the combined instance are maintained by the generic
+   * cache code and will overwrite the front end's numbers. */
+  info->used_size += back_info.used_size;
+  info->data_size += back_info.data_size;
+  info->total_size += back_info.total_size;
+  info->used_entries += back_info.used_entries;
+  info->total_entries += back_info.total_entries;
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+two_level_cache_get_multi(void *cache_void,
+                          svn_cache__multi_item_t *items,
+                          apr_size_t count,
+                          apr_pool_t *result_pool)
+{
+  two_level_cache_t *cache = cache_void;
+  svn_cache__multi_item_t *missed;
+  apr_size_t missed_count = 0;
+  apr_size_t i;
+
+  /* Answer what we can from the front cache. */
+  SVN_ERR(svn_cache__get_multi(cache->front, items, count, result_pool));
+
+  /* Collect the misses into a dense batch for the back end. */
+  missed = apr_palloc(result_pool, count * sizeof(*missed));
+  for (i = 0; i < count; ++i)
+    if (!items[i].found)
+      {
+        missed[missed_count].key = items[i].key;
+        ++missed_count;
+      }
+
+  if (missed_count == 0)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_cache__get_multi(cache->back, missed, missed_count,
+                               result_pool));
+
+  /* Copy the results back and promote them into the front cache. */
+  missed_count = 0;
+  for (i = 0; i < count; ++i)
+    if (!items[i].found)
+      {
+        items[i].value = missed[missed_count].value;
+        items[i].found = missed[missed_count].found;
+        if (items[i].found)
+          SVN_ERR(svn_cache__set(cache->front, items[i].key, items[i].value,
+                                 result_pool));
+        ++missed_count;
+      }
+
+  return SVN_NO_ERROR;
+}
+
+static svn_cache__vtable_t two_level_cache_vtable = {
+  two_level_cache_get,
+  two_level_cache_has_key,
+  two_level_cache_set,
+  two_level_cache_iter,
+  two_level_cache_is_cachable,
+  two_level_cache_get_partial,
+  two_level_cache_set_partial,
+  two_level_cache_get_info,
+  NULL /* get_multi */
+};
+
+/* Used when the back end answers batches natively; otherwise batching
+ * through the combined cache would offer no benefit over single gets. */
+static svn_cache__vtable_t two_level_cache_multi_vtable = {
+  two_level_cache_get,
+  two_level_cache_has_key,
+  two_level_cache_set,
+  two_level_cache_iter,
+  two_level_cache_is_cachable,
+  two_level_cache_get_partial,
+  two_level_cache_set_partial,
+  two_level_cache_get_info,
+  two_level_cache_get_multi
+};
+
+svn_error_t *
+svn_cache__create_two_level(svn_cache__t **cache_p,
+                            svn_cache__t *front,
+                            svn_cache__t *back,
+                            apr_pool_t *result_pool)
+{
+  svn_cache__t *wrapper = apr_pcalloc(result_pool, sizeof(*wrapper));
+  two_level_cache_t *cache = apr_palloc(result_pool, sizeof(*cache));
+
+  cache->front = front;
+  cache->back = back;
+
+  wrapper->vtable = svn_cache__supports_multi_get(back)
+                  ? &two_level_cache_multi_vtable
+                  : &two_level_cache_vtable;
+  wrapper->cache_internal = cache;
+
+  *cache_p = wrapper;
+  return SVN_NO_ERROR;
+}
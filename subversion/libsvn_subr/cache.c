@@ -95,6 +95,64 @@ svn_cache__get(void **value_p,
   return err;
 }
 
+svn_boolean_t
+svn_cache__supports_multi_get(svn_cache__t *cache)
+{
+  return cache != NULL && cache->vtable->get_multi != NULL;
+}
+
+svn_error_t *
+svn_cache__get_multi(svn_cache__t *cache,
+                     svn_cache__multi_item_t *items,
+                     apr_size_t count,
+                     apr_pool_t *result_pool)
+{
+  svn_error_t *err;
+  apr_size_t i;
+
+  /* In case any errors happen and are quelched, make sure we start
+     out with all items not found. */
+  for (i = 0; i < count; ++i)
+    {
+      items[i].value = NULL;
+      items[i].found = FALSE;
+    }
+#ifdef SVN_DEBUG
+  if (cache->pretend_empty)
+    return SVN_NO_ERROR;
+#endif
+
+  cache->reads += count;
+  if (cache->vtable->get_multi)
+    {
+      err = handle_error(cache,
+                         (cache->vtable->get_multi)(cache->cache_internal,
+                                                    items,
+                                                    count,
+                                                    result_pool),
+                         result_pool);
+    }
+  else
+    {
+      /* The backend gains nothing from batching; just loop. */
+      err = SVN_NO_ERROR;
+      for (i = 0; i < count && !err; ++i)
+        err = handle_error(cache,
+                           (cache->vtable->get)(&items[i].value,
+                                                &items[i].found,
+                                                cache->cache_internal,
+                                                items[i].key,
+                                                result_pool),
+                           result_pool);
+    }
+
+  for (i = 0; i < count; ++i)
+    if (items[i].found)
+      cache->hits++;
+
+  return err;
+}
+
 svn_error_t *
 svn_cache__has_key(svn_boolean_t *found,
                    svn_cache__t *cache,
@@ -300,7 +358,10 @@ svn_cache__format_info(const svn_cache__info_t *info,
                             " of %" APR_UINT64_T_FMT " MB data cache"
                             " / %" APR_UINT64_T_FMT " MB total cache memory\n"
                             "          %" APR_UINT64_T_FMT " entries (%5.2f%%)"
-                            " of %" APR_UINT64_T_FMT " total\n%s",
+                            " of %" APR_UINT64_T_FMT " total\n"
+                            "          %" APR_UINT64_T_FMT " low / %"
+                            APR_UINT64_T_FMT " default / %"
+                            APR_UINT64_T_FMT " high priority entries\n%s",
 
                             info->id,
 
@@ -315,5 +376,9 @@ svn_cache__format_info(const svn_cache__info_t *info,
 
                             info->used_entries, data_entry_rate,
                             info->total_entries,
+
+                            info->used_entries_per_class[0],
+                            info->used_entries_per_class[1],
+                            info->used_entries_per_class[2],
                             histogram);
 }
@@ -82,6 +82,13 @@ typedef struct svn_cache__vtable_t {
                            svn_cache__info_t *info,
                            svn_boolean_t reset,
                            apr_pool_t *result_pool);
+
+  /* See svn_cache__get_multi().  May be NULL, in which case the lookups
+     will be performed one at a time through GET. */
+  svn_error_t *(*get_multi)(void *cache_implementation,
+                            svn_cache__multi_item_t *items,
+                            apr_size_t count,
+                            apr_pool_t *result_pool);
 } svn_cache__vtable_t;
 
 struct svn_cache__t {
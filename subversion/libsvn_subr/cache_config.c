@@ -64,6 +64,13 @@ static svn_cache_config_t cache_settings =
 #endif
 };
 
+/* Number of segments to use for the process-global membuffer cache.
+ * 0 means "derive a suitable value from the cache size".  Because
+ * svn_cache_config_t cannot be extended without breaking binary
+ * compatibility, this knob lives next to it as a separate singleton.
+ */
+static apr_size_t membuffer_segment_count = 0;
+
 /* Get the current FSFS cache configuration. */
 const svn_cache_config_t *
 svn_cache_config_get(void)
@@ -71,6 +78,12 @@ svn_cache_config_get(void)
   return &cache_settings;
 }
 
+void
+svn_cache__set_global_membuffer_segments(apr_size_t segment_count)
+{
+  membuffer_segment_count = segment_count;
+}
+
 /* Initializer function as required by svn_atomic__init_once.  Allocate
  * the process-global (singleton) membuffer cache and return it in the
  * svn_membuffer_t * in *BATON.  UNUSED_POOL is unused and should be NULL.
@@ -124,7 +137,7 @@ initialize_cache(void *baton, apr_pool_t *unused_pool)
           &cache,
           (apr_size_t)cache_size,
           (apr_size_t)(cache_size / 5),
-          0,
+          membuffer_segment_count,
           ! svn_cache_config_get()->single_threaded,
           FALSE,
           pool);
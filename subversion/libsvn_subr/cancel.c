@@ -0,0 +1,87 @@
+/* cancel.c : deadline-aware cancellation contexts
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <apr_time.h>
+
+#include "svn_error.h"
+#include "svn_pools.h"
+
+#include "private/svn_atomic.h"
+#include "private/svn_subr_private.h"
+
+#include "svn_private_config.h"
+
+struct svn_cancel__context_t
+{
+  /* Absolute wall-clock deadline for the operation, or 0 for none. */
+  apr_time_t deadline;
+
+  /* Set to non-zero, possibly from another thread, to cancel. */
+  svn_atomic_t cancelled;
+
+  /* Optional further cancellation callback to consult. */
+  svn_cancel_func_t wrapped_func;
+  void *wrapped_baton;
+};
+
+svn_cancel__context_t *
+svn_cancel__context_create(apr_time_t deadline,
+                           svn_cancel_func_t wrapped_func,
+                           void *wrapped_baton,
+                           apr_pool_t *result_pool)
+{
+  svn_cancel__context_t *cc = apr_pcalloc(result_pool, sizeof(*cc));
+
+  cc->deadline = deadline;
+  cc->wrapped_func = wrapped_func;
+  cc->wrapped_baton = wrapped_baton;
+
+  return cc;
+}
+
+void
+svn_cancel__context_cancel(svn_cancel__context_t *cc)
+{
+  svn_atomic_set(&cc->cancelled, TRUE);
+}
+
+svn_error_t *
+svn_cancel__context_check(void *baton)
+{
+  svn_cancel__context_t *cc = baton;
+
+  /* The fast path is one atomic load; the clock read below is cheap as
+     well (a vDSO call on common platforms), so this function is safe to
+     call at the same frequency as any other cancellation callback. */
+  if (svn_atomic_read(&cc->cancelled))
+    return svn_error_create(SVN_ERR_CANCELLED, NULL,
+                            _("Operation cancelled"));
+
+  if (cc->deadline && apr_time_now() > cc->deadline)
+    return svn_error_create(SVN_ERR_CANCELLED, NULL,
+                            _("Operation deadline exceeded"));
+
+  if (cc->wrapped_func)
+    return svn_error_trace(cc->wrapped_func(cc->wrapped_baton));
+
+  return SVN_NO_ERROR;
+}
@@ -0,0 +1,195 @@
+/*
+ * compress_zstd.c:  zstd data compression routines
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <assert.h>
+
+#include "private/svn_subr_private.h"
+
+#include "svn_private_config.h"
+
+#ifdef SVN_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+svn_boolean_t
+svn__zstd_available(void)
+{
+#ifdef SVN_HAVE_ZSTD
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+#ifdef SVN_HAVE_ZSTD
+
+/* Map our generic 0..9 compression level onto a zstd level.  Level 9
+ * becomes zstd-19, our default of 5 becomes zstd-11 and level 1 becomes
+ * zstd-3 (the zstd default). */
+static int
+zstd_level(int compression_level)
+{
+  int level = compression_level * 2 + 1;
+
+  return level > ZSTD_maxCLevel() ? ZSTD_maxCLevel() : level;
+}
+
+svn_error_t *
+svn__compress_zstd(const void *data, apr_size_t len,
+                   svn_stringbuf_t *out,
+                   int compression_level)
+{
+  apr_size_t hdrlen;
+  unsigned char buf[SVN__MAX_ENCODED_UINT_LEN];
+  unsigned char *p;
+  size_t compressed_data_len;
+  size_t max_compressed_data_len;
+
+  p = svn__encode_uint(buf, (apr_uint64_t)len);
+  hdrlen = p - buf;
+  max_compressed_data_len = ZSTD_compressBound(len);
+  svn_stringbuf_setempty(out);
+  svn_stringbuf_ensure(out, max_compressed_data_len + hdrlen);
+  svn_stringbuf_appendbytes(out, (const char *)buf, hdrlen);
+
+  if (compression_level <= 0)
+    {
+      /* Compression disabled; just append the original text.  The
+         decoder detects this case by the identical lengths. */
+      svn_stringbuf_appendbytes(out, data, len);
+      return SVN_NO_ERROR;
+    }
+
+  compressed_data_len = ZSTD_compress(out->data + out->len,
+                                      max_compressed_data_len, data, len,
+                                      zstd_level(compression_level));
+  if (ZSTD_isError(compressed_data_len))
+    return svn_error_create(SVN_ERR_ZSTD_COMPRESSION_FAILED, NULL, NULL);
+
+  if (compressed_data_len >= len)
+    {
+      /* Compression didn't help :(, just append the original text */
+      svn_stringbuf_appendbytes(out, data, len);
+    }
+  else
+    {
+      out->len += compressed_data_len;
+      out->data[out->len] = 0;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn__decompress_zstd(const void *data, apr_size_t len,
+                     svn_stringbuf_t *out,
+                     apr_size_t limit)
+{
+  apr_size_t hdrlen;
+  apr_size_t compressed_data_len;
+  apr_size_t decompressed_data_len;
+  apr_uint64_t u64;
+  const unsigned char *p = data;
+  size_t rv;
+
+  /* First thing in the string is the original length.  */
+  p = svn__decode_uint(&u64, p, p + len);
+  if (p == NULL)
+    return svn_error_create(SVN_ERR_SVNDIFF_INVALID_COMPRESSED_DATA, NULL,
+                            _("Decompression of compressed data failed: "
+                              "no size"));
+  if (u64 > limit)
+    return svn_error_create(SVN_ERR_SVNDIFF_INVALID_COMPRESSED_DATA, NULL,
+                            _("Decompression of compressed data failed: "
+                              "size too large"));
+  decompressed_data_len = (apr_size_t)u64;
+  hdrlen = p - (const unsigned char *)data;
+  compressed_data_len = len - hdrlen;
+
+  svn_stringbuf_setempty(out);
+  svn_stringbuf_ensure(out, decompressed_data_len);
+
+  if (compressed_data_len == decompressed_data_len)
+    {
+      /* Data is in the original, uncompressed form. */
+      memcpy(out->data, p, decompressed_data_len);
+    }
+  else
+    {
+      rv = ZSTD_decompress(out->data, decompressed_data_len, p,
+                           compressed_data_len);
+      if (ZSTD_isError(rv))
+        return svn_error_create(SVN_ERR_ZSTD_DECOMPRESSION_FAILED, NULL,
+                                NULL);
+
+      if (rv != decompressed_data_len)
+        return svn_error_create(SVN_ERR_SVNDIFF_INVALID_COMPRESSED_DATA,
+                                NULL,
+                                _("Size of uncompressed data "
+                                  "does not match stored original length"));
+    }
+
+  out->data[decompressed_data_len] = 0;
+  out->len = decompressed_data_len;
+
+  return SVN_NO_ERROR;
+}
+
+const char *
+svn_zstd__compiled_version(void)
+{
+  static const char zstd_version_str[] =
+    APR_STRINGIFY(ZSTD_VERSION_MAJOR) "." \
+    APR_STRINGIFY(ZSTD_VERSION_MINOR) "." \
+    APR_STRINGIFY(ZSTD_VERSION_RELEASE);
+
+  return zstd_version_str;
+}
+
+#else /* !SVN_HAVE_ZSTD */
+
+svn_error_t *
+svn__compress_zstd(const void *data, apr_size_t len,
+                   svn_stringbuf_t *out,
+                   int compression_level)
+{
+  return svn_error_create(SVN_ERR_UNSUPPORTED_FEATURE, NULL,
+                          _("Subversion was built without zstd support"));
+}
+
+svn_error_t *
+svn__decompress_zstd(const void *data, apr_size_t len,
+                     svn_stringbuf_t *out,
+                     apr_size_t limit)
+{
+  return svn_error_create(SVN_ERR_UNSUPPORTED_FEATURE, NULL,
+                          _("Subversion was built without zstd support"));
+}
+
+const char *
+svn_zstd__compiled_version(void)
+{
+  return NULL;
+}
+
+#endif /* SVN_HAVE_ZSTD */
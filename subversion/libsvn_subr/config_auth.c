@@ -33,7 +33,202 @@
 
 #include "svn_private_config.h"
 
+#include "private/svn_atomic.h"
 #include "private/svn_auth_private.h"
+#include "private/svn_mutex.h"
+
+/* The parsed contents of one auth file, cached process-wide so that
+   scripts opening many RA sessions don't re-read and re-parse the same
+   handful of files from disk for every session. */
+typedef struct cached_auth_file_t
+{
+  /* Sub-pool of AUTH_FILE_CACHE_POOL holding this entry. */
+  apr_pool_t *pool;
+
+  /* Modification time and size of the file when it was parsed.  Used
+     to detect changes made by other processes. */
+  apr_time_t mtime;
+  svn_filesize_t filesize;
+
+  /* Maps (const char *) keys to (svn_string_t *) values. */
+  apr_hash_t *hash;
+} cached_auth_file_t;
+
+/* A mutex to protect our global pool and cache. */
+static svn_mutex__t *auth_file_cache_mutex = NULL;
+
+/* Global pool to allocate the cache in. */
+static apr_pool_t *auth_file_cache_pool;
+
+/* Global cache, mapping auth file paths to cached_auth_file_t. */
+static apr_hash_t *auth_file_cache;
+
+static volatile svn_atomic_t auth_file_cache_init_status = 0;
+
+/* Implements svn_atomic__err_init_func_t; sets up the global cache. */
+static svn_error_t *
+init_auth_file_cache(void *baton,
+                     apr_pool_t *pool)
+{
+  auth_file_cache_pool = svn_pool_create(NULL);
+
+  SVN_ERR(svn_mutex__init(&auth_file_cache_mutex, TRUE,
+                          auth_file_cache_pool));
+
+  auth_file_cache = apr_hash_make(auth_file_cache_pool);
+  return SVN_NO_ERROR;
+}
+
+/* Return a deep copy of the auth data hash SRC, allocated in POOL. */
+static apr_hash_t *
+copy_auth_hash(apr_hash_t *src,
+               apr_pool_t *pool)
+{
+  apr_hash_t *dst = apr_hash_make(pool);
+  apr_hash_index_t *hi;
+
+  for (hi = apr_hash_first(pool, src); hi; hi = apr_hash_next(hi))
+    {
+      const svn_string_t *value = apr_hash_this_val(hi);
+
+      svn_hash_sets(dst, apr_pstrdup(pool, apr_hash_this_key(hi)),
+                    svn_string_dup(value, pool));
+    }
+
+  return dst;
+}
+
+/* The amount by which an auth file's mtime must predate the time of
+ * its caching for the cache entry to be usable.  A rewrite within that
+ * window may leave mtime and size unchanged due to timestamp
+ * granularity, which would make the change invisible to our validation
+ * and serve stale credentials; such files are re-read every time.
+ */
+#define FILE_INFO_TRUST_WINDOW apr_time_from_sec(1)
+
+/* Enter a deep copy of HASH into the global cache under AUTH_PATH,
+   recording MTIME and FILESIZE for later change detection.  Replaces
+   any existing entry for AUTH_PATH.  Files whose mtime is too recent
+   to be trusted are not recorded.
+   To be called with AUTH_FILE_CACHE_MUTEX held. */
+static void
+cache_auth_data_locked(const char *auth_path,
+                       apr_hash_t *hash,
+                       apr_time_t mtime,
+                       svn_filesize_t filesize)
+{
+  cached_auth_file_t *cached;
+  apr_pool_t *entry_pool;
+
+  cached = svn_hash_gets(auth_file_cache, auth_path);
+
+  if (apr_time_now() - mtime < FILE_INFO_TRUST_WINDOW)
+    {
+      /* A same-second rewrite could not be told from the state we would
+         record; drop any entry for the old contents and stay out of the
+         cache until the file's mtime has aged a bit. */
+      if (cached)
+        {
+          svn_hash_sets(auth_file_cache, auth_path, NULL);
+          svn_pool_destroy(cached->pool);
+        }
+      return;
+    }
+  if (cached)
+    svn_pool_destroy(cached->pool);
+
+  entry_pool = svn_pool_create(auth_file_cache_pool);
+  cached = apr_palloc(entry_pool, sizeof(*cached));
+  cached->pool = entry_pool;
+  cached->mtime = mtime;
+  cached->filesize = filesize;
+  cached->hash = copy_auth_hash(hash, entry_pool);
+
+  /* Note: on replacement, apr_hash_set() keeps the previously stored
+     key, so re-duplicating AUTH_PATH here wastes a few bytes at most. */
+  svn_hash_sets(auth_file_cache,
+                apr_pstrdup(auth_file_cache_pool, auth_path), cached);
+}
+
+/* Implements the body of svn_config_read_auth_data for AUTH_PATH: set
+   *HASH to the parsed contents of that file, allocated in POOL, served
+   from the global cache when the file is unchanged on disk.  Leave
+   *HASH untouched if the file does not exist.
+   To be called with AUTH_FILE_CACHE_MUTEX held. */
+static svn_error_t *
+read_auth_data_locked(apr_hash_t **hash,
+                      const char *auth_path,
+                      apr_pool_t *pool)
+{
+  apr_finfo_t finfo;
+  cached_auth_file_t *cached;
+  svn_stream_t *stream;
+  svn_error_t *err;
+
+  err = svn_io_stat(&finfo, auth_path,
+                    APR_FINFO_TYPE | APR_FINFO_MTIME | APR_FINFO_SIZE,
+                    pool);
+  if (err)
+    {
+      if (!APR_STATUS_IS_ENOENT(err->apr_err)
+          && !SVN__APR_STATUS_IS_ENOTDIR(err->apr_err))
+        return svn_error_trace(err);
+
+      /* The file is gone; make sure the cache agrees. */
+      svn_error_clear(err);
+      cached = svn_hash_gets(auth_file_cache, auth_path);
+      if (cached)
+        {
+          svn_hash_sets(auth_file_cache, auth_path, NULL);
+          svn_pool_destroy(cached->pool);
+        }
+      return SVN_NO_ERROR;
+    }
+
+  if (finfo.filetype != APR_REG)
+    return SVN_NO_ERROR;
+
+  cached = svn_hash_gets(auth_file_cache, auth_path);
+  if (cached
+      && cached->mtime == finfo.mtime
+      && cached->filesize == finfo.size)
+    {
+      *hash = copy_auth_hash(cached->hash, pool);
+      return SVN_NO_ERROR;
+    }
+
+  SVN_ERR_W(svn_stream_open_readonly(&stream, auth_path, pool, pool),
+            _("Unable to open auth file for reading"));
+
+  *hash = apr_hash_make(pool);
+
+  SVN_ERR_W(svn_hash_read2(*hash, stream, SVN_HASH_TERMINATOR, pool),
+            apr_psprintf(pool, _("Error parsing '%s'"),
+                         svn_dirent_local_style(auth_path, pool)));
+
+  SVN_ERR(svn_stream_close(stream));
+
+  cache_auth_data_locked(auth_path, *hash, finfo.mtime, finfo.size);
+
+  return SVN_NO_ERROR;
+}
+
+/* Refresh the global cache entry for AUTH_PATH from HASH, which was
+   just written to disk (and still contains the realmstring key).
+   To be called with AUTH_FILE_CACHE_MUTEX held. */
+static svn_error_t *
+write_auth_data_locked(const char *auth_path,
+                       apr_hash_t *hash,
+                       apr_pool_t *scratch_pool)
+{
+  apr_finfo_t finfo;
+
+  SVN_ERR(svn_io_stat(&finfo, auth_path,
+                      APR_FINFO_MTIME | APR_FINFO_SIZE, scratch_pool));
+  cache_auth_data_locked(auth_path, hash, finfo.mtime, finfo.size);
+
+  return SVN_NO_ERROR;
+}
 
 svn_error_t *
 svn_auth__file_path(const char **path,
@@ -76,7 +271,6 @@ svn_config_read_auth_data(apr_hash_t **hash,
                           const char *config_dir,
                           apr_pool_t *pool)
 {
-  svn_node_kind_t kind;
   const char *auth_path;
 
   *hash = NULL;
@@ -86,27 +280,18 @@ svn_config_read_auth_data(apr_hash_t **hash,
   if (! auth_path)
     return SVN_NO_ERROR;
 
-  SVN_ERR(svn_io_check_path(auth_path, &kind, pool));
-  if (kind == svn_node_file)
-    {
-      svn_stream_t *stream;
-      svn_string_t *stored_realm;
-
-      SVN_ERR_W(svn_stream_open_readonly(&stream, auth_path, pool, pool),
-                _("Unable to open auth file for reading"));
-
-      *hash = apr_hash_make(pool);
+  SVN_ERR(svn_atomic__init_once(&auth_file_cache_init_status,
+                                init_auth_file_cache, NULL, pool));
+  SVN_MUTEX__WITH_LOCK(auth_file_cache_mutex,
+                       read_auth_data_locked(hash, auth_path, pool));
 
-      SVN_ERR_W(svn_hash_read2(*hash, stream, SVN_HASH_TERMINATOR, pool),
-                apr_psprintf(pool, _("Error parsing '%s'"),
-                             svn_dirent_local_style(auth_path, pool)));
-
-      stored_realm = svn_hash_gets(*hash, SVN_CONFIG_REALMSTRING_KEY);
+  if (*hash)
+    {
+      svn_string_t *stored_realm
+        = svn_hash_gets(*hash, SVN_CONFIG_REALMSTRING_KEY);
 
       if (!stored_realm || strcmp(stored_realm->data, realmstring) != 0)
         *hash = NULL; /* Hash collision, or somebody tampering with storage */
-
-      SVN_ERR(svn_stream_close(stream));
     }
 
   return SVN_NO_ERROR;
@@ -146,6 +331,13 @@ svn_config_write_auth_data(apr_hash_t *hash,
   SVN_ERR(svn_stream_close(stream));
   SVN_ERR(svn_io_file_rename2(tmp_path, auth_path, FALSE, pool));
 
+  /* Keep the process-wide cache in sync with what we just wrote, so
+     the next read doesn't have to go back to disk. */
+  SVN_ERR(svn_atomic__init_once(&auth_file_cache_init_status,
+                                init_auth_file_cache, NULL, pool));
+  SVN_MUTEX__WITH_LOCK(auth_file_cache_mutex,
+                       write_auth_data_locked(auth_path, hash, pool));
+
   /* To be nice, remove the realmstring from the hash again, just in
      case the caller wants their hash unchanged.
      ### Should we also do this when a write error occurs? */
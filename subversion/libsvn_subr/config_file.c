@@ -1155,6 +1155,10 @@ svn_config_ensure(const char *config_dir, apr_pool_t *pool)
         "###                              HTTP operation."                   NL
         "###   http-chunked-requests      Whether to use chunked transfer"   NL
         "###                              encoding for HTTP requests body."  NL
+        "###   http-capability-cache      Whether to reuse cached server"    NL
+        "###                              capability information instead of" NL
+        "###                              querying it at the start of every" NL
+        "###                              session."                          NL
         "###   http-auth-types            List of HTTP authentication types."NL
         "###   ssl-authority-files        List of files, each of a trusted CA"
                                                                              NL
@@ -1512,6 +1516,12 @@ svn_config_ensure(const char *config_dir, apr_pool_t *pool)
         "### to show meaningful differences for binary file formats.  [New"  NL
         "### in 1.9]"                                                        NL
         "# diff-ignore-content-type = no"                                    NL
+        "### Set blame-cache to 'yes' to let 'svn blame' keep a per-file"    NL
+        "### cache of blame results in the user configuration area.  A"      NL
+        "### later blame of the same file then only fetches and processes"   NL
+        "### the revisions committed since the cached result was computed."  NL
+        "### It defaults to 'no'.  [New in 1.15]"                            NL
+        "# blame-cache = no"                                                 NL
         ""                                                                   NL
         "### Section for configuring automatic properties."                  NL
         "[auto-props]"                                                       NL
@@ -1553,6 +1563,28 @@ svn_config_ensure(const char *config_dir, apr_pool_t *pool)
         "### returning an error.  The default is 10000, i.e. 10 seconds."    NL
         "### Longer values may be useful when exclusive locking is enabled." NL
         "# busy-timeout = 10000"                                             NL
+        "### Set the SQLite page cache size used for the working copy"       NL
+        "### database.  Positive values are numbers of pages, negative"      NL
+        "### values are KiB (SQLite convention).  Larger caches speed up"    NL
+        "### clients that perform many operations on big working copies."    NL
+        "# cache-size = -2000"                                               NL
+        "### Set the maximum number of bytes of the working copy database"   NL
+        "### that SQLite may access via memory-mapped I/O.  0 disables"      NL
+        "### memory mapping.  Has no effect if SQLite was built without"     NL
+        "### mmap support."                                                  NL
+        "# mmap-size = 0"                                                    NL
+        "### Set to the path of a directory in which pristine texts are"     NL
+        "### shared between working copies via hardlinks.  The cache must"   NL
+        "### live on the same filesystem as the working copies; on other"    NL
+        "### configurations the option is silently ignored.  Entries whose"  NL
+        "### link count has dropped to one are no longer referenced by any"  NL
+        "### working copy and may be deleted."                               NL
+        "# pristine-cache-dir ="                                             NL
+        "### Set to 'yes' to store newly installed pristine texts in"        NL
+        "### compressed form.  Reads decompress transparently; pristines"    NL
+        "### installed before the option changed keep their representation"  NL
+        "### until they are replaced."                                       NL
+        "# compress-pristines = no"                                          NL
         "### Set the default working copy format version.  Newly created"    NL
         "### and upgraded working copies will by default be compatible with" NL
         "### the specified Subversion version."                              NL
@@ -1232,6 +1232,25 @@ svn_relpath_join(const char *base,
   return path;
 }
 
+void
+svn_relpath__join_buf(svn_stringbuf_t *result,
+                      const char *base,
+                      const char *component)
+{
+  apr_size_t blen = strlen(base);
+  apr_size_t clen = strlen(component);
+
+  assert(relpath_is_canonical(base));
+  assert(relpath_is_canonical(component));
+
+  svn_stringbuf_setempty(result);
+  svn_stringbuf_ensure(result, blen + 1 + clen);
+  svn_stringbuf_appendbytes(result, base, blen);
+  if (blen > 0 && clen > 0)
+    svn_stringbuf_appendbyte(result, '/');
+  svn_stringbuf_appendbytes(result, component, clen);
+}
+
 char *
 svn_dirent_dirname(const char *dirent, apr_pool_t *pool)
 {
@@ -29,6 +29,18 @@
 #include "private/svn_subr_private.h"
 #include "fnv1a.h"
 
+/* The 4-way interleaved variant maps directly onto 4-lane integer SIMD:
+ * one XOR plus one 32 bit multiply per input quad.  The multiply needs
+ * SSE4.1 (_mm_mullo_epi32) on x86; SSE2 alone is not enough.
+ */
+#if defined(__SSE4_1__)
+#define SVN_FNV1A__SIMD_SSE4_1
+#include <smmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SVN_FNV1A__SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 /**
  * See http://www.isthe.com/chongo/tech/comp/fnv/ for more info on FNV-1
  */
@@ -57,6 +69,30 @@ fnv1a_32(apr_uint32_t hash, const void *input, apr_size_t len)
   return hash;
 }
 
+/* FNV-1 64 bit constants taken from
+ * http://www.isthe.com/chongo/tech/comp/fnv/
+ */
+#define FNV1_PRIME_64 APR_UINT64_C(0x00000100000001b3)
+#define FNV1_BASE_64 APR_UINT64_C(0xcbf29ce484222325)
+
+/* FNV-1a core implementation returning a 64 bit checksum over the first
+ * LEN bytes in INPUT.  HASH is the checksum over preceding data (if any).
+ */
+static apr_uint64_t
+fnv1a_64(apr_uint64_t hash, const void *input, apr_size_t len)
+{
+  const unsigned char *data = input;
+  const unsigned char *end = data + len;
+
+  for (; data != end; ++data)
+    {
+      hash ^= *data;
+      hash *= FNV1_PRIME_64;
+    }
+
+  return hash;
+}
+
 /* Number of interleaved FVN-1a checksums we calculate for the modified
  * checksum algorithm.
  */
@@ -73,6 +109,47 @@ fnv1a_32x4(apr_uint32_t hashes[SCALING], const void *input, apr_size_t len)
      is large enough */
   const unsigned char *data = input;
   const unsigned char *end = data + len;
+
+#if defined(SVN_FNV1A__SIMD_SSE4_1)
+  if (data + SCALING <= end)
+    {
+      const __m128i prime = _mm_set1_epi32(FNV1_PRIME_32);
+      __m128i hash = _mm_loadu_si128((const __m128i *)hashes);
+
+      for (; data + SCALING <= end; data += SCALING)
+        {
+          /* Zero-extend the next 4 input bytes into the 4 hash lanes,
+             i.e. lane I sees data[I] - same as the scalar code below. */
+          apr_uint32_t quad;
+          __m128i chunk;
+          memcpy(&quad, data, sizeof(quad));
+          chunk = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((apr_int32_t)quad));
+
+          hash = _mm_mullo_epi32(_mm_xor_si128(hash, chunk), prime);
+        }
+
+      _mm_storeu_si128((__m128i *)hashes, hash);
+    }
+#elif defined(SVN_FNV1A__SIMD_NEON)
+  /* vld1_u8 reads 8 bytes per iteration, so stop one full quad short
+     of the end and let the scalar loop below pick up the rest. */
+  if (data + 2 * SCALING <= end)
+    {
+      const uint32x4_t prime = vdupq_n_u32(FNV1_PRIME_32);
+      uint32x4_t hash = vld1q_u32(hashes);
+
+      for (; data + 2 * SCALING <= end; data += SCALING)
+        {
+          const uint32x4_t chunk
+            = vmovl_u16(vget_low_u16(vmovl_u8(vld1_u8(data))));
+
+          hash = vmulq_u32(veorq_u32(hash, chunk), prime);
+        }
+
+      vst1q_u32(hashes, hash);
+    }
+#endif
+
   for (; data + SCALING <= end; data += SCALING)
     {
       hashes[0] ^= data[0];
@@ -120,6 +197,12 @@ svn__fnv1a_32(const void *input, apr_size_t len)
   return fnv1a_32(FNV1_BASE_32, input, len);
 }
 
+apr_uint64_t
+svn__fnv1a_64(const void *input, apr_size_t len)
+{
+  return fnv1a_64(FNV1_BASE_64, input, len);
+}
+
 apr_uint32_t
 svn__fnv1a_32x4(const void *input, apr_size_t len)
 {
@@ -151,6 +234,43 @@ svn__fnv1a_32x4_raw(apr_uint32_t hashes[4],
                        len - processed);
 }
 
+/* Murmur3-style bit mixer: a few shift-xor-multiply rounds suffice to
+ * let every bit of VALUE toggle about half of the result bits.
+ */
+static apr_uint32_t
+mix32(apr_uint32_t value)
+{
+  value ^= value >> 16;
+  value *= 0x85ebca6b;
+  value ^= value >> 13;
+  value *= 0xc2b2ae35;
+  value ^= value >> 16;
+
+  return value;
+}
+
+void
+svn__fnv1a_32x4_digest(unsigned char digest[16],
+                       const void *input,
+                       apr_size_t len)
+{
+  apr_uint32_t hashes[SCALING];
+  svn__fnv1a_32x4_raw(hashes, input, len);
+
+  /* FNV-1a multiplies last, so the low bits of each lane avalanche
+   * poorly, and two equal-length keys differing in a single byte leave
+   * 3 of the 4 lanes untouched.  Chain the lanes through the mixer to
+   * diffuse every input bit (and the input length) over the full digest.
+   */
+  hashes[0] = mix32(hashes[0] ^ (apr_uint32_t)len);
+  hashes[1] = mix32(hashes[1] ^ hashes[0]);
+  hashes[2] = mix32(hashes[2] ^ hashes[1]);
+  hashes[3] = mix32(hashes[3] ^ hashes[2]);
+  hashes[0] = mix32(hashes[0] ^ hashes[3]);
+
+  memcpy(digest, hashes, sizeof(hashes));
+}
+
 struct svn_fnv1a_32__context_t
 {
   apr_uint32_t hash;
@@ -94,6 +94,17 @@ svn__fnv1a_32x4_raw(apr_uint32_t hashes[4],
                     const void *input,
                     apr_size_t len);
 
+/* Set DIGEST to a 16 byte fingerprint of INPUT of LEN bytes, derived
+ * from the 4 interleaved FNV-1a hash sums with an extra avalanche mixing
+ * step.  Unlike svn__fnv1a_32x4_raw, every input bit affects all digest
+ * bits, making this a suitable replacement for cryptographic digests in
+ * contexts that only need good distribution, e.g. hash bucket selection.
+ */
+void
+svn__fnv1a_32x4_digest(unsigned char digest[16],
+                       const void *input,
+                       apr_size_t len);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -29,6 +29,32 @@
 #include <unistd.h>
 #endif
 
+/* Directory-handle-relative stat support.  Obtaining the stat data for
+   directory entries via fstatat() on the open directory handle avoids a
+   full kernel path resolution per entry, which is a significant cost
+   when scanning deep trees (e.g. during 'svn status').  Requires the
+   POSIX.1-2008 st_mtim stat member so that timestamps are filled with
+   the same resolution as APR uses. */
+#if defined(HAVE_FSTATAT) && defined(HAVE_DIRFD) \
+    && defined(HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC) \
+    && !defined(WIN32) && !defined(__OS2__)
+#include <sys/stat.h>
+#include <dirent.h>
+#define SVN_IO__DIR_RELATIVE_STAT
+#endif
+
+/* Kernel-offload file copy support.  copy_file_range() moves data
+   between two file descriptors inside the kernel, without bouncing
+   every byte through a userspace buffer, and filesystems with reflink
+   support may satisfy it without copying any data blocks at all.  Use
+   the raw syscall so that we do not depend on a recent C library. */
+#if defined(__linux__)
+#include <sys/syscall.h>
+#ifdef __NR_copy_file_range
+#define SVN_IO__USE_COPY_FILE_RANGE
+#endif
+#endif
+
 #ifndef APR_STATUS_IS_EPERM
 #include <errno.h>
 #ifdef EPERM
@@ -894,11 +920,49 @@ copy_contents(apr_file_t *from_file,
               apr_file_t *to_file,
               apr_pool_t *pool)
 {
+  /* Use a much larger buffer than SVN__STREAM_CHUNK_SIZE.  The files
+   * are opened unbuffered, i.e. every iteration translates into one
+   * read() plus one write() syscall.  For bulk copies of large files
+   * (hotcopy and pack moving rev data, in particular), the larger
+   * buffer reduces the syscall count to a fraction and lets the copy
+   * run at media speed. */
+  const apr_size_t buf_size = 16 * SVN__STREAM_CHUNK_SIZE;
+  char *buf;
+
+#ifdef SVN_IO__USE_COPY_FILE_RANGE
+  /* Try to let the kernel copy the data directly between the two file
+   * descriptors first.  If the syscall is not implemented or refuses
+   * this pair of files (e.g. special files, or different filesystems
+   * on older kernels), fall back to the read/write loop below.  Both
+   * file offsets are advanced by the syscall, so the fallback simply
+   * continues where the kernel stopped. */
+  {
+    apr_os_file_t fd_from;
+    apr_os_file_t fd_to;
+
+    if (apr_os_file_get(&fd_from, from_file) == APR_SUCCESS
+        && apr_os_file_get(&fd_to, to_file) == APR_SUCCESS)
+      {
+        while (1)
+          {
+            long bytes_copied = syscall(__NR_copy_file_range,
+                                        fd_from, NULL, fd_to, NULL,
+                                        (apr_size_t)16 * 1024 * 1024, 0);
+            if (bytes_copied == 0)
+              return APR_SUCCESS;       /* EOF */
+            if (bytes_copied < 0)
+              break;
+          }
+      }
+  }
+#endif
+
+  buf = apr_palloc(pool, buf_size);
+
   /* Copy bytes till the cows come home. */
   while (1)
     {
-      char buf[SVN__STREAM_CHUNK_SIZE];
-      apr_size_t bytes_this_time = sizeof(buf);
+      apr_size_t bytes_this_time = buf_size;
       apr_status_t read_err;
       apr_status_t write_err;
 
@@ -3096,6 +3160,9 @@ svn_io_get_dirents3(apr_hash_t **dirents,
   apr_dir_t *this_dir;
   apr_finfo_t this_entry;
   apr_int32_t flags = APR_FINFO_TYPE | APR_FINFO_NAME;
+#ifdef SVN_IO__DIR_RELATIVE_STAT
+  int dir_fd = -1;
+#endif
 
   if (!only_check_type)
     flags |= APR_FINFO_SIZE | APR_FINFO_MTIME;
@@ -3104,6 +3171,22 @@ svn_io_get_dirents3(apr_hash_t **dirents,
 
   SVN_ERR(svn_io_dir_open(&this_dir, path, scratch_pool));
 
+#ifdef SVN_IO__DIR_RELATIVE_STAT
+  /* With the directory handle at hand, we can stat each entry relative
+     to it instead of having the kernel resolve the full path again for
+     every single entry.  Restrict the data requested from APR to what
+     the directory entry itself provides, so APR won't stat either. */
+  if (!only_check_type)
+    {
+      DIR *os_dir;
+
+      if (apr_os_dir_get(&os_dir, this_dir) == APR_SUCCESS)
+        dir_fd = dirfd(os_dir);
+      if (dir_fd != -1)
+        flags = APR_FINFO_TYPE | APR_FINFO_NAME;
+    }
+#endif
+
   for (status = apr_dir_read(&this_entry, flags, this_dir);
        status == APR_SUCCESS;
        status = apr_dir_read(&this_entry, flags, this_dir))
@@ -3119,17 +3202,55 @@ svn_io_get_dirents3(apr_hash_t **dirents,
         {
           const char *name;
           svn_io_dirent2_t *dirent = svn_io_dirent2_create(result_pool);
+#ifdef SVN_IO__DIR_RELATIVE_STAT
+          struct stat st;
+#endif
 
           SVN_ERR(entry_name_to_utf8(&name, this_entry.name, path, result_pool));
 
-          map_apr_finfo_to_node_kind(&(dirent->kind),
-                                     &(dirent->special),
-                                     &this_entry);
-
-          if (!only_check_type)
+#ifdef SVN_IO__DIR_RELATIVE_STAT
+          if (dir_fd != -1
+              && fstatat(dir_fd, this_entry.name, &st,
+                         AT_SYMLINK_NOFOLLOW) == 0)
+            {
+              /* Mirrors map_apr_finfo_to_node_kind().  Like APR's
+                 per-entry stat, we do not follow symlinks here. */
+              if (S_ISREG(st.st_mode))
+                dirent->kind = svn_node_file;
+              else if (S_ISDIR(st.st_mode))
+                dirent->kind = svn_node_dir;
+              else if (S_ISLNK(st.st_mode))
+                {
+                  dirent->special = TRUE;
+                  dirent->kind = svn_node_file;
+                }
+              else
+                dirent->kind = svn_node_unknown;
+
+              /* Same microsecond conversion as APR's stat wrapper,
+                 so these timestamps compare equal to those obtained
+                 through svn_io_stat(). */
+              dirent->filesize = st.st_size;
+              dirent->mtime = apr_time_from_sec(st.st_mtim.tv_sec)
+                              + st.st_mtim.tv_nsec / 1000;
+            }
+          else
+#endif
             {
-              dirent->filesize = this_entry.size;
-              dirent->mtime = this_entry.mtime;
+              map_apr_finfo_to_node_kind(&(dirent->kind),
+                                         &(dirent->special),
+                                         &this_entry);
+
+              if (!only_check_type)
+                {
+                  /* In the directory-relative mode, these fields are
+                     only filled in if APR could provide them without
+                     an extra stat, e.g. not after an unlink race. */
+                  if (this_entry.valid & APR_FINFO_SIZE)
+                    dirent->filesize = this_entry.size;
+                  if (this_entry.valid & APR_FINFO_MTIME)
+                    dirent->mtime = this_entry.mtime;
+                }
             }
 
           svn_hash_sets(*dirents, name, dirent);
@@ -816,6 +816,137 @@ svn_mergeinfo_parse(svn_mergeinfo_t *mergeinfo,
   return err;
 }
 
+struct svn_mergeinfo__parse_context_t
+{
+  /* Pool holding the interned path strings and the prefix tree. */
+  apr_pool_t *pool;
+
+  /* Dedupes merge source paths across all parses with this context. */
+  svn_prefix_tree__t *tree;
+
+  /* Maps svn_prefix_string__t * (by pointer - equal strings yield the
+     same node) to the single expanded copy used as the hash key. */
+  apr_hash_t *paths;
+};
+
+svn_mergeinfo__parse_context_t *
+svn_mergeinfo__parse_context_create(apr_pool_t *pool)
+{
+  svn_mergeinfo__parse_context_t *context = apr_pcalloc(pool,
+                                                        sizeof(*context));
+
+  context->pool = pool;
+  context->tree = svn_prefix_tree__create(pool);
+  context->paths = svn_hash__make(pool);
+
+  return context;
+}
+
+/* Return CONTEXT's interned copy of PATHNAME, creating it if this is the
+ * first time the path has been seen by CONTEXT. */
+static const char *
+intern_pathname(svn_mergeinfo__parse_context_t *context,
+                const char *pathname)
+{
+  svn_prefix_string__t *key = svn_prefix_string__create(context->tree,
+                                                        pathname);
+  const char *interned = apr_hash_get(context->paths, &key, sizeof(key));
+
+  if (!interned)
+    {
+      interned = apr_pstrdup(context->pool, pathname);
+      apr_hash_set(context->paths,
+                   apr_pmemdup(context->pool, &key, sizeof(key)),
+                   sizeof(key), interned);
+    }
+
+  return interned;
+}
+
+/* Variant of parse_revision_line() for svn_mergeinfo__parse(): the path
+ * key is interned through CONTEXT and the final rangelist is stored as a
+ * single contiguous block of ranges instead of one allocation per range.
+ */
+static svn_error_t *
+parse_revision_line_packed(const char **input, const char *end,
+                           svn_mergeinfo_t hash,
+                           svn_mergeinfo__parse_context_t *context,
+                           apr_pool_t *scratch_pool)
+{
+  const char *pathname = "";
+  apr_ssize_t klen;
+  svn_rangelist_t *existing_rangelist;
+  apr_pool_t *result_pool = apr_hash_pool_get(hash);
+  svn_rangelist_t *rangelist = apr_array_make(scratch_pool, 1,
+                                              sizeof(svn_merge_range_t *));
+
+  SVN_ERR(parse_pathname(input, end, &pathname, scratch_pool));
+
+  if (*(*input) != ':')
+    return svn_error_create(SVN_ERR_MERGEINFO_PARSE_ERROR, NULL,
+                            _("Pathname not terminated by ':'"));
+
+  *input = *input + 1;
+
+  SVN_ERR(parse_rangelist(input, end, rangelist, scratch_pool));
+
+  if (rangelist->nelts == 0)
+      return svn_error_createf(SVN_ERR_MERGEINFO_PARSE_ERROR, NULL,
+                               _("Mergeinfo for '%s' maps to an "
+                                 "empty revision range"), pathname);
+  if (*input != end && *(*input) != '\n')
+    return svn_error_createf(SVN_ERR_MERGEINFO_PARSE_ERROR, NULL,
+                             _("Could not find end of line in range list line "
+                               "in '%s'"), *input);
+
+  if (*input != end)
+    *input = *input + 1;
+
+  SVN_ERR(svn_rangelist__canonicalize(rangelist, scratch_pool));
+
+  /* See parse_revision_line() for the reason behind this merge. */
+  klen = strlen(pathname);
+  existing_rangelist = apr_hash_get(hash, pathname, klen);
+  if (existing_rangelist)
+    SVN_ERR(svn_rangelist_merge2(rangelist, existing_rangelist,
+                                 scratch_pool, scratch_pool));
+
+  /* Store the final rangelist as one block of ranges plus the array of
+   * pointers into it. */
+  apr_hash_set(hash, intern_pathname(context, pathname), klen,
+               svn_rangelist__dup_packed(rangelist, result_pool));
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_mergeinfo__parse(svn_mergeinfo_t *mergeinfo,
+                     const char *input,
+                     svn_mergeinfo__parse_context_t *context,
+                     apr_pool_t *result_pool)
+{
+  svn_error_t *err = SVN_NO_ERROR;
+  const char *curr = input;
+  const char *end = input + strlen(input);
+  apr_pool_t *iterpool = svn_pool_create(result_pool);
+
+  *mergeinfo = svn_hash__make(result_pool);
+  while (curr < end && !err)
+    {
+      svn_pool_clear(iterpool);
+      err = parse_revision_line_packed(&curr, end, *mergeinfo, context,
+                                       iterpool);
+    }
+  svn_pool_destroy(iterpool);
+
+  /* Always return SVN_ERR_MERGEINFO_PARSE_ERROR as the topmost error. */
+  if (err && err->apr_err != SVN_ERR_MERGEINFO_PARSE_ERROR)
+    err = svn_error_createf(SVN_ERR_MERGEINFO_PARSE_ERROR, err,
+                            _("Could not parse mergeinfo string '%s'"),
+                            input);
+  return err;
+}
+
 static const char *
 rangelist_to_string_debug(const svn_rangelist_t *rl,
                           apr_pool_t *pool)
@@ -1858,6 +1989,242 @@ svn_mergeinfo_remove2(svn_mergeinfo_t *mergeinfo,
                                       scratch_pool);
 }
 
+svn_rangelist_t *
+svn_rangelist__dup_packed(const svn_rangelist_t *rangelist,
+                          apr_pool_t *result_pool)
+{
+  svn_rangelist_t *packed = apr_array_make(result_pool, rangelist->nelts,
+                                           sizeof(svn_merge_range_t *));
+  svn_merge_range_t *ranges = apr_palloc(result_pool,
+                                         rangelist->nelts * sizeof(*ranges));
+  int i;
+
+  for (i = 0; i < rangelist->nelts; i++)
+    {
+      ranges[i] = *APR_ARRAY_IDX(rangelist, i, svn_merge_range_t *);
+      APR_ARRAY_PUSH(packed, svn_merge_range_t *) = &ranges[i];
+    }
+
+  return packed;
+}
+
+svn_mergeinfo_t
+svn_mergeinfo__dup_packed(svn_mergeinfo_t mergeinfo,
+                          apr_pool_t *result_pool,
+                          apr_pool_t *scratch_pool)
+{
+  svn_mergeinfo_t new_mergeinfo = svn_hash__make(result_pool);
+  apr_hash_index_t *hi;
+
+  for (hi = apr_hash_first(scratch_pool, mergeinfo);
+       hi; hi = apr_hash_next(hi))
+    {
+      const char *path;
+      apr_ssize_t klen;
+      svn_rangelist_t *rangelist;
+
+      apr_hash_this(hi, (const void **)&path, &klen, (void **)&rangelist);
+      apr_hash_set(new_mergeinfo, apr_pstrmemdup(result_pool, path, klen),
+                   klen, svn_rangelist__dup_packed(rangelist, result_pool));
+    }
+
+  return new_mergeinfo;
+}
+
+/* The mergeinfo-level worker for the bulk catalog set operations:  set
+   *RESULT to the intersection of MERGEINFO1 and MERGEINFO2 or, if
+   DO_REMOVE is set, to MERGEINFO2 with all revision ranges of MERGEINFO1
+   removed.  Instead of probing one hash while iterating the other, walk
+   both path sets in a single sorted merged iteration, reusing the sort
+   allocations in SCRATCH_POOL, and store the output rangelists packed.
+   Allocate *RESULT in RESULT_POOL. */
+static svn_error_t *
+mergeinfo_bulk_operation(svn_mergeinfo_t *result,
+                         svn_mergeinfo_t mergeinfo1,
+                         svn_mergeinfo_t mergeinfo2,
+                         svn_boolean_t do_remove,
+                         svn_boolean_t consider_inheritance,
+                         apr_pool_t *result_pool,
+                         apr_pool_t *scratch_pool)
+{
+  apr_array_header_t *sorted1
+    = svn_sort__hash(mergeinfo1, svn_sort_compare_items_as_paths,
+                     scratch_pool);
+  apr_array_header_t *sorted2
+    = svn_sort__hash(mergeinfo2, svn_sort_compare_items_as_paths,
+                     scratch_pool);
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  int i1 = 0;
+  int i2 = 0;
+
+  *result = svn_hash__make(result_pool);
+
+  while (i1 < sorted1->nelts && i2 < sorted2->nelts)
+    {
+      svn_sort__item_t elt1 = APR_ARRAY_IDX(sorted1, i1, svn_sort__item_t);
+      svn_sort__item_t elt2 = APR_ARRAY_IDX(sorted2, i2, svn_sort__item_t);
+      int res = svn_sort_compare_items_as_paths(&elt1, &elt2);
+
+      if (res == 0)  /* Both sides have ranges for this path. */
+        {
+          svn_rangelist_t *output;
+
+          svn_pool_clear(iterpool);
+          SVN_ERR(rangelist_intersect_or_remove(&output, elt1.value,
+                                                elt2.value, do_remove,
+                                                consider_inheritance,
+                                                iterpool));
+          if (output->nelts > 0)
+            apr_hash_set(*result,
+                         apr_pstrmemdup(result_pool, elt1.key, elt1.klen),
+                         elt1.klen,
+                         svn_rangelist__dup_packed(output, result_pool));
+          i1++;
+          i2++;
+        }
+      else if (res < 0)  /* Only MERGEINFO1 covers this path. */
+        {
+          i1++;
+        }
+      else  /* Only MERGEINFO2 covers this path. */
+        {
+          /* Nothing to remove from this path's ranges. */
+          if (do_remove)
+            apr_hash_set(*result,
+                         apr_pstrmemdup(result_pool, elt2.key, elt2.klen),
+                         elt2.klen,
+                         svn_rangelist__dup_packed(elt2.value, result_pool));
+          i2++;
+        }
+    }
+
+  /* Ditto for MERGEINFO2 paths beyond the last MERGEINFO1 path. */
+  if (do_remove)
+    for (; i2 < sorted2->nelts; i2++)
+      {
+        svn_sort__item_t elt2 = APR_ARRAY_IDX(sorted2, i2, svn_sort__item_t);
+
+        apr_hash_set(*result,
+                     apr_pstrmemdup(result_pool, elt2.key, elt2.klen),
+                     elt2.klen,
+                     svn_rangelist__dup_packed(elt2.value, result_pool));
+      }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Shared guts of svn_mergeinfo__catalog_intersect and
+   svn_mergeinfo__catalog_remove, built like svn_mergeinfo_catalog_merge:
+   a sorted merged iteration over both catalogs' keys which delegates the
+   per-path work to mergeinfo_bulk_operation(). */
+static svn_error_t *
+catalog_bulk_operation(svn_mergeinfo_catalog_t *result_catalog,
+                       svn_mergeinfo_catalog_t catalog1,
+                       svn_mergeinfo_catalog_t catalog2,
+                       svn_boolean_t do_remove,
+                       svn_boolean_t consider_inheritance,
+                       apr_pool_t *result_pool,
+                       apr_pool_t *scratch_pool)
+{
+  apr_array_header_t *sorted1
+    = svn_sort__hash(catalog1, svn_sort_compare_items_as_paths,
+                     scratch_pool);
+  apr_array_header_t *sorted2
+    = svn_sort__hash(catalog2, svn_sort_compare_items_as_paths,
+                     scratch_pool);
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  int i1 = 0;
+  int i2 = 0;
+
+  *result_catalog = svn_hash__make(result_pool);
+
+  while (i1 < sorted1->nelts && i2 < sorted2->nelts)
+    {
+      svn_sort__item_t elt1 = APR_ARRAY_IDX(sorted1, i1, svn_sort__item_t);
+      svn_sort__item_t elt2 = APR_ARRAY_IDX(sorted2, i2, svn_sort__item_t);
+      int res = svn_sort_compare_items_as_paths(&elt1, &elt2);
+
+      if (res == 0)  /* Both catalogs have mergeinfo for this path. */
+        {
+          svn_mergeinfo_t mergeinfo;
+
+          svn_pool_clear(iterpool);
+          SVN_ERR(mergeinfo_bulk_operation(&mergeinfo, elt1.value, elt2.value,
+                                           do_remove, consider_inheritance,
+                                           result_pool, iterpool));
+          if (apr_hash_count(mergeinfo))
+            apr_hash_set(*result_catalog,
+                         apr_pstrmemdup(result_pool, elt1.key, elt1.klen),
+                         elt1.klen, mergeinfo);
+          i1++;
+          i2++;
+        }
+      else if (res < 0)  /* Only CATALOG1 has mergeinfo for this path. */
+        {
+          i1++;
+        }
+      else  /* Only CATALOG2 has mergeinfo for this path. */
+        {
+          if (do_remove)
+            {
+              svn_pool_clear(iterpool);
+              apr_hash_set(*result_catalog,
+                           apr_pstrmemdup(result_pool, elt2.key, elt2.klen),
+                           elt2.klen,
+                           svn_mergeinfo__dup_packed(elt2.value, result_pool,
+                                                iterpool));
+            }
+          i2++;
+        }
+    }
+
+  /* Keep any remaining CATALOG2 entries when removing. */
+  if (do_remove)
+    for (; i2 < sorted2->nelts; i2++)
+      {
+        svn_sort__item_t elt2 = APR_ARRAY_IDX(sorted2, i2, svn_sort__item_t);
+
+        svn_pool_clear(iterpool);
+        apr_hash_set(*result_catalog,
+                     apr_pstrmemdup(result_pool, elt2.key, elt2.klen),
+                     elt2.klen,
+                     svn_mergeinfo__dup_packed(elt2.value, result_pool, iterpool));
+      }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_mergeinfo__catalog_intersect(svn_mergeinfo_catalog_t *result_catalog,
+                                 svn_mergeinfo_catalog_t catalog1,
+                                 svn_mergeinfo_catalog_t catalog2,
+                                 svn_boolean_t consider_inheritance,
+                                 apr_pool_t *result_pool,
+                                 apr_pool_t *scratch_pool)
+{
+  return catalog_bulk_operation(result_catalog, catalog1, catalog2, FALSE,
+                                consider_inheritance, result_pool,
+                                scratch_pool);
+}
+
+svn_error_t *
+svn_mergeinfo__catalog_remove(svn_mergeinfo_catalog_t *result_catalog,
+                              svn_mergeinfo_catalog_t eraser_catalog,
+                              svn_mergeinfo_catalog_t whiteboard_catalog,
+                              svn_boolean_t consider_inheritance,
+                              apr_pool_t *result_pool,
+                              apr_pool_t *scratch_pool)
+{
+  return catalog_bulk_operation(result_catalog, eraser_catalog,
+                                whiteboard_catalog, TRUE,
+                                consider_inheritance, result_pool,
+                                scratch_pool);
+}
+
 svn_error_t *
 svn_rangelist_to_string(svn_string_t **output,
                         const svn_rangelist_t *rangelist,
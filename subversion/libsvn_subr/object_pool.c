@@ -57,6 +57,11 @@ typedef struct object_ref_t
 
   /* Number of references to this data struct */
   volatile svn_atomic_t ref_count;
+
+  /* Next element in a temporary chain of entries evicted from the index.
+   * Only valid between being unlinked in remove_unused_objects() and the
+   * deferred pool destruction in svn_object_pool__insert(). */
+  struct object_ref_t *next;
 } object_ref_t;
 
 
@@ -102,12 +107,16 @@ object_pool_cleanup(void *baton)
   return APR_SUCCESS;
 }
 
-/* Remove entries from OBJECTS in OBJECT_POOL that have a ref-count of 0.
+/* Remove entries from OBJECTS in OBJECT_POOL that have a ref-count of 0
+ * and chain them in *DOOMED.  Once unlinked, an entry can no longer be
+ * found or referenced, so the caller shall destroy the chained entries'
+ * pools - preferably after releasing the serialization object.
  *
  * Requires external serialization on OBJECT_POOL.
  */
 static void
-remove_unused_objects(svn_object_pool__t *object_pool)
+remove_unused_objects(svn_object_pool__t *object_pool,
+                      object_ref_t **doomed)
 {
   apr_pool_t *subpool = svn_pool_create(object_pool->pool);
 
@@ -128,7 +137,8 @@ remove_unused_objects(svn_object_pool__t *object_pool)
           svn_atomic_dec(&object_pool->object_count);
           svn_atomic_dec(&object_pool->unused_count);
 
-          svn_pool_destroy(object_ref->pool);
+          object_ref->next = *doomed;
+          *doomed = object_ref;
         }
     }
 
@@ -206,6 +216,10 @@ lookup(void **object,
 }
 
 /* Actual implementation of svn_object_pool__insert.
+ *
+ * Pools that are no longer needed get chained in *DOOMED respectively
+ * returned in *DUPLICATE_POOL instead of being destroyed right away;
+ * see svn_object_pool__insert().
  *
  * Requires external serialization on OBJECT_POOL.
  */
@@ -215,16 +229,19 @@ insert(void **object,
        const svn_membuf_t *key,
        void *item,
        apr_pool_t *item_pool,
+       object_ref_t **doomed,
+       apr_pool_t **duplicate_pool,
        apr_pool_t *result_pool)
 {
   object_ref_t *object_ref
     = apr_hash_get(object_pool->objects, key->data, key->size);
   if (object_ref)
     {
-      /* Destroy the new one and return a reference to the existing one
-       * because the existing one may already have references on it.
+      /* The new object shall be discarded and a reference to the existing
+       * one returned because the existing one may already have references
+       * on it.
        */
-      svn_pool_destroy(item_pool);
+      *duplicate_pool = item_pool;
     }
   else
     {
@@ -255,7 +272,7 @@ insert(void **object,
   /* limit memory usage */
   if (svn_atomic_read(&object_pool->unused_count) * 2
       > apr_hash_count(object_pool->objects) + 2)
-    remove_unused_objects(object_pool);
+    remove_unused_objects(object_pool, doomed);
 
   return SVN_NO_ERROR;
 }
@@ -319,9 +336,27 @@ svn_object_pool__insert(void **object,
                         apr_pool_t *item_pool,
                         apr_pool_t *result_pool)
 {
+  object_ref_t *doomed = NULL;
+  apr_pool_t *duplicate_pool = NULL;
+
   *object = NULL;
   SVN_MUTEX__WITH_LOCK(object_pool->mutex,
-                       insert(object, object_pool, key, item,
-                              item_pool, result_pool));
+                       insert(object, object_pool, key, item, item_pool,
+                              &doomed, &duplicate_pool, result_pool));
+
+  /* Destroy discarded and evicted objects only now, after releasing the
+   * mutex.  Pool destruction is by far the most expensive part of the
+   * critical section (cleanup handlers, allocator traffic) and every
+   * lookup in this object pool would be blocked on it otherwise. */
+  if (duplicate_pool)
+    svn_pool_destroy(duplicate_pool);
+
+  while (doomed)
+    {
+      object_ref_t *next = doomed->next;
+      svn_pool_destroy(doomed->pool);
+      doomed = next;
+    }
+
   return SVN_NO_ERROR;
 }
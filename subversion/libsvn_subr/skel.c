@@ -393,6 +393,218 @@ explicit_atom(const char *data,
 }
 
 
+/* Non-recursive parsing into a contiguous node slab.  */
+
+/* First pass of svn_skel__parse_in_place(): scan the skel at the start
+   of the LEN bytes at DATA without building nodes.  If it is
+   well-formed, return TRUE and set *NODE_COUNT to the number of skel
+   objects it contains and *MAX_DEPTH to its maximum list nesting depth.
+   Trailing data after the skel is ignored, as in parse().  */
+static svn_boolean_t
+scan_skel(apr_size_t *node_count,
+          apr_size_t *max_depth,
+          const char *data,
+          apr_size_t len)
+{
+  const char *end = data + len;
+  apr_size_t depth = 0;
+  apr_size_t nodes = 0;
+  apr_size_t deepest = 0;
+
+  /* The empty string isn't a valid skel.  */
+  if (len <= 0)
+    return FALSE;
+
+  do
+    {
+      char c;
+
+      if (depth > 0)
+        {
+          /* Skip any whitespace between list elements.  */
+          while (data < end
+                 && skel_char_type[(unsigned char) *data] == type_space)
+            data++;
+
+          /* End of data, but no closing paren?  */
+          if (data >= end)
+            return FALSE;
+
+          /* End of the current list?  */
+          if (*data == ')')
+            {
+              depth--;
+              data++;
+              continue;
+            }
+        }
+
+      c = *data;
+      if (c == '(')
+        {
+          nodes++;
+          depth++;
+          if (depth > deepest)
+            deepest = depth;
+          data++;
+        }
+      else if (skel_char_type[(unsigned char) c] == type_name)
+        {
+          /* An atom with implicit length.  */
+          nodes++;
+          while (++data < end
+                 && skel_char_type[(unsigned char) *data] != type_space
+                 && skel_char_type[(unsigned char) *data] != type_paren)
+            ;
+        }
+      else
+        {
+          /* An atom with explicit length, or garbage.  */
+          const char *next;
+          apr_size_t size = getsize(data, end - data, &next, end - data);
+
+          if (! next
+              || next >= end
+              || skel_char_type[(unsigned char) *next] != type_space)
+            return FALSE;
+
+          data = next + 1;
+          if ((apr_size_t)(end - data) < size)
+            return FALSE;
+
+          nodes++;
+          data += size;
+        }
+    }
+  while (depth > 0);
+
+  *node_count = nodes;
+  *max_depth = deepest;
+  return TRUE;
+}
+
+/* An open list on the parse stack of fill_skel().  */
+typedef struct parse_frame_t
+{
+  /* The list node being filled in.  */
+  svn_skel_t *list;
+
+  /* Where to link the list's next child.  */
+  svn_skel_t **tail;
+} parse_frame_t;
+
+/* Second pass of svn_skel__parse_in_place(): build the tree for the
+   skel at the start of the LEN bytes at DATA, which scan_skel() found
+   to be well-formed, by filling in the zeroed node slab NODES in
+   pre-order.  STACK, with room for one frame per nesting level, holds
+   the currently open lists.  Return the root node, i.e. NODES.  */
+static svn_skel_t *
+fill_skel(svn_skel_t *nodes,
+          parse_frame_t *stack,
+          const char *data,
+          apr_size_t len)
+{
+  const char *end = data + len;
+  apr_size_t depth = 0;
+  svn_skel_t *next_node = nodes;
+
+  do
+    {
+      svn_skel_t *s;
+      char c;
+
+      if (depth > 0)
+        {
+          while (data < end
+                 && skel_char_type[(unsigned char) *data] == type_space)
+            data++;
+
+          if (*data == ')')
+            {
+              /* Close the current list.  Its body extends up to and
+                 including the closing paren.  */
+              data++;
+              depth--;
+              stack[depth].list->len = data - stack[depth].list->data;
+              continue;
+            }
+        }
+
+      /* Take the next node off the slab and link it into the innermost
+         open list.  The slab came from apr_pcalloc(), so CHILDREN and
+         NEXT are already NULL.  */
+      s = next_node++;
+      if (depth > 0)
+        {
+          *stack[depth - 1].tail = s;
+          stack[depth - 1].tail = &s->next;
+        }
+
+      c = *data;
+      if (c == '(')
+        {
+          s->is_atom = FALSE;
+          s->data = data;
+          stack[depth].list = s;
+          stack[depth].tail = &s->children;
+          depth++;
+          data++;
+        }
+      else if (skel_char_type[(unsigned char) c] == type_name)
+        {
+          s->is_atom = TRUE;
+          s->data = data;
+          while (++data < end
+                 && skel_char_type[(unsigned char) *data] != type_space
+                 && skel_char_type[(unsigned char) *data] != type_paren)
+            ;
+          s->len = data - s->data;
+        }
+      else
+        {
+          const char *next;
+          apr_size_t size = getsize(data, end - data, &next, end - data);
+
+          data = next + 1;
+          s->is_atom = TRUE;
+          s->data = data;
+          s->len = size;
+          data += size;
+        }
+    }
+  while (depth > 0);
+
+  return nodes;
+}
+
+/* For shallow skels --- the vast majority --- fill_skel() can use a
+   stack allocated on the C stack instead of in the caller's pool.  */
+#define PARSE_STACK_SIZE 16
+
+svn_skel_t *
+svn_skel__parse_in_place(const char *data,
+                         apr_size_t len,
+                         apr_pool_t *pool)
+{
+  apr_size_t node_count;
+  apr_size_t max_depth;
+  svn_skel_t *nodes;
+  parse_frame_t local_stack[PARSE_STACK_SIZE];
+  parse_frame_t *stack = local_stack;
+
+  if (! scan_skel(&node_count, &max_depth, data, len))
+    return NULL;
+
+  /* A single allocation covers the whole tree; pre-order filling keeps
+     parents and children on the same cache lines.  */
+  nodes = apr_pcalloc(pool, node_count * sizeof(*nodes));
+  if (max_depth > PARSE_STACK_SIZE)
+    stack = apr_palloc(pool, max_depth * sizeof(*stack));
+
+  return fill_skel(nodes, stack, data, len);
+}
+
+
 
 /* Unparsing skeletons.  */
 
@@ -144,6 +144,153 @@ svn_sort__array(apr_array_header_t *array,
   qsort(array->elts, array->nelts, array->elt_size, comparison_func);
 }
 
+/* Threshold up to which multikey_sort_paths() uses a simple insertion
+ * sort instead of partitioning further. */
+#define MULTIKEY_SORT_CUTOFF 16
+
+/* Map C to the character ordering used by svn_path_compare_paths():
+ * '/' sorts before any other non-NUL character, making children of a
+ * directory sort right after it.  Canonical paths cannot contain
+ * control characters, so remapping '/' to 0x01 cannot collide.
+ */
+static APR_INLINE unsigned char
+path_sort_key(char c)
+{
+  return c == '/' ? 0x01 : (unsigned char)c;
+}
+
+/* Compare the suffixes of paths A and B starting at byte DEPTH, using
+ * the ordering of svn_path_compare_paths().  Both paths are known to
+ * be equal up to DEPTH.
+ */
+static int
+path_suffix_cmp(const char *a, const char *b, apr_size_t depth)
+{
+  a += depth;
+  b += depth;
+  while (*a && path_sort_key(*a) == path_sort_key(*b))
+    {
+      ++a;
+      ++b;
+    }
+
+  return (int)path_sort_key(*a) - (int)path_sort_key(*b);
+}
+
+/* Sort the N paths in PATHS, all known to be equal up to byte DEPTH,
+ * into svn_path_compare_paths() order.
+ *
+ * This is a multikey quicksort (Bentley & Sedgewick): partition on the
+ * single byte at DEPTH and recurse into the "equal" partition with
+ * DEPTH + 1, so the shared prefix of a partition is never compared
+ * again.  That makes the sort linear in the total number of distinct
+ * path bytes instead of paying full string comparisons per step, which
+ * matters for the long common prefixes of deep trees.
+ */
+static void
+multikey_sort_paths(const char **paths, apr_size_t n, apr_size_t depth)
+{
+  while (n > MULTIKEY_SORT_CUTOFF)
+    {
+      unsigned char pivot;
+      apr_size_t less = 0;      /* end of the "< pivot" section */
+      apr_size_t greater = n;   /* start of the "> pivot" section */
+      apr_size_t i = 0;
+      apr_size_t left, middle, right;
+      const char *temp;
+
+      /* Median-of-three pivot selection on the byte at DEPTH. */
+      {
+        unsigned char a = path_sort_key(paths[0][depth]);
+        unsigned char b = path_sort_key(paths[n / 2][depth]);
+        unsigned char c = path_sort_key(paths[n - 1][depth]);
+
+        pivot = a < b ? (b < c ? b : (a < c ? c : a))
+                      : (a < c ? a : (b < c ? c : b));
+      }
+
+      /* Three-way partition by the byte at DEPTH. */
+      while (i < greater)
+        {
+          unsigned char c = path_sort_key(paths[i][depth]);
+          if (c < pivot)
+            {
+              temp = paths[less];
+              paths[less] = paths[i];
+              paths[i] = temp;
+              ++less;
+              ++i;
+            }
+          else if (c > pivot)
+            {
+              --greater;
+              temp = paths[greater];
+              paths[greater] = paths[i];
+              paths[i] = temp;
+            }
+          else
+            {
+              ++i;
+            }
+        }
+
+      /* Recurse into the two smaller sections and iterate on the
+       * largest one to keep the recursion depth logarithmic.  The
+       * "equal" section advances to the next byte; if the pivot is NUL,
+       * all its paths ended at DEPTH and are duplicates, i.e. sorted. */
+      left = less;
+      middle = greater - less;
+      right = n - greater;
+
+      if (left >= middle && left >= right)
+        {
+          if (pivot)
+            multikey_sort_paths(paths + less, middle, depth + 1);
+          multikey_sort_paths(paths + greater, right, depth);
+          n = left;
+        }
+      else if (middle >= right)
+        {
+          multikey_sort_paths(paths, left, depth);
+          multikey_sort_paths(paths + greater, right, depth);
+          if (!pivot)
+            return;
+          paths += less;
+          n = middle;
+          ++depth;
+        }
+      else
+        {
+          multikey_sort_paths(paths, left, depth);
+          if (pivot)
+            multikey_sort_paths(paths + less, middle, depth + 1);
+          paths += greater;
+          n = right;
+        }
+    }
+
+  /* Insertion sort for small sections; the comparison can still skip
+   * the section's shared prefix. */
+  {
+    apr_size_t i, k;
+    for (i = 1; i < n; ++i)
+      for (k = i;
+           k > 0 && path_suffix_cmp(paths[k - 1], paths[k], depth) > 0;
+           --k)
+        {
+          const char *temp = paths[k];
+          paths[k] = paths[k - 1];
+          paths[k - 1] = temp;
+        }
+  }
+}
+
+void
+svn_sort__array_paths(apr_array_header_t *array)
+{
+  multikey_sort_paths((const char **)array->elts, array->nelts, 0);
+}
+
 apr_array_header_t *
 svn_sort__hash(apr_hash_t *ht,
                int (*comparison_func)(const svn_sort__item_t *,
@@ -541,3 +688,122 @@ svn_priority_queue__push(svn_priority_queue__t *queue,
   memcpy(apr_array_push(queue->elements), element, queue->elements->elt_size);
   heap_bubble_down(queue, queue->elements->nelts - 1);
 }
+
+/* Minimum number of pending insertions before we bother consolidating
+ * on behalf of a lookup. */
+#define SORTED_ARRAY_MIN_PENDING 64
+
+struct svn_sorted_array__t
+{
+  /* the wrapped array; sorted except for the elements in PENDING */
+  apr_array_header_t *elements;
+
+  /* insertions not merged into ELEMENTS yet, in insertion order */
+  apr_array_header_t *pending;
+
+  /* element ordering of ELEMENTS */
+  int (*compare_func)(const void *, const void *);
+};
+
+/* Merge all elements in ARRAY's pending buffer into its main array. */
+static void
+sorted_array_consolidate(svn_sorted_array__t *array)
+{
+  apr_array_header_t *elements = array->elements;
+  apr_array_header_t *pending = array->pending;
+  apr_size_t elt_size = elements->elt_size;
+  int source, merge, target, i;
+
+  if (pending->nelts == 0)
+    return;
+
+  svn_sort__array(pending, array->compare_func);
+
+  /* Grow the main array by the number of pending elements. */
+  for (i = 0; i < pending->nelts; ++i)
+    apr_array_push(elements);
+
+  /* Merge from the back, so each element gets moved at most once.
+   * If all pending elements sort after the existing ones - the common
+   * case when insertions come in roughly ascending order - the loop
+   * degenerates into a plain copy of the pending buffer. */
+  target = elements->nelts - 1;
+  source = elements->nelts - pending->nelts - 1;
+  for (merge = pending->nelts - 1; merge >= 0; --target)
+    {
+      const char *merge_elt = pending->elts + merge * elt_size;
+
+      if (   source >= 0
+          && array->compare_func(elements->elts + source * elt_size,
+                                 merge_elt) > 0)
+        {
+          memcpy(elements->elts + target * elt_size,
+                 elements->elts + source * elt_size, elt_size);
+          --source;
+        }
+      else
+        {
+          memcpy(elements->elts + target * elt_size, merge_elt, elt_size);
+          --merge;
+        }
+    }
+
+  pending->nelts = 0;
+}
+
+svn_sorted_array__t *
+svn_sorted_array__create(apr_array_header_t *elements,
+                         int (*compare_func)(const void *, const void *),
+                         apr_pool_t *pool)
+{
+  svn_sorted_array__t *array = apr_palloc(pool, sizeof(*array));
+  array->elements = elements;
+  array->pending = apr_array_make(pool, 16, elements->elt_size);
+  array->compare_func = compare_func;
+
+  return array;
+}
+
+void
+svn_sorted_array__insert(svn_sorted_array__t *array,
+                         const void *element)
+{
+  memcpy(apr_array_push(array->pending), element, array->pending->elt_size);
+}
+
+void *
+svn_sorted_array__lookup(svn_sorted_array__t *array,
+                         const void *key,
+                         int (*compare_func)(const void *, const void *))
+{
+  void *result;
+  int i;
+
+  /* Consolidate once the linear scan below would get more expensive
+   * than its share of the merge, i.e. at about sqrt(N) pending items. */
+  if (   array->pending->nelts >= SORTED_ARRAY_MIN_PENDING
+      && (apr_uint64_t)array->pending->nelts * array->pending->nelts
+         >= (apr_uint64_t)array->elements->nelts)
+    sorted_array_consolidate(array);
+
+  result = svn_sort__array_lookup(array->elements, key, NULL, compare_func);
+  if (result)
+    return result;
+
+  /* The pending buffer is small; scan it linearly. */
+  for (i = 0; i < array->pending->nelts; ++i)
+    {
+      void *element = array->pending->elts
+                      + i * array->pending->elt_size;
+      if (compare_func(element, key) == 0)
+        return element;
+    }
+
+  return NULL;
+}
+
+void
+svn_sorted_array__flush(svn_sorted_array__t *array)
+{
+  sorted_array_consolidate(array);
+}
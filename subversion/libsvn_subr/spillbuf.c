@@ -87,6 +87,12 @@ struct svn_spillbuf_t {
 
   /* The name of the temporary spill file. */
   const char *filename;
+
+  /* An outstanding reservation made by svn_spillbuf__reserve(), or NULL
+     when no reservation is pending. When it equals TAIL, the caller was
+     handed the free space of the tail block; otherwise it is a fresh
+     block that has not been linked into the list yet. */
+  struct memblock_t *reserved;
 };
 
 
@@ -230,6 +236,45 @@ return_buffer(svn_spillbuf_t *buf,
 }
 
 
+/* Create the spill file for BUF and optionally dump the in-memory
+   content into it, per BUF->SPILL_ALL_CONTENTS.  */
+static svn_error_t *
+create_spill(svn_spillbuf_t *buf,
+             apr_pool_t *scratch_pool)
+{
+  SVN_ERR(svn_io_open_unique_file3(&buf->spill,
+                                   &buf->filename,
+                                   buf->dirpath,
+                                   (buf->delete_on_close
+                                    ? svn_io_file_del_on_close
+                                    : svn_io_file_del_none),
+                                   buf->pool, scratch_pool));
+
+  /* Optionally write the memory contents into the file. */
+  if (buf->spill_all_contents)
+    {
+      struct memblock_t *mem = buf->head;
+
+      while (mem != NULL)
+        {
+          SVN_ERR(svn_io_file_write_full(buf->spill, mem->data, mem->size,
+                                         NULL, scratch_pool));
+          mem = mem->next;
+        }
+
+      /* Adjust the start offset for reading from the spill file.
+
+         This way, the first `buf->memory_size` bytes of data will
+         be read from the existing in-memory buffers, which makes
+         more sense than discarding the buffers and re-reading
+         data from the file. */
+      buf->spill_start = buf->memory_size;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+
 svn_error_t *
 svn_spillbuf__write(svn_spillbuf_t *buf,
                     const char *data,
@@ -243,35 +288,7 @@ svn_spillbuf__write(svn_spillbuf_t *buf,
      the temporary file.  */
   if (buf->spill == NULL
       && ((buf->maxsize - buf->memory_size) < len))
-    {
-      SVN_ERR(svn_io_open_unique_file3(&buf->spill,
-                                       &buf->filename,
-                                       buf->dirpath,
-                                       (buf->delete_on_close
-                                        ? svn_io_file_del_on_close
-                                        : svn_io_file_del_none),
-                                       buf->pool, scratch_pool));
-
-      /* Optionally write the memory contents into the file. */
-      if (buf->spill_all_contents)
-        {
-          mem = buf->head;
-          while (mem != NULL)
-            {
-              SVN_ERR(svn_io_file_write_full(buf->spill, mem->data, mem->size,
-                                             NULL, scratch_pool));
-              mem = mem->next;
-            }
-
-          /* Adjust the start offset for reading from the spill file.
-
-             This way, the first `buf->memory_size` bytes of data will
-             be read from the existing in-memory buffers, which makes
-             more sense than discarding the buffers and re-reading
-             data from the file. */
-          buf->spill_start = buf->memory_size;
-        }
-    }
+    SVN_ERR(create_spill(buf, scratch_pool));
 
   /* Once a spill file has been constructed, then we need to put all
      arriving data into the file. We will no longer attempt to hold it
@@ -344,6 +361,121 @@ svn_spillbuf__write(svn_spillbuf_t *buf,
 }
 
 
+svn_error_t *
+svn_spillbuf__reserve(char **data,
+                      apr_size_t *len,
+                      svn_spillbuf_t *buf,
+                      apr_pool_t *scratch_pool)
+{
+  struct memblock_t *mem;
+
+  if (buf->reserved != NULL)
+    return svn_error_create(SVN_ERR_INCORRECT_PARAMS, NULL, NULL);
+
+  /* A reservation may bring up to BLOCKSIZE further bytes. If that would
+     grow the in-memory content too large, switch to the spill file now,
+     just like svn_spillbuf__write() would.  */
+  if (buf->spill == NULL
+      && ((buf->maxsize - buf->memory_size) < buf->blocksize))
+    SVN_ERR(create_spill(buf, scratch_pool));
+
+  /* While we are buffering in memory, hand out the free space of the
+     tail block, so that producers filling the buffer in small pieces
+     do not burn a block per reservation.  */
+  if (buf->spill == NULL
+      && buf->tail != NULL
+      && buf->tail->size < buf->blocksize)
+    {
+      buf->reserved = buf->tail;
+      *data = &buf->tail->data[buf->tail->size];
+      *len = buf->blocksize - buf->tail->size;
+
+      return SVN_NO_ERROR;
+    }
+
+  /* Hand out a fresh block. It remains unlinked until the commit; if the
+     content has spilled, the commit will write it to the file instead.  */
+  mem = get_buffer(buf);
+  mem->size = 0;
+  mem->next = NULL;
+
+  buf->reserved = mem;
+  *data = mem->data;
+  *len = buf->blocksize;
+
+  return SVN_NO_ERROR;
+}
+
+
+svn_error_t *
+svn_spillbuf__commit(svn_spillbuf_t *buf,
+                     apr_size_t len,
+                     apr_pool_t *scratch_pool)
+{
+  struct memblock_t *mem = buf->reserved;
+
+  if (mem == NULL)
+    return svn_error_create(SVN_ERR_INCORRECT_PARAMS, NULL, NULL);
+  buf->reserved = NULL;
+
+  /* The caller wrote into the tail block's free space.  */
+  if (mem == buf->tail)
+    {
+      if (len > buf->blocksize - mem->size)
+        return svn_error_create(SVN_ERR_INCORRECT_PARAMS, NULL, NULL);
+
+      mem->size += len;
+      buf->memory_size += len;
+
+      return SVN_NO_ERROR;
+    }
+
+  if (len > buf->blocksize)
+    return svn_error_create(SVN_ERR_INCORRECT_PARAMS, NULL, NULL);
+
+  /* Nothing was produced after all; recycle the block.  */
+  if (len == 0)
+    {
+      return_buffer(buf, mem);
+      return SVN_NO_ERROR;
+    }
+
+  /* Once the content has spilled, all arriving data belongs into the
+     file; the reserved block merely served as a staging area.  */
+  if (buf->spill != NULL)
+    {
+      apr_off_t output_unused = 0;  /* ### stupid API  */
+
+      SVN_ERR(svn_io_file_seek(buf->spill,
+                               APR_END, &output_unused,
+                               scratch_pool));
+      SVN_ERR(svn_io_file_write_full(buf->spill, mem->data, len,
+                                     NULL, scratch_pool));
+      buf->spill_size += len;
+
+      return_buffer(buf, mem);
+      return SVN_NO_ERROR;
+    }
+
+  /* Link the now-filled block onto the end of the list.  */
+  mem->size = len;
+  buf->memory_size += len;
+
+  if (buf->tail == NULL)
+    {
+      buf->head = mem;
+      buf->tail = mem;
+    }
+  else
+    {
+      buf->tail->next = mem;
+      buf->tail = mem;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+
 /* Return a memblock of content, if any is available. *mem will be NULL if
    no further content is available. The memblock should eventually be
    passed to return_buffer() (or stored into buf->out_for_reading which
@@ -266,6 +266,30 @@ svn_sqlite__exec_statements(svn_sqlite__db_t *db, int stmt_idx)
 }
 
 
+svn_error_t *
+svn_sqlite__set_cache_tuning(svn_sqlite__db_t *db,
+                             apr_int64_t cache_size,
+                             apr_int64_t mmap_size,
+                             apr_pool_t *scratch_pool)
+{
+  if (cache_size != 0)
+    SVN_ERR(exec_sql(db,
+                     apr_psprintf(scratch_pool,
+                                  "PRAGMA cache_size = %" APR_INT64_T_FMT ";",
+                                  cache_size)));
+
+  /* Memory-mapped I/O may be disabled in the SQLite build; the pragma
+     is a silent no-op then. */
+  if (mmap_size > 0)
+    SVN_ERR(exec_sql(db,
+                     apr_psprintf(scratch_pool,
+                                  "PRAGMA mmap_size = %" APR_INT64_T_FMT ";",
+                                  mmap_size)));
+
+  return SVN_NO_ERROR;
+}
+
+
 svn_error_t *
 svn_sqlite__get_statement(svn_sqlite__stmt_t **stmt, svn_sqlite__db_t *db,
                           int stmt_idx)
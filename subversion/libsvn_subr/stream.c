@@ -31,6 +31,11 @@
 #include <apr_errno.h>
 #include <apr_poll.h>
 #include <apr_portable.h>
+#if APR_HAS_THREADS
+#include <apr_thread_proc.h>
+#include <apr_thread_mutex.h>
+#include <apr_thread_cond.h>
+#endif
 
 #include <zlib.h>
 
@@ -1358,6 +1363,285 @@ svn_stream_compressed(svn_stream_t *stream, apr_pool_t *pool)
   return zstream;
 }
 
+
+/*** Asynchronously buffered stream ***/
+
+#if APR_HAS_THREADS
+
+/* A handover buffer in the ring of an asynchronously buffered stream. */
+struct async_buffer_t
+{
+  char *data;
+  apr_size_t len;
+};
+
+/* Baton for the asynchronously buffered stream, shared between the
+   producer (the stream's write handler) and the writer thread. */
+struct async_baton_t
+{
+  /* The stream that the writer thread drains the ring buffers into. */
+  svn_stream_t *target;
+
+  /* Ring of BUF_COUNT handover buffers of BUF_SIZE bytes capacity each.
+     COUNT completely filled buffers are queued for the writer thread,
+     starting at index FIRST.  All five members are protected by MUTEX. */
+  struct async_buffer_t *ring;
+  apr_size_t buf_size;
+  apr_size_t buf_count;
+  apr_size_t first;
+  apr_size_t count;
+
+  /* The buffer currently being filled by the producer, i.e.
+     &RING[(FIRST + COUNT) % BUF_COUNT], or NULL if the producer does not
+     own a buffer right now.  Only ever accessed by the producer.  Note
+     that (FIRST + COUNT) is invariant under the writer thread's dequeue
+     operation, so the slot remains valid until the producer enqueues it. */
+  struct async_buffer_t *fill;
+
+  /* Set when no further data will be enqueued.  Protected by MUTEX. */
+  svn_boolean_t eof;
+
+  /* First error encountered by the writer thread, SVN_NO_ERROR so far.
+     Protected by MUTEX; consumed by the close handler. */
+  svn_error_t *err;
+
+  apr_thread_mutex_t *mutex;
+  apr_thread_cond_t *not_empty;
+  apr_thread_cond_t *not_full;
+
+  /* The writer thread; NULL once it has been joined. */
+  apr_thread_t *thread;
+
+  /* The writer thread gets created from this pool.  It needs a
+     serialized allocator because apr_thread_exit() destroys the
+     thread's own pool from the writer thread, possibly while the
+     producer is still allocating elsewhere.  Destroyed after the
+     join. */
+  apr_pool_t *thread_pool;
+};
+
+/* Thread function of the asynchronously buffered stream.  Write queued
+   buffers in DATA (an async_baton_t) to the target stream until EOF has
+   been set and the queue ran dry, or until the first write error. */
+static void * APR_THREAD_FUNC
+async_buffered_writer(apr_thread_t *tid, void *data)
+{
+  struct async_baton_t *b = data;
+
+  while (TRUE)
+    {
+      struct async_buffer_t *buffer;
+      svn_error_t *err;
+
+      apr_thread_mutex_lock(b->mutex);
+      while (b->count == 0 && !b->eof)
+        apr_thread_cond_wait(b->not_empty, b->mutex);
+
+      if (b->count == 0)
+        {
+          /* EOF and all data written. */
+          apr_thread_mutex_unlock(b->mutex);
+          break;
+        }
+
+      /* The buffer remains ours until we bump FIRST below, i.e. we may
+         access it with the mutex released. */
+      buffer = &b->ring[b->first];
+      apr_thread_mutex_unlock(b->mutex);
+
+      err = svn_stream_write(b->target, buffer->data, &buffer->len);
+
+      apr_thread_mutex_lock(b->mutex);
+      if (err)
+        {
+          /* Keep the first error for the close handler and stop writing.
+             Wake the producer lest it waits for a free buffer forever. */
+          b->err = err;
+          apr_thread_cond_signal(b->not_full);
+          apr_thread_mutex_unlock(b->mutex);
+          break;
+        }
+
+      b->first = (b->first + 1) % b->buf_count;
+      b->count--;
+      apr_thread_cond_signal(b->not_full);
+      apr_thread_mutex_unlock(b->mutex);
+    }
+
+  apr_thread_exit(tid, APR_SUCCESS);
+  return NULL;
+}
+
+/* Implements svn_write_fn_t for the asynchronously buffered stream. */
+static svn_error_t *
+write_handler_async(void *baton, const char *buffer, apr_size_t *len)
+{
+  struct async_baton_t *b = baton;
+  apr_size_t remaining = *len;
+
+  while (remaining)
+    {
+      apr_size_t chunk;
+
+      if (b->fill == NULL)
+        {
+          /* Acquire the next free ring buffer, waiting for the writer
+             thread to vacate one if necessary. */
+          apr_thread_mutex_lock(b->mutex);
+          while (b->count == b->buf_count && !b->err)
+            apr_thread_cond_wait(b->not_full, b->mutex);
+
+          if (b->err)
+            {
+              /* Report the writer's error but leave the original in
+                 place for the close handler to consume. */
+              svn_error_t *err = svn_error_dup(b->err);
+              apr_thread_mutex_unlock(b->mutex);
+              return svn_error_trace(err);
+            }
+
+          b->fill = &b->ring[(b->first + b->count) % b->buf_count];
+          b->fill->len = 0;
+          apr_thread_mutex_unlock(b->mutex);
+        }
+
+      chunk = MIN(remaining, b->buf_size - b->fill->len);
+      memcpy(b->fill->data + b->fill->len, buffer, chunk);
+      b->fill->len += chunk;
+      buffer += chunk;
+      remaining -= chunk;
+
+      if (b->fill->len == b->buf_size)
+        {
+          /* Buffer full; queue it for the writer thread. */
+          apr_thread_mutex_lock(b->mutex);
+          b->count++;
+          apr_thread_cond_signal(b->not_empty);
+          apr_thread_mutex_unlock(b->mutex);
+          b->fill = NULL;
+        }
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Flush all pending data of the async_baton_t B, wait for the writer
+   thread to terminate and return the first error it encountered, if any.
+   This is a no-op if the writer thread has already been joined. */
+static svn_error_t *
+async_buffered_shutdown(struct async_baton_t *b)
+{
+  apr_status_t status;
+  svn_error_t *err;
+
+  if (b->thread == NULL)
+    return SVN_NO_ERROR;
+
+  apr_thread_mutex_lock(b->mutex);
+  if (b->fill && b->fill->len > 0)
+    {
+      /* Queue the final, partially filled buffer. */
+      b->count++;
+      b->fill = NULL;
+    }
+  b->eof = TRUE;
+  apr_thread_cond_signal(b->not_empty);
+  apr_thread_mutex_unlock(b->mutex);
+
+  apr_thread_join(&status, b->thread);
+  b->thread = NULL;
+
+  svn_pool_destroy(b->thread_pool);
+  b->thread_pool = NULL;
+
+  err = b->err;
+  b->err = SVN_NO_ERROR;
+
+  return err;
+}
+
+/* Implements svn_close_fn_t for the asynchronously buffered stream. */
+static svn_error_t *
+close_handler_async(void *baton)
+{
+  struct async_baton_t *b = baton;
+
+  return svn_error_compose_create(async_buffered_shutdown(b),
+                                  svn_stream_close(b->target));
+}
+
+/* Pool cleanup handler: make sure the writer thread has terminated
+   before the ring buffers get deallocated, in case the stream never got
+   closed, e.g. due to an error during stream production. */
+static apr_status_t
+cleanup_handler_async(void *baton)
+{
+  struct async_baton_t *b = baton;
+
+  svn_error_clear(async_buffered_shutdown(b));
+  return APR_SUCCESS;
+}
+
+#endif /* APR_HAS_THREADS */
+
+svn_error_t *
+svn_stream__async_buffered(svn_stream_t **stream,
+                           svn_stream_t *target,
+                           apr_size_t buf_size,
+                           apr_size_t buf_count,
+                           apr_pool_t *result_pool)
+{
+#if APR_HAS_THREADS
+  struct async_baton_t *baton;
+  apr_status_t status;
+  apr_size_t i;
+
+  SVN_ERR_ASSERT(buf_size > 0 && buf_count >= 2);
+
+  baton = apr_pcalloc(result_pool, sizeof(*baton));
+  baton->target = target;
+  baton->buf_size = buf_size;
+  baton->buf_count = buf_count;
+  baton->ring = apr_palloc(result_pool, buf_count * sizeof(*baton->ring));
+  for (i = 0; i < buf_count; ++i)
+    {
+      baton->ring[i].data = apr_palloc(result_pool, buf_size);
+      baton->ring[i].len = 0;
+    }
+
+  status = apr_thread_mutex_create(&baton->mutex, APR_THREAD_MUTEX_DEFAULT,
+                                   result_pool);
+  if (!status)
+    status = apr_thread_cond_create(&baton->not_empty, result_pool);
+  if (!status)
+    status = apr_thread_cond_create(&baton->not_full, result_pool);
+  if (!status)
+    {
+      baton->thread_pool
+        = apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+      status = apr_thread_create(&baton->thread, NULL, async_buffered_writer,
+                                 baton, baton->thread_pool);
+      if (status)
+        svn_pool_destroy(baton->thread_pool);
+    }
+  if (status)
+    return svn_error_wrap_apr(status,
+                              _("Can't create the stream writer thread"));
+
+  apr_pool_cleanup_register(result_pool, baton, cleanup_handler_async,
+                            apr_pool_cleanup_null);
+
+  *stream = svn_stream_create(baton, result_pool);
+  svn_stream_set_write(*stream, write_handler_async);
+  svn_stream_set_close(*stream, close_handler_async);
+#else
+  /* No threads, no buffering. */
+  *stream = target;
+#endif
+
+  return SVN_NO_ERROR;
+}
+
 
 /* Checksummed stream support */
 
@@ -1903,12 +2187,15 @@ svn_stream_for_stdin2(svn_stream_t **in,
 
 
 svn_error_t *
-svn_stream_for_stdout(svn_stream_t **out, apr_pool_t *pool)
+svn_stream_for_stdout2(svn_stream_t **out,
+                       svn_boolean_t buffered,
+                       apr_pool_t *pool)
 {
   apr_file_t *stdout_file;
   apr_status_t apr_err;
 
-  apr_err = apr_file_open_stdout(&stdout_file, pool);
+  apr_uint32_t flags = buffered ? APR_BUFFERED : 0;
+  apr_err = apr_file_open_flags_stdout(&stdout_file, flags, pool);
   if (apr_err)
     return svn_error_wrap_apr(apr_err, "Can't open stdout");
 
@@ -1922,6 +2209,13 @@ svn_stream_for_stdout(svn_stream_t **out, apr_pool_t *pool)
 }
 
 
+svn_error_t *
+svn_stream_for_stdout(svn_stream_t **out, apr_pool_t *pool)
+{
+  return svn_error_trace(svn_stream_for_stdout2(out, FALSE, pool));
+}
+
+
 svn_error_t *
 svn_stream_for_stderr(svn_stream_t **err, apr_pool_t *pool)
 {
@@ -37,6 +37,15 @@
 
 #include "svn_private_config.h"
 
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SVN_STRING__SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SVN_STRING__SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 
 
 /* Allocate the space for a memory buffer from POOL.
@@ -532,12 +541,21 @@ svn_stringbuf_isempty(const svn_stringbuf_t *str)
 }
 
 
+/* Once a stringbuf has to grow at all, grow it to at least this many
+ * bytes.  Byte-wise appends to an initially (near-)empty stringbuf would
+ * otherwise retire a whole series of tiny blocks into the pool before
+ * reaching any useful capacity. */
+#define MIN_GROWTH_SIZE 64
+
 void
 svn_stringbuf_ensure(svn_stringbuf_t *str, apr_size_t minimum_size)
 {
   void *mem = NULL;
   ++minimum_size;  /* + space for '\0' */
 
+  if (minimum_size > str->blocksize && minimum_size < MIN_GROWTH_SIZE)
+    minimum_size = MIN_GROWTH_SIZE;
+
   membuf_ensure(&mem, &str->blocksize, minimum_size, str->pool);
   if (mem && mem != str->data)
     {
@@ -621,8 +639,12 @@ svn_stringbuf_appendbytes(svn_stringbuf_t *str, const char *bytes,
 
   total_len = str->len + count;  /* total size needed */
 
-  /* svn_stringbuf_ensure adds 1 for null terminator. */
-  svn_stringbuf_ensure(str, total_len);
+  /* In most cases, the pre-allocated buffer is already large enough and
+   * the reallocation checks can be skipped entirely (the + 1 accounts
+   * for the NUL terminator). */
+  if (str->blocksize < total_len + 1)
+    /* svn_stringbuf_ensure adds 1 for null terminator. */
+    svn_stringbuf_ensure(str, total_len);
 
   /* get address 1 byte beyond end of original bytestring */
   start_address = (str->data + str->len);
@@ -641,7 +663,10 @@ svn_stringbuf_appendfill(svn_stringbuf_t *str,
                          apr_size_t count)
 {
   apr_size_t new_len = str->len + count;
-  svn_stringbuf_ensure(str, new_len);
+
+  /* Same fast path as in svn_stringbuf_appendbytes(). */
+  if (str->blocksize < new_len + 1)
+    svn_stringbuf_ensure(str, new_len);
 
   memset(str->data + str->len, byte, count);
 
@@ -1508,7 +1533,32 @@ svn_cstring__match_length(const char *a,
 {
   apr_size_t pos = 0;
 
-#if SVN_UNALIGNED_ACCESS_IS_OK
+#if defined(SVN_STRING__SIMD_SSE2)
+
+  /* Compare 16 bytes at a time.  The explicitly unaligned loads are safe
+   * regardless of the (probably different) alignment of A and B.  Upon
+   * mismatch, fall through to the scalar loop to find its position.
+   */
+  for (; max_len - pos >= 16; pos += 16)
+    {
+      const __m128i chunk_a = _mm_loadu_si128((const __m128i *)(a + pos));
+      const __m128i chunk_b = _mm_loadu_si128((const __m128i *)(b + pos));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk_a, chunk_b)) != 0xffff)
+        break;
+    }
+
+#elif defined(SVN_STRING__SIMD_NEON)
+
+  /* Same scheme using 16 byte NEON registers. */
+  for (; max_len - pos >= 16; pos += 16)
+    {
+      const uint8x16_t chunk_a = vld1q_u8((const apr_byte_t *)(a + pos));
+      const uint8x16_t chunk_b = vld1q_u8((const apr_byte_t *)(b + pos));
+      if (vminvq_u8(vceqq_u8(chunk_a, chunk_b)) != 0xff)
+        break;
+    }
+
+#elif SVN_UNALIGNED_ACCESS_IS_OK
 
   /* Chunky processing is so much faster ...
    *
@@ -1536,7 +1586,35 @@ svn_cstring__reverse_match_length(const char *a,
 {
   apr_size_t pos = 0;
 
-#if SVN_UNALIGNED_ACCESS_IS_OK
+#if defined(SVN_STRING__SIMD_SSE2)
+
+  /* Compare 16 bytes at a time, walking backwards.  See
+   * svn_cstring__match_length for the alignment considerations.
+   */
+  for (pos = 16; pos <= max_len; pos += 16)
+    {
+      const __m128i chunk_a = _mm_loadu_si128((const __m128i *)(a - pos));
+      const __m128i chunk_b = _mm_loadu_si128((const __m128i *)(b - pos));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk_a, chunk_b)) != 0xffff)
+        break;
+    }
+
+  pos -= 16;
+
+#elif defined(SVN_STRING__SIMD_NEON)
+
+  /* Same scheme using 16 byte NEON registers. */
+  for (pos = 16; pos <= max_len; pos += 16)
+    {
+      const uint8x16_t chunk_a = vld1q_u8((const apr_byte_t *)(a - pos));
+      const uint8x16_t chunk_b = vld1q_u8((const apr_byte_t *)(b - pos));
+      if (vminvq_u8(vceqq_u8(chunk_a, chunk_b)) != 0xff)
+        break;
+    }
+
+  pos -= 16;
+
+#elif SVN_UNALIGNED_ACCESS_IS_OK
 
   /* Chunky processing is so much faster ...
    *
@@ -30,7 +30,7 @@
 #include "private/svn_string_private.h"
 #include "private/svn_subr_private.h"
 #include "private/svn_packed_data.h"
-#include "string_table.h"
+#include "private/svn_string_table.h"
 
 
 
@@ -68,7 +68,7 @@ typedef struct builder_table_t
   apr_size_t long_string_size;
 } builder_table_t;
 
-struct string_table_builder_t
+struct svn_string_table_builder_t
 {
   apr_pool_t *pool;
   apr_array_header_t *tables;
@@ -94,7 +94,7 @@ typedef struct string_sub_table_t
   apr_size_t long_string_count;
 } string_sub_table_t;
 
-struct string_table_t
+struct svn_string_table_t
 {
   apr_size_t size;
   string_sub_table_t *sub_tables;
@@ -104,7 +104,7 @@ struct string_table_t
 /* Accessing ID Pieces.  */
 
 static builder_table_t *
-add_table(string_table_builder_t *builder)
+add_table(svn_string_table_builder_t *builder)
 {
   builder_table_t *table = apr_pcalloc(builder->pool, sizeof(*table));
   table->max_data_size = MAX_DATA_SIZE - PADDING; /* ensure there remain a few
@@ -120,10 +120,10 @@ add_table(string_table_builder_t *builder)
   return table;
 }
 
-string_table_builder_t *
-svn_fs_x__string_table_builder_create(apr_pool_t *result_pool)
+svn_string_table_builder_t *
+svn_string_table__builder_create(apr_pool_t *result_pool)
 {
-  string_table_builder_t *result = apr_palloc(result_pool, sizeof(*result));
+  svn_string_table_builder_t *result = apr_palloc(result_pool, sizeof(*result));
   result->pool = result_pool;
   result->tables = apr_array_make(result_pool, 1, sizeof(builder_table_t *));
 
@@ -270,7 +270,7 @@ insert_string(builder_table_t *table,
 }
 
 apr_size_t
-svn_fs_x__string_table_builder_add(string_table_builder_t *builder,
+svn_string_table__builder_add(svn_string_table_builder_t *builder,
                                    const char *string,
                                    apr_size_t len)
 {
@@ -343,7 +343,7 @@ svn_fs_x__string_table_builder_add(string_table_builder_t *builder,
 }
 
 apr_size_t
-svn_fs_x__string_table_builder_estimate_size(string_table_builder_t *builder)
+svn_string_table__builder_estimate_size(svn_string_table_builder_t *builder)
 {
   apr_size_t total = 0;
   int i;
@@ -453,13 +453,13 @@ create_table(string_sub_table_t *target,
   target->data_size = data->len;
 }
 
-string_table_t *
-svn_fs_x__string_table_create(const string_table_builder_t *builder,
+svn_string_table_t *
+svn_string_table__create(const svn_string_table_builder_t *builder,
                               apr_pool_t *result_pool)
 {
   apr_size_t i;
 
-  string_table_t *result = apr_pcalloc(result_pool, sizeof(*result));
+  svn_string_table_t *result = apr_pcalloc(result_pool, sizeof(*result));
   result->size = (apr_size_t)builder->tables->nelts;
   result->sub_tables
     = apr_pcalloc(result_pool, result->size * sizeof(*result->sub_tables));
@@ -541,7 +541,7 @@ table_copy_string(char *buffer,
 }
 
 const char*
-svn_fs_x__string_table_get(const string_table_t *table,
+svn_string_table__get(const svn_string_table_t *table,
                            apr_size_t idx,
                            apr_size_t *length,
                            apr_pool_t *result_pool)
@@ -585,8 +585,8 @@ svn_fs_x__string_table_get(const string_table_t *table,
 }
 
 svn_error_t *
-svn_fs_x__write_string_table(svn_stream_t *stream,
-                             const string_table_t *table,
+svn_string_table__write(svn_stream_t *stream,
+                             const svn_string_table_t *table,
                              apr_pool_t *scratch_pool)
 {
   apr_size_t i, k;
@@ -654,14 +654,14 @@ svn_fs_x__write_string_table(svn_stream_t *stream,
 }
 
 svn_error_t *
-svn_fs_x__read_string_table(string_table_t **table_p,
+svn_string_table__read(svn_string_table_t **table_p,
                             svn_stream_t *stream,
                             apr_pool_t *result_pool,
                             apr_pool_t *scratch_pool)
 {
   apr_size_t i, k;
 
-  string_table_t *table = apr_palloc(result_pool, sizeof(*table));
+  svn_string_table_t *table = apr_palloc(result_pool, sizeof(*table));
 
   svn_packed__data_root_t *root;
   svn_packed__int_stream_t *table_sizes;
@@ -746,11 +746,11 @@ svn_fs_x__read_string_table(string_table_t **table_p,
 }
 
 void
-svn_fs_x__serialize_string_table(svn_temp_serializer__context_t *context,
-                                 string_table_t **st)
+svn_string_table__serialize(svn_temp_serializer__context_t *context,
+                                 svn_string_table_t **st)
 {
   apr_size_t i, k;
-  string_table_t *string_table = *st;
+  svn_string_table_t *string_table = *st;
   if (string_table == NULL)
     return;
 
@@ -799,8 +799,8 @@ svn_fs_x__serialize_string_table(svn_temp_serializer__context_t *context,
 }
 
 void
-svn_fs_x__deserialize_string_table(void *buffer,
-                                   string_table_t **table)
+svn_string_table__deserialize(void *buffer,
+                                   svn_string_table_t **table)
 {
   apr_size_t i, k;
   string_sub_table_t *sub_tables;
@@ -829,7 +829,7 @@ svn_fs_x__deserialize_string_table(void *buffer,
 }
 
 const char*
-svn_fs_x__string_table_get_func(const string_table_t *table,
+svn_string_table__get_func(const svn_string_table_t *table,
                                 apr_size_t idx,
                                 apr_size_t *length,
                                 apr_pool_t *result_pool)
@@ -982,6 +982,14 @@ eol_unchanged(struct translation_baton *b,
 }
 
 
+/* Word-sized bit pattern for chunky '$' detection in translate_chunk(),
+ * along the lines of SVN__R_MASK and SVN__N_MASK. */
+#if APR_SIZEOF_VOIDP == 8
+#  define SVN__DOLLAR_MASK 0x2424242424242424
+#else
+#  define SVN__DOLLAR_MASK 0x24242424
+#endif
+
 /* Translate eols and keywords of a 'chunk' of characters BUF of size BUFLEN
  * according to the settings and state stored in baton B.
  *
@@ -1126,6 +1134,43 @@ translate_chunk(svn_stream_t *dst,
 
               if (b->keywords)
                 {
+#if SVN_UNALIGNED_ACCESS_IS_OK
+                  /* Scan for the next '$' (and CR / LF, if we translate
+                     EOLs as well) one machine word at a time, using the
+                     same technique as svn_eol__find_eol_start.  This is
+                     the hot loop of keyword translation; almost all
+                     bytes are boring. */
+                  while ((end - p) >= (len + sizeof(apr_uintptr_t)))
+                    {
+                      apr_uintptr_t chunk
+                        = *(const apr_uintptr_t *)(p + len);
+
+                      /* A byte in TEST can only be < 0x80, iff it was
+                       * '$' in CHUNK (see eol.c for the details). */
+                      apr_uintptr_t test = chunk ^ SVN__DOLLAR_MASK;
+                      test |= (test & SVN__LOWER_7BITS_SET)
+                              + SVN__LOWER_7BITS_SET;
+
+                      if (b->eol_str)
+                        {
+                          /* Ditto for \r and \n. */
+                          apr_uintptr_t r_test = chunk ^ SVN__R_MASK;
+                          apr_uintptr_t n_test = chunk ^ SVN__N_MASK;
+
+                          r_test |= (r_test & SVN__LOWER_7BITS_SET)
+                                    + SVN__LOWER_7BITS_SET;
+                          n_test |= (n_test & SVN__LOWER_7BITS_SET)
+                                    + SVN__LOWER_7BITS_SET;
+
+                          test &= r_test & n_test;
+                        }
+
+                      if ((test & SVN__BIT_7_SET) != SVN__BIT_7_SET)
+                        break;
+
+                      len += sizeof(apr_uintptr_t);
+                    }
+#else
                   /* Check 4 bytes at once to allow for efficient pipelining
                     and to reduce loop condition overhead. */
                   while ((end - p) >= (len + 4))
@@ -1138,8 +1183,9 @@ translate_chunk(svn_stream_t *dst,
 
                       len += 4;
                     }
+#endif
 
-                  /* Found an interesting char or EOF in the next 4 bytes.
+                  /* Found an interesting char or EOF nearby.
                      Find its exact position. */
                   while ((p + len) < end
                          && !interesting[(unsigned char)p[len]])
@@ -0,0 +1,160 @@
+/*
+ * trace.c :  lightweight in-process tracing for performance analysis
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <apr_atomic.h>
+#include <apr_time.h>
+#include <apr_thread_proc.h>
+#if APR_HAS_THREADS
+#include <apr_portable.h>
+#endif
+
+#include "svn_types.h"
+
+#include "private/svn_trace.h"
+
+
+/* Number of spans kept in the ring buffer.  Older spans get overwritten
+ * once the buffer is full. */
+#define TRACE_SPAN_COUNT 0x4000
+
+/* A single completed timing span. */
+typedef struct trace_span_t
+{
+  const char *category;
+  const char *name;
+  apr_time_t start;
+  apr_time_t end;
+  apr_uint32_t op_id;
+  unsigned long tid;
+} trace_span_t;
+
+/* The ring buffer and the total number of spans recorded so far.
+ * OP_COUNTER is only ever incremented, the slot index is derived from it. */
+static trace_span_t spans[TRACE_SPAN_COUNT];
+static volatile apr_uint32_t op_counter = 0;
+
+/* Target file name from SVN_TRACE_FILE, or NULL if tracing is disabled.
+ * TRACE_INITIALIZED guards the one-time setup. */
+static const char *trace_path = NULL;
+static volatile svn_boolean_t trace_initialized = FALSE;
+
+
+/* Return an identifier for the calling thread. */
+static unsigned long
+current_tid(void)
+{
+#if APR_HAS_THREADS
+  return (unsigned long)apr_os_thread_current();
+#else
+  return 0;
+#endif
+}
+
+/* atexit() handler.  Write all spans still in the ring buffer to
+ * TRACE_PATH as Chrome trace event JSON.  Any I/O errors are ignored;
+ * there is nobody left to report them to. */
+static void
+dump_spans(void)
+{
+  FILE *fp = fopen(trace_path, "w");
+  apr_uint32_t count = op_counter;
+  apr_uint32_t first = count > TRACE_SPAN_COUNT ? count - TRACE_SPAN_COUNT : 0;
+  apr_uint32_t i;
+  const char *separator = "";
+
+  if (fp == NULL)
+    return;
+
+  fputs("{\"traceEvents\":[\n", fp);
+  for (i = first; i < count; ++i)
+    {
+      const trace_span_t *span = &spans[i % TRACE_SPAN_COUNT];
+
+      /* Chrome trace timestamps and durations are in microseconds,
+       * which is exactly what apr_time_t provides. */
+      fprintf(fp,
+              "%s{\"cat\":\"%s\",\"name\":\"%s\",\"ph\":\"X\","
+              "\"ts\":%" APR_TIME_T_FMT ",\"dur\":%" APR_TIME_T_FMT ","
+              "\"pid\":1,\"tid\":%lu,\"args\":{\"op\":%lu}}",
+              separator, span->category, span->name,
+              span->start, span->end - span->start,
+              span->tid, (unsigned long)span->op_id);
+      separator = ",\n";
+    }
+  fputs("\n]}\n", fp);
+
+  fclose(fp);
+}
+
+/* One-time setup: read the environment and register the exit handler.
+ * Calling this concurrently is harmless - getenv() yields the same
+ * result either way and atexit() handlers may run more than once only
+ * if we raced, in which case the last write wins. */
+static void
+initialize(void)
+{
+  const char *path = getenv("SVN_TRACE_FILE");
+
+  if (path && *path)
+    {
+      trace_path = path;
+      atexit(dump_spans);
+    }
+
+  trace_initialized = TRUE;
+}
+
+apr_time_t
+svn_trace__start(void)
+{
+  if (!trace_initialized)
+    initialize();
+
+  return trace_path ? apr_time_now() : 0;
+}
+
+void
+svn_trace__record(const char *category,
+                  const char *name,
+                  apr_time_t start)
+{
+  trace_span_t *span;
+  apr_uint32_t op_id;
+
+  if (start == 0)
+    return;
+
+  /* Claim the next slot.  apr_atomic_inc32 returns the old value. */
+  op_id = apr_atomic_inc32((volatile apr_uint32_t *)&op_counter);
+  span = &spans[op_id % TRACE_SPAN_COUNT];
+
+  span->category = category;
+  span->name = name;
+  span->start = start;
+  span->end = apr_time_now();
+  span->op_id = op_id;
+  span->tid = current_tid();
+}
@@ -60,6 +60,15 @@
 #include "private/svn_eol_private.h"
 #include "private/svn_dep_compat.h"
 
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SVN_UTF__SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SVN_UTF__SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 /* Lookup table to categorise each octet in the string. */
 static const char octet_category[256] = {
   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, /* 0x00-0x7f */
@@ -258,7 +267,23 @@ static const char machine [9][14] = {
 static const char *
 first_non_fsm_start_char(const char *data, apr_size_t max_len)
 {
-#if SVN_UNALIGNED_ACCESS_IS_OK
+#if defined(SVN_UTF__SIMD_SSE2)
+
+  /* Scan the input 16 bytes at a time; the sign bit mask is non-zero as
+   * soon as the chunk contains a non-ASCII byte.  The explicitly
+   * unaligned loads are safe regardless of DATA's alignment. */
+  for (; max_len >= 16; data += 16, max_len -= 16)
+    if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)data)))
+      break;
+
+#elif defined(SVN_UTF__SIMD_NEON)
+
+  /* Same scheme using 16 byte NEON registers. */
+  for (; max_len >= 16; data += 16, max_len -= 16)
+    if (vmaxvq_u8(vld1q_u8((const apr_byte_t *)data)) >= 0x80)
+      break;
+
+#elif SVN_UNALIGNED_ACCESS_IS_OK
 
   /* Scan the input one machine word at a time. */
   for (; max_len > sizeof(apr_uintptr_t)
@@ -290,7 +315,12 @@ svn_utf__last_valid(const char *data, apr_size_t len)
       int category = octet_category[octet];
       state = machine[state][category];
       if (state == FSM_START)
-        start = data;
+        {
+          /* The sequence is complete; skip over the next ASCII run with
+             the fast scanner before resuming the state machine. */
+          data = first_non_fsm_start_char(data, end - data);
+          start = data;
+        }
     }
   return start;
 }
@@ -320,6 +350,14 @@ svn_utf__is_valid(const char *data, apr_size_t len)
       unsigned char octet = *data++;
       int category = octet_category[octet];
       state = machine[state][category];
+      if (state == FSM_START)
+        {
+          /* The sequence is complete; skip over the next ASCII run with
+             the fast scanner before resuming the state machine. */
+          data = first_non_fsm_start_char(data, end - data);
+        }
+      else if (state == FSM_ERROR)
+        return FALSE;
     }
   return state == FSM_START;
 }
@@ -408,7 +446,12 @@ svn_utf__last_valid2(const char *data, apr_size_t len)
           return start;
         }
       if (state == FSM_START)
-        start = data;
+        {
+          /* The sequence is complete; skip over the next ASCII run with
+             the fast scanner before resuming the state machine. */
+          data = first_non_fsm_start_char(data, end - data);
+          start = data;
+        }
     }
   return start;
 }
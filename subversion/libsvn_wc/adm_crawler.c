@@ -636,6 +636,7 @@ report_revisions_and_depths(svn_wc__db_t *db,
           if (SVN_DEPTH_IS_RECURSIVE(depth))
             {
               const char *repos_relpath = ths->repos_relpath;
+              svn_boolean_t skip_subtree = FALSE;
 
               if (repos_relpath == NULL)
                 {
@@ -643,22 +644,41 @@ report_revisions_and_depths(svn_wc__db_t *db,
                                                    iterpool);
                 }
 
-              SVN_ERR(report_revisions_and_depths(db,
-                                                  this_abspath,
-                                                  this_report_relpath,
-                                                  ths->revnum,
-                                                  repos_relpath,
-                                                  dir_repos_root,
-                                                  ths->depth,
-                                                  reporter, report_baton,
-                                                  restore_files, depth,
-                                                  honor_depth_exclude,
-                                                  depth_compatibility_trick,
-                                                  start_empty,
-                                                  use_commit_times,
-                                                  cancel_func, cancel_baton,
-                                                  notify_func, notify_baton,
-                                                  iterpool));
+              /* The report for this directory - whether sent explicitly
+                 above or implied by its parent - claims that everything
+                 below it is at THS->REVNUM and depth infinity.  If the
+                 whole subtree actually matches that claim, there is
+                 nothing to report for it and we don't need to crawl it.
+                 Restoring missing files requires visiting every
+                 directory, though, so don't take the shortcut then. */
+              if (!restore_files
+                  && !start_empty
+                  && !this_switched
+                  && ths->status == svn_wc__db_status_normal
+                  && ths->depth == svn_depth_infinity)
+                SVN_ERR(svn_wc__db_base_subtree_is_uniform(&skip_subtree,
+                                                           db, this_abspath,
+                                                           repos_relpath,
+                                                           ths->revnum,
+                                                           iterpool));
+
+              if (! skip_subtree)
+                SVN_ERR(report_revisions_and_depths(db,
+                                                    this_abspath,
+                                                    this_report_relpath,
+                                                    ths->revnum,
+                                                    repos_relpath,
+                                                    dir_repos_root,
+                                                    ths->depth,
+                                                    reporter, report_baton,
+                                                    restore_files, depth,
+                                                    honor_depth_exclude,
+                                                    depth_compatibility_trick,
+                                                    start_empty,
+                                                    use_commit_times,
+                                                    cancel_func, cancel_baton,
+                                                    notify_func, notify_baton,
+                                                    iterpool));
             }
         } /* end directory case */
     } /* end main entries loop */
@@ -921,13 +921,38 @@ svn_wc__get_pristine_contents_by_checksum(svn_stream_t **contents,
                                           apr_pool_t *result_pool,
                                           apr_pool_t *scratch_pool)
 {
+  const svn_checksum_t *sha1_checksum = checksum;
   svn_boolean_t present;
   svn_boolean_t hydrated;
 
   *contents = NULL;
 
+  /* The pristine store is indexed by SHA-1.  If we were given an MD5
+     checksum (e.g. obtained from a pre-1.7 server that doesn't transmit
+     SHA-1s), try to map it to a SHA-1 before probing the store. */
+  if (checksum->kind != svn_checksum_sha1)
+    {
+      svn_error_t *err;
+
+      if (checksum->kind != svn_checksum_md5)
+        return SVN_NO_ERROR;
+
+      err = svn_wc__db_pristine_get_sha1(&sha1_checksum, wc_ctx->db,
+                                         wri_abspath, checksum,
+                                         result_pool, scratch_pool);
+      if (err)
+        {
+          if (err->apr_err != SVN_ERR_WC_DB_ERROR)
+            return svn_error_trace(err);
+
+          /* We have no pristine text with this MD5 checksum. */
+          svn_error_clear(err);
+          return SVN_NO_ERROR;
+        }
+    }
+
   SVN_ERR(svn_wc__db_pristine_check(&present, &hydrated, wc_ctx->db,
-                                    wri_abspath, checksum, scratch_pool));
+                                    wri_abspath, sha1_checksum, scratch_pool));
 
   if (present && hydrated)
     {
@@ -936,7 +961,7 @@ svn_wc__get_pristine_contents_by_checksum(svn_stream_t **contents,
       gpl_baton = apr_pcalloc(result_pool, sizeof(*gpl_baton));
       gpl_baton->wc_ctx = wc_ctx;
       gpl_baton->wri_abspath = wri_abspath;
-      gpl_baton->checksum = checksum;
+      gpl_baton->checksum = sha1_checksum;
 
       *contents = svn_stream_lazyopen_create(get_pristine_lazyopen_func,
                                              gpl_baton, FALSE, result_pool);
@@ -1067,6 +1092,31 @@ svn_wc_set_changelist2(svn_wc_context_t *wc_ctx,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_wc__set_changelist_many(svn_wc_context_t *wc_ctx,
+                            const apr_array_header_t *local_abspaths,
+                            const char *new_changelist,
+                            svn_depth_t depth,
+                            const apr_array_header_t *changelist_filter,
+                            svn_cancel_func_t cancel_func,
+                            void *cancel_baton,
+                            svn_wc_notify_func2_t notify_func,
+                            void *notify_baton,
+                            apr_pool_t *scratch_pool)
+{
+  /* Assert that we aren't being asked to set an empty changelist. */
+  SVN_ERR_ASSERT(! (new_changelist && new_changelist[0] == '\0'));
+
+  SVN_ERR(svn_wc__db_op_set_changelist_many(wc_ctx->db, local_abspaths,
+                                            new_changelist,
+                                            changelist_filter,
+                                            depth, notify_func, notify_baton,
+                                            cancel_func, cancel_baton,
+                                            scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
 struct get_cl_fn_baton
 {
   svn_wc__db_t *db;
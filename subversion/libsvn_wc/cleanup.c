@@ -25,6 +25,7 @@
 
 #include <string.h>
 
+#include "svn_hash.h"
 #include "svn_wc.h"
 #include "svn_error.h"
 #include "svn_pools.h"
@@ -67,13 +68,93 @@ can_be_cleaned(int *wc_format,
   return SVN_NO_ERROR;
 }
 
-/* Dummy svn_wc_status_func4_t implementation */
+/* Walk the tree below DIR_ABSPATH and re-validate the recorded size and
+   timestamp of every unmodified file against the on-disk state.
+
+   Files whose size and timestamp still match their recorded values are
+   skipped without reading their contents.  For all others
+   svn_wc__internal_file_modified_p() performs the full content
+   comparison and, because cleanup holds the working copy lock, repairs
+   the recorded values of files that turn out to be unmodified.  Once
+   repaired, later (read-only) status walks answer from the recorded
+   values again instead of re-reading the file.
+
+   DIRENT_CACHE, if not NULL, is a prefetched on-disk tree snapshot as
+   produced by svn_wc__prefetch_dirents().  Nodes found in it are not
+   stat()ed again. */
 static svn_error_t *
-status_dummy_callback(void *baton,
-                      const char *local_abspath,
-                      const svn_wc_status3_t *status,
-                      apr_pool_t *scratch_pool)
+repair_recorded_fileinfo(svn_wc__db_t *db,
+                         const char *dir_abspath,
+                         apr_hash_t *dirent_cache,
+                         svn_cancel_func_t cancel_func,
+                         void *cancel_baton,
+                         apr_pool_t *scratch_pool)
 {
+  apr_hash_t *nodes;
+  apr_hash_t *conflicts;
+  apr_hash_index_t *hi;
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+
+  if (cancel_func)
+    SVN_ERR(cancel_func(cancel_baton));
+
+  SVN_ERR(svn_wc__db_read_children_info(&nodes, &conflicts, db, dir_abspath,
+                                        FALSE /* base_tree_only */,
+                                        scratch_pool, iterpool));
+
+  for (hi = apr_hash_first(scratch_pool, nodes); hi; hi = apr_hash_next(hi))
+    {
+      const char *name = apr_hash_this_key(hi);
+      const struct svn_wc__db_info_t *info = apr_hash_this_val(hi);
+      const char *node_abspath;
+
+      if (info->status != svn_wc__db_status_normal
+          && info->status != svn_wc__db_status_added
+          && info->status != svn_wc__db_status_incomplete)
+        continue;
+
+      svn_pool_clear(iterpool);
+      node_abspath = svn_dirent_join(dir_abspath, name, iterpool);
+
+      if (info->kind == svn_node_dir)
+        {
+          SVN_ERR(repair_recorded_fileinfo(db, node_abspath, dirent_cache,
+                                           cancel_func, cancel_baton,
+                                           iterpool));
+        }
+      else if (info->kind == svn_node_file && info->has_checksum)
+        {
+          const svn_io_dirent2_t *dirent = NULL;
+          svn_boolean_t modified;
+
+          /* Prefer the info collected by the prefetch worker threads. */
+          if (dirent_cache)
+            {
+              apr_hash_t *dirents = svn_hash_gets(dirent_cache, dir_abspath);
+
+              if (dirents)
+                dirent = svn_hash_gets(dirents, name);
+            }
+
+          if (dirent == NULL)
+            SVN_ERR(svn_io_stat_dirent2(&dirent, node_abspath, FALSE, TRUE,
+                                        iterpool, iterpool));
+
+          /* The cheap check first: an unchanged size and timestamp mean
+             the recorded values are still valid.  Don't read the file. */
+          if (dirent->kind != svn_node_file
+              || (info->recorded_size != SVN_INVALID_FILESIZE
+                  && info->recorded_size == dirent->filesize
+                  && info->recorded_time == dirent->mtime))
+            continue;
+
+          SVN_ERR(svn_wc__internal_file_modified_p(&modified, db,
+                                                   node_abspath, FALSE,
+                                                   iterpool));
+        }
+    }
+
+  svn_pool_destroy(iterpool);
   return SVN_NO_ERROR;
 }
 
@@ -133,17 +214,26 @@ cleanup_internal(svn_wc__db_t *db,
 
   if (fix_recorded_timestamps)
     {
-      /* Instead of implementing a separate repair step here, use the standard
-         status walker's optimized implementation, which performs repairs when
-         there is a lock. */
-      SVN_ERR(svn_wc__internal_walk_status(db, dir_abspath, svn_depth_infinity,
-                                           FALSE /* get_all */,
-                                           FALSE /* no_ignore */,
-                                           FALSE /* ignore_text_mods */,
-                                           NULL /* ignore patterns */,
-                                           status_dummy_callback, NULL,
-                                           cancel_func, cancel_baton,
-                                           scratch_pool));
+      apr_hash_t *dirent_cache = NULL;
+
+#if APR_HAS_THREADS
+      /* Read and stat the on-disk tree with a worker pool up front.
+         Crashed build trees are usually cold, so the stat() calls - not
+         the wc_db reads - dominate the repair scan below. */
+      SVN_ERR(svn_wc__prefetch_dirents(&dirent_cache, dir_abspath,
+                                       FALSE /* only_check_type */,
+                                       cancel_func, cancel_baton,
+                                       scratch_pool, scratch_pool));
+#endif
+
+      /* Re-validate the recorded sizes and timestamps against the files
+         on disk.  This used to piggyback on a full status walk for the
+         repair-under-lock side effect; the dedicated walk skips all the
+         status assembly and only reads files whose recorded info no
+         longer matches. */
+      SVN_ERR(repair_recorded_fileinfo(db, dir_abspath, dirent_cache,
+                                       cancel_func, cancel_baton,
+                                       scratch_pool));
     }
 
   /* All done, toss the lock */
@@ -3258,25 +3258,32 @@ svn_wc__resolve_conflicts(svn_wc_context_t *wc_ctx,
      walk, we now walk them one by one as closure. */
   while (!err && cswb.resolve_later && apr_hash_count(cswb.resolve_later))
     {
-      apr_hash_index_t *hi;
+      apr_array_header_t *sorted;
       svn_wc_status3_t *status = NULL;
       const char *tc_abspath = NULL;
+      int i;
 
       if (iterpool)
         svn_pool_clear(iterpool);
       else
         iterpool = svn_pool_create(scratch_pool);
 
-      hi = apr_hash_first(scratch_pool, cswb.resolve_later);
+      /* Process the deferred conflicts parents-first.  Conflicts deferred
+         behind a moved-away ancestor can only be resolved after that
+         ancestor, so walking them in path order usually converges in a
+         single pass where hash order would need one pass per nesting
+         level, re-attempting every remaining conflict each time. */
+      sorted = svn_sort__hash(cswb.resolve_later,
+                              svn_sort_compare_items_as_paths, scratch_pool);
       cswb.resolve_later = apr_hash_make(scratch_pool);
       cswb.resolved_one = FALSE;
 
-      for (; hi && !err; hi = apr_hash_next(hi))
+      for (i = 0; i < sorted->nelts && !err; i++)
         {
           const char *relpath;
           svn_pool_clear(iterpool);
 
-          tc_abspath = apr_hash_this_key(hi);
+          tc_abspath = APR_ARRAY_IDX(sorted, i, svn_sort__item_t).key;
 
           if (cancel_func)
             SVN_ERR(cancel_func(cancel_baton));
@@ -3300,7 +3307,7 @@ svn_wc__resolve_conflicts(svn_wc_context_t *wc_ctx,
             continue;
 
           err = svn_error_trace(conflict_status_walker(&cswb, tc_abspath,
-                                                       status, scratch_pool));
+                                                       status, iterpool));
         }
 
       /* None of the remaining conflicts got resolved, and non did provide
@@ -642,13 +642,17 @@ apply_textdelta(void *file_baton,
 
   SVN_ERR(svn_wc__textbase_prepare_install(&dest_stream,
                                            &eb->install_data,
-                                           &eb->new_sha1_checksum,
-                                           &eb->new_md5_checksum,
+                                           NULL, NULL,
                                            eb->db, eb->local_abspath,
                                            TRUE,
                                            eb->pool, pool));
 
-  svn_txdelta_apply2(src_stream, dest_stream, NULL, eb->local_abspath, pool,
+  /* Compute the new pristine's checksums in the delta application loop
+     itself instead of wrapping DEST_STREAM, so the text is hashed only
+     once.  EB->POOL keeps the checksums alive until close_file(). */
+  svn_txdelta_apply3(src_stream, dest_stream,
+                     &eb->new_md5_checksum, &eb->new_sha1_checksum,
+                     eb->local_abspath, eb->pool,
                      handler, handler_baton);
 
   return SVN_NO_ERROR;
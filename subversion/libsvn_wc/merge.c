@@ -641,7 +641,7 @@ preserve_pre_merge_files(svn_skel_t **work_items,
  *       resolution of that conflict at a higher level, in preparation for
  *       being able to support stricter conflict detection.
  *
- * This case is inherently trivial but not currently handled here:
+ * This case is inherently trivial as well:
  *
  *   left == right != target         =>  no-op
  *
@@ -785,6 +785,15 @@ merge_file_trivial(svn_skel_t **work_items,
           *merge_outcome = svn_wc_merge_unchanged;
           return SVN_NO_ERROR;
         }
+
+      /* If the incoming change is a no-op (left == right), it cannot
+       * affect the target.  Running the full three-way merge would only
+       * tokenize all three files to reach the same conclusion. */
+      if (same_left_right)
+        {
+          *merge_outcome = svn_wc_merge_unchanged;
+          return SVN_NO_ERROR;
+        }
     }
 
   *merge_outcome = svn_wc_merge_no_merge;
@@ -638,6 +638,19 @@ svn_wc__has_switched_subtrees(svn_boolean_t *is_switched,
 }
 
 
+svn_error_t *
+svn_wc__base_uniform_revision(svn_revnum_t *revision,
+                              svn_wc_context_t *wc_ctx,
+                              const char *local_abspath,
+                              apr_pool_t *scratch_pool)
+{
+  return svn_error_trace(svn_wc__db_base_uniform_revision(revision,
+                                                          wc_ctx->db,
+                                                          local_abspath,
+                                                          scratch_pool));
+}
+
+
 /* A baton for use with modcheck_found_entry(). */
 typedef struct modcheck_baton_t {
   svn_boolean_t ignore_unversioned;
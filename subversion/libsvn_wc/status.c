@@ -48,6 +48,7 @@
 #include "props.h"
 
 #include "private/svn_sorts_private.h"
+#include "private/svn_task.h"
 #include "private/svn_wc_private.h"
 #include "private/svn_fspath.h"
 #include "private/svn_editor.h"
@@ -100,6 +101,11 @@ struct walk_status_baton
 
   /* Repository locks, if set. */
   apr_hash_t *repos_locks;
+
+  /* Maps 'const char *' abspath -> dirent hash as returned by
+     svn_io_get_dirents3() for directories whose on-disk state has been
+     read ahead by a worker thread pool.  NULL if not prefetching. */
+  apr_hash_t *prefetched_dirents;
 };
 
 /*** Editor batons ***/
@@ -1245,7 +1251,14 @@ get_dir_status(const struct walk_status_baton *wb,
 
   iterpool = svn_pool_create(scratch_pool);
 
-  if (wb->check_working_copy)
+  if (wb->check_working_copy
+      && wb->prefetched_dirents
+      && svn_hash_gets(wb->prefetched_dirents, local_abspath))
+    {
+      /* A worker thread already read this directory for us. */
+      dirents = svn_hash_gets(wb->prefetched_dirents, local_abspath);
+    }
+  else if (wb->check_working_copy)
     {
       err = svn_io_get_dirents3(&dirents, local_abspath,
                                 wb->ignore_text_mods /* only_check_type*/,
@@ -2512,6 +2525,7 @@ svn_wc__get_status_editor(const svn_delta_editor_t **editor,
   eb->wb.ignore_text_mods = !check_working_copy;
   eb->wb.check_working_copy = check_working_copy;
   eb->wb.repos_locks      = NULL;
+  eb->wb.prefetched_dirents = NULL;
   eb->wb.repos_root       = NULL;
 
   SVN_ERR(svn_wc__db_externals_defined_below(&eb->wb.externals,
@@ -2619,6 +2633,151 @@ stat_wc_dirent_case_sensitive(const svn_io_dirent2_t **dirent,
                                 result_pool, scratch_pool));
 }
 
+/* Number of worker threads used to read the on-disk tree ahead of a
+   tree walk.  The walk itself remains single-threaded. */
+#define STATUS_PREFETCH_THREADS 4
+
+/* Baton for prefetch_dirents_process(), describing one directory to read. */
+struct prefetch_dirents_baton
+{
+  /* The directory to read. */
+  const char *local_abspath;
+
+  /* Same as the ONLY_CHECK_TYPE flag of svn_io_get_dirents3(). */
+  svn_boolean_t only_check_type;
+};
+
+/* Intermediate result of one prefetch task. */
+struct prefetch_dirents_result
+{
+  /* The directory that has been read. */
+  const char *local_abspath;
+
+  /* Its contents; maps entry name to svn_io_dirent2_t *. */
+  apr_hash_t *dirents;
+};
+
+/* Implements svn_task__process_func_t.  Read the directory described by
+   the prefetch_dirents_baton in PROCESS_BATON, return its dirents as
+   intermediate result and add one sub-task for every sub-directory
+   found. */
+static svn_error_t *
+prefetch_dirents_process(void **result,
+                         svn_task__t *task,
+                         void *thread_context,
+                         void *process_baton,
+                         svn_cancel_func_t cancel_func,
+                         void *cancel_baton,
+                         apr_pool_t *result_pool,
+                         apr_pool_t *scratch_pool)
+{
+  struct prefetch_dirents_baton *pb = process_baton;
+  struct prefetch_dirents_result *r;
+  apr_hash_t *dirents;
+  apr_hash_index_t *hi;
+  svn_error_t *err;
+
+  if (cancel_func)
+    SVN_ERR(cancel_func(cancel_baton));
+
+  *result = NULL;
+
+  /* The walk proper has elaborate error handling for unreadable or
+     vanished directories.  Upon any problem here, simply don't produce
+     a result and leave this directory for the walk to (re-)examine. */
+  err = svn_io_get_dirents3(&dirents, pb->local_abspath,
+                            pb->only_check_type, result_pool, scratch_pool);
+  if (err)
+    {
+      svn_error_clear(err);
+      return SVN_NO_ERROR;
+    }
+
+  for (hi = apr_hash_first(scratch_pool, dirents);
+       hi;
+       hi = apr_hash_next(hi))
+    {
+      const char *name = apr_hash_this_key(hi);
+      svn_io_dirent2_t *dirent = apr_hash_this_val(hi);
+      apr_pool_t *process_pool;
+      struct prefetch_dirents_baton *child;
+
+      if (dirent->kind != svn_node_dir
+          || svn_wc_is_adm_dir(name, scratch_pool))
+        continue;
+
+      process_pool = svn_task__create_process_pool(task);
+      child = apr_pcalloc(process_pool, sizeof(*child));
+      child->local_abspath = svn_dirent_join(pb->local_abspath, name,
+                                             process_pool);
+      child->only_check_type = pb->only_check_type;
+
+      SVN_ERR(svn_task__add_similar(task, process_pool, NULL, child));
+    }
+
+  r = apr_pcalloc(result_pool, sizeof(*r));
+  r->local_abspath = apr_pstrdup(result_pool, pb->local_abspath);
+  r->dirents = dirents;
+  *result = r;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_task__output_func_t.  Add the RESULT of one prefetch
+   task to the cache hash given by OUTPUT_BATON. */
+static svn_error_t *
+prefetch_dirents_output(svn_task__t *task,
+                        void *result,
+                        void *output_baton,
+                        svn_cancel_func_t cancel_func,
+                        void *cancel_baton,
+                        apr_pool_t *result_pool,
+                        apr_pool_t *scratch_pool)
+{
+  apr_hash_t *cache = output_baton;
+  apr_pool_t *cache_pool = apr_hash_pool_get(cache);
+  struct prefetch_dirents_result *r = result;
+  apr_hash_t *dirents = apr_hash_make(cache_pool);
+  apr_hash_index_t *hi;
+
+  /* The intermediate result may be reclaimed after this call returns;
+     copy it into the cache pool. */
+  for (hi = apr_hash_first(scratch_pool, r->dirents);
+       hi;
+       hi = apr_hash_next(hi))
+    svn_hash_sets(dirents,
+                  apr_pstrdup(cache_pool, apr_hash_this_key(hi)),
+                  svn_io_dirent2_dup(apr_hash_this_val(hi), cache_pool));
+
+  svn_hash_sets(cache, apr_pstrdup(cache_pool, r->local_abspath), dirents);
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_wc__prefetch_dirents(apr_hash_t **cache,
+                         const char *local_abspath,
+                         svn_boolean_t only_check_type,
+                         svn_cancel_func_t cancel_func,
+                         void *cancel_baton,
+                         apr_pool_t *result_pool,
+                         apr_pool_t *scratch_pool)
+{
+  struct prefetch_dirents_baton pb;
+
+  *cache = apr_hash_make(result_pool);
+
+  pb.local_abspath = local_abspath;
+  pb.only_check_type = only_check_type;
+
+  return svn_error_trace(svn_task__run(STATUS_PREFETCH_THREADS,
+                                       prefetch_dirents_process, &pb,
+                                       prefetch_dirents_output, *cache,
+                                       NULL, NULL,
+                                       cancel_func, cancel_baton,
+                                       result_pool, scratch_pool));
+}
+
 svn_error_t *
 svn_wc__internal_walk_status(svn_wc__db_t *db,
                              const char *local_abspath,
@@ -2644,6 +2803,18 @@ svn_wc__internal_walk_status(svn_wc__db_t *db,
   wb.check_working_copy = TRUE;
   wb.repos_root = NULL;
   wb.repos_locks = NULL;
+  wb.prefetched_dirents = NULL;
+
+#if APR_HAS_THREADS
+  /* For a full-depth walk, read and stat the on-disk tree with a worker
+     pool up front.  The walk below then interleaves its wc_db queries
+     with prefetched data instead of serialized disk I/O. */
+  if (depth == svn_depth_infinity || depth == svn_depth_unknown)
+    SVN_ERR(svn_wc__prefetch_dirents(&wb.prefetched_dirents, local_abspath,
+                                     ignore_text_mods,
+                                     cancel_func, cancel_baton,
+                                     scratch_pool, scratch_pool));
+#endif
 
   /* Use the caller-provided ignore patterns if provided; the build-time
      configured defaults otherwise. */
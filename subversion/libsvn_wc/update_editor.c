@@ -28,7 +28,6 @@
 
 #include <apr_pools.h>
 #include <apr_hash.h>
-#include <apr_md5.h>
 #include <apr_tables.h>
 #include <apr_strings.h>
 
@@ -323,6 +322,10 @@ struct dir_baton
   /* Set if this directory is being added during this editor drive. */
   svn_boolean_t adding_dir;
 
+  /* Set if this directory opened a wc_db bulk-ingest batch that must be
+     closed again when the directory and all its children are done. */
+  svn_boolean_t bulk_ingest;
+
   /* Set on a node and its descendants are not present in the working copy
      but should still be updated (not skipped). These nodes should all be
      marked as deleted. */
@@ -425,16 +428,14 @@ struct handler_baton
   /* The stream used to calculate the source checksums */
   svn_stream_t *source_checksum_stream;
 
-  /* A calculated MD5 digest of NEW_TEXT_BASE_TMP_ABSPATH.
-     This is initialized to all zeroes when the baton is created, then
-     populated with the MD5 digest of the resultant fulltext after the
-     last window is handled by the handler returned from
-     apply_textdelta(). */
-  unsigned char new_text_base_md5_digest[APR_MD5_DIGESTSIZE];
+  /* The calculated MD5 checksum of NEW_TEXT_BASE_TMP_ABSPATH.  This is
+     set by the apply machinery after the last window is handled by the
+     handler returned from apply_textdelta(). */
+  svn_checksum_t *new_text_base_md5_checksum;
 
-  /* A calculated SHA-1 of NEW_TEXT_BASE_TMP_ABSPATH, which we'll use for
-     eventually writing the pristine. */
-  svn_checksum_t * new_text_base_sha1_checksum;
+  /* The calculated SHA-1 of NEW_TEXT_BASE_TMP_ABSPATH, set at the same
+     point, which we'll use for eventually writing the pristine. */
+  svn_checksum_t *new_text_base_sha1_checksum;
 };
 
 
@@ -508,6 +509,23 @@ cleanup_edit_baton(void *edit_baton)
   return APR_SUCCESS;
 }
 
+/* An APR pool cleanup handler.  A backstop for drivers that destroy the
+   edit pool without calling abort_edit(): closes any bulk-ingest batches
+   still open on the wc.db connection, so that the work queue run in
+   cleanup_edit_baton() - registered before us, hence run after us -
+   commits instead of vanishing with the open savepoint.  Normally a
+   no-op. */
+static apr_status_t
+cleanup_bulk_ingest(void *edit_baton)
+{
+  struct edit_baton *eb = edit_baton;
+
+  svn_error_clear(svn_wc__db_bulk_ingest_abort(eb->db, eb->wcroot_abspath,
+                                               apr_pool_parent_get(eb->pool)));
+
+  return APR_SUCCESS;
+}
+
 /* Calculate the new repos_relpath for a directory or file */
 static svn_error_t *
 calculate_repos_relpath(const char **new_repos_relpath,
@@ -689,6 +707,13 @@ maybe_release_dir_info(struct dir_baton *db)
     {
       struct dir_baton *pb = db->parent_baton;
 
+      /* This directory and all its children made it into wc.db; close
+         the bulk-ingest batch opened by add_directory(). */
+      if (db->bulk_ingest)
+        SVN_ERR(svn_wc__db_bulk_ingest_finish(db->edit_baton->db,
+                                              db->local_abspath,
+                                              db->pool));
+
       svn_pool_destroy(db->pool);
 
       if (pb)
@@ -1049,7 +1074,7 @@ window_handler(svn_txdelta_window_t *window, void *baton)
     {
       /* Tell the file baton about the new text base's checksums. */
       fb->new_text_base_md5_checksum =
-        svn_checksum__from_digest_md5(hb->new_text_base_md5_digest, fb->pool);
+        svn_checksum_dup(hb->new_text_base_md5_checksum, fb->pool);
       fb->new_text_base_sha1_checksum =
         svn_checksum_dup(hb->new_text_base_sha1_checksum, fb->pool);
 
@@ -1903,6 +1928,15 @@ add_directory(const char *path,
   if (db->skip_this)
     return SVN_NO_ERROR;
 
+  /* Batch the wc.db inserts for this directory and everything below it
+     into a single transaction.  The batch ends when the directory and
+     all its children have been processed; see maybe_release_dir_info().
+     For a checkout, the effect is one commit-and-fsync per top-level
+     batch instead of one per installed node. */
+  SVN_ERR(svn_wc__db_bulk_ingest_begin(eb->db, pb->local_abspath,
+                                       scratch_pool));
+  db->bulk_ingest = TRUE;
+
   SVN_ERR(calculate_repos_relpath(&db->new_repos_relpath, db->local_abspath,
                                   NULL, eb, pb, db->pool, scratch_pool));
 
@@ -3786,11 +3820,15 @@ lazy_open_target(svn_stream_t **stream_p,
      on HB->INSTALL_DATA value in window_handler() and abort
      INSTALL_STREAM if is not NULL on error.
      So we store INSTALL_DATA to local variable first, to leave
-     HB->INSTALL_DATA unchanged on error. */
+     HB->INSTALL_DATA unchanged on error.
+
+     Note that we don't request checksumming wrappers around the install
+     stream: the pristine's MD5 and SHA-1 are computed incrementally by
+     the delta application loop itself (see apply_textdelta()), so the
+     installed text is hashed exactly once. */
   SVN_ERR(svn_wc__textbase_prepare_install(&pristine_install_stream,
                                            &pristine_install_data,
-                                           &hb->new_text_base_sha1_checksum,
-                                           NULL,
+                                           NULL, NULL,
                                            fb->edit_baton->db,
                                            fb->local_abspath,
                                            hydrated,
@@ -3941,8 +3979,9 @@ apply_textdelta(void *file_baton,
 
   /* Prepare to apply the delta.  */
   /* Keep historical behavior by disowning the stream; adjust if needed. */
-  svn_txdelta_apply2(svn_stream_disown(source, handler_pool), target,
-                     hb->new_text_base_md5_digest,
+  svn_txdelta_apply3(svn_stream_disown(source, handler_pool), target,
+                     &hb->new_text_base_md5_checksum,
+                     &hb->new_text_base_sha1_checksum,
                      fb->local_abspath /* error_info */,
                      handler_pool,
                      &hb->apply_handler, &hb->apply_baton);
@@ -4960,6 +4999,26 @@ update_keywords_after_switch_cb(void *baton,
 }
 
 
+/* An svn_delta_editor_t function. */
+static svn_error_t *
+abort_edit(void *edit_baton,
+           apr_pool_t *pool)
+{
+  struct edit_baton *eb = edit_baton;
+
+  /* The drive bailed out with some directories still open, leaving
+     their bulk-ingest batches behind on the wc.db connection.  Close
+     them now, so that what the drive managed to install is committed
+     (still marked incomplete, for a later update to resume) and
+     everything written afterwards - the work queue run, the release
+     of the write lock - commits as usual instead of silently dying
+     with the open savepoint when the connection closes. */
+  return svn_error_trace(svn_wc__db_bulk_ingest_abort(eb->db,
+                                                      eb->wcroot_abspath,
+                                                      pool));
+}
+
+
 /* An svn_delta_editor_t function. */
 static svn_error_t *
 close_edit(void *edit_baton,
@@ -5081,6 +5140,7 @@ close_edit(void *edit_baton,
      but first kill the handler that would run it on the pool
      cleanup at the end of this function. */
   apr_pool_cleanup_kill(eb->pool, eb, cleanup_edit_baton);
+  apr_pool_cleanup_kill(eb->pool, eb, cleanup_bulk_ingest);
 
   SVN_ERR(svn_wc__wq_run(eb->db, eb->wcroot_abspath,
                          eb->cancel_func, eb->cancel_baton,
@@ -5212,6 +5272,8 @@ make_editor(svn_revnum_t *target_revision,
 
   apr_pool_cleanup_register(edit_pool, eb, cleanup_edit_baton,
                             apr_pool_cleanup_null);
+  apr_pool_cleanup_register(edit_pool, eb, cleanup_bulk_ingest,
+                            apr_pool_cleanup_null);
 
   /* Construct an editor. */
   tree_editor->set_target_revision = set_target_revision;
@@ -5229,6 +5291,7 @@ make_editor(svn_revnum_t *target_revision,
   tree_editor->close_file = close_file;
   tree_editor->absent_file = absent_file;
   tree_editor->close_edit = close_edit;
+  tree_editor->abort_edit = abort_edit;
 
   /* Fiddle with the type system. */
   inner_editor = tree_editor;
@@ -841,6 +841,13 @@ upgrade_apply_props(svn_sqlite__db_t *sdb,
 
 struct bump_baton {
   const char *wcroot_abspath;
+
+  /* May be NULL.  Checked between formats and within the per-row
+     migration loops; an interrupted bump rolls back the format it was
+     working on and a later upgrade resumes from the last completed
+     format. */
+  svn_cancel_func_t cancel_func;
+  void *cancel_baton;
 };
 
 /* Migrate the properties for one node (LOCAL_ABSPATH).  */
@@ -1345,8 +1352,11 @@ bump_to_30(void *baton, svn_sqlite__db_t *sdb, apr_pool_t *scratch_pool)
       svn_error_t *err;
       svn_pool_clear(iterpool);
 
-      err = bump_30_upgrade_one_conflict(db, bb->wcroot_abspath, stmt, sdb,
-                                         iterpool);
+      err = bb->cancel_func ? bb->cancel_func(bb->cancel_baton)
+                            : SVN_NO_ERROR;
+      if (!err)
+        err = bump_30_upgrade_one_conflict(db, bb->wcroot_abspath, stmt, sdb,
+                                           iterpool);
 
       if (err)
         {
@@ -1733,6 +1743,8 @@ svn_wc__upgrade_sdb(int *result_format,
                     svn_sqlite__db_t *sdb,
                     int start_format,
                     int target_format,
+                    svn_cancel_func_t cancel_func,
+                    void *cancel_baton,
                     apr_pool_t *scratch_pool)
 {
   if (start_format < SVN_WC__WC_NG_VERSION /* 12 */)
@@ -1783,7 +1795,8 @@ svn_wc__upgrade_sdb(int *result_format,
      ### _can_ use this un-upgraded database before we finish the upgrade. */
   /* Update the schema */
   SVN_ERR(svn_wc__update_schema(result_format, wcroot_abspath, sdb,
-                                start_format, target_format, scratch_pool));
+                                start_format, target_format,
+                                cancel_func, cancel_baton, scratch_pool));
 
   /* Make sure that the stats1 table is populated. */
   SVN_SQLITE__WITH_LOCK(
@@ -1803,15 +1816,25 @@ svn_wc__update_schema(int *result_format,
                       svn_sqlite__db_t *sdb,
                       int start_format,
                       int target_format,
+                      svn_cancel_func_t cancel_func,
+                      void *cancel_baton,
                       apr_pool_t *scratch_pool)
 {
   struct bump_baton bb;
   bb.wcroot_abspath = wcroot_abspath;
+  bb.cancel_func = cancel_func;
+  bb.cancel_baton = cancel_baton;
 
-  /* Repeatedly upgrade until the target format version is reached. */
+  /* Repeatedly upgrade until the target format version is reached.
+     Each per-format bump runs in its own transaction and persists the
+     new format number, so a cancelled or crashed upgrade loses at most
+     the format it was working on and resumes from there when re-run. */
   for (*result_format = start_format;
        *result_format < target_format;)
     {
+      if (cancel_func)
+        SVN_ERR(cancel_func(cancel_baton));
+
 #define UPDATE_TO_FORMAT(X) \
           case ((X) - 1):   \
             SVN_ERR(svn_sqlite__with_lock(sdb, bump_to_##X, &bb, scratch_pool)); \
@@ -2030,6 +2053,7 @@ svn_wc__upgrade(int *result_format_p,
 
   err = svn_wc__db_bump_format(&result_format, &bumped_format,
                                db, local_abspath, target_format,
+                               cancel_func, cancel_baton,
                                scratch_pool);
   if (err)
     {
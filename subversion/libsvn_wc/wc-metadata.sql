@@ -612,6 +612,12 @@ INSERT INTO sqlite_stat1(tbl, idx, stat) VALUES
 /* Tell a lie: We ignore that 99.9% of all moved_to values are NULL */
 INSERT INTO sqlite_stat1(tbl, idx, stat) VALUES
     ('NODES', 'I_NODES_MOVED',                          '8000 8000 1 1');
+/* I_NODES_CHILDREN_INFO only exists in format 32+ working copies, so
+   install its statistics only where the index itself is present. */
+INSERT INTO sqlite_stat1(tbl, idx, stat)
+SELECT 'NODES', 'I_NODES_CHILDREN_INFO', '8000 8000 10 2 1 1 1'
+WHERE EXISTS(SELECT 1 FROM sqlite_master
+             WHERE type = 'index' AND name = 'I_NODES_CHILDREN_INFO');
 
 INSERT INTO sqlite_stat1(tbl, idx, stat) VALUES
     ('ACTUAL_NODE', 'sqlite_autoindex_ACTUAL_NODE_1',   '8000 8000 1');
@@ -712,6 +718,7 @@ WHERE l.op_depth = 0
    following schema changes:
    - Add the 'hydrated' column to the PRISTINE table.
    - Add the I_PRISTINE_UNREFERENCED index.
+   - Add the I_NODES_CHILDREN_INFO index.
    - Add the TEXTBASE_REFS table.
    - Add the SETTINGS table. */
 -- STMT_UPGRADE_TO_32
@@ -720,6 +727,16 @@ ALTER TABLE PRISTINE ADD COLUMN hydrated INTEGER NOT NULL DEFAULT 1;
 
 CREATE INDEX I_PRISTINE_UNREFERENCED ON PRISTINE (refcount, refcount=0);
 
+/* Covering index for the hot status/walker queries on NODES.  Those only
+   need the presence and kind of each child (plus the key columns), so with
+   these two columns appended to the I_NODES_PARENT key the entire query can
+   be answered from the index, without fetching the wide NODES rows with
+   their property blobs.  This matters most for recursive status and revert
+   over deep trees. */
+CREATE INDEX I_NODES_CHILDREN_INFO ON NODES (wc_id, parent_relpath,
+                                             local_relpath, op_depth,
+                                             presence, kind);
+
 /* This table contains references to the on disk text-base contents.
    Every row corresponds to a row in NODES table with the same key.
    While a row is present is this table, the contents identified by the
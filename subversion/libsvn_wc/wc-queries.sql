@@ -85,6 +85,32 @@ LEFT OUTER JOIN lock ON nodes.repos_id = lock.repos_id
   AND nodes.repos_path = lock.repos_relpath
 WHERE wc_id = ?1 AND parent_relpath = ?2 AND op_depth = 0
 
+/* Find any BASE descendant of ?2 that an update report would have to
+   describe separately from its parent: a different revision than ?3, a
+   non-normal presence, a non-infinite directory depth, a switched
+   repository location (?4 is the repository path of ?2 plus a trailing
+   slash, ?5 indexes the first character of a descendant's relpath below
+   ?2) or a lock token to transmit.  File externals are not part of the
+   report and are ignored. */
+-- STMT_SELECT_BASE_NON_UNIFORM_DESCENDANT
+SELECT local_relpath FROM nodes n
+WHERE wc_id = ?1
+  AND IS_STRICT_DESCENDANT_OF(local_relpath, ?2)
+  AND op_depth = 0
+  AND file_external IS NULL
+  AND (revision != ?3
+       OR presence != MAP_NORMAL
+       OR (kind = MAP_DIR AND depth IS NOT NULL
+           AND depth NOT IN (MAP_DEPTH_INFINITY, MAP_DEPTH_UNKNOWN))
+       OR repos_path IS NOT (?4 || SUBSTR(local_relpath, ?5))
+       OR repos_id IS NOT (SELECT r.repos_id FROM nodes r
+                           WHERE r.wc_id = ?1 AND r.local_relpath = ?2
+                             AND r.op_depth = 0)
+       OR EXISTS(SELECT 1 FROM lock l
+                 WHERE l.repos_id = n.repos_id
+                   AND l.repos_relpath = n.repos_path))
+LIMIT 1
+
 
 -- STMT_SELECT_WORKING_NODE
 SELECT op_depth, presence, kind, checksum, translated_size,
@@ -575,9 +601,8 @@ UPDATE actual_node SET conflict_data = ?3
 WHERE wc_id = ?1 AND local_relpath = ?2
 
 -- STMT_UPDATE_ACTUAL_CHANGELISTS
-UPDATE actual_node SET changelist = ?3
+UPDATE actual_node SET changelist = ?2
 WHERE wc_id = ?1
-  AND (local_relpath = ?2 OR IS_STRICT_DESCENDANT_OF(local_relpath, ?2))
   AND local_relpath = (SELECT local_relpath FROM targets_list AS t
                        WHERE wc_id = ?1
                          AND t.local_relpath = actual_node.local_relpath
@@ -590,10 +615,9 @@ UPDATE actual_node SET changelist = NULL
 -- STMT_MARK_SKIPPED_CHANGELIST_DIRS
 /* 7 corresponds to svn_wc_notify_skip */
 INSERT INTO changelist_list (wc_id, local_relpath, notify, changelist)
-SELECT wc_id, local_relpath, 7, ?3
+SELECT wc_id, local_relpath, 7, ?2
 FROM targets_list
 WHERE wc_id = ?1
-  AND (local_relpath = ?2 OR IS_STRICT_DESCENDANT_OF(local_relpath, ?2))
   AND kind = MAP_DIR
 
 -- STMT_RESET_ACTUAL_WITH_CHANGELIST
@@ -658,14 +682,14 @@ CREATE TEMPORARY TABLE targets_list (
 DROP TABLE targets_list
 
 -- STMT_INSERT_TARGET
-INSERT INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
+INSERT OR IGNORE INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
 SELECT wc_id, local_relpath, parent_relpath, kind
 FROM nodes_current
 WHERE wc_id = ?1
   AND local_relpath = ?2
 
 -- STMT_INSERT_TARGET_DEPTH_FILES
-INSERT INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
+INSERT OR IGNORE INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
 SELECT wc_id, local_relpath, parent_relpath, kind
 FROM nodes_current
 WHERE wc_id = ?1
@@ -673,21 +697,21 @@ WHERE wc_id = ?1
   AND kind = MAP_FILE
 
 -- STMT_INSERT_TARGET_DEPTH_IMMEDIATES
-INSERT INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
+INSERT OR IGNORE INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
 SELECT wc_id, local_relpath, parent_relpath, kind
 FROM nodes_current
 WHERE wc_id = ?1
   AND parent_relpath = ?2
 
 -- STMT_INSERT_TARGET_DEPTH_INFINITY
-INSERT INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
+INSERT OR IGNORE INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
 SELECT wc_id, local_relpath, parent_relpath, kind
 FROM nodes_current
 WHERE wc_id = ?1
   AND IS_STRICT_DESCENDANT_OF(local_relpath, ?2)
 
 -- STMT_INSERT_TARGET_WITH_CHANGELIST
-INSERT INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
+INSERT OR IGNORE INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
 SELECT N.wc_id, N.local_relpath, N.parent_relpath, N.kind
   FROM actual_node AS A JOIN nodes_current AS N
     ON A.wc_id = N.wc_id AND A.local_relpath = N.local_relpath
@@ -696,7 +720,7 @@ SELECT N.wc_id, N.local_relpath, N.parent_relpath, N.kind
    AND A.changelist = ?3
 
 -- STMT_INSERT_TARGET_WITH_CHANGELIST_DEPTH_FILES
-INSERT INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
+INSERT OR IGNORE INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
 SELECT N.wc_id, N.local_relpath, N.parent_relpath, N.kind
   FROM actual_node AS A JOIN nodes_current AS N
     ON A.wc_id = N.wc_id AND A.local_relpath = N.local_relpath
@@ -706,7 +730,7 @@ SELECT N.wc_id, N.local_relpath, N.parent_relpath, N.kind
    AND A.changelist = ?3
 
 -- STMT_INSERT_TARGET_WITH_CHANGELIST_DEPTH_IMMEDIATES
-INSERT INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
+INSERT OR IGNORE INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
 SELECT N.wc_id, N.local_relpath, N.parent_relpath, N.kind
   FROM actual_node AS A JOIN nodes_current AS N
     ON A.wc_id = N.wc_id AND A.local_relpath = N.local_relpath
@@ -715,7 +739,7 @@ SELECT N.wc_id, N.local_relpath, N.parent_relpath, N.kind
   AND A.changelist = ?3
 
 -- STMT_INSERT_TARGET_WITH_CHANGELIST_DEPTH_INFINITY
-INSERT INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
+INSERT OR IGNORE INTO targets_list(wc_id, local_relpath, parent_relpath, kind)
 SELECT N.wc_id, N.local_relpath, N.parent_relpath, N.kind
   FROM actual_node AS A JOIN nodes_current AS N
     ON A.wc_id = N.wc_id AND A.local_relpath = N.local_relpath
@@ -754,7 +778,8 @@ WHERE wc_id = ?1 AND local_relpath = ?2
 -- STMT_DELETE_ACTUAL_EMPTIES
 DELETE FROM actual_node
 WHERE wc_id = ?1
-  AND (local_relpath = ?2 OR IS_STRICT_DESCENDANT_OF(local_relpath, ?2))
+  AND local_relpath IN (SELECT local_relpath FROM targets_list
+                        WHERE wc_id = ?1)
   AND properties IS NULL
   AND conflict_data IS NULL
   AND changelist IS NULL
@@ -880,6 +905,9 @@ INSERT INTO work_queue (work) VALUES (?1)
 -- STMT_SELECT_WORK_ITEM
 SELECT id, work FROM work_queue ORDER BY id LIMIT 1
 
+-- STMT_SELECT_WORK_ITEMS
+SELECT id, work FROM work_queue ORDER BY id LIMIT 50
+
 -- STMT_DELETE_WORK_ITEM
 DELETE FROM work_queue WHERE id = ?1
 
@@ -911,6 +939,14 @@ SELECT md5_checksum, size, hydrated
 FROM pristine
 WHERE checksum = ?1
 
+-- STMT_SELECT_PRISTINE_ALL_F31
+SELECT checksum, 1
+FROM pristine
+
+-- STMT_SELECT_PRISTINE_ALL_F32
+SELECT checksum, hydrated
+FROM pristine
+
 -- STMT_SELECT_PRISTINE_BY_MD5
 SELECT checksum
 FROM pristine
@@ -1577,6 +1613,16 @@ WHERE wc_id = ?1
   AND file_external IS NULL
 LIMIT 1
 
+-- STMT_HAS_INCOMPLETE_NODES
+SELECT 1 FROM nodes
+WHERE wc_id = ?1
+  AND (local_relpath = ?2
+       OR IS_STRICT_DESCENDANT_OF(local_relpath, ?2))
+  AND op_depth = 0
+  AND presence = MAP_INCOMPLETE
+  AND file_external IS NULL
+LIMIT 1
+
 -- STMT_SUBTREE_HAS_TREE_MODIFICATIONS
 SELECT 1 FROM nodes
 WHERE wc_id = ?1
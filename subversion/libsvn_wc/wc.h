@@ -542,6 +542,23 @@ svn_wc__internal_changelist_match(svn_wc__db_t *db,
                                   const apr_hash_t *clhash,
                                   apr_pool_t *scratch_pool);
 
+/* Fill *CACHE, allocated in RESULT_POOL, with a mapping of
+   'const char *' abspath -> dirent hash (as returned by
+   svn_io_get_dirents3() with ONLY_CHECK_TYPE) covering LOCAL_ABSPATH
+   and all its sub-directories, reading the disk with a pool of worker
+   threads.  Tree walks that interleave wc_db queries with on-disk
+   checks can consult the cache instead of serializing one stat() per
+   node.  CANCEL_FUNC and CANCEL_BATON are the usual things and must be
+   thread-safe; use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_wc__prefetch_dirents(apr_hash_t **cache,
+                         const char *local_abspath,
+                         svn_boolean_t only_check_type,
+                         svn_cancel_func_t cancel_func,
+                         void *cancel_baton,
+                         apr_pool_t *result_pool,
+                         apr_pool_t *scratch_pool);
+
 /* Library-internal version of svn_wc_walk_status(), which see. */
 svn_error_t *
 svn_wc__internal_walk_status(svn_wc__db_t *db,
@@ -610,14 +627,20 @@ svn_wc__internal_get_origin(svn_boolean_t *is_copy,
    WCROOT_ABSPATH. It's current/starting format is given by START_FORMAT,
    and the intended format is given by TARGET_FORMAT.
    After the upgrade is complete (to as far as the automatic upgrade will
-   perform), the resulting format is RESULT_FORMAT. All allocations are
-   performed in SCRATCH_POOL.  */
+   perform), the resulting format is RESULT_FORMAT.
+   If CANCEL_FUNC is not NULL, invoke it with CANCEL_BATON between the
+   per-format bumps and within their longer row-migration loops; each
+   completed format is persisted, so a cancelled upgrade resumes from
+   the last completed format when re-run.
+   All allocations are performed in SCRATCH_POOL.  */
 svn_error_t *
 svn_wc__upgrade_sdb(int *result_format,
                     const char *wcroot_abspath,
                     svn_sqlite__db_t *sdb,
                     int start_format,
                     int target_format,
+                    svn_cancel_func_t cancel_func,
+                    void *cancel_baton,
                     apr_pool_t *scratch_pool);
 
 /* The schema-update part of svn_wc__upgrade_sdb. */
@@ -627,6 +650,8 @@ svn_wc__update_schema(int *result_format,
                       svn_sqlite__db_t *sdb,
                       int start_format,
                       int target_format,
+                      svn_cancel_func_t cancel_func,
+                      void *cancel_baton,
                       apr_pool_t *scratch_pool);
 
 /* Create a conflict skel from the old separated data */
@@ -49,9 +49,11 @@
 #include "workqueue.h"
 #include "token-map.h"
 
+#include "private/svn_dirent_uri_private.h"
 #include "private/svn_sorts_private.h"
 #include "private/svn_sqlite.h"
 #include "private/svn_skel.h"
+#include "private/svn_trace.h"
 #include "private/svn_wc_private.h"
 #include "private/svn_token.h"
 
@@ -927,6 +929,7 @@ insert_incomplete_children(svn_sqlite__db_t *sdb,
   int i;
   apr_pool_t *iterpool = svn_pool_create(scratch_pool);
   apr_hash_t *moved_to_relpaths = apr_hash_make(scratch_pool);
+  svn_stringbuf_t *join_buf = svn_stringbuf_create_empty(scratch_pool);
 
   SVN_ERR_ASSERT(repos_path != NULL || op_depth > 0);
   SVN_ERR_ASSERT((repos_id != INVALID_REPOS_ID)
@@ -946,9 +949,8 @@ insert_incomplete_children(svn_sqlite__db_t *sdb,
 
           SVN_ERR(svn_sqlite__get_statement(&stmt, sdb,
                                             STMT_SELECT_WORKING_NODE));
-          SVN_ERR(svn_sqlite__bindf(stmt, "is", wc_id,
-                                    svn_relpath_join(local_relpath, name,
-                                                     iterpool)));
+          svn_relpath__join_buf(join_buf, local_relpath, name);
+          SVN_ERR(svn_sqlite__bindf(stmt, "is", wc_id, join_buf->data));
           SVN_ERR(svn_sqlite__step(&have_row, stmt));
           if (have_row && !svn_sqlite__column_is_null(stmt, 14))
             svn_hash_sets(moved_to_relpaths, name,
@@ -966,10 +968,12 @@ insert_incomplete_children(svn_sqlite__db_t *sdb,
 
       svn_pool_clear(iterpool);
 
+      /* The bound text is copied right away, so the join buffer can be
+         reused for the next binding. */
+      svn_relpath__join_buf(join_buf, local_relpath, name);
       SVN_ERR(svn_sqlite__bindf(stmt, "isdsnnrsnsnnnnnnnnnnsn",
                                 wc_id,
-                                svn_relpath_join(local_relpath, name,
-                                                 iterpool),
+                                join_buf->data,
                                 op_depth,
                                 local_relpath,
                                 revision,
@@ -980,9 +984,8 @@ insert_incomplete_children(svn_sqlite__db_t *sdb,
       if (repos_id != INVALID_REPOS_ID)
         {
           SVN_ERR(svn_sqlite__bind_int64(stmt, 5, repos_id));
-          SVN_ERR(svn_sqlite__bind_text(stmt, 6,
-                                        svn_relpath_join(repos_path, name,
-                                                         iterpool)));
+          svn_relpath__join_buf(join_buf, repos_path, name);
+          SVN_ERR(svn_sqlite__bind_text(stmt, 6, join_buf->data));
         }
 
       SVN_ERR(svn_sqlite__insert(NULL, stmt));
@@ -1377,7 +1380,7 @@ init_db(/* output values */
   SVN_ERR(svn_sqlite__exec_statements(db, STMT_CREATE_SCHEMA));
   SVN_ERR(svn_wc__update_schema(&result_format, wcroot_abspath, db,
                                 SVN_WC__SUPPORTED_VERSION, target_format,
-                                scratch_pool));
+                                NULL, NULL, scratch_pool));
 
   SVN_ERR(svn_wc__db_install_schema_statistics(db, scratch_pool));
 
@@ -1516,6 +1519,8 @@ svn_wc__db_init(svn_wc__db_t *db,
                         sdb, wc_id, FORMAT_FROM_SDB,
                         FALSE /* auto-upgrade */,
                         store_pristine,
+                        db->pristine_cache_dir,
+                        db->compress_pristines,
                         db->state_pool, scratch_pool));
 
   /* Any previously cached children may now have a new WCROOT, most likely that
@@ -2159,6 +2164,85 @@ svn_wc__db_base_add_not_present_node(svn_wc__db_t *db,
     kind, svn_wc__db_status_not_present, conflict, work_items, scratch_pool);
 }
 
+svn_error_t *
+svn_wc__db_bulk_ingest_begin(svn_wc__db_t *db,
+                             const char *local_abspath,
+                             apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(local_abspath));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath,
+                                                db, local_abspath,
+                                                scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  /* Savepoints nest, so batches opened for sub-directories simply become
+     part of the outermost batch and only that one will hit the disk. */
+  SVN_ERR(svn_sqlite__begin_savepoint(wcroot->sdb));
+  wcroot->bulk_ingest_depth++;
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_wc__db_bulk_ingest_finish(svn_wc__db_t *db,
+                              const char *local_abspath,
+                              apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(local_abspath));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath,
+                                                db, local_abspath,
+                                                scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  SVN_ERR_ASSERT(wcroot->bulk_ingest_depth > 0);
+  wcroot->bulk_ingest_depth--;
+
+  return svn_error_trace(svn_sqlite__finish_savepoint(wcroot->sdb,
+                                                      SVN_NO_ERROR));
+}
+
+svn_error_t *
+svn_wc__db_bulk_ingest_abort(svn_wc__db_t *db,
+                             const char *local_abspath,
+                             apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(local_abspath));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath,
+                                                db, local_abspath,
+                                                scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  /* Unwind the whole savepoint stack, committing what the aborted drive
+     already wrote.  Every wc_db operation inside the batch was atomic by
+     itself, so the partial batch is internally consistent: directories
+     still being filled in remain marked incomplete and a later update
+     simply resumes them.  Rolling back instead would orphan the files
+     and directories already installed on disk as unversioned
+     obstructions.  Releasing also unsticks everything subsequently
+     written through this connection - the work queue run, the release
+     of the working copy lock - which would otherwise silently die with
+     the open savepoint when the connection closes. */
+  while (wcroot->bulk_ingest_depth > 0)
+    {
+      wcroot->bulk_ingest_depth--;
+      SVN_ERR(svn_sqlite__finish_savepoint(wcroot->sdb, SVN_NO_ERROR));
+    }
+
+  return SVN_NO_ERROR;
+}
+
 /* Recursively clear moved-here information at the copy-half of the move
  * which moved a node to MOVED_TO_RELPATH. This transforms this side of the
  * move into a simple copy.
@@ -2881,6 +2965,47 @@ svn_wc__db_base_get_children_info(apr_hash_t **nodes,
                                                 scratch_pool));
 }
 
+svn_error_t *
+svn_wc__db_base_subtree_is_uniform(svn_boolean_t *is_uniform,
+                                   svn_wc__db_t *db,
+                                   const char *dir_abspath,
+                                   const char *repos_relpath,
+                                   svn_revnum_t revision,
+                                   apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+  const char *prefix;
+  svn_sqlite__stmt_t *stmt;
+  svn_boolean_t have_row;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(dir_abspath));
+  SVN_ERR_ASSERT(SVN_IS_VALID_REVNUM(revision));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath, db,
+                              dir_abspath, scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  /* The repository path of a non-switched descendant is REPOS_RELPATH
+   * plus the part of its local relpath below LOCAL_RELPATH. */
+  prefix = (*repos_relpath == '\0')
+             ? ""
+             : apr_pstrcat(scratch_pool, repos_relpath, "/", SVN_VA_NULL);
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
+                                    STMT_SELECT_BASE_NON_UNIFORM_DESCENDANT));
+  SVN_ERR(svn_sqlite__bindf(stmt, "isrsd", wcroot->wc_id, local_relpath,
+                            revision, prefix,
+                            (*local_relpath == '\0')
+                              ? 1
+                              : (int)strlen(local_relpath) + 2));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+
+  *is_uniform = !have_row;
+
+  return svn_error_trace(svn_sqlite__reset(stmt));
+}
+
 
 svn_error_t *
 svn_wc__db_base_get_props(apr_hash_t **props,
@@ -6343,7 +6468,11 @@ svn_wc__db_op_modified(svn_wc__db_t *db,
   NOT_IMPLEMENTED();
 }
 
-/* */
+/* Add the nodes at and below LOCAL_RELPATH, filtered by DEPTH and
+   CHANGELIST_FILTER, to the temporary TARGETS_LIST table.  The caller
+   must have created the table with STMT_CREATE_TARGETS_LIST first;
+   callers may invoke this multiple times to collect several targets
+   into a single list. */
 static svn_error_t *
 populate_targets_tree(svn_wc__db_wcroot_t *wcroot,
                       const char *local_relpath,
@@ -6353,8 +6482,6 @@ populate_targets_tree(svn_wc__db_wcroot_t *wcroot,
 {
   svn_sqlite__stmt_t *stmt;
   int affected_rows = 0;
-  SVN_ERR(svn_sqlite__exec_statements(wcroot->sdb,
-                                      STMT_CREATE_TARGETS_LIST));
 
   if (changelist_filter && changelist_filter->nelts > 0)
     {
@@ -6502,6 +6629,8 @@ dump_targets(svn_wc__db_wcroot_t *wcroot,
 
 struct set_changelist_baton_t
 {
+  /* Array of const char * relpaths, all within the same wcroot. */
+  const apr_array_header_t *target_relpaths;
   const char *new_changelist;
   const apr_array_header_t *changelist_filter;
   svn_depth_t depth;
@@ -6519,9 +6648,26 @@ set_changelist_txn(void *baton,
 {
   struct set_changelist_baton_t *scb = baton;
   svn_sqlite__stmt_t *stmt;
+  apr_pool_t *iterpool;
+  int i;
 
-  SVN_ERR(populate_targets_tree(wcroot, local_relpath, scb->depth,
-                                scb->changelist_filter, scratch_pool));
+  /* Collect all targets into one list, so that the actual changelist
+     assignment below is a single statement no matter how many targets
+     we were given. */
+  SVN_ERR(svn_sqlite__exec_statements(wcroot->sdb,
+                                      STMT_CREATE_TARGETS_LIST));
+
+  iterpool = svn_pool_create(scratch_pool);
+  for (i = 0; i < scb->target_relpaths->nelts; i++)
+    {
+      svn_pool_clear(iterpool);
+      SVN_ERR(populate_targets_tree(wcroot,
+                                    APR_ARRAY_IDX(scb->target_relpaths, i,
+                                                  const char *),
+                                    scb->depth, scb->changelist_filter,
+                                    iterpool));
+    }
+  svn_pool_destroy(iterpool);
 
   /* Ensure we have actual nodes for our targets. */
   if (scb->new_changelist)
@@ -6540,7 +6686,7 @@ set_changelist_txn(void *baton,
   /* Update our changelists. */
   SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
                                     STMT_UPDATE_ACTUAL_CHANGELISTS));
-  SVN_ERR(svn_sqlite__bindf(stmt, "iss", wcroot->wc_id, local_relpath,
+  SVN_ERR(svn_sqlite__bindf(stmt, "is", wcroot->wc_id,
                             scb->new_changelist));
   SVN_ERR(svn_sqlite__step_done(stmt));
 
@@ -6549,7 +6695,7 @@ set_changelist_txn(void *baton,
       /* We have to notify that we skipped directories, so do that now. */
       SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
                                         STMT_MARK_SKIPPED_CHANGELIST_DIRS));
-      SVN_ERR(svn_sqlite__bindf(stmt, "iss", wcroot->wc_id, local_relpath,
+      SVN_ERR(svn_sqlite__bindf(stmt, "is", wcroot->wc_id,
                                 scb->new_changelist));
       SVN_ERR(svn_sqlite__step_done(stmt));
     }
@@ -6560,7 +6706,7 @@ set_changelist_txn(void *baton,
     {
       SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
                                         STMT_DELETE_ACTUAL_EMPTIES));
-      SVN_ERR(svn_sqlite__bindf(stmt, "is", wcroot->wc_id, local_relpath));
+      SVN_ERR(svn_sqlite__bindf(stmt, "i", wcroot->wc_id));
       SVN_ERR(svn_sqlite__step_done(stmt));
     }
 
@@ -6635,34 +6781,100 @@ svn_wc__db_op_set_changelist(svn_wc__db_t *db,
                              void *cancel_baton,
                              apr_pool_t *scratch_pool)
 {
-  svn_wc__db_wcroot_t *wcroot;
-  const char *local_relpath;
-  struct set_changelist_baton_t scb;
+  apr_array_header_t *local_abspaths
+    = apr_array_make(scratch_pool, 1, sizeof(const char *));
 
-  scb.new_changelist = new_changelist;
-  scb.changelist_filter = changelist_filter;
-  scb.depth = depth;
+  APR_ARRAY_PUSH(local_abspaths, const char *) = local_abspath;
 
-  SVN_ERR_ASSERT(svn_dirent_is_absolute(local_abspath));
+  return svn_error_trace(svn_wc__db_op_set_changelist_many(
+                           db, local_abspaths, new_changelist,
+                           changelist_filter, depth,
+                           notify_func, notify_baton,
+                           cancel_func, cancel_baton,
+                           scratch_pool));
+}
 
-  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath,
-                                                db, local_abspath,
-                                                scratch_pool, scratch_pool));
-  VERIFY_USABLE_WCROOT(wcroot);
 
-  /* Flush the entries before we do the work. Even if no work is performed,
-     the flush isn't a problem. */
-  SVN_ERR(flush_entries(wcroot, local_abspath, depth, scratch_pool));
+svn_error_t *
+svn_wc__db_op_set_changelist_many(svn_wc__db_t *db,
+                                  const apr_array_header_t *local_abspaths,
+                                  const char *new_changelist,
+                                  const apr_array_header_t *changelist_filter,
+                                  svn_depth_t depth,
+                                  svn_wc_notify_func2_t notify_func,
+                                  void *notify_baton,
+                                  svn_cancel_func_t cancel_func,
+                                  void *cancel_baton,
+                                  apr_pool_t *scratch_pool)
+{
+  apr_hash_t *wcroot_targets = apr_hash_make(scratch_pool);
+  apr_hash_index_t *hi;
+  int i;
 
-  /* Perform the set-changelist operation (transactionally), perform any
-     notifications necessary, and then clean out our temporary tables.  */
-  return svn_error_trace(with_finalization(wcroot, local_relpath,
-                                           set_changelist_txn, &scb,
-                                           do_changelist_notify, NULL,
-                                           cancel_func, cancel_baton,
-                                           notify_func, notify_baton,
-                                           STMT_FINALIZE_CHANGELIST,
-                                           scratch_pool));
+  /* Group the targets by working copy root, so that each root gets
+     exactly one transaction regardless of the number of targets. */
+  for (i = 0; i < local_abspaths->nelts; i++)
+    {
+      const char *local_abspath = APR_ARRAY_IDX(local_abspaths, i,
+                                                const char *);
+      svn_wc__db_wcroot_t *wcroot;
+      const char *local_relpath;
+      apr_array_header_t *relpaths;
+
+      SVN_ERR_ASSERT(svn_dirent_is_absolute(local_abspath));
+
+      SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath,
+                                                    db, local_abspath,
+                                                    scratch_pool,
+                                                    scratch_pool));
+      VERIFY_USABLE_WCROOT(wcroot);
+
+      relpaths = svn_hash_gets(wcroot_targets, wcroot->abspath);
+      if (relpaths == NULL)
+        {
+          relpaths = apr_array_make(scratch_pool, 1, sizeof(const char *));
+          svn_hash_sets(wcroot_targets, wcroot->abspath, relpaths);
+        }
+      APR_ARRAY_PUSH(relpaths, const char *) = local_relpath;
+
+      /* Flush the entries before we do the work. Even if no work is
+         performed, the flush isn't a problem. */
+      SVN_ERR(flush_entries(wcroot, local_abspath, depth, scratch_pool));
+    }
+
+  for (hi = apr_hash_first(scratch_pool, wcroot_targets);
+       hi;
+       hi = apr_hash_next(hi))
+    {
+      const char *wcroot_abspath = apr_hash_this_key(hi);
+      apr_array_header_t *relpaths = apr_hash_this_val(hi);
+      svn_wc__db_wcroot_t *wcroot;
+      const char *local_relpath;
+      struct set_changelist_baton_t scb;
+
+      SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath,
+                                                    db, wcroot_abspath,
+                                                    scratch_pool,
+                                                    scratch_pool));
+
+      scb.target_relpaths = relpaths;
+      scb.new_changelist = new_changelist;
+      scb.changelist_filter = changelist_filter;
+      scb.depth = depth;
+
+      /* Perform the set-changelist operation (transactionally), perform
+         any notifications necessary, and then clean out our temporary
+         tables.  */
+      SVN_ERR(with_finalization(wcroot, local_relpath,
+                                set_changelist_txn, &scb,
+                                do_changelist_notify, NULL,
+                                cancel_func, cancel_baton,
+                                notify_func, notify_baton,
+                                STMT_FINALIZE_CHANGELIST,
+                                scratch_pool));
+    }
+
+  return SVN_NO_ERROR;
 }
 
 /* Implementation of svn_wc__db_op_mark_conflict() */
@@ -9680,6 +9892,7 @@ svn_wc__db_read_children_info(apr_hash_t **nodes,
 {
   svn_wc__db_wcroot_t *wcroot;
   const char *dir_relpath;
+  apr_time_t trace_start = svn_trace__start();
 
   *conflicts = apr_hash_make(result_pool);
   *nodes = apr_hash_make(result_pool);
@@ -9695,6 +9908,8 @@ svn_wc__db_read_children_info(apr_hash_t **nodes,
                        base_tree_only, result_pool, scratch_pool),
     wcroot);
 
+  svn_trace__record("wc_db", "read-children-info", trace_start);
+
   return SVN_NO_ERROR;
 }
 
@@ -10383,6 +10598,8 @@ cache_props_recursive(void *cb_baton,
   svn_sqlite__stmt_t *stmt;
   int stmt_idx;
 
+  SVN_ERR(svn_sqlite__exec_statements(wcroot->sdb,
+                                      STMT_CREATE_TARGETS_LIST));
   SVN_ERR(populate_targets_tree(wcroot, local_relpath, baton->depth,
                                 baton->changelists, scratch_pool));
 
@@ -13480,6 +13697,8 @@ svn_wc__db_upgrade_begin(svn_sqlite__db_t **sdb,
                                        *sdb, *wc_id, FORMAT_FROM_SDB,
                                        FALSE /* auto-upgrade */,
                                        store_pristine,
+                                       wc_db->pristine_cache_dir,
+                                       wc_db->compress_pristines,
                                        wc_db->state_pool, scratch_pool));
 
   /* The WCROOT is complete. Stash it into DB.  */
@@ -13637,7 +13856,7 @@ wq_fetch_next(apr_uint64_t *id,
 
       val = svn_sqlite__column_blob(stmt, 1, &len, result_pool);
 
-      *work_item = svn_skel__parse(val, len, result_pool);
+      *work_item = svn_skel__parse_in_place(val, len, result_pool);
     }
 
   return svn_error_trace(svn_sqlite__reset(stmt));
@@ -13672,6 +13891,60 @@ svn_wc__db_wq_fetch_next(apr_uint64_t *id,
   return SVN_NO_ERROR;
 }
 
+/* The body of svn_wc__db_wq_fetch_batch().
+ */
+static svn_error_t *
+wq_fetch_batch(apr_array_header_t **work_items,
+               svn_wc__db_wcroot_t *wcroot,
+               const apr_array_header_t *completed_ids,
+               apr_pool_t *result_pool,
+               apr_pool_t *scratch_pool)
+{
+  svn_sqlite__stmt_t *stmt;
+  svn_boolean_t have_row;
+  apr_array_header_t *items;
+  int i;
+
+  if (completed_ids)
+    for (i = 0; i < completed_ids->nelts; ++i)
+      {
+        apr_uint64_t completed_id
+          = APR_ARRAY_IDX(completed_ids, i, apr_uint64_t);
+
+        SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
+                                          STMT_DELETE_WORK_ITEM));
+        SVN_ERR(svn_sqlite__bind_int64(stmt, 1, completed_id));
+
+        SVN_ERR(svn_sqlite__step_done(stmt));
+      }
+
+  items = apr_array_make(result_pool, 16, sizeof(svn_wc__db_wq_item_t));
+
+  SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
+                                    STMT_SELECT_WORK_ITEMS));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+
+  while (have_row)
+    {
+      svn_wc__db_wq_item_t *item;
+      apr_size_t len;
+      const void *val;
+
+      item = &APR_ARRAY_PUSH(items, svn_wc__db_wq_item_t);
+      item->id = svn_sqlite__column_int64(stmt, 0);
+
+      val = svn_sqlite__column_blob(stmt, 1, &len, result_pool);
+
+      item->work_item = svn_skel__parse_in_place(val, len, result_pool);
+
+      SVN_ERR(svn_sqlite__step(&have_row, stmt));
+    }
+
+  *work_items = items;
+
+  return svn_error_trace(svn_sqlite__reset(stmt));
+}
+
 /* Records timestamp and size for one or more files in wcroot */
 static svn_error_t *
 wq_record(svn_wc__db_wcroot_t *wcroot,
@@ -13704,33 +13977,41 @@ wq_record(svn_wc__db_wcroot_t *wcroot,
 }
 
 svn_error_t *
-svn_wc__db_wq_record_and_fetch_next(apr_uint64_t *id,
-                                    svn_skel_t **work_item,
-                                    svn_wc__db_t *db,
-                                    const char *wri_abspath,
-                                    apr_uint64_t completed_id,
-                                    apr_hash_t *record_map,
-                                    apr_pool_t *result_pool,
-                                    apr_pool_t *scratch_pool)
+svn_wc__db_wq_fetch_batch(apr_array_header_t **work_items,
+                          svn_wc__db_t *db,
+                          const char *wri_abspath,
+                          const apr_array_header_t *completed_ids,
+                          apr_hash_t *record_map,
+                          apr_pool_t *result_pool,
+                          apr_pool_t *scratch_pool)
 {
   svn_wc__db_wcroot_t *wcroot;
   const char *local_relpath;
+  apr_time_t trace_start = svn_trace__start();
 
-  SVN_ERR_ASSERT(id != NULL);
-  SVN_ERR_ASSERT(work_item != NULL);
+  SVN_ERR_ASSERT(work_items != NULL);
   SVN_ERR_ASSERT(svn_dirent_is_absolute(wri_abspath));
 
   SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath, db,
                               wri_abspath, scratch_pool, scratch_pool));
   VERIFY_USABLE_WCROOT(wcroot);
 
-  SVN_WC__DB_WITH_TXN(
-    svn_error_compose_create(
-            wq_fetch_next(id, work_item,
-                          wcroot, local_relpath, completed_id,
-                          result_pool, scratch_pool),
-            wq_record(wcroot, record_map, scratch_pool)),
-    wcroot);
+  if (record_map)
+    SVN_WC__DB_WITH_TXN(
+      svn_error_compose_create(
+              wq_fetch_batch(work_items,
+                             wcroot, completed_ids,
+                             result_pool, scratch_pool),
+              wq_record(wcroot, record_map, scratch_pool)),
+      wcroot);
+  else
+    SVN_WC__DB_WITH_TXN(
+      wq_fetch_batch(work_items,
+                     wcroot, completed_ids,
+                     result_pool, scratch_pool),
+      wcroot);
+
+  svn_trace__record("wc_db", "wq-fetch-batch", trace_start);
 
   return SVN_NO_ERROR;
 }
@@ -15719,6 +16000,72 @@ svn_wc__db_has_switched_subtrees(svn_boolean_t *is_switched,
                                                scratch_pool));
 }
 
+/* The body of svn_wc__db_base_uniform_revision().
+ */
+static svn_error_t *
+base_uniform_revision_txn(svn_revnum_t *revision,
+                          svn_wc__db_wcroot_t *wcroot,
+                          const char *local_relpath,
+                          apr_pool_t *scratch_pool)
+{
+  svn_revnum_t min_revision, max_revision;
+  svn_boolean_t is_sparse, is_switched, have_row;
+  svn_sqlite__stmt_t *stmt;
+
+  *revision = SVN_INVALID_REVNUM;
+
+  SVN_ERR(get_min_max_revisions(&min_revision, &max_revision, wcroot,
+                                local_relpath, FALSE, scratch_pool));
+  if (!SVN_IS_VALID_REVNUM(min_revision) || min_revision != max_revision)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(is_sparse_checkout_internal(&is_sparse, wcroot, local_relpath,
+                                      scratch_pool));
+  if (is_sparse)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(has_switched_subtrees(&is_switched, wcroot, local_relpath,
+                                NULL, scratch_pool));
+  if (is_switched)
+    return SVN_NO_ERROR;
+
+  /* Interrupted updates leave incomplete nodes whose children must be
+   * re-reported, even though they have an ordinary revision number. */
+  SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb,
+                                    STMT_HAS_INCOMPLETE_NODES));
+  SVN_ERR(svn_sqlite__bindf(stmt, "is", wcroot->wc_id, local_relpath));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+  SVN_ERR(svn_sqlite__reset(stmt));
+  if (have_row)
+    return SVN_NO_ERROR;
+
+  *revision = min_revision;
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_wc__db_base_uniform_revision(svn_revnum_t *revision,
+                                 svn_wc__db_t *db,
+                                 const char *local_abspath,
+                                 apr_pool_t *scratch_pool)
+{
+  svn_wc__db_wcroot_t *wcroot;
+  const char *local_relpath;
+
+  SVN_ERR_ASSERT(svn_dirent_is_absolute(local_abspath));
+
+  SVN_ERR(svn_wc__db_wcroot_parse_local_abspath(&wcroot, &local_relpath,
+                                                db, local_abspath,
+                                                scratch_pool, scratch_pool));
+  VERIFY_USABLE_WCROOT(wcroot);
+
+  SVN_WC__DB_WITH_TXN(
+    base_uniform_revision_txn(revision, wcroot, local_relpath, scratch_pool),
+    wcroot);
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_wc__db_get_excluded_subtrees(apr_hash_t **excluded_subtrees,
                                  svn_wc__db_t *db,
@@ -16140,6 +16487,8 @@ svn_wc__db_bump_format(int *result_format,
                        svn_wc__db_t *db,
                        const char *wcroot_abspath,
                        int target_format,
+                       svn_cancel_func_t cancel_func,
+                       void *cancel_baton,
                        apr_pool_t *scratch_pool)
 {
   svn_sqlite__db_t *sdb;
@@ -16184,7 +16533,8 @@ svn_wc__db_bump_format(int *result_format,
 
   SVN_ERR(svn_sqlite__read_schema_version(&format, sdb, scratch_pool));
   err = svn_wc__upgrade_sdb(result_format, wcroot_abspath,
-                            sdb, format, target_format, scratch_pool);
+                            sdb, format, target_format,
+                            cancel_func, cancel_baton, scratch_pool);
 
   if (err == SVN_NO_ERROR && bumped_format)
     *bumped_format = (*result_format > format);
@@ -707,6 +707,54 @@ svn_wc__db_base_add_not_present_node(svn_wc__db_t *db,
                                      const svn_skel_t *work_items,
                                      apr_pool_t *scratch_pool);
 
+/* Begin a bulk-ingest batch on the working copy containing LOCAL_ABSPATH.
+
+   All NODES / ACTUAL_NODE modifications made through DB until the matching
+   svn_wc__db_bulk_ingest_finish() call are accumulated in a single SQLite
+   transaction instead of one journal write per node.  This speeds up
+   operations that install a large number of nodes, such as checkout.
+
+   Batches may be nested (e.g. one batch per directory during an editor
+   drive); only the outermost one will actually commit to disk.
+
+   Every batch MUST be closed again: with svn_wc__db_bulk_ingest_finish()
+   on success, or with svn_wc__db_bulk_ingest_abort() when the operation
+   bails out with the batch still open.  A batch left open swallows
+   everything subsequently written through the same connection - work
+   queue runs, the release of the working copy lock - and silently rolls
+   all of it back when the connection closes.
+
+   All temporary allocations will be made in SCRATCH_POOL.
+*/
+svn_error_t *
+svn_wc__db_bulk_ingest_begin(svn_wc__db_t *db,
+                             const char *local_abspath,
+                             apr_pool_t *scratch_pool);
+
+/* Finish the innermost bulk-ingest batch opened on the working copy
+   containing LOCAL_ABSPATH, committing the accumulated modifications
+   once the outermost batch completes.
+
+   All temporary allocations will be made in SCRATCH_POOL.
+*/
+svn_error_t *
+svn_wc__db_bulk_ingest_finish(svn_wc__db_t *db,
+                              const char *local_abspath,
+                              apr_pool_t *scratch_pool);
+
+/* Close all bulk-ingest batches still open on the working copy
+   containing LOCAL_ABSPATH, committing whatever they accumulated so
+   far.  Nodes the aborted operation did not get to complete stay
+   marked incomplete, ready to be resumed by a later update.  A no-op
+   when no batch is open.
+
+   All temporary allocations will be made in SCRATCH_POOL.
+*/
+svn_error_t *
+svn_wc__db_bulk_ingest_abort(svn_wc__db_t *db,
+                             const char *local_abspath,
+                             apr_pool_t *scratch_pool);
+
 /* Remove a node and all its descendants from the BASE tree. This can
    be done in two modes:
 
@@ -845,6 +893,24 @@ svn_wc__db_base_get_children_info(apr_hash_t **nodes,
                                   apr_pool_t *result_pool,
                                   apr_pool_t *scratch_pool);
 
+/* Set *IS_UNIFORM to TRUE if every BASE node below DIR_ABSPATH is exactly
+   what an RA report describing DIR_ABSPATH at REVISION with depth infinity
+   already implies:  at REVISION, with presence normal, at depth infinity
+   (for directories), not switched against REPOS_RELPATH (the repository
+   path of DIR_ABSPATH) and without a lock token.  File externals are not
+   part of such a report and are ignored.
+
+   If *IS_UNIFORM is TRUE, the adm crawler does not have to descend into
+   DIR_ABSPATH at all.
+ */
+svn_error_t *
+svn_wc__db_base_subtree_is_uniform(svn_boolean_t *is_uniform,
+                                   svn_wc__db_t *db,
+                                   const char *dir_abspath,
+                                   const char *repos_relpath,
+                                   svn_revnum_t revision,
+                                   apr_pool_t *scratch_pool);
+
 
 /* Set *PROPS to the properties of the node LOCAL_ABSPATH in the BASE tree.
 
@@ -941,6 +1007,18 @@ svn_wc__db_pristine_get_future_path(const char **pristine_abspath,
                                     apr_pool_t *result_pool,
                                     apr_pool_t *scratch_pool);
 
+/* Set *CONTENTS to a readable stream for the text whose path was
+   obtained from svn_wc__db_pristine_get_future_path().  The text may
+   be stored at that path in either plain or compressed form; a
+   compressed text is decompressed transparently.  PRISTINE_ABSPATH may
+   also name any ordinary file, in which case it is opened as-is.
+ */
+svn_error_t *
+svn_wc__db_pristine_open_future_path(svn_stream_t **contents,
+                                     const char *pristine_abspath,
+                                     apr_pool_t *result_pool,
+                                     apr_pool_t *scratch_pool);
+
 
 /* If requested set *CONTENTS to a readable stream that will yield the pristine
    text identified by SHA1_CHECKSUM (must be a SHA-1 checksum) within the WC
@@ -1649,6 +1727,25 @@ svn_wc__db_op_set_changelist(svn_wc__db_t *db,
                              void *cancel_baton,
                              apr_pool_t *scratch_pool);
 
+/* Like svn_wc__db_op_set_changelist(), but for multiple targets at once.
+
+   LOCAL_ABSPATHS is an array of const char * absolute paths.  The
+   targets are grouped by working copy root and each root is processed
+   in a single transaction, so assigning a large explicit target list
+   costs one commit per root instead of one per target.
+ */
+svn_error_t *
+svn_wc__db_op_set_changelist_many(svn_wc__db_t *db,
+                                  const apr_array_header_t *local_abspaths,
+                                  const char *new_changelist,
+                                  const apr_array_header_t *changelist_filter,
+                                  svn_depth_t depth,
+                                  svn_wc_notify_func2_t notify_func,
+                                  void *notify_baton,
+                                  svn_cancel_func_t cancel_func,
+                                  void *cancel_baton,
+                                  apr_pool_t *scratch_pool);
+
 /* Record CONFLICT on LOCAL_ABSPATH, potentially replacing other conflicts
    recorded on LOCAL_ABSPATH.
 
@@ -2985,6 +3082,11 @@ svn_wc__db_upgrade_insert_external(svn_wc__db_t *db,
  *
  * If BUMPED_FORMAT is not NULL, set *BUMPED_FORMAT to TRUE if the format
  * was bumped or to FALSE if the wc was already at the resulting format.
+ *
+ * If CANCEL_FUNC is not NULL, invoke it with CANCEL_BATON at various
+ * points during the upgrade.  A cancelled upgrade rolls back the format
+ * bump it was working on and can be resumed later from the last
+ * completed format.
  */
 svn_error_t *
 svn_wc__db_bump_format(int *result_format,
@@ -2992,6 +3094,8 @@ svn_wc__db_bump_format(int *result_format,
                        svn_wc__db_t *db,
                        const char *wcroot_abspath,
                        int target_format,
+                       svn_cancel_func_t cancel_func,
+                       void *cancel_baton,
                        apr_pool_t *scratch_pool);
 
 /* @} */
@@ -3035,17 +3139,39 @@ svn_wc__db_wq_fetch_next(apr_uint64_t *id,
                          apr_pool_t *result_pool,
                          apr_pool_t *scratch_pool);
 
-/* Special variant of svn_wc__db_wq_fetch_next(), which in the same transaction
-   also records timestamps and sizes for one or more nodes */
+/* One element of the arrays returned by svn_wc__db_wq_fetch_batch(). */
+typedef struct svn_wc__db_wq_item_t {
+  /* The identifier of this item in the work queue. */
+  apr_uint64_t id;
+
+  /* The parsed work item. */
+  const svn_skel_t *work_item;
+} svn_wc__db_wq_item_t;
+
+/* Batch variant of svn_wc__db_wq_fetch_next(): in a single transaction,
+   mark all items in COMPLETED_IDS (an array of apr_uint64_t; may be NULL
+   or empty) as completed, record timestamps and sizes for the nodes in
+   RECORD_MAP (may be NULL), and return in *WORK_ITEMS the next run of
+   work items as an array of svn_wc__db_wq_item_t.
+
+   Items are returned in the same order they were queued, up to a fixed,
+   implementation-defined batch size.  An empty *WORK_ITEMS array means
+   there is no work left to be completed.
+
+   Because completing items is deferred until the next call, callers must
+   be prepared for already-run items to be handed out again after an
+   interruption; work items are restartable by design (see workqueue.h).
+
+   RESULT_POOL will be used to allocate *WORK_ITEMS, and SCRATCH_POOL
+   will be used for all temporary allocations.  */
 svn_error_t *
-svn_wc__db_wq_record_and_fetch_next(apr_uint64_t *id,
-                                    svn_skel_t **work_item,
-                                    svn_wc__db_t *db,
-                                    const char *wri_abspath,
-                                    apr_uint64_t completed_id,
-                                    apr_hash_t *record_map,
-                                    apr_pool_t *result_pool,
-                                    apr_pool_t *scratch_pool);
+svn_wc__db_wq_fetch_batch(apr_array_header_t **work_items,
+                          svn_wc__db_t *db,
+                          const char *wri_abspath,
+                          const apr_array_header_t *completed_ids,
+                          apr_hash_t *record_map,
+                          apr_pool_t *result_pool,
+                          apr_pool_t *scratch_pool);
 
 
 /* @} */
@@ -3428,6 +3554,19 @@ svn_wc__db_has_switched_subtrees(svn_boolean_t *is_switched,
                                  const char *trail_url,
                                  apr_pool_t *scratch_pool);
 
+/* If the BASE tree under LOCAL_ABSPATH is entirely at one revision, with
+ * no switched, sparse, excluded or incomplete nodes, set *REVISION to
+ * that revision; set it to SVN_INVALID_REVNUM otherwise.
+ *
+ * Such a tree is an exact mirror of its repository URL at *REVISION, so
+ * a crawled report of it would describe a single unmodified subtree.
+ * Use SCRATCH_POOL for temporary allocations. */
+svn_error_t *
+svn_wc__db_base_uniform_revision(svn_revnum_t *revision,
+                                 svn_wc__db_t *db,
+                                 const char *local_abspath,
+                                 apr_pool_t *scratch_pool);
+
 /* Set @a *excluded_subtrees to a hash mapping <tt>const char *</tt>
  * local absolute paths to <tt>const char *</tt> local absolute paths for
  * every path under @a local_abspath in @a db which are excluded by
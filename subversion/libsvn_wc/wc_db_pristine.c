@@ -40,6 +40,11 @@
 #define PRISTINE_STORAGE_RELPATH "pristine"
 #define PRISTINE_TEMPDIR_RELPATH "tmp"
 
+/* Suffix appended to a pristine file name when the text is stored in
+   compressed form.  A pristine text lives at either its plain name or
+   its compressed name, never both; readers probe for whichever exists. */
+#define PRISTINE_COMPRESSED_SUFFIX ".z"
+
 
 
 /* Returns in PRISTINE_ABSPATH a new string allocated from RESULT_POOL,
@@ -93,6 +98,46 @@ get_pristine_fname(const char **pristine_abspath,
 }
 
 
+/* Return the path, allocated in RESULT_POOL, at which the pristine text
+   with checksum SHA1_CHECKSUM is (or would be) stored in the shared
+   pristine cache rooted at CACHE_DIR_ABSPATH.  The cache uses the same
+   two-character fan-out layout as the per-working-copy pristine store,
+   i.e. CACHE_DIR/XX/XXYYZZ...svn-base.  */
+static const char *
+get_pristine_cache_fname(const char *cache_dir_abspath,
+                         const svn_checksum_t *sha1_checksum,
+                         apr_pool_t *result_pool,
+                         apr_pool_t *scratch_pool)
+{
+  const char *hexdigest = svn_checksum_to_cstring(sha1_checksum, scratch_pool);
+  char subdir[3];
+
+  subdir[0] = hexdigest[0];
+  subdir[1] = hexdigest[1];
+  subdir[2] = '\0';
+
+  return svn_dirent_join_many(result_pool,
+                              cache_dir_abspath,
+                              subdir,
+                              apr_pstrcat(scratch_pool, hexdigest,
+                                          PRISTINE_STORAGE_EXT,
+                                          SVN_VA_NULL),
+                              SVN_VA_NULL);
+}
+
+
+/* Return the path, allocated in RESULT_POOL, at which the compressed
+   representation of the pristine text stored at PRISTINE_ABSPATH lives
+   (or would live). */
+static const char *
+get_compressed_fname(const char *pristine_abspath,
+                     apr_pool_t *result_pool)
+{
+  return apr_pstrcat(result_pool, pristine_abspath,
+                     PRISTINE_COMPRESSED_SUFFIX, SVN_VA_NULL);
+}
+
+
 svn_error_t *
 svn_wc__db_pristine_get_future_path(const char **pristine_abspath,
                                     const char *wcroot_abspath,
@@ -106,6 +151,38 @@ svn_wc__db_pristine_get_future_path(const char **pristine_abspath,
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_wc__db_pristine_open_future_path(svn_stream_t **contents,
+                                     const char *pristine_abspath,
+                                     apr_pool_t *result_pool,
+                                     apr_pool_t *scratch_pool)
+{
+  svn_boolean_t compressed = FALSE;
+  apr_file_t *file;
+  svn_error_t *err;
+
+  err = svn_io_file_open(&file, pristine_abspath, APR_READ, APR_OS_DEFAULT,
+                         result_pool);
+  if (err && APR_STATUS_IS_ENOENT(err->apr_err))
+    {
+      /* No fulltext; the pristine store may hold only the compressed
+       * representation. */
+      svn_error_clear(err);
+      err = svn_io_file_open(&file,
+                             get_compressed_fname(pristine_abspath,
+                                                  scratch_pool),
+                             APR_READ, APR_OS_DEFAULT, result_pool);
+      compressed = TRUE;
+    }
+  SVN_ERR(err);
+
+  *contents = svn_stream_from_aprfile2(file, FALSE, result_pool);
+  if (compressed)
+    *contents = svn_stream_compressed(*contents, result_pool);
+
+  return SVN_NO_ERROR;
+}
+
 /* Read *HAVE_ROW, *MD5_CHECKSUM, *SIZE, *HYDRATED for WCROOT:SHA1_CHECKSUM.
  * If it returns with *HAVE_ROW=FALSE, other outputs are null/zero/false.
  */
@@ -152,6 +229,123 @@ stmt_select_pristine(svn_boolean_t *have_row,
   return SVN_NO_ERROR;
 }
 
+/* Invalidate WCROOT's in-memory pristine index after a modification of
+ * the PRISTINE table.  The index will be rebuilt on the next presence
+ * query. */
+static void
+pristine_index_invalidate(svn_wc__db_wcroot_t *wcroot)
+{
+  if (wcroot->pristine_index)
+    {
+      wcroot->pristine_index = NULL;
+      svn_pool_clear(wcroot->pristine_index_pool);
+    }
+}
+
+/* Ensure that WCROOT's in-memory pristine index exists, building it from
+ * the PRISTINE table if necessary.  The index maps the raw SHA-1 digest
+ * of every row to that row's "hydrated" flag (svn_boolean_t *), so bulk
+ * operations like diff can check thousands of pristines without issuing
+ * one SQLite query each. */
+static svn_error_t *
+pristine_index_ensure(svn_wc__db_wcroot_t *wcroot,
+                      apr_pool_t *scratch_pool)
+{
+  int stmt_num;
+  svn_sqlite__stmt_t *stmt;
+  svn_boolean_t have_row;
+  apr_pool_t *pool = wcroot->pristine_index_pool;
+  apr_hash_t *index;
+
+  if (wcroot->pristine_index)
+    return SVN_NO_ERROR;
+
+  index = apr_hash_make(pool);
+
+  stmt_num = (wcroot->format >= SVN_WC__HAS_OPTIONAL_PRISTINE
+              ? STMT_SELECT_PRISTINE_ALL_F32
+              : STMT_SELECT_PRISTINE_ALL_F31);
+  SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb, stmt_num));
+  SVN_ERR(svn_sqlite__step(&have_row, stmt));
+  while (have_row)
+    {
+      const svn_checksum_t *sha1_checksum;
+      svn_boolean_t *hydrated = apr_palloc(pool, sizeof(*hydrated));
+
+      SVN_ERR(svn_sqlite__column_checksum(&sha1_checksum, stmt, 0,
+                                          scratch_pool));
+      *hydrated = svn_sqlite__column_boolean(stmt, 1);
+      apr_hash_set(index,
+                   apr_pmemdup(pool, sha1_checksum->digest,
+                               svn_checksum_size(sha1_checksum)),
+                   svn_checksum_size(sha1_checksum), hydrated);
+
+      SVN_ERR(svn_sqlite__step(&have_row, stmt));
+    }
+  SVN_ERR(svn_sqlite__reset(stmt));
+
+  wcroot->pristine_index = index;
+  return SVN_NO_ERROR;
+}
+
+/* Set *CONTENTS to a readable stream for the pristine text stored at
+ * PRISTINE_ABSPATH or at its compressed sibling, whichever exists.  A
+ * compressed text is decompressed transparently.  Allocate the stream
+ * in RESULT_POOL.
+ *
+ * The file is opened without APR_BUFFERED to maximize throughput e.g.
+ * for fulltext comparison.  As we use SVN__STREAM_CHUNK_SIZE buffers
+ * where needed in streams, there is no point in having another layer
+ * of buffers.  The stream will remain readable even when the file is
+ * deleted from disk; APR guarantees that on Windows as well as Unix. */
+static svn_error_t *
+open_pristine_contents(svn_stream_t **contents,
+                       svn_wc__db_wcroot_t *wcroot,
+                       const char *pristine_abspath,
+                       apr_pool_t *result_pool,
+                       apr_pool_t *scratch_pool)
+{
+  const char *compressed_abspath = get_compressed_fname(pristine_abspath,
+                                                        scratch_pool);
+  const char *first, *second;
+  svn_boolean_t compressed;
+  apr_file_t *file;
+  svn_error_t *err;
+
+  /* The store may hold a mix of representations after the configuration
+   * changed, so probe for the one this working copy currently installs
+   * first and fall back to the other. */
+  if (wcroot->compress_pristines)
+    {
+      first = compressed_abspath;
+      second = pristine_abspath;
+      compressed = TRUE;
+    }
+  else
+    {
+      first = pristine_abspath;
+      second = compressed_abspath;
+      compressed = FALSE;
+    }
+
+  err = svn_io_file_open(&file, first, APR_READ, APR_OS_DEFAULT,
+                         result_pool);
+  if (err && APR_STATUS_IS_ENOENT(err->apr_err))
+    {
+      svn_error_clear(err);
+      err = svn_io_file_open(&file, second, APR_READ, APR_OS_DEFAULT,
+                             result_pool);
+      compressed = !compressed;
+    }
+  SVN_ERR(err);
+
+  *contents = svn_stream_from_aprfile2(file, FALSE, result_pool);
+  if (compressed)
+    *contents = svn_stream_compressed(*contents, result_pool);
+
+  return SVN_NO_ERROR;
+}
+
 /* Set *CONTENTS to a readable stream from which the pristine text
  * identified by SHA1_CHECKSUM and PRISTINE_ABSPATH can be read from the
  * pristine store of WCROOT.  If the pristine contents are currently not
@@ -197,18 +391,8 @@ pristine_read_txn(svn_stream_t **contents,
     {
       if (hydrated)
         {
-          /* Open the file as a readable stream.  It will remain readable even when
-           * deleted from disk; APR guarantees that on Windows as well as Unix.
-           *
-           * We also don't enable APR_BUFFERED on this file to maximize throughput
-           * e.g. for fulltext comparison.  As we use SVN__STREAM_CHUNK_SIZE buffers
-           * where needed in streams, there is no point in having another layer of
-           * buffers. */
-
-          apr_file_t *file;
-          SVN_ERR(svn_io_file_open(&file, pristine_abspath, APR_READ,
-                                   APR_OS_DEFAULT, result_pool));
-          *contents = svn_stream_from_aprfile2(file, FALSE, result_pool);
+          SVN_ERR(open_pristine_contents(contents, wcroot, pristine_abspath,
+                                         result_pool, scratch_pool));
         }
       else
         {
@@ -320,6 +504,42 @@ pristine_get_tempdir(svn_wc__db_wcroot_t *wcroot,
                               PRISTINE_TEMPDIR_RELPATH, SVN_VA_NULL);
 }
 
+/* Replace the fulltext pristine file at PRISTINE_ABSPATH with a
+ * compressed representation at its compressed sibling name.  The
+ * compressed text is written to a temporary file in WCROOT's pristine
+ * temp dir first and moved into place, so readers never see a partial
+ * file. */
+static svn_error_t *
+compress_pristine(svn_wc__db_wcroot_t *wcroot,
+                  const char *pristine_abspath,
+                  apr_pool_t *scratch_pool)
+{
+  const char *compressed_abspath = get_compressed_fname(pristine_abspath,
+                                                        scratch_pool);
+  const char *temp_dir_abspath;
+  const char *temp_abspath;
+  svn_stream_t *src_stream;
+  svn_stream_t *dst_stream;
+
+  temp_dir_abspath = pristine_get_tempdir(wcroot, scratch_pool, scratch_pool);
+
+  SVN_ERR(svn_stream_open_readonly(&src_stream, pristine_abspath,
+                                   scratch_pool, scratch_pool));
+  SVN_ERR(svn_stream_open_unique(&dst_stream, &temp_abspath,
+                                 temp_dir_abspath, svn_io_file_del_none,
+                                 scratch_pool, scratch_pool));
+  dst_stream = svn_stream_compressed(dst_stream, scratch_pool);
+
+  SVN_ERR(svn_stream_copy3(src_stream, dst_stream, NULL, NULL, scratch_pool));
+
+  SVN_ERR(svn_io_set_file_read_only(temp_abspath, FALSE, scratch_pool));
+  SVN_ERR(svn_io_file_rename2(temp_abspath, compressed_abspath, FALSE,
+                              scratch_pool));
+  SVN_ERR(svn_io_remove_file2(pristine_abspath, TRUE, scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
 /* Install the pristine text described by INSTALL_DATA into the pristine store
  * of SDB.
  *
@@ -362,19 +582,89 @@ pristine_install_txn(svn_wc__db_wcroot_t *wcroot,
 
   if (install_stream)
     {
-      /* Move the file to its target location.  (If it is already there, it is
-       * an orphan file and it doesn't matter if we overwrite it.) */
-
-      svn_stream__install_set_read_only(install_stream, TRUE);
+      const char *cache_abspath = NULL;
+      svn_boolean_t linked = FALSE;
+
+      /* If a shared pristine cache is configured, try to hardlink the
+       * text from the cache instead of keeping a private copy.  Pristine
+       * texts are read-only and never modified in place, so sharing the
+       * inode between working copies is safe; the link count doubles as
+       * the reference count.  Any failure (file not cached yet, cache on
+       * another filesystem, no hardlink support) just means we install a
+       * private copy as usual.
+       *
+       * The cache holds fulltexts, so it cannot be combined with
+       * compressed pristine storage; the two are alternative ways of
+       * saving disk space and the cache, when configured, saves more. */
+      if (wcroot->pristine_cache_dir && !wcroot->compress_pristines)
+        {
+          cache_abspath = get_pristine_cache_fname(wcroot->pristine_cache_dir,
+                                                   sha1_checksum,
+                                                   scratch_pool,
+                                                   scratch_pool);
+          svn_error_clear(svn_io_remove_file2(pristine_abspath, TRUE,
+                                              scratch_pool));
+          if (apr_file_link(cache_abspath, pristine_abspath) == APR_SUCCESS)
+            {
+              SVN_ERR(svn_stream__install_delete(install_stream,
+                                                 scratch_pool));
+              linked = TRUE;
+            }
+        }
 
-      SVN_ERR(svn_stream__install_finalize(NULL, NULL, install_stream,
-                                           scratch_pool));
-      SVN_ERR(svn_stream__install_stream(install_stream, pristine_abspath,
-                                         TRUE, scratch_pool));
+      if (! linked)
+        {
+          /* Move the file to its target location.  (If it is already there,
+           * it is an orphan file and it doesn't matter if we overwrite it.) */
+
+          svn_stream__install_set_read_only(install_stream, TRUE);
+
+          SVN_ERR(svn_stream__install_finalize(NULL, NULL, install_stream,
+                                               scratch_pool));
+          SVN_ERR(svn_stream__install_stream(install_stream, pristine_abspath,
+                                             TRUE, scratch_pool));
+
+          if (wcroot->compress_pristines)
+            {
+              /* Swap the fulltext we just installed for its compressed
+               * representation.  Should we crash in between, readers fall
+               * back to the fulltext, so the store stays consistent. */
+              SVN_ERR(compress_pristine(wcroot, pristine_abspath,
+                                        scratch_pool));
+            }
+          else
+            {
+              /* Make sure no orphaned compressed representation shadows
+               * the fulltext we just installed. */
+              SVN_ERR(svn_io_remove_file2(get_compressed_fname(
+                                            pristine_abspath, scratch_pool),
+                                          TRUE, scratch_pool));
+            }
+
+          /* Seed the cache with the text we just installed, so that other
+           * working copies can link to it.  This is best-effort: if it
+           * fails (e.g. the entry appeared concurrently, or hardlinks are
+           * not supported), this working copy simply keeps an unshared
+           * copy. */
+          if (cache_abspath)
+            {
+              svn_error_t *err
+                = svn_io_make_dir_recursively(svn_dirent_dirname(cache_abspath,
+                                                                 scratch_pool),
+                                              scratch_pool);
+              if (err)
+                svn_error_clear(err);
+              else
+                apr_file_link(pristine_abspath, cache_abspath);
+            }
+        }
     }
   else
     {
       SVN_ERR(svn_io_remove_file2(pristine_abspath, TRUE, scratch_pool));
+      SVN_ERR(svn_io_remove_file2(get_compressed_fname(pristine_abspath,
+                                                       scratch_pool),
+                                  TRUE, scratch_pool));
     }
 
   stmt_num = (wcroot->format >= SVN_WC__HAS_OPTIONAL_PRISTINE
@@ -495,6 +785,8 @@ svn_wc__db_pristine_install(svn_wc__db_install_data_t *install_data,
                          scratch_pool),
     wcroot->sdb);
 
+  pristine_index_invalidate(wcroot);
+
   return SVN_NO_ERROR;
 }
 
@@ -608,9 +900,15 @@ pristine_remove_if_unreferenced_txn(svn_sqlite__db_t *sdb,
   SVN_ERR(svn_sqlite__bind_checksum(stmt, 1, sha1_checksum, scratch_pool));
   SVN_ERR(svn_sqlite__update(&affected_rows, stmt));
 
-  /* If we removed the DB row, then remove the file. */
+  /* If we removed the DB row, then remove the file, whichever
+   * representation it is stored in. */
   if (affected_rows > 0)
-    SVN_ERR(svn_io_remove_file2(pristine_abspath, TRUE, scratch_pool));
+    {
+      SVN_ERR(svn_io_remove_file2(pristine_abspath, TRUE, scratch_pool));
+      SVN_ERR(svn_io_remove_file2(get_compressed_fname(pristine_abspath,
+                                                       scratch_pool),
+                                  TRUE, scratch_pool));
+    }
 
   return SVN_NO_ERROR;
 }
@@ -637,6 +935,8 @@ pristine_remove_if_unreferenced(svn_wc__db_wcroot_t *wcroot,
       wcroot->sdb, wcroot, sha1_checksum, pristine_abspath, scratch_pool),
     wcroot->sdb);
 
+  pristine_index_invalidate(wcroot);
+
   return SVN_NO_ERROR;
 }
 
@@ -779,7 +1079,7 @@ svn_wc__db_pristine_check(svn_boolean_t *present,
 {
   svn_wc__db_wcroot_t *wcroot;
   const char *local_relpath;
-  svn_boolean_t have_row;
+  const svn_boolean_t *hydrated_entry;
 
   SVN_ERR_ASSERT(svn_dirent_is_absolute(wri_abspath));
   SVN_ERR_ASSERT(sha1_checksum != NULL);
@@ -797,11 +1097,15 @@ svn_wc__db_pristine_check(svn_boolean_t *present,
                               wri_abspath, scratch_pool, scratch_pool));
   VERIFY_USABLE_WCROOT(wcroot);
 
-  /* Check that there is an entry in the PRISTINE table. */
-  SVN_ERR(stmt_select_pristine(&have_row, NULL, NULL, hydrated,
-                               wcroot, sha1_checksum,
-                               scratch_pool, scratch_pool));
-  *present = have_row;
+  /* Check that there is an entry in the PRISTINE table.  Use the
+   * in-memory index rather than querying SQLite for each file. */
+  SVN_ERR(pristine_index_ensure(wcroot, scratch_pool));
+  hydrated_entry = apr_hash_get(wcroot->pristine_index,
+                                sha1_checksum->digest,
+                                svn_checksum_size(sha1_checksum));
+  *present = (hydrated_entry != NULL);
+  if (hydrated)
+    *hydrated = hydrated_entry ? *hydrated_entry : FALSE;
   return SVN_NO_ERROR;
 }
 
@@ -849,6 +1153,11 @@ svn_wc__db_pristine_dehydrate_internal(svn_wc__db_wcroot_t *wcroot,
   SVN_ERR(svn_sqlite__update(NULL, stmt));
 
   SVN_ERR(svn_io_remove_file2(pristine_abspath, TRUE, scratch_pool));
+  SVN_ERR(svn_io_remove_file2(get_compressed_fname(pristine_abspath,
+                                                   scratch_pool),
+                              TRUE, scratch_pool));
+
+  pristine_index_invalidate(wcroot);
 
   return SVN_NO_ERROR;
 }
@@ -52,6 +52,22 @@ struct svn_wc__db_t {
   /* Busy timeout in ms., 0 for the libsvn_subr default. */
   apr_int32_t timeout;
 
+  /* SQLite page cache size ("PRAGMA cache_size" semantics), 0 for the
+     SQLite default. */
+  apr_int64_t cache_size;
+
+  /* SQLite memory-map limit in bytes, 0 for the SQLite default. */
+  apr_int64_t mmap_size;
+
+  /* Absolute path of a directory holding pristine texts shared between
+     working copies via hardlinks, or NULL if no such cache is configured.
+     See pristine_install_txn() in wc_db_pristine.c. */
+  const char *pristine_cache_dir;
+
+  /* Should newly installed pristine texts be stored in compressed form?
+     See wc_db_pristine.c. */
+  svn_boolean_t compress_pristines;
+
   /* Map a given working copy directory to its relevant data.
      const char *local_abspath -> svn_wc__db_wcroot_t *wcroot  */
   apr_hash_t *dir_data;
@@ -111,6 +127,28 @@ typedef struct svn_wc__db_wcroot_t {
      to fetch the contents on demand. */
   svn_boolean_t store_pristine;
 
+  /* Lazily built in-memory index over the PRISTINE table, mapping the
+     raw SHA-1 digest of each row to that row's "hydrated" flag
+     (svn_boolean_t *).  NULL until the first presence query; reset to
+     NULL whenever the PRISTINE table is modified.  See wc_db_pristine.c. */
+  apr_hash_t *pristine_index;
+
+  /* The allocation pool for PRISTINE_INDEX; cleared on invalidation. */
+  apr_pool_t *pristine_index_pool;
+
+  /* Absolute path of the shared pristine cache directory, or NULL if
+     no such cache is configured.  Copied from the svn_wc__db_t that
+     this wcroot was opened through. */
+  const char *pristine_cache_dir;
+
+  /* Should newly installed pristine texts be stored in compressed form?
+     Copied from the svn_wc__db_t that this wcroot was opened through. */
+  svn_boolean_t compress_pristines;
+
+  /* Number of bulk-ingest savepoints currently open on SDB.  See
+     svn_wc__db_bulk_ingest_begin(). */
+  int bulk_ingest_depth;
+
 } svn_wc__db_wcroot_t;
 
 
@@ -121,8 +159,9 @@ svn_wc__db_close_many_wcroots(apr_hash_t *roots,
                               apr_pool_t *scratch_pool);
 
 
-/* Construct a new svn_wc__db_wcroot_t. The WCROOT_ABSPATH and SDB parameters
-   must have lifetime of at least RESULT_POOL.  */
+/* Construct a new svn_wc__db_wcroot_t. The WCROOT_ABSPATH, SDB and
+   PRISTINE_CACHE_DIR parameters must have lifetime of at least
+   RESULT_POOL.  PRISTINE_CACHE_DIR may be NULL.  */
 svn_error_t *
 svn_wc__db_pdh_create_wcroot(svn_wc__db_wcroot_t **wcroot,
                              const char *wcroot_abspath,
@@ -131,6 +170,8 @@ svn_wc__db_pdh_create_wcroot(svn_wc__db_wcroot_t **wcroot,
                              int format,
                              svn_boolean_t verify_format,
                              svn_boolean_t store_pristine,
+                             const char *pristine_cache_dir,
+                             svn_boolean_t compress_pristines,
                              apr_pool_t *result_pool,
                              apr_pool_t *scratch_pool);
 
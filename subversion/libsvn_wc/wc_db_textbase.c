@@ -212,6 +212,14 @@ textbase_hydrate(svn_wc__db_wcroot_t *wcroot,
   return SVN_NO_ERROR;
 }
 
+/* A text-base that needs hydrating, queued while walking the db. */
+typedef struct textbase_hydrate_item_t
+{
+  const svn_checksum_t *checksum;
+  const char *repos_relpath;
+  svn_revnum_t revision;
+} textbase_hydrate_item_t;
+
 svn_error_t *
 svn_wc__db_textbase_sync(svn_wc__db_t *db,
                          const char *local_abspath,
@@ -228,6 +236,8 @@ svn_wc__db_textbase_sync(svn_wc__db_t *db,
   svn_sqlite__stmt_t *stmt;
   apr_pool_t *iterpool;
   const char *repos_root_url;
+  apr_array_header_t *hydrate_items;
+  int i;
 
   SVN_ERR_ASSERT(svn_dirent_is_absolute(local_abspath));
 
@@ -239,7 +249,13 @@ svn_wc__db_textbase_sync(svn_wc__db_t *db,
   SVN_ERR(svn_sqlite__get_statement(&stmt, wcroot->sdb, STMT_TEXTBASE_SYNC));
   SVN_ERR(svn_sqlite__bindf(stmt, "is", wcroot->wc_id, local_relpath));
 
+  /* Hydrating means fetching from the repository, and the fetches can
+     take an arbitrarily long time.  Only collect what needs hydrating
+     while the statement is open; the actual fetching happens below,
+     after the statement has been reset. */
   repos_root_url = NULL;
+  hydrate_items = apr_array_make(scratch_pool, 0,
+                                 sizeof(textbase_hydrate_item_t));
   iterpool = svn_pool_create(scratch_pool);
   while (1)
     {
@@ -273,6 +289,7 @@ svn_wc__db_textbase_sync(svn_wc__db_t *db,
         {
           if (allow_hydrate)
             {
+              textbase_hydrate_item_t *item;
               const char *repos_relpath;
               svn_revnum_t revision;
 
@@ -303,14 +320,6 @@ svn_wc__db_textbase_sync(svn_wc__db_t *db,
                     return svn_error_compose_create(err, svn_sqlite__reset(stmt));
                 }
 
-              if (!repos_relpath)
-                {
-                  return svn_error_createf(
-                           SVN_ERR_WC_CORRUPT, svn_sqlite__reset(stmt),
-                           _("Unexpected entry for '%s'"),
-                           svn_checksum_to_cstring_display(checksum, iterpool));
-                }
-
               revision = svn_sqlite__column_revnum(stmt, 5);
               if (!SVN_IS_VALID_REVNUM(revision))
                 {
@@ -320,12 +329,10 @@ svn_wc__db_textbase_sync(svn_wc__db_t *db,
                            svn_checksum_to_cstring_display(checksum, iterpool));
                 }
 
-              err = textbase_hydrate(wcroot, fetch_callback, fetch_baton,
-                                     cancel_func, cancel_baton, checksum,
-                                     repos_root_url, repos_relpath, revision,
-                                     iterpool);
-              if (err)
-                return svn_error_compose_create(err, svn_sqlite__reset(stmt));
+              item = apr_array_push(hydrate_items);
+              item->checksum = svn_checksum_dup(checksum, scratch_pool);
+              item->repos_relpath = apr_pstrdup(scratch_pool, repos_relpath);
+              item->revision = revision;
             }
         }
       else if (hydrated && !referenced)
@@ -338,13 +345,30 @@ svn_wc__db_textbase_sync(svn_wc__db_t *db,
                 return svn_error_compose_create(err, svn_sqlite__reset(stmt));
             }
         }
-
-      if (err)
-        return svn_error_compose_create(err, svn_sqlite__reset(stmt));
     }
-  svn_pool_destroy(iterpool);
 
   SVN_ERR(svn_sqlite__reset(stmt));
 
+  /* Now fetch the collected text-bases.  The fetch callback typically
+     reuses a single session for all of them, so feeding it the whole
+     batch in one go amortizes the session setup and lets the RA layer
+     stream one file after another without any db work in between. */
+  for (i = 0; i < hydrate_items->nelts; i++)
+    {
+      const textbase_hydrate_item_t *item
+        = &APR_ARRAY_IDX(hydrate_items, i, textbase_hydrate_item_t);
+
+      svn_pool_clear(iterpool);
+
+      if (cancel_func)
+        SVN_ERR(cancel_func(cancel_baton));
+
+      SVN_ERR(textbase_hydrate(wcroot, fetch_callback, fetch_baton,
+                               cancel_func, cancel_baton, item->checksum,
+                               repos_root_url, item->repos_relpath,
+                               item->revision, iterpool));
+    }
+  svn_pool_destroy(iterpool);
+
   return SVN_NO_ERROR;
 }
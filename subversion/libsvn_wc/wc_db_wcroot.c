@@ -241,6 +241,7 @@ svn_wc__db_open(svn_wc__db_t **db,
       svn_error_t *err;
       svn_boolean_t sqlite_exclusive = FALSE;
       apr_int64_t timeout;
+      const char *pristine_cache_dir;
 
       err = svn_config_get_bool(config, &sqlite_exclusive,
                                 SVN_CONFIG_SECTION_WORKING_COPY,
@@ -261,6 +262,46 @@ svn_wc__db_open(svn_wc__db_t **db,
         svn_error_clear(err);
       else
         (*db)->timeout = (apr_int32_t)timeout;
+
+      err = svn_config_get_int64(config, &(*db)->cache_size,
+                                 SVN_CONFIG_SECTION_WORKING_COPY,
+                                 SVN_CONFIG_OPTION_SQLITE_CACHE_SIZE,
+                                 0);
+      if (err)
+        {
+          svn_error_clear(err);
+          (*db)->cache_size = 0;
+        }
+
+      err = svn_config_get_int64(config, &(*db)->mmap_size,
+                                 SVN_CONFIG_SECTION_WORKING_COPY,
+                                 SVN_CONFIG_OPTION_SQLITE_MMAP_SIZE,
+                                 0);
+      if (err || (*db)->mmap_size < 0)
+        {
+          svn_error_clear(err);
+          (*db)->mmap_size = 0;
+        }
+
+      svn_config_get(config, &pristine_cache_dir,
+                     SVN_CONFIG_SECTION_WORKING_COPY,
+                     SVN_CONFIG_OPTION_PRISTINE_CACHE_DIR,
+                     NULL);
+      if (pristine_cache_dir && *pristine_cache_dir)
+        SVN_ERR(svn_dirent_get_absolute(&(*db)->pristine_cache_dir,
+                                        svn_dirent_internal_style(
+                                          pristine_cache_dir, scratch_pool),
+                                        result_pool));
+
+      err = svn_config_get_bool(config, &(*db)->compress_pristines,
+                                SVN_CONFIG_SECTION_WORKING_COPY,
+                                SVN_CONFIG_OPTION_COMPRESS_PRISTINES,
+                                FALSE);
+      if (err)
+        {
+          svn_error_clear(err);
+          (*db)->compress_pristines = FALSE;
+        }
     }
 
   return SVN_NO_ERROR;
@@ -302,6 +343,8 @@ svn_wc__db_pdh_create_wcroot(svn_wc__db_wcroot_t **wcroot,
                              int format,
                              svn_boolean_t verify_format,
                              svn_boolean_t store_pristine,
+                             const char *pristine_cache_dir,
+                             svn_boolean_t compress_pristines,
                              apr_pool_t *result_pool,
                              apr_pool_t *scratch_pool)
 {
@@ -390,6 +433,10 @@ svn_wc__db_pdh_create_wcroot(svn_wc__db_wcroot_t **wcroot,
                                           sizeof(svn_wc__db_wclock_t));
   (*wcroot)->access_cache = apr_hash_make(result_pool);
   (*wcroot)->store_pristine = store_pristine;
+  (*wcroot)->pristine_index = NULL;
+  (*wcroot)->pristine_index_pool = svn_pool_create(result_pool);
+  (*wcroot)->pristine_cache_dir = pristine_cache_dir;
+  (*wcroot)->compress_pristines = compress_pristines;
 
   /* SDB will be NULL for pre-NG working copies. We only need to run a
      cleanup when the SDB is present.  */
@@ -687,6 +734,13 @@ svn_wc__db_wcroot_parse_local_abspath(svn_wc__db_wcroot_t **wcroot,
                                         db->state_pool, scratch_pool);
           if (err == NULL)
             {
+              /* Apply the user's page cache / mmap tuning.  The handle is
+                 cached in DB, so larger caches keep paying off across all
+                 operations of this wcroot. */
+              if (db->cache_size != 0 || db->mmap_size > 0)
+                SVN_ERR(svn_sqlite__set_cache_tuning(sdb, db->cache_size,
+                                                     db->mmap_size,
+                                                     iterpool));
 #ifdef SVN_DEBUG
               /* Install self-verification trigger statements. */
               err = svn_sqlite__exec_statements(sdb,
@@ -819,6 +873,8 @@ try_symlink_as_dir:
                             sdb, wc_id, format,
                             db->verify_format,
                             store_pristine,
+                            db->pristine_cache_dir,
+                            db->compress_pristines,
                             db->state_pool, scratch_pool);
       if (err && (err->apr_err == SVN_ERR_WC_UNSUPPORTED_FORMAT ||
                   err->apr_err == SVN_ERR_WC_UPGRADE_REQUIRED) &&
@@ -895,6 +951,8 @@ try_symlink_as_dir:
                             NULL, UNKNOWN_WC_ID, wc_format,
                             db->verify_format,
                             TRUE,
+                            db->pristine_cache_dir,
+                            db->compress_pristines,
                             db->state_pool, scratch_pool));
     }
 
@@ -42,6 +42,7 @@
 #include "private/svn_io_private.h"
 #include "private/svn_wc_private.h"
 #include "private/svn_skel.h"
+#include "private/svn_task.h"
 
 
 /* Workqueue operation names.  */
@@ -468,51 +469,72 @@ svn_wc__wq_build_postupgrade(svn_skel_t **work_item,
 
 /* OP_FILE_INSTALL */
 
-/* Process the OP_FILE_INSTALL work item WORK_ITEM.
- * See svn_wc__wq_build_file_install() which generates this work item.
- * Implements (struct work_item_dispatch).func. */
+/* Everything needed to put a working file into place, gathered up front
+ * from the wc_db so that the actual I/O can run without touching the
+ * database (and hence off the main thread, see the install batching in
+ * svn_wc__wq_run). */
+struct file_install_data_t
+{
+  /* Where the file shall be installed. */
+  const char *local_abspath;
+
+  /* The (translated or pristine) contents to install. */
+  const char *source_abspath;
+
+  /* The working copy's temp directory. */
+  const char *temp_dir_abspath;
+
+  /* Timestamp to set on the final file, or -1. */
+  apr_time_t final_mtime;
+
+  /* Translation parameters. */
+  svn_subst_eol_style_t eol_style;
+  const char *eol;
+  apr_hash_t *keywords;
+
+  /* File flavor and flags. */
+  svn_boolean_t is_special;
+  svn_boolean_t is_executable;
+  svn_boolean_t is_readonly;
+
+  /* Whether the final mtime and size shall be recorded in the db. */
+  svn_boolean_t record_fileinfo;
+};
+
+/* Gather all data needed to execute the OP_FILE_INSTALL work item
+ * WORK_ITEM into *DATA_P, allocated in RESULT_POOL.  This part talks to
+ * the wc_db and must run single-threaded.  Use SCRATCH_POOL for
+ * temporary allocations. */
 static svn_error_t *
-run_file_install(work_item_baton_t *wqb,
-                 svn_wc__db_t *db,
-                 const svn_skel_t *work_item,
-                 const char *wri_abspath,
-                 svn_cancel_func_t cancel_func,
-                 void *cancel_baton,
-                 apr_pool_t *scratch_pool)
+file_install_prepare(struct file_install_data_t **data_p,
+                     svn_wc__db_t *db,
+                     const svn_skel_t *work_item,
+                     const char *wri_abspath,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
 {
   const svn_skel_t *arg1 = work_item->children->next;
   const svn_skel_t *arg4 = arg1->next->next->next;
+  struct file_install_data_t *data = apr_pcalloc(result_pool, sizeof(*data));
   const char *local_relpath;
   const char *local_abspath;
   svn_boolean_t use_commit_times;
-  svn_boolean_t record_fileinfo;
-  svn_stream_t *src_stream;
   const char *temp_dir_abspath;
   apr_int64_t val;
   const char *wcroot_abspath;
   const char *source_abspath;
   const svn_checksum_t *checksum;
   apr_hash_t *props;
-  svn_boolean_t is_special;
-  svn_boolean_t is_executable;
   svn_boolean_t needs_lock;
   const char *eol_propval;
-  svn_subst_eol_style_t eol_style;
-  const char *eol;
   const char *keywords_propval;
-  apr_hash_t *keywords;
   apr_time_t changed_date;
   svn_revnum_t changed_rev;
   const char *changed_author;
-  apr_time_t final_mtime;
   svn_wc__db_status_t status;
   svn_wc__db_lock_t *lock;
   const char *repos_relpath;
   const char *repos_root_url;
-  svn_wc__working_file_writer_t *file_writer;
-  apr_time_t record_mtime;
-  apr_off_t record_size;
-  svn_boolean_t is_readonly;
 
   local_relpath = apr_pstrmemdup(scratch_pool, arg1->data, arg1->len);
   SVN_ERR(svn_wc__db_from_relpath(&local_abspath, db, wri_abspath,
@@ -521,7 +543,7 @@ run_file_install(work_item_baton_t *wqb,
   SVN_ERR(svn_skel__parse_int(&val, arg1->next, scratch_pool));
   use_commit_times = (val != 0);
   SVN_ERR(svn_skel__parse_int(&val, arg1->next->next, scratch_pool));
-  record_fileinfo = (val != 0);
+  data->record_fileinfo = (val != 0);
 
   SVN_ERR(svn_wc__db_read_node_install_info(&wcroot_abspath,
                                             &checksum, &props,
@@ -566,12 +588,14 @@ run_file_install(work_item_baton_t *wqb,
                                          db, wcroot_abspath,
                                          scratch_pool, scratch_pool));
 
-  is_special = svn_prop_get_value(props, SVN_PROP_SPECIAL) != NULL;
-  is_executable = svn_prop_get_value(props, SVN_PROP_EXECUTABLE) != NULL;
+  data->is_special = svn_prop_get_value(props, SVN_PROP_SPECIAL) != NULL;
+  data->is_executable = svn_prop_get_value(props, SVN_PROP_EXECUTABLE) != NULL;
   needs_lock = svn_prop_get_value(props, SVN_PROP_NEEDS_LOCK) != NULL;
 
   eol_propval = svn_prop_get_value(props, SVN_PROP_EOL_STYLE);
-  svn_subst_eol_style_from_value(&eol_style, &eol, eol_propval);
+  svn_subst_eol_style_from_value(&data->eol_style, &data->eol, eol_propval);
+  if (data->eol)
+    data->eol = apr_pstrdup(result_pool, data->eol);
 
   keywords_propval = svn_prop_get_value(props, SVN_PROP_KEYWORDS);
 
@@ -584,11 +608,11 @@ run_file_install(work_item_baton_t *wqb,
                                  NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
                                  db, local_abspath,
                                  scratch_pool, scratch_pool));
- 
+
   if (keywords_propval)
     {
       const char *url;
-                                           
+
       /* Handle special statuses (e.g. added) */
       if (!repos_relpath)
         SVN_ERR(svn_wc__db_read_repos_info(NULL, &repos_relpath,
@@ -599,67 +623,120 @@ run_file_install(work_item_baton_t *wqb,
       url = svn_path_url_add_component2(repos_root_url, repos_relpath,
                                         scratch_pool);
 
-      SVN_ERR(svn_subst_build_keywords3(&keywords, keywords_propval,
+      SVN_ERR(svn_subst_build_keywords3(&data->keywords, keywords_propval,
                                         apr_psprintf(scratch_pool, "%ld",
                                                      changed_rev),
                                         url, repos_root_url, changed_date,
-                                        changed_author, scratch_pool));
+                                        changed_author, result_pool));
     }
   else
     {
-      keywords = NULL;
+      data->keywords = NULL;
     }
 
   if (use_commit_times && changed_date)
-    final_mtime = changed_date;
+    data->final_mtime = changed_date;
   else
-    final_mtime = -1;
+    data->final_mtime = -1;
 
   if (needs_lock && !lock && status != svn_wc__db_status_added)
-    is_readonly = TRUE;
+    data->is_readonly = TRUE;
   else
-    is_readonly = FALSE;
+    data->is_readonly = FALSE;
+
+  data->local_abspath = apr_pstrdup(result_pool, local_abspath);
+  data->source_abspath = apr_pstrdup(result_pool, source_abspath);
+  data->temp_dir_abspath = apr_pstrdup(result_pool, temp_dir_abspath);
+
+  *data_p = data;
+  return SVN_NO_ERROR;
+}
+
+/* Create, translate and move into place the working file described by
+ * DATA.  Set *RECORD_MTIME and *RECORD_SIZE to the values to record in
+ * the db, or to -1 if DATA does not ask for fileinfo recording.  This
+ * part performs no database access at all and may run on any thread.
+ * Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+file_install_execute(apr_time_t *record_mtime,
+                     apr_off_t *record_size,
+                     const struct file_install_data_t *data,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *scratch_pool)
+{
+  svn_wc__working_file_writer_t *file_writer;
+  svn_stream_t *src_stream;
 
   SVN_ERR(svn_wc__working_file_writer_open(&file_writer,
-                                           temp_dir_abspath,
-                                           final_mtime,
-                                           eol_style,
-                                           eol,
+                                           data->temp_dir_abspath,
+                                           data->final_mtime,
+                                           data->eol_style,
+                                           data->eol,
                                            TRUE /* repair_eol */,
-                                           keywords,
-                                           is_special,
-                                           is_executable,
-                                           is_readonly,
+                                           data->keywords,
+                                           data->is_special,
+                                           data->is_executable,
+                                           data->is_readonly,
                                            scratch_pool,
                                            scratch_pool));
 
-  SVN_ERR(svn_stream_open_readonly(&src_stream, source_abspath,
-                                   scratch_pool, scratch_pool));
+  /* SOURCE_ABSPATH is usually a pristine path, which may hold the text
+   * in compressed form; this opens plain files as-is and decompresses
+   * compressed pristines transparently. */
+  SVN_ERR(svn_wc__db_pristine_open_future_path(&src_stream,
+                                               data->source_abspath,
+                                               scratch_pool, scratch_pool));
 
   SVN_ERR(svn_stream_copy3(src_stream,
                            svn_wc__working_file_writer_get_stream(file_writer),
                            cancel_func, cancel_baton,
                            scratch_pool));
 
-  if (record_fileinfo)
+  if (data->record_fileinfo)
     {
-      SVN_ERR(svn_wc__working_file_writer_finalize(&record_mtime, &record_size,
+      SVN_ERR(svn_wc__working_file_writer_finalize(record_mtime, record_size,
                                                    file_writer, scratch_pool));
     }
   else
     {
       SVN_ERR(svn_wc__working_file_writer_finalize(NULL, NULL, file_writer,
                                                    scratch_pool));
-      record_mtime = -1;
-      record_size = -1;
+      *record_mtime = -1;
+      *record_size = -1;
     }
 
-  SVN_ERR(svn_wc__working_file_writer_install(file_writer, local_abspath,
+  SVN_ERR(svn_wc__working_file_writer_install(file_writer,
+                                              data->local_abspath,
                                               scratch_pool));
 
-  if (record_fileinfo)
+  return SVN_NO_ERROR;
+}
+
+/* Process the OP_FILE_INSTALL work item WORK_ITEM.
+ * See svn_wc__wq_build_file_install() which generates this work item.
+ * Implements (struct work_item_dispatch).func. */
+static svn_error_t *
+run_file_install(work_item_baton_t *wqb,
+                 svn_wc__db_t *db,
+                 const svn_skel_t *work_item,
+                 const char *wri_abspath,
+                 svn_cancel_func_t cancel_func,
+                 void *cancel_baton,
+                 apr_pool_t *scratch_pool)
+{
+  struct file_install_data_t *data;
+  apr_time_t record_mtime;
+  apr_off_t record_size;
+
+  SVN_ERR(file_install_prepare(&data, db, work_item, wri_abspath,
+                               scratch_pool, scratch_pool));
+  SVN_ERR(file_install_execute(&record_mtime, &record_size, data,
+                               cancel_func, cancel_baton, scratch_pool));
+
+  if (data->record_fileinfo)
     {
-      wq_record_fileinfo(wqb, local_abspath, record_mtime, record_size);
+      wq_record_fileinfo(wqb, data->local_abspath, record_mtime, record_size);
     }
 
   return SVN_NO_ERROR;
@@ -1505,6 +1582,201 @@ dispatch_work_item(work_item_baton_t *wqb,
   return SVN_NO_ERROR;
 }
 
+/* Number of worker threads used to execute a batch's file installs.
+ * Since the installs are plain file I/O, a small thread count is enough
+ * to keep the disk's request queue filled. */
+#define WQ_FILE_INSTALL_THREADS 4
+
+/* A file install that has been prepared but not executed yet. */
+typedef struct pending_install_t
+{
+  /* The id of the respective work queue item. */
+  apr_uint64_t id;
+
+  /* The item's unparsed skel, for error messages. */
+  const char *skel;
+
+  /* The prepared install parameters. */
+  struct file_install_data_t *data;
+} pending_install_t;
+
+/* Baton for the install flush machinery below. */
+typedef struct install_flush_baton_t
+{
+  /* The installs to execute, pending_install_t elements. */
+  apr_array_header_t *pending;
+
+  /* The wri_abspath given to svn_wc__wq_run, for error messages. */
+  const char *wri_abspath;
+
+  /* Where to record fileinfo for completed installs. */
+  work_item_baton_t *wqb;
+
+  /* Where to record the ids of completed work items. */
+  apr_array_header_t *completed_ids;
+} install_flush_baton_t;
+
+/* The result of executing a single pending install. */
+typedef struct install_result_t
+{
+  /* The install that this result belongs to. */
+  const pending_install_t *item;
+
+  /* Fileinfo to record, or -1 if none shall be recorded. */
+  apr_time_t mtime;
+  apr_off_t size;
+} install_result_t;
+
+/* Execute the single pending install given by PROCESS_BATON.  This may
+ * run in a worker thread and must not touch the wc_db.
+ * Implements svn_task__process_func_t. */
+static svn_error_t *
+install_task_process(void **result,
+                     svn_task__t *task,
+                     void *thread_context,
+                     void *process_baton,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  const pending_install_t *item = process_baton;
+  const install_flush_baton_t *fb = thread_context;
+  install_result_t *install_result = apr_pcalloc(result_pool,
+                                                 sizeof(*install_result));
+  svn_error_t *err;
+
+  err = file_install_execute(&install_result->mtime, &install_result->size,
+                             item->data, NULL, NULL, scratch_pool);
+  if (err)
+    return svn_error_createf(SVN_ERR_WC_BAD_ADM_LOG, err,
+                             _("Failed to run the WC DB work queue "
+                               "associated with '%s', work item %d %s"),
+                             svn_dirent_local_style(fb->wri_abspath,
+                                                    scratch_pool),
+                             (int)item->id, item->skel);
+
+  install_result->item = item;
+  *result = install_result;
+
+  return SVN_NO_ERROR;
+}
+
+/* Record the completion of the install that produced RESULT.  This runs
+ * in the main thread, in queue order.
+ * Implements svn_task__output_func_t. */
+static svn_error_t *
+install_task_output(svn_task__t *task,
+                    void *result,
+                    void *output_baton,
+                    svn_cancel_func_t cancel_func,
+                    void *cancel_baton,
+                    apr_pool_t *result_pool,
+                    apr_pool_t *scratch_pool)
+{
+  install_result_t *install_result = result;
+  install_flush_baton_t *fb = output_baton;
+  const pending_install_t *item = install_result->item;
+
+  if (item->data->record_fileinfo)
+    wq_record_fileinfo(fb->wqb, item->data->local_abspath,
+                       install_result->mtime, install_result->size);
+
+  /* The work item finished without error.  Mark it completed in the
+     next batch fetch.  */
+  APR_ARRAY_PUSH(fb->completed_ids, apr_uint64_t) = item->id;
+
+  return SVN_NO_ERROR;
+}
+
+/* Spawn one sub-task per pending install in the install_flush_baton_t
+ * given by PROCESS_BATON.
+ * Implements svn_task__process_func_t. */
+static svn_error_t *
+install_root_process(void **result,
+                     svn_task__t *task,
+                     void *thread_context,
+                     void *process_baton,
+                     svn_cancel_func_t cancel_func,
+                     void *cancel_baton,
+                     apr_pool_t *result_pool,
+                     apr_pool_t *scratch_pool)
+{
+  install_flush_baton_t *fb = process_baton;
+  int i;
+
+  for (i = 0; i < fb->pending->nelts; ++i)
+    {
+      pending_install_t *item = &APR_ARRAY_IDX(fb->pending, i,
+                                               pending_install_t);
+      apr_pool_t *process_pool = svn_task__create_process_pool(task);
+
+      SVN_ERR(svn_task__add(task, process_pool, NULL,
+                            install_task_process, item,
+                            install_task_output, fb));
+    }
+
+  *result = NULL;
+  return SVN_NO_ERROR;
+}
+
+/* Return the flush baton itself as per-worker context, so that the
+ * process function can produce proper error messages.
+ * Implements svn_task__thread_context_constructor_t. */
+static svn_error_t *
+install_context_construct(void **thread_context,
+                          void *context_baton,
+                          apr_pool_t *result_pool,
+                          apr_pool_t *scratch_pool)
+{
+  *thread_context = context_baton;
+  return SVN_NO_ERROR;
+}
+
+/* Execute all file installs queued up in PENDING, using worker threads,
+ * and record their completion in WQB and COMPLETED_IDS.  WRI_ABSPATH is
+ * used for error messages.  On success, clear PENDING and the target
+ * index PENDING_TARGETS so that further installs can be queued.
+ *
+ * Results are recorded in the main thread and in queue order, i.e. if
+ * this returns an error, all installs whose ids have been pushed onto
+ * COMPLETED_IDS have fully completed and all later ones remain in the
+ * queue.  Since running a work item twice is safe by design, installs
+ * that were executed but whose completion was not recorded will simply
+ * be re-run by a later 'svn cleanup'. */
+static svn_error_t *
+wq_flush_installs(work_item_baton_t *wqb,
+                  apr_array_header_t *completed_ids,
+                  apr_array_header_t *pending,
+                  apr_hash_t *pending_targets,
+                  const char *wri_abspath,
+                  apr_pool_t *scratch_pool)
+{
+  install_flush_baton_t fb;
+
+  if (pending->nelts == 0)
+    return SVN_NO_ERROR;
+
+  fb.pending = pending;
+  fb.wri_abspath = wri_abspath;
+  fb.wqb = wqb;
+  fb.completed_ids = completed_ids;
+
+  /* Cancellation checks remain with the caller's main loop; the workers
+     only ever perform a bounded amount of file I/O. */
+  SVN_ERR(svn_task__run(WQ_FILE_INSTALL_THREADS,
+                        install_root_process, &fb,
+                        NULL, NULL,
+                        install_context_construct, &fb,
+                        NULL, NULL,
+                        scratch_pool, scratch_pool));
+
+  apr_array_clear(pending);
+  apr_hash_clear(pending_targets);
+
+  return SVN_NO_ERROR;
+}
+
 
 svn_error_t *
 svn_wc__wq_run(svn_wc__db_t *db,
@@ -1514,7 +1786,9 @@ svn_wc__wq_run(svn_wc__db_t *db,
                apr_pool_t *scratch_pool)
 {
   apr_pool_t *iterpool = svn_pool_create(scratch_pool);
-  apr_uint64_t last_id = 0;
+  apr_pool_t *batch_pool = svn_pool_create(scratch_pool);
+  apr_array_header_t *completed_ids
+    = apr_array_make(scratch_pool, 16, sizeof(apr_uint64_t));
   work_item_baton_t wib = { 0 };
   wib.result_pool = svn_pool_create(scratch_pool);
 
@@ -1534,66 +1808,135 @@ svn_wc__wq_run(svn_wc__db_t *db,
 
   while (TRUE)
     {
-      apr_uint64_t id;
-      svn_skel_t *work_item;
-      svn_error_t *err;
-
-      svn_pool_clear(iterpool);
-
-      if (! wib.used)
+      apr_array_header_t *work_items;
+      apr_array_header_t *pending_installs;
+      apr_hash_t *pending_targets;
+      int i;
+
+      svn_pool_clear(batch_pool);
+
+      /* File installs found in this batch are queued up here and executed
+         with worker threads, see wq_flush_installs.  The target index
+         detects repeated installs to the same path, which must not be
+         reordered wrt. each other.  */
+      pending_installs = apr_array_make(batch_pool, 16,
+                                        sizeof(pending_install_t));
+      pending_targets = apr_hash_make(batch_pool);
+
+      /* Make sure to do this *early* in the loop iteration. There may
+         be completed items that need to be marked as such, and fileinfo
+         that needs to be recorded, *before* we start worrying about
+         anything else.  Fetching a whole batch per transaction keeps the
+         journalling overhead of the database away from the hot loop.  */
+      SVN_ERR(svn_wc__db_wq_fetch_batch(&work_items, db, wri_abspath,
+                                        completed_ids,
+                                        wib.used ? wib.record_map : NULL,
+                                        batch_pool, batch_pool));
+
+      apr_array_clear(completed_ids);
+      if (wib.used)
         {
-          /* Make sure to do this *early* in the loop iteration. There may
-             be a LAST_ID that needs to be marked as completed, *before* we
-             start worrying about anything else.  */
-          SVN_ERR(svn_wc__db_wq_fetch_next(&id, &work_item, db, wri_abspath,
-                                           last_id, iterpool, iterpool));
-        }
-      else
-        {
-          /* Make sure to do this *early* in the loop iteration. There may
-             be a LAST_ID that needs to be marked as completed, *before* we
-             start worrying about anything else.  */
-          SVN_ERR(svn_wc__db_wq_record_and_fetch_next(&id, &work_item,
-                                                      db, wri_abspath,
-                                                      last_id, wib.record_map,
-                                                      iterpool,
-                                                      wib.result_pool));
-
           svn_pool_clear(wib.result_pool);
           wib.record_map = NULL;
           wib.used = FALSE;
         }
 
-      /* Stop work queue processing, if requested. A future 'svn cleanup'
-         should be able to continue the processing. Note that we may
-         have WORK_ITEM, but we'll just skip its processing for now.  */
-      if (cancel_func)
-        SVN_ERR(cancel_func(cancel_baton));
-
-      /* If we have a WORK_ITEM, then process the sucker. Otherwise,
-         we're done.  */
-      if (work_item == NULL)
+      /* If the queue is empty, we're done.  */
+      if (work_items->nelts == 0)
         break;
 
-      err = dispatch_work_item(&wib, db, wri_abspath, work_item,
-                               cancel_func, cancel_baton, iterpool);
-      if (err)
+      for (i = 0; i < work_items->nelts; ++i)
         {
-          const char *skel = svn_skel__unparse(work_item, scratch_pool)->data;
-
-          return svn_error_createf(SVN_ERR_WC_BAD_ADM_LOG, err,
-                                   _("Failed to run the WC DB work queue "
-                                     "associated with '%s', work item %d %s"),
-                                   svn_dirent_local_style(wri_abspath,
-                                                          scratch_pool),
-                                   (int)id, skel);
+          const svn_wc__db_wq_item_t *item
+            = &APR_ARRAY_IDX(work_items, i, svn_wc__db_wq_item_t);
+          svn_error_t *err;
+
+          svn_pool_clear(iterpool);
+
+          /* Stop work queue processing, if requested. A future 'svn cleanup'
+             should be able to continue the processing.  Items of this batch
+             that already ran have not been marked as completed yet, but
+             running a work item twice is safe by design.  */
+          if (cancel_func)
+            SVN_ERR(cancel_func(cancel_baton));
+
+          if (svn_skel__matches_atom(item->work_item->children,
+                                     OP_FILE_INSTALL))
+            {
+              struct file_install_data_t *data;
+              pending_install_t *pending;
+
+              err = file_install_prepare(&data, db, item->work_item,
+                                         wri_abspath, batch_pool, iterpool);
+              if (err)
+                {
+                  const char *skel = svn_skel__unparse(item->work_item,
+                                                       scratch_pool)->data;
+
+                  return svn_error_createf(SVN_ERR_WC_BAD_ADM_LOG, err,
+                                           _("Failed to run the WC DB work "
+                                             "queue associated with '%s', "
+                                             "work item %d %s"),
+                                           svn_dirent_local_style(wri_abspath,
+                                                                  scratch_pool),
+                                           (int)item->id, skel);
+                }
+
+              /* Two installs to the same path must run in queue order,
+                 so complete all queued installs before adding the
+                 second one.  */
+              if (svn_hash_gets(pending_targets, data->local_abspath))
+                SVN_ERR(wq_flush_installs(&wib, completed_ids,
+                                          pending_installs, pending_targets,
+                                          wri_abspath, iterpool));
+
+              pending = apr_array_push(pending_installs);
+              pending->id = item->id;
+              pending->skel = svn_skel__unparse(item->work_item,
+                                                batch_pool)->data;
+              pending->data = data;
+              svn_hash_sets(pending_targets, data->local_abspath,
+                            data->local_abspath);
+
+              /* The item's id will be pushed onto COMPLETED_IDS by
+                 install_task_output once the install has happened.  */
+              continue;
+            }
+
+          /* Any other work item may depend on the effects of earlier
+             installs, so it acts as a barrier.  */
+          SVN_ERR(wq_flush_installs(&wib, completed_ids, pending_installs,
+                                    pending_targets, wri_abspath, iterpool));
+
+          err = dispatch_work_item(&wib, db, wri_abspath, item->work_item,
+                                   cancel_func, cancel_baton, iterpool);
+          if (err)
+            {
+              const char *skel = svn_skel__unparse(item->work_item,
+                                                   scratch_pool)->data;
+
+              return svn_error_createf(SVN_ERR_WC_BAD_ADM_LOG, err,
+                                       _("Failed to run the WC DB work queue "
+                                         "associated with '%s', work item "
+                                         "%d %s"),
+                                       svn_dirent_local_style(wri_abspath,
+                                                              scratch_pool),
+                                       (int)item->id, skel);
+            }
+
+          /* The work item finished without error. Mark it completed
+             in the next batch fetch.  */
+          APR_ARRAY_PUSH(completed_ids, apr_uint64_t) = item->id;
         }
 
-      /* The work item finished without error. Mark it completed
-         in the next loop.  */
-      last_id = id;
+      /* Execute the installs left over at the end of the batch.  Their
+         completion is recorded in the same transaction as the next batch
+         fetch, giving one durability barrier per batch.  */
+      SVN_ERR(wq_flush_installs(&wib, completed_ids, pending_installs,
+                                pending_targets, wri_abspath, batch_pool));
     }
 
+  svn_pool_destroy(batch_pool);
   svn_pool_destroy(iterpool);
   return SVN_NO_ERROR;
 }
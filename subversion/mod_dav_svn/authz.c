@@ -156,6 +156,8 @@ authz_read(svn_boolean_t *allowed,
   dav_svn__authz_read_baton *arb = baton;
   svn_revnum_t rev = SVN_INVALID_REVNUM;
   const char *revpath = NULL;
+  const char *key;
+  svn_boolean_t *verdict;
 
   /* Our ultimate goal here is to create a Version Resource (VR) url,
      which is a url that represents a path within a revision.  We then
@@ -216,9 +218,30 @@ authz_read(svn_boolean_t *allowed,
       revpath = path;
     }
 
-  /* We have a (rev, path) pair to check authorization on. */
+  /* We have a (rev, path) pair to check authorization on.
+
+     Memoize the verdict in the baton:  tree walks such as the update
+     report ask about the same parent paths over and over again, and
+     every miss costs a full subrequest.  The cache lives in the
+     request pool, so it covers exactly one editor drive. */
+  if (arb->verdict_cache == NULL)
+    arb->verdict_cache = apr_hash_make(arb->r->pool);
+
+  key = apr_psprintf(pool, "%ld:%s", rev, revpath);
+  verdict = apr_hash_get(arb->verdict_cache, key, APR_HASH_KEY_STRING);
+  if (verdict)
+    {
+      *allowed = *verdict;
+      return SVN_NO_ERROR;
+    }
+
   *allowed = dav_svn__allow_read(arb->r, arb->repos, revpath, rev, pool);
 
+  verdict = apr_palloc(arb->r->pool, sizeof(*verdict));
+  *verdict = *allowed;
+  apr_hash_set(arb->verdict_cache, apr_pstrdup(arb->r->pool, key),
+               APR_HASH_KEY_STRING, verdict);
+
   return SVN_NO_ERROR;
 }
 
@@ -490,6 +490,19 @@ svn_error_t *
 dav_svn__output_pass_brigade(dav_svn__output *output,
                              apr_bucket_brigade *bb);
 
+/* Return a bucket, allocated from OUTPUT's bucket allocator, which
+   delivers the contents of STREAM on demand:  each read pulls at most
+   SVN__STREAM_CHUNK_SIZE bytes from STREAM, so the filter stack (and,
+   with an async MPM, the write completion machinery) fetches data only
+   as fast as the client drains it instead of a handler loop pumping
+   the whole response through a pinned worker thread.  STREAM must
+   remain usable for the lifetime of the request; the baton is
+   allocated in POOL. */
+apr_bucket *
+dav_svn__bucket_from_stream(svn_stream_t *stream,
+                            dav_svn__output *output,
+                            apr_pool_t *pool);
+
 
 /*** activity.c ***/
 
@@ -785,6 +798,11 @@ typedef struct dav_svn__authz_read_baton
   /* We need this to construct a URI based on a repository abs path. */
   const dav_svn_repos *repos;
 
+  /* Verdicts from earlier checks made through this baton, keyed by
+     "REV:PATH" and mapping to svn_boolean_t *.  Lazily created in the
+     request pool by authz_read(); initialize to NULL. */
+  apr_hash_t *verdict_cache;
+
 } dav_svn__authz_read_baton;
 
 
@@ -252,6 +252,7 @@ dav_svn__file_revs_report(const dav_resource *resource,
   /* Construct the authz read check baton. */
   arb.r = resource->info->r;
   arb.repos = resource->info->repos;
+  arb.verdict_cache = NULL;
 
   /* Sanity check. */
   if (!resource->info->repos_path)
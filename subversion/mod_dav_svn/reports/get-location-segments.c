@@ -212,6 +212,7 @@ dav_svn__get_location_segments_report(const dav_resource *resource,
   /* Build an authz read baton. */
   arb.r = resource->info->r;
   arb.repos = resource->info->repos;
+  arb.verdict_cache = NULL;
 
   /* Build the bucket brigade we'll use for output. */
   bb = apr_brigade_create(resource->pool,
@@ -156,6 +156,7 @@ dav_svn__get_locations_report(const dav_resource *resource,
   /* Build an authz read baton */
   arb.r = resource->info->r;
   arb.repos = resource->info->repos;
+  arb.verdict_cache = NULL;
 
   serr = svn_repos_trace_node_locations(resource->info->repos->fs,
                                         &fs_locations, abs_path, peg_revision,
@@ -180,6 +180,7 @@ dav_svn__get_locks_report(const dav_resource *resource,
 
   arb.r = resource->info->r;
   arb.repos = resource->info->repos;
+  arb.verdict_cache = NULL;
 
   /* See if the client provided additional information for this request. */
   for (this_attr = doc->root->attr; this_attr; this_attr = this_attr->next)
@@ -104,6 +104,7 @@ dav_svn__get_inherited_props_report(const dav_resource *resource,
   /* Build authz read baton */
   arb.r = resource->info->r;
   arb.repos = resource->info->repos;
+  arb.verdict_cache = NULL;
 
   /* Build inherited property brigade */
   bb = apr_brigade_create(resource->pool,
@@ -289,6 +289,7 @@ dav_svn__list_report(const dav_resource *resource,
   /* Build authz read baton */
   arb.r = resource->info->r;
   arb.repos = resource->info->repos;
+  arb.verdict_cache = NULL;
 
   /* Build log receiver baton */
   lrb.bb = apr_brigade_create(resource->pool,  /* not the subpool! */
@@ -304,9 +305,11 @@ dav_svn__list_report(const dav_resource *resource,
     {
       /* Fetch the directory entries if requested and send them immediately. */
       path_info_only = (lrb.dirent_fields & ~SVN_DIRENT_KIND) == 0;
-      serr = svn_repos_list(root, full_path, patterns, depth, path_info_only,
-                            dav_svn__authz_read_func(&arb), &arb,
-                            list_receiver, &lrb, NULL, NULL, resource->pool);
+      serr = svn_repos_list2(root, full_path, patterns, depth,
+                             path_info_only, NULL, 0, /* no pagination */
+                             dav_svn__authz_read_func(&arb), &arb,
+                             list_receiver, &lrb, NULL, NULL,
+                             resource->pool);
     }
 
   if (serr)
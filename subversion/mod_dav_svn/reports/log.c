@@ -486,6 +486,7 @@ dav_svn__log_report(const dav_resource *resource,
   /* Build authz read baton */
   arb.r = resource->info->r;
   arb.repos = resource->info->repos;
+  arb.verdict_cache = NULL;
 
   /* Build log receiver baton */
   lrb.bb = apr_brigade_create(resource->pool,  /* not the subpool! */
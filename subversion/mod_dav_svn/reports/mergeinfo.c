@@ -200,6 +200,7 @@ dav_svn__get_mergeinfo_report(const dav_resource *resource,
   /* Build authz read baton */
   arb.r = resource->info->r;
   arb.repos = resource->info->repos;
+  arb.verdict_cache = NULL;
 
   /* Build mergeinfo brigade */
   bb = apr_brigade_create(resource->pool,
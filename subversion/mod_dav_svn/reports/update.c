@@ -42,6 +42,8 @@
 
 #include "private/svn_log.h"
 #include "private/svn_fspath.h"
+#include "private/svn_atomic.h"
+#include "private/svn_cache.h"
 
 #include "../dav_svn.h"
 
@@ -118,6 +120,11 @@ typedef struct item_baton_t {
   /* Base_checksum (from apply_textdelta). */
   const char *base_checksum;
 
+  /* Base revision (from open_file/open_directory); the revision any
+     delta for this item is computed against.  SVN_INVALID_REVNUM for
+     added items. */
+  svn_revnum_t base_rev;
+
   /* Did the file's contents change? */
   svn_boolean_t text_changed;
 
@@ -207,6 +214,7 @@ make_child_baton(item_baton_t *parent, const char *path, apr_pool_t *pool)
   baton->uc = parent->uc;
   baton->name = svn_relpath_basename(path, pool);
   baton->parent = parent;
+  baton->base_rev = SVN_INVALID_REVNUM;
 
   /* Telescope the path based on uc->anchor.  */
   baton->path = svn_fspath__join(parent->path, baton->name, pool);
@@ -429,6 +437,8 @@ open_helper(svn_boolean_t is_dir,
   item_baton_t *child = make_child_baton(parent, path, pool);
   const char *qname = apr_xml_quote_string(pool, child->name, 1);
 
+  child->base_rev = base_revision;
+
   SVN_ERR(dav_svn__brigade_printf(child->uc->bb, child->uc->output,
                                   "<S:open-%s name=\"%s\""
                                   " rev=\"%ld\">" DEBUG_CR,
@@ -749,6 +759,42 @@ upd_open_file(const char *path,
 }
 
 
+/* Process-global cache mapping pairs of node-revisions - qualified by
+   repository UUID - to the svndiff-encoded delta between their texts.
+   When whole build farms update to the same new revision, every client
+   requests the very same deltas; serving them from this cache saves
+   recomputing and recompressing them for each client.  Remains NULL if
+   no global cache is configured. */
+static svn_cache__t *svndiff_cache = NULL;
+static volatile svn_atomic_t svndiff_cache_state = 0;
+
+/* Don't cache svndiff texts larger than this.  Large deltas are rare,
+   would evict many smaller entries and are comparatively cheap to
+   recompute per request. */
+#define SVNDIFF_CACHE_MAX_ENTRY_SIZE (1024 * 1024)
+
+/* Implements svn_atomic__err_init_func_t, initializing SVNDIFF_CACHE. */
+static svn_error_t *
+initialize_svndiff_cache(void *baton, apr_pool_t *pool)
+{
+  svn_membuffer_t *membuffer = svn_cache__get_global_membuffer_cache();
+
+  /* No in-memory cache configured for this process. */
+  if (!membuffer)
+    return SVN_NO_ERROR;
+
+  /* The cache front-end must live as long as the process, not as long
+     as the current request. */
+  SVN_ERR(svn_cache__create_membuffer_cache(
+              &svndiff_cache, membuffer, NULL, NULL,
+              APR_HASH_KEY_STRING, "DAV:SVNDIFF",
+              SVN_CACHE__MEMBUFFER_DEFAULT_PRIORITY,
+              TRUE, FALSE,
+              svn_pool_create(NULL), pool));
+
+  return SVN_NO_ERROR;
+}
+
 /* We have our own window handler and baton as a simple wrapper around
    the real handler (which converts txdelta windows to base64-encoded
    svndiff data).  The wrapper is responsible for sending the opening
@@ -760,6 +806,21 @@ struct window_handler_baton
 
   const char *base_checksum; /* For transfer as part of the S:txdelta element */
 
+  /* The file baton's pool, outliving the individual windows. */
+  apr_pool_t *pool;
+
+  /* If non-NULL, store the encoded delta in SVNDIFF_CACHE under this
+     key once it is complete. */
+  const char *cache_key;
+
+  /* svndiff data encoded so far.  NULL if we are not caching this delta
+     or if it turned out to be too large. */
+  svn_stringbuf_t *svndiff_text;
+
+  /* The base64-encoding output stream that the encoded data ultimately
+     goes to. */
+  svn_stream_t *base64_stream;
+
   /* The _real_ window handler and baton. */
   svn_txdelta_window_handler_t handler;
   void *handler_baton;
@@ -791,11 +852,47 @@ window_handler(svn_txdelta_window_t *window, void *baton)
     {
       SVN_ERR(dav_svn__brigade_puts(wb->uc->bb, wb->uc->output,
                                     "</S:txdelta>"));
+
+      /* Remember the complete delta for other clients requesting the
+         same update. */
+      if (wb->cache_key && wb->svndiff_text)
+        SVN_ERR(svn_cache__set(svndiff_cache, wb->cache_key,
+                               wb->svndiff_text, wb->pool));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_write_fn_t.  Forward DATA to the base64 output stream
+   in BATON and keep a copy for the svndiff cache. */
+static svn_error_t *
+svndiff_collector_write_cb(void *baton, const char *data, apr_size_t *len)
+{
+  struct window_handler_baton *wb = baton;
+
+  SVN_ERR(svn_stream_write(wb->base64_stream, data, len));
+
+  /* Stop collecting if the delta turns out to be too large to cache. */
+  if (wb->svndiff_text)
+    {
+      if (wb->svndiff_text->len + *len > SVNDIFF_CACHE_MAX_ENTRY_SIZE)
+        wb->svndiff_text = NULL;
+      else
+        svn_stringbuf_appendbytes(wb->svndiff_text, data, *len);
     }
 
   return SVN_NO_ERROR;
 }
 
+/* Implements svn_close_fn_t for the stream above. */
+static svn_error_t *
+svndiff_collector_close_cb(void *baton)
+{
+  struct window_handler_baton *wb = baton;
+
+  return svn_error_trace(svn_stream_close(wb->base64_stream));
+}
+
 static svn_error_t *
 upd_apply_textdelta(void *file_baton,
                     const char *base_checksum,
@@ -805,7 +902,7 @@ upd_apply_textdelta(void *file_baton,
 {
   item_baton_t *file = file_baton;
   struct window_handler_baton *wb;
-  svn_stream_t *base64_stream;
+  svn_stream_t *stream;
 
   /* Store the base checksum and the fact the file's text changed. */
   file->base_checksum = apr_pstrdup(file->pool, base_checksum);
@@ -824,12 +921,119 @@ upd_apply_textdelta(void *file_baton,
   wb->seen_first_window = FALSE;
   wb->uc = file->uc;
   wb->base_checksum = file->base_checksum;
-  base64_stream = dav_svn__make_base64_output_stream(wb->uc->bb,
-                                                     wb->uc->output,
-                                                     file->pool);
+  wb->pool = file->pool;
+  wb->cache_key = NULL;
+  wb->svndiff_text = NULL;
+
+  SVN_ERR(svn_atomic__init_once(&svndiff_cache_state,
+                                initialize_svndiff_cache, NULL, pool));
+
+  /* Try to serve the delta from the cache.  Both ends are identified by
+     their node-revision - created rev and created path - qualified by
+     the repository UUID.  Content checksums are deliberately not part
+     of the key: the cache is shared between all repositories served by
+     this process, and deduplicating on a digest would let anyone able
+     to commit a colliding file in one repository poison the deltas
+     delivered for another.  MD5, which is all the editor hands us,
+     admits chosen-prefix collisions. */
+  if (svndiff_cache && base_checksum && !file->added
+      && SVN_IS_VALID_REVNUM(file->base_rev))
+    {
+      svn_fs_t *fs = svn_fs_root_fs(file->uc->rev_root);
+      const char *real_path = get_real_fs_path(file, pool);
+      svn_fs_root_t *base_root;
+      svn_node_kind_t base_kind;
+      svn_checksum_t *base_md5 = NULL;
+
+      SVN_ERR(svn_fs_revision_root(&base_root, fs, file->base_rev, pool));
+      SVN_ERR(svn_fs_check_path(&base_kind, base_root, real_path, pool));
+
+      /* REAL_PATH @ BASE_REV must be the base the reporter computes the
+         delta against; verify that via the checksum it handed us.  If
+         they disagree - some exotic switch arrangement, perhaps - the
+         key would describe the wrong delta, so don't cache. */
+      if (base_kind == svn_node_file)
+        SVN_ERR(svn_fs_file_checksum(&base_md5, svn_checksum_md5,
+                                     base_root, real_path, FALSE, pool));
+
+      if (base_md5
+          && strcmp(svn_checksum_to_cstring(base_md5, pool),
+                    base_checksum) == 0)
+        {
+          svn_stringbuf_t *cached_text;
+          svn_boolean_t found;
+          const char *uuid;
+          svn_revnum_t base_created_rev, target_created_rev;
+          const char *base_created_path, *target_created_path;
+
+          SVN_ERR(svn_fs_get_uuid(fs, &uuid, pool));
+          SVN_ERR(svn_fs_node_created_rev(&base_created_rev, base_root,
+                                          real_path, pool));
+          SVN_ERR(svn_fs_node_created_path(&base_created_path, base_root,
+                                           real_path, pool));
+          /* PATH2 telescopes uc->dst_path exactly like the reporter's
+             target path does, so this is the node the delta leads to. */
+          SVN_ERR(svn_fs_node_created_rev(&target_created_rev,
+                                          file->uc->rev_root, file->path2,
+                                          pool));
+          SVN_ERR(svn_fs_node_created_path(&target_created_path,
+                                           file->uc->rev_root, file->path2,
+                                           pool));
+
+          wb->cache_key
+            = apr_psprintf(file->pool, "%s:%ld:%s:%ld:%s:%d:%d", uuid,
+                           base_created_rev, base_created_path,
+                           target_created_rev, target_created_path,
+                           file->uc->svndiff_version,
+                           file->uc->compression_level);
+
+          SVN_ERR(svn_cache__get((void **)&cached_text, &found,
+                                 svndiff_cache, wb->cache_key, pool));
+          if (found)
+            {
+              apr_size_t len = cached_text->len;
+
+              SVN_ERR(dav_svn__brigade_printf(
+                          file->uc->bb, file->uc->output,
+                          "<S:txdelta base-checksum=\"%s\">",
+                          base_checksum));
+
+              stream = dav_svn__make_base64_output_stream(file->uc->bb,
+                                                          file->uc->output,
+                                                          pool);
+              SVN_ERR(svn_stream_write(stream, cached_text->data, &len));
+              SVN_ERR(svn_stream_close(stream));
+
+              SVN_ERR(dav_svn__brigade_puts(file->uc->bb, file->uc->output,
+                                            "</S:txdelta>"));
+
+              /* The reporter will skip the delta computation altogether
+                 when it sees the no-op handler. */
+              *handler = svn_delta_noop_window_handler;
+              *handler_baton = NULL;
+              return SVN_NO_ERROR;
+            }
+
+          wb->svndiff_text = svn_stringbuf_create_empty(file->pool);
+        }
+    }
+
+  wb->base64_stream = dav_svn__make_base64_output_stream(wb->uc->bb,
+                                                         wb->uc->output,
+                                                         file->pool);
+
+  if (wb->svndiff_text)
+    {
+      /* Siphon off a copy of the encoded data as it streams by. */
+      stream = svn_stream_create(wb, file->pool);
+      svn_stream_set_write(stream, svndiff_collector_write_cb);
+      svn_stream_set_close(stream, svndiff_collector_close_cb);
+    }
+  else
+    stream = wb->base64_stream;
 
   svn_txdelta_to_svndiff3(&(wb->handler), &(wb->handler_baton),
-                          base64_stream, file->uc->svndiff_version,
+                          stream, file->uc->svndiff_version,
                           file->uc->compression_level, file->pool);
 
   *handler = window_handler;
@@ -985,6 +1189,7 @@ dav_svn__update_report(const dav_resource *resource,
   /* Construct the authz read check baton. */
   arb.r = resource->info->r;
   arb.repos = repos;
+  arb.verdict_cache = NULL;
 
   if ((resource->info->restype != DAV_SVN_RESTYPE_VCC)
       && (resource->info->restype != DAV_SVN_RESTYPE_ME))
@@ -57,6 +57,7 @@
 #include "private/svn_fspath.h"
 #include "private/svn_repos_private.h"
 #include "private/svn_sorts_private.h"
+#include "private/svn_subr_private.h"
 
 #include "dav_svn.h"
 
@@ -1771,7 +1772,9 @@ static int sort_encoding_pref(const void *accept_rec1, const void *accept_rec2)
 
 static int get_svndiff_version(const struct accept_rec *rec)
 {
-  if (strcmp(rec->name, "svndiff2") == 0)
+  if (strcmp(rec->name, "svndiff3") == 0)
+    return 3;
+  else if (strcmp(rec->name, "svndiff2") == 0)
     return 2;
   else if (strcmp(rec->name, "svndiff1") == 0)
     return 1;
@@ -1796,6 +1799,7 @@ negotiate_encoding_prefs(request_rec *r, int *svndiff_version)
   apr_array_header_t *encoding_prefs;
   apr_array_header_t *svndiff_encodings;
   svn_boolean_t accepts_svndiff2 = FALSE;
+  svn_boolean_t accepts_svndiff3 = FALSE;
 
   encoding_prefs = do_header_line(r->pool,
                                   apr_table_get(r->headers_in,
@@ -1814,11 +1818,18 @@ negotiate_encoding_prefs(request_rec *r, int *svndiff_version)
                                                     struct accept_rec);
       int version = get_svndiff_version(rec);
 
+      /* Don't let an svndiff3 preference win the quality sort below if
+       * this server cannot produce it. */
+      if (version == 3 && !svn__zstd_available())
+        continue;
+
       if (version > 0)
         APR_ARRAY_PUSH(svndiff_encodings, struct accept_rec) = *rec;
 
       if (version == 2)
         accepts_svndiff2 = TRUE;
+      else if (version == 3)
+        accepts_svndiff3 = TRUE;
     }
 
   if (dav_svn__get_compression_level(r) == 0)
@@ -1827,6 +1838,14 @@ negotiate_encoding_prefs(request_rec *r, int *svndiff_version)
        * svndiff0 format, which we assume is always supported. */
       *svndiff_version = 0;
     }
+  else if (accepts_svndiff3 && svn__zstd_available())
+    {
+      /* Prefer svndiff3 whenever both sides support it: zstd beats both
+       * zlib and LZ4 on compression ratio at comparable or better speed,
+       * at every server-side compression level.
+       */
+      *svndiff_version = 3;
+    }
   else if (accepts_svndiff2 && dav_svn__get_compression_level(r) == 1)
     {
       /* Enable svndiff2 if the client can read it, and if the server-side
@@ -3943,7 +3962,6 @@ deliver(const dav_resource *resource, ap_filter_t *unused)
   /* resource->info->delta_base is NULL, or we had an invalid base URL */
     {
       svn_stream_t *stream;
-      char *block;
 
       serr = svn_fs_file_contents(&stream,
                                   resource->info->root.root,
@@ -4027,44 +4045,17 @@ deliver(const dav_resource *resource, ap_filter_t *unused)
             }
         }
 
-      /* ### one day in the future, we can create a custom bucket type
-         ### which will read from the FS stream on demand */
-
-      block = apr_palloc(resource->pool, SVN__STREAM_CHUNK_SIZE);
+      /* Deliver the contents as a single bucket which reads from the
+         FS stream on demand.  The filter stack then pulls chunks only
+         as fast as the client consumes them, and an async MPM can
+         complete the write without keeping this worker thread pinned
+         behind a slow connection for the whole transfer. */
       bb = apr_brigade_create(resource->pool,
                               dav_svn__output_get_bucket_alloc(output));
+      bkt = dav_svn__bucket_from_stream(stream, output, resource->pool);
+      APR_BRIGADE_INSERT_TAIL(bb, bkt);
 
-      while (1) {
-        apr_size_t bufsize = SVN__STREAM_CHUNK_SIZE;
-
-        /* read from the FS ... */
-        serr = svn_stream_read_full(stream, block, &bufsize);
-        if (serr != NULL)
-          {
-            apr_brigade_destroy(bb);
-            return dav_svn__convert_err(serr, HTTP_INTERNAL_SERVER_ERROR,
-                                        "could not read the file contents",
-                                        resource->pool);
-          }
-        if (bufsize == 0)
-          break;
-
-        /* write to the filter ... */
-        bkt = apr_bucket_transient_create(
-          block, bufsize, dav_svn__output_get_bucket_alloc(output));
-        APR_BRIGADE_INSERT_TAIL(bb, bkt);
-        serr = dav_svn__output_pass_brigade(output, bb);
-        if (serr != NULL)
-          {
-            apr_brigade_destroy(bb);
-            /* ### that HTTP code... */
-            return dav_svn__convert_err(serr, HTTP_INTERNAL_SERVER_ERROR,
-                                        "Could not write data to filter.",
-                                        resource->pool);
-          }
-      }
-
-      /* done with the file. write an EOS bucket now. */
+      /* ... followed by the EOS bucket, all in one pass. */
       bkt = apr_bucket_eos_create(dav_svn__output_get_bucket_alloc(output));
       APR_BRIGADE_INSERT_TAIL(bb, bkt);
       serr = dav_svn__output_pass_brigade(output, bb);
@@ -4073,7 +4064,7 @@ deliver(const dav_resource *resource, ap_filter_t *unused)
           apr_brigade_destroy(bb);
           /* ### that HTTP code... */
           return dav_svn__convert_err(serr, HTTP_INTERNAL_SERVER_ERROR,
-                                      "Could not write EOS to filter.",
+                                      "Could not write data to filter.",
                                       resource->pool);
         }
 
@@ -4494,6 +4485,7 @@ do_walk(walker_ctx_t *ctx,
   apr_size_t repos_len;
   apr_hash_t *children;
   apr_pool_t *iterpool;
+  apr_pool_t *saved_pool = ctx->res.pool;
 
   /* The current resource is a collection (possibly here thru recursion)
      and this is the invocation for the collection. Alternatively, this is
@@ -4568,8 +4560,16 @@ do_walk(walker_ctx_t *ctx,
                                 "could not fetch collection members",
                                 params->pool);
 
+  /* The per-child callbacks need no allocations that outlive the walk
+     of that child: mod_dav streams PROPFIND responses one resource at a
+     time and dav_add_response() copies what it keeps into WRES->POOL.
+     So have the callbacks allocate from ITERPOOL.  With request-pool
+     lifetime, the property XML built for each child would accumulate
+     until the end of the walk, ballooning the request pool on depth-1
+     PROPFINDs against directories with very many entries. */
+  ctx->res.pool = iterpool = svn_pool_create(scratch_pool);
+
   /* iterate over the children in this collection */
-  iterpool = svn_pool_create(scratch_pool);
   for (hi = apr_hash_first(scratch_pool, children); hi; hi = apr_hash_next(hi))
     {
       const void *key;
@@ -4612,6 +4612,7 @@ do_walk(walker_ctx_t *ctx,
           err = (*params->func)(&ctx->wres, DAV_CALLTYPE_MEMBER);
           if (err != NULL)
             {
+              ctx->res.pool = saved_pool;
               svn_pool_destroy(iterpool);
               return err;
             }
@@ -4629,6 +4630,7 @@ do_walk(walker_ctx_t *ctx,
           err = do_walk(ctx, depth - 1, FALSE, iterpool);
           if (err != NULL)
             {
+              ctx->res.pool = saved_pool;
               svn_pool_destroy(iterpool);
               return err;
             }
@@ -4643,6 +4645,7 @@ do_walk(walker_ctx_t *ctx,
       ctx->repos_path->len = repos_len;
     }
 
+  ctx->res.pool = saved_pool;
   svn_pool_destroy(iterpool);
 
   return NULL;
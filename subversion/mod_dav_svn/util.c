@@ -509,6 +509,111 @@ dav_svn__output_pass_brigade(dav_svn__output *output,
   return SVN_NO_ERROR;
 }
 
+
+/* Baton for the on-demand stream bucket type below. */
+struct stream_bucket_baton
+{
+  /* The stream we deliver, one chunk per bucket read. */
+  svn_stream_t *stream;
+
+  /* The request being answered, used to log read errors.  By the time
+     a read fails, the response status has long been sent, so the log
+     is the only place where the error can still surface. */
+  request_rec *r;
+};
+
+static apr_status_t
+stream_bucket_read(apr_bucket *b, const char **str, apr_size_t *len,
+                   apr_read_type_e block);
+
+/* A bucket which reads from an svn_stream_t only when the filter stack
+   asks for data.  Reading morphs the bucket into a heap bucket holding
+   the chunk just read and appends a fresh stream bucket for the rest,
+   following the same pattern as APR's pipe and socket buckets.
+
+   Setaside is not implemented:  the stream is bound to the request
+   pool, so consumers that want to keep the data longer must read it
+   (ap_save_brigade does exactly that when setaside returns
+   APR_ENOTIMPL). */
+static const apr_bucket_type_t stream_bucket_type = {
+  "SVN-FS-STREAM", 5, APR_BUCKET_DATA,
+  apr_bucket_destroy_noop,
+  stream_bucket_read,
+  apr_bucket_setaside_notimpl,
+  apr_bucket_split_notimpl,
+  apr_bucket_copy_notimpl
+};
+
+/* Create a stream bucket for SBB, allocated from LIST. */
+static apr_bucket *
+stream_bucket_create(struct stream_bucket_baton *sbb,
+                     apr_bucket_alloc_t *list)
+{
+  apr_bucket *b = apr_bucket_alloc(sizeof(*b), list);
+
+  APR_BUCKET_INIT(b);
+  b->free = apr_bucket_free;
+  b->list = list;
+  b->type = &stream_bucket_type;
+  b->length = (apr_size_t)-1;
+  b->start = -1;
+  b->data = sbb;
+  return b;
+}
+
+static apr_status_t
+stream_bucket_read(apr_bucket *b, const char **str, apr_size_t *len,
+                   apr_read_type_e block)
+{
+  struct stream_bucket_baton *sbb = b->data;
+  char *buf = apr_bucket_alloc(SVN__STREAM_CHUNK_SIZE, b->list);
+  apr_size_t bufsize = SVN__STREAM_CHUNK_SIZE;
+  svn_error_t *err;
+
+  err = svn_stream_read_full(sbb->stream, buf, &bufsize);
+  if (err)
+    {
+      apr_status_t status = err->apr_err;
+      char errbuf[128];
+
+      ap_log_rerror(APLOG_MARK, APLOG_ERR, status, sbb->r,
+                    "Error reading stream for response delivery: %s",
+                    svn_err_best_message(err, errbuf, sizeof(errbuf)));
+      svn_error_clear(err);
+      apr_bucket_free(buf);
+      return status ? status : APR_EGENERAL;
+    }
+
+  if (bufsize == 0)
+    {
+      /* The stream is exhausted.  Morph into an empty bucket;  the
+         consumer sees end-of-data through the zero-length read. */
+      apr_bucket_free(buf);
+      apr_bucket_immortal_make(b, "", 0);
+      return apr_bucket_read(b, str, len, block);
+    }
+
+  /* Morph into a heap bucket owning the chunk just read and chain a
+     new stream bucket after it for whatever the stream still holds. */
+  apr_bucket_heap_make(b, buf, bufsize, apr_bucket_free);
+  APR_BUCKET_INSERT_AFTER(b, stream_bucket_create(sbb, b->list));
+  *str = buf;
+  *len = bufsize;
+  return APR_SUCCESS;
+}
+
+apr_bucket *
+dav_svn__bucket_from_stream(svn_stream_t *stream,
+                            dav_svn__output *output,
+                            apr_pool_t *pool)
+{
+  struct stream_bucket_baton *sbb = apr_pcalloc(pool, sizeof(*sbb));
+
+  sbb->stream = stream;
+  sbb->r = output->r;
+  return stream_bucket_create(sbb, dav_svn__output_get_bucket_alloc(output));
+}
+
 
 /*** Brigade I/O wrappers ***/
 
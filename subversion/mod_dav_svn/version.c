@@ -197,6 +197,7 @@ get_option(const dav_resource *resource,
     { SVN_DAV_NS_DAV_SVN_EPHEMERAL_TXNPROPS,  { 1,  8, 0, ""} },
     { SVN_DAV_NS_DAV_SVN_SVNDIFF1,            { 1, 10, 0, ""} },
     { SVN_DAV_NS_DAV_SVN_SVNDIFF2,            { 1, 10, 0, ""} },
+    { SVN_DAV_NS_DAV_SVN_SVNDIFF3,            { 1, 15, 0, ""} },
     { SVN_DAV_NS_DAV_SVN_PUT_RESULT_CHECKSUM, { 1, 10, 0, ""} },
   };
 
@@ -357,6 +358,12 @@ get_option(const dav_resource *resource,
   /* Report commit capabilities. */
   for (i = 0; i < sizeof(capabilities)/sizeof(capabilities[0]); ++i)
     {
+      /* Don't advertise svndiff3 unless this build can decode it. */
+      if (strcmp(capabilities[i].capability_name,
+                 SVN_DAV_NS_DAV_SVN_SVNDIFF3) == 0
+          && !svn__zstd_available())
+        continue;
+
       /* If a master version is declared filter out unsupported
          capabilities. */
       if (master_version
@@ -68,8 +68,10 @@ typedef struct svn_cl__log_receiver_baton
   /* Stack which keeps track of merge revision nesting, using svn_revnum_t's */
   apr_array_header_t *merge_stack;
 
-  /* Log message search patterns. Log entries will only be shown if the author,
-   * the log message, or a changed path matches one of these patterns. */
+  /* Log message search patterns, already wrapped for substring matching
+   * (see prepare_search_patterns() in log-cmd.c). Log entries will only be
+   * shown if the author, the log message, or a changed path matches one of
+   * these patterns. */
   apr_array_header_t *search_patterns;
 
   /* Buffer for Unicode normalization and case folding. */
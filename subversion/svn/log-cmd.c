@@ -112,72 +112,59 @@ display_diff(const svn_log_entry_t *log_entry,
   return SVN_NO_ERROR;
 }
 
-/* Return TRUE if STR matches PATTERN. Else, return FALSE. Assumes that
- * PATTERN is a UTF-8 string prepared for case- and accent-insensitive
- * comparison via svn_utf__xfrm(). */
-static svn_boolean_t
-match(const char *pattern, const char *str, svn_membuf_t *buf)
+/* Prepare STR for case- and accent-insensitive comparison via
+ * svn_utf__xfrm() and return a copy of the result allocated in POOL.
+ * Return NULL if STR cannot be transformed (invalid data never matches).
+ * BUF is used for temporary storage. */
+static const char *
+xfrm_dup(const char *str, svn_membuf_t *buf, apr_pool_t *pool)
 {
   svn_error_t *err;
 
   err = svn_utf__xfrm(&str, str, strlen(str), TRUE, TRUE, buf);
   if (err)
     {
-      /* Can't match invalid data. */
       svn_error_clear(err);
-      return FALSE;
+      return NULL;
     }
 
-  return apr_fnmatch(pattern, str, 0) == APR_SUCCESS;
+  return apr_pstrdup(pool, str);
 }
 
-/* Return TRUE if SEARCH_PATTERN matches the AUTHOR, DATE, LOG_MESSAGE,
- * or a path in the set of keys of the CHANGED_PATHS hash. Else, return FALSE.
- * Any of AUTHOR, DATE, LOG_MESSAGE, and CHANGED_PATHS may be NULL. */
+/* Return TRUE if PATTERN matches the AUTHOR, DATE, LOG_MESSAGE, or an
+ * entry of PATHS. Else, return FALSE. All arguments must already have
+ * been prepared for comparison: PATTERN by prepare_search_patterns()
+ * and the others via svn_utf__xfrm(). Any of AUTHOR, DATE, LOG_MESSAGE,
+ * and PATHS may be NULL. */
 static svn_boolean_t
-match_search_pattern(const char *search_pattern,
+match_search_pattern(const char *pattern,
                      const char *author,
                      const char *date,
                      const char *log_message,
-                     apr_hash_t *changed_paths,
-                     svn_membuf_t *buf,
-                     apr_pool_t *pool)
+                     const apr_array_header_t *paths)
 {
-  /* Match any substring containing the pattern, like UNIX 'grep' does. */
-  const char *pattern = apr_psprintf(pool, "*%s*", search_pattern);
-
   /* Does the author match the search pattern? */
-  if (author && match(pattern, author, buf))
+  if (author && apr_fnmatch(pattern, author, 0) == APR_SUCCESS)
     return TRUE;
 
   /* Does the date the search pattern? */
-  if (date && match(pattern, date, buf))
+  if (date && apr_fnmatch(pattern, date, 0) == APR_SUCCESS)
     return TRUE;
 
   /* Does the log message the search pattern? */
-  if (log_message && match(pattern, log_message, buf))
+  if (log_message && apr_fnmatch(pattern, log_message, 0) == APR_SUCCESS)
     return TRUE;
 
-  if (changed_paths)
+  if (paths)
     {
-      apr_hash_index_t *hi;
+      int i;
 
       /* Does a changed path match the search pattern? */
-      for (hi = apr_hash_first(pool, changed_paths);
-           hi;
-           hi = apr_hash_next(hi))
+      for (i = 0; i < paths->nelts; i++)
         {
-          const char *path = apr_hash_this_key(hi);
-          svn_log_changed_path2_t *log_item;
+          const char *path = APR_ARRAY_IDX(paths, i, const char *);
 
-          if (match(pattern, path, buf))
-            return TRUE;
-
-          /* Match copy-from paths, too. */
-          log_item = apr_hash_this_val(hi);
-          if (log_item->copyfrom_path
-              && SVN_IS_VALID_REVNUM(log_item->copyfrom_rev)
-              && match(pattern, log_item->copyfrom_path, buf))
+          if (apr_fnmatch(pattern, path, 0) == APR_SUCCESS)
             return TRUE;
         }
     }
@@ -199,7 +186,44 @@ match_search_patterns(apr_array_header_t *search_patterns,
 {
   int i;
   svn_boolean_t match = FALSE;
-  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  apr_array_header_t *paths = NULL;
+
+  /* Transform the log entry's data once; matching it against each
+   * pattern in each group is then a plain glob match. */
+  if (author)
+    author = xfrm_dup(author, buf, scratch_pool);
+  if (date)
+    date = xfrm_dup(date, buf, scratch_pool);
+  if (message)
+    message = xfrm_dup(message, buf, scratch_pool);
+
+  if (changed_paths)
+    {
+      apr_hash_index_t *hi;
+
+      paths = apr_array_make(scratch_pool, apr_hash_count(changed_paths),
+                             sizeof(const char *));
+      for (hi = apr_hash_first(scratch_pool, changed_paths);
+           hi;
+           hi = apr_hash_next(hi))
+        {
+          const char *path = apr_hash_this_key(hi);
+          svn_log_changed_path2_t *log_item = apr_hash_this_val(hi);
+
+          path = xfrm_dup(path, buf, scratch_pool);
+          if (path)
+            APR_ARRAY_PUSH(paths, const char *) = path;
+
+          /* Match copy-from paths, too. */
+          if (log_item->copyfrom_path
+              && SVN_IS_VALID_REVNUM(log_item->copyfrom_rev))
+            {
+              path = xfrm_dup(log_item->copyfrom_path, buf, scratch_pool);
+              if (path)
+                APR_ARRAY_PUSH(paths, const char *) = path;
+            }
+        }
+    }
 
   for (i = 0; i < search_patterns->nelts; i++)
     {
@@ -213,11 +237,8 @@ match_search_patterns(apr_array_header_t *search_patterns,
         {
           const char *pattern;
 
-          svn_pool_clear(iterpool);
-
           pattern = APR_ARRAY_IDX(pattern_group, j, const char *);
-          match = match_search_pattern(pattern, author, date, message,
-                                       changed_paths, buf, iterpool);
+          match = match_search_pattern(pattern, author, date, message, paths);
           if (!match)
             break;
         }
@@ -226,11 +247,51 @@ match_search_patterns(apr_array_header_t *search_patterns,
       if (match)
         break;
     }
-  svn_pool_destroy(iterpool);
 
   return match;
 }
 
+/* Return a copy of the --search/--search-and pattern groups in
+ * SEARCH_PATTERNS with every pattern wrapped in '*'s, so that it matches
+ * any substring, like UNIX 'grep' does. Wrapping the patterns up front
+ * saves the receiver from reassembling the very same strings for every
+ * log entry. Allocate the result in RESULT_POOL; return NULL if
+ * SEARCH_PATTERNS is NULL. */
+static apr_array_header_t *
+prepare_search_patterns(const apr_array_header_t *search_patterns,
+                        apr_pool_t *result_pool)
+{
+  apr_array_header_t *prepared;
+  int i;
+
+  if (search_patterns == NULL)
+    return NULL;
+
+  prepared = apr_array_make(result_pool, search_patterns->nelts,
+                            sizeof(apr_array_header_t *));
+  for (i = 0; i < search_patterns->nelts; i++)
+    {
+      apr_array_header_t *pattern_group;
+      apr_array_header_t *prepared_group;
+      int j;
+
+      pattern_group = APR_ARRAY_IDX(search_patterns, i, apr_array_header_t *);
+      prepared_group = apr_array_make(result_pool, pattern_group->nelts,
+                                      sizeof(const char *));
+      for (j = 0; j < pattern_group->nelts; j++)
+        {
+          const char *pattern = APR_ARRAY_IDX(pattern_group, j, const char *);
+
+          APR_ARRAY_PUSH(prepared_group, const char *)
+            = apr_psprintf(result_pool, "*%s*", pattern);
+        }
+
+      APR_ARRAY_PUSH(prepared, apr_array_header_t *) = prepared_group;
+    }
+
+  return prepared;
+}
+
 /* Implement `svn_log_entry_receiver_t', printing the logs in
  * a human-readable and machine-parseable format.
  *
@@ -810,7 +871,8 @@ svn_cl__log(apr_getopt_t *os,
                                                    : opt_state->depth;
   lb.diff_extensions = opt_state->extensions;
   lb.merge_stack = NULL;
-  lb.search_patterns = opt_state->search_patterns;
+  lb.search_patterns = prepare_search_patterns(opt_state->search_patterns,
+                                               pool);
   svn_membuf__create(&lb.buffer, 0, pool);
   lb.pool = pool;
 
@@ -23,6 +23,8 @@
 
 
 #include <apr_file_io.h>
+#include <apr_thread_proc.h>
+#include <apr_thread_mutex.h>
 
 #include "svn_hash.h"
 #include "svn_pools.h"
@@ -45,6 +47,7 @@
 #include "svn_fs.h"
 
 #include "private/svn_cmdline_private.h"
+#include "private/svn_io_private.h"
 #include "private/svn_opt_private.h"
 #include "private/svn_sorts_private.h"
 #include "private/svn_subr_private.h"
@@ -97,6 +100,8 @@ check_lib_versions(void)
 /** Subcommands. **/
 
 static svn_opt_subcommand_t
+  subcommand_build_lockindex,
+  subcommand_build_pathsindex,
   subcommand_build_repcache,
   subcommand_crashtest,
   subcommand_create,
@@ -159,7 +164,8 @@ enum svnadmin__cmdline_options_t
     svnadmin__normalize_props,
     svnadmin__exclude,
     svnadmin__include,
-    svnadmin__glob
+    svnadmin__glob,
+    svnadmin__parallel
   };
 
 /* Option codes and descriptions.
@@ -282,6 +288,10 @@ static const apr_getopt_option_t options_table[] =
      N_("disable flushing to disk during the operation\n"
         "                             (faster, but unsafe on power off)")},
 
+    {"parallel", svnadmin__parallel, 1,
+     N_("pack up to ARG shards concurrently\n"
+        "                             [used for FSFS repositories only]")},
+
     {"normalize-props", svnadmin__normalize_props, 0,
      N_("normalize property values found in the dumpstream\n"
         "                             (currently, only translates non-LF line endings)")},
@@ -307,6 +317,28 @@ static const apr_getopt_option_t options_table[] =
  */
 static const svn_opt_subcommand_desc3_t cmd_table[] =
 {
+  {"build-lockindex", subcommand_build_lockindex, {0}, {N_(
+    "usage: svnadmin build-lockindex REPOS_PATH\n"
+    "\n"), N_(
+    "Build or rebuild the lock path index for the repository at\n"
+    "REPOS_PATH.  Once created, the index is kept up to date\n"
+    "automatically by every lock and unlock operation and is used to\n"
+    "speed up recursive lock queries on repositories with many locks.\n"
+    "All processes accessing the repository must support the index\n"
+    "once it exists.\n"
+   )},
+   {'M'} },
+
+  {"build-pathsindex", subcommand_build_pathsindex, {0}, {N_(
+    "usage: svnadmin build-pathsindex REPOS_PATH\n"
+    "\n"), N_(
+    "Build or update the changed-paths index for the repository at\n"
+    "REPOS_PATH.  Once created, the index is kept up to date\n"
+    "automatically after each commit and is used to speed up\n"
+    "path-filtered history queries.\n"
+   )},
+   {'q', 'M'} },
+
   {"build-repcache", subcommand_build_repcache, {0}, {N_(
     "usage: svnadmin build-repcache REPOS_PATH [-r LOWER[:UPPER]]\n"
     "\n"), N_(
@@ -384,8 +416,12 @@ static const svn_opt_subcommand_desc3_t cmd_table[] =
     "excluded, the copy is transformed into an add (unlike in 'svndumpfilter').\n"
    )},
   {'r', svnadmin__incremental, svnadmin__deltas, 'q', 'M', 'F',
-   svnadmin__exclude, svnadmin__include, svnadmin__glob },
-  {{'F', N_("write to file ARG instead of stdout")}} },
+   svnadmin__exclude, svnadmin__include, svnadmin__glob,
+   svnadmin__parallel },
+  {{'F', N_("write to file ARG instead of stdout")},
+   {svnadmin__parallel, N_("for values of ARG greater than 1, generate the\n"
+                       "                             "
+                       "dump and write the output on separate threads")}} },
 
   {"dump-revprops", subcommand_dump_revprops, {0}, {N_(
     "usage: svnadmin dump-revprops REPOS_PATH [-r LOWER[:UPPER]]\n"
@@ -521,7 +557,7 @@ static const svn_opt_subcommand_desc3_t cmd_table[] =
     "Possibly compact the repository into a more efficient storage model.\n"
     "This may not apply to all repositories, in which case, exit.\n"
    )},
-   {'q', 'M'} },
+   {'q', 'M', svnadmin__parallel} },
 
   {"recover", subcommand_recover, {0}, {N_(
     "usage: svnadmin recover REPOS_PATH\n"
@@ -634,7 +670,13 @@ static const svn_opt_subcommand_desc3_t cmd_table[] =
     "Verify the data stored in the repository.\n"
    )},
    {'t', 'r', 'q', svnadmin__keep_going, 'M',
-    svnadmin__check_normalization, svnadmin__metadata_only} },
+    svnadmin__check_normalization, svnadmin__metadata_only,
+    svnadmin__parallel},
+   {{svnadmin__parallel, N_("verify up to ARG disjoint revision ranges\n"
+                       "                             "
+                       "concurrently (revisions will complete out of\n"
+                       "                             "
+                       "order)")}} },
 
   { NULL, NULL, {0}, {NULL}, {0} }
 };
@@ -672,6 +714,7 @@ struct svnadmin_opt_state
   enum svn_repos_load_uuid uuid_action;             /* --ignore-uuid,
                                                        --force-uuid */
   apr_uint64_t memory_cache_size;                   /* --memory-cache-size M */
+  apr_uint64_t parallel;                            /* --parallel N */
   const char *parent_dir;                           /* --parent-dir */
   const char *file;                                 /* --file */
   apr_array_header_t *exclude;                      /* --exclude */
@@ -706,6 +749,10 @@ open_repos(svn_repos_t **repos,
                            use_block_read ? "1" : "0");
   svn_hash_sets(fs_config, SVN_FS_CONFIG_NO_FLUSH_TO_DISK,
                            opt_state->no_flush_to_disk ? "1" : "0");
+  if (opt_state->parallel > 1)
+    svn_hash_sets(fs_config, SVN_FS_CONFIG_FSFS_PACK_THREADS,
+                             apr_psprintf(pool, "%" APR_UINT64_T_FMT,
+                                          opt_state->parallel));
 
   /* now, open the requested repository */
   SVN_ERR(svn_repos_open3(repos, path, fs_config, pool, pool));
@@ -1456,6 +1503,14 @@ subcommand_dump(apr_getopt_t *os, void *baton, apr_pool_t *pool)
   else
     SVN_ERR(svn_stream_for_stdout(&out_stream, pool));
 
+  /* With --parallel, decouple revision serialization from writing the
+   * output: hand the dump text to a separate writer thread through a
+   * bounded ring of buffers. */
+  if (opt_state->parallel > 1)
+    SVN_ERR(svn_stream__async_buffered(&out_stream, out_stream,
+                                       0x100000 /* 1 MB buffers */, 16,
+                                       pool));
+
   /* Progress feedback goes to STDERR, unless they asked to suppress it. */
   if (! opt_state->quiet)
     feedback_stream = recode_stream_create(stderr, pool);
@@ -1489,6 +1544,10 @@ subcommand_dump(apr_getopt_t *os, void *baton, apr_pool_t *pool)
                              &filter_baton,
                              check_cancel, NULL, pool));
 
+  /* Flush pending buffers and pick up any deferred writer error. */
+  if (opt_state->parallel > 1)
+    SVN_ERR(svn_stream_close(out_stream));
+
   return SVN_NO_ERROR;
 }
 
@@ -2215,6 +2274,234 @@ subcommand_pack(apr_getopt_t *os, void *baton, apr_pool_t *pool)
 }
 
 
+#if APR_HAS_THREADS
+
+/* State shared between all parallel verification workers spawned by
+   verify_parallel(). */
+struct verify_worker_shared
+{
+  /* Options to open the per-worker repository handles with. */
+  struct svnadmin_opt_state *opt_state;
+
+  /* Serializes progress output, error reporting and access to
+     VERIFY_BATON and TERMINATED. */
+  apr_thread_mutex_t *mutex;
+
+  /* The shared --keep-going error summary. */
+  struct repos_verify_callback_baton *verify_baton;
+
+  /* Stream for progress output, or NULL in --quiet mode. */
+  svn_stream_t *feedback_stream;
+
+  /* Set when a worker failed or the user cancelled the operation;
+     tells the remaining workers to wind down early. */
+  svn_boolean_t terminated;
+};
+
+/* Per-worker state. */
+struct verify_worker
+{
+  struct verify_worker_shared *shared;
+
+  /* Inclusive revision range that this worker verifies. */
+  svn_revnum_t start_rev;
+  svn_revnum_t end_rev;
+
+  /* Error encountered by this worker, or SVN_NO_ERROR. */
+  svn_error_t *err;
+};
+
+/* Implements svn_repos_notify_func_t.  BATON is a
+   'struct verify_worker_shared *'.  Forward NOTIFY to
+   repos_notify_handler() under the shared mutex, so that output from
+   concurrent workers does not interleave mid-line. */
+static void
+verify_worker_notify(void *baton,
+                     const svn_repos_notify_t *notify,
+                     apr_pool_t *scratch_pool)
+{
+  struct verify_worker_shared *shared = baton;
+
+  apr_thread_mutex_lock(shared->mutex);
+  repos_notify_handler(shared->feedback_stream, notify, scratch_pool);
+  apr_thread_mutex_unlock(shared->mutex);
+}
+
+/* Implements svn_repos_verify_callback_t.  BATON is a
+   'struct verify_worker_shared *'.  Forward to repos_verify_callback()
+   under the shared mutex, which also protects the error summary and
+   its result pool. */
+static svn_error_t *
+verify_worker_callback(void *baton,
+                       svn_revnum_t revision,
+                       svn_error_t *verify_err,
+                       apr_pool_t *scratch_pool)
+{
+  struct verify_worker_shared *shared = baton;
+  svn_error_t *err;
+
+  apr_thread_mutex_lock(shared->mutex);
+  err = repos_verify_callback(shared->verify_baton, revision, verify_err,
+                              scratch_pool);
+  apr_thread_mutex_unlock(shared->mutex);
+
+  return err;
+}
+
+/* Implements svn_cancel_func_t.  BATON is a
+   'struct verify_worker_shared *'.  Cancel this worker if the user
+   interrupted the process or another worker already failed. */
+static svn_error_t *
+verify_worker_cancel(void *baton)
+{
+  struct verify_worker_shared *shared = baton;
+  svn_boolean_t terminated;
+
+  apr_thread_mutex_lock(shared->mutex);
+  terminated = shared->terminated;
+  apr_thread_mutex_unlock(shared->mutex);
+
+  if (terminated)
+    return svn_error_create(SVN_ERR_CANCELLED, NULL, NULL);
+
+  return check_cancel(NULL);
+}
+
+/* Implements apr_thread_start_t.  BATON is a 'struct verify_worker *'.
+   Verify the worker's revision range through its own repository handle.
+   Errors are reported through BATON->ERR; the thread itself always
+   "succeeds". */
+static void * APR_THREAD_FUNC
+verify_worker_func(apr_thread_t *thread,
+                   void *baton)
+{
+  struct verify_worker *worker = baton;
+  struct verify_worker_shared *shared = worker->shared;
+
+  /* Thread-private root pool; the pool handed to verify_parallel() must
+     not see unsynchronized allocations from multiple threads. */
+  apr_pool_t *pool = svn_pool_create(NULL);
+  svn_repos_t *repos;
+  svn_error_t *err;
+
+  /* Each worker uses its own repository handle and, with it, its own
+     rev file handles and cache namespace. */
+  err = open_repos(&repos, shared->opt_state->repository_path,
+                   shared->opt_state, pool);
+  if (!err)
+    err = svn_repos_verify_fs3(repos, worker->start_rev, worker->end_rev,
+                               shared->opt_state->check_normalization,
+                               shared->opt_state->metadata_only,
+                               shared->feedback_stream
+                                 ? verify_worker_notify : NULL,
+                               shared,
+                               verify_worker_callback, shared,
+                               verify_worker_cancel, shared, pool);
+
+  if (err)
+    {
+      apr_thread_mutex_lock(shared->mutex);
+      shared->terminated = TRUE;
+      apr_thread_mutex_unlock(shared->mutex);
+      worker->err = err;
+    }
+
+  svn_pool_destroy(pool);
+  return NULL;
+}
+
+/* Verify revisions LOWER through UPPER of the repository described by
+   OPT_STATE, using up to OPT_STATE->PARALLEL worker threads on disjoint
+   contiguous revision ranges.  FEEDBACK_STREAM and VERIFY_BATON are used
+   as in the single-threaded code; output and error summary collection
+   are serialized between the workers. */
+static svn_error_t *
+verify_parallel(struct svnadmin_opt_state *opt_state,
+                svn_revnum_t lower,
+                svn_revnum_t upper,
+                svn_stream_t *feedback_stream,
+                struct repos_verify_callback_baton *verify_baton,
+                apr_pool_t *pool)
+{
+  struct verify_worker_shared shared = { 0 };
+  struct verify_worker *workers;
+  apr_array_header_t *threads;
+  apr_uint64_t worker_count = opt_state->parallel;
+  svn_revnum_t range_size = upper - lower + 1;
+  svn_error_t *err = SVN_NO_ERROR;
+  apr_status_t status;
+  int i;
+
+  /* No point in spawning more workers than there are revisions. */
+  if (worker_count > (apr_uint64_t)range_size)
+    worker_count = (apr_uint64_t)range_size;
+
+  status = apr_thread_mutex_create(&shared.mutex, APR_THREAD_MUTEX_DEFAULT,
+                                   pool);
+  if (status)
+    return svn_error_wrap_apr(status,
+                              _("Can't create parallel verify mutex"));
+
+  shared.opt_state = opt_state;
+  shared.verify_baton = verify_baton;
+  shared.feedback_stream = feedback_stream;
+
+  workers = apr_pcalloc(pool, worker_count * sizeof(*workers));
+  threads = apr_array_make(pool, (int)worker_count, sizeof(apr_thread_t *));
+
+  for (i = 0; i < (int)worker_count; i++)
+    {
+      apr_thread_t *thread;
+
+      /* Hand out contiguous, disjoint ranges of roughly equal size. */
+      workers[i].shared = &shared;
+      workers[i].start_rev = lower + (svn_revnum_t)(range_size * i
+                                                    / worker_count);
+      workers[i].end_rev = lower + (svn_revnum_t)(range_size * (i + 1)
+                                                  / worker_count) - 1;
+
+      status = apr_thread_create(&thread, NULL, verify_worker_func,
+                                 &workers[i], pool);
+      if (status)
+        {
+          /* Let the already running workers wind down early. */
+          apr_thread_mutex_lock(shared.mutex);
+          shared.terminated = TRUE;
+          apr_thread_mutex_unlock(shared.mutex);
+          err = svn_error_wrap_apr(status,
+                                   _("Can't create parallel verify thread"));
+          break;
+        }
+      APR_ARRAY_PUSH(threads, apr_thread_t *) = thread;
+    }
+
+  for (i = 0; i < threads->nelts; i++)
+    {
+      apr_status_t retval;
+      apr_thread_join(&retval, APR_ARRAY_IDX(threads, i, apr_thread_t *));
+    }
+
+  /* Report the first real error; the cancellations it triggered in the
+     remaining workers are secondary. */
+  for (i = 0; i < (int)worker_count; i++)
+    if (workers[i].err)
+      {
+        if (err == SVN_NO_ERROR
+            || (err->apr_err == SVN_ERR_CANCELLED
+                && workers[i].err->apr_err != SVN_ERR_CANCELLED))
+          {
+            svn_error_clear(err);
+            err = workers[i].err;
+          }
+        else
+          svn_error_clear(workers[i].err);
+      }
+
+  return svn_error_trace(err);
+}
+
+#endif /* APR_HAS_THREADS */
+
 /* This implements `svn_opt_subcommand_t'. */
 static svn_error_t *
 subcommand_verify(apr_getopt_t *os, void *baton, apr_pool_t *pool)
@@ -2276,14 +2563,27 @@ subcommand_verify(apr_getopt_t *os, void *baton, apr_pool_t *pool)
     apr_array_make(pool, 0, sizeof(struct verification_error *));
   verify_baton.result_pool = pool;
 
-  SVN_ERR(svn_repos_verify_fs3(repos, lower, upper,
-                               opt_state->check_normalization,
-                               opt_state->metadata_only,
-                               !opt_state->quiet
-                                 ? repos_notify_handler : NULL,
-                               feedback_stream,
-                               repos_verify_callback, &verify_baton,
-                               check_cancel, NULL, pool));
+#if APR_HAS_THREADS
+  if (opt_state->parallel > 1 && upper > lower)
+    {
+      /* Check the revision range concurrently, on disjoint contiguous
+         chunks.  Each worker opens its own repository handle, so REPOS
+         stays untouched by the worker threads. */
+      SVN_ERR(verify_parallel(opt_state, lower, upper, feedback_stream,
+                              &verify_baton, pool));
+    }
+  else
+#endif
+    {
+      SVN_ERR(svn_repos_verify_fs3(repos, lower, upper,
+                                   opt_state->check_normalization,
+                                   opt_state->metadata_only,
+                                   !opt_state->quiet
+                                     ? repos_notify_handler : NULL,
+                                   feedback_stream,
+                                   repos_verify_callback, &verify_baton,
+                                   check_cancel, NULL, pool));
+    }
 
   /* Show the --keep-going error summary. */
   if (opt_state->keep_going && verify_baton.error_summary->nelts > 0)
@@ -3044,6 +3344,79 @@ subcommand_build_repcache(apr_getopt_t *os, void *baton, apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+/* This implements `svn_opt_subcommand_t'. */
+static svn_error_t *
+subcommand_build_lockindex(apr_getopt_t *os, void *baton, apr_pool_t *pool)
+{
+  struct svnadmin_opt_state *opt_state = baton;
+  svn_repos_t *repos;
+  svn_fs_t *fs;
+  svn_error_t *err;
+
+  /* Expect no more arguments. */
+  SVN_ERR(parse_args(NULL, os, 0, 0, pool));
+
+  SVN_ERR(open_repos(&repos, opt_state->repository_path, opt_state, pool));
+  fs = svn_repos_fs(repos);
+
+  err = svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_BUILD_LOCK_INDEX,
+                     NULL, NULL,
+                     check_cancel, NULL, pool, pool);
+  if (err && err->apr_err == SVN_ERR_FS_UNRECOGNIZED_IOCTL_CODE)
+    {
+      return svn_error_quick_wrapf(err,
+                                   _("Building the lock path index is "
+                                     "not implemented for the filesystem "
+                                     "type found in '%s'"),
+                                   svn_fs_path(fs, pool));
+    }
+
+  return err;
+}
+
+/* This implements `svn_opt_subcommand_t'. */
+static svn_error_t *
+subcommand_build_pathsindex(apr_getopt_t *os, void *baton, apr_pool_t *pool)
+{
+  struct svnadmin_opt_state *opt_state = baton;
+  svn_repos_t *repos;
+  svn_fs_t *fs;
+  svn_fs_fs__ioctl_build_paths_index_input_t input = { 0 };
+  svn_error_t *err;
+
+  /* Expect no more arguments. */
+  SVN_ERR(parse_args(NULL, os, 0, 0, pool));
+
+  SVN_ERR(open_repos(&repos, opt_state->repository_path, opt_state, pool));
+  fs = svn_repos_fs(repos);
+
+  input.end_rev = SVN_INVALID_REVNUM;
+  if (opt_state->quiet)
+    {
+      input.progress_func = NULL;
+      input.progress_baton = NULL;
+    }
+  else
+    {
+      input.progress_func = build_rep_cache_progress_func;
+      input.progress_baton = NULL;
+    }
+
+  err = svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_BUILD_PATHS_INDEX,
+                     &input, NULL,
+                     check_cancel, NULL, pool, pool);
+  if (err && err->apr_err == SVN_ERR_FS_UNRECOGNIZED_IOCTL_CODE)
+    {
+      return svn_error_quick_wrapf(err,
+                                   _("Building the changed-paths index is "
+                                     "not implemented for the filesystem "
+                                     "type found in '%s'"),
+                                   svn_fs_path(fs, pool));
+    }
+
+  return err;
+}
+
 
 /** Main. **/
 
@@ -3154,6 +3527,9 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
         SVN_ERR(svn_utf_cstring_to_utf8(&(opt_state.file), opt_arg, pool));
         dash_F_arg = TRUE;
         break;
+      case svnadmin__parallel:
+        SVN_ERR(svn_cstring_atoui64(&opt_state.parallel, opt_arg));
+        break;
       case svnadmin__version:
         opt_state.version = TRUE;
         break;
@@ -3426,7 +3802,12 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
     svn_cache_config_t settings = *svn_cache_config_get();
 
     settings.cache_size = opt_state.memory_cache_size;
-    settings.single_threaded = TRUE;
+
+    /* Subcommands running with --parallel N access the global membuffer
+       cache from multiple threads, so it must keep its segment locks.
+       Everything else in svnadmin is single-threaded and may skip the
+       locking overhead. */
+    settings.single_threaded = (opt_state.parallel <= 1);
 
     svn_cache_config_set(&settings);
   }
@@ -0,0 +1,413 @@
+/*
+ * bench-cmd.c -- Run a concurrent request-latency benchmark
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <apr_thread_proc.h>
+
+#include "svn_cmdline.h"
+#include "svn_client.h"
+#include "svn_dirent_uri.h"
+#include "svn_path.h"
+#include "svn_pools.h"
+#include "svn_ra.h"
+
+#include "cl.h"
+
+#include "svn_private_config.h"
+#include "private/svn_cmdline_private.h"
+#include "private/svn_string_private.h"
+
+
+/*** Code. ***/
+
+/* Number of log2 latency buckets we keep for the verbose histogram.
+ * 2^40 usec is about 12 days, so this won't overflow in practice. */
+#define BENCH_HISTOGRAM_BUCKETS 40
+
+/* Everything a single benchmark session needs.  Each worker gets its own
+ * client context, RA session and root pool, so the sessions share nothing
+ * and never synchronize while requests are being timed. */
+typedef struct bench_session_baton_t
+{
+  /* The URL all sessions send their requests to. */
+  const char *url;
+
+  /* Shared option state; only read after the workers have started. */
+  svn_cl__opt_state_t *opt_state;
+
+  /* Number of unmeasured warm-up requests to issue first. */
+  int warmup;
+
+  /* Number of measured requests to issue after the warm-up. */
+  int iterations;
+
+  /* Pre-allocated room for ITERATIONS latency samples, in usecs.
+   * COMPLETED of them are valid after the worker has finished. */
+  apr_time_t *latencies;
+  int completed;
+
+  /* Root pool private to this session's worker. */
+  apr_pool_t *pool;
+
+  /* Error status of this session, or SVN_NO_ERROR. */
+  svn_error_t *err;
+} bench_session_baton_t;
+
+/* Issue the warm-up and measured requests for the session described by
+ * BSB, recording latencies in BSB->LATENCIES.  Uses BSB->POOL, which no
+ * other thread touches, for all allocations. */
+static svn_error_t *
+run_session(bench_session_baton_t *bsb)
+{
+  svn_cl__opt_state_t *opt_state = bsb->opt_state;
+  svn_client_ctx_t *ctx;
+  svn_config_t *cfg_config;
+  svn_ra_session_t *session;
+  apr_pool_t *pool = bsb->pool;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  int i;
+
+  /* Each session uses a private client context, so the workers don't
+   * have to serialize on the auth baton or the config hashes.  Prompting
+   * from a worker thread would garble the terminal, so the contexts are
+   * always non-interactive; credentials must be cached or given with
+   * --username / --password. */
+  SVN_ERR(svn_client_create_context2(&ctx, NULL, pool));
+  SVN_ERR(svn_config_get_config(&ctx->config, opt_state->config_dir, pool));
+
+  if (opt_state->config_options)
+    svn_error_clear(
+        svn_cmdline__apply_config_options(ctx->config,
+                                          opt_state->config_options,
+                                          "svnbench: ", "--config-option"));
+
+  cfg_config = apr_hash_get(ctx->config, SVN_CONFIG_CATEGORY_CONFIG,
+                            APR_HASH_KEY_STRING);
+  ctx->cancel_func = svn_cl__check_cancel;
+
+  SVN_ERR(svn_cmdline_create_auth_baton2(&ctx->auth_baton,
+                                         TRUE /* non_interactive */,
+                                         opt_state->auth_username,
+                                         opt_state->auth_password,
+                                         opt_state->config_dir,
+                                         opt_state->no_auth_cache,
+                                         opt_state->trust_server_cert_unknown_ca,
+                                         opt_state->trust_server_cert_cn_mismatch,
+                                         opt_state->trust_server_cert_expired,
+                                         opt_state->trust_server_cert_not_yet_valid,
+                                         opt_state->trust_server_cert_other_failure,
+                                         cfg_config,
+                                         ctx->cancel_func,
+                                         ctx->cancel_baton,
+                                         pool));
+
+  SVN_ERR(svn_client_open_ra_session2(&session, bsb->url, NULL, ctx,
+                                      pool, iterpool));
+
+  /* Warm up the connection, the server-side caches and this process
+   * without polluting the statistics. */
+  for (i = 0; i < bsb->warmup; i++)
+    {
+      svn_revnum_t head;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_ra_get_latest_revnum(session, &head, iterpool));
+    }
+
+  for (i = 0; i < bsb->iterations; i++)
+    {
+      svn_revnum_t head;
+      apr_time_t started;
+
+      svn_pool_clear(iterpool);
+
+      started = apr_time_now();
+      SVN_ERR(svn_ra_get_latest_revnum(session, &head, iterpool));
+      bsb->latencies[bsb->completed] = apr_time_now() - started;
+      bsb->completed++;
+    }
+
+  svn_pool_destroy(iterpool);
+  return SVN_NO_ERROR;
+}
+
+#if APR_HAS_THREADS
+/* Thread entry point; DATA is the session's bench_session_baton_t. */
+static void * APR_THREAD_FUNC
+bench_session_thread(apr_thread_t *thread, void *data)
+{
+  bench_session_baton_t *bsb = data;
+  bsb->err = svn_error_trace(run_session(bsb));
+  return NULL;
+}
+#endif
+
+/* qsort() callback, ordering two apr_time_t latency samples. */
+static int
+compare_latencies(const void *lhs, const void *rhs)
+{
+  const apr_time_t lhs_time = *(const apr_time_t *)lhs;
+  const apr_time_t rhs_time = *(const apr_time_t *)rhs;
+
+  if (lhs_time < rhs_time)
+    return -1;
+  return lhs_time > rhs_time ? 1 : 0;
+}
+
+/* Return the PER_MILLE-th per-mille latency (nearest rank) from the
+ * ascendingly sorted COUNT samples in SORTED.  COUNT must be > 0. */
+static apr_time_t
+percentile(const apr_time_t *sorted,
+           int count,
+           int per_mille)
+{
+  return sorted[(int)(((apr_int64_t)(count - 1) * per_mille) / 1000)];
+}
+
+/* Print the benchmark results for the COUNT ascendingly sorted latency
+ * samples in SORTED, gathered by SESSIONS concurrent sessions over
+ * ELAPSED wall-clock time.  Follow OPT_STATE's output options. */
+static svn_error_t *
+print_results(const apr_time_t *sorted,
+              int count,
+              int sessions,
+              apr_time_t elapsed,
+              svn_cl__opt_state_t *opt_state,
+              apr_pool_t *pool)
+{
+  apr_time_t sum = 0;
+  double requests_per_sec;
+  int i;
+
+  for (i = 0; i < count; i++)
+    sum += sorted[i];
+
+  requests_per_sec = elapsed > 0
+                   ? (double)count * APR_USEC_PER_SEC / elapsed
+                   : 0.0;
+
+  if (opt_state->bench_csv)
+    {
+      /* Machine-readable variant: a CSV header plus one row, all
+       * latencies in microseconds. */
+      SVN_ERR(svn_cmdline_printf(pool,
+                "sessions,requests,elapsed_usec,requests_per_sec,"
+                "min_usec,mean_usec,p50_usec,p90_usec,p99_usec,"
+                "p999_usec,max_usec\n"));
+      SVN_ERR(svn_cmdline_printf(pool,
+                "%d,%d,%" APR_TIME_T_FMT ",%.1f,%" APR_TIME_T_FMT
+                ",%" APR_TIME_T_FMT ",%" APR_TIME_T_FMT
+                ",%" APR_TIME_T_FMT ",%" APR_TIME_T_FMT
+                ",%" APR_TIME_T_FMT ",%" APR_TIME_T_FMT "\n",
+                sessions, count, elapsed, requests_per_sec,
+                sorted[0], sum / count,
+                percentile(sorted, count, 500),
+                percentile(sorted, count, 900),
+                percentile(sorted, count, 990),
+                percentile(sorted, count, 999),
+                sorted[count - 1]));
+
+      return SVN_NO_ERROR;
+    }
+
+  SVN_ERR(svn_cmdline_printf(pool,
+            _("%15s requests in %15s usec from %d sessions (%.1f req/s)\n"),
+            svn__ui64toa_sep(count, ',', pool),
+            svn__ui64toa_sep(elapsed, ',', pool),
+            sessions, requests_per_sec));
+  SVN_ERR(svn_cmdline_printf(pool,
+            _("%15s usec min,  %15s usec mean\n"),
+            svn__ui64toa_sep(sorted[0], ',', pool),
+            svn__ui64toa_sep(sum / count, ',', pool)));
+  SVN_ERR(svn_cmdline_printf(pool,
+            _("%15s usec p50,  %15s usec p90\n"),
+            svn__ui64toa_sep(percentile(sorted, count, 500), ',', pool),
+            svn__ui64toa_sep(percentile(sorted, count, 900), ',', pool)));
+  SVN_ERR(svn_cmdline_printf(pool,
+            _("%15s usec p99,  %15s usec p999\n"),
+            svn__ui64toa_sep(percentile(sorted, count, 990), ',', pool),
+            svn__ui64toa_sep(percentile(sorted, count, 999), ',', pool)));
+  SVN_ERR(svn_cmdline_printf(pool,
+            _("%15s usec max\n"),
+            svn__ui64toa_sep(sorted[count - 1], ',', pool)));
+
+  if (opt_state->verbose)
+    {
+      apr_int64_t buckets[BENCH_HISTOGRAM_BUCKETS] = { 0 };
+      int bucket;
+
+      for (i = 0; i < count; i++)
+        {
+          for (bucket = 0;
+               bucket + 1 < BENCH_HISTOGRAM_BUCKETS
+                 && sorted[i] > ((apr_time_t)1 << bucket);
+               bucket++)
+            ;
+          buckets[bucket]++;
+        }
+
+      SVN_ERR(svn_cmdline_printf(pool, _("\nLatency histogram:\n")));
+      for (bucket = 0; bucket < BENCH_HISTOGRAM_BUCKETS; bucket++)
+        if (buckets[bucket])
+          SVN_ERR(svn_cmdline_printf(pool, _("  <= %15s usec %15s\n"),
+                    svn__ui64toa_sep((apr_time_t)1 << bucket, ',', pool),
+                    svn__ui64toa_sep(buckets[bucket], ',', pool)));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* This implements the `svn_opt_subcommand_t' interface. */
+svn_error_t *
+svn_cl__bench(apr_getopt_t *os,
+              void *baton,
+              apr_pool_t *pool)
+{
+  svn_cl__opt_state_t *opt_state = ((svn_cl__cmd_baton_t *) baton)->opt_state;
+  svn_client_ctx_t *ctx = ((svn_cl__cmd_baton_t *) baton)->ctx;
+  apr_array_header_t *targets;
+  bench_session_baton_t *sessions;
+  apr_time_t *all_latencies;
+  apr_time_t started, elapsed;
+  const char *url;
+  svn_error_t *err = SVN_NO_ERROR;
+  int sample_count;
+  int i;
+
+  SVN_ERR(svn_cl__args_to_target_array_print_reserved(&targets, os,
+                                                      opt_state->targets,
+                                                      ctx, FALSE, pool));
+
+  if (targets->nelts != 1)
+    return svn_error_create(SVN_ERR_CL_ARG_PARSING_ERROR, NULL,
+                            _("'bench' requires exactly one URL"));
+
+  url = APR_ARRAY_IDX(targets, 0, const char *);
+  if (! svn_path_is_url(url))
+    return svn_error_createf(SVN_ERR_CL_ARG_PARSING_ERROR, NULL,
+                             _("'%s' is not a URL"), url);
+
+#if !APR_HAS_THREADS
+  if (opt_state->concurrency > 1)
+    return svn_error_create(SVN_ERR_UNSUPPORTED_FEATURE, NULL,
+                            _("svnbench was compiled without thread "
+                              "support; --concurrency must be 1"));
+#endif
+
+  /* Set up the shared-nothing session batons.  The root pools are
+   * created here, serially, and each one is used by one worker only. */
+  sessions = apr_pcalloc(pool,
+                         opt_state->concurrency * sizeof(*sessions));
+  for (i = 0; i < opt_state->concurrency; i++)
+    {
+      bench_session_baton_t *bsb = &sessions[i];
+
+      bsb->url = url;
+      bsb->opt_state = opt_state;
+      bsb->warmup = opt_state->bench_warmup;
+      bsb->iterations = opt_state->bench_requests;
+      bsb->latencies = apr_palloc(pool,
+                                  bsb->iterations
+                                    * sizeof(*bsb->latencies));
+      bsb->completed = 0;
+      bsb->pool = svn_pool_create(NULL);
+      bsb->err = SVN_NO_ERROR;
+    }
+
+  started = apr_time_now();
+
+#if APR_HAS_THREADS
+  {
+    apr_thread_t **threads;
+    apr_threadattr_t *tattr;
+    apr_status_t status;
+
+    status = apr_threadattr_create(&tattr, pool);
+    if (status)
+      return svn_error_wrap_apr(status, _("Can't create threadattr"));
+
+    threads = apr_palloc(pool,
+                         opt_state->concurrency * sizeof(*threads));
+    for (i = 0; i < opt_state->concurrency; i++)
+      {
+        status = apr_thread_create(&threads[i], tattr,
+                                   bench_session_thread, &sessions[i],
+                                   pool);
+        if (status)
+          {
+            /* Let the already running sessions finish, then bail out. */
+            err = svn_error_wrap_apr(status, _("Can't create thread"));
+            opt_state->concurrency = i;
+            break;
+          }
+      }
+
+    for (i = 0; i < opt_state->concurrency; i++)
+      {
+        apr_status_t thread_status;
+
+        apr_thread_join(&thread_status, threads[i]);
+        err = svn_error_compose_create(err, sessions[i].err);
+      }
+  }
+#else
+  sessions[0].err = svn_error_trace(run_session(&sessions[0]));
+  err = sessions[0].err;
+#endif
+
+  elapsed = apr_time_now() - started;
+
+  if (err)
+    {
+      for (i = 0; i < opt_state->concurrency; i++)
+        svn_pool_destroy(sessions[i].pool);
+      return svn_error_trace(err);
+    }
+
+  /* Merge and sort all samples for the percentile computation. */
+  sample_count = 0;
+  for (i = 0; i < opt_state->concurrency; i++)
+    sample_count += sessions[i].completed;
+
+  all_latencies = apr_palloc(pool, sample_count * sizeof(*all_latencies));
+  sample_count = 0;
+  for (i = 0; i < opt_state->concurrency; i++)
+    {
+      memcpy(all_latencies + sample_count, sessions[i].latencies,
+             sessions[i].completed * sizeof(*all_latencies));
+      sample_count += sessions[i].completed;
+      svn_pool_destroy(sessions[i].pool);
+    }
+
+  qsort(all_latencies, sample_count, sizeof(*all_latencies),
+        compare_latencies);
+
+  if (!opt_state->quiet || opt_state->bench_csv)
+    SVN_ERR(print_results(all_latencies, sample_count,
+                          opt_state->concurrency, elapsed,
+                          opt_state, pool));
+
+  return SVN_NO_ERROR;
+}
@@ -96,6 +96,10 @@ typedef struct svn_cl__opt_state_t
   svn_boolean_t trust_server_cert_not_yet_valid;
   svn_boolean_t trust_server_cert_other_failure;
   apr_array_header_t* search_patterns; /* pattern arguments for --search */
+  int concurrency;               /* number of concurrent 'bench' sessions */
+  int bench_requests;            /* measured requests per 'bench' session */
+  int bench_warmup;              /* warm-up requests per 'bench' session */
+  svn_boolean_t bench_csv;       /* print 'bench' results as CSV */
 } svn_cl__opt_state_t;
 
 
@@ -109,6 +113,7 @@ typedef struct svn_cl__cmd_baton_t
 /* Declare all the command procedures */
 svn_opt_subcommand_t
   svn_cl__help,
+  svn_cl__bench,
   svn_cl__null_blame,
   svn_cl__null_export,
   svn_cl__null_list,
@@ -70,7 +70,11 @@ typedef enum svn_cl__longopt_t {
   opt_trust_server_cert,
   opt_trust_server_cert_failures,
   opt_changelist,
-  opt_search
+  opt_search,
+  opt_concurrency,
+  opt_requests,
+  opt_warmup,
+  opt_csv
 } svn_cl__longopt_t;
 
 
@@ -171,6 +175,18 @@ const apr_getopt_option_t svn_cl__options[] =
                        "history")},
   {"search", opt_search, 1,
                        N_("use ARG as search pattern (glob syntax)")},
+  {"concurrency",   opt_concurrency, 1,
+                    N_("number of concurrent sessions (default: 1)")},
+  {"requests",      opt_requests, 1,
+                    N_("number of measured requests per session\n"
+                       "                             "
+                       "(default: 1000)")},
+  {"warmup",        opt_warmup, 1,
+                    N_("number of unmeasured warm-up requests per session\n"
+                       "                             "
+                       "(default: 10)")},
+  {"csv",           opt_csv, 0,
+                    N_("print machine-readable results in CSV format")},
 
   /* Long-opt Aliases
    *
@@ -215,6 +231,26 @@ const svn_opt_subcommand_desc3_t svn_cl__cmd_table[] =
     {0} },
   /* This command is also invoked if we see option "--help", "-h" or "-?". */
 
+  { "bench", svn_cl__bench, {0}, {N_(
+     "Run a concurrent request-latency benchmark against a repository.\n"
+     "usage: bench URL\n"
+     "\n"), N_(
+     "  Opens --concurrency independent sessions to the repository at URL\n"
+     "  and issues --requests timed requests per session, after --warmup\n"
+     "  unmeasured requests that prime the connections and caches.  Each\n"
+     "  session runs in its own thread with its own client context, so the\n"
+     "  sessions share nothing while requests are being timed.\n"
+     "\n"), N_(
+     "  Prints throughput plus min/mean/p50/p90/p99/p999/max request\n"
+     "  latencies over all sessions.  With --verbose, also prints a\n"
+     "  latency histogram; with --csv, prints the summary in a\n"
+     "  machine-readable CSV format instead.\n"
+     "\n"), N_(
+     "  The sessions authenticate non-interactively; credentials must be\n"
+     "  cached or supplied via --username and --password.\n"
+    )},
+    {'q', 'v', opt_concurrency, opt_requests, opt_warmup, opt_csv} },
+
   { "null-blame", svn_cl__null_blame, {0}, {N_(
      "Fetch all versions of a file in a batch.\n"
      "usage: null-blame [-rM:N] TARGET[@REV]...\n"
@@ -431,6 +467,9 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   opt_state.revision_ranges =
     apr_array_make(pool, 0, sizeof(svn_opt_revision_range_t *));
   opt_state.depth = svn_depth_unknown;
+  opt_state.concurrency = 1;
+  opt_state.bench_requests = 1000;
+  opt_state.bench_warmup = 10;
 
   /* No args?  Show usage. */
   if (argc <= 1)
@@ -636,6 +675,38 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
       case 'g':
         opt_state.use_merge_history = TRUE;
         break;
+      case opt_concurrency:
+        err = svn_cstring_atoi(&opt_state.concurrency, opt_arg);
+        if (err)
+          return svn_error_create(SVN_ERR_CL_ARG_PARSING_ERROR, err,
+                                  _("Non-numeric concurrency argument given"));
+        if (opt_state.concurrency <= 0)
+          return svn_error_create(SVN_ERR_INCORRECT_PARAMS, NULL,
+                                  _("Argument to --concurrency must be "
+                                    "positive"));
+        break;
+      case opt_requests:
+        err = svn_cstring_atoi(&opt_state.bench_requests, opt_arg);
+        if (err)
+          return svn_error_create(SVN_ERR_CL_ARG_PARSING_ERROR, err,
+                                  _("Non-numeric requests argument given"));
+        if (opt_state.bench_requests <= 0)
+          return svn_error_create(SVN_ERR_INCORRECT_PARAMS, NULL,
+                                  _("Argument to --requests must be positive"));
+        break;
+      case opt_warmup:
+        err = svn_cstring_atoi(&opt_state.bench_warmup, opt_arg);
+        if (err)
+          return svn_error_create(SVN_ERR_CL_ARG_PARSING_ERROR, err,
+                                  _("Non-numeric warmup argument given"));
+        if (opt_state.bench_warmup < 0)
+          return svn_error_create(SVN_ERR_INCORRECT_PARAMS, NULL,
+                                  _("Argument to --warmup must not be "
+                                    "negative"));
+        break;
+      case opt_csv:
+        opt_state.bench_csv = TRUE;
+        break;
       case opt_search:
         SVN_ERR(svn_utf_cstring_to_utf8(&utf8_opt_arg, opt_arg, pool));
         SVN_ERR(svn_utf__xfrm(&utf8_opt_arg, utf8_opt_arg,
@@ -0,0 +1,81 @@
+/* rebuild-index-cmd.c -- implements the rebuild-index sub-command.
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include "svn_pools.h"
+
+#include "private/svn_fs_fs_private.h"
+
+#include "svn_private_config.h"
+
+#include "svnfsfs.h"
+
+/* Our progress function simply prints the REVISION number and makes it
+ * appear immediately.
+ */
+static void
+print_progress(svn_revnum_t revision,
+               void *baton,
+               apr_pool_t *pool)
+{
+  printf("%8ld", revision);
+  fflush(stdout);
+}
+
+/* Rebuild the indexes of the repository at PATH for the revision range
+ * given in OPT_STATE.  Allocate from POOL. */
+static svn_error_t *
+rebuild_index(const char *path,
+              svnfsfs__opt_state *opt_state,
+              apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  svn_fs_fs__ioctl_rebuild_index_input_t input = {0};
+
+  /* Check repository type and open it. */
+  SVN_ERR(open_fs(&fs, path, pool));
+
+  input.start_rev = 0;
+  input.end_rev = SVN_INVALID_REVNUM;
+  if (opt_state->start_revision.kind == svn_opt_revision_number)
+    input.start_rev = opt_state->start_revision.value.number;
+  if (opt_state->end_revision.kind == svn_opt_revision_number)
+    input.end_rev = opt_state->end_revision.value.number;
+
+  if (!opt_state->quiet)
+    input.progress_func = print_progress;
+
+  SVN_ERR(svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_REBUILD_INDEX, &input, NULL,
+                       check_cancel, NULL, pool, pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* This implements `svn_opt_subcommand_t'. */
+svn_error_t *
+subcommand__rebuild_index(apr_getopt_t *os, void *baton, apr_pool_t *pool)
+{
+  svnfsfs__opt_state *opt_state = baton;
+
+  SVN_ERR(rebuild_index(opt_state->repository_path, opt_state, pool));
+
+  return SVN_NO_ERROR;
+}
@@ -507,6 +507,8 @@ subcommand__stats(apr_getopt_t *os, void *baton, apr_pool_t *pool)
   printf("Reading revisions\n");
   SVN_ERR(open_fs(&fs, opt_state->repository_path, pool));
 
+  if (opt_state->start_revision.kind == svn_opt_revision_number)
+    input.start_rev = opt_state->start_revision.value.number;
   input.progress_func = print_progress;
   SVN_ERR(svn_fs_ioctl(fs, SVN_FS_FS__IOCTL_GET_STATS, &input, (void **)&output,
                        check_cancel, NULL, pool, pool));
@@ -162,12 +162,32 @@ static const svn_opt_subcommand_desc3_t cmd_table[] =
    )},
    {'M'} },
 
+  {"rebuild-index", subcommand__rebuild_index, {0}, {N_(
+    "usage: svnfsfs rebuild-index REPOS_PATH [-r LOWER[:UPPER]]\n"
+    "\n"), N_(
+    "Read the P2L index of every revision / pack file containing revisions LOWER\n"
+    "through UPPER (defaulting to the whole repository) and rewrite both index\n"
+    "blocks from it, using the index page sizes currently configured in fsfs.conf.\n"
+    "Use this to re-optimize the indexes after a configuration change or format\n"
+    "upgrade.  A LOWER within the packed part of the repository is rounded down\n"
+    "to the pack file boundary.  The revision range must not be accessed by any\n"
+    "other process while this command runs.  Since revision / pack files are\n"
+    "independent of one another, multiple instances of this command may be run\n"
+    "over disjoint revision ranges in parallel.\n"
+   )},
+   {'r', 'q', 'M'} },
+
   {"stats", subcommand__stats, {0}, {N_(
-    "usage: svnfsfs stats REPOS_PATH\n"
+    "usage: svnfsfs stats REPOS_PATH [-r LOWER]\n"
     "\n"), N_(
-    "Write object size statistics to console.\n"
+    "Write object size statistics to console.  If LOWER is given, scan only\n"
+    "revisions LOWER through HEAD, e.g. to incrementally update previously\n"
+    "gathered statistics.  A LOWER within the packed part of the repository\n"
+    "is rounded down to the pack file boundary.  Note that representations\n"
+    "shared with revisions before LOWER are not included in such a partial\n"
+    "scan.\n"
    )},
-   {'M'} },
+   {'r', 'M'} },
 
   { NULL, NULL, {0}, {NULL}, {0} }
 };
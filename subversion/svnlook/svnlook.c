@@ -28,6 +28,7 @@
 #include <apr_pools.h>
 #include <apr_time.h>
 #include <apr_file_io.h>
+#include <apr_thread_proc.h>
 
 #define APR_WANT_STDIO
 #define APR_WANT_STRFUNC
@@ -47,7 +48,6 @@
 #include "svn_time.h"
 #include "svn_utf.h"
 #include "svn_subst.h"
-#include "svn_sorts.h"
 #include "svn_opt.h"
 #include "svn_props.h"
 #include "svn_diff.h"
@@ -56,9 +56,9 @@
 
 #include "private/svn_cmdline_private.h"
 #include "private/svn_diff_private.h"
+#include "private/svn_fs_private.h"
 #include "private/svn_fspath.h"
 #include "private/svn_io_private.h"
-#include "private/svn_sorts_private.h"
 
 #include "svn_private_config.h"
 
@@ -70,6 +70,7 @@
 
 static svn_opt_subcommand_t
   subcommand_author,
+  subcommand_batch,
   subcommand_cat,
   subcommand_changed,
   subcommand_date,
@@ -221,6 +222,19 @@ static const svn_opt_subcommand_desc3_t cmd_table[] =
    )},
    {'r', 't'} },
 
+  {"batch", subcommand_batch, {0}, {N_(
+      "usage: svnlook batch REPOS_PATH\n"
+      "\n"), N_(
+      "Read subcommands from standard input and run them one after the\n"
+      "other against the repository, all within a single process.  Each\n"
+      "input line holds one complete command: the subcommand name followed\n"
+      "by its options and arguments - but not the repository path, which is\n"
+      "taken from the command line above.  Tokens may be quoted.  Empty\n"
+      "lines and lines starting with '#' are ignored.  Processing stops at\n"
+      "the end of input or with the first failing subcommand.\n"
+   )},
+   {0} },
+
   {"cat", subcommand_cat, {0}, {N_(
       "usage: svnlook cat REPOS_PATH FILE_PATH\n"
       "\n"), N_(
@@ -382,6 +396,7 @@ struct svnlook_opt_state
   svn_boolean_t show_inherited_props; /*  --show-inherited-props */
   svn_boolean_t no_newline;       /* --no-newline */
   apr_uint64_t memory_cache_size; /* --memory-cache-size */
+  svn_repos_t *repos;             /* Pre-opened repository ('batch' mode). */
 };
 
 
@@ -407,6 +422,16 @@ typedef struct svnlook_ctxt_t
 
 } svnlook_ctxt_t;
 
+
+/* Parse and run one svnlook command line.  Shared between the program's
+   own command line and the lines read by the 'batch' subcommand; in the
+   latter case BATCH_REPOS_PATH and BATCH_REPOS identify the repository
+   and ARGV contains no repository argument.  Defined below with main(). */
+static svn_error_t *
+run_command(int *exit_code, int argc, const char *argv[],
+            const char *batch_repos_path, svn_repos_t *batch_repos,
+            apr_pool_t *pool);
+
 
 /*** Helper functions. ***/
 
@@ -1202,7 +1227,6 @@ print_tree(svn_fs_root_t *root,
            apr_pool_t *pool)
 {
   apr_pool_t *subpool;
-  apr_hash_t *entries;
   const char* name;
 
   SVN_ERR(check_cancel(NULL));
@@ -1253,15 +1277,12 @@ print_tree(svn_fs_root_t *root,
       apr_array_header_t *sorted_entries;
       int i;
 
-      SVN_ERR(svn_fs_dir_entries(&entries, root, path, pool));
+      SVN_ERR(svn_fs__dir_entries_sorted(&sorted_entries, root, path, pool));
       subpool = svn_pool_create(pool);
-      sorted_entries = svn_sort__hash(entries,
-                                      svn_sort_compare_items_lexically, pool);
       for (i = 0; i < sorted_entries->nelts; i++)
         {
-          svn_sort__item_t item = APR_ARRAY_IDX(sorted_entries, i,
-                                                svn_sort__item_t);
-          svn_fs_dirent_t *entry = item.value;
+          svn_fs_dirent_t *entry = APR_ARRAY_IDX(sorted_entries, i,
+                                                 svn_fs_dirent_t *);
 
           svn_pool_clear(subpool);
           SVN_ERR(print_tree(root,
@@ -2099,8 +2120,13 @@ get_ctxt_baton(svnlook_ctxt_t **baton_p,
 {
   svnlook_ctxt_t *baton = apr_pcalloc(pool, sizeof(*baton));
 
-  SVN_ERR(svn_repos_open3(&(baton->repos), opt_state->repos_path, NULL,
-                          pool, pool));
+  /* In batch mode, reuse the long-lived repository handle so that all
+     commands of the batch work on warmed-up caches. */
+  if (opt_state->repos)
+    baton->repos = opt_state->repos;
+  else
+    SVN_ERR(svn_repos_open3(&(baton->repos), opt_state->repos_path, NULL,
+                            pool, pool));
   baton->fs = svn_repos_fs(baton->repos);
   svn_fs_set_warning_func(baton->fs, warning_func, NULL);
   baton->show_ids = opt_state->show_ids;
@@ -2148,6 +2174,88 @@ subcommand_author(apr_getopt_t *os, void *baton, apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+/* This implements `svn_opt_subcommand_t'. */
+static svn_error_t *
+subcommand_batch(apr_getopt_t *os, void *baton, apr_pool_t *pool)
+{
+  struct svnlook_opt_state *opt_state = baton;
+  svn_repos_t *repos;
+  svn_stream_t *input;
+  apr_pool_t *iterpool;
+  int line_no = 0;
+
+  SVN_ERR(check_number_of_args(opt_state, 0));
+
+  /* Open the repository once; every command of the batch shares the
+     handle and thus the warmed-up caches. */
+  SVN_ERR(svn_repos_open3(&repos, opt_state->repos_path, NULL, pool, pool));
+  svn_fs_set_warning_func(svn_repos_fs(repos), warning_func, NULL);
+
+  SVN_ERR(svn_stream_for_stdin2(&input, FALSE, pool));
+
+  iterpool = svn_pool_create(pool);
+  while (TRUE)
+    {
+      svn_stringbuf_t *line;
+      svn_boolean_t eof;
+      char **tokens;
+      const char **cmd_argv;
+      int cmd_argc;
+      int exit_code = EXIT_SUCCESS;
+      apr_status_t apr_err;
+      svn_error_t *err;
+
+      svn_pool_clear(iterpool);
+
+      if (check_cancel)
+        SVN_ERR(check_cancel(NULL));
+
+      SVN_ERR(svn_stream_readline(input, &line, "\n", &eof, iterpool));
+      if (eof && line->len == 0)
+        break;
+      ++line_no;
+
+      /* Allow empty lines and comments, e.g. from hook script templates. */
+      svn_stringbuf_strip_whitespace(line);
+      if (line->len == 0 || line->data[0] == '#')
+        continue;
+
+      apr_err = apr_tokenize_to_argv(line->data, &tokens, iterpool);
+      if (apr_err)
+        return svn_error_wrap_apr(apr_err,
+                                  _("Error parsing batch command "
+                                    "on line %d"), line_no);
+
+      for (cmd_argc = 0; tokens[cmd_argc]; ++cmd_argc)
+        ;
+      cmd_argv = apr_palloc(iterpool,
+                            (cmd_argc + 2) * sizeof(*cmd_argv));
+      cmd_argv[0] = "svnlook";
+      memcpy(cmd_argv + 1, tokens, (cmd_argc + 1) * sizeof(*cmd_argv));
+
+      err = run_command(&exit_code, cmd_argc + 1, cmd_argv,
+                        opt_state->repos_path, repos, iterpool);
+      if (err)
+        return svn_error_quick_wrapf(err,
+                                     _("Batch command on line %d failed"),
+                                     line_no);
+      if (exit_code != EXIT_SUCCESS)
+        return svn_error_createf(SVN_ERR_CL_ARG_PARSING_ERROR, NULL,
+                                 _("Invalid batch command on line %d"),
+                                 line_no);
+
+      /* Make each command's output visible to the driving script before
+         reading the next command. */
+      SVN_ERR(svn_cmdline_fflush(stdout));
+
+      if (eof)
+        break;
+    }
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
 /* This implements `svn_opt_subcommand_t'. */
 static svn_error_t *
 subcommand_cat(apr_getopt_t *os, void *baton, apr_pool_t *pool)
@@ -2460,13 +2568,16 @@ subcommand_uuid(apr_getopt_t *os, void *baton, apr_pool_t *pool)
 
 /*** Main. ***/
 
-/*
+/* See the forward declaration above.
+ *
  * On success, leave *EXIT_CODE untouched and return SVN_NO_ERROR. On error,
  * either return an error to be displayed, or set *EXIT_CODE to non-zero and
  * return SVN_NO_ERROR.
  */
 static svn_error_t *
-sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
+run_command(int *exit_code, int argc, const char *argv[],
+            const char *batch_repos_path, svn_repos_t *batch_repos,
+            apr_pool_t *pool)
 {
   svn_error_t *err;
   apr_status_t apr_err;
@@ -2480,19 +2591,6 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
 
   received_opts = apr_array_make(pool, SVN_OPT_MAX_OPTIONS, sizeof(int));
 
-  /* Check library versions */
-  SVN_ERR(check_lib_versions());
-
-  /* Initialize the FS library. */
-  SVN_ERR(svn_fs_initialize(pool));
-
-  if (argc <= 1)
-    {
-      SVN_ERR(subcommand_help(NULL, NULL, pool));
-      *exit_code = EXIT_FAILURE;
-      return SVN_NO_ERROR;
-    }
-
   /* Initialize opt_state. */
   memset(&opt_state, 0, sizeof(opt_state));
   opt_state.rev = SVN_INVALID_REVNUM;
@@ -2732,13 +2830,25 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
      after that is the path.  Since we don't know, we just call them
      arg1 and arg2, meaning the first and second arguments following
      the repository. */
+  /* Batches name their repository just once, up front; don't let a
+     batch command recurse into reading our own input. */
+  if (batch_repos_path && subcommand->cmd_func == subcommand_batch)
+    return svn_error_create(SVN_ERR_CL_ARG_PARSING_ERROR, NULL,
+                            _("'batch' cannot be used as a batch command"));
+
   if (subcommand->cmd_func != subcommand_help)
     {
       const char *repos_path = NULL;
       const char *arg1 = NULL, *arg2 = NULL;
 
       /* Get the repository. */
-      if (os->ind < os->argc)
+      if (batch_repos_path)
+        {
+          /* Already in UTF-8 and internal style. */
+          repos_path = batch_repos_path;
+          opt_state.repos = batch_repos;
+        }
+      else if (os->ind < os->argc)
         {
           SVN_ERR(svn_utf_cstring_to_utf8(&repos_path,
                                           os->argv[os->ind++],
@@ -2848,6 +2958,30 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+/*
+ * On success, leave *EXIT_CODE untouched and return SVN_NO_ERROR. On error,
+ * either return an error to be displayed, or set *EXIT_CODE to non-zero and
+ * return SVN_NO_ERROR.
+ */
+static svn_error_t *
+sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
+{
+  /* Check library versions */
+  SVN_ERR(check_lib_versions());
+
+  /* Initialize the FS library. */
+  SVN_ERR(svn_fs_initialize(pool));
+
+  if (argc <= 1)
+    {
+      SVN_ERR(subcommand_help(NULL, NULL, pool));
+      *exit_code = EXIT_FAILURE;
+      return SVN_NO_ERROR;
+    }
+
+  return run_command(exit_code, argc, argv, NULL, NULL, pool);
+}
+
 int
 main(int argc, const char *argv[])
 {
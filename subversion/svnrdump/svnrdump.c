@@ -491,7 +491,9 @@ replay_revisions(svn_ra_session_t *session,
     }
   else
     {
-      SVN_ERR(svn_stream_for_stdout(&output_stream, pool));
+      /* The dump is bulk output: all user feedback goes to stderr, so
+         buffer stdout to avoid one write() per dump record. */
+      SVN_ERR(svn_stream_for_stdout2(&output_stream, TRUE, pool));
     }
 
   replay_baton = apr_pcalloc(pool, sizeof(*replay_baton));
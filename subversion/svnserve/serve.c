@@ -54,7 +54,10 @@
 #include "private/svn_log.h"
 #include "private/svn_mergeinfo_private.h"
 #include "private/svn_ra_svn_private.h"
+#include "private/svn_repos_private.h"
 #include "private/svn_fspath.h"
+#include "private/svn_subr_private.h"
+#include "private/svn_cache.h"
 
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>   /* For getpid() */
@@ -211,6 +214,43 @@ log_authz_denied(const char *path,
   return logger__write(b->logger, line, strlen(line));
 }
 
+/* Write a machine-readable record of the process-wide membuffer cache
+   statistics to the log file.  Called when a client connection ends (see
+   the --log-cache-stats option), so that administrators can correlate
+   cache effectiveness with actual traffic and size the cache from
+   production data.  B may be NULL if the connection failed before a
+   server baton was constructed. */
+static svn_error_t *
+log_cache_stats(server_baton_t *b, apr_pool_t *pool)
+{
+  const char *timestr, *line;
+  svn_cache__info_t *info;
+
+  if (b == NULL || b->logger == NULL)
+    return SVN_NO_ERROR;
+
+  info = svn_cache__membuffer_get_global_info(pool);
+  timestr = svn_time_to_cstring(apr_time_now(), pool);
+
+  line = apr_psprintf(pool, "%" APR_PID_T_FMT
+                      " %s - - %s cache-stats"
+                      " gets=%" APR_UINT64_T_FMT
+                      " hits=%" APR_UINT64_T_FMT
+                      " sets=%" APR_UINT64_T_FMT
+                      " failures=%" APR_UINT64_T_FMT
+                      " used-size=%" APR_UINT64_T_FMT
+                      " data-size=%" APR_UINT64_T_FMT
+                      " total-size=%" APR_UINT64_T_FMT
+                      " used-entries=%" APR_UINT64_T_FMT
+                      " total-entries=%" APR_UINT64_T_FMT APR_EOL_STR,
+                      getpid(), timestr, b->repository->repos_name,
+                      info->gets, info->hits, info->sets, info->failures,
+                      info->used_size, info->data_size, info->total_size,
+                      info->used_entries, info->total_entries);
+
+  return logger__write(b->logger, line, strlen(line));
+}
+
 /* If CFG specifies a path to the password DB, read that DB through
  * CONFIG_POOL and store it in REPOSITORY->PWDB.
  */
@@ -433,6 +473,27 @@ static void convert_case(char *text, svn_boolean_t to_uppercase)
     }
 }
 
+/* Return the username from B as it is to be used for authz purposes,
+   i.e. with any requested case normalization applied, or NULL for the
+   anonymous user.  Determine and cache it on the first use. */
+static const char *get_authz_user(server_baton_t *b)
+{
+  client_info_t *client_info = b->client_info;
+
+  if (client_info->user && (! client_info->authz_user))
+    {
+      char *authz_user = apr_pstrdup(b->pool, client_info->user);
+      if (b->repository->username_case == CASE_FORCE_UPPER)
+        convert_case(authz_user, TRUE);
+      else if (b->repository->username_case == CASE_FORCE_LOWER)
+        convert_case(authz_user, FALSE);
+
+      client_info->authz_user = authz_user;
+    }
+
+  return client_info->authz_user;
+}
+
 /* Set *ALLOWED to TRUE if PATH is accessible in the REQUIRED mode to
    the user described in BATON according to the authz rules in BATON.
    Use POOL for temporary allocations only.  If no authz rules are
@@ -444,7 +505,6 @@ static svn_error_t *authz_check_access(svn_boolean_t *allowed,
                                        apr_pool_t *pool)
 {
   repository_t *repository = b->repository;
-  client_info_t *client_info = b->client_info;
 
   /* If authz cannot be performed, grant access.  This is NOT the same
      as the default policy when authz is performed on a path with no
@@ -465,23 +525,9 @@ static svn_error_t *authz_check_access(svn_boolean_t *allowed,
   if (path && *path != '/')
     path = svn_fspath__canonicalize(path, pool);
 
-  /* If we have a username, and we've not yet used it + any username
-     case normalization that might be requested to determine "the
-     username we used for authz purposes", do so now. */
-  if (client_info->user && (! client_info->authz_user))
-    {
-      char *authz_user = apr_pstrdup(b->pool, client_info->user);
-      if (repository->username_case == CASE_FORCE_UPPER)
-        convert_case(authz_user, TRUE);
-      else if (repository->username_case == CASE_FORCE_LOWER)
-        convert_case(authz_user, FALSE);
-
-      client_info->authz_user = authz_user;
-    }
-
   SVN_ERR(svn_repos_authz_check_access(repository->authzdb,
                                        repository->authz_repos_name,
-                                       path, client_info->authz_user,
+                                       path, get_authz_user(b),
                                        required, allowed, pool));
   if (!*allowed)
     SVN_ERR(log_authz_denied(path, required, b, pool));
@@ -506,12 +552,35 @@ static svn_error_t *authz_check_access_cb(svn_boolean_t *allowed,
 }
 
 /* If authz is enabled in the specified BATON, return a read authorization
-   function. Otherwise, return NULL. */
+   function. Otherwise, return NULL.
+
+   Also return NULL if the authz rules grant the current user read access
+   to every path in the repository.  Callers pass the result into the
+   repos layer, which treats a NULL callback as "everything is readable"
+   and skips all its per-path checks - a noticeable win for path-heavy
+   operations such as log retrieval, dumps and reports. */
 static svn_repos_authz_func_t authz_check_access_cb_func(server_baton_t *baton)
 {
-  if (baton->repository->authzdb)
-     return authz_check_access_cb;
-  return NULL;
+  repository_t *repository = baton->repository;
+  svn_boolean_t globally_readable;
+  svn_error_t *err;
+
+  if (!repository->authzdb)
+    return NULL;
+
+  err = svn_repos_authz__get_global_access(&globally_readable,
+                                           repository->authzdb,
+                                           repository->authz_repos_name,
+                                           get_authz_user(baton),
+                                           svn_authz_read);
+  if (err)
+    {
+      /* Be conservative and keep checking each path individually. */
+      svn_error_clear(err);
+      return authz_check_access_cb;
+    }
+
+  return globally_readable ? NULL : authz_check_access_cb;
 }
 
 /* Set *ALLOWED to TRUE if the REQUIRED access to PATH is granted,
@@ -1782,6 +1851,7 @@ get_dir(svn_ra_svn_conn_t *conn,
   apr_array_header_t *inherited_props;
   apr_hash_index_t *hi;
   svn_fs_root_t *root;
+  apr_pool_t *entries_pool = NULL;
   apr_pool_t *subpool;
   svn_boolean_t want_props, want_contents;
   apr_uint64_t wants_inherited_props;
@@ -1832,9 +1902,16 @@ get_dir(svn_ra_svn_conn_t *conn,
                           pool));
 
   /* Fetch the directories' entries before starting the response, to allow
-     proper error handling in cases like when FULL_PATH doesn't exist */
+     proper error handling in cases like when FULL_PATH doesn't exist.
+     Keep them in their own pool so the memory can be returned as soon as
+     they have been sent; for very large directories, that is the bulk of
+     this command's footprint. */
   if (want_contents)
-      SVN_CMD_ERR(svn_fs_dir_entries(&entries, root, full_path, pool));
+    {
+      entries_pool = svn_pool_create(pool);
+      SVN_CMD_ERR(svn_fs_dir_entries(&entries, root, full_path,
+                                     entries_pool));
+    }
 
   /* Begin response ... */
   SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "w(r(!", "success", rev));
@@ -1850,7 +1927,9 @@ get_dir(svn_ra_svn_conn_t *conn,
       /* Transform the hash table's FS entries into dirents.  This probably
        * belongs in libsvn_repos. */
       subpool = svn_pool_create(pool);
-      for (hi = apr_hash_first(pool, entries); hi; hi = apr_hash_next(hi))
+      for (hi = apr_hash_first(entries_pool, entries);
+           hi;
+           hi = apr_hash_next(hi))
         {
           const char *name = apr_hash_this_key(hi);
           svn_fs_dirent_t *fsent = apr_hash_this_val(hi);
@@ -1910,14 +1989,18 @@ get_dir(svn_ra_svn_conn_t *conn,
           if (cdate == NULL)
             cdate = missing_date;
 
-          /* Send the entry. */
-          SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "cwnbr(?c)(?c)", name,
+          /* Send the entry.  Use the iterpool for the marshalling scratch
+             space, too; with hundreds of thousands of entries, per-entry
+             allocations from POOL add up to a substantial peak. */
+          SVN_ERR(svn_ra_svn__write_tuple(conn, subpool, "cwnbr(?c)(?c)",
+                                          name,
                                           svn_node_kind_to_word(entry_kind),
                                           (apr_uint64_t) entry_size,
                                           has_props, created_rev,
                                           cdate, last_author));
         }
       svn_pool_destroy(subpool);
+      svn_pool_destroy(entries_pool);
     }
 
   if (wants_inherited_props)
@@ -3397,6 +3480,19 @@ get_lock(svn_ra_svn_conn_t *conn,
   return SVN_NO_ERROR;
 }
 
+/* Implements svn_fs_get_locks_callback_t.  Writes LOCK onto the
+   connection given as BATON, as one element of an already opened
+   get-locks response list. */
+static svn_error_t *
+write_lock_callback(void *baton,
+                    svn_lock_t *lock,
+                    apr_pool_t *pool)
+{
+  svn_ra_svn_conn_t *conn = baton;
+
+  return svn_error_trace(write_lock(conn, pool, lock));
+}
+
 static svn_error_t *
 get_locks(svn_ra_svn_conn_t *conn,
           apr_pool_t *pool,
@@ -3409,8 +3505,6 @@ get_locks(svn_ra_svn_conn_t *conn,
   const char *canonical_path;
   const char *depth_word;
   svn_depth_t depth;
-  apr_hash_t *locks;
-  apr_hash_index_t *hi;
   svn_error_t *err;
   authz_baton_t ab;
 
@@ -3439,18 +3533,17 @@ get_locks(svn_ra_svn_conn_t *conn,
 
   SVN_ERR(log_command(b, conn, pool, "get-locks %s",
                       svn_path_uri_encode(full_path, pool)));
-  SVN_CMD_ERR(svn_repos_fs_get_locks2(&locks, b->repository->repos,
-                                      full_path, depth,
-                                      authz_check_access_cb_func(b), &ab,
-                                      pool));
-
+  /* Stream the locks straight onto the connection as the filesystem
+     walk discovers them, instead of collecting them all in memory
+     first.  Once the first lock has been written we are committed to
+     the "success" response; an error during the walk aborts the
+     connection, as it does for other streamed responses. */
   SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "w((!", "success"));
-  for (hi = apr_hash_first(pool, locks); hi; hi = apr_hash_next(hi))
-    {
-      svn_lock_t *l = apr_hash_this_val(hi);
-
-      SVN_ERR(write_lock(conn, pool, l));
-    }
+  SVN_ERR(svn_repos__fs_get_locks_stream(b->repository->repos,
+                                         full_path, depth,
+                                         authz_check_access_cb_func(b),
+                                         &ab, write_lock_callback, conn,
+                                         pool));
   SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "!))"));
 
   return SVN_NO_ERROR;
@@ -3763,9 +3856,10 @@ list(svn_ra_svn_conn_t *conn,
 
   /* Fetch the directory entries if requested and send them immediately. */
   path_info_only = (rb.dirent_fields & ~SVN_DIRENT_KIND) == 0;
-  err = svn_repos_list(root, full_path, patterns, depth, path_info_only,
-                       authz_check_access_cb_func(b), &ab, list_receiver,
-                       &rb, NULL, NULL, pool);
+  err = svn_repos_list2(root, full_path, patterns, depth, path_info_only,
+                        NULL, 0, /* no pagination */
+                        authz_check_access_cb_func(b), &ab, list_receiver,
+                        &rb, NULL, NULL, pool);
 
 
   /* Finish response. */
@@ -3780,6 +3874,58 @@ list(svn_ra_svn_conn_t *conn,
   return svn_error_trace(svn_ra_svn__write_cmd_response(conn, pool, ""));
 }
 
+/* Run the command handler CMD with the connection's output rate limited
+ * to the repository's configured bulk rate.  The limit is always removed
+ * again before returning, whether CMD succeeded or not, so that
+ * subsequent interactive commands on the same connection run at full
+ * speed. */
+static svn_error_t *
+run_throttled(svn_ra_svn__command_handler cmd,
+              svn_ra_svn_conn_t *conn,
+              apr_pool_t *pool,
+              svn_ra_svn__list_t *params,
+              void *baton)
+{
+  server_baton_t *b = baton;
+  svn_error_t *err;
+
+  svn_ra_svn__set_bandwidth_limit(conn, b->repository->bulk_rate_limit);
+  err = cmd(conn, pool, params, baton);
+  svn_ra_svn__set_bandwidth_limit(conn, 0);
+
+  return svn_error_trace(err);
+}
+
+/* Bulk revision-streaming commands, throttled so that e.g. a dump-style
+ * full export cannot starve interactive clients of server I/O. */
+
+static svn_error_t *
+replay_throttled(svn_ra_svn_conn_t *conn,
+                 apr_pool_t *pool,
+                 svn_ra_svn__list_t *params,
+                 void *baton)
+{
+  return run_throttled(replay, conn, pool, params, baton);
+}
+
+static svn_error_t *
+replay_range_throttled(svn_ra_svn_conn_t *conn,
+                       apr_pool_t *pool,
+                       svn_ra_svn__list_t *params,
+                       void *baton)
+{
+  return run_throttled(replay_range, conn, pool, params, baton);
+}
+
+static svn_error_t *
+get_file_revs_throttled(svn_ra_svn_conn_t *conn,
+                        apr_pool_t *pool,
+                        svn_ra_svn__list_t *params,
+                        void *baton)
+{
+  return run_throttled(get_file_revs, conn, pool, params, baton);
+}
+
 static const svn_ra_svn__cmd_entry_t main_commands[] = {
   { "reparent",        reparent },
   { "get-latest-rev",  get_latest_rev },
@@ -3801,15 +3947,15 @@ static const svn_ra_svn__cmd_entry_t main_commands[] = {
   { "stat",            stat_cmd },
   { "get-locations",   get_locations },
   { "get-location-segments",   get_location_segments },
-  { "get-file-revs",   get_file_revs },
+  { "get-file-revs",   get_file_revs_throttled },
   { "lock",            lock },
   { "lock-many",       lock_many },
   { "unlock",          unlock },
   { "unlock-many",     unlock_many },
   { "get-lock",        get_lock },
   { "get-locks",       get_locks },
-  { "replay",          replay },
-  { "replay-range",    replay_range },
+  { "replay",          replay_throttled },
+  { "replay-range",    replay_range_throttled },
   { "get-deleted-rev", get_deleted_rev },
   { "get-iprops",      get_inherited_props },
   { "list",            list },
@@ -4015,6 +4161,17 @@ find_repos(const char *url,
      are given by the client. */
   set_access(repository, cfg, read_only);
 
+  /* Read the I/O rate limit for bulk commands, in KiB per second. */
+  {
+    const char *val;
+    apr_uint64_t limit;
+
+    svn_config_get(cfg, &val, SVN_CONFIG_SECTION_GENERAL,
+                   SVN_CONFIG_OPTION_BULK_RATE_LIMIT, "0");
+    SVN_ERR(svn_cstring_atoui64(&limit, val));
+    repository->bulk_rate_limit = limit * 1024;
+  }
+
   /* Configure hook script environment variables. */
   svn_config_get(cfg, &hooks_env, SVN_CONFIG_SECTION_GENERAL,
                  SVN_CONFIG_OPTION_HOOKS_ENV, NULL);
@@ -4239,11 +4396,16 @@ construct_server_baton(server_baton_t **baton,
    * send an empty mechlist. */
   if (params->compression_level > 0)
     SVN_ERR(svn_ra_svn__write_cmd_response(conn, scratch_pool,
-                                           "nn()(wwwwwwwwwwwww)",
+                                           "nn()(www?wwwwwwwwwww)",
                                            (apr_uint64_t) 2, (apr_uint64_t) 2,
                                            SVN_RA_SVN_CAP_EDIT_PIPELINE,
                                            SVN_RA_SVN_CAP_SVNDIFF1,
                                            SVN_RA_SVN_CAP_SVNDIFF2_ACCEPTED,
+                                           /* accepting svndiff3 requires
+                                              a build with zstd */
+                                           svn__zstd_available()
+                                             ? SVN_RA_SVN_CAP_SVNDIFF3_ACCEPTED
+                                             : NULL,
                                            SVN_RA_SVN_CAP_ABSENT_ENTRIES,
                                            SVN_RA_SVN_CAP_COMMIT_REVPROPS,
                                            SVN_RA_SVN_CAP_DEPTH,
@@ -4467,6 +4629,16 @@ serve_interruptable(svn_boolean_t *terminate_p,
           /* It's not a fatal error if we cannot enable keep-alives. */
         }
 
+      /* Disable Nagle's algorithm.  The marshalling layer coalesces
+       * outgoing data into large blocks itself, so delaying segments
+       * until the client ACKs the previous response only adds
+       * round-trips to small command/response exchanges. */
+      ar = apr_socket_opt_set(connection->usock, APR_TCP_NODELAY, 1);
+      if (ar)
+        {
+          /* Not fatal either; we merely keep the default send behavior. */
+        }
+
       /* create the connection, configure ports etc. */
       connection->conn
         = svn_ra_svn_create_conn5(connection->usock, NULL, NULL,
@@ -4526,6 +4698,10 @@ serve_interruptable(svn_boolean_t *terminate_p,
   if (terminate_p)
     *terminate_p = terminate;
 
+  if ((terminate || err) && connection->params->log_cache_stats)
+    err = svn_error_compose_create(
+            err, log_cache_stats(connection->baton, pool));
+
   return svn_error_trace(err);
 }
 
@@ -4533,8 +4709,14 @@ svn_error_t *serve(svn_ra_svn_conn_t *conn,
                    serve_params_t *params,
                    apr_pool_t *pool)
 {
+  svn_error_t *err;
   server_baton_t *baton = NULL;
 
   SVN_ERR(construct_server_baton(&baton, conn, params, pool));
-  return svn_ra_svn__handle_commands2(conn, pool, main_commands, baton, FALSE);
+  err = svn_ra_svn__handle_commands2(conn, pool, main_commands, baton, FALSE);
+
+  if (params->log_cache_stats)
+    err = svn_error_compose_create(err, log_cache_stats(baton, pool));
+
+  return svn_error_trace(err);
 }
@@ -73,6 +73,11 @@ typedef struct repository_t {
   enum access_type auth_access; /* access granted to authenticated users */
   enum access_type anon_access; /* access granted to anonymous users */
 
+  apr_uint64_t bulk_rate_limit; /* Max bytes/sec sent while serving bulk
+                                   revision-streaming commands (replay,
+                                   replay-range, get-file-revs);
+                                   0 = unlimited */
+
 } repository_t;
 
 typedef struct client_info_t {
@@ -159,6 +164,10 @@ typedef struct serve_params_t {
 
   /* Use virtual-host-based path to repo. */
   svn_boolean_t vhost;
+
+  /* If TRUE, write a record of the process-wide cache statistics to the
+     log file whenever a client connection ends. */
+  svn_boolean_t log_cache_stats;
 } serve_params_t;
 
 /* This structure contains all data that describes a client / server
@@ -28,6 +28,7 @@
 #include <apr_general.h>
 #include <apr_getopt.h>
 #include <apr_network_io.h>
+#include <apr_poll.h>
 #include <apr_signal.h>
 #include <apr_thread_proc.h>
 #include <apr_portable.h>
@@ -55,8 +56,10 @@
 #include "private/svn_dep_compat.h"
 #include "private/svn_cmdline_private.h"
 #include "private/svn_atomic.h"
+#include "private/svn_cache.h"
 #include "private/svn_mutex.h"
 #include "private/svn_subr_private.h"
+#include "private/svn_ra_svn_private.h"
 
 #if APR_HAS_THREADS
 #    include <apr_thread_pool.h>
@@ -145,6 +148,16 @@ enum run_mode {
  */
 #define THREADPOOL_THREAD_IDLE_LIMIT 1000000
 
+/* Capacity of the pollset on which idle connections are parked between
+ * commands in threaded mode.  This is an upper bound to the number of
+ * concurrently parked connections; further connections simply keep
+ * cycling through the worker queue as before.
+ *
+ * A parked connection costs a few kB (its pollset slot plus the
+ * connection object) instead of a full worker thread stack.
+ */
+#define CONNECTION_POLLSET_SIZE (16 * 1024)
+
 /* Number of client to server connections that may concurrently in the
  * TCP 3-way handshake state, i.e. are in the process of being created.
  *
@@ -222,6 +235,9 @@ void winservice_notify_stop(void)
 #define SVNSERVE_OPT_MAX_REQUEST     274
 #define SVNSERVE_OPT_MAX_RESPONSE    275
 #define SVNSERVE_OPT_CACHE_NODEPROPS 276
+#define SVNSERVE_OPT_MAINT_WINDOW    277
+#define SVNSERVE_OPT_CACHE_SEGMENTS  278
+#define SVNSERVE_OPT_LOG_CACHE_STATS 279
 
 /* Text macro because we can't use #ifdef sections inside a N_("...")
    macro expansion. */
@@ -297,6 +313,18 @@ static const apr_getopt_option_t svnserve__options[] =
         "0 switches to dynamically sized caches.\n"
         "                             "
         "[used for FSFS and FSX repositories only]")},
+    {"cache-segments", SVNSERVE_OPT_CACHE_SEGMENTS, 1,
+     N_("number of segments to split the in-memory cache\n"
+        "                             "
+        "into; will be rounded down to a power of two.\n"
+        "                             "
+        "Larger values reduce lock contention and improve\n"
+        "                             "
+        "memory locality on multi-socket machines but\n"
+        "                             "
+        "limit the size of individual cachable items.\n"
+        "                             "
+        "Default is 0 (select automatically).")},
     {"cache-txdeltas", SVNSERVE_OPT_CACHE_TXDELTAS, 1,
      N_("enable or disable caching of deltas between older\n"
         "                             "
@@ -362,6 +390,20 @@ static const apr_getopt_option_t svnserve__options[] =
         "                             "
         "Default is " APR_STRINGIFY(THREADPOOL_MAX_SIZE) "."
         ONLY_AVAILABLE_WITH_THEADS)},
+    {"maintenance-window", SVNSERVE_OPT_MAINT_WINDOW, 1,
+     N_("pack the served repositories in a background\n"
+        "                             "
+        "thread during the daily local-time window ARG,\n"
+        "                             "
+        "given as HH:MM-HH:MM.  The work is I/O-throttled\n"
+        "                             "
+        "and stops at the end of the window.\n"
+        "                             "
+#ifdef WIN32
+        "[mode: daemon, service]")},
+#else
+        "[mode: daemon]")},
+#endif
 #endif
     {"max-request-size", SVNSERVE_OPT_MAX_REQUEST, 1,
      N_("Maximum acceptable size of a client request in MB.\n"
@@ -396,6 +438,12 @@ static const apr_getopt_option_t svnserve__options[] =
         "process (useful for debugging)")},
     {"log-file",         SVNSERVE_OPT_LOG_FILE, 1,
      N_("svnserve log file")},
+    {"log-cache-stats",  SVNSERVE_OPT_LOG_CACHE_STATS, 0,
+     N_("write a machine-readable record of the in-memory\n"
+        "                             "
+        "cache statistics to the log file whenever a\n"
+        "                             "
+        "client connection ends")},
     {"pid-file",         SVNSERVE_OPT_PID_FILE, 1,
 #ifdef WIN32
      N_("write server process ID to file ARG\n"
@@ -632,6 +680,12 @@ static svn_root_pools__t *connection_pools;
 /* The global thread pool serving all connections. */
 static apr_thread_pool_t *threads;
 
+/* The pollset on which idle connections are parked between commands, or
+   NULL if the platform does not support thread-safe pollsets.  Parked
+   connections are owned by the poll thread and re-enter the worker pool
+   once their socket becomes readable. */
+static apr_pollset_t *pollset;
+
 /* Very simple load determination callback for serve_interruptable:
    With less than half the threads in THREADS in use, we can afford to
    wait in the socket read() function.  Otherwise, poll them round-robin. */
@@ -642,14 +696,74 @@ is_busy(connection_t *connection)
        > apr_thread_pool_thread_max_get(threads);
 }
 
+/* Forward declaration ... */
+static void * APR_THREAD_FUNC serve_thread(apr_thread_t *tid, void *data);
+
+/* Try to park CONNECTION on the pollset until its socket becomes
+   readable.  Return TRUE on success, in which case the poll thread now
+   owns the connection.  On failure (e.g. the pollset being full), the
+   caller must keep scheduling the connection itself. */
+static svn_boolean_t
+try_park_connection(connection_t *connection)
+{
+  apr_pollfd_t descriptor = { 0 };
+
+  descriptor.p = connection->pool;
+  descriptor.desc_type = APR_POLL_SOCKET;
+  descriptor.desc.s = connection->usock;
+  descriptor.reqevents = APR_POLLIN | APR_POLLHUP | APR_POLLERR;
+  descriptor.client_data = connection;
+
+  return apr_pollset_add(pollset, &descriptor) == APR_SUCCESS;
+}
+
+/* Wait for parked connections to become readable and hand them back to
+   the worker thread pool.  DATA is unused.  Runs until process exit. */
+static void * APR_THREAD_FUNC poll_thread_func(apr_thread_t *tid, void *data)
+{
+  while (TRUE)
+    {
+      apr_int32_t count;
+      const apr_pollfd_t *descriptors;
+      apr_int32_t i;
+      apr_status_t status;
+
+      /* Use a finite timeout such that we notice process shutdown. */
+      status = apr_pollset_poll(pollset, apr_time_from_sec(1), &count,
+                                &descriptors);
+
+#if APR_HAVE_SIGACTION
+      if (sigtermint_seen)
+        break;
+#endif
+      if (status && !APR_STATUS_IS_EINTR(status)
+          && !APR_STATUS_IS_TIMEUP(status))
+        break;
+
+      for (i = 0; i < count; ++i)
+        {
+          connection_t *connection = descriptors[i].client_data;
+
+          /* The connection is no longer parked; it either has data to
+             process or encountered a socket error that the worker will
+             run into and handle. */
+          apr_pollset_remove(pollset, &descriptors[i]);
+          apr_thread_pool_push(threads, serve_thread, connection, 0, NULL);
+        }
+    }
+
+  return NULL;
+}
+
 /* Serve the connection given by DATA.  Under high load, serve only
-   the current command (if any) and then put the connection back into
-   THREAD's task pool. */
+   the current command (if any) and then park the connection on the
+   pollset or put it back into THREAD's task pool. */
 static void * APR_THREAD_FUNC serve_thread(apr_thread_t *tid, void *data)
 {
   svn_boolean_t done;
   connection_t *connection = data;
   svn_error_t *err;
+  svn_boolean_t park = FALSE;
 
   apr_pool_t *pool = svn_root_pools__acquire_pool(connection_pools);
 
@@ -663,17 +777,297 @@ static void * APR_THREAD_FUNC serve_thread(apr_thread_t *tid, void *data)
       svn_error_clear(err);
       done = TRUE;
     }
+
+  /* If neither our receive buffers nor the socket contain another
+     command, the connection is idle and can wait on the pollset instead
+     of cycling through the worker queue. */
+  if (!done && pollset)
+    {
+      svn_boolean_t has_command;
+      svn_boolean_t terminated;
+
+      err = svn_ra_svn__has_command(&has_command, &terminated,
+                                    connection->conn, pool);
+      if (err)
+        svn_error_clear(err);    /* Let the next cycle deal with it. */
+      else if (terminated)
+        done = TRUE;
+      else
+        park = !has_command;
+    }
   svn_root_pools__release_pool(pool, connection_pools);
 
-  /* Close or re-schedule connection. */
+  /* Close, park or re-schedule connection. */
   if (done)
     close_connection(connection);
-  else
+  else if (!park || !try_park_connection(connection))
     apr_thread_pool_push(threads, serve_thread, connection, 0, NULL);
 
   return NULL;
 }
 
+
+/*** Background maintenance. ***/
+
+/* How often the maintenance thread re-checks whether the maintenance
+ * window has been entered or left. */
+#define MAINTENANCE_POLL_INTERVAL apr_time_from_sec(60)
+
+/* While inside the maintenance window, alternate between working for
+ * MAINTENANCE_RUN_SLICE and sleeping for MAINTENANCE_PAUSE_SLICE.
+ * This caps the maintenance share of the I/O bandwidth at roughly
+ * RUN / (RUN + PAUSE), i.e. 25%, so that clients connecting during
+ * the window still get served at a reasonable speed. */
+#define MAINTENANCE_RUN_SLICE (APR_USEC_PER_SEC / 10)
+#define MAINTENANCE_PAUSE_SLICE (3 * APR_USEC_PER_SEC / 10)
+
+/* How many directory levels below the server root to scan for
+ * repositories. */
+#define MAINTENANCE_SCAN_DEPTH 3
+
+/* The state of the maintenance thread. */
+typedef struct maintenance_baton_t
+{
+  /* Server root; scanned for repositories at the start of each sweep. */
+  const char *root;
+
+  /* The server log, or NULL. */
+  logger_t *logger;
+
+  /* FS configuration to use when opening the repositories. */
+  apr_hash_t *fs_config;
+
+  /* The daily maintenance window in minutes since local midnight.
+     END before START wraps around midnight; START equal to END denotes
+     an empty window. */
+  int window_start;
+  int window_end;
+
+  /* When the current work slice began, for I/O throttling. */
+  apr_time_t slice_start;
+} maintenance_baton_t;
+
+/* Parse ARG of the form "HH:MM-HH:MM" into *START and *END, each in
+   minutes since local midnight. */
+static svn_error_t *
+parse_maintenance_window(int *start, int *end, const char *arg)
+{
+  int values[4];
+  const char separators[4] = { ':', '-', ':', '\0' };
+  const char *p = arg;
+  int i;
+
+  for (i = 0; i < 4; ++i)
+    {
+      char *next;
+      apr_int64_t value = apr_strtoi64(p, &next, 10);
+
+      if (next == p || *next != separators[i]
+          || value < 0 || value > (i % 2 ? 59 : 23))
+        return svn_error_createf(SVN_ERR_CL_ARG_PARSING_ERROR, NULL,
+                                 _("Invalid maintenance window '%s'; "
+                                   "expected HH:MM-HH:MM"), arg);
+
+      values[i] = (int)value;
+      p = next + 1;
+    }
+
+  *start = values[0] * 60 + values[1];
+  *end = values[2] * 60 + values[3];
+
+  return SVN_NO_ERROR;
+}
+
+/* Return TRUE if the current local time of day lies within the window
+   given by START and END, in minutes since midnight as parsed by
+   parse_maintenance_window(). */
+static svn_boolean_t
+in_maintenance_window(int start, int end)
+{
+  apr_time_exp_t exploded;
+  int now;
+
+  apr_time_exp_lt(&exploded, apr_time_now());
+  now = exploded.tm_hour * 60 + exploded.tm_min;
+
+  return start <= end ? (now >= start && now < end)
+                      : (now >= start || now < end);
+}
+
+/* Implements svn_cancel_func_t.  BATON is a maintenance_baton_t.
+   Cancel the running maintenance operation when the window has been
+   left or the server is shutting down; otherwise, enforce the work /
+   pause duty cycle.  Since the FS layer checks for cancellation at
+   regular points of its I/O loops, this doubles as a simple token
+   bucket on the maintenance I/O rate. */
+static svn_error_t *
+maintenance_cancel_func(void *baton)
+{
+  maintenance_baton_t *mb = baton;
+
+#if APR_HAVE_SIGACTION
+  if (sigtermint_seen)
+    return svn_error_create(SVN_ERR_CANCELLED, NULL, NULL);
+#endif
+  if (!in_maintenance_window(mb->window_start, mb->window_end))
+    return svn_error_create(SVN_ERR_CANCELLED, NULL, NULL);
+
+  if (apr_time_now() - mb->slice_start >= MAINTENANCE_RUN_SLICE)
+    {
+      apr_sleep(MAINTENANCE_PAUSE_SLICE);
+      mb->slice_start = apr_time_now();
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Append to REPOSITORIES (const char *, allocated in RESULT_POOL) all
+   repositories found at or below PATH, scanning at most DEPTH directory
+   levels.  Use SCRATCH_POOL for temporary allocations. */
+static svn_error_t *
+find_repositories(apr_array_header_t *repositories,
+                  const char *path,
+                  int depth,
+                  apr_pool_t *result_pool,
+                  apr_pool_t *scratch_pool)
+{
+  apr_hash_t *dirents;
+  apr_hash_index_t *hi;
+  apr_pool_t *iterpool;
+
+  if (svn_repos_find_root_path(path, scratch_pool))
+    {
+      /* Don't scan into the repository. */
+      APR_ARRAY_PUSH(repositories, const char *)
+        = apr_pstrdup(result_pool, path);
+      return SVN_NO_ERROR;
+    }
+
+  if (depth == 0)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_io_get_dirents3(&dirents, path, TRUE, scratch_pool,
+                              scratch_pool));
+
+  iterpool = svn_pool_create(scratch_pool);
+  for (hi = apr_hash_first(scratch_pool, dirents); hi; hi = apr_hash_next(hi))
+    {
+      const char *name = apr_hash_this_key(hi);
+      svn_io_dirent2_t *dirent = apr_hash_this_val(hi);
+
+      if (dirent->kind != svn_node_dir)
+        continue;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(find_repositories(repositories,
+                                svn_dirent_join(path, name, iterpool),
+                                depth - 1, result_pool, iterpool));
+    }
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Run one maintenance sweep for MB: pack every repository below the
+   server root.  Errors other than cancellation are logged per
+   repository; cancellation aborts the sweep.  Use POOL for temporary
+   allocations. */
+static svn_error_t *
+run_maintenance(maintenance_baton_t *mb, apr_pool_t *pool)
+{
+  apr_array_header_t *repositories
+    = apr_array_make(pool, 16, sizeof(const char *));
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  int i;
+
+  SVN_ERR(find_repositories(repositories, mb->root, MAINTENANCE_SCAN_DEPTH,
+                            pool, iterpool));
+
+  for (i = 0; i < repositories->nelts; ++i)
+    {
+      const char *path = APR_ARRAY_IDX(repositories, i, const char *);
+      svn_repos_t *repos;
+      svn_error_t *err;
+
+      svn_pool_clear(iterpool);
+
+      /* Packing takes the pack and write locks as needed, so this
+         coordinates with concurrent commits just like an external
+         'svnadmin pack' would - minus the peak-hour I/O contention. */
+      err = svn_repos_open3(&repos, path, mb->fs_config, iterpool, iterpool);
+      if (!err)
+        err = svn_repos_fs_pack2(repos, NULL, NULL,
+                                 maintenance_cancel_func, mb, iterpool);
+
+      if (err && err->apr_err == SVN_ERR_CANCELLED)
+        return err;
+      if (err)
+        {
+          /* E.g. a read-only or foreign-owned repository.  Log it and
+             carry on with the others. */
+          logger__log_error(mb->logger, err, NULL, NULL);
+          svn_error_clear(err);
+        }
+    }
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Run repository maintenance during the configured window.  DATA is
+   the maintenance_baton_t.  Runs until process exit. */
+static void * APR_THREAD_FUNC
+maintenance_thread_func(apr_thread_t *tid, void *data)
+{
+  maintenance_baton_t *mb = data;
+  apr_pool_t *pool = svn_pool_create(NULL);
+  svn_boolean_t done_this_window = FALSE;
+
+  while (TRUE)
+    {
+      svn_error_t *err;
+
+      apr_sleep(MAINTENANCE_POLL_INTERVAL);
+#if APR_HAVE_SIGACTION
+      if (sigtermint_seen)
+        break;
+#endif
+
+      if (!in_maintenance_window(mb->window_start, mb->window_end))
+        {
+          done_this_window = FALSE;
+          continue;
+        }
+
+      /* One sweep per window; new repositories and shards simply wait
+         for the next one. */
+      if (done_this_window)
+        continue;
+
+      svn_pool_clear(pool);
+      mb->slice_start = apr_time_now();
+      err = run_maintenance(mb, pool);
+      if (err && err->apr_err == SVN_ERR_CANCELLED)
+        {
+          /* Window closed mid-sweep; packing is incremental, so the
+             next window's sweep picks up where this one left off. */
+          svn_error_clear(err);
+        }
+      else
+        {
+          if (err)
+            {
+              logger__log_error(mb->logger, err, NULL, NULL);
+              svn_error_clear(err);
+            }
+          done_this_window = TRUE;
+        }
+    }
+  svn_pool_destroy(pool);
+
+  return NULL;
+}
+
 #endif
 
 /* Write the PID of the current process as a decimal number, followed by a
@@ -742,6 +1136,7 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   svn_boolean_t cache_nodeprops = TRUE;
   svn_boolean_t cache_txdeltas = TRUE;
   svn_boolean_t cache_revprops = FALSE;
+  apr_uint64_t cache_segments = 0;
   svn_boolean_t use_block_read = FALSE;
   apr_uint16_t port = SVN_RA_SVN_PORT;
   const char *host = NULL;
@@ -760,6 +1155,10 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   svn_node_kind_t kind;
   apr_size_t min_thread_count = THREADPOOL_MIN_SIZE;
   apr_size_t max_thread_count = THREADPOOL_MAX_SIZE;
+#if APR_HAS_THREADS
+  int maintenance_start = -1;
+  int maintenance_end = -1;
+#endif
 #ifdef SVN_HAVE_SASL
   SVN_ERR(cyrus_init(pool));
 #endif
@@ -792,6 +1191,7 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   params.error_check_interval = 4096;
   params.max_request_size = MAX_REQUEST_SIZE * 0x100000;
   params.max_response_size = 0;
+  params.log_cache_stats = FALSE;
 
   while (1)
     {
@@ -927,6 +1327,10 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
           }
           break;
 
+        case SVNSERVE_OPT_CACHE_SEGMENTS:
+          SVN_ERR(svn_cstring_atoui64(&cache_segments, arg));
+          break;
+
         case SVNSERVE_OPT_CACHE_TXDELTAS:
           cache_txdeltas = svn_tristate__from_word(arg) == svn_tristate_true;
           break;
@@ -980,6 +1384,13 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
           max_thread_count = (apr_size_t)apr_strtoi64(arg, NULL, 0);
           break;
 
+#if APR_HAS_THREADS
+        case SVNSERVE_OPT_MAINT_WINDOW:
+          SVN_ERR(parse_maintenance_window(&maintenance_start,
+                                           &maintenance_end, arg));
+          break;
+#endif
+
 #ifdef WIN32
         case SVNSERVE_OPT_SERVICE:
           if (run_mode != run_mode_service)
@@ -1013,6 +1424,10 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
           SVN_ERR(svn_dirent_get_absolute(&log_filename, log_filename, pool));
           break;
 
+        case SVNSERVE_OPT_LOG_CACHE_STATS:
+          params.log_cache_stats = TRUE;
+          break;
+
         }
     }
 
@@ -1054,6 +1469,20 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
       return SVN_NO_ERROR;
     }
 
+#if APR_HAS_THREADS
+  if (maintenance_start >= 0
+      && run_mode != run_mode_daemon && run_mode != run_mode_service)
+    {
+      svn_error_clear(svn_cmdline_fputs(
+                      _("Option --maintenance-window is only valid "
+                        "in daemon mode\n"),
+                      stderr, pool));
+      usage(argv[0], pool);
+      *exit_code = EXIT_FAILURE;
+      return SVN_NO_ERROR;
+    }
+#endif
+
   /* construct object pools */
   is_multi_threaded = handling_mode == connection_mode_thread;
   params.fs_config = apr_hash_make(pool);
@@ -1313,6 +1742,9 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
       }
 
     svn_cache_config_set(&settings);
+
+    if (cache_segments)
+      svn_cache__set_global_membuffer_segments((apr_size_t)cache_segments);
   }
 
 #if APR_HAS_THREADS
@@ -1341,11 +1773,66 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
 
       /* don't queue requests unless we reached the worker thread limit */
       apr_thread_pool_threshold_set(threads, 0);
+
+      /* Park idle connections on a pollset instead of letting them
+         cycle through the worker queue.  This is best-effort: without
+         thread-safe pollset support on this platform, we simply fall
+         back to the queue-cycling behavior. */
+      status = apr_pollset_create(&pollset, CONNECTION_POLLSET_SIZE, pool,
+                                  APR_POLLSET_THREADSAFE);
+      if (status)
+        {
+          pollset = NULL;
+        }
+      else
+        {
+          apr_threadattr_t *tattr;
+          apr_thread_t *tid;
+
+          status = apr_threadattr_create(&tattr, pool);
+          if (!status)
+            status = apr_threadattr_detach_set(tattr, 1);
+          if (!status)
+            status = apr_thread_create(&tid, tattr, poll_thread_func,
+                                       NULL, pool);
+          if (status)
+            {
+              apr_pollset_destroy(pollset);
+              pollset = NULL;
+            }
+        }
     }
   else
     {
       threads = NULL;
     }
+
+  if (maintenance_start >= 0)
+    {
+      /* Run maintenance in a detached thread regardless of the
+         connection handling mode; fork() only duplicates the calling
+         thread, so forked connection handlers are not affected. */
+      maintenance_baton_t *mb = apr_pcalloc(pool, sizeof(*mb));
+      apr_threadattr_t *tattr;
+      apr_thread_t *tid;
+
+      mb->root = params.root;
+      mb->logger = params.logger;
+      mb->fs_config = params.fs_config;
+      mb->window_start = maintenance_start;
+      mb->window_end = maintenance_end;
+      mb->slice_start = apr_time_now();
+
+      status = apr_threadattr_create(&tattr, pool);
+      if (!status)
+        status = apr_threadattr_detach_set(tattr, 1);
+      if (!status)
+        status = apr_thread_create(&tid, tattr, maintenance_thread_func,
+                                   mb, pool);
+      if (status)
+        return svn_error_wrap_apr(status,
+                                  _("Can't create maintenance thread"));
+    }
 #endif
 
 #if APR_HAVE_SIGACTION
@@ -1367,9 +1367,32 @@ replay_rev_finished(svn_revnum_t revision,
               _("Commit created r%ld but should have created r%ld"),
               rb->sb->committed_rev, revision);
 
-  SVN_ERR(svn_ra_rev_proplist(rb->to_session, revision, &existing_props,
-                              subpool));
-
+  if (rb->has_commit_revprops_capability)
+    {
+      /* We created this revision ourselves a moment ago, so we know
+         exactly which properties it carries: the ones we passed to the
+         commit editor in replay_rev_started() (the source's properties
+         minus 'svn:author', 'svn:date' and the svnsync bookkeeping
+         props, with 'svn:log' forced to exist), plus the
+         server-generated 'svn:author' and 'svn:date'.  Reconstructing
+         that set locally saves a round-trip to the mirror for every
+         synchronized revision; only the property names matter for the
+         removal step below. */
+      int unused_count;
+
+      existing_props = filter_props(&unused_count, rev_props,
+                                    filter_exclude_date_author_sync,
+                                    subpool);
+      svn_hash_sets(existing_props, SVN_PROP_REVISION_LOG,
+                    svn_string_create_empty(subpool));
+      svn_hash_sets(existing_props, SVN_PROP_REVISION_AUTHOR,
+                    svn_string_create_empty(subpool));
+      svn_hash_sets(existing_props, SVN_PROP_REVISION_DATE,
+                    svn_string_create_empty(subpool));
+    }
+  else
+    SVN_ERR(svn_ra_rev_proplist(rb->to_session, revision, &existing_props,
+                                subpool));
 
   /* Ok, we're done with the data, now we just need to copy the remaining
      'svn:date' and 'svn:author' revprops and we're all set.
@@ -1398,7 +1421,14 @@ replay_rev_finished(svn_revnum_t revision,
 
   rev_str = svn_string_createf(subpool, "%ld", revision);
 
-  /* Ok, we're done, bring the last-merged-rev property up to date. */
+  /* Ok, we're done, bring the last-merged-rev property up to date.
+
+     The currently-copying prop deliberately stays in place: the next
+     revision's replay_rev_started() simply overwrites it, and
+     do_synchronize() drops it once after the whole range has been
+     mirrored.  Should we get interrupted before then, currently-copying
+     equals last-merged-rev, which the recovery logic in
+     do_synchronize() already accepts as a consistent state. */
   SVN_ERR(svn_ra_change_rev_prop2(
            rb->to_session,
            0,
@@ -1407,14 +1437,6 @@ replay_rev_finished(svn_revnum_t revision,
            rev_str,
            subpool));
 
-  /* And finally drop the currently copying prop, since we're done
-     with this revision. */
-  SVN_ERR(svn_ra_change_rev_prop2(rb->to_session, 0,
-                                  SVNSYNC_PROP_CURRENTLY_COPYING,
-                                  rb->has_atomic_revprops_capability
-                                    ? &rev_str : NULL,
-                                  NULL, subpool));
-
   /* Notify the user that we copied revision properties. */
   if (! rb->sb->quiet)
     SVN_ERR(log_properties_copied(filtered_count > 0, revision, subpool));
@@ -1560,6 +1582,20 @@ do_synchronize(svn_ra_session_t *to_session,
                               0, TRUE, replay_rev_started,
                               replay_rev_finished, rb, pool));
 
+  /* replay_rev_finished() leaves the currently-copying prop of the last
+     mirrored revision in place so that it doesn't cost a round-trip per
+     revision; drop it now that the whole range is done. */
+  {
+    const svn_string_t *end_rev_str
+      = svn_string_createf(pool, "%ld", end_revision);
+
+    SVN_ERR(svn_ra_change_rev_prop2(to_session, 0,
+                                    SVNSYNC_PROP_CURRENTLY_COPYING,
+                                    rb->has_atomic_revprops_capability
+                                      ? &end_rev_str : NULL,
+                                    NULL, pool));
+  }
+
   SVN_ERR(log_properties_normalized(rb->normalized_rev_props_count
                                       + normalized_rev_props_count,
                                     rb->normalized_node_props_count,
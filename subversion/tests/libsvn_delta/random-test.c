@@ -37,6 +37,8 @@
 #include "svn_pools.h"
 #include "svn_error.h"
 
+#include "private/svn_delta_private.h"
+
 #include "../../libsvn_delta/delta.h"
 #include "delta-window-test.h"
 
@@ -605,6 +607,104 @@ random_txdelta_to_svndiff_stream_test(apr_pool_t *pool)
   return err;
 }
 
+/* (Note: *LAST_SEED is an output parameter.) */
+static svn_error_t *
+do_random_pipelined_svndiff_test(apr_pool_t *pool,
+                                 apr_uint32_t *last_seed)
+{
+  apr_uint32_t seed, maxlen;
+  apr_size_t bytes_range;
+  int i, iterations, dump_files, print_windows;
+  const char *random_bytes;
+  apr_pool_t *iterpool;
+
+  /* Initialize parameters and print out the seed in case we dump core
+     or something. */
+  init_params(&seed, &maxlen, &iterations, &dump_files, &print_windows,
+              &random_bytes, &bytes_range, pool);
+
+  iterpool = svn_pool_create(pool);
+  for (i = 0; i < iterations; i++)
+    {
+      apr_uint32_t subseed_base;
+      apr_file_t *source;
+      apr_file_t *target;
+      apr_file_t *source_copy;
+      apr_file_t *target_regen;
+      svn_txdelta_stream_t *txdelta_stream;
+      svn_txdelta_window_handler_t handler;
+      svn_stream_t *stream;
+      void *handler_baton;
+
+      svn_pool_clear(iterpool);
+
+      /* Generate source and target for the delta and its application.  */
+      *last_seed = seed;
+      subseed_base = svn_test_rand(&seed);
+      source = generate_random_file(maxlen, subseed_base, &seed,
+                                    random_bytes, bytes_range,
+                                    dump_files, iterpool);
+      target = generate_random_file(maxlen, subseed_base, &seed,
+                                    random_bytes, bytes_range,
+                                    dump_files, iterpool);
+      source_copy = copy_tempfile(source, iterpool);
+      target_regen = open_tempfile(NULL, iterpool);
+
+      /* The same four-stage pipeline as in do_random_test(), but with
+         the multi-threaded svndiff encoder in stage 2 and small enough
+         delta windows that several of them are in flight at once.  */
+
+      /* Make stage 4: apply the text delta.  */
+      svn_txdelta_apply2(svn_stream_from_aprfile(source_copy, iterpool),
+                         svn_stream_from_aprfile(target_regen, iterpool),
+                         NULL, NULL, iterpool, &handler, &handler_baton);
+
+      /* Make stage 3: reparse the text delta.  */
+      stream = svn_txdelta_parse_svndiff(handler, handler_baton, TRUE,
+                                         iterpool);
+
+      /* Make stage 2: encode the text delta in svndiff format on worker
+                       threads, varying the svndiff version, compression
+                       level and thread count.  Version 0 exercises the
+                       single-threaded fallback.  */
+      svn_txdelta__to_svndiff_pipelined(&handler, &handler_baton, stream,
+                                        i % 3, i % 10, 2 + i % 3, iterpool);
+
+      /* Make stage 1: create the text delta with small windows so that
+                       even the default 100 kB input yields several.  */
+      svn_txdelta__create_stream(&txdelta_stream,
+                                 svn_stream_from_aprfile(source, iterpool),
+                                 svn_stream_from_aprfile(target, iterpool),
+                                 FALSE, 16 * 1024, iterpool);
+
+      SVN_ERR(svn_txdelta_send_txstream(txdelta_stream,
+                                        handler,
+                                        handler_baton,
+                                        iterpool));
+
+      SVN_ERR(compare_files(target, target_regen, dump_files));
+
+      apr_file_close(source);
+      apr_file_close(target);
+      apr_file_close(source_copy);
+      apr_file_close(target_regen);
+    }
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_test_driver_t. */
+static svn_error_t *
+random_pipelined_svndiff_test(apr_pool_t *pool)
+{
+  apr_uint32_t seed;
+  svn_error_t *err = do_random_pipelined_svndiff_test(pool, &seed);
+  if (err)
+    fprintf(stderr, "SEED: %lu\n", (unsigned long)seed);
+  return err;
+}
+
 /* Change to 1 to enable the unit test for the delta combiner's range index: */
 #if 0
 #include "range-index-test.h"
@@ -625,6 +725,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                    "random combine delta test"),
     SVN_TEST_PASS2(random_txdelta_to_svndiff_stream_test,
                    "random txdelta to svndiff stream test"),
+    SVN_TEST_PASS2(random_pipelined_svndiff_test,
+                   "random pipelined svndiff encoder test"),
 #ifdef SVN_RANGE_INDEX_TEST_H
     SVN_TEST_PASS2(random_range_index_test,
                    "random range index test"),
@@ -231,6 +231,43 @@ test_parse_single_line_mergeinfo(apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+static svn_error_t *
+test_mergeinfo_parse_context(apr_pool_t *pool)
+{
+  const char *input = "/trunk: 5,7-9,41*\n/branches/foo: 1-1000";
+  svn_mergeinfo__parse_context_t *context;
+  svn_mergeinfo_t plain, packed, packed2;
+  svn_boolean_t equal;
+  apr_hash_index_t *hi;
+
+  context = svn_mergeinfo__parse_context_create(pool);
+
+  /* The context-based parser must agree with svn_mergeinfo_parse(). */
+  SVN_ERR(svn_mergeinfo_parse(&plain, input, pool));
+  SVN_ERR(svn_mergeinfo__parse(&packed, input, context, pool));
+  SVN_ERR(svn_mergeinfo__equals(&equal, plain, packed, TRUE, pool));
+  if (!equal)
+    return fail(pool, "Context-based parse differs from standard parse");
+
+  /* Parsing the same paths again must reuse the interned key strings. */
+  SVN_ERR(svn_mergeinfo__parse(&packed2, input, context, pool));
+  for (hi = apr_hash_first(pool, packed); hi; hi = apr_hash_next(hi))
+    {
+      const char *path = apr_hash_this_key(hi);
+      apr_hash_index_t *hi2;
+      svn_boolean_t found = FALSE;
+
+      for (hi2 = apr_hash_first(pool, packed2); hi2; hi2 = apr_hash_next(hi2))
+        if (apr_hash_this_key(hi2) == path)
+          found = TRUE;
+
+      if (!found)
+        return fail(pool, "Path key '%s' was not interned", path);
+    }
+
+  return SVN_NO_ERROR;
+}
+
 static const char *single_mergeinfo = "/trunk: 5,7-9,10,11,13,14";
 
 static svn_error_t *
@@ -264,6 +301,44 @@ test_mergeinfo_dup(apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+static svn_error_t *
+test_mergeinfo_dup_packed(apr_pool_t *pool)
+{
+  apr_hash_t *orig_mergeinfo, *copied_mergeinfo;
+  apr_pool_t *subpool;
+  svn_rangelist_t *rangelist;
+  svn_boolean_t is_equal;
+  int i;
+
+  /* Copy some mergeinfo using another pool, then destroy the pool with
+     which the original mergeinfo was created. */
+  subpool = svn_pool_create(pool);
+  SVN_ERR(svn_mergeinfo_parse(&orig_mergeinfo, single_mergeinfo, subpool));
+  copied_mergeinfo = svn_mergeinfo__dup_packed(orig_mergeinfo, pool, subpool);
+  SVN_ERR(svn_mergeinfo__equals(&is_equal, orig_mergeinfo, copied_mergeinfo,
+                                TRUE, subpool));
+  svn_pool_destroy(subpool);
+  if (! is_equal)
+    return fail(pool, "Packed copy should equal the original");
+
+  /* The ranges must live in one contiguous block. */
+  rangelist = apr_hash_get(copied_mergeinfo, "/trunk", APR_HASH_KEY_STRING);
+  if (! rangelist)
+    return fail(pool, "Expected copied mergeinfo; got nothing");
+  for (i = 1; i < rangelist->nelts; i++)
+    {
+      svn_merge_range_t *prev = APR_ARRAY_IDX(rangelist, i - 1,
+                                              svn_merge_range_t *);
+      svn_merge_range_t *range = APR_ARRAY_IDX(rangelist, i,
+                                               svn_merge_range_t *);
+
+      if (range != prev + 1)
+        return fail(pool, "Packed ranges should be adjacent in memory");
+    }
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 test_parse_combine_rangeinfo(apr_pool_t *pool)
 {
@@ -1672,6 +1747,87 @@ test_remove_prefix_from_catalog(apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+/* Verify that ACTUAL_CATALOG contains exactly the path -> mergeinfo
+   mappings of EXPECTED_CATALOG, comparing the mergeinfos with
+   svn_mergeinfo__equals(..., consider_inheritance=TRUE, ...). */
+static svn_error_t *
+compare_catalogs(svn_mergeinfo_catalog_t actual_catalog,
+                 svn_mergeinfo_catalog_t expected_catalog,
+                 apr_pool_t *pool)
+{
+  apr_hash_index_t *hi;
+
+  if (apr_hash_count(actual_catalog) != apr_hash_count(expected_catalog))
+    return fail(pool, "Got unexpected number of catalog entries");
+
+  for (hi = apr_hash_first(pool, expected_catalog);
+       hi; hi = apr_hash_next(hi))
+    {
+      const char *path = apr_hash_this_key(hi);
+      svn_mergeinfo_t expected_mergeinfo = apr_hash_this_val(hi);
+      svn_mergeinfo_t actual_mergeinfo = svn_hash_gets(actual_catalog, path);
+      svn_boolean_t equal;
+
+      if (!actual_mergeinfo)
+        return fail(pool, "Missing key '%s' in catalog", path);
+
+      SVN_ERR(svn_mergeinfo__equals(&equal, actual_mergeinfo,
+                                    expected_mergeinfo, TRUE, pool));
+      if (!equal)
+        return fail(pool, "Unexpected mergeinfo for key '%s'", path);
+    }
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_catalog_set_operations(apr_pool_t *pool)
+{
+  svn_mergeinfo_catalog_t cat1 = apr_hash_make(pool);
+  svn_mergeinfo_catalog_t cat2 = apr_hash_make(pool);
+  svn_mergeinfo_catalog_t expected = apr_hash_make(pool);
+  svn_mergeinfo_catalog_t actual;
+  svn_mergeinfo_t mergeinfo;
+
+  SVN_ERR(svn_mergeinfo_parse(&mergeinfo, "/trunk: 1-10,12*,15-20", pool));
+  svn_hash_sets(cat1, "/A", mergeinfo);
+  SVN_ERR(svn_mergeinfo_parse(&mergeinfo, "/trunk: 30-40", pool));
+  svn_hash_sets(cat1, "/C", mergeinfo);
+
+  SVN_ERR(svn_mergeinfo_parse(&mergeinfo,
+                              "/trunk: 5-30\n/branches/b: 1-5", pool));
+  svn_hash_sets(cat2, "/A", mergeinfo);
+  SVN_ERR(svn_mergeinfo_parse(&mergeinfo, "/trunk: 1-4", pool));
+  svn_hash_sets(cat2, "/B", mergeinfo);
+
+  /* Intersection:  only the key common to both catalogs survives and
+     the non-inheritable r12 does not match the inheritable ranges. */
+  SVN_ERR(svn_mergeinfo__catalog_intersect(&actual, cat1, cat2, TRUE,
+                                           pool, pool));
+  SVN_ERR(svn_mergeinfo_parse(&mergeinfo, "/trunk: 5-10,15-20", pool));
+  svn_hash_sets(expected, "/A", mergeinfo);
+  SVN_ERR(compare_catalogs(actual, expected, pool));
+
+  /* Removal:  CAT1 erases its ranges from the common key; keys only in
+     the whiteboard CAT2 are kept unchanged. */
+  SVN_ERR(svn_mergeinfo__catalog_remove(&actual, cat1, cat2, TRUE,
+                                        pool, pool));
+  expected = apr_hash_make(pool);
+  SVN_ERR(svn_mergeinfo_parse(&mergeinfo,
+                              "/trunk: 11-14,21-30\n/branches/b: 1-5", pool));
+  svn_hash_sets(expected, "/A", mergeinfo);
+  SVN_ERR(svn_mergeinfo_parse(&mergeinfo, "/trunk: 1-4", pool));
+  svn_hash_sets(expected, "/B", mergeinfo);
+  SVN_ERR(compare_catalogs(actual, expected, pool));
+
+  /* A path erased down to nothing must be dropped from the result. */
+  SVN_ERR(svn_mergeinfo__catalog_remove(&actual, cat2, cat2, TRUE,
+                                        pool, pool));
+  SVN_ERR(compare_catalogs(actual, apr_hash_make(pool), pool));
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 test_rangelist_merge_overlap(apr_pool_t *pool)
 {
@@ -2490,8 +2646,12 @@ static struct svn_test_descriptor_t test_funcs[] =
     SVN_TEST_NULL,
     SVN_TEST_PASS2(test_parse_single_line_mergeinfo,
                    "parse single line mergeinfo"),
+    SVN_TEST_PASS2(test_mergeinfo_parse_context,
+                   "parse mergeinfo with an interning parse context"),
     SVN_TEST_PASS2(test_mergeinfo_dup,
                    "copy a mergeinfo data structure"),
+    SVN_TEST_PASS2(test_mergeinfo_dup_packed,
+                   "copy mergeinfo with packed rangelists"),
     SVN_TEST_PASS2(test_parse_combine_rangeinfo,
                    "parse single line mergeinfo and combine ranges"),
     SVN_TEST_PASS2(test_parse_broken_mergeinfo,
@@ -2524,6 +2684,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                    "diff of rangelists"),
     SVN_TEST_PASS2(test_remove_prefix_from_catalog,
                    "removal of prefix paths from catalog keys"),
+    SVN_TEST_PASS2(test_catalog_set_operations,
+                   "bulk intersect/remove of mergeinfo catalogs"),
     SVN_TEST_PASS2(test_rangelist_merge_overlap,
                    "merge of rangelists with overlaps (issue 4686)"),
     SVN_TEST_PASS2(test_rangelist_loop,
@@ -884,6 +884,103 @@ unparse_list(apr_pool_t *pool)
 }
 
 
+/* Parsing into a contiguous node slab.  */
+
+static svn_error_t *
+parse_in_place(apr_pool_t *pool)
+{
+  /* Rebuild the list of lists from unparse_list() and check that the
+     slab parser agrees with the recursive one.  */
+  {
+    svn_stringbuf_t *str;
+    svn_skel_t *top = empty(pool);
+    svn_skel_t *reference, *reparsed;
+    int i;
+
+    for (i = 0; i < 10; i++)
+      {
+        svn_skel_t *middle = empty(pool);
+        int j;
+
+        for (j = 0; j < 10; j++)
+          {
+            char buf[10];
+            apr_size_t k;
+            int val;
+
+            val = i * 10 + j;
+            for (k = 0; k < sizeof(buf); k++)
+              {
+                buf[k] = (char)val;
+                val += j;
+              }
+
+            add(build_atom(sizeof(buf), buf, pool), middle);
+          }
+
+        add(middle, top);
+      }
+
+    str = svn_skel__unparse(top, pool);
+    reference = svn_skel__parse(str->data, str->len, pool);
+    reparsed = svn_skel__parse_in_place(str->data, str->len, pool);
+
+    if (! reparsed)
+      return fail(pool, "in-place parser rejected a valid skel");
+
+    if (! skel_equal(reference, reparsed))
+      return fail(pool, "in-place parser disagrees with recursive parser");
+
+    /* The parse must not have copied the data.  */
+    if (reparsed->children->children->data < str->data
+        || reparsed->children->children->data > str->data + str->len)
+      return fail(pool, "in-place parser copied the input data");
+  }
+
+  /* A list nested deeper than the parser's on-stack frame array.  */
+  {
+    svn_stringbuf_t *str = get_empty_string(pool);
+    svn_skel_t *reparsed;
+    int depth = 200;
+    int i;
+
+    for (i = 0; i < depth; i++)
+      svn_stringbuf_appendbyte(str, '(');
+    svn_stringbuf_appendcstr(str, "hello");
+    for (i = 0; i < depth; i++)
+      svn_stringbuf_appendbyte(str, ')');
+
+    reparsed = svn_skel__parse_in_place(str->data, str->len, pool);
+    if (! reparsed)
+      return fail(pool, "in-place parser rejected a deeply nested skel");
+
+    for (i = 0; i < depth; i++)
+      {
+        if (! reparsed || reparsed->is_atom)
+          return fail(pool, "bad deeply nested skel");
+        reparsed = reparsed->children;
+      }
+    if (! (reparsed && reparsed->is_atom && reparsed->len == 5))
+      return fail(pool, "bad atom in deeply nested skel");
+  }
+
+  /* Invalid inputs must be rejected, just as by svn_skel__parse().  */
+  {
+    static const char * const invalid[]
+      = { "", "(", ")", "(a", "5 abc", "3 ", "99999999999999999999 x",
+          NULL };
+    int i;
+
+    for (i = 0; invalid[i]; i++)
+      if (svn_skel__parse_in_place(invalid[i], strlen(invalid[i]), pool))
+        return fail(pool, "in-place parser accepted invalid skel '%s'",
+                    invalid[i]);
+  }
+
+  return SVN_NO_ERROR;
+}
+
+
 /* The test table.  */
 
 static int max_threads = 1;
@@ -903,6 +1000,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                    "unparse implicit-length atoms"),
     SVN_TEST_PASS2(unparse_list,
                    "unparse lists"),
+    SVN_TEST_PASS2(parse_in_place,
+                   "parse into a contiguous node slab"),
     SVN_TEST_NULL
   };
 
@@ -0,0 +1,139 @@
+/*
+ * sorts-test.c:  a collection of svn_sort__* tests
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <apr_pools.h>
+
+#include "../svn_test.h"
+
+#include "svn_error.h"
+#include "svn_sorts.h"
+#include "private/svn_sorts_private.h"
+
+/* A list of paths in svn_path_compare_paths() order, including the
+ * corner cases that ordering is known for: children right after their
+ * parents, '/' before other characters, duplicates and single chars. */
+static const char *const ordered_paths[] =
+  {
+    "",
+    "A",
+    "A/B",
+    "A/B",
+    "A/B/C",
+    "A/B0",
+    "A/Bx",
+    "A0",
+    "a",
+    "a/b",
+    "a!b",
+    "abc",
+    "abc/deeply/nested/path",
+    "abc/deeply/nested/path0",
+    "abcd"
+  };
+
+enum { ORDERED_PATH_COUNT = sizeof(ordered_paths) / sizeof(*ordered_paths) };
+
+static svn_error_t *
+test_sort_paths(apr_pool_t *pool)
+{
+  apr_array_header_t *paths
+    = apr_array_make(pool, ORDERED_PATH_COUNT, sizeof(const char *));
+  int i;
+
+  /* Add the expected output in some shuffled order. */
+  for (i = 0; i < ORDERED_PATH_COUNT; ++i)
+    APR_ARRAY_PUSH(paths, const char *)
+      = ordered_paths[(i * 7 + 3) % ORDERED_PATH_COUNT];
+
+  svn_sort__array_paths(paths);
+
+  for (i = 0; i < ORDERED_PATH_COUNT; ++i)
+    SVN_TEST_STRING_ASSERT(APR_ARRAY_IDX(paths, i, const char *),
+                           ordered_paths[i]);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_sort_paths_random(apr_pool_t *pool)
+{
+  enum { PATH_COUNT = 1000 };
+  apr_array_header_t *actual
+    = apr_array_make(pool, PATH_COUNT, sizeof(const char *));
+  apr_array_header_t *expected;
+  apr_uint32_t state = 42;
+  int i;
+
+  /* Generate random paths of varying depth over a small alphabet to
+   * produce plenty of shared prefixes and duplicates. */
+  for (i = 0; i < PATH_COUNT; ++i)
+    {
+      svn_stringbuf_t *path = svn_stringbuf_create_empty(pool);
+      int k, len;
+
+      state = state * 1103515245 + 12345;
+      len = state % 24;
+      for (k = 0; k < len; ++k)
+        {
+          state = state * 1103515245 + 12345;
+          if (k > 0 && k + 1 < len && path->data[path->len - 1] != '/'
+              && state % 4 == 0)
+            svn_stringbuf_appendbyte(path, '/');
+          else
+            svn_stringbuf_appendbyte(path, (char)('a' + state % 3));
+        }
+
+      APR_ARRAY_PUSH(actual, const char *) = path->data;
+    }
+
+  /* The ordering of the generic sort defines the expected result. */
+  expected = apr_array_copy(pool, actual);
+  svn_sort__array(expected, svn_sort_compare_paths);
+
+  svn_sort__array_paths(actual);
+
+  for (i = 0; i < PATH_COUNT; ++i)
+    SVN_TEST_STRING_ASSERT(APR_ARRAY_IDX(actual, i, const char *),
+                           APR_ARRAY_IDX(expected, i, const char *));
+
+  return SVN_NO_ERROR;
+}
+
+
+/* An array of all test functions */
+
+static int max_threads = 1;
+
+static struct svn_test_descriptor_t test_funcs[] =
+  {
+    SVN_TEST_NULL,
+    SVN_TEST_PASS2(test_sort_paths,
+                   "path sort produces svn_path_compare_paths order"),
+    SVN_TEST_PASS2(test_sort_paths_random,
+                   "path sort matches the generic sort on random input"),
+    SVN_TEST_NULL
+  };
+
+SVN_TEST_MAIN
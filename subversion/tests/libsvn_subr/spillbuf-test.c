@@ -558,6 +558,42 @@ test_spillbuf_file_attrs_spill_all(apr_pool_t *pool)
   return test_spillbuf__file_attrs(pool, TRUE, buf);
 }
 
+static svn_error_t *
+test_spillbuf_reserve(apr_pool_t *pool)
+{
+  apr_size_t len = strlen(basic_data);  /* Don't include basic_data's NUL  */
+  svn_spillbuf_t *buf = svn_spillbuf__create(len, 10 * len, pool);
+  int i;
+  char *data;
+  apr_size_t avail;
+  const char *readptr;
+  apr_size_t readlen;
+
+  /* Append enough copies via reserve/commit to cause a spill to disk.  */
+  for (i = 20; i--; )
+    {
+      SVN_ERR(svn_spillbuf__reserve(&data, &avail, buf, pool));
+      SVN_TEST_ASSERT(avail >= len);
+      memcpy(data, basic_data, len);
+      SVN_ERR(svn_spillbuf__commit(buf, len, pool));
+    }
+
+  /* Verify that we can read 20 copies of basic_data from the buffer.  */
+  for (i = 20; i--; )
+    CHECK_READ(buf, (i + 1) * len, basic_data, pool);
+
+  SVN_ERR(svn_spillbuf__read(&readptr, &readlen, buf, pool));
+  SVN_TEST_ASSERT(readptr == NULL);
+  SVN_TEST_ASSERT(svn_spillbuf__get_size(buf) == 0);
+
+  /* A discarded reservation must not add any content.  */
+  SVN_ERR(svn_spillbuf__reserve(&data, &avail, buf, pool));
+  SVN_ERR(svn_spillbuf__commit(buf, 0, pool));
+  SVN_TEST_ASSERT(svn_spillbuf__get_size(buf) == 0);
+
+  return SVN_NO_ERROR;
+}
+
 /* The test table.  */
 
 static int max_threads = 1;
@@ -589,6 +625,7 @@ static struct svn_test_descriptor_t test_funcs[] =
     SVN_TEST_PASS2(test_spillbuf_file_attrs, "check spill file properties"),
     SVN_TEST_PASS2(test_spillbuf_file_attrs_spill_all,
                    "check spill file properties (spill-all-data)"),
+    SVN_TEST_PASS2(test_spillbuf_reserve, "reserve/commit zero-copy append"),
     SVN_TEST_NULL
   };
 
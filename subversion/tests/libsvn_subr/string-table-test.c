@@ -21,7 +21,7 @@
  */
 
 #include "../svn_test.h"
-#include "../../libsvn_fs_x/string_table.h"
+#include "private/svn_string_table.h"
 #include "svn_pools.h"
 #include "svn_sorts.h"
 
@@ -82,19 +82,19 @@ generate_string(apr_uint64_t key, apr_size_t len, apr_pool_t *pool)
 }
 
 static svn_error_t *
-store_and_load_table(string_table_t **table, apr_pool_t *pool)
+store_and_load_table(svn_string_table_t **table, apr_pool_t *pool)
 {
   svn_stringbuf_t *stream_buffer = svn_stringbuf_create_empty(pool);
   svn_stream_t *stream;
 
   stream = svn_stream_from_stringbuf(stream_buffer, pool);
-  SVN_ERR(svn_fs_x__write_string_table(stream, *table, pool));
+  SVN_ERR(svn_string_table__write(stream, *table, pool));
   SVN_ERR(svn_stream_close(stream));
 
   *table = NULL;
 
   stream = svn_stream_from_stringbuf(stream_buffer, pool);
-  SVN_ERR(svn_fs_x__read_string_table(table, stream, pool, pool));
+  SVN_ERR(svn_string_table__read(table, stream, pool, pool));
   SVN_ERR(svn_stream_close(stream));
 
   return SVN_NO_ERROR;
@@ -104,17 +104,17 @@ static svn_error_t *
 create_empty_table_body(svn_boolean_t do_load_store,
                         apr_pool_t *pool)
 {
-  string_table_builder_t *builder
-    = svn_fs_x__string_table_builder_create(pool);
-  string_table_t *table
-    = svn_fs_x__string_table_create(builder, pool);
+  svn_string_table_builder_t *builder
+    = svn_string_table__builder_create(pool);
+  svn_string_table_t *table
+    = svn_string_table__create(builder, pool);
 
-  SVN_TEST_STRING_ASSERT(svn_fs_x__string_table_get(table, 0, NULL, pool), "");
+  SVN_TEST_STRING_ASSERT(svn_string_table__get(table, 0, NULL, pool), "");
 
   if (do_load_store)
     SVN_ERR(store_and_load_table(&table, pool));
 
-  SVN_TEST_STRING_ASSERT(svn_fs_x__string_table_get(table, 0, NULL, pool), "");
+  SVN_TEST_STRING_ASSERT(svn_string_table__get(table, 0, NULL, pool), "");
 
   return SVN_NO_ERROR;
 }
@@ -125,15 +125,15 @@ short_string_table_body(svn_boolean_t do_load_store,
 {
   apr_size_t indexes[STRING_COUNT] = { 0 };
 
-  string_table_builder_t *builder;
-  string_table_t *table;
+  svn_string_table_builder_t *builder;
+  svn_string_table_t *table;
   int i;
 
-  builder = svn_fs_x__string_table_builder_create(pool);
+  builder = svn_string_table__builder_create(pool);
   for (i = 0; i < STRING_COUNT; ++i)
-    indexes[i] = svn_fs_x__string_table_builder_add(builder, basic_strings[i], 0);
+    indexes[i] = svn_string_table__builder_add(builder, basic_strings[i], 0);
 
-  table = svn_fs_x__string_table_create(builder, pool);
+  table = svn_string_table__create(builder, pool);
   if (do_load_store)
     SVN_ERR(store_and_load_table(&table, pool));
 
@@ -142,14 +142,14 @@ short_string_table_body(svn_boolean_t do_load_store,
     {
       apr_size_t len;
       const char *string
-        = svn_fs_x__string_table_get(table, indexes[i], &len, pool);
+        = svn_string_table__get(table, indexes[i], &len, pool);
 
       SVN_TEST_STRING_ASSERT(string, basic_strings[i]);
       SVN_TEST_ASSERT(len == strlen(string));
       SVN_TEST_ASSERT(len == strlen(basic_strings[i]));
     }
 
-  SVN_TEST_STRING_ASSERT(svn_fs_x__string_table_get(table, STRING_COUNT,
+  SVN_TEST_STRING_ASSERT(svn_string_table__get(table, STRING_COUNT,
                                                     NULL, pool), "");
 
   return SVN_NO_ERROR;
@@ -164,21 +164,21 @@ large_string_table_body(svn_boolean_t do_load_store,
   svn_stringbuf_t *strings[COUNT] = { 0 };
   apr_size_t indexes[COUNT] = { 0 };
 
-  string_table_builder_t *builder;
-  string_table_t *table;
+  svn_string_table_builder_t *builder;
+  svn_string_table_t *table;
   int i;
 
-  builder = svn_fs_x__string_table_builder_create(pool);
+  builder = svn_string_table__builder_create(pool);
   for (i = 0; i < COUNT; ++i)
     {
       strings[i] = generate_string(APR_UINT64_C(0x1234567876543210) * (i + 1),
                                    73000 + 1000 * i,  pool);
-      indexes[i] = svn_fs_x__string_table_builder_add(builder,
+      indexes[i] = svn_string_table__builder_add(builder,
                                                       strings[i]->data,
                                                       strings[i]->len);
     }
 
-  table = svn_fs_x__string_table_create(builder, pool);
+  table = svn_string_table__create(builder, pool);
   if (do_load_store)
     SVN_ERR(store_and_load_table(&table, pool));
 
@@ -186,7 +186,7 @@ large_string_table_body(svn_boolean_t do_load_store,
     {
       apr_size_t len;
       const char *string
-        = svn_fs_x__string_table_get(table, indexes[i], &len, pool);
+        = svn_string_table__get(table, indexes[i], &len, pool);
 
       SVN_TEST_STRING_ASSERT(string, strings[i]->data);
       SVN_TEST_ASSERT(len == strlen(string));
@@ -206,21 +206,21 @@ many_strings_table_body(svn_boolean_t do_load_store,
   svn_stringbuf_t *strings[COUNT] = { 0 };
   apr_size_t indexes[COUNT] = { 0 };
 
-  string_table_builder_t *builder;
-  string_table_t *table;
+  svn_string_table_builder_t *builder;
+  svn_string_table_t *table;
   int i;
 
-  builder = svn_fs_x__string_table_builder_create(pool);
+  builder = svn_string_table__builder_create(pool);
   for (i = 0; i < COUNT; ++i)
     {
       strings[i] = generate_string(APR_UINT64_C(0x1234567876543210) * (i + 1),
                                    (i * i) % 23000,  pool);
-      indexes[i] = svn_fs_x__string_table_builder_add(builder,
+      indexes[i] = svn_string_table__builder_add(builder,
                                                       strings[i]->data,
                                                       strings[i]->len);
     }
 
-  table = svn_fs_x__string_table_create(builder, pool);
+  table = svn_string_table__create(builder, pool);
   if (do_load_store)
     SVN_ERR(store_and_load_table(&table, pool));
 
@@ -228,7 +228,7 @@ many_strings_table_body(svn_boolean_t do_load_store,
     {
       apr_size_t len;
       const char *string
-        = svn_fs_x__string_table_get(table, indexes[i], &len, pool);
+        = svn_string_table__get(table, indexes[i], &len, pool);
 
       SVN_TEST_STRING_ASSERT(string, strings[i]->data);
       SVN_TEST_ASSERT(len == strlen(string));
@@ -64,7 +64,7 @@ utf_validate(apr_pool_t *pool)
 {
   struct data {
     svn_boolean_t valid;
-    char string[20];
+    char string[48];
   } tests[] = {
     {TRUE,  {'a', 'b', '\0'}},
     {FALSE, {'a', 'b', '\x80', '\0'}},
@@ -148,6 +148,15 @@ utf_validate(apr_pool_t *pool)
     {FALSE, {'a', 'b', '\xF4', '\x81', '\x81', '\x81', 'x', 'y',
              'a', 'b', '\xF2', '\x91', '\x81',         'x', 'y', '\0'}},
 
+    /* ASCII runs long enough to exercise the chunked fast path, both
+       at the start of the string and between multi-byte sequences. */
+    {TRUE,  "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"},
+    {FALSE, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\x80"},
+    {TRUE,  "aaaaaaaaaaaaaaaaaa\xC5\x81zzzzzzzzzzzzzzzzzz"},
+    {FALSE, "aaaaaaaaaaaaaaaaaa\xC5\xC0zzzzzzzzzzzzzzzzzz"},
+    {FALSE, "aaaaaaaaaaaaaaaaaazzzzzzzzzzzzzzzzzz\xE0\xA0"},
+    {TRUE,  "aaaaaaaaaaaaaaaaaazzzzzzzzzzzzzzzz\xE0\xA0\x81"},
+
     {-1},
   };
   int i = 0;
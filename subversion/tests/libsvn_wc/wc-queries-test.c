@@ -136,6 +136,7 @@ static const int primary_key_statements[] =
      and primary key instead of adding a list? */
   STMT_LOOK_FOR_WORK,
   STMT_SELECT_WORK_ITEM,
+  STMT_SELECT_WORK_ITEMS,
 
   -1 /* final marker */
 };
@@ -817,6 +817,94 @@ test_get_pristine_copy_path(const svn_test_opts_t *opts, apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+/* Baton for the callbacks of test_update_abort_unlocks(). */
+struct abort_update_baton
+{
+  /* Set once a node addition has been notified. */
+  svn_boolean_t saw_add;
+};
+
+/* Implements svn_wc_notify_func2_t.  Records in the baton that the update
+   started adding nodes. */
+static void
+abort_update_notify(void *baton,
+                    const svn_wc_notify_t *notify,
+                    apr_pool_t *scratch_pool)
+{
+  struct abort_update_baton *aub = baton;
+
+  if (notify->action == svn_wc_notify_update_add)
+    aub->saw_add = TRUE;
+}
+
+/* Implements svn_cancel_func_t.  Cancels as soon as the update has added
+   its first node, i.e. in the middle of the editor drive. */
+static svn_error_t *
+abort_update_cancel(void *baton)
+{
+  struct abort_update_baton *aub = baton;
+
+  if (aub->saw_add)
+    return svn_error_create(SVN_ERR_CANCELLED, NULL, NULL);
+
+  return SVN_NO_ERROR;
+}
+
+/* Abort an update in the middle of the editor drive and verify that the
+   working copy is left unlocked and that re-running the update succeeds. */
+static svn_error_t *
+test_update_abort_unlocks(const svn_test_opts_t *opts, apr_pool_t *pool)
+{
+  svn_test__sandbox_t b;
+  svn_client_ctx_t *ctx;
+  struct abort_update_baton aub = { FALSE };
+  apr_array_header_t *paths;
+  svn_opt_revision_t revision;
+  apr_array_header_t *result_revs;
+  svn_boolean_t locked_here, locked;
+  svn_error_t *err;
+
+  SVN_ERR(svn_test__sandbox_create(&b, "update_abort_unlocks", opts, pool));
+  SVN_ERR(sbox_wc_mkdir(&b, "A"));
+  SVN_ERR(sbox_file_write(&b, "A/f1", "f1 content"));
+  SVN_ERR(sbox_wc_add(&b, "A/f1"));
+  SVN_ERR(sbox_file_write(&b, "A/f2", "f2 content"));
+  SVN_ERR(sbox_wc_add(&b, "A/f2"));
+  SVN_ERR(sbox_wc_commit(&b, ""));
+  SVN_ERR(sbox_wc_update(&b, "", 0));
+
+  /* Update back to r1, cancelling the drive as soon as the first node has
+     been added, while the directory A is still being filled in. */
+  SVN_ERR(svn_test__create_client_ctx(&ctx, &b, pool));
+  ctx->notify_func2 = abort_update_notify;
+  ctx->notify_baton2 = &aub;
+  ctx->cancel_func = abort_update_cancel;
+  ctx->cancel_baton = &aub;
+
+  paths = apr_array_make(pool, 1, sizeof(const char *));
+  APR_ARRAY_PUSH(paths, const char *) = b.wc_abspath;
+  revision.kind = svn_opt_revision_number;
+  revision.value.number = 1;
+
+  err = svn_client_update4(&result_revs, paths, &revision,
+                           svn_depth_unknown, FALSE, FALSE, FALSE, FALSE,
+                           FALSE, ctx, pool);
+  SVN_TEST_ASSERT(err != NULL
+                  && svn_error_find_cause(err, SVN_ERR_CANCELLED));
+  svn_error_clear(err);
+
+  /* The aborted drive must not leave the working copy locked... */
+  SVN_ERR(svn_wc_locked2(&locked_here, &locked, b.wc_ctx, b.wc_abspath,
+                         pool));
+  SVN_TEST_ASSERT(!locked_here);
+  SVN_TEST_ASSERT(!locked);
+
+  /* ...and re-running the update must pick up where it left off. */
+  SVN_ERR(sbox_wc_update(&b, "", 1));
+
+  return SVN_NO_ERROR;
+}
+
 /* ---------------------------------------------------------------------- */
 /* The list of test functions */
 
@@ -851,6 +939,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "test internal_file_modified with eol-style"),
     SVN_TEST_OPTS_PASS(test_get_pristine_copy_path,
                        "test svn_wc_get_pristine_copy_path"),
+    SVN_TEST_OPTS_PASS(test_update_abort_unlocks,
+                       "update aborted mid-drive leaves wc unlocked"),
     SVN_TEST_NULL
   };
 